@@ -0,0 +1,422 @@
+/**
+ * @file gemm_benchmark.cpp
+ * @brief วัด GFLOP/s ของ sgemm สำหรับขนาดเมทริกซ์ที่เครือข่ายใน examples/dl_examples ใช้จริง
+ *        เวลาของ conv แต่ละชั้นด้วย im2col เทียบกับ Winograd
+ *        ปริมาณข้อมูลที่อ่าน/เขียนของบล็อก conv + bias + ReLU + max pool แบบแยกรอบเทียบกับแบบรวม
+ *        และ Adam + clip ตาม norm รวมแบบทีละ tensor เทียบกับรอบเดียวบนบัฟเฟอร์แบน
+ *
+ * build: cmake -S . -B build -DBUILD_BENCHMARKS=ON && cmake --build build --target gemm_benchmark
+ * รัน:   ./gemm_benchmark [--threads N] [--ghz F] [--seconds S]
+ */
+
+#include "../include/dl/Conv.h"
+#include "../include/dl/Gemm.h"
+#include "../include/dl/Graph.h"
+#include "../include/dl/Optimizer.h"
+#include "../include/dl/Pool.h"
+#include "../include/utils/parallel.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace ai_language;
+
+namespace {
+
+struct GemmShape {
+    std::string use;    // ชั้นและทิศทาง เช่น "mnist dense7 forward"
+    bool transA;
+    bool transB;
+    size_t m, n, k;
+};
+
+struct Network {
+    std::string name;
+    std::vector<std::string> layers;
+    size_t batch;
+};
+
+// สถาปัตยกรรมเดียวกับ examples/dl_examples/*.ai (รูปแบบเดียวกับที่ add layer เก็บไว้)
+std::vector<Network> exampleNetworks() {
+    return {
+        {"cnn.ai images", {"input:64x64x3", "conv:32:3:relu", "pool:2x2", "conv:64:3:relu", "pool:2x2",
+                           "dropout:0.25", "flatten", "dense:128:relu", "dropout:0.5", "output:3:softmax"}, 32},
+        {"cnn.ai mnist", {"input:28x28x1", "conv:32:3:relu", "pool:2x2", "conv:64:3:relu", "pool:2x2", "flatten",
+                          "hidden:128:relu", "dropout:0.2", "output:10:softmax"}, 64},
+        {"neural_network.ai iris", {"input:4:linear", "hidden:8:relu", "hidden:6:relu", "output:3:softmax"}, 16},
+        {"neural_network.ai default", defaultLayers(128), 64},
+    };
+}
+
+// dense: Y = X W^T, dX = dY W, dW = dY^T X
+// conv (ทีละตัวอย่าง, im2col): Y = W cols, dW = dY cols^T, dcols = W^T dY
+std::vector<GemmShape> shapesOf(const Network& network) {
+    LayerGraph graph = LayerGraph::compile(network.layers, network.batch);
+    std::vector<GemmShape> shapes;
+    for (const GraphNode& node : graph.nodes()) {
+        std::string prefix = network.name + " " + node.name + " ";
+        if (node.spec.kind == LayerKind::Dense) {
+            size_t in = node.inputShape[0], out = node.spec.units, batch = network.batch;
+            shapes.push_back({prefix + "forward", false, true, batch, out, in});
+            shapes.push_back({prefix + "dX", false, false, batch, in, out});
+            shapes.push_back({prefix + "dW", true, false, out, in, batch});
+        } else if (node.spec.kind == LayerKind::Conv) {
+            size_t filters = node.spec.units;
+            size_t patch = node.inputShape[0] * node.spec.kernel * node.spec.kernel;
+            size_t positions = node.outputShape[1] * node.outputShape[2];
+            shapes.push_back({prefix + "forward", false, false, filters, positions, patch});
+            shapes.push_back({prefix + "dW", false, true, filters, patch, positions});
+            shapes.push_back({prefix + "dcols", true, false, patch, positions, filters});
+        }
+    }
+    return shapes;
+}
+
+// ความถี่สูงสุดที่ /proc/cpuinfo รายงาน (0 = ไม่ทราบ)
+double cpuGhz() {
+    std::ifstream info("/proc/cpuinfo");
+    std::string line;
+    double best = 0.0;
+    while (std::getline(info, line)) {
+        if (line.rfind("cpu MHz", 0) == 0) {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                best = std::max(best, std::atof(line.c_str() + colon + 1) / 1000.0);
+            }
+        }
+    }
+    return best;
+}
+
+// FLOP ต่อรอบสัญญาณนาฬิกาต่อคอร์: จำนวน lane x 2 (FMA) x 2 หน่วย FMA
+double flopsPerCycle(GemmKernel kernel) {
+    switch (kernel) {
+        case GemmKernel::Avx512: return 16 * 2 * 2;
+        case GemmKernel::Avx2: return 8 * 2 * 2;
+        default: return 1 * 2 * 2;
+    }
+}
+
+double measureGflops(const GemmShape& shape, GemmKernel kernel, double seconds) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    std::vector<float> a(shape.m * shape.k), b(shape.k * shape.n), c(shape.m * shape.n);
+    for (float& x : a) x = uniform(rng);
+    for (float& x : b) x = uniform(rng);
+    size_t lda = shape.transA ? shape.m : shape.k;
+    size_t ldb = shape.transB ? shape.k : shape.n;
+    double flops = 2.0 * shape.m * shape.n * shape.k;
+
+    auto run = [&]() {
+        sgemm(shape.transA, shape.transB, shape.m, shape.n, shape.k, 1.0f, a.data(), lda, b.data(), ldb, 0.0f,
+              c.data(), shape.n, kernel);
+    };
+    run();   // อุ่นเครื่องและจองบัฟเฟอร์จัดเรียง
+    double best = 1e30, total = 0.0;
+    size_t reps = 0;
+    while (total < seconds || reps < 3) {
+        auto start = std::chrono::steady_clock::now();
+        size_t inner = std::max<size_t>(1, static_cast<size_t>(2e6 / flops));
+        for (size_t i = 0; i < inner; i++) {
+            run();
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        best = std::min(best, elapsed / inner);
+        total += elapsed;
+        reps++;
+    }
+    return flops / best / 1e9;
+}
+
+double millisSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct BlockCost {
+    double forwardMillis = 1e30;
+    double backwardMillis = 1e30;
+    double bytes = 0.0;     // ไบต์ที่อ่าน + เขียนของ activation ทุกรอบ (ไม่รวมการอ่าน input ของ conv ซึ่งเท่ากัน)
+};
+
+// conv (เขียนผลลัพธ์) -> บวก bias -> ReLU -> max pool ที่เก็บดัชนี int32 และ backward ย้อนกลับทีละรอบ
+BlockCost separatePasses(const ConvShape& conv, const PoolShape& pool, size_t batch, const std::vector<float>& x,
+                         const std::vector<float>& w, const std::vector<float>& bias, const std::vector<float>& dp,
+                         std::vector<float>& workspace) {
+    const size_t positions = conv.outHeight() * conv.outWidth();
+    const size_t ySize = batch * conv.filters * positions, pSize = dp.size();
+    std::vector<float> y(ySize), p(pSize), dy(ySize);
+    std::vector<int32_t> index(pSize);
+    BlockCost cost;
+    for (int round = 0; round < 3; round++) {
+        auto start = std::chrono::steady_clock::now();
+        convForward(conv, batch, x.data(), w.data(), nullptr, y.data(), workspace.data(), workspace.size());
+        for (size_t i = 0; i < ySize; i++) y[i] += bias[(i / positions) % conv.filters];
+        for (size_t i = 0; i < ySize; i++) y[i] = std::max(y[i], 0.0f);
+        const size_t oh = pool.outHeight(), ow = pool.outWidth();
+        for (size_t plane = 0; plane < batch * pool.channels; plane++) {
+            for (size_t i = 0; i < oh; i++) {
+                for (size_t j = 0; j < ow; j++) {
+                    size_t best = (plane * pool.height + i * pool.poolHeight) * pool.width + j * pool.poolWidth;
+                    for (size_t r = 0; r < pool.poolHeight; r++) {
+                        for (size_t c = 0; c < pool.poolWidth; c++) {
+                            size_t at = (plane * pool.height + i * pool.poolHeight + r) * pool.width + j * pool.poolWidth + c;
+                            best = y[at] > y[best] ? at : best;
+                        }
+                    }
+                    p[(plane * oh + i) * ow + j] = y[best];
+                    index[(plane * oh + i) * ow + j] = static_cast<int32_t>(best);
+                }
+            }
+        }
+        cost.forwardMillis = std::min(cost.forwardMillis, millisSince(start));
+        start = std::chrono::steady_clock::now();
+        std::fill(dy.begin(), dy.end(), 0.0f);
+        for (size_t o = 0; o < pSize; o++) dy[static_cast<size_t>(index[o])] = dp[o];
+        activationBackward(y.data(), dy.data(), ySize, Activation::ReLU);
+        cost.backwardMillis = std::min(cost.backwardMillis, millisSince(start));
+    }
+    // forward: เขียน y, bias อ่าน+เขียน, ReLU อ่าน+เขียน, pool อ่าน y เขียน p และดัชนี 4 ไบต์
+    // backward: ล้าง dy, อ่าน dp กับดัชนี, ReLU backward อ่าน y และ dy แล้วเขียน dy
+    cost.bytes = 4.0 * (6 * ySize + pSize) + 4.0 * pSize + 4.0 * (4 * ySize + pSize) + 4.0 * pSize;
+    return cost;
+}
+
+// bias + ReLU อยู่ใน epilogue ของ conv และ ReLU ถูกย้ายไปทำหลัง max บนผลลัพธ์ของ pool
+BlockCost fusedBlock(const ConvShape& conv, const PoolShape& pool, size_t batch, const std::vector<float>& x,
+                     const std::vector<float>& w, const std::vector<float>& bias, const std::vector<float>& dp,
+                     std::vector<float>& workspace) {
+    const size_t ySize = batch * conv.filters * conv.outHeight() * conv.outWidth(), pSize = dp.size();
+    std::vector<float> y(ySize), p(pSize), dy(ySize);
+    std::vector<uint8_t> argmax(pSize);
+    BlockCost cost;
+    for (int round = 0; round < 3; round++) {
+        auto start = std::chrono::steady_clock::now();
+        convForward(conv, batch, x.data(), w.data(), bias.data(), y.data(), workspace.data(), workspace.size());
+        maxPoolForward(pool, batch, y.data(), p.data(), argmax.data(), true);
+        cost.forwardMillis = std::min(cost.forwardMillis, millisSince(start));
+        start = std::chrono::steady_clock::now();
+        maxPoolBackward(pool, batch, dp.data(), argmax.data(), p.data(), true, dy.data());
+        cost.backwardMillis = std::min(cost.backwardMillis, millisSince(start));
+    }
+    // forward: เขียน y ครั้งเดียว, pool อ่าน y เขียน p และ argmax 1 ไบต์
+    // backward: ล้าง dy, อ่าน dp, argmax และ p (mask ของ ReLU)
+    cost.bytes = 4.0 * (2 * ySize + pSize) + 1.0 * pSize + 4.0 * (ySize + 2 * pSize) + 1.0 * pSize;
+    return cost;
+}
+
+// Adam + clip แบบทีละ tensor: หา norm, เขียน gradient ที่ย่อแล้วกลับ จากนั้นแต่ละ tensor อัปเดต m, v และ w
+// เป็น loop แยกกัน (เหมือน op ทีละตัวของ framework แบบ eager)
+double perTensorAdamMillis(const std::vector<size_t>& tensors, std::vector<float>& w, const std::vector<float>& grads,
+                           std::vector<float>& m, std::vector<float>& v, const OptimizerConfig& config) {
+    std::vector<float> g(grads.size());
+    double best = 1e30;
+    for (int round = 1; round <= 5; round++) {
+        g = grads;
+        auto start = std::chrono::steady_clock::now();
+        double total = 0.0;
+        for (size_t offset = 0, t = 0; t < tensors.size(); offset += tensors[t++]) {
+            for (size_t i = offset; i < offset + tensors[t]; i++) total += static_cast<double>(g[i]) * g[i];
+        }
+        float norm = static_cast<float>(std::sqrt(total));
+        if (norm > config.clipNorm) {
+            float scale = config.clipNorm / norm;
+            for (float& x : g) x *= scale;
+        }
+        float c1 = 1.0f / (1.0f - std::pow(config.beta1, static_cast<float>(round)));
+        float c2 = 1.0f / (1.0f - std::pow(config.beta2, static_cast<float>(round)));
+        for (size_t offset = 0, t = 0; t < tensors.size(); offset += tensors[t++]) {
+            size_t end = offset + tensors[t];
+            for (size_t i = offset; i < end; i++) m[i] = config.beta1 * m[i] + (1.0f - config.beta1) * g[i];
+            for (size_t i = offset; i < end; i++) v[i] = config.beta2 * v[i] + (1.0f - config.beta2) * g[i] * g[i];
+            for (size_t i = offset; i < end; i++) {
+                w[i] -= config.learningRate * c1 * m[i] / (std::sqrt(v[i] * c2) + config.epsilon);
+            }
+        }
+        best = std::min(best, millisSince(start));
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    double ghz = 0.0;
+    double seconds = 0.2;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        if (flag == "--threads") {
+            setMaxThreads(static_cast<size_t>(std::atoi(argv[i + 1])));
+        } else if (flag == "--ghz") {
+            ghz = std::atof(argv[i + 1]);
+        } else if (flag == "--seconds") {
+            seconds = std::atof(argv[i + 1]);
+        } else {
+            std::cerr << "Unknown option " << flag << "\n";
+            return 1;
+        }
+    }
+    if (ghz <= 0.0) {
+        ghz = cpuGhz();
+    }
+
+    std::vector<GemmKernel> kernels;
+    for (GemmKernel kernel : {GemmKernel::Scalar, GemmKernel::Avx2, GemmKernel::Avx512}) {
+        if (gemmKernelSupported(kernel)) {
+            kernels.push_back(kernel);
+        }
+    }
+    GemmKernel best = bestGemmKernel();
+    size_t threads = maxThreads();
+    double peak = ghz * threads * flopsPerCycle(best);
+
+    std::cout << "sgemm benchmark: " << threads << (threads == 1 ? " thread" : " threads") << ", dispatch "
+              << gemmKernelName(best) << ", ";
+    if (peak > 0.0) {
+        std::cout << std::fixed << std::setprecision(1) << "theoretical peak " << peak << " GFLOP/s (" << ghz
+                  << " GHz x " << threads << " x " << flopsPerCycle(best) << " FLOP/cycle, 2 FMA units assumed)\n";
+    } else {
+        std::cout << "unknown clock (pass --ghz to report % of peak)\n";
+    }
+    std::cout << std::left << std::setw(44) << "  layer GEMM" << std::setw(8) << "op" << std::setw(18) << "M x N x K";
+    for (GemmKernel kernel : kernels) {
+        std::cout << std::right << std::setw(10) << gemmKernelName(kernel);
+    }
+    std::cout << std::setw(9) << "% peak" << "\n";
+
+    std::set<std::tuple<bool, bool, size_t, size_t, size_t>> seen;
+    for (const Network& network : exampleNetworks()) {
+        for (const GemmShape& shape : shapesOf(network)) {
+            if (!seen.insert(std::make_tuple(shape.transA, shape.transB, shape.m, shape.n, shape.k)).second) {
+                continue;
+            }
+            std::ostringstream dims, op;
+            dims << shape.m << " x " << shape.n << " x " << shape.k;
+            op << (shape.transA ? "T" : "N") << (shape.transB ? "T" : "N");
+            std::cout << "  " << std::left << std::setw(42) << shape.use << std::setw(8) << op.str() << std::setw(18)
+                      << dims.str() << std::right << std::fixed << std::setprecision(1);
+            double dispatched = 0.0;
+            for (GemmKernel kernel : kernels) {
+                double gflops = measureGflops(shape, kernel, seconds);
+                if (kernel == best) {
+                    dispatched = gflops;
+                }
+                std::cout << std::setw(10) << gflops;
+            }
+            if (peak > 0.0) {
+                std::cout << std::setw(8) << 100.0 * dispatched / peak << "%";
+            }
+            std::cout << "\n";
+        }
+    }
+
+    // conv หนึ่งตัวอย่าง forward + backward: FLOP นับตาม convolution ตรง (Winograd ทำงานจริงน้อยกว่า)
+    std::cout << "\nconv layers (forward + backward, one sample, effective GFLOP/s)\n";
+    std::cout << std::left << std::setw(44) << "  layer" << std::right << std::setw(12) << "im2col ms" << std::setw(10)
+              << "GFLOP/s" << std::setw(13) << "winograd ms" << std::setw(10) << "GFLOP/s" << "  chosen\n";
+    std::set<std::tuple<size_t, size_t, size_t, size_t, size_t>> seenConv;
+    for (const Network& network : exampleNetworks()) {
+        LayerGraph graph = LayerGraph::compile(network.layers, network.batch);
+        for (const GraphNode& node : graph.nodes()) {
+            if (node.spec.kind != LayerKind::Conv) {
+                continue;
+            }
+            ConvShape conv = node.convShape();
+            if (!seenConv.insert(std::make_tuple(conv.channels, conv.height, conv.width, conv.filters, conv.kernel)).second) {
+                continue;
+            }
+            ConvChoice choice = selectConvAlgorithm(conv);
+            double flops = 3 * 2.0 * conv.filters * conv.patch() * conv.outHeight() * conv.outWidth();
+            std::cout << "  " << std::left << std::setw(42) << network.name + " " + node.name << std::right << std::fixed
+                      << std::setprecision(3) << std::setw(12) << choice.im2colMillis << std::setprecision(1)
+                      << std::setw(10) << flops / choice.im2colMillis / 1e6;
+            if (winogradSupported(conv)) {
+                std::cout << std::setprecision(3) << std::setw(13) << choice.winogradMillis << std::setprecision(1)
+                          << std::setw(10) << flops / choice.winogradMillis / 1e6;
+            } else {
+                std::cout << std::setw(13) << "-" << std::setw(10) << "-";
+            }
+            std::cout << "  " << convAlgorithmName(choice.algorithm) << "\n";
+        }
+    }
+
+    // บล็อก conv relu -> pool ที่กราฟรวมกัน ใช้ batch ของเครือข่ายและ im2col ทั้งสองแบบ
+    std::cout << "\nconv + bias + relu + max pool blocks (batch, forward + backward; MB = activation bytes read + written)\n";
+    std::cout << std::left << std::setw(44) << "  block" << std::right << std::setw(14) << "separate MB"
+              << std::setw(10) << "ms" << std::setw(12) << "fused MB" << std::setw(10) << "ms" << std::setw(12)
+              << "traffic" << "\n";
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    auto random = [&](size_t n) {
+        std::vector<float> v(n);
+        for (float& e : v) e = uniform(rng);
+        return v;
+    };
+    for (const Network& network : exampleNetworks()) {
+        LayerGraph graph = LayerGraph::compile(network.layers, network.batch);
+        const std::vector<GraphNode>& nodes = graph.nodes();
+        for (size_t i = 1; i < nodes.size(); i++) {
+            if (!nodes[i].fusedReLU) {
+                continue;
+            }
+            ConvShape conv = nodes[i - 1].convShape();
+            PoolShape pool{conv.filters, conv.outHeight(), conv.outWidth(), nodes[i].spec.poolHeight,
+                           nodes[i].spec.poolWidth};
+            size_t batch = network.batch;
+            std::vector<float> x = random(batch * conv.channels * conv.height * conv.width);
+            std::vector<float> w = random(conv.filters * conv.patch()), bias = random(conv.filters);
+            std::vector<float> dp = random(batch * pool.channels * pool.outHeight() * pool.outWidth());
+            std::vector<float> workspace(convWorkspaceFloats(conv, ConvAlgorithm::Im2col, false, maxThreads()));
+            BlockCost separate = separatePasses(conv, pool, batch, x, w, bias, dp, workspace);
+            BlockCost fused = fusedBlock(conv, pool, batch, x, w, bias, dp, workspace);
+            std::cout << "  " << std::left << std::setw(42)
+                      << network.name + " " + nodes[i - 1].name + "+" + nodes[i].name << std::right << std::fixed
+                      << std::setprecision(1) << std::setw(14) << separate.bytes / 1e6 << std::setw(10)
+                      << separate.forwardMillis + separate.backwardMillis << std::setw(12) << fused.bytes / 1e6
+                      << std::setw(10) << fused.forwardMillis + fused.backwardMillis << std::setw(11)
+                      << 100.0 * (1.0 - fused.bytes / separate.bytes) << "%" << " less\n";
+        }
+    }
+
+    // optimizer step ของทุกพารามิเตอร์ของเครือข่าย (weight และ bias ของแต่ละชั้นเป็น tensor แยกกันในแบบทีละ tensor)
+    std::cout << "\nadam + global-norm clip step (all parameters)\n";
+    std::cout << std::left << std::setw(44) << "  network" << std::right << std::setw(12) << "parameters"
+              << std::setw(10) << "tensors" << std::setw(16) << "per-tensor ms" << std::setw(12) << "fused ms"
+              << std::setw(10) << "speedup" << "\n";
+    OptimizerConfig adam;
+    adam.clipNorm = 1.0f;
+    for (const Network& network : exampleNetworks()) {
+        LayerGraph graph = LayerGraph::compile(network.layers, network.batch);
+        std::vector<size_t> tensors;
+        for (const GraphNode& node : graph.nodes()) {
+            if (node.parameters > 0) {
+                tensors.push_back(node.parameters - node.spec.units);
+                tensors.push_back(node.spec.units);
+            }
+        }
+        size_t count = graph.parameterCount();
+        std::vector<float> w = random(count), g = random(count), m(count), v(count);
+        double separate = perTensorAdamMillis(tensors, w, g, m, v, adam);
+        Optimizer optimizer(adam, count);
+        double fused = 1e30;
+        for (int round = 0; round < 5; round++) {
+            auto start = std::chrono::steady_clock::now();
+            optimizer.step(w.data(), g.data());
+            fused = std::min(fused, millisSince(start));
+        }
+        std::cout << "  " << std::left << std::setw(42) << network.name << std::right << std::setw(12) << count
+                  << std::setw(10) << tensors.size() << std::fixed << std::setprecision(3) << std::setw(16)
+                  << separate << std::setw(12) << fused << std::setprecision(1) << std::setw(9)
+                  << separate / fused << "x\n";
+    }
+    return 0;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file Activation.h
+ * @brief ฟังก์ชันกระตุ้นและการบวก bias แบบทีละแถว สำหรับ epilogue ของ GEMM/conv และ backward
+ */
+
+#ifndef AI_LANGUAGE_ACTIVATION_H
+#define AI_LANGUAGE_ACTIVATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ai_language {
+
+enum class Activation {
+    Linear,
+    ReLU,
+    Sigmoid,
+    Tanh,
+    Softmax
+};
+
+std::string activationName(Activation activation);
+
+/**
+ * @brief "relu", "sigmoid", "tanh", "softmax", "linear" หรือ "none"
+ * @throws std::invalid_argument ถ้าไม่รู้จัก
+ */
+Activation parseActivation(const std::string& name);
+
+/**
+ * @brief row[j] = f(row[j] + rowBias + columnBias[j]) ในที่เดิม
+ * @param columnBias nullptr ได้
+ * @throws std::invalid_argument ถ้าเป็น softmax (ต้องใช้ทั้งแถวของตัวอย่าง จึงทำในขั้น loss)
+ */
+void biasActivation(float* row, size_t n, float rowBias, const float* columnBias, Activation activation);
+
+/**
+ * @brief grad[j] *= f'(x) โดยคำนวณจากผลลัพธ์ output[j] = f(x) ที่เก็บไว้ตอน forward
+ * @throws std::invalid_argument ถ้าเป็น softmax
+ */
+void activationBackward(const float* output, float* grad, size_t n, Activation activation);
+
+/**
+ * @brief เหมือนข้างบนเมื่อผลลัพธ์ของ forward เก็บเป็น bf16 (mixed precision)
+ */
+void activationBackward(const uint16_t* output, float* grad, size_t n, Activation activation);
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_ACTIVATION_H
@@ -0,0 +1,86 @@
+/**
+ * @file Arena.h
+ * @brief arena แบบ bump pointer สำหรับหน่วยความจำชั่วคราวของหนึ่งรอบการเทรน
+ */
+
+#ifndef AI_LANGUAGE_ARENA_H
+#define AI_LANGUAGE_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @class BumpArena
+ * @brief จองหน่วยความจำโดยเลื่อนตัวชี้ไปข้างหน้าและคืนทั้งหมดในครั้งเดียวด้วย reset
+ *
+ * ถ้าบล็อกปัจจุบันไม่พอจะขอบล็อกใหม่จาก heap (นับใน heapAllocations)
+ * และ reset จะรวมทุกบล็อกเป็นก้อนเดียวขนาดเท่าที่ใช้สูงสุด รอบถัดไปที่ใช้เท่าเดิมจึงไม่จองเพิ่มอีก
+ * destructor ของวัตถุใน arena ไม่ถูกเรียก จึงรับเฉพาะชนิดที่ทำลายได้โดยไม่ต้องทำอะไร
+ */
+class BumpArena {
+public:
+    static constexpr size_t kAlignment = 64;
+
+    explicit BumpArena(size_t initialBytes = 0);
+    BumpArena(const BumpArena&) = delete;
+    BumpArena& operator=(const BumpArena&) = delete;
+    BumpArena(BumpArena&&) = default;
+    BumpArena& operator=(BumpArena&&) = default;
+
+    /**
+     * @brief พื้นที่ bytes ไบต์ที่จัดแนว kAlignment (ค่าไม่ถูกกำหนด)
+     */
+    void* allocate(size_t bytes);
+
+    template <typename T>
+    T* allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "BumpArena never runs destructors");
+        return static_cast<T*>(allocate(count * sizeof(T)));
+    }
+
+    float* allocateFloats(size_t count, bool zero = false);
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible<T>::value, "BumpArena never runs destructors");
+        return new (allocate(sizeof(T))) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief คืนพื้นที่ทั้งหมด (ตัวชี้ที่เคยได้ใช้ไม่ได้อีก)
+     */
+    void reset();
+
+    size_t used() const { return usedBytes; }
+    size_t capacity() const;
+    size_t peak() const { return peakBytes; }
+
+    /**
+     * @brief จำนวนครั้งที่ขอหน่วยความจำจาก heap ตั้งแต่สร้าง (ตัวนับสำหรับตรวจว่ารอบการเทรนไม่จองเพิ่ม)
+     */
+    size_t heapAllocations() const { return allocations; }
+
+private:
+    struct Block {
+        std::unique_ptr<char, void (*)(void*)> memory;
+        size_t size;
+    };
+
+    void addBlock(size_t bytes);
+
+    std::vector<Block> blocks;
+    size_t offset = 0;          ///< ตำแหน่งในบล็อกสุดท้าย
+    size_t usedBytes = 0;
+    size_t peakBytes = 0;
+    size_t allocations = 0;
+};
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_ARENA_H
@@ -0,0 +1,192 @@
+/**
+ * @file Autograd.h
+ * @brief reverse-mode autodiff แบบ tape: แต่ละ op บันทึกขั้น backward ของตัวเองลง arena ตามลำดับ forward
+ */
+
+#ifndef AI_LANGUAGE_AUTOGRAD_H
+#define AI_LANGUAGE_AUTOGRAD_H
+
+#include "Activation.h"
+#include "Arena.h"
+#include "Conv.h"
+#include "Pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+
+namespace ai_language {
+
+/**
+ * @brief ค่าหนึ่งค่าบน tape ขนาด batch x features (แต่ละตัวอย่างต่อเนื่องกัน เช่น NCHW ของ conv)
+ *
+ * ค่าอยู่ใน data (float32) หรือ data16 (bf16) อย่างใดอย่างหนึ่ง ส่วน grad เป็น float32 เสมอ
+ * grad ถูกจองพร้อมกันเมื่อ requiresGrad โดย op แรกที่ส่ง gradient มาเขียนทับ
+ * และ op ถัดไปบวกเพิ่ม (ค่าหนึ่งค่าจึงถูกใช้ได้หลายครั้ง)
+ */
+struct Value {
+    float* data = nullptr;
+    uint16_t* data16 = nullptr;
+    float* grad = nullptr;
+    size_t batch = 0;
+    size_t features = 0;
+    bool requiresGrad = false;
+    bool gradWritten = false;
+
+    size_t size() const { return batch * features; }
+};
+
+using Var = Value*;
+
+/**
+ * @brief weight หรือ bias หนึ่งก้อน ชี้เข้าบัฟเฟอร์ที่เจ้าของโมเดลเก็บไว้ gradient ถูกบวกสะสม
+ */
+struct Parameter {
+    float* value = nullptr;
+    float* grad = nullptr;
+    size_t size = 0;
+    const uint16_t* value16 = nullptr;  ///< สำเนา bf16 ของ value สำหรับ GEMM แบบ mixed precision (ไม่มี = nullptr)
+};
+
+/**
+ * @class Tape
+ * @brief บันทึก op ระหว่าง forward แล้วเรียก backward ย้อนลำดับ
+ *
+ * โหนดของ tape, ค่า, gradient และบัฟเฟอร์ชั่วคราวทั้งหมดมาจาก BumpArena ที่ส่งเข้ามา
+ * clear แล้ว reset arena หลังอัปเดต weight จึงไม่มีการจอง heap ในรอบที่ขนาดเท่าเดิม
+ * GemmPrecision::BFloat16 เก็บผลลัพธ์ของทุก op (รวมค่าที่เก็บไว้ให้ backward) เป็น bf16
+ * ผลรวมสะสม float32 อยู่ในไทล์ของ workspace (conv) หรือ accumulator ที่ทุก dense ใช้ก้อนเดียวกัน
+ */
+class Tape {
+public:
+    /**
+     * @param recording false สำหรับการทำนาย: op ไม่บันทึกขั้น backward และไม่จอง gradient
+     * @param precision ความละเอียดของตัวถูกคูณใน GEMM และ convolution ทุกตัวทั้ง forward และ backward
+     *        และของค่าที่ variable สร้าง
+     */
+    explicit Tape(BumpArena& arena, bool recording = true, GemmPrecision precision = GemmPrecision::Float32)
+        : memory(&arena), active(recording), gemmPrecision(precision) {}
+
+    BumpArena& arena() { return *memory; }
+    bool recording() const { return active; }
+    GemmPrecision precision() const { return gemmPrecision; }
+
+    /**
+     * @brief ค่าคงที่จากหน่วยความจำภายนอก (ไม่ต้องการ gradient)
+     */
+    Var constant(const float* data, size_t batch, size_t features);
+
+    /**
+     * @brief ค่าใหม่ใน arena (ค่าไม่ถูกกำหนด) เป็น bf16 ใน data16 เมื่อ precision() เป็น BFloat16
+     */
+    Var variable(size_t batch, size_t features, bool requiresGrad);
+
+    /**
+     * @brief บัฟเฟอร์ float32 อย่างน้อย count ค่าที่ใช้ได้จนถึงการเรียกครั้งถัดไป
+     *        (ผลรวมสะสมของ dense ก่อนปัดลงค่า bf16) จองใหม่เฉพาะเมื่อก้อนเดิมเล็กเกินไป
+     */
+    float* accumulator(size_t count);
+
+    /**
+     * @brief เก็บ op (ต้องทำลายได้โดยไม่ต้องเรียก destructor) ที่มีเมธอด backward(Tape&)
+     */
+    template <typename Op>
+    void record(const Op& op) {
+        static_assert(std::is_trivially_destructible<Op>::value, "tape ops live in the arena");
+        Node<Op>* node = memory->create<Node<Op>>(op);
+        node->previous = last;
+        last = node;
+        count++;
+    }
+
+    /**
+     * @brief เรียก backward ของทุก op ย้อนลำดับ (gradient ของผลลัพธ์สุดท้ายต้องถูกเขียนแล้ว)
+     */
+    void backward();
+
+    /**
+     * @brief ลืม op ทั้งหมด (ผู้เรียก reset arena เองหลังจากนี้)
+     */
+    void clear();
+
+    size_t size() const { return count; }
+
+    /**
+     * @brief ตำแหน่งสำหรับเขียน gradient ของ v: grad เองถ้ายังไม่มีใครเขียน หรือบัฟเฟอร์ชั่วคราว
+     *        ซึ่ง finishGradient จะบวกเข้า grad ให้
+     */
+    float* beginGradient(Var v);
+    void finishGradient(Var v, float* written);
+
+private:
+    struct NodeBase {
+        void (*run)(NodeBase* self, Tape& tape) = nullptr;
+        NodeBase* previous = nullptr;
+    };
+
+    template <typename Op>
+    struct Node : NodeBase {
+        explicit Node(const Op& value) : op(value) {
+            run = [](NodeBase* self, Tape& tape) { static_cast<Node*>(self)->op.backward(tape); };
+        }
+        Op op;
+    };
+
+    BumpArena* memory;
+    bool active;
+    GemmPrecision gemmPrecision;
+    NodeBase* last = nullptr;
+    size_t count = 0;
+    float* scratch = nullptr;
+    size_t scratchFloats = 0;
+};
+
+/**
+ * @brief งบของผลรวมสะสม float32 ที่ dense ใช้ก่อนปัดลงผลลัพธ์ bf16 (อย่างน้อย kMinAccumulatorRows แถว
+ *        เพื่อไม่ให้ต้องจัดเรียง W ใหม่บ่อยเกินไป)
+ */
+constexpr size_t kAccumulatorBudgetBytes = 256 * 1024;
+constexpr size_t kMinAccumulatorRows = 64;
+
+/**
+ * @brief จำนวนแถวของ batch ที่ dense คำนวณต่อ GEMM หนึ่งครั้งเมื่อผลลัพธ์เป็น bf16
+ */
+size_t denseAccumulatorRows(size_t batch, size_t units);
+
+/**
+ * @brief y = activation(x W^T + b) โดย W เป็น [units, x->features] (epilogue ของ sgemm)
+ *
+ * ถ้า weights.value16 ไม่เป็น nullptr GEMM ที่อ่าน W (forward และ gradient ของ x) อ่านสำเนา bf16 แทน
+ */
+Var dense(Tape& tape, Var x, Parameter weights, Parameter bias, size_t units, Activation activation);
+
+/**
+ * @brief y = activation(conv(x) + b) และ x->features ต้องเท่ากับ channels * height * width
+ */
+Var conv2d(Tape& tape, Var x, const ConvShape& shape, Parameter weights, Parameter bias, Activation activation,
+           ConvAlgorithm algorithm);
+
+/**
+ * @brief max pooling (relu = ReLU ของ conv ก่อนหน้าที่ย้ายมาทำหลัง max)
+ */
+Var maxPool(Tape& tape, Var x, const PoolShape& shape, bool relu);
+
+/**
+ * @brief inverted dropout: ค่าที่เหลือถูกคูณ 1 / (1 - rate) ตอนเทรน
+ */
+Var dropout(Tape& tape, Var x, float rate, std::mt19937& rng);
+
+/**
+ * @brief ค่าเฉลี่ยของ loss ต่อตัวอย่าง และเขียน gradient ของ output
+ *
+ * Softmax: cross entropy ของ softmax(output), Sigmoid: binary cross entropy ของ sigmoid(output)
+ * (output จึงต้องเป็น logit ที่ยังไม่ผ่าน activation) อย่างอื่น: ครึ่งหนึ่งของผลรวมกำลังสองของความต่าง
+ *
+ * @param targets batch x output->features เช่น one-hot ของ class
+ * @param predictions ถ้าไม่เป็น nullptr รับความน่าจะเป็น/ค่าทำนายหลัง activation
+ */
+float lossAndGradient(Tape& tape, Var output, Activation activation, const float* targets, float* predictions = nullptr);
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_AUTOGRAD_H
@@ -0,0 +1,129 @@
+/**
+ * @file Conv.h
+ * @brief convolution 2 มิติ (stride 1, ไม่เติมขอบ) ด้วย im2col แบบแบ่งไทล์ + GEMM หรือ Winograd F(2x2, 3x3)
+ */
+
+#ifndef AI_LANGUAGE_CONV_H
+#define AI_LANGUAGE_CONV_H
+
+#include "Activation.h"
+#include "Gemm.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ai_language {
+
+enum class ConvAlgorithm {
+    Auto,       ///< เลือกด้วย selectConvAlgorithm
+    Im2col,     ///< ขยายหน้าต่างเป็นเมทริกซ์ทีละไทล์ของตำแหน่งผลลัพธ์แล้วคูณด้วย sgemm
+    Winograd    ///< F(2x2, 3x3): คูณ 16 ครั้งต่อไทล์ผลลัพธ์ 2x2 แทน 36 (เฉพาะ kernel 3x3)
+};
+
+std::string convAlgorithmName(ConvAlgorithm algorithm);
+
+/**
+ * @brief ขนาดของ conv หนึ่งชั้น ข้อมูลเป็น NCHW และ weight เป็น [filters, channels, kernel, kernel]
+ */
+struct ConvShape {
+    size_t channels = 0;
+    size_t height = 0;
+    size_t width = 0;
+    size_t filters = 0;
+    size_t kernel = 0;
+
+    size_t outHeight() const { return height - kernel + 1; }
+    size_t outWidth() const { return width - kernel + 1; }
+    size_t patch() const { return channels * kernel * kernel; }
+};
+
+/**
+ * @brief งบหน่วยความจำของเมทริกซ์ที่ขยายแล้ว (ไทล์ im2col หรือไทล์ Winograd) ต่อเธรด
+ */
+constexpr size_t kConvCacheBudgetBytes = 256 * 1024;
+
+/**
+ * @brief จำนวนตำแหน่งผลลัพธ์ต่อไทล์ im2col ที่ทำให้ patch() x คอลัมน์ ไม่เกิน kConvCacheBudgetBytes
+ */
+size_t im2colTileColumns(const ConvShape& shape);
+
+bool winogradSupported(const ConvShape& shape);
+
+/**
+ * @brief จำนวน float ของ workspace ที่ convForward/convBackward ต้องการเมื่อใช้ threads เธรด
+ *
+ * Auto คืนค่าที่มากที่สุดของทุกวิธีที่ใช้ได้ ถ้า workspace เล็กกว่าที่ขอ จะใช้เธรดน้อยลงตามที่พอ
+ * output เป็นชนิดผลลัพธ์ของ convForward: im2col ที่เขียน bf16 ต้องมีไทล์ผลรวมสะสม float32 ต่อเธรดเพิ่ม
+ */
+size_t convWorkspaceFloats(const ConvShape& shape, ConvAlgorithm algorithm, bool backward, size_t threads,
+                           DType output = DType::Float32);
+
+/**
+ * @brief output[n] = activation(conv(input[n], weights) + bias)
+ *
+ * bias และ activation ทำใน epilogue ของ sgemm (im2col) หรือในการแปลงผลลัพธ์ (Winograd)
+ * จึงเขียน output เพียงครั้งเดียว precision ใช้กับทุก GEMM ภายใน (การแปลงของ Winograd เป็น float32 เสมอ)
+ *
+ * @param bias nullptr ได้
+ * @throws std::invalid_argument ถ้า Winograd ใช้กับ kernel ที่ไม่ใช่ 3x3, activation เป็น softmax
+ *         หรือ workspace ไม่พอแม้แต่หนึ่งเธรด
+ */
+void convForward(const ConvShape& shape, size_t batch, const float* input, const float* weights, const float* bias,
+                 float* output, float* workspace, size_t workspaceFloats,
+                 ConvAlgorithm algorithm = ConvAlgorithm::Im2col, Activation activation = Activation::Linear,
+                 GemmPrecision precision = GemmPrecision::Float32);
+
+/**
+ * @brief convForward ที่เก็บผลลัพธ์เป็น bf16 (mixed precision) จาก input ที่เป็น bf16 หรือ float32
+ *
+ * ผลรวมสะสมเป็น float32 ทีละไทล์ใน workspace (ขนาดจาก convWorkspaceFloats กับ DType::BFloat16)
+ * แล้วปัดลงผลลัพธ์หลัง bias และ activation
+ */
+void convForward(const ConvShape& shape, size_t batch, const uint16_t* input, const float* weights, const float* bias,
+                 uint16_t* output, float* workspace, size_t workspaceFloats,
+                 ConvAlgorithm algorithm = ConvAlgorithm::Im2col, Activation activation = Activation::Linear,
+                 GemmPrecision precision = GemmPrecision::Float32);
+void convForward(const ConvShape& shape, size_t batch, const float* input, const float* weights, const float* bias,
+                 uint16_t* output, float* workspace, size_t workspaceFloats,
+                 ConvAlgorithm algorithm = ConvAlgorithm::Im2col, Activation activation = Activation::Linear,
+                 GemmPrecision precision = GemmPrecision::Float32);
+
+/**
+ * @brief gradient จาก gradOutput [batch, filters, outH, outW] (คูณอนุพันธ์ของ activation มาแล้ว)
+ *
+ * เขียนทับ gradWeights และ gradBias (ผลรวมทั้ง batch) และ gradInput ถ้าไม่เป็น nullptr
+ * Winograd คำนวณ gradInput เป็น convolution แบบเติมขอบของ gradOutput กับ weight ที่กลับด้าน
+ * ส่วน gradWeights ใช้ im2col + GEMM เสมอ
+ */
+void convBackward(const ConvShape& shape, size_t batch, const float* input, const float* weights,
+                  const float* gradOutput, float* gradInput, float* gradWeights, float* gradBias, float* workspace,
+                  size_t workspaceFloats, ConvAlgorithm algorithm = ConvAlgorithm::Im2col,
+                  GemmPrecision precision = GemmPrecision::Float32);
+
+/**
+ * @brief convBackward ที่ input เก็บเป็น bf16 (อ่านเฉพาะตอนคำนวณ gradWeights)
+ */
+void convBackward(const ConvShape& shape, size_t batch, const uint16_t* input, const float* weights,
+                  const float* gradOutput, float* gradInput, float* gradWeights, float* gradBias, float* workspace,
+                  size_t workspaceFloats, ConvAlgorithm algorithm = ConvAlgorithm::Im2col,
+                  GemmPrecision precision = GemmPrecision::Float32);
+
+/**
+ * @brief ผลการวัดเวลาที่ใช้เลือกวิธีของแต่ละชั้น
+ */
+struct ConvChoice {
+    ConvAlgorithm algorithm = ConvAlgorithm::Im2col;
+    double im2colMillis = 0.0;      ///< forward + backward หนึ่งตัวอย่าง
+    double winogradMillis = 0.0;    ///< 0 ถ้าใช้ไม่ได้
+};
+
+/**
+ * @brief วัด forward + backward ของทั้งสองวิธีบนข้อมูลสุ่มหนึ่งตัวอย่างแล้วเลือกวิธีที่เร็วกว่า
+ *
+ * ผลถูกเก็บไว้ตาม shape จึงวัดเพียงครั้งเดียวต่อขนาดชั้นต่อการรันโปรแกรม
+ */
+ConvChoice selectConvAlgorithm(const ConvShape& shape);
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_CONV_H
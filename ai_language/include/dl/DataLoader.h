@@ -0,0 +1,114 @@
+/**
+ * @file DataLoader.h
+ * @brief ประกอบ minibatch ถัดไปบนเธรดเบื้องหลังระหว่างที่รอบปัจจุบันกำลังคำนวณ
+ */
+
+#ifndef AI_LANGUAGE_DATA_LOADER_H
+#define AI_LANGUAGE_DATA_LOADER_H
+
+#include "Tensor.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @brief ปรับสเกลแต่ละ feature ตอนรวบ batch: (x - offset[j]) * scale[j] (ว่าง = ไม่ปรับ)
+ */
+struct FeatureScaling {
+    std::vector<float> offset;
+    std::vector<float> scale;
+
+    bool empty() const { return offset.empty(); }
+};
+
+/**
+ * @brief ค่าเฉลี่ยและ 1 / ส่วนเบี่ยงเบนของแต่ละคอลัมน์ (คอลัมน์ที่ค่าคงที่ได้ scale 1)
+ */
+FeatureScaling standardization(const float* inputs, size_t samples, size_t features);
+
+struct DataLoaderConfig {
+    size_t batchSize = 32;
+    size_t prefetch = 2;            ///< จำนวน batch ที่เตรียมไว้ล่วงหน้าได้ นอกจาก batch ที่ผู้ใช้ถืออยู่
+    size_t epochs = 1;
+    bool shuffle = true;            ///< สลับลำดับใหม่ทุก epoch ด้วย std::mt19937(seed)
+    uint32_t seed = 42;
+};
+
+/**
+ * @class DataLoader
+ * @brief ring ของช่อง batch ที่มีผู้ผลิตหนึ่งเธรดและผู้ใช้หนึ่งเธรด ส่งต่อกันด้วยตัวนับ atomic สองตัว
+ *
+ * เธรดเบื้องหลังสลับลำดับตัวอย่าง รวบแถวตามลำดับนั้น และปรับสเกล features ลงช่องถัดไป
+ * (ต้นแต่ละช่องจัดแนว 64 ไบต์ แถวต่อกันตามที่ Network รับ) แล้วเพิ่ม produced ส่วน next คืนช่องเดิมโดยเพิ่ม consumed แล้วรับช่องถัดไป
+ * ไม่มี mutex ระหว่างสองฝั่ง: ฝ่ายที่ต้องรอจะ spin สั้น ๆ, yield แล้วจึง sleep ครั้งละน้อย
+ * ผู้ผลิตทำงานต่อเนื่องข้าม epoch จึงไม่มีช่วงว่างระหว่าง epoch
+ * ถ้าการคำนวณหนึ่งรอบนานกว่าการรวบหนึ่ง batch ผู้ใช้จะไม่ต้องรอเลยหลัง batch แรก (ดู stalls)
+ */
+class DataLoader {
+public:
+    struct Batch {
+        const float* inputs = nullptr;      ///< size x inputSize (ต่อเนื่อง)
+        const float* targets = nullptr;     ///< size x outputSize
+        size_t size = 0;
+        size_t epoch = 0;                   ///< เริ่มที่ 0
+        size_t index = 0;                   ///< ลำดับ batch ใน epoch
+    };
+
+    /**
+     * @param inputs, targets ต้องมีอายุนานกว่า DataLoader (อ่านอย่างเดียว)
+     * @throws std::invalid_argument ถ้าไม่มีตัวอย่าง, batchSize หรือ epochs เป็นศูนย์ หรือ scaling ขนาดไม่ตรง
+     */
+    DataLoader(const float* inputs, const float* targets, size_t samples, size_t inputSize, size_t outputSize,
+               const DataLoaderConfig& config, FeatureScaling scaling = FeatureScaling());
+    ~DataLoader();
+    DataLoader(const DataLoader&) = delete;
+    DataLoader& operator=(const DataLoader&) = delete;
+
+    /**
+     * @brief คืน batch ที่ถืออยู่ (ถ้ามี) แล้วรับ batch ถัดไป ข้อมูลใช้ได้จนถึงการเรียก next ครั้งต่อไป
+     * @return false เมื่อครบทุก epoch แล้ว
+     */
+    bool next(Batch& batch);
+
+    size_t batchesPerEpoch() const { return perEpoch; }
+
+    /**
+     * @brief จำนวนครั้งและเวลารวมที่ next ต้องรอผู้ผลิต ไม่นับ batch แรกซึ่งไม่มีอะไรให้เตรียมล่วงหน้าได้
+     */
+    size_t stalls() const { return stallCount; }
+    double stallSeconds() const { return stallTime; }
+
+private:
+    void produce();
+
+    const float* sourceInputs;
+    const float* sourceTargets;
+    size_t samples;
+    size_t inputSize;
+    size_t outputSize;
+    DataLoaderConfig settings;
+    FeatureScaling scaling;
+    size_t perEpoch = 0;
+    size_t total = 0;               ///< batch ทั้งหมดของทุก epoch
+    size_t slots = 0;
+    Tensor inputBuffer;             ///< [slots, batchSize * inputSize ปัดขึ้นเป็นพหุคูณของ 64 ไบต์]
+    Tensor targetBuffer;
+    std::vector<Batch> meta;        ///< ขนาดและตำแหน่งของแต่ละช่อง เขียนโดยผู้ผลิตก่อนเพิ่ม produced
+
+    alignas(64) std::atomic<size_t> produced{0};
+    alignas(64) std::atomic<size_t> consumed{0};
+    alignas(64) std::atomic<bool> stopping{false};
+    size_t delivered = 0;           ///< ฝั่งผู้ใช้: batch ที่ส่งออกไปแล้ว
+    bool holding = false;
+    size_t stallCount = 0;
+    double stallTime = 0.0;
+    std::thread worker;
+};
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_DATA_LOADER_H
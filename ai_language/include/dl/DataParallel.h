@@ -0,0 +1,85 @@
+/**
+ * @file DataParallel.h
+ * @brief เทรนแบบ data parallel บน CPU: แบ่ง minibatch ให้แบบจำลองของแต่ละเธรดแล้วรวม gradient ในหน่วยความจำร่วม
+ */
+
+#ifndef AI_LANGUAGE_DATA_PARALLEL_H
+#define AI_LANGUAGE_DATA_PARALLEL_H
+
+#include "Graph.h"
+#include "Network.h"
+#include "Optimizer.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @class DataParallelTrainer
+ * @brief แบบจำลองหนึ่งตัวต่อเธรดที่ใช้ weight ก้อนเดียวกัน แต่มี arena และ gradient ของตัวเอง
+ *
+ * step แบ่ง batch เป็นช่วงต่อเนื่องเท่า ๆ กันตามจำนวนแบบจำลอง แต่ละเธรดคำนวณ gradient ของช่วงตัวเอง
+ * จากนั้น all-reduce รวม gradient ถ่วงน้ำหนักตามจำนวนตัวอย่างลงบัฟเฟอร์ของแบบจำลองแรก:
+ * พารามิเตอร์ถูกแบ่งเป็นก้อนละ 16 KB และแต่ละเธรดรวมก้อนของตัวเองจากทุกแบบจำลองขณะก้อนนั้นยังอยู่ใน L1
+ * ผลจึงเท่ากับ gradient ของทั้ง batch และ optimizer อัปเดต weight ที่ใช้ร่วมกันเพียงครั้งเดียว
+ */
+class DataParallelTrainer {
+public:
+    /**
+     * @param replicas จำนวนแบบจำลอง (ปกติเท่าจำนวนเธรด) อย่างน้อย 1
+     * @param seed ค่าเริ่มต้นของ weight มาจากแบบจำลองแรก แบบจำลองอื่นใช้ seed ถัดไปสำหรับ dropout
+     * @param precision ของทุกแบบจำลอง (สำเนา bf16 ของ weight ก็ใช้ร่วมกัน)
+     */
+    DataParallelTrainer(const LayerGraph& graph, size_t replicas, uint32_t seed = 42,
+                        GemmPrecision precision = GemmPrecision::Float32);
+
+    /**
+     * @brief หนึ่งรอบการเทรนบน batch ทั้งก้อน
+     * @return ค่าเฉลี่ยของ loss ต่อตัวอย่างของทั้ง batch
+     */
+    float step(const float* inputs, const float* targets, size_t batch, Optimizer& optimizer);
+
+    /**
+     * @brief loss เฉลี่ยและผลทำนายของข้อมูลทั้งหมด (ทีละไม่เกิน 256 ตัวอย่าง บนแบบจำลองแรก)
+     */
+    float evaluate(const float* inputs, const float* targets, size_t count, float* predictions = nullptr);
+
+    Network& model() { return *replicas.front(); }
+    /**
+     * @brief แบบจำลองที่ r ใช้ weight ก้อนเดียวกับแบบจำลองแรก แต่ละเธรดจึงทำนายพร้อมกันบนแบบจำลองของตัวเองได้
+     */
+    Network& replica(size_t r) { return *replicas.at(r); }
+    size_t replicaCount() const { return replicas.size(); }
+
+private:
+    void allReduce(size_t shards, size_t batch);
+
+    std::vector<std::unique_ptr<Network>> replicas;
+    std::vector<float> losses;      ///< loss ของแต่ละช่วงในรอบล่าสุด
+    std::vector<size_t> offsets;    ///< ช่วงของแต่ละแบบจำลอง: [offsets[r], offsets[r + 1])
+};
+
+/**
+ * @brief เวลาต่อรอบที่จำนวนเธรดหนึ่ง
+ */
+struct ScalingPoint {
+    size_t threads = 1;
+    double millisPerStep = 0.0;
+    double speedup = 1.0;           ///< เทียบกับหนึ่งเธรด
+    double efficiency = 1.0;        ///< speedup / threads
+};
+
+/**
+ * @brief วัดเวลาต่อรอบของ batch เดียวกันที่ 1, 2, 4, ... และ maxThreads เธรด (แบบจำลองใหม่ทุกครั้ง ไม่แตะโมเดลที่เทรนอยู่)
+ *
+ * ตั้ง setMaxThreads ระหว่างวัดแล้วคืนค่าเดิม
+ */
+std::vector<ScalingPoint> measureScaling(const LayerGraph& graph, const float* inputs, const float* targets, size_t batch,
+                                         size_t maxThreads, size_t steps = 3,
+                                         GemmPrecision precision = GemmPrecision::Float32);
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_DATA_PARALLEL_H
@@ -0,0 +1,146 @@
+/**
+ * @file Gemm.h
+ * @brief SGEMM แบบแบ่งบล็อกตามแคช (Goto) พร้อม microkernel AVX2/AVX-512 ที่เลือกขณะรันโปรแกรม
+ */
+
+#ifndef AI_LANGUAGE_GEMM_H
+#define AI_LANGUAGE_GEMM_H
+
+#include "Activation.h"
+#include "Tensor.h"
+#include <cstddef>
+#include <string>
+
+namespace ai_language {
+
+enum class GemmKernel {
+    Auto,       ///< เลือกตัวที่ดีที่สุดที่ CPU รองรับ
+    Scalar,     ///< microkernel 4x8 แบบพกพา
+    Avx2,       ///< microkernel 6x16 (AVX2 + FMA, 12 ตัวสะสมใน ymm)
+    Avx512,     ///< microkernel 14x32 (AVX-512F, 28 ตัวสะสมใน zmm)
+    Avx512Bf16, ///< microkernel 14x32 ของ vdpbf16ps บนแผงคู่ bf16 (เฉพาะ GemmPrecision::BFloat16)
+    AmxBf16     ///< ไทล์ AMX-BF16 ทีละ 32x32 ของ C (เฉพาะ GemmPrecision::BFloat16)
+};
+
+std::string gemmKernelName(GemmKernel kernel);
+
+enum class GemmPrecision {
+    Float32,
+    BFloat16    ///< ตัวถูกคูณถูกปัดเป็น bfloat16 ตอนจัดเรียงแผง ผลรวมสะสมเป็น float32
+};
+
+std::string gemmPrecisionName(GemmPrecision precision);
+
+/**
+ * @brief อ่านชื่อจาก set precision: "fp32"/"float32" หรือ "bf16"/"bfloat16" (ไม่สนตัวพิมพ์)
+ * @throws std::invalid_argument ถ้าไม่รู้จักชื่อ
+ */
+GemmPrecision parseGemmPrecision(const std::string& name);
+
+/**
+ * @brief เมทริกซ์ตัวถูกคูณหนึ่งตัว: float32 หรือ bfloat16 (uint16_t) แบบ row-major
+ * @param transposed เก็บแบบสลับแกน (เหมือน transA/transB ของ sgemm)
+ */
+struct GemmOperand {
+    GemmOperand(const float* values, size_t ld, bool transposed = false)
+        : data(values), ld(ld), transposed(transposed), dtype(DType::Float32) {}
+    GemmOperand(const uint16_t* values, size_t ld, bool transposed = false)
+        : data(values), ld(ld), transposed(transposed), dtype(DType::BFloat16) {}
+
+    const void* data;
+    size_t ld;
+    bool transposed;
+    DType dtype;
+};
+
+/**
+ * @brief microkernel ที่ sgemm ใช้เมื่อส่ง GemmKernel::Auto
+ */
+GemmKernel bestGemmKernel();
+
+/**
+ * @brief kernel ของ gemm แบบ GemmPrecision::BFloat16 กับ GemmKernel::Auto: AmxBf16, Avx512Bf16
+ *        หรือ bestGemmKernel() ซึ่งคูณค่าที่ปัดเป็น bf16 แล้วด้วย FMA ของ float32 (จำลอง)
+ */
+GemmKernel bestBf16GemmKernel();
+
+bool gemmKernelSupported(GemmKernel kernel);
+
+/**
+ * @brief ขนาดบล็อกของ microkernel หนึ่งตัว
+ *
+ * แถบ A ขนาด mc x kc อยู่ใน L2, แถบ B ขนาด kc x nc อยู่ใน L3
+ * และ microkernel คำนวณ C ทีละ mr x nr จากแผง A (mr x kc) กับแผง B (kc x nr) ที่จัดเรียงไว้ต่อเนื่อง
+ */
+struct GemmBlocking {
+    size_t mr = 0;
+    size_t nr = 0;
+    size_t mc = 0;
+    size_t kc = 0;
+    size_t nc = 0;
+};
+
+/**
+ * @brief Auto หมายถึง bestGemmKernel() ส่วน kernel ของ bf16 คืนบล็อกที่นับความลึกเป็นค่า bf16
+ * @throws std::invalid_argument ถ้า CPU ไม่รองรับ kernel
+ */
+GemmBlocking gemmBlocking(GemmKernel kernel = GemmKernel::Auto);
+
+/**
+ * @brief C = alpha * op(A) * op(B) + beta * C แบบ row-major
+ *
+ * op(A) มีขนาด m x k และ op(B) มีขนาด k x n โดย transA/transB บอกว่า A หรือ B ถูกเก็บแบบสลับแกน
+ * lda/ldb/ldc คือระยะห่างระหว่างแถว (หน่วยเป็นสมาชิก) เมื่อ beta เป็นศูนย์จะไม่อ่าน C เดิม
+ * งานถูกแบ่งตามไทล์ของ M (เมื่อมีหลายบล็อก) หรือของ N ด้วย parallelFor
+ *
+ * @throws std::invalid_argument ถ้า leading dimension เล็กกว่าความกว้างของเมทริกซ์หรือ CPU ไม่รองรับ kernel
+ */
+void sgemm(bool transA, bool transB, size_t m, size_t n, size_t k, float alpha, const float* a, size_t lda,
+           const float* b, size_t ldb, float beta, float* c, size_t ldc, GemmKernel kernel = GemmKernel::Auto);
+
+/**
+ * @brief งานที่ทำกับไทล์ของ C ทันทีหลังบล็อก K สุดท้ายขณะไทล์ยังอยู่ใน L1
+ *
+ * C[i][j] = activation(C[i][j] + rowBias[i] + columnBias[j]) แทนการอ่านและเขียน C ทั้งก้อนอีกหลายรอบ
+ * เช่น conv (ผลลัพธ์ filters x ตำแหน่ง) ใช้ rowBias ส่วน dense (batch x นิวรอน) ใช้ columnBias
+ */
+struct GemmEpilogue {
+    const float* rowBias = nullptr;       ///< ความยาว m
+    const float* columnBias = nullptr;    ///< ความยาว n
+    Activation activation = Activation::Linear;
+
+    bool empty() const { return rowBias == nullptr && columnBias == nullptr && activation == Activation::Linear; }
+};
+
+/**
+ * @brief sgemm ตามด้วย epilogue ในรอบเดียวกัน
+ * @throws std::invalid_argument เพิ่มเติมถ้า epilogue เป็น softmax
+ */
+void sgemm(bool transA, bool transB, size_t m, size_t n, size_t k, float alpha, const float* a, size_t lda,
+           const float* b, size_t ldb, float beta, float* c, size_t ldc, const GemmEpilogue& epilogue,
+           GemmKernel kernel = GemmKernel::Auto);
+
+/**
+ * @brief C = alpha * op(A) * op(B) + beta * C เมื่อตัวถูกคูณเป็น float32 หรือ bfloat16 ผสมกันได้
+ *
+ * ค่า bf16 ถูกขยายเป็น float32 ตรง ๆ ตอนจัดเรียงแผง ส่วน GemmPrecision::BFloat16 ปัดค่า float32 เป็น bf16 ด้วย
+ * (หนึ่งครั้งต่อค่า ไม่ใช่ต่อการคูณ) ผลรวมสะสมและ C เป็น float32 เสมอ
+ * kernel AmxBf16 และ Avx512Bf16 จัดเรียงแผงเป็น bf16 (ขนาดครึ่งหนึ่งของ float32) โดย B เป็นคู่ตามแนว K
+ * ส่วน kernel ของ float32 คูณค่าที่ปัดแล้วด้วย FMA ของ float32 ซึ่งได้ผลเดียวกันจนถึงลำดับการบวก
+ *
+ * @throws std::invalid_argument เช่นเดียวกับ sgemm หรือถ้าใช้ kernel ของ bf16 กับ GemmPrecision::Float32
+ */
+void gemm(size_t m, size_t n, size_t k, float alpha, const GemmOperand& a, const GemmOperand& b, float beta, float* c,
+          size_t ldc, const GemmEpilogue& epilogue = GemmEpilogue(), GemmPrecision precision = GemmPrecision::Float32,
+          GemmKernel kernel = GemmKernel::Auto);
+
+/**
+ * @brief c = alpha * op(a) * op(b) + beta * c บน Tensor float32 สองมิติ (รวมมุมมองที่แกนในสุดต่อเนื่อง)
+ * @throws std::invalid_argument ถ้า shape หรือชนิดไม่ตรงกัน
+ */
+void matmul(const Tensor& a, const Tensor& b, Tensor& c, bool transA = false, bool transB = false,
+            float alpha = 1.0f, float beta = 0.0f, GemmKernel kernel = GemmKernel::Auto);
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_GEMM_H
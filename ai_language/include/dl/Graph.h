@@ -0,0 +1,164 @@
+/**
+ * @file Graph.h
+ * @brief คอมไพล์คำสั่ง add layer เป็นกราฟที่มีชนิดและ shape ชัดเจน พร้อมลำดับขั้นตอน forward/backward
+ */
+
+#ifndef AI_LANGUAGE_GRAPH_H
+#define AI_LANGUAGE_GRAPH_H
+
+#include "Activation.h"
+#include "Conv.h"
+#include "Tensor.h"
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ai_language {
+
+enum class LayerKind {
+    Input,
+    Conv,       ///< convolution แบบ stride 1 ไม่เติมขอบ (valid)
+    Pool,       ///< max pooling ที่หน้าต่างไม่ซ้อนกัน
+    Flatten,
+    Dense,      ///< hidden, dense และ output
+    Dropout
+};
+
+std::string layerKindName(LayerKind kind);
+
+/**
+ * @brief รายละเอียดของ layer หนึ่งชั้นที่อ่านจากข้อความที่ DLInterpreter เก็บไว้
+ */
+struct LayerSpec {
+    LayerKind kind = LayerKind::Dense;
+    std::vector<size_t> shape;      ///< Input: {features} หรือ {channels, height, width}
+    size_t units = 0;               ///< Dense: จำนวนนิวรอน, Conv: จำนวน filter
+    size_t kernel = 0;              ///< Conv: ขนาด kernel (สี่เหลี่ยมจัตุรัส)
+    size_t poolHeight = 0;
+    size_t poolWidth = 0;
+    float rate = 0.0f;              ///< Dropout
+    Activation activation = Activation::Linear;
+    bool output = false;            ///< มาจาก "output" ต้องเป็นชั้นสุดท้าย
+    std::string source;             ///< ข้อความต้นฉบับ เช่น "conv:32:3:relu"
+
+    /**
+     * @brief อ่านรูปแบบ "input:784:linear", "input:28x28x1" (กว้าง x สูง x ช่องสี), "conv:32:3:relu",
+     *        "pool:2x2", "flatten", "hidden:128:relu", "dense:128:relu", "output:10:softmax", "dropout:0.2"
+     * @throws std::invalid_argument ถ้ารูปแบบหรือค่าไม่ถูกต้อง
+     */
+    static LayerSpec parse(const std::string& text);
+
+    /**
+     * @brief เช่น "conv 32x3x3 relu"
+     */
+    std::string describe() const;
+};
+
+/**
+ * @brief ค่าหนึ่งค่าในกราฟ (activation, gradient, ผลรวมสะสม หรือพื้นที่ทำงานชั่วคราว) รวมมิติ batch แล้ว
+ */
+struct GraphValue {
+    std::string name;               ///< เช่น "conv1.out", "conv1.grad", "conv1.acc", "conv1.workspace"
+    std::vector<size_t> shape;
+    DType dtype = DType::Float32;
+    int aliasOf = -1;               ///< เป็นมุมมองบนค่าอื่น (flatten) ไม่มีบัฟเฟอร์ของตัวเอง
+
+    size_t bytes() const;
+};
+
+/**
+ * @brief หนึ่งขั้นตอนของการคำนวณตามลำดับเวลา ใช้หาอายุ (liveness) ของแต่ละค่า
+ */
+struct GraphStep {
+    std::string name;               ///< เช่น "forward conv1", "loss", "backward dense2"
+    size_t node = 0;
+    std::vector<size_t> reads;
+    std::vector<size_t> writes;
+};
+
+struct GraphNode {
+    LayerSpec spec;
+    std::string name;               ///< เช่น "conv1", "dense3"
+    std::vector<size_t> inputShape; ///< ต่อหนึ่งตัวอย่าง (ไม่รวม batch)
+    std::vector<size_t> outputShape;
+    size_t parameters = 0;          ///< จำนวน weight + bias
+    size_t input = 0;               ///< ค่าที่อ่าน
+    size_t output = 0;              ///< ค่าที่เขียน
+    int gradient = -1;              ///< gradient ของ output (-1 = ไม่ต้องคำนวณ)
+    int argmax = -1;                ///< Pool ตอนเทรน: ตำแหน่งสูงสุดในหน้าต่าง หนึ่งไบต์ต่อผลลัพธ์
+    bool activationFused = false;   ///< Conv: ReLU ทำโดย pool ถัดไป output จึงเป็นค่า linear
+    bool fusedReLU = false;         ///< Pool: ทำ ReLU ของ conv ก่อนหน้า
+
+    /**
+     * @brief ขนาดสำหรับ convForward/convBackward (เฉพาะ LayerKind::Conv)
+     */
+    ConvShape convShape() const;
+};
+
+/**
+ * @class LayerGraph
+ * @brief กราฟเชิงเส้นของ layer ที่ผ่านการอนุมาน shape ทุกชั้นแล้ว
+ *
+ * compile ตรวจ shape ทั้งหมดก่อนมีการคำนวณใด ๆ เช่น conv หลัง flatten หรือ dense บนข้อมูลสามมิติ
+ * และสร้างลำดับขั้นตอน: โหลด batch, forward ทีละชั้น, loss, backward ย้อนกลับ
+ * (โหมดทำนายมีเฉพาะ forward และ dropout เป็นมุมมองบนค่าเดิม)
+ * activation สุดท้ายที่เป็น softmax หรือ sigmoid รวมอยู่ในขั้น loss จึงไม่ต้องเก็บไว้สำหรับ backward
+ * conv ที่ใช้ ReLU และตามด้วย pool ถูกรวมเป็นบล็อกเดียว: pool ทำ ReLU และ backward ใช้ argmax กับผลลัพธ์ของ pool
+ * ผลลัพธ์เต็มขนาดของ conv จึงหมดอายุหลัง forward ของ pool
+ * GemmPrecision::BFloat16: batch ที่โหลดและผลลัพธ์ของทุกชั้นเป็น bf16 ส่วน gradient และ workspace เป็น float32
+ * dense มีผลรวมสะสม float32 ขนาดไม่เกิน denseAccumulatorRows แถวที่มีอายุเฉพาะขั้น forward ของชั้นนั้น
+ */
+class LayerGraph {
+public:
+    LayerGraph() = default;
+
+    /**
+     * @throws std::invalid_argument พร้อมลำดับชั้นและเหตุผล ถ้า layer หรือ shape ไม่สอดคล้องกัน
+     */
+    static LayerGraph compile(const std::vector<std::string>& layers, size_t batchSize, bool training = true,
+                              GemmPrecision precision = GemmPrecision::Float32);
+
+    const std::vector<GraphNode>& nodes() const { return layerNodes; }
+    const std::vector<GraphValue>& values() const { return graphValues; }
+    const std::vector<GraphStep>& steps() const { return schedule; }
+    size_t batchSize() const { return batch; }
+    bool training() const { return trainingMode; }
+    GemmPrecision precision() const { return activationPrecision; }
+    bool empty() const { return layerNodes.empty(); }
+    size_t parameterCount() const;
+    const std::vector<size_t>& outputShape() const;
+
+    /**
+     * @brief ตารางชั้น shape และจำนวนพารามิเตอร์
+     */
+    void print(std::ostream& os) const;
+
+private:
+    size_t addValue(const std::string& name, std::vector<size_t> shape, DType dtype = DType::Float32);
+    size_t aliasValue(const std::string& name, size_t target, std::vector<size_t> shape);
+
+    std::vector<GraphNode> layerNodes;
+    std::vector<GraphValue> graphValues;
+    std::vector<GraphStep> schedule;
+    size_t batch = 0;
+    bool trainingMode = true;
+    GemmPrecision activationPrecision = GemmPrecision::Float32;
+};
+
+/**
+ * @brief สถาปัตยกรรมที่ใช้เมื่อผู้ใช้ไม่ได้เพิ่ม layer (ตรงกับที่ show model แสดง)
+ */
+std::vector<std::string> defaultLayers(size_t neuronsPerLayer);
+
+/**
+ * @brief layers ที่มี input แบบแบนขนาด features นำหน้า (ถ้าประกาศ input layer ไว้แล้วคืนค่าเดิม)
+ *
+ * จำนวน features ของไฟล์ CSV บอกขนาด input แบบแบนได้ แต่บอก กว้าง x สูง x ช่องสี ของรูปภาพไม่ได้
+ * @throws std::invalid_argument ถ้ามี conv หรือ pool (ต้องประกาศ input รูปภาพเอง) หรือ features เป็นศูนย์
+ */
+std::vector<std::string> withInferredInput(const std::vector<std::string>& layers, size_t features);
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_GRAPH_H
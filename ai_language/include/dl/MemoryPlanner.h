@@ -0,0 +1,81 @@
+/**
+ * @file MemoryPlanner.h
+ * @brief วางทุก activation และ gradient ของกราฟลงใน arena ก้อนเดียว โดยใช้พื้นที่ซ้ำเมื่ออายุไม่ซ้อนกัน
+ */
+
+#ifndef AI_LANGUAGE_MEMORY_PLANNER_H
+#define AI_LANGUAGE_MEMORY_PLANNER_H
+
+#include "Graph.h"
+#include "Tensor.h"
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @brief บัฟเฟอร์หนึ่งก้อนใน arena ใช้งานตั้งแต่ขั้น firstStep ถึง lastStep (รวมทั้งสองขั้น)
+ */
+struct PlannedBuffer {
+    size_t value = 0;       ///< ค่าในกราฟที่เป็นเจ้าของ (มุมมองของ flatten ใช้บัฟเฟอร์นี้ร่วมกัน)
+    size_t offset = 0;      ///< ไบต์จากต้น arena (จัดแนว Tensor::kAlignment)
+    size_t bytes = 0;       ///< ปัดขึ้นเป็นพหุคูณของ Tensor::kAlignment
+    size_t firstStep = 0;
+    size_t lastStep = 0;
+};
+
+/**
+ * @class MemoryPlan
+ * @brief แผนหน่วยความจำแบบคงที่ที่คำนวณก่อนเริ่มเทรน
+ *
+ * อายุของแต่ละค่าคือช่วงจากขั้นแรกถึงขั้นสุดท้ายที่อ่านหรือเขียนค่านั้นหรือมุมมองของมัน
+ * วางบัฟเฟอร์จากใหญ่ไปเล็ก (greedy by size) ที่ offset ต่ำสุดที่ไม่ทับบัฟเฟอร์ที่มีอายุซ้อนกัน
+ * ระหว่างเทรนจึงไม่มีการจองหน่วยความจำเพิ่ม ทุก Tensor เป็นมุมมองบน arena
+ */
+class MemoryPlan {
+public:
+    MemoryPlan() = default;
+
+    static MemoryPlan build(const LayerGraph& graph);
+
+    size_t arenaBytes() const { return peak; }
+    /** @brief ผลรวมเมื่อแต่ละค่ามีบัฟเฟอร์ของตัวเอง */
+    size_t naiveBytes() const { return naive; }
+    size_t stepCount() const { return steps; }
+    const std::vector<PlannedBuffer>& buffers() const { return planned; }
+
+    /**
+     * @throws std::out_of_range ถ้าค่านั้นไม่ถูกใช้ในขั้นตอนใดเลย
+     */
+    const PlannedBuffer& bufferOf(size_t value) const;
+
+    /**
+     * @brief จอง arena ขนาด arenaBytes() ที่จัดแนว 64 ไบต์
+     */
+    Tensor allocateArena() const;
+
+    /**
+     * @brief มุมมองของค่า value บน arena ตาม shape และชนิดในกราฟ
+     * @throws std::invalid_argument ถ้า arena เล็กกว่าแผน
+     */
+    Tensor bind(Tensor& arena, size_t value) const;
+
+    /**
+     * @brief สรุป peak เทียบกับผลรวมแบบไม่ใช้ซ้ำ
+     * @param float32Plan ถ้าไม่เป็น nullptr เทียบ peak กับแผนของกราฟเดียวกันที่ activation เป็น float32 ด้วย
+     */
+    void print(std::ostream& os, const MemoryPlan* float32Plan = nullptr) const;
+
+private:
+    std::vector<PlannedBuffer> planned;
+    std::vector<int> bufferIndex;       ///< ค่าในกราฟ -> ลำดับใน planned (-1 = ไม่ใช้)
+    std::vector<GraphValue> values;
+    size_t peak = 0;
+    size_t naive = 0;
+    size_t steps = 0;
+};
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_MEMORY_PLANNER_H
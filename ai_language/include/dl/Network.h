@@ -0,0 +1,144 @@
+/**
+ * @file Network.h
+ * @brief โมเดลที่เทรนได้จริงจาก LayerGraph: weight แบบบัฟเฟอร์เดียว forward/backward ผ่าน tape
+ */
+
+#ifndef AI_LANGUAGE_NETWORK_H
+#define AI_LANGUAGE_NETWORK_H
+
+#include "Arena.h"
+#include "Autograd.h"
+#include "Graph.h"
+#include "Optimizer.h"
+#include "Tensor.h"
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @class Network
+ * @brief weight และ gradient ของทุกชั้นอยู่ต่อกันใน Tensor ก้อนเดียว ส่วนค่าระหว่างทางอยู่ใน BumpArena
+ *
+ * หนึ่งรอบการเทรนคือ computeGradients -> Optimizer::step -> endStep ซึ่ง clear tape และ reset arena
+ * หลังรอบแรกของแต่ละขนาด batch arena ใหญ่พอแล้ว และ parallelFor ใช้ชุดเธรดถาวร รอบถัดไปจึงไม่จอง heap เลย
+ * (build แบบ debug ตรวจ arena ทุกรอบ ส่วน dl_test นับทุก operator new ของรอบที่ใช้หลายเธรด)
+ * conv ที่ ReLU ถูกรวมเข้า pool และ softmax/sigmoid ของชั้นสุดท้ายถูกรวมเข้า loss ตามที่ LayerGraph กำหนด
+ *
+ * GemmPrecision::BFloat16 (mixed precision): ผลลัพธ์ของทุกชั้นใน arena รวมค่าที่เก็บไว้ให้ backward เป็น bf16
+ * (ครึ่งหนึ่งของ float32) weight หลักยังเป็น float32 ที่ optimizer อัปเดต และมีสำเนา bf16 ที่สร้างใหม่หลังทุกการอัปเดต
+ * dense อ่าน W จากสำเนานี้ ส่วน conv ปัด weight หลักตอนจัดเรียงแผง (Winograd ต้องแปลง weight เป็น float32 อยู่แล้ว)
+ * ผลรวมสะสมของ GEMM, loss, gradient และ state ของ optimizer เป็น float32
+ */
+class Network {
+public:
+    /**
+     * @param seed สำหรับค่าเริ่มต้นของ weight (He สำหรับ ReLU, Xavier สำหรับอย่างอื่น, bias เป็นศูนย์) และ dropout
+     * @param precision ความละเอียดของตัวถูกคูณใน GEMM/convolution ทุกตัวทั้งตอนเทรนและตอนทำนาย
+     * @throws std::invalid_argument ถ้ากราฟไม่ได้ compile สำหรับการเทรน
+     */
+    explicit Network(const LayerGraph& graph, uint32_t seed = 42, GemmPrecision precision = GemmPrecision::Float32);
+
+    /**
+     * @brief ล้าง gradient แล้ว forward, loss และ backward บน batch เดียว
+     * @param inputs batch x inputSize()
+     * @param targets batch x outputSize() (one-hot สำหรับ softmax)
+     * @return ค่าเฉลี่ยของ loss ต่อตัวอย่าง
+     */
+    float computeGradients(const float* inputs, const float* targets, size_t batch);
+
+    /**
+     * @brief อัปเดต weight ด้วย gradient ของรอบนี้ (คืน norm ตาม Optimizer::step)
+     * @throws std::invalid_argument ถ้า optimizer ถูกสร้างสำหรับจำนวนพารามิเตอร์อื่น
+     */
+    float applyOptimizer(Optimizer& optimizer);
+
+    /**
+     * @brief คืนหน่วยความจำชั่วคราวทั้งหมดของรอบนี้
+     * @throws std::logic_error (เฉพาะ build แบบ debug) ถ้ารอบที่ขนาดเคยเห็นแล้วยังจอง heap
+     */
+    void endStep();
+
+    /**
+     * @brief computeGradients + applyOptimizer + endStep
+     */
+    float trainStep(const float* inputs, const float* targets, size_t batch, Optimizer& optimizer);
+
+    /**
+     * @brief forward อย่างเดียว (dropout ไม่ทำงาน)
+     * @param predictions ถ้าไม่เป็น nullptr รับผลทำนายหลัง activation สุดท้าย batch x outputSize()
+     */
+    float evaluate(const float* inputs, const float* targets, size_t batch, float* predictions = nullptr);
+
+    /**
+     * @brief ใช้บัฟเฟอร์ weight เดียวกับ source (แบบจำลองของเธรดอื่นใน data parallel ที่มีค่าระหว่างทางและ gradient ของตัวเอง)
+     * @throws std::invalid_argument ถ้าโครงสร้างต่างกัน
+     */
+    void shareParameters(const Network& source);
+
+    /**
+     * @brief สร้างสำเนา bf16 ใหม่จาก weight หลัก (ต้องเรียกเองถ้าแก้ parameters() โดยตรงในโหมด BFloat16)
+     */
+    void refreshWeightCopy();
+
+    /**
+     * @brief weight ที่ optimizer อัปเดต (float32 เสมอ)
+     */
+    Tensor& parameters() { return weights; }
+    Tensor& gradients() { return grads; }
+    const Tensor& gradients() const { return grads; }
+    size_t parameterCount() const { return weights.numel(); }
+    size_t inputSize() const { return inputFeatures; }
+    size_t outputSize() const { return outputFeatures; }
+    GemmPrecision precision() const { return gemmPrecision; }
+
+    /**
+     * @brief จำนวนครั้งที่ arena จอง heap ในรอบล่าสุด (รวม reset ท้ายรอบ)
+     */
+    size_t lastStepHeapAllocations() const { return stepAllocations; }
+
+    /**
+     * @brief พื้นที่ arena สูงสุดที่เคยใช้ในหนึ่งรอบ (ค่าระหว่างทาง, gradient และบัฟเฟอร์ชั่วคราว)
+     */
+    size_t arenaPeakBytes() const { return arena.peak(); }
+
+private:
+    struct Layer {
+        LayerKind kind = LayerKind::Dense;
+        Activation activation = Activation::Linear;
+        ConvShape conv;
+        PoolShape pool;
+        ConvAlgorithm algorithm = ConvAlgorithm::Im2col;
+        size_t units = 0;
+        size_t weightOffset = 0;
+        size_t weightSize = 0;
+        size_t biasOffset = 0;
+        bool fusedReLU = false;
+        float rate = 0.0f;
+    };
+
+    Var forward(Tape& tape, const float* inputs, size_t batch);
+    Parameter parameter(size_t offset, size_t size);
+
+    std::vector<Layer> layers;
+    Tensor weights;
+    Tensor weights16;               ///< สำเนา bf16 ของ weights (ว่างเมื่อเป็น Float32)
+    Tensor grads;
+    BumpArena arena;
+    std::mt19937 rng;
+    GemmPrecision gemmPrecision;
+    Activation lossActivation = Activation::Linear;   ///< Softmax/Sigmoid เมื่อรวมเข้า loss
+    size_t inputFeatures = 0;
+    size_t outputFeatures = 0;
+    size_t stepStart = 0;           ///< heapAllocations ของ arena ตอนเริ่มรอบ
+    size_t stepAllocations = 0;
+    size_t stepBatch = 0;
+    size_t warmBatch = 0;           ///< batch ใหญ่สุดที่ arena รองรับแล้ว
+    size_t warmThreads = 0;         ///< จำนวนเธรดตอนนั้น (workspace ของ conv ขึ้นกับจำนวนเธรด)
+};
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_NETWORK_H
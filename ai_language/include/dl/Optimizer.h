@@ -0,0 +1,86 @@
+/**
+ * @file Optimizer.h
+ * @brief SGD, SGD + momentum, Adam และ AdamW ที่อัปเดตทุก weight ในรอบเดียวบนบัฟเฟอร์แบน
+ */
+
+#ifndef AI_LANGUAGE_OPTIMIZER_H
+#define AI_LANGUAGE_OPTIMIZER_H
+
+#include "Tensor.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ai_language {
+
+enum class OptimizerKind {
+    SGD,
+    Momentum,   ///< SGD + momentum: buffer = momentum * buffer + g
+    Adam,
+    AdamW       ///< Adam ที่ weight decay แยกจาก gradient (decoupled)
+};
+
+std::string optimizerName(OptimizerKind kind);
+
+/**
+ * @brief อ่านชื่อจาก set optimizer เช่น "sgd", "momentum", "adam", "adamw" (ไม่สนตัวพิมพ์)
+ * @throws std::invalid_argument ถ้าไม่รู้จักชื่อ
+ */
+OptimizerKind parseOptimizer(const std::string& name);
+
+struct OptimizerConfig {
+    OptimizerKind kind = OptimizerKind::Adam;
+    float learningRate = 0.001f;
+    float momentum = 0.9f;          ///< Momentum
+    float beta1 = 0.9f;             ///< Adam, AdamW
+    float beta2 = 0.999f;
+    float epsilon = 1e-8f;
+    float weightDecay = 0.0f;       ///< AdamW: w *= 1 - lr * weightDecay, อย่างอื่น: บวก weightDecay * w เข้า gradient
+    float clipNorm = 0.0f;          ///< ย่อ gradient ทั้งหมดให้ norm รวมไม่เกินค่านี้ (0 = ไม่ clip)
+};
+
+/**
+ * @class Optimizer
+ * @brief ถือ moment ของทุกพารามิเตอร์ในบัฟเฟอร์ต่อเนื่องก้อนเดียวที่เรียงตรงกับ weight
+ *
+ * step อ่าน weight, gradient และ moment แต่ละค่าครั้งเดียว: clip, weight decay, อัปเดต moment
+ * และ weight ทำใน loop เดียวกันด้วย AVX-512/AVX2 (เลือกตอนรัน) โดยแบ่งช่วงให้หลายเธรด
+ * เมื่อเปิด clipNorm ต้องรู้ norm รวมก่อนอัปเดตค่าแรก จึงมีรอบอ่าน gradient อย่างเดียวหนึ่งรอบก่อนหน้า
+ * และตัวคูณของการ clip ถูกใช้ใน loop อัปเดตโดยไม่เขียน gradient ที่ถูกย่อกลับลงหน่วยความจำ
+ */
+class Optimizer {
+public:
+    /**
+     * @throws std::invalid_argument ถ้าค่าใน config อยู่นอกช่วง (เช่น learning rate ไม่เป็นบวก, beta ไม่อยู่ใน [0, 1))
+     */
+    Optimizer(const OptimizerConfig& config, size_t parameters);
+
+    /**
+     * @brief อัปเดต weight ทั้งหมดหนึ่งครั้ง
+     * @return norm รวมของ gradient ก่อน clip (0 ถ้าไม่ได้เปิด clipNorm)
+     *
+     * ถ้า norm ไม่เป็นจำนวนจำกัด (gradient ระเบิด) จะไม่แตะ weight และ moment เลย ผู้เรียกตรวจจากค่าที่คืน
+     */
+    float step(float* weights, const float* gradients);
+
+    const OptimizerConfig& config() const { return settings; }
+    void setLearningRate(float learningRate);
+    size_t parameterCount() const { return count; }
+    size_t steps() const { return stepCount; }
+
+    /**
+     * @brief ไบต์ของ moment (0 สำหรับ SGD, หนึ่งชุดสำหรับ momentum, สองชุดสำหรับ Adam/AdamW)
+     */
+    size_t stateBytes() const { return moments.empty() ? 0 : moments.nbytes(); }
+
+private:
+    OptimizerConfig settings;
+    size_t count = 0;
+    size_t stepCount = 0;
+    Tensor moments;                 ///< [ชุด, count]: momentum หรือ m กับ v ของ Adam
+    std::vector<double> partials;   ///< ผลรวมกำลังสองต่อก้อนของ parallelFor (โตอย่างเดียว)
+};
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_OPTIMIZER_H
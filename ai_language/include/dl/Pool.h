@@ -0,0 +1,65 @@
+/**
+ * @file Pool.h
+ * @brief max pooling แบบหน้าต่างไม่ซ้อนกัน พร้อม ReLU ที่รวมเข้ามาและ argmax หนึ่งไบต์ต่อผลลัพธ์
+ */
+
+#ifndef AI_LANGUAGE_POOL_H
+#define AI_LANGUAGE_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ai_language {
+
+/**
+ * @brief ขนาดของ pooling หนึ่งชั้น ข้อมูลเป็น NCHW ขอบที่เหลือไม่ครบหน้าต่างถูกตัดทิ้ง
+ */
+struct PoolShape {
+    size_t channels = 0;
+    size_t height = 0;
+    size_t width = 0;
+    size_t poolHeight = 0;
+    size_t poolWidth = 0;
+
+    size_t outHeight() const { return height / poolHeight; }
+    size_t outWidth() const { return width / poolWidth; }
+};
+
+/**
+ * @brief output = max ของแต่ละหน้าต่าง (relu: max(0, max) ซึ่งเท่ากับ max ของ ReLU เพราะทั้งสองเป็นฟังก์ชันเพิ่ม)
+ *
+ * เมื่อรวม ReLU ของ conv ก่อนหน้าไว้ที่นี่ conv เขียนผลลัพธ์แบบ linear ครั้งเดียว
+ * และไม่ต้องมีรอบอ่าน/เขียน activation ทั้งก้อนเพื่อทำ ReLU
+ *
+ * @param argmax ตำแหน่งในหน้าต่าง (แถว * poolWidth + คอลัมน์) ต่อผลลัพธ์หนึ่งตัว nullptr ได้ (โหมดทำนาย)
+ * @throws std::invalid_argument ถ้าหน้าต่างว่าง ใหญ่กว่าข้อมูล หรือมีเกิน 256 ตำแหน่ง
+ */
+void maxPoolForward(const PoolShape& shape, size_t batch, const float* input, float* output, uint8_t* argmax,
+                    bool relu = false);
+
+/**
+ * @brief เหมือนข้างบนสำหรับ mixed precision: ผลลัพธ์เป็น bf16 และ input เป็น bf16 หรือ float32 (pool ถัดจาก input layer)
+ */
+void maxPoolForward(const PoolShape& shape, size_t batch, const uint16_t* input, uint16_t* output, uint8_t* argmax,
+                    bool relu = false);
+void maxPoolForward(const PoolShape& shape, size_t batch, const float* input, uint16_t* output, uint8_t* argmax,
+                    bool relu = false);
+
+/**
+ * @brief gradInput = gradient ที่ส่งไปยังตำแหน่ง argmax เท่านั้น (ตำแหน่งอื่นเป็นศูนย์)
+ * @param output ผลลัพธ์ของ forward เมื่อ relu เป็นจริง: หน้าต่างที่ได้ 0 ไม่ส่ง gradient ต่อ
+ *        จึงไม่ต้องอ่าน activation ทั้งก้อนของ conv อีกครั้ง
+ */
+void maxPoolBackward(const PoolShape& shape, size_t batch, const float* gradOutput, const uint8_t* argmax,
+                     const float* output, bool relu, float* gradInput);
+
+/**
+ * @brief maxPoolBackward ที่มี ReLU รวมเข้ามาเมื่อผลลัพธ์ของ forward เก็บเป็น bf16
+ *        (ไม่มี ReLU ไม่ต้องอ่านผลลัพธ์ จึงใช้ฟังก์ชันข้างบนกับ output = nullptr ได้เลย)
+ */
+void maxPoolBackward(const PoolShape& shape, size_t batch, const float* gradOutput, const uint8_t* argmax,
+                     const uint16_t* output, float* gradInput);
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_POOL_H
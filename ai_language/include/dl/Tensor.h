@@ -0,0 +1,200 @@
+/**
+ * @file Tensor.h
+ * @brief Tensor หลายมิติที่จัดแนวหน่วยความจำ 64 ไบต์ พร้อม shape/stride และมุมมอง (view) ที่ไม่คัดลอกข้อมูล
+ */
+
+#ifndef AI_LANGUAGE_TENSOR_H
+#define AI_LANGUAGE_TENSOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @brief ชนิดของสมาชิกใน Tensor
+ */
+enum class DType {
+    Float32,
+    BFloat16,   ///< 16 บิตบนของ float32 (exponent เท่ากัน, mantissa 7 บิต)
+    Int8        ///< ค่าจริง = q * quantScale() (quantization แบบสมมาตร)
+};
+
+size_t dtypeSize(DType dtype);
+std::string dtypeName(DType dtype);
+
+/**
+ * @brief แปลง float เป็น bfloat16 ด้วยการปัดเศษไปหาเลขคู่ที่ใกล้ที่สุด (NaN ยังคงเป็น NaN)
+ */
+inline uint16_t floatToBf16(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    if ((bits & 0x7fffffffu) > 0x7f800000u) {
+        return static_cast<uint16_t>((bits >> 16) | 0x40u);
+    }
+    bits += 0x7fffu + ((bits >> 16) & 1u);
+    return static_cast<uint16_t>(bits >> 16);
+}
+
+inline float bf16ToFloat(uint16_t value) {
+    uint32_t bits = static_cast<uint32_t>(value) << 16;
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+/**
+ * @brief แปลงเป็นชุด (ใช้ AVX2 เมื่อ CPU รองรับ ผลตรงกับฟังก์ชันทีละค่า)
+ */
+void floatToBf16(const float* in, uint16_t* out, size_t count);
+void bf16ToFloat(const uint16_t* in, float* out, size_t count);
+
+/**
+ * @brief อ่าน/เขียนหนึ่งค่าของบัฟเฟอร์ float32 หรือ bf16 ให้ template ชุดเดียวรับได้ทั้งสองชนิด
+ */
+inline float loadFloat(float value) { return value; }
+inline float loadFloat(uint16_t value) { return bf16ToFloat(value); }
+inline void storeFloat(float& target, float value) { target = value; }
+inline void storeFloat(uint16_t& target, float value) { target = floatToBf16(value); }
+
+template <typename T>
+struct DTypeOf;
+template <>
+struct DTypeOf<float> { static constexpr DType value = DType::Float32; };
+template <>
+struct DTypeOf<uint16_t> { static constexpr DType value = DType::BFloat16; };
+template <>
+struct DTypeOf<int8_t> { static constexpr DType value = DType::Int8; };
+
+/**
+ * @class Tensor
+ * @brief มุมมองแบบ strided บนบัฟเฟอร์หนึ่งก้อน
+ *
+ * Tensor ที่สร้างด้วย shape เป็นเจ้าของบัฟเฟอร์ที่จัดแนว kAlignment ไบต์ (ค่าเริ่มต้นเป็นศูนย์)
+ * การคัดลอก Tensor, view, slice, select และ transpose ใช้บัฟเฟอร์เดียวกันโดยไม่คัดลอกข้อมูล
+ * (นับการอ้างอิงร่วมกัน) ส่วน wrap สร้างมุมมองบนหน่วยความจำภายนอก เช่น arena ของกราฟ โดยไม่เป็นเจ้าของ
+ * stride มีหน่วยเป็นจำนวนสมาชิก ไม่ใช่ไบต์
+ */
+class Tensor {
+public:
+    static constexpr size_t kAlignment = 64;
+
+    Tensor() = default;
+    explicit Tensor(const std::vector<size_t>& shape, DType dtype = DType::Float32);
+
+    /**
+     * @brief มุมมองบนหน่วยความจำที่ผู้เรียกเป็นเจ้าของ (ต้องมีอายุนานกว่า Tensor และทุก view)
+     */
+    static Tensor wrap(void* data, const std::vector<size_t>& shape, DType dtype = DType::Float32);
+
+    /**
+     * @brief คัดลอกค่า float ต่อเนื่องเข้า Tensor ใหม่ขนาด shape
+     */
+    static Tensor fromData(const float* values, const std::vector<size_t>& shape);
+
+    const std::vector<size_t>& shape() const { return dims; }
+    const std::vector<size_t>& strides() const { return steps; }
+    size_t dim() const { return dims.size(); }
+    size_t size(size_t axis) const;
+    size_t numel() const;
+    size_t nbytes() const { return numel() * dtypeSize(kind); }
+    DType dtype() const { return kind; }
+    bool empty() const { return base == nullptr; }
+    bool isContiguous() const;
+    bool ownsStorage() const { return static_cast<bool>(storage); }
+
+    float quantScale() const { return scale; }
+    void setQuantScale(float value) { scale = value; }
+
+    /**
+     * @brief ตัวชี้ไปยังสมาชิกแรกของมุมมอง
+     * @throws std::invalid_argument ถ้า T ไม่ตรงกับ dtype()
+     */
+    template <typename T>
+    T* data() {
+        checkType(DTypeOf<T>::value);
+        return static_cast<T*>(raw());
+    }
+    template <typename T>
+    const T* data() const {
+        checkType(DTypeOf<T>::value);
+        return static_cast<const T*>(raw());
+    }
+    void* raw() { return static_cast<uint8_t*>(base) + offset * dtypeSize(kind); }
+    const void* raw() const { return static_cast<const uint8_t*>(base) + offset * dtypeSize(kind); }
+
+    /**
+     * @brief อ่านหรือเขียนหนึ่งสมาชิกเป็น float (แปลงจาก bf16/int8 ให้)
+     * @throws std::out_of_range ถ้าดัชนีเกินขอบเขต
+     */
+    float at(const std::vector<size_t>& index) const;
+    void set(const std::vector<size_t>& index, float value);
+
+    /**
+     * @brief มุมมองที่เปลี่ยน shape (ต้องต่อเนื่องและจำนวนสมาชิกเท่าเดิม)
+     */
+    Tensor view(const std::vector<size_t>& shape) const;
+
+    /**
+     * @brief มุมมองช่วง [begin, end) ทีละ step บนแกน axis
+     */
+    Tensor slice(size_t axis, size_t begin, size_t end, size_t step = 1) const;
+
+    /**
+     * @brief มุมมองที่เลือกดัชนีเดียวบนแกน axis และตัดแกนนั้นออก
+     */
+    Tensor select(size_t axis, size_t index) const;
+
+    Tensor transpose(size_t a, size_t b) const;
+
+    /**
+     * @brief คืนตัวเองถ้าต่อเนื่องอยู่แล้ว ไม่เช่นนั้นคัดลอกเป็น Tensor ใหม่ที่ต่อเนื่อง
+     */
+    Tensor contiguous() const;
+    Tensor clone() const;
+
+    /**
+     * @brief แปลงชนิด (int8 ใช้ scale = max|x| / 127 แบบสมมาตร)
+     */
+    Tensor to(DType dtype) const;
+
+    /**
+     * @brief คัดลอกค่าจาก source ที่ shape เท่ากัน (แปลงชนิดให้ถ้าต่างกัน)
+     */
+    void copyFrom(const Tensor& source);
+
+    void fill(float value);
+
+    /**
+     * @brief เช่น "float32[32, 128]" และ " (strided)" ถ้าไม่ต่อเนื่อง
+     */
+    std::string describe() const;
+
+private:
+    void checkType(DType expected) const;
+    size_t elementOffset(const std::vector<size_t>& index) const;
+
+    std::shared_ptr<void> storage;   ///< ว่างสำหรับมุมมองจาก wrap
+    void* base = nullptr;
+    size_t offset = 0;               ///< ตำแหน่งสมาชิกแรก (หน่วยเป็นสมาชิก)
+    std::vector<size_t> dims;
+    std::vector<size_t> steps;
+    DType kind = DType::Float32;
+    float scale = 1.0f;
+};
+
+/**
+ * @brief stride แบบ row-major ของ shape
+ */
+std::vector<size_t> contiguousStrides(const std::vector<size_t>& shape);
+
+std::string shapeToString(const std::vector<size_t>& shape);
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_TENSOR_H
@@ -61,12 +61,14 @@ public:
     virtual void handlePredictCommand(const std::vector<std::string>& args) = 0;
     virtual void handleListModelsCommand() = 0;
     virtual void handleDeleteModelCommand(const std::vector<std::string>& args) = 0;
-    virtual void handleCompareModelsCommand() = 0;
+    virtual void handleCompareModelsCommand(const std::vector<std::string>& args) = 0;
     virtual void handleCheckStatusCommand() = 0;
     virtual void handleDebugCommand(const std::vector<std::string>& args) = 0;
     virtual void handleCrossValidateCommand(const std::vector<std::string>& args) = 0;
     virtual void handleExportResultsCommand(const std::vector<std::string>& args) = 0;
     virtual void handleScheduleTrainingCommand(const std::vector<std::string>& args) = 0;
+    // recommend model (ค่าเริ่มต้น: แจ้งว่าไม่รองรับ)
+    virtual void handleRecommendCommand(const std::vector<std::string>& args);
 
     // Utility methods
     std::string getCurrentDateTime();
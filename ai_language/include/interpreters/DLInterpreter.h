@@ -2,8 +2,15 @@
 #define AI_LANGUAGE_DLINTERPRETER_H
 
 #include "BaseInterpreter.h"
+#include "../dl/DataLoader.h"
+#include "../dl/DataParallel.h"
+#include "../dl/Graph.h"
+#include "../dl/MemoryPlanner.h"
+#include "../dl/Optimizer.h"
+#include "../ml/Dataset.h"
 #include <string>
 #include <map>
+#include <memory>
 #include <vector>
 
 namespace ai_language {
@@ -14,8 +21,33 @@ private:
     std::vector<std::string> layers;
     std::map<std::string, std::string> stringParameters; // เพิ่มแมพสำหรับเก็บค่าพารามิเตอร์ที่เป็นสตริง
     std::map<std::string, double> parameters;
+    LayerGraph graph;       // กราฟที่คอมไพล์จาก layers ตอน train
+    MemoryPlan memoryPlan;  // ค่าประมาณ peak ของ activation/gradient ต่อหนึ่ง replica (Network จองจริงใน BumpArena ของตัวเอง)
+    MemoryPlan float32Plan; // กราฟเดียวกันแบบ activation fp32 ไว้เทียบเมื่อ set precision "bf16" (ว่างถ้าเป็น fp32)
+    Dataset dataset;        // ข้อมูล CSV จาก load (ว่าง = train ใช้ข้อมูลสังเคราะห์ตาม shape ของ input)
+    std::unique_ptr<DataParallelTrainer> trainer;
+    FeatureScaling trainedScaling;  // การปรับสเกล features ของ train ล่าสุด (ใช้กับไฟล์ที่ทำนายภายหลัง)
+    std::vector<std::string> trainedClassNames;
+    std::vector<std::vector<std::string>> trainedFeatureCategories;
+    float trainLoss = 0.0f;
+    float trainAccuracy = -1.0f;    // -1 = งาน regression
+    bool syntheticData = false;     // train ล่าสุดใช้ข้อมูลสังเคราะห์ ค่า loss/accuracy จึงไม่ใช่ผลของชุดข้อมูลจริง
+
+    void printConvChoices() const;
+    OptimizerConfig optimizerConfig() const;   // จาก set optimizer, learning_rate, momentum, beta1, beta2, weight_decay, clip_norm
+    OptimizerConfig optimizerConfig(OptimizerKind kind) const;   // พารามิเตอร์เดียวกันแต่ใช้ optimizer kind
+    GemmPrecision trainingPrecision() const;   // จาก set precision (ค่าเริ่มต้น fp32)
+    // layers ที่จะคอมไพล์ (เติม input layer จากจำนวน features ของ CSV ถ้าไม่ได้ประกาศ); false พร้อมข้อความถ้าอนุมานไม่ได้
+    bool resolveArchitecture(std::vector<std::string>& architecture);
+    // features (samples x input) ที่ standardize แล้วและเป้าหมาย (samples x output) ตาม network; false ถ้าไม่ตรงกัน
+    bool prepareTrainingData(const LayerGraph& network, std::vector<float>& inputs, std::vector<float>& targets,
+                             size_t& samples, FeatureScaling& scaling);
+    void printScaling(const float* inputs, const float* targets, size_t count);
+    // show feature_importance [on "file"]: permutation importance ของเครือข่ายบนแถว held-out
+    void showFeatureImportance(const std::vector<std::string>& args);
 
 public:
+    DLInterpreter();
     void interpret();
     void setDefaultParameters() override;
     void addLayer(const std::string& layerType, const std::map<std::string, std::string>& params);
@@ -42,7 +74,7 @@ public:
     void handlePredictCommand(const std::vector<std::string>& args) override;
     void handleListModelsCommand() override;
     void handleDeleteModelCommand(const std::vector<std::string>& args) override;
-    void handleCompareModelsCommand() override;
+    void handleCompareModelsCommand(const std::vector<std::string>& args) override;
     void handleCheckStatusCommand() override;
     void handleDebugCommand(const std::vector<std::string>& args) override;
     void handleCrossValidateCommand(const std::vector<std::string>& args) override;
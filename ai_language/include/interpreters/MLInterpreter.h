@@ -3,7 +3,12 @@
 
 #include "BaseInterpreter.h"
 #include "../connectors/ScikitLearnConnector.h"
+#include "../ml/Dataset.h"
+#include "../ml/Metrics.h"
+#include "../ml/Model.h"
+#include "../ml/PCA.h"
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -21,6 +26,40 @@ private:
     std::map<std::string, std::string> stringParameters;
     std::string modelType;
     std::vector<std::map<std::string, std::string>> layers; // Store neural network layers
+    std::string datasetPath;
+    Dataset dataset;                 // ข้อมูลที่โหลดจากไฟล์ CSV
+    std::unique_ptr<MLModel> model;  // โมเดลที่ทำงานในตัวภาษา (nullptr ถ้ายังไม่รองรับประเภทนี้)
+    size_t trainedRows;              // จำนวนแถวแรกของ dataset ที่โมเดลเห็นแล้ว (แถวที่เหลือคือข้อมูลใหม่)
+    double lastFullFitSeconds;       // เวลาของการเทรนเต็มครั้งล่าสุด เพื่อเทียบกับการเทรนเพิ่ม
+    std::vector<std::string> trainedClassNames;  // ชื่อคลาสตามรหัสที่โมเดลใช้อยู่
+    std::vector<std::vector<std::string>> trainedFeatureCategories;  // รหัสของ feature ที่เป็นข้อความที่โมเดลใช้อยู่
+    std::string trainedTarget;       // คอลัมน์เป้าหมายที่โมเดลเทรนด้วย
+    MetricsReport lastMetrics;       // ผลของ evaluate model ครั้งล่าสุด
+    bool hasMetrics;
+    std::string metricsSource;       // ชุดข้อมูลที่ใช้คำนวณ lastMetrics
+    std::shared_ptr<const PCA> projection;         // PCA ที่ใช้กับ dataset ปัจจุบัน (preprocess pca)
+    std::shared_ptr<const PCA> trainedProjection;  // PCA ที่โมเดลเทรนด้วย ใช้ฉายข้อมูลดิบก่อนทำนาย/ประเมิน
+
+    // คำนวณตัวชี้วัดของโมเดลบนชุดข้อมูลและเก็บไว้ใน lastMetrics
+    bool computeMetrics(Dataset& data, const std::string& source);
+    // ใช้ผลล่าสุด หรือประเมินบนข้อมูลที่โหลดไว้ถ้ายังไม่เคยประเมิน
+    bool ensureMetrics();
+    // permutation importance บนข้อมูลที่โหลดไว้หรือไฟล์ที่ระบุ พร้อม gain ของการแบ่งสำหรับโมเดลต้นไม้
+    void showFeatureImportance(const std::vector<std::string>& args);
+    // preprocess pca components N: แทน features ของ dataset ด้วยแกนหลัก N แกน
+    void preprocessPCA(const std::vector<std::string>& args);
+    // preprocess polynomial degree N [interaction_only]: พจน์พหุนามที่โมเดลเชิงเส้นขยายเองทีละแถว (ไม่แก้ dataset)
+    void preprocessPolynomial(const std::vector<std::string>& args);
+    // export model "m.cpp" [on "raw.csv"]: ซอร์ส C++ สำหรับทำนายพร้อม benchmark harness
+    void exportModelSource(const std::vector<std::string>& args);
+    // ฉายข้อมูลดิบที่โหลดจากไฟล์ด้วย PCA ของโมเดล (ไม่ทำอะไรถ้าโมเดลไม่ได้เทรนบนข้อมูลที่ฉายแล้ว)
+    void projectForModel(Dataset& data) const;
+
+    // รวบรวมพารามิเตอร์จากคำสั่ง set สำหรับสร้างโมเดล
+    ModelParams currentModelParams() const;
+    void printPredictions(const std::vector<float>& predictions, size_t count, double seconds);
+    // ชื่อคลาส/ค่าเป้าหมาย หรือหมายเลขกลุ่มสำหรับโมเดลที่ไม่ใช้เป้าหมาย
+    std::string formatPrediction(float value) const;
 
 public:
     MLInterpreter();
@@ -31,7 +70,7 @@ public:
     // Additional functions
     void setDefaultParameters();
     void loadModel(const std::string& modelPath);
-    void trainModel();
+    void trainModel(bool incremental = false);
     void evaluateModel();
     void saveModel(const std::string& modelPath);
     void createModel(const std::string& modelType);
@@ -57,12 +96,16 @@ public:
     void handlePredictCommand(const std::vector<std::string>& args) override;
     void handleListModelsCommand() override;
     void handleDeleteModelCommand(const std::vector<std::string>& args) override;
-    void handleCompareModelsCommand() override;
+    // compare models [<A>, <B>, ...]: เทรนพร้อมกันบนการแบ่งข้อมูลเดียวกัน แล้วแสดงคะแนน เวลา และขนาด
+    void handleCompareModelsCommand(const std::vector<std::string>& args) override;
+    // recommend model [budget <วินาที>]: สรุปชุดข้อมูลและจัดอันดับโมเดลด้วยโมเดลตัวแทนบนแถวตัวอย่าง
+    void handleRecommendCommand(const std::vector<std::string>& args) override;
     void handleCheckStatusCommand() override;
     void handleDebugCommand(const std::vector<std::string>& args) override;
     void handleCrossValidateCommand(const std::vector<std::string>& args) override;
     void handleExportResultsCommand(const std::vector<std::string>& args) override;
     void handleScheduleTrainingCommand(const std::vector<std::string>& args) override;
+    void showModelInfo() override;
 
     // เพิ่มฟังก์ชันสำหรับรับวันที่และเวลาปัจจุบัน
     std::string getCurrentDateTime();
@@ -107,7 +107,7 @@ private:
     void handlePredictCommand(const std::vector<std::string>& args) override;
     void handleListModelsCommand() override;
     void handleDeleteModelCommand(const std::vector<std::string>& args) override;
-    void handleCompareModelsCommand() override;
+    void handleCompareModelsCommand(const std::vector<std::string>& args) override;
     void handleCheckStatusCommand() override;
     void handleDebugCommand(const std::vector<std::string>& args) override;
     void handleCrossValidateCommand(const std::vector<std::string>& args) override;
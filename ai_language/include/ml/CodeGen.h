@@ -0,0 +1,92 @@
+/**
+ * @file CodeGen.h
+ * @brief สร้างซอร์ส C++ แบบไม่พึ่งไลบรารีสำหรับทำนายด้วยโมเดลที่เทรนแล้ว (export model "m.cpp")
+ */
+
+#ifndef AI_LANGUAGE_CODEGEN_H
+#define AI_LANGUAGE_CODEGEN_H
+
+#include "Model.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ai_language {
+
+class PCA;
+
+/**
+ * @class SourceWriter
+ * @brief ตัวช่วยเขียนโค้ดที่สร้างขึ้น: ย่อหน้า ค่าคงที่ float ที่แปลงกลับได้ตรงทุกบิต และอาร์เรย์ constexpr
+ *
+ * โมเดลที่รองรับต้องเขียนฟังก์ชัน `static float model(const float* x)` ที่ให้ผลเหมือน predictBatch
+ * (ดู MLModel::emitSource) ชื่ออื่นที่ขึ้นต้นด้วย k หรือ model_ สงวนไว้ให้โมเดลใช้ได้อิสระ
+ */
+class SourceWriter {
+public:
+    explicit SourceWriter(std::ostream& os) : os(os) {}
+
+    /**
+     * @brief เริ่มบรรทัดใหม่ตามระดับย่อหน้าปัจจุบัน
+     */
+    std::ostream& line();
+    void indent() { depth++; }
+    void dedent() { depth--; }
+
+    /**
+     * @brief `constexpr float name[count] = {...};`
+     */
+    void floatArray(const std::string& name, const float* values, size_t count);
+    void floatArray(const std::string& name, const std::vector<float>& values) {
+        floatArray(name, values.data(), values.size());
+    }
+
+    /**
+     * @brief คืนดัชนีของค่ามากสุดใน scores[width] เป็น float (ค่าเท่ากันเลือกตัวแรกเหมือน std::max_element)
+     */
+    void returnArgmax(const std::string& scores, size_t width);
+
+    /**
+     * @brief ค่าคงที่ float ที่อ่านกลับได้ค่าเดิม (รวม inf และ NaN)
+     */
+    static std::string literal(float value);
+
+private:
+    std::ostream& os;
+    int depth = 0;
+};
+
+/**
+ * @brief ข้อมูลประกอบการส่งออกโมเดล
+ */
+struct SourceExportOptions {
+    std::string fileName;                  ///< ใช้ในคอมเมนต์วิธีคอมไพล์
+    const PCA* projection = nullptr;       ///< ฉายข้อมูลดิบก่อนเข้าโมเดล (preprocess pca)
+    std::vector<std::string> featureNames; ///< ชื่อ input ตามลำดับ
+    std::vector<std::string> classNames;   ///< ชื่อคลาสสำหรับ predict_label (ว่างถ้าไม่ใช่การจำแนกประเภท)
+    const float* sampleRows = nullptr;     ///< แถวข้อมูลดิบสำหรับ benchmark harness (ว่างได้)
+    size_t sampleCount = 0;
+};
+
+/**
+ * @brief ผลการส่งออก
+ */
+struct SourceExportReport {
+    size_t bytes = 0;
+    size_t sampleRows = 0;
+    double interpreterRowNanos = 0.0;    ///< predict ทีละแถวผ่าน MLModel (รวมการฉาย PCA)
+    double interpreterBatchNanos = 0.0;  ///< predictBatch ต่อแถว
+};
+
+/**
+ * @brief เขียนไฟล์ C++ ที่มี `float predict(const float* x)` และ benchmark harness
+ *
+ * harness อยู่ใน `#ifdef AI_LANGUAGE_BENCHMARK` และฝังแถวตัวอย่าง ผลทำนายของ interpreter
+ * และ latency ของเส้นทาง predict ของ interpreter ที่วัดตอนส่งออก เพื่อตรวจว่าผลตรงกันและเทียบความเร็ว
+ * @throw std::invalid_argument ถ้าโมเดลส่งออกเป็นโค้ดไม่ได้
+ */
+SourceExportReport exportModelSource(const MLModel& model, const SourceExportOptions& options, std::ostream& os);
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_CODEGEN_H
@@ -0,0 +1,86 @@
+/**
+ * @file Compare.h
+ * @brief compare models: เทรนโมเดลหลายประเภทพร้อมกันบนการแบ่งข้อมูลชุดเดียวกันแล้ววัดคะแนน เวลา และขนาด
+ */
+
+#ifndef AI_LANGUAGE_COMPARE_H
+#define AI_LANGUAGE_COMPARE_H
+
+#include "Model.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @brief ผลของโมเดลหนึ่งประเภทในการเปรียบเทียบ
+ */
+struct ModelComparison {
+    std::string type;
+    double score = 0.0;             ///< accuracy หรือ R^2 บนชุดทดสอบ
+    double trainSeconds = 0.0;      ///< เวลาเทรน (wall time ขณะเทรนพร้อมโมเดลอื่น)
+    size_t threads = 0;             ///< จำนวนคอร์ที่ตัวจัดตารางให้ระหว่างเทรน
+    double latencyMicros = 0.0;     ///< เวลาทำนายหนึ่งแถว (predictOne) วัดหลังเทรนเสร็จทั้งหมด
+    double batchMicros = 0.0;       ///< เวลาทำนายต่อแถวเมื่อทำนายทั้งชุดทดสอบด้วย predictBatch
+    size_t modelBytes = 0;          ///< MLModel::memoryBytes() (0 = ไม่ทราบ)
+    std::string error;              ///< ข้อความเมื่อสร้างหรือเทรนไม่สำเร็จ
+
+    bool ok() const { return error.empty(); }
+};
+
+/**
+ * @brief ผลการเปรียบเทียบ เรียงจากคะแนนสูงไปต่ำ (โมเดลที่ล้มเหลวอยู่ท้ายสุด)
+ */
+struct ComparisonReport {
+    bool classification = false;
+    size_t trainRows = 0;
+    size_t testRows = 0;
+    size_t cores = 0;
+    double splitSeconds = 0.0;      ///< เวลาแบ่งข้อมูลที่ทุกโมเดลใช้ร่วมกัน
+    double trainWallSeconds = 0.0;  ///< เวลารวมของการเทรนพร้อมกันทั้งหมด
+    std::vector<ModelComparison> results;
+
+    /**
+     * @return nullptr ถ้าไม่มีโมเดลใดเทรนสำเร็จ
+     */
+    const ModelComparison* best() const;
+
+    void print(std::ostream& os) const;
+};
+
+struct CompareOptions {
+    double testSize = 0.2;          ///< สัดส่วนแถวทดสอบ (แบ่งแบบ stratified สำหรับการจำแนกประเภท)
+    unsigned seed = 42;
+    ModelParams params;             ///< พารามิเตอร์ที่ส่งให้ทุกโมเดล
+    size_t latencyRows = 256;       ///< จำนวนแถวทดสอบที่ใช้วัดเวลาทำนายทีละแถว
+};
+
+/**
+ * @brief โมเดลที่เปรียบเทียบเมื่อผู้ใช้ไม่ได้ระบุ (เฉพาะโมเดลที่เหมาะกับประเภทงาน)
+ */
+std::vector<std::string> defaultComparisonModels(bool classification);
+
+/**
+ * @brief แบ่งแถวเป็นชุดเทรนและชุดทดสอบ (stratified ตามคลาสเมื่อ classification) แต่ละชุดเรียงตามลำดับเดิม
+ * @param labels ค่าเป้าหมายต่อแถว (classification: ดัชนีคลาส)
+ * @throws std::invalid_argument ถ้า testSize ไม่อยู่ในช่วง (0, 1) หรือชุดใดชุดหนึ่งว่าง
+ */
+void splitTrainTest(const std::vector<float>& labels, bool classification, double testSize, unsigned seed,
+                    std::vector<size_t>& trainRows, std::vector<size_t>& testRows);
+
+/**
+ * @brief เทรนโมเดลทุกประเภทพร้อมกันและวัดผลบนชุดทดสอบเดียวกัน
+ *
+ * แบ่งข้อมูลครั้งเดียว ทุกโมเดลอ่านชุดเทรนและชุดทดสอบเดียวกันโดยไม่คัดลอก
+ * การเทรนใช้ scheduleTasks: โมเดลที่เทรนแบบขนานได้ (เช่น RandomForest) ได้หลายคอร์
+ * โมเดลที่เทรนแบบลำดับได้คอร์เดียว รวมกันไม่เกินจำนวนคอร์ที่ใช้ได้
+ * เวลาทำนายวัดทีละโมเดลหลังเทรนเสร็จทั้งหมด เพื่อไม่ให้การเทรนของโมเดลอื่นรบกวน
+ *
+ * @throws std::invalid_argument ถ้าไม่มีโมเดลหรือข้อมูลน้อยเกินกว่าจะแบ่ง
+ */
+ComparisonReport compareModels(const Dataset& data, const std::vector<std::string>& types, const CompareOptions& options);
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_COMPARE_H
@@ -0,0 +1,111 @@
+/**
+ * @file Dataset.h
+ * @brief ชุดข้อมูลตัวเลขในหน่วยความจำสำหรับโมเดล Machine Learning
+ */
+
+#ifndef AI_LANGUAGE_DATASET_H
+#define AI_LANGUAGE_DATASET_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @class Dataset
+ * @brief เก็บ features แบบ row-major (rows x cols) และคอลัมน์เป้าหมายแยกต่างหาก
+ *
+ * คอลัมน์ที่เป็นข้อความจะถูกแปลงเป็นรหัสตัวเลข (label encoding)
+ * ถ้าคอลัมน์เป้าหมายเป็นข้อความ ชื่อคลาสจะถูกเก็บไว้ใน classNames
+ */
+class Dataset {
+public:
+    std::vector<std::string> featureNames;
+    std::string targetName;
+    std::vector<float> features;          ///< rows * cols, row-major
+    std::vector<float> targets;           ///< ค่าเป้าหมายหนึ่งค่าต่อแถว
+    std::vector<std::string> classNames;  ///< ชื่อคลาสเมื่อเป้าหมายเป็นข้อความ
+    std::vector<std::vector<std::string>> featureCategories;  ///< ข้อความของแต่ละ feature ตามรหัส (ว่าง = คอลัมน์ตัวเลข)
+    size_t rows = 0;
+    size_t cols = 0;
+    bool classification = false;          ///< กำหนดตอนโหลดข้อมูล
+
+    const float* row(size_t index) const { return features.data() + index * cols; }
+    float* row(size_t index) { return features.data() + index * cols; }
+    bool empty() const { return rows == 0; }
+
+    /**
+     * @brief เป้าหมายเป็นงานจำแนกประเภทหรือไม่
+     *
+     * จริงเมื่อเป้าหมายเป็นข้อความ หรือเป็นจำนวนเต็มที่มีค่าไม่ซ้ำกันไม่เกิน 20 ค่า
+     * และไม่เกินครึ่งหนึ่งของจำนวนแถว
+     */
+    bool isClassification() const { return classification; }
+
+    /**
+     * @brief จำนวนคลาส (ค่าเป้าหมายสูงสุด + 1) สำหรับงานจำแนกประเภท
+     */
+    size_t numClasses() const;
+
+    /**
+     * @brief แปลงค่าทำนายเป็นข้อความ (ใช้ชื่อคลาสถ้ามี)
+     */
+    std::string formatTarget(float value) const;
+
+    /**
+     * @brief สร้างชุดข้อมูลย่อยจากดัชนีแถวที่กำหนด
+     */
+    Dataset subset(const std::vector<size_t>& indices) const;
+
+    /**
+     * @brief ต่อแถวจากชุดข้อมูลอื่นที่มีคอลัมน์เหมือนกัน
+     *
+     * รหัสคลาสและรหัสของ feature ที่เป็นข้อความถูกแปลงให้ตรงกับของชุดนี้ (ข้อความใหม่ต่อท้าย)
+     * @return false ถ้าจำนวนคอลัมน์ไม่ตรงกัน
+     */
+    bool append(const Dataset& other);
+
+    /**
+     * @brief เปลี่ยนรหัสคลาสให้ตรงกับรายชื่อคลาสอ้างอิง (คลาสใหม่ต่อท้าย)
+     *
+     * ใช้เมื่อเทรนโมเดลเดิมเพิ่มด้วยไฟล์ใหม่ ซึ่งอาจเรียงชื่อคลาสต่างจากไฟล์แรก
+     */
+    void alignClasses(const std::vector<std::string>& reference);
+
+    /**
+     * @brief เปลี่ยนรหัสของ feature ที่เป็นข้อความให้ตรงกับพจนานุกรมอ้างอิง (ข้อความใหม่ต่อท้าย)
+     *
+     * ใช้กับไฟล์ที่โหลดแยกจากข้อมูลเทรน ซึ่งให้รหัสตามลำดับที่พบในไฟล์ของตัวเอง
+     */
+    void alignFeatureCategories(const std::vector<std::vector<std::string>>& reference);
+};
+
+/**
+ * @brief โหลดไฟล์ CSV ที่มีแถวหัวตาราง
+ * @param path พาธของไฟล์ (เครื่องหมายคำพูดรอบพาธจะถูกตัดออก)
+ * @param targetColumn ชื่อคอลัมน์เป้าหมาย (ว่าง = คอลัมน์สุดท้าย)
+ * @param out ชุดข้อมูลผลลัพธ์
+ * @param error ข้อความข้อผิดพลาดเมื่อโหลดไม่สำเร็จ
+ * @return true ถ้าโหลดสำเร็จ
+ */
+bool loadCsvDataset(const std::string& path, const std::string& targetColumn,
+                    Dataset& out, std::string& error);
+
+/**
+ * @brief โหลดเฉพาะ features จากไฟล์ CSV สำหรับการทำนาย
+ *
+ * ถ้าไฟล์มีคอลัมน์มากกว่า expectedCols หนึ่งคอลัมน์ คอลัมน์สุดท้ายถือเป็นเป้าหมายและจะถูกข้าม
+ * ถ้าแถวแรกไม่ใช่ตัวเลข จะถือว่าเป็นหัวตาราง
+ */
+bool loadCsvFeatures(const std::string& path, size_t expectedCols,
+                     std::vector<float>& out, size_t& rows, std::string& error);
+
+/**
+ * @brief ตัดเครื่องหมายคำพูดรอบข้อความออก
+ */
+std::string stripQuotes(const std::string& text);
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_DATASET_H
@@ -0,0 +1,142 @@
+/**
+ * @file DecisionTree.h
+ * @brief ต้นไม้ตัดสินใจแบบ histogram: แบ่งค่า features เป็นช่วง (bins) ก่อน แล้วหาจุดแบ่งจาก histogram ของแต่ละโหนด
+ */
+
+#ifndef AI_LANGUAGE_DECISION_TREE_H
+#define AI_LANGUAGE_DECISION_TREE_H
+
+#include "Dataset.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @class FeatureBinner
+ * @brief แปลงค่า feature เป็นรหัสช่วง 8 บิต จากควอนไทล์ของข้อมูลเทรน
+ *
+ * ขอบช่วงเป็นจุดกึ่งกลางระหว่างค่าที่ติดกัน ทำให้ x <= edges[f][b] เทียบเท่ากับ bin(x) <= b พอดี
+ * ต้นไม้จึงเก็บเกณฑ์ได้ทั้งแบบ float และแบบรหัสช่วงโดยให้ผลเหมือนกัน
+ */
+class FeatureBinner {
+public:
+    /**
+     * @param maxBins จำนวนช่วงสูงสุดต่อ feature (ไม่เกิน 256)
+     */
+    void fit(const Dataset& data, size_t maxBins);
+
+    uint8_t bin(size_t feature, float value) const;
+
+    /**
+     * @brief แปลงชุดข้อมูลเป็นรหัสช่วงแบบ column-major (cols x rows) สำหรับสร้าง histogram
+     */
+    void transformColumns(const Dataset& data, std::vector<uint8_t>& out) const;
+
+    /**
+     * @brief แปลงแถวเป็นรหัสช่วงแบบ row-major (count x cols) สำหรับการทำนาย
+     */
+    void transformRows(const float* rows, size_t count, uint8_t* out) const;
+
+    float threshold(size_t feature, uint8_t bin) const { return edges[feature][bin]; }
+    size_t numBins(size_t feature) const { return edges[feature].size() + 1; }
+    size_t numFeatures() const { return edges.size(); }
+
+private:
+    std::vector<std::vector<float>> edges;
+};
+
+/**
+ * @brief โหนดของต้นไม้ (feature = -1 หมายถึงใบ)
+ */
+struct TreeNode {
+    int32_t feature = -1;
+    uint8_t bin = 0;          ///< ไปทางซ้ายเมื่อ bin(x) <= bin
+    float threshold = 0.0f;   ///< ไปทางซ้ายเมื่อ x <= threshold (เทียบเท่ากัน)
+    int32_t left = -1;
+    int32_t right = -1;
+    uint32_t leaf = 0;        ///< ลำดับใบ ใช้หาค่าใน leafValues
+    float gain = 0.0f;        ///< การลดลงของ impurity/loss จากการแบ่งที่โหนดนี้
+    uint32_t samples = 0;
+};
+
+/**
+ * @class DecisionTree
+ * @brief ต้นไม้หนึ่งต้น เก็บโหนดตามลำดับที่สร้าง (depth-first) และค่าใบ outputs ค่าต่อใบ
+ *
+ * ค่าใบถูกบวกเข้ากับคะแนนช่อง [outputOffset, outputOffset + outputs)
+ */
+class DecisionTree {
+public:
+    std::vector<TreeNode> nodes;
+    std::vector<float> leafValues;  ///< leaves x outputs
+    size_t outputs = 1;
+    size_t outputOffset = 0;
+
+    /**
+     * @brief เดินจากรากถึงใบด้วยเกณฑ์ float แล้วคืนตัวชี้ค่าใบ
+     */
+    const float* evaluate(const float* row) const;
+
+    /**
+     * @brief เดินต้นไม้ด้วยข้อมูลรหัสช่วงแบบ column-major (ใช้ระหว่างเทรน)
+     */
+    const float* evaluateBinned(const uint8_t* columns, size_t rows, size_t index) const;
+
+    size_t leafCount() const { return outputs == 0 ? 0 : leafValues.size() / outputs; }
+    size_t depth() const;
+};
+
+/**
+ * @brief พารามิเตอร์ของการสร้างต้นไม้
+ */
+struct TreeBuildParams {
+    size_t maxDepth = 64;
+    size_t minSamplesSplit = 2;
+    size_t minSamplesLeaf = 1;
+    size_t maxFeatures = 0;     ///< จำนวน features ที่สุ่มพิจารณาต่อโหนด (0 = ทั้งหมด)
+    double minGain = 1e-12;
+    double lambda = 0.0;        ///< L2 regularization ของค่าใบ (เฉพาะแบบ gradient)
+    double leafScale = 1.0;     ///< คูณค่าใบ (learning rate ของ boosting)
+    unsigned seed = 42;
+};
+
+/**
+ * @class TreeBuilder
+ * @brief สร้างต้นไม้จากข้อมูลรหัสช่วงแบบ column-major
+ *
+ * rowIndex อาจมีแถวซ้ำได้ (bootstrap) แถวที่ซ้ำนับน้ำหนักตามจำนวนครั้ง
+ */
+class TreeBuilder {
+public:
+    TreeBuilder(const FeatureBinner& binner, const std::vector<uint8_t>& columns, size_t rows);
+
+    /**
+     * @brief ต้นไม้จำแนกประเภทด้วยเกณฑ์ Gini ค่าใบคือสัดส่วนของแต่ละคลาส
+     */
+    DecisionTree buildClassifier(const std::vector<float>& labels, size_t classes,
+                                 std::vector<uint32_t> rowIndex, const TreeBuildParams& params) const;
+
+    /**
+     * @brief ต้นไม้ถดถอยจาก gradient/hessian ค่าใบคือ -G / (H + lambda)
+     *
+     * สำหรับ MSE ใช้ gradient = -y และ hessian = 1 จะได้ค่าใบเป็นค่าเฉลี่ยของ y
+     */
+    DecisionTree buildRegressor(const std::vector<float>& gradients, const std::vector<float>& hessians,
+                                std::vector<uint32_t> rowIndex, const TreeBuildParams& params) const;
+
+private:
+    DecisionTree build(const std::vector<float>* labels, size_t classes,
+                       const std::vector<float>* gradients, const std::vector<float>* hessians,
+                       std::vector<uint32_t>& rowIndex, const TreeBuildParams& params) const;
+
+    const FeatureBinner& binner;
+    const std::vector<uint8_t>& columns;
+    size_t rows;
+    size_t cols;
+};
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_DECISION_TREE_H
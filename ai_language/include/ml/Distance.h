@@ -0,0 +1,71 @@
+/**
+ * @file Distance.h
+ * @brief เคอร์เนลคำนวณระยะทางแบบ SIMD (เลือก AVX2 อัตโนมัติเมื่อ CPU รองรับ)
+ */
+
+#ifndef AI_LANGUAGE_DISTANCE_H
+#define AI_LANGUAGE_DISTANCE_H
+
+#include <cstddef>
+#include <string>
+
+namespace ai_language {
+
+/**
+ * @brief ระยะทางที่รองรับ
+ */
+enum class DistanceMetric {
+    Euclidean,  ///< ระยะยุคลิด (เปรียบเทียบด้วยกำลังสอง)
+    Cosine      ///< 1 - cosine similarity
+};
+
+/**
+ * @brief แปลงชื่อระยะทางจากคำสั่ง set metric
+ * @return false ถ้าไม่รู้จักชื่อ
+ */
+bool parseDistanceMetric(const std::string& name, DistanceMetric& metric);
+
+/**
+ * @brief ผลรวมกำลังสองของผลต่าง ||a - b||²
+ */
+float squaredL2(const float* a, const float* b, size_t dim);
+
+/**
+ * @brief ผลคูณภายใน a·b
+ */
+float dotProduct(const float* a, const float* b, size_t dim);
+
+/**
+ * @brief ระยะ cosine 1 - a·b / (||a|| ||b||) คำนวณในรอบเดียว
+ */
+float cosineDistance(const float* a, const float* b, size_t dim);
+
+/**
+ * @brief คำนวณ ||row||² ของทุกแถว
+ */
+void squaredNorms(const float* rows, size_t count, size_t dim, float* out);
+
+/**
+ * @brief คำนวณผลคูณภายในทุกคู่ระหว่าง queries (m x dim) และ points (n x dim)
+ * @param out เมทริกซ์ผลลัพธ์ m x n โดยแถว i เริ่มที่ out + i * ldOut
+ *
+ * ใช้ microkernel แบบ register blocking 4x2 เพื่อให้โหลดข้อมูลแต่ละแถวครั้งเดียวต่อหลายคู่
+ */
+void dotTile(const float* queries, size_t m, const float* points, size_t n,
+             size_t dim, float* out, size_t ldOut);
+
+/**
+ * @brief เคอร์เนล RBF exp(-gamma * ||q_i - p_j||²) ทุกคู่ระหว่าง queries (m x dim) และ points (n x dim)
+ * @param queryNorms ||q_i||² ที่คำนวณไว้แล้ว
+ * @param pointNorms ||p_j||² ที่คำนวณไว้แล้ว
+ * @param out เมทริกซ์ผลลัพธ์ m x n โดยแถว i เริ่มที่ out + i * ldOut
+ *
+ * ใช้ dotTile สำหรับผลคูณภายใน แล้วคำนวณ exp ด้วยพหุนามแบบ AVX2 ครั้งละ 8 ค่า
+ */
+void rbfKernelTile(const float* queries, const float* queryNorms, size_t m,
+                   const float* points, const float* pointNorms, size_t n,
+                   size_t dim, float gamma, float* out, size_t ldOut);
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_DISTANCE_H
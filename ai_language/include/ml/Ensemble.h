@@ -0,0 +1,151 @@
+/**
+ * @file Ensemble.h
+ * @brief Voting และ Stacking: รวมโมเดลพื้นฐานหลายประเภทที่เทรนพร้อมกันบนชุดข้อมูลเดียวกัน
+ */
+
+#ifndef AI_LANGUAGE_ENSEMBLE_H
+#define AI_LANGUAGE_ENSEMBLE_H
+
+#include "Model.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @class EnsembleModel
+ * @brief ฐานของโมเดลที่ประกอบด้วยโมเดลพื้นฐาน (create model Stacking with LinearRegression, RandomForest, KNN)
+ *
+ * งานเทรนทุกชิ้น (โมเดลพื้นฐานแต่ละตัว และสำหรับ Stacking คือทุกคู่ fold x โมเดล) อยู่ในคิวเดียว
+ * เธรดของ parallelFor ดึงงานถัดไปจากตัวนับร่วม งานที่ใช้เวลาต่างกันมากจึงกระจายได้สมดุล
+ * โมเดลพื้นฐานอ่านชุดข้อมูลร่วมกันโดยไม่คัดลอก ยกเว้นชุดเทรนของแต่ละ fold
+ * parallelFor ที่ซ้อนอยู่ในโมเดลพื้นฐานทำงานแบบลำดับในเธรดของงาน จึงไม่ใช้เธรดเกินจำนวนคอร์
+ *
+ * พารามิเตอร์: estimators (ข้อความ คั่นด้วยจุลภาค; คำสั่ง create model ... with ... ตั้งให้)
+ * พารามิเตอร์อื่นส่งต่อให้โมเดลพื้นฐานทุกตัว
+ */
+class EnsembleModel : public MLModel {
+public:
+    explicit EnsembleModel(const ModelParams& params);
+
+    void fit(const Dataset& data) override;
+    void describe(std::ostream& os) const override;
+    size_t memoryBytes() const override;
+
+    const std::vector<std::string>& learnerTypes() const { return types; }
+    const MLModel& learner(size_t index) const { return *learners[index]; }
+
+protected:
+    /**
+     * @brief จำนวนงานเทรนเพิ่มเติมนอกจากการเทรนโมเดลพื้นฐานบนข้อมูลทั้งหมด (Stacking: folds x โมเดล)
+     */
+    virtual size_t extraTasks(const Dataset& data) { (void)data; return 0; }
+
+    /**
+     * @brief ทำงานเพิ่มเติมลำดับที่ task (เรียกพร้อมกันจากหลายเธรด)
+     */
+    virtual void runExtraTask(const Dataset& data, size_t task) { (void)data; (void)task; }
+
+    /**
+     * @brief รวมผลหลังงานทั้งหมดเสร็จ (เช่น เทรน meta-learner)
+     */
+    virtual void finishFit(const Dataset& data) { (void)data; }
+
+    virtual void describeCombiner(std::ostream& os) const = 0;
+
+    std::unique_ptr<MLModel> createLearner(size_t index) const;
+
+    ModelParams learnerParams;
+    std::vector<std::string> types;
+    std::vector<std::unique_ptr<MLModel>> learners;
+    std::vector<double> learnerSeconds;     ///< เวลาเทรนบนข้อมูลทั้งหมดของแต่ละโมเดล
+    bool classification = false;
+    size_t classes = 0;
+    unsigned seed;
+
+private:
+    size_t taskCount = 0;
+    double taskSeconds = 0.0;               ///< ผลรวมเวลาของทุกงาน
+    double wallSeconds = 0.0;
+};
+
+/**
+ * @class VotingModel
+ * @brief เสียงข้างมากของผลทำนาย (จำแนกประเภท) หรือค่าเฉลี่ย (ถดถอย)
+ *
+ * decisionScores คือสัดส่วนเสียงของแต่ละคลาส
+ */
+class VotingModel : public EnsembleModel {
+public:
+    explicit VotingModel(const ModelParams& params) : EnsembleModel(params) {}
+
+    std::string typeName() const override { return "Voting"; }
+    void predictBatch(const float* rows, size_t count, float* out) const override;
+    size_t decisionScores(const float* rows, size_t count, std::vector<float>& out) const override;
+
+protected:
+    void describeCombiner(std::ostream& os) const override;
+
+private:
+    /**
+     * @brief ผลทำนายของทุกโมเดล (count x จำนวนโมเดล)
+     */
+    std::vector<float> learnerPredictions(const float* rows, size_t count) const;
+};
+
+/**
+ * @class StackingModel
+ * @brief meta-learner ที่เรียนจากผลทำนายนอก fold (out-of-fold) ของโมเดลพื้นฐาน
+ *
+ * แต่ละแถวถูกทำนายโดยโมเดลที่ไม่เคยเห็นแถวนั้น (fold แบ่งแบบ stratified สำหรับการจำแนกประเภท)
+ * meta-features ของการจำแนกประเภทคือ decisionScores ของโมเดล (หรือ one-hot ของผลทำนายถ้าโมเดลไม่มีคะแนน)
+ * ตอนทำนายใช้โมเดลพื้นฐานที่เทรนบนข้อมูลทั้งหมด
+ *
+ * พารามิเตอร์: cv (5), final_estimator (LogisticRegression สำหรับจำแนกประเภท, LinearRegression สำหรับถดถอย)
+ */
+class StackingModel : public EnsembleModel {
+public:
+    explicit StackingModel(const ModelParams& params);
+
+    std::string typeName() const override { return "Stacking"; }
+    void predictBatch(const float* rows, size_t count, float* out) const override;
+    size_t decisionScores(const float* rows, size_t count, std::vector<float>& out) const override;
+    size_t memoryBytes() const override;
+
+    size_t metaFeatureCount() const { return metaWidth; }
+    const MLModel& metaLearner() const { return *meta; }
+
+protected:
+    size_t extraTasks(const Dataset& data) override;
+    void runExtraTask(const Dataset& data, size_t task) override;
+    void finishFit(const Dataset& data) override;
+    void describeCombiner(std::ostream& os) const override;
+
+private:
+    /**
+     * @brief meta-features ของโมเดลหนึ่ง (count x ค่าที่คืน)
+     */
+    size_t learnerMetaFeatures(const MLModel& model, const float* rows, size_t count, std::vector<float>& out) const;
+
+    /**
+     * @brief meta-features ของทุกโมเดลเรียงต่อกัน (count x metaFeatureCount())
+     */
+    void metaFeatures(const float* rows, size_t count, std::vector<float>& out) const;
+
+    size_t folds;
+    std::string metaType;
+    std::vector<uint32_t> foldOf;                    ///< fold ของแต่ละแถว
+    std::vector<std::vector<float>> foldScores;      ///< meta-features นอก fold ต่อ (fold, โมเดล): แถวของ fold x ความกว้าง
+    std::vector<std::vector<float>> foldPredictions; ///< ผลทำนายนอก fold ต่อ (fold, โมเดล)
+    std::vector<size_t> foldWidths;
+    std::vector<double> oofScores;                   ///< accuracy หรือ R^2 นอก fold ของแต่ละโมเดล
+    std::vector<size_t> learnerWidths;
+    size_t metaWidth = 0;
+    std::unique_ptr<MLModel> meta;
+};
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_ENSEMBLE_H
@@ -0,0 +1,55 @@
+/**
+ * @file GradientBoosting.h
+ * @brief Gradient Boosting ด้วยต้นไม้ histogram ที่ใช้ gradient และ hessian ของ loss
+ */
+
+#ifndef AI_LANGUAGE_GRADIENT_BOOSTING_H
+#define AI_LANGUAGE_GRADIENT_BOOSTING_H
+
+#include "TreeEnsemble.h"
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @class GradientBoostingModel
+ * @brief รวมต้นไม้ตื้นทีละรอบเพื่อลด loss: squared error (ถดถอย), logistic (สองคลาส), softmax (หลายคลาส)
+ *
+ * พารามิเตอร์: n_estimators หรือ trees (100), learning_rate, max_depth (3), subsample (1.0),
+ * lambda (1.0), min_samples_leaf (1), incremental_rounds (10% ของ n_estimators)
+ * หลายคลาสสร้างต้นไม้หนึ่งต้นต่อคลาสต่อรอบ
+ * partialFit เพิ่ม incremental_rounds รอบโดยเริ่มจากคะแนนของโมเดลเดิมบนข้อมูลชุดใหม่
+ * และใช้ช่วงค่า features เดิม
+ */
+class GradientBoostingModel : public TreeEnsembleModel {
+public:
+    explicit GradientBoostingModel(const ModelParams& params);
+
+    std::string typeName() const override { return "GradientBoosting"; }
+    void fit(const Dataset& data) override;
+    void partialFit(const Dataset& data) override;
+    bool supportsPartialFit() const override { return true; }
+    size_t decisionScores(const float* rows, size_t count, std::vector<float>& out) const override;
+    void describe(std::ostream& os) const override;
+
+    const std::vector<double>& lossHistory() const { return trainLoss; }
+
+private:
+    /**
+     * @brief เพิ่มรอบ boosting บนข้อมูลที่แปลงเป็นรหัสช่วงแล้ว โดยเริ่มจากคะแนนปัจจุบัน F
+     */
+    void boost(const Dataset& data, const std::vector<uint8_t>& columns, std::vector<float>& F, size_t count);
+    double loss(const Dataset& data, const std::vector<float>& F) const;
+
+    size_t rounds;
+    size_t incrementalRounds;
+    double learningRate;
+    double subsample;
+    TreeBuildParams buildParams;
+    std::vector<double> trainLoss;      ///< loss ก่อนและหลังแต่ละรอบของการเทรนครั้งล่าสุด
+    size_t trainingCalls = 0;
+};
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_GRADIENT_BOOSTING_H
@@ -0,0 +1,81 @@
+/**
+ * @file HNSW.h
+ * @brief ดัชนีค้นหาเพื่อนบ้านโดยประมาณแบบ Hierarchical Navigable Small World
+ */
+
+#ifndef AI_LANGUAGE_HNSW_H
+#define AI_LANGUAGE_HNSW_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @class HNSWIndex
+ * @brief กราฟหลายชั้นสำหรับค้นหาเพื่อนบ้านโดยประมาณด้วยระยะยุคลิดกำลังสอง
+ *
+ * การเพิ่มจุดทำแบบหลายเธรด โดยล็อกเฉพาะรายการเพื่อนบ้านของโหนดที่กำลังแก้ไข
+ * ข้อมูลจุดไม่ถูกคัดลอก ผู้เรียกต้องเก็บบัฟเฟอร์ไว้ตลอดอายุของดัชนี
+ */
+class HNSWIndex {
+public:
+    /**
+     * @param m จำนวนเพื่อนบ้านต่อโหนดในชั้นบน (ชั้นล่างสุดใช้ 2m)
+     * @param efConstruction ขนาดรายการผู้สมัครระหว่างสร้างกราฟ
+     * @param seed ค่าเริ่มต้นของตัวสุ่มสำหรับเลือกชั้นของแต่ละโหนด
+     */
+    HNSWIndex(size_t m, size_t efConstruction, unsigned seed);
+    ~HNSWIndex();
+
+    /**
+     * @brief สร้างกราฟจากจุดทั้งหมด (count x dim, row-major) แบบขนาน
+     */
+    void build(const float* points, size_t count, size_t dim);
+
+    /**
+     * @brief ค้นหาเพื่อนบ้านโดยประมาณ k ตัว
+     * @param ef ขนาดรายการผู้สมัครขณะค้นหา (มากขึ้น = แม่นขึ้นแต่ช้าลง)
+     * @return คู่ (ระยะกำลังสอง, ดัชนีจุด) เรียงจากใกล้ไปไกล
+     */
+    std::vector<std::pair<float, uint32_t>> search(const float* query, size_t k, size_t ef) const;
+
+    size_t size() const { return count; }
+    int maxLevel() const { return topLevel; }
+    size_t edgeCount() const;
+
+private:
+    using Candidate = std::pair<float, uint32_t>;
+
+    void insert(uint32_t node);
+    std::vector<Candidate> searchLayer(const float* query, uint32_t entry, float entryDist,
+                                       size_t ef, int level, std::vector<uint32_t>& visitedMark,
+                                       uint32_t visitTag) const;
+    std::vector<uint32_t> selectNeighbors(std::vector<Candidate> candidates, size_t limit) const;
+    void connect(uint32_t node, uint32_t neighbor, int level);
+    std::vector<uint32_t> neighborsOf(uint32_t node, int level) const;
+    float distance(const float* a, uint32_t b) const;
+
+    size_t m;
+    size_t efConstruction;
+    unsigned seed;
+    const float* data;
+    size_t count;
+    size_t dim;
+
+    std::vector<int> levels;
+    std::vector<std::vector<std::vector<uint32_t>>> links;  ///< links[node][level]
+    std::unique_ptr<std::mutex[]> nodeLocks;
+    mutable std::mutex entryLock;
+    std::atomic<uint32_t> entryPoint;
+    std::atomic<int> topLevel;
+};
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_HNSW_H
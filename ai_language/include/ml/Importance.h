@@ -0,0 +1,61 @@
+/**
+ * @file Importance.h
+ * @brief Permutation importance ที่ประเมินแต่ละ feature พร้อมกันผ่านดัชนีแทนการคัดลอกข้อมูล
+ */
+
+#ifndef AI_LANGUAGE_IMPORTANCE_H
+#define AI_LANGUAGE_IMPORTANCE_H
+
+#include "Model.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @struct PermutationImportance
+ * @brief คะแนนที่ลดลงเมื่อสลับค่าของแต่ละ feature (ยิ่งมากยิ่งสำคัญ)
+ */
+struct PermutationImportance {
+    std::string metric;          ///< "accuracy" หรือ "r2"
+    double baseline = 0.0;       ///< คะแนนก่อนสลับ
+    std::vector<double> mean;    ///< คะแนนที่ลดลงเฉลี่ยต่อ feature
+    std::vector<double> stddev;  ///< ส่วนเบี่ยงเบนมาตรฐานระหว่างรอบ
+    size_t rows = 0;
+    size_t repeats = 0;
+};
+
+/**
+ * @brief คำนวณ permutation importance บนแถวที่เลือกใน view
+ * @param view ดัชนีแถวของ data ที่ใช้ประเมิน (ใช้ร่วมกันทุก feature)
+ * @param repeats จำนวนรอบการสลับต่อ feature
+ * @param classification ใช้ accuracy (true) หรือ R² (false) เป็นคะแนน
+ *
+ * งาน (feature, รอบ) ทั้งหมดทำแบบขนาน แต่ละงานประกอบแถวทีละบล็อกเล็กจาก view
+ * และอ่านค่าของ feature ที่สลับผ่านดัชนี permutation ของรอบนั้น
+ * หน่วยความจำจึงเป็น O(เธรด x (บล็อก + แถว)) ไม่ขึ้นกับจำนวน features
+ */
+PermutationImportance permutationImportance(const MLModel& model, const Dataset& data,
+                                            const std::vector<uint32_t>& view, size_t repeats,
+                                            unsigned seed, bool classification);
+
+/**
+ * @brief ทำนายบล็อกแถวดิบ (count x data.cols) ลง out หนึ่งค่าต่อแถว (ดัชนีคลาสสำหรับการจำแนกประเภท)
+ *
+ * worker อยู่ในช่วง [0, availableThreads()) และไม่มีสองงานใช้ worker เดียวกันพร้อมกัน
+ * ผู้เรียกจึงเก็บบัฟเฟอร์หรือแบบจำลองประจำ worker ได้ (เช่นเครือข่ายของ DL ที่มี arena ของตัวเอง)
+ */
+using BlockPredictor = std::function<void(const float* rows, size_t count, float* out, size_t worker)>;
+
+/**
+ * @brief permutation importance ของตัวทำนายใดก็ได้ (ไม่ตรวจจำนวน features) ด้วยวิธีเดียวกับของ MLModel
+ */
+PermutationImportance permutationImportance(const BlockPredictor& predict, const Dataset& data,
+                                            const std::vector<uint32_t>& view, size_t repeats,
+                                            unsigned seed, bool classification);
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_IMPORTANCE_H
@@ -0,0 +1,116 @@
+/**
+ * @file KMeans.h
+ * @brief KMeans: เริ่มต้นด้วย k-means|| แบบขนาน ตัดการคำนวณระยะด้วยขอบเขตของ Hamerly/Elkan และแบบ mini-batch
+ */
+
+#ifndef AI_LANGUAGE_KMEANS_H
+#define AI_LANGUAGE_KMEANS_H
+
+#include "Model.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @brief วิธีวนรอบของ KMeans (กำหนดด้วย set algorithm "<ชื่อ>")
+ */
+enum class KMeansAlgorithm {
+    Auto,       ///< Hamerly เมื่อ clusters <= 20 ไม่เช่นนั้น Elkan (ถ้าหน่วยความจำของขอบเขตไม่เกินงบ)
+    Lloyd,      ///< คำนวณระยะทุกคู่ทุกรอบ (ใช้เทียบผล)
+    Hamerly,    ///< ขอบเขตบนหนึ่งค่าและขอบเขตล่างหนึ่งค่าต่อแถว
+    Elkan,      ///< ขอบเขตล่างต่อศูนย์กลางและระยะระหว่างศูนย์กลาง
+    MiniBatch   ///< สุ่มชุดย่อยและปรับศูนย์กลางด้วยอัตราเรียนรู้ 1/จำนวนแถวที่เห็น
+};
+
+/**
+ * @brief สถิติของการเทรนครั้งล่าสุด
+ */
+struct KMeansStats {
+    size_t iterations = 0;             ///< รอบของ Lloyd/Hamerly/Elkan หรือจำนวนชุดย่อยของ mini-batch
+    uint64_t distancesComputed = 0;
+    uint64_t distancesSkipped = 0;     ///< คู่ (แถว, ศูนย์กลาง) ที่ขอบเขตตัดออกเทียบกับ Lloyd
+    uint64_t initDistances = 0;        ///< ระยะที่คำนวณระหว่าง k-means||
+    size_t initCandidates = 0;
+    bool converged = false;
+    double inertia = 0.0;              ///< ผลรวมระยะกำลังสองถึงศูนย์กลางที่ใกล้ที่สุด
+    double seconds = 0.0;
+};
+
+/**
+ * @class KMeansModel
+ * @brief จัดกลุ่มแถวเป็น clusters กลุ่ม ผลทำนายคือหมายเลขกลุ่ม (ไม่ใช้คอลัมน์เป้าหมาย)
+ *
+ * k-means|| สุ่มศูนย์กลางผู้สมัครหลายรอบแบบขนานตามสัดส่วนระยะกำลังสอง
+ * (ใช้ hash ของดัชนีแถวเป็นตัวสุ่ม ผลจึงไม่ขึ้นกับจำนวนเธรด) แล้วลดเหลือ clusters ด้วย greedy k-means++ แบบถ่วงน้ำหนัก (ทำหลายครั้งและเก็บผลที่ดีที่สุด)
+ * รอบการจัดกลุ่มแบ่งแถวเป็นก้อนแบบขนาน ระยะทั้งหมดใช้เคอร์เนล SIMD จาก Distance.h
+ * partialFit ทำ mini-batch บนแถวใหม่ต่อจากศูนย์กลางเดิม
+ *
+ * พารามิเตอร์: clusters หรือ n_clusters (8), max_iter (300), tol (0.0001), algorithm ("auto"),
+ * init ("kmeans||" หรือ "random"), init_rounds (5), minibatch_size (1024), random_state (42)
+ */
+class KMeansModel : public MLModel {
+public:
+    explicit KMeansModel(const ModelParams& params);
+
+    std::string typeName() const override { return "KMeans"; }
+    bool isSupervised() const override { return false; }
+    void fit(const Dataset& data) override;
+    void partialFit(const Dataset& data) override;
+    bool supportsPartialFit() const override { return true; }
+    void predictBatch(const float* rows, size_t count, float* out) const override;
+    void reportBatch(const float* rows, size_t count, std::ostream& os) const override;
+    bool emitSource(SourceWriter& out) const override;
+    void describe(std::ostream& os) const override;
+    size_t memoryBytes() const override;
+
+    /**
+     * @brief หาศูนย์กลางที่ใกล้ที่สุดของแต่ละแถว และระยะกำลังสอง (ถ้า distances ไม่เป็น nullptr)
+     */
+    void assign(const float* rows, size_t count, uint32_t* labels, float* distances) const;
+
+    size_t numClusters() const { return clusters; }
+    const std::vector<float>& centerMatrix() const { return centers; }
+    const KMeansStats& lastStats() const { return stats; }
+    KMeansAlgorithm usedAlgorithm() const { return algorithmUsed; }
+    static std::string algorithmName(KMeansAlgorithm algorithm);
+
+private:
+    void initialize(const float* data, size_t rows);
+    void runLloyd(const float* data, size_t rows);
+    void runHamerly(const float* data, size_t rows);
+    void runElkan(const float* data, size_t rows);
+    void miniBatchPass(const float* data, size_t rows, size_t maxBatches, bool earlyStop);
+    void finish(const float* data, size_t rows);
+
+    /**
+     * @brief คำนวณศูนย์กลางใหม่จากผลรวมต่อก้อน คืนระยะที่แต่ละศูนย์กลางเคลื่อน
+     */
+    std::vector<float> updateCenters(const std::vector<std::vector<double>>& sums,
+                                     const std::vector<std::vector<uint64_t>>& counts);
+    bool shiftConverged(const std::vector<float>& shifts) const;
+
+    size_t clusters;
+    size_t maxIterations;
+    double tol;
+    KMeansAlgorithm requested;
+    bool randomInit;
+    size_t initRounds;
+    size_t miniBatchSize;
+    unsigned seed;
+
+    size_t dim = 0;
+    std::vector<float> centers;        ///< clusters x dim
+    std::vector<uint64_t> clusterSizes;
+    std::vector<double> seenCounts;    ///< จำนวนแถวที่แต่ละศูนย์กลางเห็นใน mini-batch
+    double tolScaled = 0.0;            ///< tol คูณค่าเฉลี่ยความแปรปรวนของ features
+    KMeansAlgorithm algorithmUsed = KMeansAlgorithm::Auto;
+    KMeansStats stats;
+    size_t trainingCalls = 0;
+    size_t rowsSeen = 0;
+};
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_KMEANS_H
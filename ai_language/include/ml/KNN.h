@@ -0,0 +1,132 @@
+/**
+ * @file KNN.h
+ * @brief โมเดล K-Nearest Neighbors พร้อมดัชนี KD-tree / Ball tree และการค้นหาแบบ brute-force แบบบล็อก
+ */
+
+#ifndef AI_LANGUAGE_KNN_H
+#define AI_LANGUAGE_KNN_H
+
+#include "Model.h"
+#include "Distance.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @brief ประเภทดัชนีสำหรับค้นหาเพื่อนบ้าน (กำหนดด้วย set index "<ชื่อ>")
+ */
+enum class KNNIndexType {
+    Auto,      ///< เลือกตามจำนวนมิติและจำนวนแถว
+    KDTree,    ///< เหมาะกับข้อมูลมิติต่ำ
+    BallTree,  ///< เหมาะกับข้อมูลมิติสูงขึ้น
+    Brute,     ///< เปรียบเทียบทุกคู่แบบบล็อก (||x||² + ||y||² - 2x·y)
+    HNSW       ///< กราฟ HNSW ค้นหาโดยประมาณ สำหรับข้อมูลขนาดใหญ่มาก
+};
+
+/**
+ * @brief ผลการวัด recall ของดัชนีโดยประมาณเทียบกับการค้นหาแบบแม่นยำ
+ */
+struct RecallReport {
+    size_t sampleSize = 0;
+    double recall = 0.0;            ///< สัดส่วนเพื่อนบ้านแท้ที่ดัชนีหาเจอ (recall@k)
+    double approxMicros = 0.0;      ///< เวลาเฉลี่ยต่อคิวรีของดัชนี (ไมโครวินาที)
+    double exactMicros = 0.0;       ///< เวลาเฉลี่ยต่อคิวรีของการค้นหาแบบแม่นยำ
+};
+
+class NeighborHeap;
+class HNSWIndex;
+
+/**
+ * @class KNNModel
+ * @brief จำแนกประเภทด้วยการโหวตเสียงข้างมาก หรือถดถอยด้วยค่าเฉลี่ยของเพื่อนบ้าน k ตัว
+ *
+ * พารามิเตอร์: k (ค่าเริ่มต้น 5), leaf_size (32), metric "euclidean"|"cosine", index "auto"|"kdtree"|"balltree"|"brute"|"hnsw"
+ * สำหรับ hnsw: M (16), ef_construction (200), ef_search (64), recall_sample (100)
+ * สำหรับ cosine ข้อมูลจะถูกปรับให้มีความยาวหนึ่งหน่วยก่อนสร้างดัชนี เพื่อให้ต้นไม้ตัดกิ่งด้วยระยะยุคลิดได้
+ */
+class KNNModel : public MLModel {
+public:
+    explicit KNNModel(const ModelParams& params);
+    ~KNNModel() override;
+
+    std::string typeName() const override { return "KNN"; }
+    void fit(const Dataset& data) override;
+    void predictBatch(const float* rows, size_t count, float* out) const override;
+    void describe(std::ostream& os) const override;
+    size_t memoryBytes() const override;
+    void reportBatch(const float* rows, size_t count, std::ostream& os) const override;
+
+    /**
+     * @brief ค้นหาเพื่อนบ้าน k ตัวของทุกแถวแบบขนาน
+     * @param indices ดัชนีแถวในชุดข้อมูลเทรน (count * k ค่า เรียงจากใกล้ไปไกล)
+     * @param distances ระยะตาม metric ที่ตั้งไว้ (ยุคลิดแบบกำลังสอง หรือ 1 - cosine)
+     */
+    void kneighbors(const float* rows, size_t count, size_t k,
+                    std::vector<uint32_t>& indices, std::vector<float>& distances) const;
+
+    /**
+     * @brief ค้นหาด้วยการเปรียบเทียบทุกคู่ ไม่ว่าจะสร้างดัชนีแบบใด (ใช้เป็นค่าอ้างอิงที่ถูกต้อง)
+     */
+    void bruteForceKneighbors(const float* rows, size_t count, size_t k,
+                              std::vector<uint32_t>& indices, std::vector<float>& distances) const;
+
+    /**
+     * @brief วัด recall@k ของดัชนีเทียบกับ brute-force บนตัวอย่างคิวรีที่เลือกแบบกระจายสม่ำเสมอ
+     */
+    RecallReport estimateRecall(const float* rows, size_t count, size_t sampleSize) const;
+
+    KNNIndexType indexType() const { return builtIndex; }
+    static std::string indexName(KNNIndexType type);
+
+private:
+    struct Node {
+        uint32_t begin;
+        uint32_t end;
+        int32_t left;
+        int32_t right;
+        int32_t splitDim;   ///< KD-tree: มิติที่ใช้แบ่ง
+        float splitValue;   ///< KD-tree: ค่าที่ใช้แบ่ง
+        float radius;       ///< Ball tree: รัศมีของลูกบอล
+    };
+
+    void buildTree(bool ball);
+    void searchKD(int32_t node, const float* query, NeighborHeap& heap) const;
+    void searchBall(int32_t node, const float* query, float centerDist, NeighborHeap& heap) const;
+    void searchOne(const float* query, NeighborHeap& heap) const;
+    void neighborPositions(const float* rows, size_t count, size_t k,
+                           std::vector<uint32_t>& indices, std::vector<float>& distances) const;
+    void bruteForcePositions(const float* rows, size_t count, size_t k,
+                             std::vector<uint32_t>& indices, std::vector<float>& distances) const;
+    void toOriginal(std::vector<uint32_t>& indices, std::vector<float>& distances) const;
+    void prepareQueries(const float* rows, size_t count, std::vector<float>& prepared) const;
+    void vote(const uint32_t* neighbors, size_t k, float* out) const;
+
+    size_t k;
+    size_t leafSize;
+    size_t hnswM;
+    size_t efConstruction;
+    size_t efSearch;
+    size_t recallSample;
+    unsigned seed;
+    DistanceMetric metric;
+    KNNIndexType requestedIndex;
+    KNNIndexType builtIndex;
+    bool classification;
+    size_t numClassesCount;
+
+    std::vector<float> points;        ///< ข้อมูลเทรนเรียงตามลำดับใบของต้นไม้
+    std::vector<float> pointNorms;    ///< ||x||² สำหรับ brute-force แบบบล็อก
+    std::vector<float> labels;
+    std::vector<uint32_t> originalIndex;
+    std::vector<Node> nodes;
+    std::vector<float> centers;       ///< Ball tree: จุดศูนย์กลางของทุกโหนด
+    std::unique_ptr<HNSWIndex> graph;
+    size_t rowCount;
+};
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_KNN_H
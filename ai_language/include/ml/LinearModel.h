@@ -0,0 +1,157 @@
+/**
+ * @file LinearModel.h
+ * @brief LinearRegression และ LogisticRegression ที่เทรนด้วย mini-batch SGD และเทรนต่อจากน้ำหนักเดิมได้
+ */
+
+#ifndef AI_LANGUAGE_LINEAR_MODEL_H
+#define AI_LANGUAGE_LINEAR_MODEL_H
+
+#include "Model.h"
+#include "Polynomial.h"
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @class LinearModel
+ * @brief ฐานของโมเดลเชิงเส้น: คะแนน = W * standardize(x) + b
+ *
+ * ค่าเฉลี่ยและส่วนเบี่ยงเบนมาตรฐานของ features คำนวณครั้งเดียวตอน fit และคงที่ตลอดการเทรนเพิ่ม
+ * SGD หยุดเมื่อ loss เฉลี่ยต่อรอบลดลงไม่ถึง tol ติดต่อกัน 3 รอบ
+ * การเทรนเพิ่มจึงเริ่มใกล้จุดต่ำสุดเดิมและหยุดหลังไม่กี่รอบ
+ *
+ * เมื่อ polynomial_degree > 1 (preprocess polynomial) x คือแถวที่ขยายเป็นพจน์พหุนามแล้ว
+ * โดยขยายทีละแถวใน mini-batch และทีละก้อนเล็กตอนทำนาย ไม่มีการเก็บเมทริกซ์ที่ขยายแล้วทั้งชุด
+ * ผลทำนายและ numFeatures() จึงยังใช้ข้อมูลดิบเหมือนเดิม
+ *
+ * พารามิเตอร์: learning_rate (0.01), epochs (100), batch_size (32), l2 (0.0001), tol (0.001), random_state (42),
+ * polynomial_degree (1), interaction_only (0)
+ */
+class LinearModel : public MLModel {
+public:
+    explicit LinearModel(const ModelParams& params);
+
+    void fit(const Dataset& data) override;
+    void partialFit(const Dataset& data) override;
+    bool supportsPartialFit() const override { return true; }
+    void predictBatch(const float* rows, size_t count, float* out) const override;
+    size_t decisionScores(const float* rows, size_t count, std::vector<float>& out) const override;
+    bool emitSource(SourceWriter& out) const override;
+    void describe(std::ostream& os) const override;
+    size_t memoryBytes() const override;
+
+    /**
+     * @brief คะแนนเชิงเส้นของแต่ละแถว (count x outputCount()) บนข้อมูลดิบ
+     */
+    void decisionFunction(const float* rows, size_t count, float* out) const;
+
+    size_t outputCount() const { return outputs; }
+    const PolynomialFeatures& featureExpansion() const { return expansion; }
+    size_t lastEpochs() const { return epochsLastCall; }
+    double lastLoss() const { return finalLoss; }
+
+protected:
+    /**
+     * @brief ตรวจเป้าหมายและกำหนดจำนวนคะแนนต่อแถวตอน fit ครั้งแรก
+     */
+    virtual size_t prepareOutputs(const Dataset& data) = 0;
+
+    /**
+     * @brief ตรวจว่าข้อมูลชุดใหม่ใช้กับโมเดลเดิมได้ (เช่น ไม่มีคลาสใหม่)
+     */
+    virtual void checkIncremental(const Dataset& data) const { (void)data; }
+
+    /**
+     * @brief loss ของหนึ่งแถว และเขียน d(loss)/d(คะแนน) ลงใน grad
+     */
+    virtual double lossGradient(const float* scores, float target, float* grad) const = 0;
+
+    /**
+     * @brief แปลงคะแนนเป็นผลทำนาย
+     */
+    virtual float decide(const float* scores) const = 0;
+
+    /**
+     * @brief เขียนโค้ดที่แปลงคะแนน s[] เป็นผลทำนายเหมือน decide (export model)
+     */
+    virtual void emitDecision(SourceWriter& out) const = 0;
+
+    virtual std::string objectiveName() const = 0;
+
+    /**
+     * @brief ค่าเริ่มต้นของ bias ก่อน SGD (ค่าเฉลี่ยเป้าหมายสำหรับการถดถอย)
+     */
+    virtual void initialBias(const Dataset& data, std::vector<float>& bias) const;
+
+private:
+    void runSGD(const Dataset& data);
+    void foldWeights();
+
+    double learningRate;
+    size_t epochs;
+    size_t batchSize;
+    double l2;
+    double tol;
+    unsigned seed;
+    size_t polynomialDegree;
+    bool interactionOnly;
+
+    size_t outputs = 0;
+    PolynomialFeatures expansion;       ///< คอลัมน์เสมือนที่ weights ใช้ (identity เมื่อ polynomial_degree = 1)
+    std::vector<float> mean;
+    std::vector<float> invStd;
+    std::vector<float> weights;         ///< outputs x คอลัมน์ที่ขยายแล้ว บนข้อมูลที่ standardize แล้ว
+    std::vector<float> bias;
+    std::vector<float> foldedWeights;   ///< รวมการ standardize เข้าไปแล้ว ใช้ตอนทำนาย
+    std::vector<float> foldedBias;
+
+    size_t epochsLastCall = 0;
+    size_t epochsTotal = 0;
+    size_t rowsSeen = 0;
+    size_t trainingCalls = 0;
+    double firstLoss = 0.0;
+    double finalLoss = 0.0;
+};
+
+/**
+ * @class LinearRegressionModel
+ * @brief การถดถอยเชิงเส้นด้วย squared loss
+ */
+class LinearRegressionModel : public LinearModel {
+public:
+    explicit LinearRegressionModel(const ModelParams& params) : LinearModel(params) {}
+    std::string typeName() const override { return "LinearRegression"; }
+
+protected:
+    size_t prepareOutputs(const Dataset& data) override;
+    double lossGradient(const float* scores, float target, float* grad) const override;
+    float decide(const float* scores) const override { return scores[0]; }
+    void emitDecision(SourceWriter& out) const override;
+    std::string objectiveName() const override { return "squared error"; }
+    void initialBias(const Dataset& data, std::vector<float>& bias) const override;
+};
+
+/**
+ * @class LogisticRegressionModel
+ * @brief logistic loss สำหรับสองคลาส (คะแนนเดียว) และ softmax สำหรับหลายคลาส
+ */
+class LogisticRegressionModel : public LinearModel {
+public:
+    explicit LogisticRegressionModel(const ModelParams& params) : LinearModel(params) {}
+    std::string typeName() const override { return "LogisticRegression"; }
+
+protected:
+    size_t prepareOutputs(const Dataset& data) override;
+    void checkIncremental(const Dataset& data) const override;
+    double lossGradient(const float* scores, float target, float* grad) const override;
+    float decide(const float* scores) const override;
+    void emitDecision(SourceWriter& out) const override;
+    std::string objectiveName() const override;
+
+private:
+    size_t classes = 0;
+};
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_LINEAR_MODEL_H
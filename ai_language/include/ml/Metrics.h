@@ -0,0 +1,127 @@
+/**
+ * @file Metrics.h
+ * @brief ตัวชี้วัดของโมเดล: คำนวณในรอบเดียวแบบขนาน และ ROC/PR-AUC ด้วย radix sort แบบขนาน
+ */
+
+#ifndef AI_LANGUAGE_METRICS_H
+#define AI_LANGUAGE_METRICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @class ConfusionMatrix
+ * @brief ตารางนับ (คลาสจริง, คลาสที่ทำนาย)
+ *
+ * เก็บแบบเต็ม classes x classes เมื่อมีไม่เกิน kDenseClasses คลาส
+ * ถ้ามากกว่านั้นเก็บเฉพาะช่องที่ไม่เป็นศูนย์ (เรียงตามคีย์) เพื่อรองรับคลาสหลายพัน
+ * ผลรวมแถว คอลัมน์ และแนวทแยงเก็บแยกไว้เสมอสำหรับ precision/recall
+ */
+class ConfusionMatrix {
+public:
+    static constexpr size_t kDenseClasses = 256;
+
+    size_t classes = 0;
+    std::vector<uint64_t> truePositives;    ///< แนวทแยงต่อคลาส
+    std::vector<uint64_t> actualCounts;     ///< จำนวนแถวที่มีคลาสจริงนี้
+    std::vector<uint64_t> predictedCounts;  ///< จำนวนแถวที่ทำนายเป็นคลาสนี้
+
+    bool isDense() const { return classes <= kDenseClasses; }
+    uint64_t at(size_t truth, size_t predicted) const;
+
+    /**
+     * @brief ช่องที่ไม่เป็นศูนย์ทั้งหมดเป็น (truth * classes + predicted, จำนวน) เรียงตามคีย์
+     */
+    std::vector<std::pair<uint64_t, uint64_t>> nonZero() const;
+
+    /**
+     * @brief กำหนดช่องที่ไม่เป็นศูนย์ (เรียงตามคีย์) หลังกำหนด classes แล้ว
+     */
+    void setCells(const std::vector<std::pair<uint64_t, uint64_t>>& cells);
+
+private:
+    std::vector<uint64_t> dense;
+    std::vector<std::pair<uint64_t, uint64_t>> sparse;
+};
+
+/**
+ * @struct MetricsReport
+ * @brief ผลการประเมินโมเดลบนชุดข้อมูลหนึ่งชุด
+ *
+ * สองคลาส: precision/recall/F1 ของคลาส 1 หลายคลาส: ค่าเฉลี่ยแบบ macro ของคลาสที่ปรากฏ
+ * ROC-AUC และ PR-AUC (average precision) เป็น NaN เมื่อโมเดลไม่มีคะแนนต่อคลาส
+ * หลายคลาสใช้ค่าเฉลี่ย macro แบบ one-vs-rest
+ */
+struct MetricsReport {
+    bool classification = false;
+    size_t count = 0;
+
+    double accuracy = 0.0;
+    double precision = 0.0;
+    double recall = 0.0;
+    double f1 = 0.0;
+    double rocAuc;
+    double prAuc;
+    ConfusionMatrix confusion;
+
+    double mse = 0.0;
+    double mae = 0.0;
+    double r2 = 0.0;
+
+    MetricsReport();
+
+    /**
+     * @brief ชื่อและค่าของตัวชี้วัดตามลำดับการแสดงผล (ข้ามค่าที่คำนวณไม่ได้)
+     */
+    std::vector<std::pair<std::string, double>> values() const;
+
+    /**
+     * @brief แสดงตัวชี้วัด และ confusion matrix ถ้ามีไม่เกิน maxMatrixClasses คลาส
+     */
+    void print(std::ostream& os, const std::vector<std::string>& classNames, size_t maxMatrixClasses = 20) const;
+};
+
+/**
+ * @class MetricsEngine
+ * @brief คำนวณตัวชี้วัดจากค่าจริงและค่าทำนาย
+ */
+class MetricsEngine {
+public:
+    /**
+     * @brief accuracy/precision/recall/F1 + confusion matrix หรือ MSE/MAE/R² ในการวนข้อมูลรอบเดียว
+     *
+     * แต่ละเธรดสะสมผลของช่วงตัวเองแล้วรวมกันตอนท้าย
+     */
+    static MetricsReport evaluate(const float* truth, const float* predicted, size_t count,
+                                  bool classification, size_t classes);
+
+    /**
+     * @brief เติม ROC-AUC และ PR-AUC จากคะแนน (count x width)
+     *
+     * width 1: คะแนนของคลาส 1, width 2: ผลต่างคะแนนคลาส 1 กับคลาส 0, มากกว่านั้น: one-vs-rest ต่อคลาส
+     */
+    static void addRankingMetrics(MetricsReport& report, const float* truth, const float* scores,
+                                  size_t count, size_t width);
+
+    /**
+     * @brief ROC-AUC และ average precision ของคะแนนกับป้ายบวก/ลบ (คะแนนเท่ากันนับเป็นกลุ่มเดียว)
+     * @return false ถ้ามีแต่ตัวอย่างบวกหรือลบอย่างเดียว หรือมีคะแนนเป็น NaN
+     */
+    static bool rankingScores(const float* scores, size_t stride, const uint8_t* positive, size_t count,
+                              double& rocAuc, double& averagePrecision);
+
+    /**
+     * @brief เรียงดัชนีแถวตามคะแนนจากมากไปน้อยด้วย LSD radix sort แบบขนาน (คงลำดับเดิมเมื่อคะแนนเท่ากัน)
+     */
+    static void sortByScoreDescending(const float* scores, size_t stride, size_t count, std::vector<uint32_t>& order);
+};
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_METRICS_H
@@ -0,0 +1,177 @@
+/**
+ * @file Model.h
+ * @brief อินเตอร์เฟซพื้นฐานสำหรับโมเดล Machine Learning ที่ทำงานในตัวภาษาเอง
+ */
+
+#ifndef AI_LANGUAGE_MODEL_H
+#define AI_LANGUAGE_MODEL_H
+
+#include "Dataset.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ai_language {
+
+class SourceWriter;
+
+/**
+ * @brief แปลงคะแนน log ที่ยังไม่ normalize (count x width) เป็น log-probability ด้วย log-softmax ทีละแถว
+ *
+ * logit ของ softmax เทียบข้ามแถวไม่ได้ จึงต้อง normalize ก่อนคืนเป็น decisionScores หลายคลาส
+ */
+inline void logSoftmaxRows(float* scores, size_t count, size_t width) {
+    for (size_t i = 0; i < count; i++) {
+        float* row = scores + i * width;
+        float top = *std::max_element(row, row + width);
+        double sum = 0.0;
+        for (size_t k = 0; k < width; k++) {
+            sum += std::exp(static_cast<double>(row[k] - top));
+        }
+        float shift = top + static_cast<float>(std::log(sum));
+        for (size_t k = 0; k < width; k++) {
+            row[k] -= shift;
+        }
+    }
+}
+
+/**
+ * @class ModelParams
+ * @brief พารามิเตอร์ของโมเดล แยกเป็นค่าตัวเลขและค่าข้อความตามคำสั่ง set
+ */
+class ModelParams {
+public:
+    std::map<std::string, double> numeric;
+    std::map<std::string, std::string> text;
+
+    /**
+     * @brief อ่านค่าตัวเลข (ค่า -1 หมายถึงพารามิเตอร์ข้อความตามธรรมเนียมของ MLInterpreter)
+     */
+    double get(const std::string& name, double fallback) const {
+        auto it = numeric.find(name);
+        if (it == numeric.end() || it->second == -1) {
+            return fallback;
+        }
+        return it->second;
+    }
+
+    /**
+     * @brief อ่านค่าข้อความ (ตัดเครื่องหมายคำพูดออกแล้ว)
+     */
+    std::string getString(const std::string& name, const std::string& fallback) const {
+        auto it = text.find(name);
+        if (it == text.end()) {
+            return fallback;
+        }
+        return stripQuotes(it->second);
+    }
+};
+
+/**
+ * @class MLModel
+ * @brief โมเดลที่เทรนจาก Dataset และทำนายเป็นชุด (batch)
+ */
+class MLModel {
+public:
+    virtual ~MLModel() = default;
+
+    /**
+     * @brief ชื่อประเภทโมเดล เช่น "KNN"
+     */
+    virtual std::string typeName() const = 0;
+
+    /**
+     * @brief เทรนโมเดลจากชุดข้อมูล
+     */
+    virtual void fit(const Dataset& data) = 0;
+
+    /**
+     * @brief ปรับโมเดลที่เทรนแล้วด้วยข้อมูลชุดใหม่โดยไม่เริ่มต้นใหม่ (ค่าเริ่มต้นคือเทรนใหม่ทั้งหมด)
+     */
+    virtual void partialFit(const Dataset& data) { fit(data); }
+
+    /**
+     * @brief โมเดลรองรับการเทรนเพิ่มจากข้อมูลชุดใหม่หรือไม่
+     */
+    virtual bool supportsPartialFit() const { return false; }
+
+    /**
+     * @brief false สำหรับโมเดลที่ไม่ใช้คอลัมน์เป้าหมาย (เช่น KMeans ที่ทำนายหมายเลขกลุ่ม)
+     */
+    virtual bool isSupervised() const { return true; }
+
+    /**
+     * @brief ทำนายหลายแถวพร้อมกัน
+     * @param rows ข้อมูล row-major ขนาด count x numFeatures()
+     * @param count จำนวนแถว
+     * @param out ผลลัพธ์หนึ่งค่าต่อแถว
+     */
+    virtual void predictBatch(const float* rows, size_t count, float* out) const = 0;
+
+    /**
+     * @brief คะแนนต่อคลาสสำหรับ ROC-AUC / PR-AUC (count x ค่าที่คืน) ที่ยิ่งสูงยิ่งเป็นคลาสนั้น
+     * @return จำนวนคะแนนต่อแถว (0 = โมเดลไม่มีคะแนน, 1 = คะแนนของคลาส 1 สำหรับสองคลาส)
+     */
+    virtual size_t decisionScores(const float* rows, size_t count, std::vector<float>& out) const {
+        (void)rows;
+        (void)count;
+        (void)out;
+        return 0;
+    }
+
+    /**
+     * @brief ความสำคัญของ features ที่เก็บได้ระหว่างเทรน เช่น gain รวมของการแบ่งในต้นไม้ (รวมเป็น 1)
+     * @return ว่างถ้าโมเดลไม่มีข้อมูลนี้
+     */
+    virtual std::vector<double> splitImportance() const { return {}; }
+
+    /**
+     * @brief จำนวนไบต์ของพารามิเตอร์และโครงสร้างที่โมเดลที่เทรนแล้วใช้ตอนทำนาย (0 = ไม่ทราบ)
+     */
+    virtual size_t memoryBytes() const { return 0; }
+
+    /**
+     * @brief เขียนฟังก์ชัน `static float model(const float* x)` ที่ทำนายเหมือน predictBatch (export model)
+     * @return false ถ้าโมเดลนี้ส่งออกเป็นโค้ดไม่ได้
+     */
+    virtual bool emitSource(SourceWriter& out) const {
+        (void)out;
+        return false;
+    }
+
+    /**
+     * @brief แสดงข้อมูลสรุปหลังการเทรน
+     */
+    virtual void describe(std::ostream& os) const { (void)os; }
+
+    /**
+     * @brief แสดงข้อมูลเพิ่มเติมหลังทำนายเป็นชุด เช่น recall ของดัชนีโดยประมาณ
+     */
+    virtual void reportBatch(const float* rows, size_t count, std::ostream& os) const {
+        (void)rows;
+        (void)count;
+        (void)os;
+    }
+
+    /**
+     * @brief จำนวน features ที่โมเดลคาดหวัง
+     */
+    size_t numFeatures() const { return featureCount; }
+
+    float predictOne(const float* row) const {
+        float result = 0.0f;
+        predictBatch(row, 1, &result);
+        return result;
+    }
+
+protected:
+    size_t featureCount = 0;
+};
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_MODEL_H
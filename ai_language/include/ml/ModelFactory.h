@@ -0,0 +1,21 @@
+#ifndef AI_LANGUAGE_MODEL_FACTORY_H
+#define AI_LANGUAGE_MODEL_FACTORY_H
+
+#include "Model.h"
+#include <memory>
+#include <string>
+
+namespace ai_language {
+
+class ModelFactory {
+public:
+    // สร้างโมเดลที่ทำงานในตัวภาษาเอง คืนค่า nullptr ถ้ายังไม่มี implementation สำหรับประเภทนี้
+    static std::unique_ptr<MLModel> createModel(const std::string& type, const ModelParams& params);
+
+    // ตรวจสอบว่ามี implementation สำหรับประเภทโมเดลนี้หรือไม่
+    static bool isNativeModel(const std::string& type);
+};
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_MODEL_FACTORY_H
@@ -0,0 +1,105 @@
+/**
+ * @file NaiveBayes.h
+ * @brief NaiveBayes แบบ Gaussian และ Multinomial ที่เก็บเฉพาะสถิติพอเพียง (sufficient statistics)
+ */
+
+#ifndef AI_LANGUAGE_NAIVE_BAYES_H
+#define AI_LANGUAGE_NAIVE_BAYES_H
+
+#include "Model.h"
+#include <string>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @brief รูปแบบการแจกแจงของ features (กำหนดด้วย set variant "<ชื่อ>")
+ */
+enum class NaiveBayesVariant {
+    Gaussian,    ///< features ต่อเนื่อง: เก็บจำนวน ผลรวม และผลรวมกำลังสองต่อคลาส
+    Multinomial  ///< features เป็นจำนวนนับ: เก็บผลรวมของแต่ละ feature ต่อคลาส
+};
+
+/**
+ * @class NaiveBayesStats
+ * @brief สถิติต่อคลาสที่รวมกันได้ (merge) ทำให้เทรนแบบขนานและเพิ่มข้อมูลทีหลังได้
+ */
+class NaiveBayesStats {
+public:
+    size_t classes = 0;
+    size_t cols = 0;
+    std::vector<double> counts;      ///< จำนวนแถวต่อคลาส
+    std::vector<double> sums;        ///< classes x cols: ผลรวมของ x
+    std::vector<double> sumSquares;  ///< classes x cols: ผลรวมของ x² (เฉพาะ Gaussian)
+
+    /**
+     * @brief ขยายจำนวนคลาส/คอลัมน์โดยคงสถิติเดิมไว้
+     */
+    void resize(size_t numClasses, size_t numCols, bool withSquares);
+
+    /**
+     * @brief สะสมสถิติของแถว [begin, end)
+     */
+    void accumulate(const Dataset& data, size_t begin, size_t end);
+
+    /**
+     * @brief รวมสถิติจากอีกชุด (จำนวนคอลัมน์ต้องเท่ากัน)
+     */
+    void merge(const NaiveBayesStats& other);
+
+    double total() const;
+};
+
+/**
+ * @class NaiveBayesModel
+ * @brief จำแนกประเภทด้วยกฎของเบย์ โดยสมมติว่า features เป็นอิสระต่อกันเมื่อรู้คลาส
+ *
+ * พารามิเตอร์: variant "gaussian"|"multinomial", var_smoothing (1e-9), alpha (1.0)
+ * การเทรนครั้งถัดไปบนข้อมูลชุดใหม่จะรวมสถิติเข้ากับของเดิม (partialFit) แทนการเทรนใหม่ทั้งหมด
+ */
+class NaiveBayesModel : public MLModel {
+public:
+    explicit NaiveBayesModel(const ModelParams& params);
+
+    std::string typeName() const override { return "NaiveBayes"; }
+    void fit(const Dataset& data) override;
+    void partialFit(const Dataset& data) override;
+    bool supportsPartialFit() const override { return true; }
+    void predictBatch(const float* rows, size_t count, float* out) const override;
+    size_t decisionScores(const float* rows, size_t count, std::vector<float>& out) const override;
+    bool emitSource(SourceWriter& out) const override;
+    void describe(std::ostream& os) const override;
+    size_t memoryBytes() const override;
+
+    /**
+     * @brief คำนวณ log P(x, c) ของทุกแถวและทุกคลาส
+     * @param out ผลลัพธ์ count x numClasses()
+     */
+    void jointLogLikelihood(const float* rows, size_t count, float* out) const;
+
+    size_t numClasses() const { return stats.classes; }
+    const NaiveBayesStats& statistics() const { return stats; }
+    NaiveBayesVariant variant() const { return kind; }
+
+private:
+    void updateCoefficients();
+    size_t expandedWidth() const;
+    void expandRows(const float* rows, size_t count, float* out) const;
+
+    NaiveBayesVariant kind;
+    double varSmoothing;
+    double alpha;
+
+    NaiveBayesStats stats;
+    size_t updates = 0;
+
+    // log-likelihood เขียนเป็นผลคูณภายใน: score[c] = bias[c] + weights[c] · expand(x)
+    // Gaussian: expand(x) = [(x - center)², (x - center)], Multinomial: expand(x) = x
+    std::vector<float> center;
+    std::vector<float> weights;   ///< classes x expandedWidth()
+    std::vector<float> bias;      ///< classes (คลาสที่ยังไม่มีข้อมูลมีค่า -inf)
+};
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_NAIVE_BAYES_H
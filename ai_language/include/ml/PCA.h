@@ -0,0 +1,68 @@
+/**
+ * @file PCA.h
+ * @brief PCA ด้วย randomized SVD สำหรับเมทริกซ์สูงผอม โดยไม่สร้างเมทริกซ์ covariance
+ */
+
+#ifndef AI_LANGUAGE_PCA_H
+#define AI_LANGUAGE_PCA_H
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @class PCA
+ * @brief ลดมิติข้อมูลเป็นแกนหลัก components แกน
+ *
+ * ใช้ randomized range finder: Y = (X - mean) * Omega แล้วทำ power iteration
+ * สลับระหว่าง (X - mean)^T Q และ (X - mean) Z โดยทำ orthonormalize ทุกครั้งด้วย blocked QR
+ * (Gram-Schmidt ระหว่างแผงละ 32 คอลัมน์และ Cholesky QR ภายในแผง ทำซ้ำสองรอบ) งานที่วนทุกแถวแบ่งเป็นก้อนแบบขนานทั้งหมด
+ * การลบค่าเฉลี่ยทำโดยปริยายในแต่ละ GEMM จึงไม่มีการคัดลอก X และใช้หน่วยความจำเพิ่มแค่ rows x (components + oversample)
+ */
+class PCA {
+public:
+    struct Options {
+        size_t components = 2;
+        size_t oversample = 10;       ///< คอลัมน์สุ่มเพิ่มจาก components เพื่อความแม่นยำ
+        size_t powerIterations = 2;   ///< จำนวนรอบ power iteration (ช่วยเมื่อค่าเอกฐานลดลงช้า)
+        unsigned seed = 42;
+    };
+
+    /**
+     * @brief หาแกนหลักของ data (rows x cols แบบ row-major)
+     */
+    void fit(const float* data, size_t rows, size_t cols, const Options& options);
+
+    /**
+     * @brief ฉายแถว (count x inputDimension()) ลงแกนหลัก ได้ count x outputDimension()
+     */
+    void transform(const float* rows, size_t count, float* out) const;
+
+    bool fitted() const { return !components.empty(); }
+    size_t inputDimension() const { return inputs; }
+    size_t outputDimension() const { return outputs; }
+    const std::vector<double>& explainedVariance() const { return variance; }
+    const std::vector<double>& explainedVarianceRatio() const { return varianceRatio; }
+    const std::vector<float>& componentMatrix() const { return components; }
+    const std::vector<float>& meanOffsets() const { return meanProjection; }
+
+    void describe(std::ostream& os) const;
+
+private:
+    size_t inputs = 0;
+    size_t outputs = 0;
+    size_t fittedRows = 0;
+    size_t rank = 0;                    ///< จำนวนคอลัมน์ของ range finder (components + oversample)
+    std::vector<float> mean;
+    std::vector<float> components;      ///< outputs x inputs
+    std::vector<float> meanProjection;  ///< components * mean ใช้ลบหลังคูณข้อมูลดิบ
+    std::vector<double> variance;
+    std::vector<double> varianceRatio;
+    double seconds = 0.0;
+};
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_PCA_H
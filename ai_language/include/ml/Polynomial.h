@@ -0,0 +1,72 @@
+/**
+ * @file Polynomial.h
+ * @brief features พหุนาม (preprocess polynomial) ที่สร้างทีละแถวตอนใช้งานแทนการเก็บเมทริกซ์ที่ขยายแล้ว
+ */
+
+#ifndef AI_LANGUAGE_POLYNOMIAL_H
+#define AI_LANGUAGE_POLYNOMIAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @class PolynomialFeatures
+ * @brief เมทริกซ์เสมือนของพจน์ x_a * x_b * ... ที่มีดีกรีรวม 1 ถึง degree (ไม่มีคอลัมน์ค่าคงที่)
+ *
+ * ลำดับคอลัมน์เหมือน scikit-learn: features เดิม ตามด้วยพจน์ดีกรี 2 เรียงตามดัชนี (a, b) ที่ a <= b
+ * แล้วจึงดีกรีถัดไป interaction_only ตัดพจน์ที่มีตัวแปรซ้ำ (a < b) ออก
+ * พจน์ดีกรี t สร้างจากพจน์ดีกรี t - 1 คูณกับช่วง x[last..] ที่ต่อเนื่องกัน ลูปในจึง vectorize ได้
+ * 200 features ที่ดีกรี 2 ได้ 20,300 คอลัมน์ ผู้ใช้จึงขยายทีละแถวหรือทีละก้อนเล็กในเคอร์เนลของตนเอง
+ */
+class PolynomialFeatures {
+public:
+    PolynomialFeatures() = default;
+
+    /**
+     * @throw std::invalid_argument ถ้า degree เป็น 0 หรือจำนวนคอลัมน์ที่ขยายแล้วเกิน maxOutputs()
+     */
+    PolynomialFeatures(size_t inputs, size_t degree, bool interactionOnly);
+
+    /**
+     * @brief จำนวนคอลัมน์หลังขยาย (ไม่ต้องสร้าง object) คืน 0 ถ้าเกิน maxOutputs()
+     */
+    static size_t outputDimension(size_t inputs, size_t degree, bool interactionOnly);
+    static size_t maxOutputs() { return size_t(1) << 24; }
+
+    size_t inputDimension() const { return inputs; }
+    size_t outputDimension() const { return outputs; }
+    size_t degree() const { return maxDegree; }
+    bool interactionOnly() const { return interactionsOnly; }
+    bool identity() const { return maxDegree <= 1; }
+
+    /**
+     * @brief ขยายแถว (count x inputDimension()) เป็น count x outputDimension()
+     */
+    void expand(const float* rows, size_t count, float* out) const;
+
+    /**
+     * @brief ชื่อคอลัมน์ที่ขยายแล้ว เช่น "a", "a^2", "a*b"
+     */
+    std::vector<std::string> featureNames(const std::vector<std::string>& inputNames) const;
+
+    /**
+     * @brief จำนวนแถวต่อก้อนที่ทำให้บัฟเฟอร์ของแถวที่ขยายแล้วไม่เกิน bytes (อย่างน้อย 1)
+     */
+    size_t rowsPerBlock(size_t bytes) const;
+
+private:
+    size_t inputs = 0;
+    size_t maxDegree = 1;
+    bool interactionsOnly = false;
+    size_t outputs = 0;
+    std::vector<size_t> levelStart;    ///< คอลัมน์แรกของแต่ละดีกรี (levelStart[t - 1] สำหรับดีกรี t)
+    std::vector<uint32_t> lastFactor;  ///< ดัชนีตัวแปรสุดท้ายของแต่ละพจน์
+};
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_POLYNOMIAL_H
@@ -0,0 +1,39 @@
+/**
+ * @file RandomForest.h
+ * @brief Random Forest: ต้นไม้หลายต้นจาก bootstrap sample และการสุ่ม features ต่อโหนด เทรนแต่ละต้นแบบขนาน
+ */
+
+#ifndef AI_LANGUAGE_RANDOM_FOREST_H
+#define AI_LANGUAGE_RANDOM_FOREST_H
+
+#include "TreeEnsemble.h"
+
+namespace ai_language {
+
+/**
+ * @class RandomForestModel
+ * @brief เฉลี่ยสัดส่วนคลาส (จำแนกประเภท) หรือค่าทำนาย (ถดถอย) จากทุกต้น
+ *
+ * พารามิเตอร์: trees หรือ n_estimators (100), max_depth (ไม่จำกัด), max_features
+ * (จำนวน หรือสัดส่วนถ้าน้อยกว่า 1; ค่าเริ่มต้น sqrt(features) สำหรับจำแนกประเภท และทั้งหมดสำหรับถดถอย),
+ * bootstrap (1), min_samples_split, min_samples_leaf
+ */
+class RandomForestModel : public TreeEnsembleModel {
+public:
+    explicit RandomForestModel(const ModelParams& params);
+
+    std::string typeName() const override { return "RandomForest"; }
+    void fit(const Dataset& data) override;
+    void describe(std::ostream& os) const override;
+
+private:
+    size_t treeCount;
+    double maxFeatures;
+    bool bootstrap;
+    size_t featuresPerSplit = 0;
+    TreeBuildParams buildParams;
+};
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_RANDOM_FOREST_H
@@ -0,0 +1,99 @@
+/**
+ * @file Recommender.h
+ * @brief recommend model: สรุปชุดข้อมูลในรอบเดียวแบบขนาน แล้วจัดอันดับโมเดลด้วยโมเดลตัวแทนบนแถวตัวอย่าง
+ */
+
+#ifndef AI_LANGUAGE_RECOMMENDER_H
+#define AI_LANGUAGE_RECOMMENDER_H
+
+#include "Model.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @brief สรุปชุดข้อมูลที่คำนวณได้ถูก (รอบเดียวบนทุกแถว ส่วนสหสัมพันธ์คำนวณบนแถวตัวอย่าง)
+ */
+struct DatasetSketch {
+    size_t rows = 0;
+    size_t cols = 0;
+    bool classification = false;
+    std::vector<size_t> classCounts;
+    double zeroFraction = 0.0;               ///< สัดส่วนค่า 0 ในเมทริกซ์ features
+    std::vector<double> cardinality;         ///< จำนวนค่าไม่ซ้ำต่อ feature (ประมาณด้วย KMV เมื่อเกิน 64 ค่า)
+    size_t lowCardinality = 0;               ///< features ที่มีไม่เกิน 10 ค่า (น่าจะเป็นรหัสหมวดหมู่)
+    double scaleSpread = 1.0;                ///< ส่วนเบี่ยงเบนมาตรฐานมากสุด / น้อยสุด (ไม่นับคอลัมน์ค่าคงที่)
+    size_t constantFeatures = 0;
+    double maxFeatureCorrelation = 0.0;      ///< |r| มากสุดระหว่างสอง features
+    double maxTargetCorrelation = 0.0;       ///< |r| มากสุดระหว่าง feature กับเป้าหมาย (สัญญาณเชิงเส้น)
+    std::vector<uint32_t> sample;            ///< ดัชนีแถวตัวอย่าง (bottom-k ของ hash จึงรวมข้ามเธรดได้)
+    double seconds = 0.0;
+
+    /**
+     * @brief สัดส่วนคลาสน้อยสุด / มากสุด (1 = สมดุล)
+     */
+    double classBalance() const;
+
+    void print(std::ostream& os) const;
+};
+
+/**
+ * @brief ผลของโมเดลตัวแทนหนึ่งประเภท
+ */
+struct ModelCandidate {
+    std::string type;
+    double score = 0.0;              ///< accuracy หรือ R^2 บนแถวตัวอย่างที่กันไว้
+    size_t trainRows = 0;            ///< แถวที่ใช้เทรนตัวแทน (น้อยกว่าแถวตัวอย่างเมื่อเกินงบเวลา)
+    double sampleSeconds = 0.0;
+    double scalingExponent = 1.0;    ///< เวลาเทรน ~ rows^exponent วัดจากสองขนาดตัวอย่าง
+    double estimatedSeconds = 0.0;   ///< เวลาเทรนบนข้อมูลทั้งหมดโดยประมาณ
+    bool competitive = false;        ///< คะแนนห่างจากคะแนนดีที่สุดไม่เกิน tolerance
+    std::string note;                ///< เหตุผลที่ข้ามหรือเทรนไม่สำเร็จ
+
+    double scorePerSecond() const { return estimatedSeconds > 0.0 ? score / estimatedSeconds : 0.0; }
+};
+
+/**
+ * @brief ผลการแนะนำ: โมเดลเรียงตามลำดับที่แนะนำ และข้อสังเกตจากสรุปชุดข้อมูล
+ */
+struct RecommendationReport {
+    DatasetSketch sketch;
+    std::vector<ModelCandidate> candidates;
+    std::vector<std::string> notes;
+    size_t sampleRows = 0;
+    double budgetSeconds = 0.0;
+    double seconds = 0.0;
+
+    void print(std::ostream& os) const;
+};
+
+struct RecommendOptions {
+    size_t sampleRows = 2000;        ///< ขนาดแถวตัวอย่าง (3/4 เทรน, 1/4 ประเมิน)
+    double budgetSeconds = 2.0;      ///< งบเวลารวมของโมเดลตัวแทน
+    double tolerance = 0.02;         ///< คะแนนที่ยอมให้ต่ำกว่าคะแนนดีที่สุดก่อนพิจารณาความเร็ว
+    unsigned seed = 42;
+    ModelParams params;              ///< พารามิเตอร์ที่จะใช้เทรนจริง (ตัวแทนใช้ค่าเดียวกัน)
+};
+
+/**
+ * @brief สรุปชุดข้อมูลในรอบเดียว: แบ่งแถวเป็นก้อนแบบขนาน แต่ละก้อนเก็บผลรวม ค่าศูนย์ จำนวนคลาส
+ * KMV ของค่าแต่ละ feature และ hash ต่ำสุด sampleRows ค่า แล้วรวมผลทุกก้อน
+ */
+DatasetSketch sketchDataset(const Dataset& data, size_t sampleRows, unsigned seed);
+
+/**
+ * @brief จัดอันดับโมเดลที่ทำงานในตัวภาษาสำหรับชุดข้อมูลนี้
+ *
+ * โมเดลตัวแทนเทรนพร้อมกัน (คิวงานร่วมแบบเดียวกับ Voting/Stacking) บนหนึ่งในสี่ของแถวตัวอย่างก่อน
+ * แล้วจึงเทรนบนแถวตัวอย่างทั้งหมดถ้าเวลาที่คาดไว้ยังอยู่ในงบ เวลาของสองขนาดให้เลขชี้กำลังของการขยายไปยังข้อมูลทั้งหมด
+ * โมเดลที่คะแนนห่างจากคะแนนดีที่สุดไม่เกิน tolerance เรียงตามคะแนนต่อวินาทีของการเทรนโดยประมาณ
+ * ที่เหลือเรียงตามคะแนน
+ */
+RecommendationReport recommendModels(const Dataset& data, const RecommendOptions& options);
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_RECOMMENDER_H
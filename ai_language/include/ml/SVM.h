@@ -0,0 +1,142 @@
+/**
+ * @file SVM.h
+ * @brief Support Vector Machine: SMO พร้อมแคชแถวเคอร์เนลแบบ LRU และ dual coordinate descent สำหรับเคอร์เนลเชิงเส้น
+ */
+
+#ifndef AI_LANGUAGE_SVM_H
+#define AI_LANGUAGE_SVM_H
+
+#include "Model.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @brief เคอร์เนลที่รองรับ (กำหนดด้วย set kernel "<ชื่อ>")
+ */
+enum class SVMKernel {
+    Linear,  ///< x · y แก้ด้วย dual coordinate descent โดยไม่สร้างแถวเคอร์เนล
+    RBF      ///< exp(-gamma ||x - y||²) แก้ด้วย SMO
+};
+
+/**
+ * @class KernelRowCache
+ * @brief แคชแถวของเมทริกซ์เคอร์เนลแบบ LRU ภายใต้งบหน่วยความจำที่กำหนด
+ *
+ * แต่ละแถวเก็บเฉพาะช่วงต้นที่คำนวณแล้ว (len) เพราะเมื่อ shrinking ตัวแก้สมการต้องการแค่ส่วนของ active set
+ */
+class KernelRowCache {
+public:
+    KernelRowCache(size_t rows, size_t bytes);
+
+    /**
+     * @brief ขอแถว index ที่มีอย่างน้อย len ค่า
+     * @param data ตัวชี้ไปยังข้อมูลของแถว
+     * @return จำนวนค่าที่มีอยู่แล้วในแคช ผู้เรียกต้องคำนวณช่วง [ค่าที่คืน, len) เอง
+     */
+    size_t get(size_t index, float** data, size_t len);
+
+    /**
+     * @brief สลับตำแหน่ง i และ j ในทุกแถว (ใช้ตอน shrinking ย้ายตัวแปรออกจาก active set)
+     */
+    void swapIndex(size_t i, size_t j);
+
+    size_t hits() const { return hitCount; }
+    size_t misses() const { return missCount; }
+
+private:
+    struct Row {
+        std::vector<float> data;
+        size_t len = 0;
+        int32_t prev = -1;
+        int32_t next = -1;
+        bool linked = false;
+    };
+
+    void unlink(size_t index);
+    void pushBack(size_t index);
+
+    std::vector<Row> rows;
+    int32_t head = -1;  ///< แถวที่ใช้ล่าสุดน้อยที่สุด (ถูกไล่ออกก่อน)
+    int32_t tail = -1;
+    size_t freeFloats;
+    size_t hitCount = 0;
+    size_t missCount = 0;
+};
+
+/**
+ * @brief สถิติของการเทรนหนึ่งปัญหาย่อยแบบสองคลาส
+ */
+struct SVMSolveInfo {
+    size_t iterations = 0;
+    size_t supportVectors = 0;
+    size_t shrinkPasses = 0;
+    size_t cacheHits = 0;
+    size_t cacheMisses = 0;
+    bool converged = false;
+};
+
+/**
+ * @class SVMModel
+ * @brief จำแนกประเภทด้วย SVM (หลายคลาสใช้แบบ one-vs-rest โดยเทรนแต่ละคลาสพร้อมกัน)
+ *
+ * พารามิเตอร์: kernel "rbf"|"linear", C (1.0), gamma (ค่าเริ่มต้น 1 / (features * ความแปรปรวน)),
+ * tol (1e-3 สำหรับ SMO, 0.1 สำหรับ linear), max_iter, kernel_cache_mb (100), shrinking (1)
+ */
+class SVMModel : public MLModel {
+public:
+    explicit SVMModel(const ModelParams& params);
+
+    std::string typeName() const override { return "SVM"; }
+    void fit(const Dataset& data) override;
+    void predictBatch(const float* rows, size_t count, float* out) const override;
+    size_t decisionScores(const float* rows, size_t count, std::vector<float>& out) const override;
+    bool emitSource(SourceWriter& out) const override;
+    void describe(std::ostream& os) const override;
+    size_t memoryBytes() const override;
+
+    /**
+     * @brief ค่า decision function ของทุกแถว (count x จำนวนปัญหาย่อย)
+     */
+    void decisionFunction(const float* rows, size_t count, float* out) const;
+
+    SVMKernel kernel() const { return kernelType; }
+    size_t numSupportVectors() const { return svCount; }
+    size_t numProblems() const { return problems; }
+
+private:
+    void solveSMO(const std::vector<float>& x, const std::vector<float>& norms, const std::vector<int8_t>& y,
+                  size_t rows, size_t cacheBytes, std::vector<double>& alpha, double& rho, SVMSolveInfo& info) const;
+    void solveDCD(const std::vector<float>& x, const std::vector<int8_t>& y, size_t rows,
+                  float* w, float& b, SVMSolveInfo& info) const;
+
+    SVMKernel kernelType;
+    double C;
+    double gammaParam;
+    double tolerance;
+    size_t maxIterations;
+    double cacheMB;
+    bool shrinking;
+    unsigned seed;
+
+    float gamma = 0.0f;
+    size_t classes = 0;
+    size_t problems = 0;           ///< 1 สำหรับสองคลาส, จำนวนคลาสสำหรับ one-vs-rest
+    std::vector<SVMSolveInfo> info;
+
+    // Linear: weights (problems x features) และ bias
+    std::vector<float> weights;
+    std::vector<float> bias;
+
+    // RBF: support vectors รวมของทุกปัญหาย่อย พร้อมสัมประสิทธิ์ alpha_i y_i ต่อปัญหา
+    size_t svCount = 0;
+    std::vector<float> supportVectors;  ///< svCount x features
+    std::vector<float> svNorms;
+    std::vector<float> svCoef;          ///< svCount x problems
+};
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_SVM_H
@@ -0,0 +1,177 @@
+/**
+ * @file TreeEnsemble.h
+ * @brief โครงสร้างร่วมของโมเดลต้นไม้ และรูปแบบการทำนายที่คอมไพล์แล้ว (BFS แบบต่อเนื่อง และ QuickScorer)
+ */
+
+#ifndef AI_LANGUAGE_TREE_ENSEMBLE_H
+#define AI_LANGUAGE_TREE_ENSEMBLE_H
+
+#include "Model.h"
+#include "DecisionTree.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @brief รูปแบบการเดินต้นไม้ตอนทำนาย (กำหนดด้วย set inference "<ชื่อ>")
+ */
+enum class TreeLayout {
+    Auto,         ///< QuickScorer ถ้าต้นไม้ตื้นพอ ไม่เช่นนั้นใช้ Compiled
+    Naive,        ///< เดินโหนดตามลำดับที่สร้างด้วยเกณฑ์ float
+    Compiled,     ///< โหนด 8 ไบต์เรียงแบบ breadth-first ต่อเนื่องกันทั้ง ensemble พร้อมเกณฑ์แบบรหัสช่วง 8 บิต
+    QuickScorer   ///< bitvector ต่อต้นไม้ ประเมินตาม feature แทนการเดินต้นไม้ (ต้นไม้ไม่เกิน 64 ใบ)
+};
+
+/**
+ * @class CompiledForest
+ * @brief ทุกต้นอยู่ในอาร์เรย์เดียว ลูกซ้ายและขวาอยู่ติดกัน จึงเก็บแค่ตำแหน่งลูกซ้าย
+ */
+class CompiledForest {
+public:
+    struct Node {
+        uint16_t feature;
+        uint8_t bin;
+        uint8_t isLeaf;
+        uint32_t target;   ///< ลูกซ้าย (ลูกขวาอยู่ที่ target + 1) หรือตำแหน่งค่าใบ
+    };
+
+    /**
+     * @return false ถ้าคอมไพล์ไม่ได้ (features เกิน 65535)
+     */
+    bool compile(const std::vector<DecisionTree>& trees, size_t features);
+
+    /**
+     * @brief บวกค่าใบของทุกต้นเข้ากับ scores (count x width) โดยประมวลผลทีละบล็อกของแถวต่อต้นไม้
+     */
+    void evaluate(const uint8_t* binnedRows, size_t count, size_t cols, float* scores, size_t width) const;
+
+    bool empty() const { return roots.empty(); }
+    size_t bytes() const;
+
+private:
+    std::vector<Node> nodes;
+    std::vector<uint32_t> roots;
+    std::vector<uint16_t> outputs;
+    std::vector<uint16_t> offsets;
+    std::vector<float> leafValues;
+};
+
+/**
+ * @class QuickScorerForest
+ * @brief QuickScorer: ทุกโหนดภายในเก็บ mask ของใบที่ยังไปถึงได้เมื่อเงื่อนไขเป็นเท็จ
+ *
+ * สำหรับแต่ละ feature เกณฑ์ของทุกต้นเรียงจากน้อยไปมาก ระหว่างประเมินจะไล่เฉพาะเกณฑ์ที่น้อยกว่าค่าของแถว
+ * แล้ว AND mask เข้ากับ bitvector ของต้นนั้น ใบที่ออกคือบิตต่ำสุดที่เหลืออยู่
+ */
+class QuickScorerForest {
+public:
+    /**
+     * @return false ถ้ามีต้นที่มีใบเกิน 64 ใบ
+     */
+    bool compile(const std::vector<DecisionTree>& trees, size_t features);
+
+    void evaluate(const uint8_t* binnedRows, size_t count, size_t cols, float* scores, size_t width) const;
+
+    bool empty() const { return treeCount == 0; }
+    size_t bytes() const;
+
+private:
+    size_t treeCount = 0;
+    std::vector<uint32_t> featureOffsets;  ///< features + 1
+    std::vector<uint8_t> entryBins;
+    std::vector<uint32_t> entryTrees;
+    std::vector<uint64_t> entryMasks;
+    std::vector<uint64_t> initialMasks;    ///< บิตของใบทั้งหมดในแต่ละต้น
+    std::vector<uint32_t> leafOffsets;     ///< ตำแหน่งเริ่มของค่าใบแต่ละต้น
+    std::vector<uint16_t> outputs;
+    std::vector<uint16_t> offsets;
+    std::vector<float> leafValues;
+};
+
+/**
+ * @class TreeEnsembleModel
+ * @brief ฐานของ DecisionTree, RandomForest และ GradientBoosting
+ *
+ * คะแนนดิบ = baseScore + scoreScale * ผลรวมค่าใบ แล้วแปลงเป็นผลทำนาย
+ * (argmax สำหรับหลายคลาส, เครื่องหมายสำหรับ boosting สองคลาส, ค่าตรงๆ สำหรับ regression)
+ *
+ * พารามิเตอร์ร่วม: inference "auto"|"naive"|"compiled"|"quickscorer", max_bins (256)
+ */
+class TreeEnsembleModel : public MLModel {
+public:
+    explicit TreeEnsembleModel(const ModelParams& params);
+
+    void predictBatch(const float* rows, size_t count, float* out) const override;
+    size_t decisionScores(const float* rows, size_t count, std::vector<float>& out) const override;
+    void reportBatch(const float* rows, size_t count, std::ostream& os) const override;
+    std::vector<double> splitImportance() const override { return gainImportance; }
+    bool emitSource(SourceWriter& out) const override;
+    size_t memoryBytes() const override;
+
+    /**
+     * @brief คำนวณคะแนนดิบ (count x scoreWidth) ด้วยรูปแบบที่กำหนด
+     */
+    void rawScores(const float* rows, size_t count, float* out, TreeLayout layout) const;
+
+    size_t numTrees() const { return trees.size(); }
+    size_t scoreSize() const { return scoreWidth; }
+    const std::vector<DecisionTree>& treeList() const { return trees; }
+    TreeLayout activeLayout() const;
+    static std::string layoutName(TreeLayout layout);
+
+protected:
+    /**
+     * @brief แบ่งช่วงค่า features และแปลงข้อมูลเทรนเป็นรหัสช่วงแบบ column-major
+     */
+    void prepareBins(const Dataset& data, std::vector<uint8_t>& columns);
+
+    /**
+     * @brief คอมไพล์ต้นไม้ทั้งหมดเป็นรูปแบบการทำนายและรวม gain ต่อ feature เรียกหลังเทรนเสร็จ
+     */
+    void compileLayouts();
+
+    void describeTrees(std::ostream& os) const;
+
+    FeatureBinner binner;
+    std::vector<DecisionTree> trees;
+    size_t maxBins;
+    TreeLayout requestedLayout;
+    bool classification = false;
+    bool marginOutput = false;         ///< boosting สองคลาส: คะแนนเดียวเป็น log-odds
+    size_t scoreWidth = 1;
+    std::vector<float> baseScore;
+    float scoreScale = 1.0f;
+
+    CompiledForest compiled;
+    QuickScorerForest quickScorer;
+    std::vector<double> gainImportance;   ///< gain รวมของการแบ่งต่อ feature (รวมเป็น 1)
+};
+
+/**
+ * @class DecisionTreeModel
+ * @brief ต้นไม้ตัดสินใจหนึ่งต้น (Gini สำหรับจำแนกประเภท, MSE สำหรับถดถอย)
+ *
+ * พารามิเตอร์: max_depth (ไม่จำกัด), min_samples_split (2), min_samples_leaf (1)
+ */
+class DecisionTreeModel : public TreeEnsembleModel {
+public:
+    explicit DecisionTreeModel(const ModelParams& params);
+
+    std::string typeName() const override { return "DecisionTree"; }
+    void fit(const Dataset& data) override;
+    void describe(std::ostream& os) const override;
+
+private:
+    TreeBuildParams buildParams;
+};
+
+/**
+ * @brief อ่านพารามิเตอร์ร่วมของการสร้างต้นไม้จากคำสั่ง set
+ */
+TreeBuildParams readTreeParams(const ModelParams& params, size_t defaultDepth);
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_TREE_ENSEMBLE_H
@@ -0,0 +1,42 @@
+/**
+ * @file cpu_features.h
+ * @brief ตรวจสอบชุดคำสั่ง SIMD ที่ CPU รองรับขณะรันโปรแกรม
+ */
+
+#ifndef AI_LANGUAGE_CPU_FEATURES_H
+#define AI_LANGUAGE_CPU_FEATURES_H
+
+#include <string>
+
+namespace ai_language {
+
+/**
+ * @brief CPU รองรับ AVX2 และ FMA หรือไม่
+ */
+bool cpuHasAvx2();
+
+/**
+ * @brief CPU รองรับ AVX-512F หรือไม่
+ */
+bool cpuHasAvx512();
+
+/**
+ * @brief CPU รองรับ AVX512-BF16 (ผลคูณจุดของคู่ bfloat16 สะสมเป็น float32) หรือไม่
+ */
+bool cpuHasAvx512Bf16();
+
+/**
+ * @brief CPU รองรับ AMX-BF16 (คูณไทล์ bfloat16 16x32 สะสมเป็น float32) และระบบปฏิบัติการอนุญาตให้ใช้ไทล์หรือไม่
+ *
+ * บน Linux การเรียกครั้งแรกขอสิทธิ์ XTILEDATA ให้ทั้งโปรเซสด้วย arch_prctl
+ */
+bool cpuHasAmxBf16();
+
+/**
+ * @brief ชื่อชุดคำสั่งที่ดีที่สุดที่ใช้ได้ (สำหรับแสดงผล)
+ */
+std::string cpuSimdLevel();
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_CPU_FEATURES_H
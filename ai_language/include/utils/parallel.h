@@ -0,0 +1,185 @@
+/**
+ * @file parallel.h
+ * @brief เครื่องมือสำหรับแบ่งงานแบบขนานบน CPU หลายคอร์
+ */
+
+#ifndef AI_LANGUAGE_PARALLEL_H
+#define AI_LANGUAGE_PARALLEL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ai_language {
+
+/**
+ * @brief จำนวนเธรดสูงสุดที่ parallelFor จะใช้ (ค่าเริ่มต้นคือจำนวนคอร์ของเครื่อง)
+ */
+size_t maxThreads();
+
+/**
+ * @brief กำหนดจำนวนเธรดสูงสุด (0 = ใช้จำนวนคอร์ของเครื่อง)
+ */
+void setMaxThreads(size_t threads);
+
+/**
+ * @brief จำนวนเธรดที่ parallelFor ซึ่งเริ่มจากเธรดปัจจุบันใช้ได้
+ *
+ * maxThreads() ที่ระดับบนสุด, 1 ภายใน parallelFor และจำนวนคอร์ที่ได้รับภายในงานของ scheduleTasks
+ */
+size_t availableThreads();
+
+/**
+ * @brief ตรวจสอบว่าเธรดปัจจุบันกำลังทำงานอยู่ภายใน parallelFor หรือไม่
+ *
+ * parallelFor ที่ซ้อนกันจะทำงานแบบลำดับในเธรดเดิม เพื่อไม่ให้จำนวนเธรดเกินจำนวนคอร์
+ */
+bool inParallelRegion();
+
+namespace detail {
+/**
+ * @brief ตั้งจำนวนเธรดที่เธรดปัจจุบันใช้ได้ (0 = maxThreads()) และคืนค่าเดิมเพื่อคืนสถานะภายหลัง
+ */
+size_t exchangeThreadBudget(size_t threads);
+
+/**
+ * @brief เรียก invoke(context, c) ทุก c ใน [0, chunks) พร้อมกัน โดยเธรดปัจจุบันร่วมทำด้วย
+ *
+ * ใช้ชุดเธรดถาวรที่สร้างเมื่อต้องการเธรดมากกว่าที่มีอยู่ครั้งแรก การเรียกครั้งถัดไปจึงไม่สร้างเธรดหรือจอง heap
+ * ถ้าชุดเธรดกำลังทำงานให้ผู้เรียกอื่น (เช่นงานที่ scheduleTasks รันพร้อมกัน) จะสร้างเธรดชั่วคราวสำหรับครั้งนั้นแทน
+ */
+void runChunks(size_t chunks, void (*invoke)(void*, size_t), void* context);
+
+template <typename Chunk>
+void invokeChunk(void* context, size_t chunk) {
+    (*static_cast<Chunk*>(context))(chunk);
+}
+} // namespace detail
+
+/**
+ * @brief แบ่งช่วง [begin, end) เป็นก้อนต่อเนื่องและเรียก fn(chunkBegin, chunkEnd, worker) แบบขนาน
+ * @param minChunk ขนาดก้อนขั้นต่ำ เพื่อไม่ให้สร้างเธรดสำหรับงานเล็กเกินไป
+ *
+ * worker มีค่าอยู่ในช่วง [0, จำนวนก้อน) ใช้สำหรับเข้าถึงบัฟเฟอร์ประจำเธรด
+ */
+template <typename Fn>
+void parallelFor(size_t begin, size_t end, Fn&& fn, size_t minChunk = 1) {
+    if (end <= begin) {
+        return;
+    }
+    size_t total = end - begin;
+    if (minChunk == 0) {
+        minChunk = 1;
+    }
+    size_t chunks = (total + minChunk - 1) / minChunk;
+    size_t threads = availableThreads();
+    if (chunks > threads) {
+        chunks = threads;
+    }
+    if (chunks <= 1) {
+        fn(begin, end, static_cast<size_t>(0));
+        return;
+    }
+
+    size_t step = (total + chunks - 1) / chunks;
+    chunks = (total + step - 1) / step;   // ปัดขนาดก้อนขึ้นแล้วก้อนท้าย ๆ อาจไม่มีงาน
+    auto chunk = [&fn, begin, end, step](size_t c) {
+        size_t chunkBegin = begin + c * step;
+        fn(chunkBegin, chunkBegin + step < end ? chunkBegin + step : end, c);
+    };
+    detail::runChunks(chunks, &detail::invokeChunk<decltype(chunk)>, &chunk);
+}
+
+/**
+ * @brief จำนวนก้อนที่ parallelFor จะใช้สำหรับช่วงขนาด total (ใช้จองบัฟเฟอร์ประจำเธรด)
+ */
+inline size_t parallelChunks(size_t total, size_t minChunk = 1) {
+    if (total == 0) {
+        return 1;
+    }
+    if (minChunk == 0) {
+        minChunk = 1;
+    }
+    size_t chunks = (total + minChunk - 1) / minChunk;
+    size_t threads = availableThreads();
+    return chunks < threads ? chunks : threads;
+}
+
+/**
+ * @brief รันงาน count ชิ้นพร้อมกันโดยแบ่งคอร์ตามที่แต่ละงานใช้ได้ แล้วเรียก fn(task, threads)
+ * @param width width(task) = จำนวนเธรดที่งานใช้ประโยชน์ได้ (งานที่ทำงานแบบลำดับเป็นส่วนใหญ่ควรขอ 1)
+ *
+ * งานเริ่มตามลำดับเมื่อมีคอร์ว่าง และได้คอร์ไม่เกินที่ขอ โดยกันคอร์ไว้หนึ่งคอร์ต่องานที่ยังรออยู่
+ * ภายในงาน parallelFor ใช้เธรดได้ไม่เกินจำนวนที่ได้รับ เธรดที่ทำงานพร้อมกันจึงไม่เกิน availableThreads()
+ * ผู้เรียกควรเรียงงานที่ใช้เวลานานหรือใช้หลายเธรดไว้ก่อน
+ */
+template <typename WidthFn, typename Fn>
+void scheduleTasks(size_t count, WidthFn&& width, Fn&& fn) {
+    if (count == 0) {
+        return;
+    }
+    size_t cores = availableThreads();
+    size_t runners = count < cores ? count : cores;
+    std::mutex lock;
+    std::condition_variable released;
+    size_t freeCores = cores;
+    size_t next = 0;
+    std::vector<std::exception_ptr> errors(count);
+
+    auto run = [&]() {
+        for (;;) {
+            size_t task = 0;
+            size_t granted = 0;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                released.wait(guard, [&] { return next >= count || freeCores > 0; });
+                if (next >= count) {
+                    return;
+                }
+                task = next++;
+                size_t waiting = count - next;
+                size_t reserve = waiting < freeCores - 1 ? waiting : freeCores - 1;
+                size_t wanted = width(task);
+                granted = wanted < 1 ? 1 : wanted;
+                if (granted > freeCores - reserve) {
+                    granted = freeCores - reserve;
+                }
+                freeCores -= granted;
+            }
+            size_t previous = detail::exchangeThreadBudget(granted);
+            try {
+                fn(task, granted);
+            } catch (...) {
+                errors[task] = std::current_exception();
+            }
+            detail::exchangeThreadBudget(previous);
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                freeCores += granted;
+            }
+            released.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(runners - 1);
+    for (size_t r = 1; r < runners; r++) {
+        workers.emplace_back(run);
+    }
+    run();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+} // namespace ai_language
+
+#endif // AI_LANGUAGE_PARALLEL_H
@@ -0,0 +1,113 @@
+#include "../../include/dl/Activation.h"
+#include "../../include/dl/Tensor.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+
+namespace ai_language {
+
+namespace {
+
+void rejectSoftmax(Activation activation) {
+    if (activation == Activation::Softmax) {
+        throw std::invalid_argument("softmax normalizes a whole sample and is applied by the loss, not element-wise");
+    }
+}
+
+} // namespace
+
+std::string activationName(Activation activation) {
+    switch (activation) {
+        case Activation::Linear: return "linear";
+        case Activation::ReLU: return "relu";
+        case Activation::Sigmoid: return "sigmoid";
+        case Activation::Tanh: return "tanh";
+        case Activation::Softmax: return "softmax";
+    }
+    return "unknown";
+}
+
+Activation parseActivation(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (lower == "linear" || lower == "none") return Activation::Linear;
+    if (lower == "relu") return Activation::ReLU;
+    if (lower == "sigmoid") return Activation::Sigmoid;
+    if (lower == "tanh") return Activation::Tanh;
+    if (lower == "softmax") return Activation::Softmax;
+    throw std::invalid_argument("Unknown activation '" + name + "' (use relu, sigmoid, tanh, softmax or linear)");
+}
+
+// แยกลูปตามกรณีเพื่อให้ compiler vectorize แต่ละแบบได้
+void biasActivation(float* row, size_t n, float rowBias, const float* columnBias, Activation activation) {
+    rejectSoftmax(activation);
+    if (columnBias != nullptr) {
+        for (size_t j = 0; j < n; j++) {
+            row[j] += rowBias + columnBias[j];
+        }
+    } else if (rowBias != 0.0f) {
+        for (size_t j = 0; j < n; j++) {
+            row[j] += rowBias;
+        }
+    }
+    switch (activation) {
+        case Activation::ReLU:
+            for (size_t j = 0; j < n; j++) {
+                row[j] = std::max(row[j], 0.0f);
+            }
+            break;
+        case Activation::Sigmoid:
+            for (size_t j = 0; j < n; j++) {
+                row[j] = 1.0f / (1.0f + std::exp(-row[j]));
+            }
+            break;
+        case Activation::Tanh:
+            for (size_t j = 0; j < n; j++) {
+                row[j] = std::tanh(row[j]);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+namespace {
+
+template <typename T>
+void activationBackwardFrom(const T* output, float* grad, size_t n, Activation activation) {
+    rejectSoftmax(activation);
+    switch (activation) {
+        case Activation::ReLU:
+            for (size_t j = 0; j < n; j++) {
+                grad[j] = loadFloat(output[j]) > 0.0f ? grad[j] : 0.0f;
+            }
+            break;
+        case Activation::Sigmoid:
+            for (size_t j = 0; j < n; j++) {
+                float y = loadFloat(output[j]);
+                grad[j] *= y * (1.0f - y);
+            }
+            break;
+        case Activation::Tanh:
+            for (size_t j = 0; j < n; j++) {
+                float y = loadFloat(output[j]);
+                grad[j] *= 1.0f - y * y;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+} // namespace
+
+void activationBackward(const float* output, float* grad, size_t n, Activation activation) {
+    activationBackwardFrom(output, grad, n, activation);
+}
+
+void activationBackward(const uint16_t* output, float* grad, size_t n, Activation activation) {
+    activationBackwardFrom(output, grad, n, activation);
+}
+
+} // namespace ai_language
@@ -0,0 +1,73 @@
+#include "../../include/dl/Arena.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace ai_language {
+
+namespace {
+
+size_t roundUp(size_t bytes) {
+    return (bytes + BumpArena::kAlignment - 1) / BumpArena::kAlignment * BumpArena::kAlignment;
+}
+
+} // namespace
+
+BumpArena::BumpArena(size_t initialBytes) {
+    if (initialBytes > 0) {
+        addBlock(initialBytes);
+    }
+}
+
+void BumpArena::addBlock(size_t bytes) {
+    bytes = roundUp(std::max<size_t>(bytes, kAlignment));
+    void* memory = std::aligned_alloc(kAlignment, bytes);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    blocks.push_back(Block{std::unique_ptr<char, void (*)(void*)>(static_cast<char*>(memory), std::free), bytes});
+    offset = 0;
+    allocations++;
+}
+
+void* BumpArena::allocate(size_t bytes) {
+    bytes = roundUp(std::max<size_t>(bytes, 1));
+    if (blocks.empty() || offset + bytes > blocks.back().size) {
+        // บล็อกใหม่อย่างน้อยเท่าความจุเดิม จำนวนบล็อกในรอบแรกจึงเพิ่มแบบลอการิทึม
+        addBlock(std::max(bytes, capacity()));
+    }
+    void* result = blocks.back().memory.get() + offset;
+    offset += bytes;
+    usedBytes += bytes;
+    peakBytes = std::max(peakBytes, usedBytes);
+    return result;
+}
+
+float* BumpArena::allocateFloats(size_t count, bool zero) {
+    float* values = allocateArray<float>(count);
+    if (zero) {
+        std::memset(values, 0, count * sizeof(float));
+    }
+    return values;
+}
+
+size_t BumpArena::capacity() const {
+    size_t total = 0;
+    for (const Block& block : blocks) {
+        total += block.size;
+    }
+    return total;
+}
+
+void BumpArena::reset() {
+    if (blocks.size() > 1) {
+        // รอบนี้ล้นบล็อกแรก: รวมเป็นก้อนเดียวที่พอสำหรับการใช้สูงสุดที่เคยเห็น
+        size_t total = std::max(peakBytes, capacity());
+        blocks.clear();
+        addBlock(total);
+    }
+    offset = 0;
+    usedBytes = 0;
+}
+
+} // namespace ai_language
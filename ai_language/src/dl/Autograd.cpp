@@ -0,0 +1,355 @@
+#include "../../include/dl/Autograd.h"
+#include "../../include/dl/Gemm.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace ai_language {
+
+namespace {
+
+void addInto(float* target, const float* values, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        target[i] += values[i];
+    }
+}
+
+// ผลรวมตามคอลัมน์ของเมทริกซ์ rows x cols บวกเข้า target (gradient ของ bias ของ dense)
+void addColumnSums(float* target, const float* matrix, size_t rows, size_t cols) {
+    for (size_t i = 0; i < rows; i++) {
+        addInto(target, matrix + i * cols, cols);
+    }
+}
+
+GemmOperand weightOperand(const Parameter& weights, size_t ld, bool transposed) {
+    return weights.value16 != nullptr ? GemmOperand(weights.value16, ld, transposed)
+                                      : GemmOperand(weights.value, ld, transposed);
+}
+
+// แถว first ขึ้นไปของค่า v ในฐานะตัวถูกคูณ
+GemmOperand valueOperand(Var v, size_t first = 0) {
+    return v->data16 != nullptr ? GemmOperand(v->data16 + first * v->features, v->features)
+                                : GemmOperand(v->data + first * v->features, v->features);
+}
+
+float valueAt(Var v, size_t i) {
+    return v->data16 != nullptr ? bf16ToFloat(v->data16[i]) : v->data[i];
+}
+
+void outputActivationBackward(Var y, float* grad, Activation activation) {
+    if (y->data16 != nullptr) {
+        activationBackward(y->data16, grad, y->size(), activation);
+    } else {
+        activationBackward(y->data, grad, y->size(), activation);
+    }
+}
+
+struct DenseOp {
+    Var x, y;
+    Parameter weights, bias;
+    Activation activation;
+
+    void backward(Tape& tape) {
+        if (!y->gradWritten) {
+            return;
+        }
+        const size_t batch = x->batch, in = x->features, units = y->features;
+        float* dz = y->grad;
+        const GemmPrecision precision = tape.precision();
+        outputActivationBackward(y, dz, activation);
+        gemm(units, in, batch, 1.0f, GemmOperand(dz, units, true), valueOperand(x), 1.0f, weights.grad, in,
+             GemmEpilogue(), precision);
+        addColumnSums(bias.grad, dz, batch, units);
+        if (x->requiresGrad) {
+            float* dx = tape.beginGradient(x);
+            gemm(batch, in, units, 1.0f, GemmOperand(dz, units), weightOperand(weights, in, false), 0.0f, dx, in,
+                 GemmEpilogue(), precision);
+            tape.finishGradient(x, dx);
+        }
+    }
+};
+
+struct ConvOp {
+    Var x, y;
+    ConvShape shape;
+    Parameter weights, bias;
+    Activation activation;
+    ConvAlgorithm algorithm;
+
+    void backward(Tape& tape) {
+        if (!y->gradWritten) {
+            return;
+        }
+        BumpArena& arena = tape.arena();
+        outputActivationBackward(y, y->grad, activation);
+        size_t floats = convWorkspaceFloats(shape, algorithm, true, availableThreads());
+        float* workspace = arena.allocateFloats(floats);
+        float* dW = arena.allocateFloats(weights.size);
+        float* db = arena.allocateFloats(bias.size);
+        float* dx = x->requiresGrad ? tape.beginGradient(x) : nullptr;
+        if (x->data16 != nullptr) {
+            convBackward(shape, x->batch, x->data16, weights.value, y->grad, dx, dW, db, workspace, floats, algorithm,
+                         tape.precision());
+        } else {
+            convBackward(shape, x->batch, x->data, weights.value, y->grad, dx, dW, db, workspace, floats, algorithm,
+                         tape.precision());
+        }
+        if (dx != nullptr) {
+            tape.finishGradient(x, dx);
+        }
+        addInto(weights.grad, dW, weights.size);
+        addInto(bias.grad, db, bias.size);
+    }
+};
+
+struct PoolOp {
+    Var x, y;
+    PoolShape shape;
+    const uint8_t* argmax;
+    bool relu;
+
+    void backward(Tape& tape) {
+        if (!y->gradWritten || !x->requiresGrad) {
+            return;
+        }
+        float* dx = tape.beginGradient(x);
+        if (relu && y->data16 != nullptr) {
+            maxPoolBackward(shape, x->batch, y->grad, argmax, y->data16, dx);
+        } else {
+            maxPoolBackward(shape, x->batch, y->grad, argmax, y->data, relu, dx);
+        }
+        tape.finishGradient(x, dx);
+    }
+};
+
+struct DropoutOp {
+    Var x, y;
+    const uint8_t* mask;
+    float scale;
+
+    void backward(Tape& tape) {
+        if (!y->gradWritten || !x->requiresGrad) {
+            return;
+        }
+        float* dx = tape.beginGradient(x);
+        for (size_t i = 0; i < x->size(); i++) {
+            dx[i] = mask[i] ? y->grad[i] * scale : 0.0f;
+        }
+        tape.finishGradient(x, dx);
+    }
+};
+
+} // namespace
+
+Var Tape::constant(const float* data, size_t batch, size_t features) {
+    Value* value = memory->create<Value>();
+    value->data = const_cast<float*>(data);
+    value->batch = batch;
+    value->features = features;
+    return value;
+}
+
+Var Tape::variable(size_t batch, size_t features, bool requiresGrad) {
+    Value* value = memory->create<Value>();
+    value->batch = batch;
+    value->features = features;
+    if (gemmPrecision == GemmPrecision::BFloat16) {
+        value->data16 = memory->allocateArray<uint16_t>(batch * features);
+    } else {
+        value->data = memory->allocateFloats(batch * features);
+    }
+    value->requiresGrad = requiresGrad && active;
+    if (value->requiresGrad) {
+        value->grad = memory->allocateFloats(batch * features);
+    }
+    return value;
+}
+
+float* Tape::accumulator(size_t count) {
+    if (count > scratchFloats) {
+        scratch = memory->allocateFloats(count);
+        scratchFloats = count;
+    }
+    return scratch;
+}
+
+void Tape::backward() {
+    for (NodeBase* node = last; node != nullptr; node = node->previous) {
+        node->run(node, *this);
+    }
+}
+
+void Tape::clear() {
+    last = nullptr;
+    count = 0;
+    scratch = nullptr;
+    scratchFloats = 0;
+}
+
+float* Tape::beginGradient(Var v) {
+    if (!v->requiresGrad) {
+        throw std::logic_error("Writing a gradient for a value that does not require one");
+    }
+    return v->gradWritten ? memory->allocateFloats(v->size()) : v->grad;
+}
+
+void Tape::finishGradient(Var v, float* written) {
+    if (written != v->grad) {
+        addInto(v->grad, written, v->size());
+    }
+    v->gradWritten = true;
+}
+
+size_t denseAccumulatorRows(size_t batch, size_t units) {
+    size_t rows = kAccumulatorBudgetBytes / (std::max<size_t>(units, 1) * sizeof(float));
+    return std::min(batch, std::max<size_t>(rows, kMinAccumulatorRows));
+}
+
+Var dense(Tape& tape, Var x, Parameter weights, Parameter bias, size_t units, Activation activation) {
+    if (weights.size != units * x->features || bias.size != units) {
+        throw std::invalid_argument("dense: expected " + std::to_string(units) + "x" + std::to_string(x->features) +
+                                    " weights and " + std::to_string(units) + " biases");
+    }
+    Var y = tape.variable(x->batch, units, true);
+    GemmEpilogue epilogue;
+    epilogue.columnBias = bias.value;
+    epilogue.activation = activation;
+    const GemmOperand w = weightOperand(weights, x->features, true);
+    if (y->data16 == nullptr) {
+        gemm(x->batch, units, x->features, 1.0f, valueOperand(x), w, 0.0f, y->data, units, epilogue, tape.precision());
+    } else {
+        // ผลลัพธ์ bf16: สะสมเป็น float32 ทีละกลุ่มแถวแล้วปัดลง accumulator จึงเล็กกว่าผลลัพธ์ทั้งก้อน
+        const size_t rows = denseAccumulatorRows(x->batch, units);
+        float* acc = tape.accumulator(rows * units);
+        for (size_t first = 0; first < x->batch; first += rows) {
+            size_t count = std::min(rows, x->batch - first);
+            gemm(count, units, x->features, 1.0f, valueOperand(x, first), w, 0.0f, acc, units, epilogue,
+                 tape.precision());
+            floatToBf16(acc, y->data16 + first * units, count * units);
+        }
+    }
+    if (tape.recording()) {
+        tape.record(DenseOp{x, y, weights, bias, activation});
+    }
+    return y;
+}
+
+Var conv2d(Tape& tape, Var x, const ConvShape& shape, Parameter weights, Parameter bias, Activation activation,
+           ConvAlgorithm algorithm) {
+    if (x->features != shape.channels * shape.height * shape.width || weights.size != shape.filters * shape.patch() ||
+        bias.size != shape.filters) {
+        throw std::invalid_argument("conv2d: input, weights or bias do not match the convolution shape");
+    }
+    Var y = tape.variable(x->batch, shape.filters * shape.outHeight() * shape.outWidth(), true);
+    size_t floats = convWorkspaceFloats(shape, algorithm, false, availableThreads(),
+                                        y->data16 != nullptr ? DType::BFloat16 : DType::Float32);
+    float* workspace = tape.arena().allocateFloats(floats);
+    if (y->data16 == nullptr) {
+        convForward(shape, x->batch, x->data, weights.value, bias.value, y->data, workspace, floats, algorithm,
+                    activation, tape.precision());
+    } else if (x->data16 != nullptr) {
+        convForward(shape, x->batch, x->data16, weights.value, bias.value, y->data16, workspace, floats, algorithm,
+                    activation, tape.precision());
+    } else {
+        convForward(shape, x->batch, x->data, weights.value, bias.value, y->data16, workspace, floats, algorithm,
+                    activation, tape.precision());
+    }
+    if (tape.recording()) {
+        tape.record(ConvOp{x, y, shape, weights, bias, activation, algorithm});
+    }
+    return y;
+}
+
+Var maxPool(Tape& tape, Var x, const PoolShape& shape, bool relu) {
+    if (x->features != shape.channels * shape.height * shape.width) {
+        throw std::invalid_argument("maxPool: input does not match the pool shape");
+    }
+    Var y = tape.variable(x->batch, shape.channels * shape.outHeight() * shape.outWidth(), x->requiresGrad);
+    uint8_t* argmax = tape.recording() ? tape.arena().allocateArray<uint8_t>(y->size()) : nullptr;
+    if (y->data16 == nullptr) {
+        maxPoolForward(shape, x->batch, x->data, y->data, argmax, relu);
+    } else if (x->data16 != nullptr) {
+        maxPoolForward(shape, x->batch, x->data16, y->data16, argmax, relu);
+    } else {
+        maxPoolForward(shape, x->batch, x->data, y->data16, argmax, relu);
+    }
+    if (tape.recording()) {
+        tape.record(PoolOp{x, y, shape, argmax, relu});
+    }
+    return y;
+}
+
+Var dropout(Tape& tape, Var x, float rate, std::mt19937& rng) {
+    if (!tape.recording() || rate <= 0.0f) {
+        return x;
+    }
+    Var y = tape.variable(x->batch, x->features, x->requiresGrad);
+    uint8_t* mask = tape.arena().allocateArray<uint8_t>(x->size());
+    const float scale = 1.0f / (1.0f - rate);
+    const auto threshold = static_cast<std::mt19937::result_type>(rate * 4294967296.0);
+    for (size_t i = 0; i < x->size(); i++) {
+        mask[i] = rng() >= threshold;
+        float value = mask[i] ? valueAt(x, i) * scale : 0.0f;
+        if (y->data16 != nullptr) {
+            y->data16[i] = floatToBf16(value);
+        } else {
+            y->data[i] = value;
+        }
+    }
+    tape.record(DropoutOp{x, y, mask, scale});
+    return y;
+}
+
+float lossAndGradient(Tape& tape, Var output, Activation activation, const float* targets, float* predictions) {
+    const size_t batch = output->batch, width = output->features;
+    float* grad = output->requiresGrad ? tape.beginGradient(output) : nullptr;
+    float* prob = predictions != nullptr ? predictions : tape.arena().allocateFloats(output->size());
+    double total = 0.0;
+    // ผลลัพธ์ bf16 ถูกขยายเป็น float32 ลง prob ก่อน (แต่ละตำแหน่งถูกอ่านก่อนเขียนทับ จึงใช้บัฟเฟอร์เดียวกันได้)
+    const float* logits = output->data;
+    if (output->data16 != nullptr) {
+        bf16ToFloat(output->data16, prob, output->size());
+        logits = prob;
+    }
+    for (size_t i = 0; i < batch; i++) {
+        const float* z = logits + i * width;
+        const float* t = targets + i * width;
+        float* p = prob + i * width;
+        if (activation == Activation::Softmax) {
+            float top = *std::max_element(z, z + width);
+            double sum = 0.0;
+            for (size_t j = 0; j < width; j++) {
+                p[j] = std::exp(z[j] - top);
+                sum += p[j];
+            }
+            for (size_t j = 0; j < width; j++) {
+                p[j] = static_cast<float>(p[j] / sum);
+                total -= t[j] * std::log(std::max(p[j], 1e-12f));
+            }
+        } else if (activation == Activation::Sigmoid) {
+            for (size_t j = 0; j < width; j++) {
+                p[j] = 1.0f / (1.0f + std::exp(-z[j]));
+                total -= t[j] * std::log(std::max(p[j], 1e-12f)) + (1.0f - t[j]) * std::log(std::max(1.0f - p[j], 1e-12f));
+            }
+        } else {
+            for (size_t j = 0; j < width; j++) {
+                p[j] = z[j];
+                total += 0.5 * (z[j] - t[j]) * (z[j] - t[j]);
+            }
+        }
+        if (grad != nullptr) {
+            // softmax + cross entropy และ sigmoid + binary cross entropy ให้อนุพันธ์ต่อ logit รูปเดียวกับ MSE
+            for (size_t j = 0; j < width; j++) {
+                grad[i * width + j] = (p[j] - t[j]) / static_cast<float>(batch);
+            }
+        }
+    }
+    if (grad != nullptr) {
+        tape.finishGradient(output, grad);
+    }
+    return static_cast<float>(total / static_cast<double>(batch));
+}
+
+} // namespace ai_language
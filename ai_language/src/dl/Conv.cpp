@@ -0,0 +1,588 @@
+#include "../../include/dl/Conv.h"
+#include "../../include/dl/Gemm.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+namespace ai_language {
+
+namespace {
+
+void checkShape(const ConvShape& shape) {
+    if (shape.channels == 0 || shape.filters == 0 || shape.kernel == 0 || shape.kernel > shape.height ||
+        shape.kernel > shape.width) {
+        throw std::invalid_argument("Invalid convolution: " + std::to_string(shape.filters) + " filters of " +
+                                    std::to_string(shape.kernel) + "x" + std::to_string(shape.kernel) + " on " +
+                                    std::to_string(shape.channels) + "x" + std::to_string(shape.height) + "x" +
+                                    std::to_string(shape.width));
+    }
+}
+
+// workspace = ส่วนที่ทุกเธรดใช้ร่วมกัน ตามด้วยส่วนของแต่ละเธรดต่อกัน
+struct WorkspaceLayout {
+    size_t shared = 0;
+    size_t perThread = 0;
+
+    size_t total(size_t threads) const { return shared + perThread * std::max<size_t>(threads, 1); }
+
+    size_t workers(size_t floats) const {
+        if (floats < shared + perThread) {
+            throw std::invalid_argument("Convolution workspace of " + std::to_string(floats) +
+                                        " floats is too small (needs " + std::to_string(shared + perThread) + ")");
+        }
+        return (floats - shared) / perThread;
+    }
+};
+
+// งานย่อย count ชิ้นแบ่งให้ไม่เกิน workers เธรด (แต่ละเธรดมีพื้นที่ของตัวเองใน workspace)
+template <typename Fn>
+void forWorkers(size_t count, size_t workers, Fn&& fn) {
+    parallelFor(0, count, fn, (count + workers - 1) / workers);
+}
+
+// ---------------------------------------------------------------- im2col
+
+// Winograd ต้องใช้ทั้ง V (cin x ไทล์) และ M (cout x ไทล์) ของ 16 ตำแหน่ง
+// ปัดลงเป็นพหุคูณของ 16 ไทล์ให้ตรงกับความกว้างของการแปลงและแผง B ของ sgemm
+size_t winogradGroupTiles(size_t cin, size_t cout) {
+    size_t tiles = kConvCacheBudgetBytes / (16 * (cin + cout) * sizeof(float));
+    return std::max<size_t>(tiles / 16 * 16, 16);
+}
+
+WorkspaceLayout im2colLayout(const ConvShape& shape, bool backward, DType output = DType::Float32) {
+    WorkspaceLayout layout;
+    layout.perThread = shape.patch() * im2colTileColumns(shape);
+    if (backward) {
+        layout.perThread += shape.filters * shape.patch() + shape.filters;   // ผลรวมย่อยของ dW และ db
+    } else if (output != DType::Float32) {
+        layout.perThread += shape.filters * im2colTileColumns(shape);       // ไทล์ผลรวมสะสมก่อนปัดลงผลลัพธ์
+    }
+    return layout;
+}
+
+struct WinogradGeometry {
+    size_t outHeight, outWidth, tilesHigh, tilesWide, tiles, groupTiles, groups;
+
+    WinogradGeometry(size_t height, size_t width, size_t pad, size_t cin, size_t cout) {
+        outHeight = height + 2 * pad - 2;
+        outWidth = width + 2 * pad - 2;
+        tilesHigh = (outHeight + 1) / 2;
+        tilesWide = (outWidth + 1) / 2;
+        tiles = tilesHigh * tilesWide;
+        groupTiles = std::min(winogradGroupTiles(cin, cout), tiles);
+        groups = (tiles + groupTiles - 1) / groupTiles;
+    }
+};
+
+WorkspaceLayout winogradLayout(const ConvShape& shape, bool backward) {
+    WorkspaceLayout layout;
+    layout.shared = 16 * shape.filters * shape.channels;   // weight ที่แปลงแล้ว
+    if (!backward) {
+        WinogradGeometry geometry(shape.height, shape.width, 0, shape.channels, shape.filters);
+        layout.perThread = 16 * (shape.channels + shape.filters) * geometry.groupTiles;
+        return layout;
+    }
+    // dX เป็น Winograd บน gradOutput ที่เติมขอบ 2 ส่วน dW ใช้ im2col (ทำทีละรอบ จึงใช้พื้นที่ร่วมกันได้)
+    WinogradGeometry geometry(shape.outHeight(), shape.outWidth(), 2, shape.filters, shape.channels);
+    size_t winograd = 16 * (shape.channels + shape.filters) * geometry.groupTiles;
+    layout.perThread = std::max(winograd, im2colLayout(shape, true).perThread);
+    return layout;
+}
+
+// Winograd เขียนผลลัพธ์จากรีจิสเตอร์ของการแปลงโดยตรง จึงไม่ต้องมีไทล์ผลรวมสะสมสำหรับผลลัพธ์ bf16
+WorkspaceLayout layoutFor(const ConvShape& shape, ConvAlgorithm algorithm, bool backward,
+                          DType output = DType::Float32) {
+    return algorithm == ConvAlgorithm::Winograd ? winogradLayout(shape, backward)
+                                                : im2colLayout(shape, backward, output);
+}
+
+// ผลลัพธ์ float32 ให้ GEMM เขียนลงตรง ๆ ส่วน bf16 ต้องผ่านไทล์ float32 ก่อน (nullptr)
+inline float* directOutput(float* output) { return output; }
+inline float* directOutput(uint16_t*) { return nullptr; }
+
+// คอลัมน์ [t0, t0 + count) ของเมทริกซ์ im2col ขนาด patch x (outH * outW) สำหรับหนึ่งตัวอย่าง
+// input เป็น float32 หรือ bf16 (ขยายเป็น float32 ตรง ๆ ซึ่ง GEMM แบบ bf16 ปัดกลับได้ค่าเดิม)
+template <typename Input>
+void im2colTile(const ConvShape& shape, const Input* input, size_t t0, size_t count, float* cols) {
+    const size_t k = shape.kernel, ow = shape.outWidth();
+    for (size_t c = 0; c < shape.channels; c++) {
+        const Input* plane = input + c * shape.height * shape.width;
+        for (size_t kh = 0; kh < k; kh++) {
+            for (size_t kw = 0; kw < k; kw++) {
+                float* dst = cols + ((c * k + kh) * k + kw) * count;
+                size_t y = t0 / ow, x = t0 % ow;
+                for (size_t j = 0; j < count;) {
+                    size_t run = std::min(ow - x, count - j);
+                    const Input* src = plane + (y + kh) * shape.width + x + kw;
+                    for (size_t i = 0; i < run; i++) {
+                        dst[j + i] = loadFloat(src[i]);
+                    }
+                    j += run;
+                    x = 0;
+                    y++;
+                }
+            }
+        }
+    }
+}
+
+// ย้อนกลับของ im2colTile: บวกค่าแต่ละคอลัมน์กลับเข้าตำแหน่งเดิม (หน้าต่างซ้อนกันจึงต้องบวก)
+void col2imTile(const ConvShape& shape, const float* cols, size_t t0, size_t count, float* gradInput) {
+    const size_t k = shape.kernel, ow = shape.outWidth();
+    for (size_t c = 0; c < shape.channels; c++) {
+        float* plane = gradInput + c * shape.height * shape.width;
+        for (size_t kh = 0; kh < k; kh++) {
+            for (size_t kw = 0; kw < k; kw++) {
+                const float* src = cols + ((c * k + kh) * k + kw) * count;
+                size_t y = t0 / ow, x = t0 % ow;
+                for (size_t j = 0; j < count;) {
+                    size_t run = std::min(ow - x, count - j);
+                    float* dst = plane + (y + kh) * shape.width + x + kw;
+                    for (size_t i = 0; i < run; i++) {
+                        dst[i] += src[j + i];
+                    }
+                    j += run;
+                    x = 0;
+                    y++;
+                }
+            }
+        }
+    }
+}
+
+template <typename Input, typename Output>
+void im2colForward(const ConvShape& shape, size_t batch, const Input* input, const float* weights, const float* bias,
+                   Activation activation, Output* output, float* workspace, size_t workers, GemmPrecision precision) {
+    const size_t positions = shape.outHeight() * shape.outWidth();
+    const size_t tile = im2colTileColumns(shape);
+    const size_t tilesPerSample = (positions + tile - 1) / tile;
+    const size_t perThread = im2colLayout(shape, false, DTypeOf<Output>::value).perThread;
+    const size_t inputSize = shape.channels * shape.height * shape.width;
+    forWorkers(batch * tilesPerSample, workers, [&](size_t begin, size_t end, size_t worker) {
+        float* cols = workspace + worker * perThread;
+        for (size_t task = begin; task < end; task++) {
+            size_t n = task / tilesPerSample;
+            size_t t0 = (task % tilesPerSample) * tile;
+            size_t count = std::min(tile, positions - t0);
+            im2colTile(shape, input + n * inputSize, t0, count, cols);
+            GemmEpilogue epilogue;
+            epilogue.rowBias = bias;
+            epilogue.activation = activation;
+            Output* y = output + n * shape.filters * positions + t0;
+            float* c = directOutput(y);
+            const bool direct = c != nullptr;
+            if (!direct) {
+                c = cols + shape.patch() * tile;
+            }
+            gemm(shape.filters, count, shape.patch(), 1.0f, GemmOperand(weights, shape.patch()), GemmOperand(cols, count),
+                 0.0f, c, direct ? positions : count, epilogue, precision);
+            if (!direct) {
+                for (size_t f = 0; f < shape.filters; f++) {
+                    for (size_t j = 0; j < count; j++) {
+                        storeFloat(y[f * positions + j], c[f * count + j]);
+                    }
+                }
+            }
+        }
+    });
+}
+
+// dW และ db เสมอ และ dX เมื่อ gradInput ไม่เป็น nullptr (dX ของตัวอย่างเดียวกันต้องอยู่ในเธรดเดียว)
+template <typename Input>
+void im2colBackward(const ConvShape& shape, size_t batch, const Input* input, const float* weights,
+                    const float* gradOutput, float* gradInput, float* gradWeights, float* gradBias, float* workspace,
+                    size_t workers, GemmPrecision precision) {
+    const size_t positions = shape.outHeight() * shape.outWidth();
+    const size_t tile = im2colTileColumns(shape);
+    const size_t patch = shape.patch();
+    const size_t perThread = im2colLayout(shape, true).perThread;
+    const size_t inputSize = shape.channels * shape.height * shape.width;
+    const size_t partialSize = shape.filters * patch + shape.filters;
+    workers = std::min(workers, std::max<size_t>(parallelChunks(batch, (batch + workers - 1) / workers), 1));
+    for (size_t w = 0; w < workers; w++) {
+        float* partial = workspace + w * perThread + patch * tile;
+        std::fill(partial, partial + partialSize, 0.0f);
+    }
+    forWorkers(batch, workers, [&](size_t begin, size_t end, size_t worker) {
+        float* cols = workspace + worker * perThread;
+        float* dW = cols + patch * tile;
+        float* db = dW + shape.filters * patch;
+        for (size_t n = begin; n < end; n++) {
+            const Input* x = input + n * inputSize;
+            const float* dY = gradOutput + n * shape.filters * positions;
+            float* dX = gradInput != nullptr ? gradInput + n * inputSize : nullptr;
+            if (dX != nullptr) {
+                std::fill(dX, dX + inputSize, 0.0f);
+            }
+            for (size_t t0 = 0; t0 < positions; t0 += tile) {
+                size_t count = std::min(tile, positions - t0);
+                im2colTile(shape, x, t0, count, cols);
+                gemm(shape.filters, patch, count, 1.0f, GemmOperand(dY + t0, positions), GemmOperand(cols, count, true),
+                     1.0f, dW, patch, GemmEpilogue(), precision);
+                if (dX != nullptr) {
+                    gemm(patch, count, shape.filters, 1.0f, GemmOperand(weights, patch, true),
+                         GemmOperand(dY + t0, positions), 0.0f, cols, count, GemmEpilogue(), precision);
+                    col2imTile(shape, cols, t0, count, dX);
+                }
+            }
+            for (size_t f = 0; f < shape.filters; f++) {
+                const float* row = dY + f * positions;
+                float sum = 0.0f;
+                for (size_t j = 0; j < positions; j++) {
+                    sum += row[j];
+                }
+                db[f] += sum;
+            }
+        }
+    });
+    // รวมผลรวมย่อยของทุกเธรด
+    std::fill(gradWeights, gradWeights + shape.filters * patch, 0.0f);
+    std::fill(gradBias, gradBias + shape.filters, 0.0f);
+    for (size_t w = 0; w < workers; w++) {
+        const float* dW = workspace + w * perThread + patch * tile;
+        const float* db = dW + shape.filters * patch;
+        for (size_t i = 0; i < shape.filters * patch; i++) {
+            gradWeights[i] += dW[i];
+        }
+        for (size_t f = 0; f < shape.filters; f++) {
+            gradBias[f] += db[f];
+        }
+    }
+}
+
+// ---------------------------------------------------------------- Winograd F(2x2, 3x3)
+
+// จำนวนไทล์ที่แปลงพร้อมกัน (หนึ่ง zmm ต่อแถว)
+constexpr size_t kLanes = 16;
+
+// U = G g G^T สำหรับ weight [cout][cin][3][3] เก็บเป็น 16 เมทริกซ์ cout x cin
+// flipped: ใช้ weight[cin][cout] ที่หมุน 180 องศา (สำหรับ dX)
+void winogradWeights(const float* weights, size_t cout, size_t cin, bool flipped, float* transformed) {
+    for (size_t o = 0; o < cout; o++) {
+        for (size_t i = 0; i < cin; i++) {
+            float g[3][3];
+            for (size_t r = 0; r < 3; r++) {
+                for (size_t s = 0; s < 3; s++) {
+                    g[r][s] = flipped ? weights[((i * cout + o) * 3 + 2 - r) * 3 + 2 - s] : weights[((o * cin + i) * 3 + r) * 3 + s];
+                }
+            }
+            float t[4][3];
+            for (size_t s = 0; s < 3; s++) {
+                t[0][s] = g[0][s];
+                t[1][s] = 0.5f * (g[0][s] + g[1][s] + g[2][s]);
+                t[2][s] = 0.5f * (g[0][s] - g[1][s] + g[2][s]);
+                t[3][s] = g[2][s];
+            }
+            for (size_t r = 0; r < 4; r++) {
+                float u[4] = {t[r][0], 0.5f * (t[r][0] + t[r][1] + t[r][2]), 0.5f * (t[r][0] - t[r][1] + t[r][2]), t[r][2]};
+                for (size_t s = 0; s < 4; s++) {
+                    transformed[((r * 4 + s) * cout + o) * cin + i] = u[s];
+                }
+            }
+        }
+    }
+}
+
+// output[n] (cout x outH x outW) = Winograd conv ของ input[n] (cin x height x width ที่เติมศูนย์รอบละ pad)
+template <typename Input, typename Output>
+void winogradRun(size_t batch, const Input* input, size_t cin, size_t height, size_t width, size_t pad,
+                 const float* transformed, size_t cout, const float* bias, Activation activation, Output* output,
+                 float* scratch, size_t perThread, size_t workers, GemmPrecision precision) {
+    const WinogradGeometry geo(height, width, pad, cin, cout);
+    const size_t P = geo.groupTiles;
+    const size_t inputSize = cin * height * width;
+    const size_t outputSize = cout * geo.outHeight * geo.outWidth;
+    forWorkers(batch * geo.groups, workers, [&](size_t begin, size_t end, size_t worker) {
+        float* V = scratch + worker * perThread;
+        float* M = V + 16 * cin * P;
+        for (size_t task = begin; task < end; task++) {
+            size_t n = task / geo.groups;
+            size_t p0 = (task % geo.groups) * P;
+            size_t count = std::min(P, geo.tiles - p0);
+            const Input* x = input + n * inputSize;
+
+            // V = B^T d B ทีละ kLanes ไทล์ เพื่อให้ทุกขั้นเป็นการคำนวณบนแถวยาว kLanes ที่ vectorize ได้
+            for (size_t c = 0; c < cin; c++) {
+                const Input* plane = x + c * height * width;
+                for (size_t q = 0; q < count; q += kLanes) {
+                    size_t lanes = std::min(kLanes, count - q);
+                    float d[16][kLanes] = {};
+                    for (size_t l = 0; l < lanes; l++) {
+                        size_t tile = p0 + q + l;
+                        long top = static_cast<long>(2 * (tile / geo.tilesWide)) - static_cast<long>(pad);
+                        long left = static_cast<long>(2 * (tile % geo.tilesWide)) - static_cast<long>(pad);
+                        bool interior = top >= 0 && left >= 0 && top + 4 <= static_cast<long>(height) &&
+                                        left + 4 <= static_cast<long>(width);
+                        for (long r = 0; r < 4; r++) {
+                            for (long s = 0; s < 4; s++) {
+                                long y = top + r, xx = left + s;
+                                if (interior || (y >= 0 && xx >= 0 && y < static_cast<long>(height) &&
+                                                 xx < static_cast<long>(width))) {
+                                    d[r * 4 + s][l] = loadFloat(plane[y * static_cast<long>(width) + xx]);
+                                }
+                            }
+                        }
+                    }
+                    float t[16][kLanes];
+                    for (size_t s = 0; s < 4; s++) {
+                        for (size_t l = 0; l < kLanes; l++) {
+                            t[s][l] = d[s][l] - d[8 + s][l];
+                            t[4 + s][l] = d[4 + s][l] + d[8 + s][l];
+                            t[8 + s][l] = d[8 + s][l] - d[4 + s][l];
+                            t[12 + s][l] = d[4 + s][l] - d[12 + s][l];
+                        }
+                    }
+                    for (size_t r = 0; r < 4; r++) {
+                        const float* t0 = t[r * 4];
+                        const float* t1 = t[r * 4 + 1];
+                        const float* t2 = t[r * 4 + 2];
+                        const float* t3 = t[r * 4 + 3];
+                        float* v0 = V + ((r * 4 + 0) * cin + c) * P + q;
+                        float* v1 = V + ((r * 4 + 1) * cin + c) * P + q;
+                        float* v2 = V + ((r * 4 + 2) * cin + c) * P + q;
+                        float* v3 = V + ((r * 4 + 3) * cin + c) * P + q;
+                        for (size_t l = 0; l < lanes; l++) {
+                            v0[l] = t0[l] - t2[l];
+                            v1[l] = t1[l] + t2[l];
+                            v2[l] = t2[l] - t1[l];
+                            v3[l] = t1[l] - t3[l];
+                        }
+                    }
+                }
+            }
+            // M[xi] = U[xi] (cout x cin) * V[xi] (cin x ไทล์)
+            for (size_t xi = 0; xi < 16; xi++) {
+                gemm(cout, count, cin, 1.0f, GemmOperand(transformed + xi * cout * cin, cin), GemmOperand(V + xi * cin * P, P),
+                     0.0f, M + xi * cout * P, P, GemmEpilogue(), precision);
+            }
+            // Y = f(A^T m A + bias) ทีละ kLanes ไทล์ แล้วตัดส่วนที่เกินขอบผลลัพธ์
+            Output* y = output + n * outputSize;
+            for (size_t o = 0; o < cout; o++) {
+                float b = bias != nullptr ? bias[o] : 0.0f;
+                for (size_t q = 0; q < count; q += kLanes) {
+                    size_t lanes = std::min(kLanes, count - q);
+                    float t[8][kLanes];
+                    for (size_t s = 0; s < 4; s++) {
+                        const float* m0 = M + ((0 * 4 + s) * cout + o) * P + q;
+                        const float* m1 = M + ((1 * 4 + s) * cout + o) * P + q;
+                        const float* m2 = M + ((2 * 4 + s) * cout + o) * P + q;
+                        const float* m3 = M + ((3 * 4 + s) * cout + o) * P + q;
+                        for (size_t l = 0; l < lanes; l++) {
+                            t[s][l] = m0[l] + m1[l] + m2[l];
+                            t[4 + s][l] = m1[l] - m2[l] - m3[l];
+                        }
+                    }
+                    float out[4][kLanes];
+                    for (size_t r = 0; r < 2; r++) {
+                        for (size_t l = 0; l < lanes; l++) {
+                            out[r * 2][l] = t[r * 4][l] + t[r * 4 + 1][l] + t[r * 4 + 2][l];
+                            out[r * 2 + 1][l] = t[r * 4 + 1][l] - t[r * 4 + 2][l] - t[r * 4 + 3][l];
+                        }
+                    }
+                    for (size_t i = 0; i < 4; i++) {
+                        biasActivation(out[i], lanes, b, nullptr, activation);
+                    }
+                    for (size_t l = 0; l < lanes; l++) {
+                        size_t tile = p0 + q + l;
+                        size_t top = 2 * (tile / geo.tilesWide), left = 2 * (tile % geo.tilesWide);
+                        for (size_t r = 0; r < 2 && top + r < geo.outHeight; r++) {
+                            for (size_t s = 0; s < 2 && left + s < geo.outWidth; s++) {
+                                storeFloat(y[(o * geo.outHeight + top + r) * geo.outWidth + left + s], out[r * 2 + s][l]);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    });
+}
+
+} // namespace
+
+std::string convAlgorithmName(ConvAlgorithm algorithm) {
+    switch (algorithm) {
+        case ConvAlgorithm::Auto: return "auto";
+        case ConvAlgorithm::Im2col: return "im2col";
+        case ConvAlgorithm::Winograd: return "winograd";
+    }
+    return "unknown";
+}
+
+size_t im2colTileColumns(const ConvShape& shape) {
+    size_t positions = shape.outHeight() * shape.outWidth();
+    size_t columns = kConvCacheBudgetBytes / (std::max<size_t>(shape.patch(), 1) * sizeof(float));
+    // อย่างน้อย 32 คอลัมน์ (หนึ่งแผง B ของ microkernel AVX-512) แม้ patch จะใหญ่มาก
+    columns = std::max<size_t>(columns / 32 * 32, 32);
+    return std::min(columns, positions);
+}
+
+bool winogradSupported(const ConvShape& shape) {
+    return shape.kernel == 3;
+}
+
+size_t convWorkspaceFloats(const ConvShape& shape, ConvAlgorithm algorithm, bool backward, size_t threads,
+                           DType output) {
+    checkShape(shape);
+    size_t floats = im2colLayout(shape, backward, output).total(threads);
+    if (algorithm == ConvAlgorithm::Winograd || (algorithm == ConvAlgorithm::Auto && winogradSupported(shape))) {
+        size_t winograd = winogradLayout(shape, backward).total(threads);
+        floats = algorithm == ConvAlgorithm::Winograd ? winograd : std::max(floats, winograd);
+    }
+    return floats;
+}
+
+namespace {
+
+template <typename Input, typename Output>
+void runForward(const ConvShape& shape, size_t batch, const Input* input, const float* weights, const float* bias,
+                Output* output, float* workspace, size_t workspaceFloats, ConvAlgorithm algorithm,
+                Activation activation, GemmPrecision precision) {
+    checkShape(shape);
+    if (activation == Activation::Softmax) {
+        throw std::invalid_argument("Convolution cannot apply softmax");
+    }
+    if (algorithm == ConvAlgorithm::Auto) {
+        algorithm = selectConvAlgorithm(shape).algorithm;
+    }
+    WorkspaceLayout layout = layoutFor(shape, algorithm, false, DTypeOf<Output>::value);
+    size_t workers = layout.workers(workspaceFloats);
+    if (algorithm == ConvAlgorithm::Im2col) {
+        im2colForward(shape, batch, input, weights, bias, activation, output, workspace, workers, precision);
+        return;
+    }
+    if (!winogradSupported(shape)) {
+        throw std::invalid_argument("Winograd convolution needs a 3x3 kernel");
+    }
+    winogradWeights(weights, shape.filters, shape.channels, false, workspace);
+    winogradRun(batch, input, shape.channels, shape.height, shape.width, 0, workspace, shape.filters, bias, activation,
+                output, workspace + layout.shared, layout.perThread, workers, precision);
+}
+
+template <typename Input>
+void runBackward(const ConvShape& shape, size_t batch, const Input* input, const float* weights,
+                 const float* gradOutput, float* gradInput, float* gradWeights, float* gradBias, float* workspace,
+                 size_t workspaceFloats, ConvAlgorithm algorithm, GemmPrecision precision) {
+    checkShape(shape);
+    if (algorithm == ConvAlgorithm::Auto) {
+        algorithm = selectConvAlgorithm(shape).algorithm;
+    }
+    WorkspaceLayout layout = layoutFor(shape, algorithm, true);
+    size_t workers = layout.workers(workspaceFloats);
+    if (algorithm == ConvAlgorithm::Im2col) {
+        im2colBackward(shape, batch, input, weights, gradOutput, gradInput, gradWeights, gradBias, workspace, workers,
+                       precision);
+        return;
+    }
+    if (!winogradSupported(shape)) {
+        throw std::invalid_argument("Winograd convolution needs a 3x3 kernel");
+    }
+    im2colBackward(shape, batch, input, weights, gradOutput, nullptr, gradWeights, gradBias,
+                   workspace + layout.shared, workers, precision);
+    if (gradInput != nullptr) {
+        // dX = gradOutput ที่เติมขอบ 2 คอนโวลูชันกับ weight ที่หมุน 180 องศาและสลับ filter กับ channel
+        winogradWeights(weights, shape.channels, shape.filters, true, workspace);
+        winogradRun(batch, gradOutput, shape.filters, shape.outHeight(), shape.outWidth(), 2, workspace,
+                    shape.channels, nullptr, Activation::Linear, gradInput, workspace + layout.shared,
+                    layout.perThread, workers, precision);
+    }
+}
+
+} // namespace
+
+void convForward(const ConvShape& shape, size_t batch, const float* input, const float* weights, const float* bias,
+                 float* output, float* workspace, size_t workspaceFloats, ConvAlgorithm algorithm,
+                 Activation activation, GemmPrecision precision) {
+    runForward(shape, batch, input, weights, bias, output, workspace, workspaceFloats, algorithm, activation, precision);
+}
+
+void convForward(const ConvShape& shape, size_t batch, const uint16_t* input, const float* weights, const float* bias,
+                 uint16_t* output, float* workspace, size_t workspaceFloats, ConvAlgorithm algorithm,
+                 Activation activation, GemmPrecision precision) {
+    runForward(shape, batch, input, weights, bias, output, workspace, workspaceFloats, algorithm, activation, precision);
+}
+
+void convForward(const ConvShape& shape, size_t batch, const float* input, const float* weights, const float* bias,
+                 uint16_t* output, float* workspace, size_t workspaceFloats, ConvAlgorithm algorithm,
+                 Activation activation, GemmPrecision precision) {
+    runForward(shape, batch, input, weights, bias, output, workspace, workspaceFloats, algorithm, activation, precision);
+}
+
+void convBackward(const ConvShape& shape, size_t batch, const float* input, const float* weights,
+                  const float* gradOutput, float* gradInput, float* gradWeights, float* gradBias, float* workspace,
+                  size_t workspaceFloats, ConvAlgorithm algorithm, GemmPrecision precision) {
+    runBackward(shape, batch, input, weights, gradOutput, gradInput, gradWeights, gradBias, workspace, workspaceFloats,
+                algorithm, precision);
+}
+
+void convBackward(const ConvShape& shape, size_t batch, const uint16_t* input, const float* weights,
+                  const float* gradOutput, float* gradInput, float* gradWeights, float* gradBias, float* workspace,
+                  size_t workspaceFloats, ConvAlgorithm algorithm, GemmPrecision precision) {
+    runBackward(shape, batch, input, weights, gradOutput, gradInput, gradWeights, gradBias, workspace, workspaceFloats,
+                algorithm, precision);
+}
+
+ConvChoice selectConvAlgorithm(const ConvShape& shape) {
+    checkShape(shape);
+    static std::mutex lock;
+    static std::map<std::tuple<size_t, size_t, size_t, size_t, size_t>, ConvChoice> measured;
+    auto key = std::make_tuple(shape.channels, shape.height, shape.width, shape.filters, shape.kernel);
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto found = measured.find(key);
+        if (found != measured.end()) {
+            return found->second;
+        }
+    }
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    auto randomVector = [&](size_t size) {
+        std::vector<float> values(size);
+        for (float& v : values) {
+            v = uniform(rng);
+        }
+        return values;
+    };
+    size_t positions = shape.outHeight() * shape.outWidth();
+    std::vector<float> input = randomVector(shape.channels * shape.height * shape.width);
+    std::vector<float> weights = randomVector(shape.filters * shape.patch());
+    std::vector<float> bias = randomVector(shape.filters);
+    std::vector<float> gradOutput = randomVector(shape.filters * positions);
+    std::vector<float> output(gradOutput.size()), gradInput(input.size()), gradWeights(weights.size()),
+        gradBias(bias.size());
+    size_t threads = availableThreads();
+    std::vector<float> workspace(convWorkspaceFloats(shape, ConvAlgorithm::Auto, true, threads));
+
+    // เวลาที่ดีที่สุดจากสามรอบของ forward + backward หนึ่งตัวอย่าง
+    auto time = [&](ConvAlgorithm algorithm) {
+        double best = 1e30;
+        for (int round = 0; round < 3; round++) {
+            auto start = std::chrono::steady_clock::now();
+            convForward(shape, 1, input.data(), weights.data(), bias.data(), output.data(), workspace.data(),
+                        workspace.size(), algorithm);
+            convBackward(shape, 1, input.data(), weights.data(), gradOutput.data(), gradInput.data(),
+                         gradWeights.data(), gradBias.data(), workspace.data(), workspace.size(), algorithm);
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    };
+    ConvChoice choice;
+    choice.im2colMillis = time(ConvAlgorithm::Im2col);
+    if (winogradSupported(shape)) {
+        choice.winogradMillis = time(ConvAlgorithm::Winograd);
+        if (choice.winogradMillis < choice.im2colMillis) {
+            choice.algorithm = ConvAlgorithm::Winograd;
+        }
+    }
+    std::lock_guard<std::mutex> guard(lock);
+    measured[key] = choice;
+    return choice;
+}
+
+} // namespace ai_language
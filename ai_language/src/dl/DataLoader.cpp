@@ -0,0 +1,174 @@
+#include "../../include/dl/DataLoader.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define AI_LANGUAGE_X86 1
+#endif
+
+namespace ai_language {
+
+namespace {
+
+constexpr size_t kFloatsPerLine = 64 / sizeof(float);
+
+size_t roundToLine(size_t floats) {
+    return (floats + kFloatsPerLine - 1) / kFloatsPerLine * kFloatsPerLine;
+}
+
+// รอแบบไม่ใช้ mutex: pause สั้น ๆ ก่อน (ปกติอีกฝั่งใกล้เสร็จ) แล้ว yield และสุดท้าย sleep
+// เพื่อไม่ให้ผู้ผลิตที่เตรียมไว้ครบแล้วแย่ง CPU จากเธรดที่กำลังคำนวณ
+void backoff(unsigned& attempt) {
+    if (attempt < 64) {
+#ifdef AI_LANGUAGE_X86
+        _mm_pause();
+#endif
+    } else if (attempt < 128) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    attempt++;
+}
+
+} // namespace
+
+FeatureScaling standardization(const float* inputs, size_t samples, size_t features) {
+    FeatureScaling scaling;
+    scaling.offset.assign(features, 0.0f);
+    scaling.scale.assign(features, 1.0f);
+    if (samples == 0) {
+        return scaling;
+    }
+    for (size_t j = 0; j < features; j++) {
+        double mean = 0.0, squares = 0.0;
+        for (size_t i = 0; i < samples; i++) {
+            mean += inputs[i * features + j];
+        }
+        mean /= static_cast<double>(samples);
+        for (size_t i = 0; i < samples; i++) {
+            double d = inputs[i * features + j] - mean;
+            squares += d * d;
+        }
+        double deviation = std::sqrt(squares / static_cast<double>(samples));
+        scaling.offset[j] = static_cast<float>(mean);
+        scaling.scale[j] = deviation > 0.0 ? static_cast<float>(1.0 / deviation) : 1.0f;
+    }
+    return scaling;
+}
+
+DataLoader::DataLoader(const float* inputs, const float* targets, size_t samples, size_t inputSize, size_t outputSize,
+                       const DataLoaderConfig& config, FeatureScaling scaling)
+    : sourceInputs(inputs), sourceTargets(targets), samples(samples), inputSize(inputSize), outputSize(outputSize),
+      settings(config), scaling(std::move(scaling)) {
+    if (samples == 0 || inputSize == 0 || outputSize == 0) {
+        throw std::invalid_argument("DataLoader needs at least one sample with inputs and targets");
+    }
+    if (config.batchSize == 0 || config.epochs == 0) {
+        throw std::invalid_argument("DataLoader batch size and epochs must be positive");
+    }
+    if (!this->scaling.empty() && (this->scaling.offset.size() != inputSize || this->scaling.scale.size() != inputSize)) {
+        throw std::invalid_argument("feature scaling has " + std::to_string(this->scaling.offset.size()) +
+                                    " columns but inputs have " + std::to_string(inputSize));
+    }
+    perEpoch = (samples + config.batchSize - 1) / config.batchSize;
+    total = perEpoch * config.epochs;
+    slots = config.prefetch + 1;
+    inputBuffer = Tensor({slots, roundToLine(config.batchSize * inputSize)});
+    targetBuffer = Tensor({slots, roundToLine(config.batchSize * outputSize)});
+    meta.resize(slots);
+    worker = std::thread(&DataLoader::produce, this);
+}
+
+DataLoader::~DataLoader() {
+    stopping.store(true, std::memory_order_release);
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void DataLoader::produce() {
+    std::vector<size_t> order(samples);
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937 rng(settings.seed);
+    const size_t batchSize = settings.batchSize;
+    const size_t inputSlot = inputBuffer.shape()[1], targetSlot = targetBuffer.shape()[1];
+    float* inputBase = inputBuffer.data<float>();
+    float* targetBase = targetBuffer.data<float>();
+
+    size_t sequence = 0;
+    for (size_t epoch = 0; epoch < settings.epochs; epoch++) {
+        if (settings.shuffle) {
+            std::shuffle(order.begin(), order.end(), rng);
+        }
+        for (size_t index = 0; index < perEpoch; index++, sequence++) {
+            // ช่องว่างเมื่อ batch ที่ผลิตไปแล้วแต่ยังไม่ถูกคืนน้อยกว่าจำนวนช่อง
+            unsigned attempt = 0;
+            while (sequence - consumed.load(std::memory_order_acquire) >= slots) {
+                if (stopping.load(std::memory_order_acquire)) {
+                    return;
+                }
+                backoff(attempt);
+            }
+            const size_t slot = sequence % slots;
+            const size_t first = index * batchSize, count = std::min(batchSize, samples - first);
+            float* in = inputBase + slot * inputSlot;
+            float* out = targetBase + slot * targetSlot;
+            for (size_t i = 0; i < count; i++) {
+                const float* src = sourceInputs + order[first + i] * inputSize;
+                float* dst = in + i * inputSize;
+                if (scaling.empty()) {
+                    std::copy_n(src, inputSize, dst);
+                } else {
+                    const float* offset = scaling.offset.data();
+                    const float* scale = scaling.scale.data();
+                    for (size_t j = 0; j < inputSize; j++) {
+                        dst[j] = (src[j] - offset[j]) * scale[j];
+                    }
+                }
+                std::copy_n(sourceTargets + order[first + i] * outputSize, outputSize, out + i * outputSize);
+            }
+            Batch& batch = meta[slot];
+            batch.inputs = in;
+            batch.targets = out;
+            batch.size = count;
+            batch.epoch = epoch;
+            batch.index = index;
+            produced.store(sequence + 1, std::memory_order_release);
+        }
+    }
+}
+
+bool DataLoader::next(Batch& batch) {
+    if (holding) {
+        consumed.store(delivered, std::memory_order_release);
+        holding = false;
+    }
+    if (delivered == total) {
+        return false;
+    }
+    if (produced.load(std::memory_order_acquire) <= delivered) {
+        auto start = std::chrono::steady_clock::now();
+        unsigned attempt = 0;
+        while (produced.load(std::memory_order_acquire) <= delivered) {
+            backoff(attempt);
+        }
+        if (delivered > 0) {
+            stallCount++;
+            stallTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+    batch = meta[delivered % slots];
+    delivered++;
+    holding = true;
+    return true;
+}
+
+} // namespace ai_language
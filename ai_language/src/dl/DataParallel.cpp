@@ -0,0 +1,143 @@
+#include "../../include/dl/DataParallel.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace ai_language {
+
+namespace {
+
+// ก้อนของ all-reduce: 16 KB ต่อแบบจำลอง ก้อนผลลัพธ์กับก้อนที่อ่านเข้ามาอยู่ใน L1 พร้อมกัน
+constexpr size_t kReduceChunk = 4096;
+// ไม่สร้างเธรดสำหรับ all-reduce ที่น้อยกว่า 16 ก้อน (256 KB ต่อแบบจำลอง)
+constexpr size_t kMinReduceChunks = 16;
+constexpr size_t kEvaluateBatch = 256;
+
+} // namespace
+
+DataParallelTrainer::DataParallelTrainer(const LayerGraph& graph, size_t replicaCount, uint32_t seed,
+                                         GemmPrecision precision) {
+    if (replicaCount == 0) {
+        throw std::invalid_argument("DataParallelTrainer needs at least one replica");
+    }
+    for (size_t r = 0; r < replicaCount; r++) {
+        replicas.push_back(std::make_unique<Network>(graph, seed + static_cast<uint32_t>(r), precision));
+        if (r > 0) {
+            replicas[r]->shareParameters(*replicas.front());
+        }
+    }
+    losses.resize(replicaCount);
+    offsets.resize(replicaCount + 1);
+}
+
+float DataParallelTrainer::step(const float* inputs, const float* targets, size_t batch, Optimizer& optimizer) {
+    if (batch == 0) {
+        throw std::invalid_argument("batch must be positive");
+    }
+    Network& primary = model();
+    const size_t in = primary.inputSize(), out = primary.outputSize();
+    const size_t shards = std::min(batch, replicas.size());
+    for (size_t r = 0; r <= shards; r++) {
+        offsets[r] = batch * r / shards;
+    }
+    parallelFor(0, shards, [&](size_t begin, size_t end, size_t) {
+        for (size_t r = begin; r < end; r++) {
+            size_t first = offsets[r], count = offsets[r + 1] - first;
+            losses[r] = replicas[r]->computeGradients(inputs + first * in, targets + first * out, count);
+        }
+    }, 1);
+
+    allReduce(shards, batch);
+    primary.applyOptimizer(optimizer);
+    float loss = 0.0f;
+    for (size_t r = 0; r < shards; r++) {
+        loss += losses[r] * static_cast<float>(offsets[r + 1] - offsets[r]) / static_cast<float>(batch);
+        replicas[r]->endStep();
+    }
+    return loss;
+}
+
+void DataParallelTrainer::allReduce(size_t shards, size_t batch) {
+    if (shards == 1) {
+        return;
+    }
+    const size_t count = model().parameterCount();
+    float* sum = model().gradients().data<float>();
+    const size_t chunks = (count + kReduceChunk - 1) / kReduceChunk;
+    // gradient ของแต่ละช่วงเป็นค่าเฉลี่ยของช่วงนั้น จึงถ่วงด้วยสัดส่วนตัวอย่างของช่วง
+    auto weight = [&](size_t r) {
+        return static_cast<float>(offsets[r + 1] - offsets[r]) / static_cast<float>(batch);
+    };
+    parallelFor(0, chunks, [&](size_t begin, size_t end, size_t) {
+        for (size_t c = begin; c < end; c++) {
+            const size_t first = c * kReduceChunk, last = std::min(count, first + kReduceChunk);
+            float* target = sum + first;
+            const float w0 = weight(0);
+            for (size_t i = 0; i < last - first; i++) {
+                target[i] *= w0;
+            }
+            for (size_t r = 1; r < shards; r++) {
+                const float* source = replicas[r]->gradients().data<float>() + first;
+                const float wr = weight(r);
+                for (size_t i = 0; i < last - first; i++) {
+                    target[i] += wr * source[i];
+                }
+            }
+        }
+    }, kMinReduceChunks);
+}
+
+float DataParallelTrainer::evaluate(const float* inputs, const float* targets, size_t count, float* predictions) {
+    Network& primary = model();
+    const size_t in = primary.inputSize(), out = primary.outputSize();
+    double total = 0.0;
+    for (size_t first = 0; first < count; first += kEvaluateBatch) {
+        size_t n = std::min(kEvaluateBatch, count - first);
+        float loss = primary.evaluate(inputs + first * in, targets + first * out, n,
+                                      predictions != nullptr ? predictions + first * out : nullptr);
+        total += static_cast<double>(loss) * n;
+    }
+    return count > 0 ? static_cast<float>(total / count) : 0.0f;
+}
+
+std::vector<ScalingPoint> measureScaling(const LayerGraph& graph, const float* inputs, const float* targets, size_t batch,
+                                         size_t threadLimit, size_t steps, GemmPrecision precision) {
+    std::vector<size_t> counts;
+    for (size_t t = 1; t < threadLimit; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(std::max<size_t>(threadLimit, 1));
+
+    const size_t previous = maxThreads();
+    std::vector<ScalingPoint> points;
+    try {
+        for (size_t threads : counts) {
+            setMaxThreads(threads);
+            DataParallelTrainer trainer(graph, threads, 42, precision);
+            OptimizerConfig config;
+            config.kind = OptimizerKind::SGD;
+            config.learningRate = 1e-6f;
+            Optimizer optimizer(config, trainer.model().parameterCount());
+            trainer.step(inputs, targets, batch, optimizer);   // อุ่นเครื่อง: arena, บัฟเฟอร์จัดเรียงของ GEMM
+            auto start = std::chrono::steady_clock::now();
+            for (size_t s = 0; s < steps; s++) {
+                trainer.step(inputs, targets, batch, optimizer);
+            }
+            double millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            ScalingPoint point;
+            point.threads = threads;
+            point.millisPerStep = millis / static_cast<double>(std::max<size_t>(steps, 1));
+            point.speedup = points.empty() ? 1.0 : points.front().millisPerStep / point.millisPerStep;
+            point.efficiency = point.speedup / static_cast<double>(threads);
+            points.push_back(point);
+        }
+    } catch (...) {
+        setMaxThreads(previous);
+        throw;
+    }
+    setMaxThreads(previous);
+    return points;
+}
+
+} // namespace ai_language
@@ -0,0 +1,975 @@
+#include "../../include/dl/Gemm.h"
+#include "../../include/utils/cpu_features.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define AI_LANGUAGE_X86 1
+#endif
+
+namespace ai_language {
+
+namespace {
+
+// คำนวณ C[rows x cols] = alpha * (แผง A) * (แผง B) + beta * C จากแผงที่จัดเรียงแล้ว
+// แผง A: kc ชุดของ mr ค่า (คอลัมน์ต่อคอลัมน์), แผง B: kc ชุดของ nr ค่า (แถวต่อแถว) ส่วนที่เกินขอบเป็นศูนย์
+using MicroKernel = void (*)(size_t kc, const float* a, const float* b, float* c, size_t ldc, float alpha,
+                             float beta, size_t rows, size_t cols);
+
+// ไทล์ที่ไม่เต็มขนาดเขียนผ่านบัฟเฟอร์ชั่วคราว (ค่าใน tile คูณ alpha แล้ว)
+void storeEdge(const float* tile, size_t nr, float* c, size_t ldc, float beta, size_t rows, size_t cols) {
+    for (size_t r = 0; r < rows; r++) {
+        for (size_t j = 0; j < cols; j++) {
+            float value = tile[r * nr + j];
+            c[r * ldc + j] = beta == 0.0f ? value : value + beta * c[r * ldc + j];
+        }
+    }
+}
+
+constexpr size_t kScalarMr = 4;
+constexpr size_t kScalarNr = 8;
+
+void kernelScalar(size_t kc, const float* a, const float* b, float* c, size_t ldc, float alpha, float beta,
+                  size_t rows, size_t cols) {
+    float acc[kScalarMr * kScalarNr] = {};
+    for (size_t p = 0; p < kc; p++) {
+        for (size_t r = 0; r < kScalarMr; r++) {
+            float av = a[r];
+            for (size_t j = 0; j < kScalarNr; j++) {
+                acc[r * kScalarNr + j] += av * b[j];
+            }
+        }
+        a += kScalarMr;
+        b += kScalarNr;
+    }
+    for (float& value : acc) {
+        value *= alpha;
+    }
+    storeEdge(acc, kScalarNr, c, ldc, beta, rows, cols);
+}
+
+#ifdef AI_LANGUAGE_X86
+
+constexpr size_t kAvx2Mr = 6;
+constexpr size_t kAvx2Nr = 16;
+
+__attribute__((target("avx2,fma")))
+void kernelAvx2(size_t kc, const float* a, const float* b, float* c, size_t ldc, float alpha, float beta,
+                size_t rows, size_t cols) {
+    __m256 acc[kAvx2Mr][2];
+#pragma GCC unroll 8
+    for (size_t r = 0; r < kAvx2Mr; r++) {
+        acc[r][0] = _mm256_setzero_ps();
+        acc[r][1] = _mm256_setzero_ps();
+    }
+    for (size_t p = 0; p < kc; p++) {
+        __m256 b0 = _mm256_load_ps(b);
+        __m256 b1 = _mm256_load_ps(b + 8);
+#pragma GCC unroll 8
+        for (size_t r = 0; r < kAvx2Mr; r++) {
+            __m256 av = _mm256_broadcast_ss(a + r);
+            acc[r][0] = _mm256_fmadd_ps(av, b0, acc[r][0]);
+            acc[r][1] = _mm256_fmadd_ps(av, b1, acc[r][1]);
+        }
+        a += kAvx2Mr;
+        b += kAvx2Nr;
+    }
+    __m256 scale = _mm256_set1_ps(alpha);
+    if (rows == kAvx2Mr && cols == kAvx2Nr) {
+        __m256 keep = _mm256_set1_ps(beta);
+#pragma GCC unroll 8
+        for (size_t r = 0; r < kAvx2Mr; r++) {
+            float* row = c + r * ldc;
+            __m256 lo = _mm256_mul_ps(acc[r][0], scale);
+            __m256 hi = _mm256_mul_ps(acc[r][1], scale);
+            if (beta != 0.0f) {
+                lo = _mm256_fmadd_ps(keep, _mm256_loadu_ps(row), lo);
+                hi = _mm256_fmadd_ps(keep, _mm256_loadu_ps(row + 8), hi);
+            }
+            _mm256_storeu_ps(row, lo);
+            _mm256_storeu_ps(row + 8, hi);
+        }
+        return;
+    }
+    alignas(64) float tile[kAvx2Mr * kAvx2Nr];
+    for (size_t r = 0; r < kAvx2Mr; r++) {
+        _mm256_store_ps(tile + r * kAvx2Nr, _mm256_mul_ps(acc[r][0], scale));
+        _mm256_store_ps(tile + r * kAvx2Nr + 8, _mm256_mul_ps(acc[r][1], scale));
+    }
+    storeEdge(tile, kAvx2Nr, c, ldc, beta, rows, cols);
+}
+
+constexpr size_t kAvx512Mr = 14;
+constexpr size_t kAvx512Nr = 32;
+
+// C = alpha * acc + beta * C สำหรับไทล์ 14x32 ของ zmm (ไทล์ที่ไม่เต็มผ่าน storeEdge)
+__attribute__((target("avx512f")))
+inline void storeAvx512(__m512 (&acc)[kAvx512Mr][2], float* c, size_t ldc, float alpha, float beta, size_t rows,
+                        size_t cols) {
+    __m512 scale = _mm512_set1_ps(alpha);
+    if (rows == kAvx512Mr && cols == kAvx512Nr) {
+        __m512 keep = _mm512_set1_ps(beta);
+#pragma GCC unroll 16
+        for (size_t r = 0; r < kAvx512Mr; r++) {
+            float* row = c + r * ldc;
+            __m512 lo = _mm512_mul_ps(acc[r][0], scale);
+            __m512 hi = _mm512_mul_ps(acc[r][1], scale);
+            if (beta != 0.0f) {
+                lo = _mm512_fmadd_ps(keep, _mm512_loadu_ps(row), lo);
+                hi = _mm512_fmadd_ps(keep, _mm512_loadu_ps(row + 16), hi);
+            }
+            _mm512_storeu_ps(row, lo);
+            _mm512_storeu_ps(row + 16, hi);
+        }
+        return;
+    }
+    alignas(64) float tile[kAvx512Mr * kAvx512Nr];
+    for (size_t r = 0; r < kAvx512Mr; r++) {
+        _mm512_store_ps(tile + r * kAvx512Nr, _mm512_mul_ps(acc[r][0], scale));
+        _mm512_store_ps(tile + r * kAvx512Nr + 16, _mm512_mul_ps(acc[r][1], scale));
+    }
+    storeEdge(tile, kAvx512Nr, c, ldc, beta, rows, cols);
+}
+
+__attribute__((target("avx512f")))
+void kernelAvx512(size_t kc, const float* a, const float* b, float* c, size_t ldc, float alpha, float beta,
+                  size_t rows, size_t cols) {
+    __m512 acc[kAvx512Mr][2];
+#pragma GCC unroll 16
+    for (size_t r = 0; r < kAvx512Mr; r++) {
+        acc[r][0] = _mm512_setzero_ps();
+        acc[r][1] = _mm512_setzero_ps();
+    }
+    for (size_t p = 0; p < kc; p++) {
+        __m512 b0 = _mm512_load_ps(b);
+        __m512 b1 = _mm512_load_ps(b + 16);
+#pragma GCC unroll 16
+        for (size_t r = 0; r < kAvx512Mr; r++) {
+            __m512 av = _mm512_set1_ps(a[r]);
+            acc[r][0] = _mm512_fmadd_ps(av, b0, acc[r][0]);
+            acc[r][1] = _mm512_fmadd_ps(av, b1, acc[r][1]);
+        }
+        a += kAvx512Mr;
+        b += kAvx512Nr;
+    }
+    storeAvx512(acc, c, ldc, alpha, beta, rows, cols);
+}
+
+// แผงเป็นคู่ bf16 ตามแนว K: a[p / 2][r][p % 2], b[p / 2][j][p % 2] และ vdpbf16ps บวก a0*b0 + a1*b1
+// ลงตัวสะสม float32 (depth เป็นเลขคู่เสมอ แผงถูกเติมศูนย์ไว้แล้ว)
+__attribute__((target("avx512f,avx512bf16")))
+void kernelAvx512Bf16(size_t depth, const uint16_t* a, const uint16_t* b, float* c, size_t ldc, float alpha,
+                      float beta, size_t rows, size_t cols) {
+    __m512 acc[kAvx512Mr][2];
+#pragma GCC unroll 16
+    for (size_t r = 0; r < kAvx512Mr; r++) {
+        acc[r][0] = _mm512_setzero_ps();
+        acc[r][1] = _mm512_setzero_ps();
+    }
+    const int32_t* pairsA = reinterpret_cast<const int32_t*>(a);
+    for (size_t p = 0; p < depth / 2; p++) {
+        __m512bh b0 = (__m512bh)_mm512_load_si512(b);
+        __m512bh b1 = (__m512bh)_mm512_load_si512(b + 32);
+#pragma GCC unroll 16
+        for (size_t r = 0; r < kAvx512Mr; r++) {
+            __m512bh av = (__m512bh)_mm512_set1_epi32(pairsA[r]);
+            acc[r][0] = _mm512_dpbf16_ps(acc[r][0], av, b0);
+            acc[r][1] = _mm512_dpbf16_ps(acc[r][1], av, b1);
+        }
+        pairsA += kAvx512Mr;
+        b += 2 * kAvx512Nr;
+    }
+    storeAvx512(acc, c, ldc, alpha, beta, rows, cols);
+}
+
+#endif
+
+struct KernelInfo {
+    GemmKernel kind;
+    GemmBlocking blocking;
+    MicroKernel run;
+};
+
+KernelInfo kernelInfo(GemmKernel kind) {
+    if (kind == GemmKernel::Auto) {
+        kind = bestGemmKernel();
+    }
+    if (!gemmKernelSupported(kind)) {
+        throw std::invalid_argument("This CPU does not support the " + gemmKernelName(kind) + " GEMM kernel");
+    }
+    if (kind == GemmKernel::Avx512Bf16 || kind == GemmKernel::AmxBf16) {
+        throw std::invalid_argument("The " + gemmKernelName(kind) + " GEMM kernel needs bf16 precision");
+    }
+    // mc ให้แถบ A ราว 150-200 KB (L2), kc ให้แผง B ของ microkernel อยู่ใน L1, nc ให้แถบ B อยู่ใน L3
+    switch (kind) {
+#ifdef AI_LANGUAGE_X86
+        case GemmKernel::Avx512:
+            return {kind, {kAvx512Mr, kAvx512Nr, kAvx512Mr * 12, 256, 2048}, kernelAvx512};
+        case GemmKernel::Avx2:
+            return {kind, {kAvx2Mr, kAvx2Nr, kAvx2Mr * 24, 256, 2048}, kernelAvx2};
+#endif
+        default:
+            return {GemmKernel::Scalar, {kScalarMr, kScalarNr, kScalarMr * 32, 256, 1024}, kernelScalar};
+    }
+}
+
+// บัฟเฟอร์จัดแนว 64 ไบต์ที่ขยายได้อย่างเดียว ใช้ซ้ำระหว่างการเรียก sgemm บนเธรดเดียวกัน
+template <typename T>
+class PackBuffer {
+public:
+    T* reserve(size_t count) {
+        if (count > capacity) {
+            size_t bytes = (count * sizeof(T) + Tensor::kAlignment - 1) / Tensor::kAlignment * Tensor::kAlignment;
+            void* memory = std::aligned_alloc(Tensor::kAlignment, bytes);
+            if (memory == nullptr) {
+                throw std::bad_alloc();
+            }
+            data.reset(static_cast<T*>(memory));
+            capacity = count;
+        }
+        return data.get();
+    }
+
+private:
+    struct Free {
+        void operator()(T* p) const { std::free(p); }
+    };
+    std::unique_ptr<T, Free> data;
+    size_t capacity = 0;
+};
+
+thread_local PackBuffer<float> packedA;
+thread_local PackBuffer<float> packedB;
+thread_local PackBuffer<uint16_t> packedPairsA;
+thread_local PackBuffer<uint16_t> packedPairsB;
+
+// ค่าหนึ่งค่าของตัวถูกคูณในแผง float32: bf16 ขยายตรง ๆ ส่วน float ถูกปัดเป็น bf16 ก่อนเมื่อ Round
+template <bool Round>
+inline float widen(float value) {
+    return Round ? bf16ToFloat(floatToBf16(value)) : value;
+}
+
+template <bool Round>
+inline float widen(uint16_t value) {
+    return bf16ToFloat(value);
+}
+
+inline uint16_t narrow(float value) { return floatToBf16(value); }
+inline uint16_t narrow(uint16_t value) { return value; }
+
+#ifdef AI_LANGUAGE_X86
+
+// floatToBf16 ของ 16 ค่าพร้อมกัน (ผลตรงกับฟังก์ชันทีละค่ารวมทั้ง NaN) ใน 16 บิตล่างของแต่ละ lane ค่านอก mask เป็นศูนย์
+__attribute__((target("avx512f")))
+inline __m512i bf16Lanes(__mmask16 mask, const float* src) {
+    __m512i bits = _mm512_castps_si512(_mm512_maskz_loadu_ps(mask, src));
+    __m512i rounded = _mm512_add_epi32(bits, _mm512_add_epi32(_mm512_set1_epi32(0x7fff),
+                                       _mm512_and_si512(_mm512_srli_epi32(bits, 16), _mm512_set1_epi32(1))));
+    __mmask16 nan = _mm512_cmpgt_epu32_mask(_mm512_and_si512(bits, _mm512_set1_epi32(0x7fffffff)),
+                                            _mm512_set1_epi32(0x7f800000));
+    rounded = _mm512_mask_or_epi32(rounded, nan, bits, _mm512_set1_epi32(0x400000));
+    return _mm512_srli_epi32(rounded, 16);
+}
+
+// mask เป็นช่วงต้นเสมอ (โหลด 16 บิตแบบมี mask ต้องใช้ AVX512-BW จึงคัดลอกส่วนท้ายเอง)
+__attribute__((target("avx512f")))
+inline __m512i bf16Lanes(__mmask16 mask, const uint16_t* src) {
+    if (mask == 0xffff) {
+        return _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)));
+    }
+    alignas(32) uint16_t part[16] = {};
+    for (unsigned i = 0; i < 16; i++) {
+        if ((mask >> i) & 1u) {
+            part[i] = src[i];
+        }
+    }
+    return _mm512_cvtepu16_epi32(_mm256_load_si256(reinterpret_cast<const __m256i*>(part)));
+}
+
+inline __mmask16 firstLanes(size_t count) {
+    return static_cast<__mmask16>((1u << std::min<size_t>(count, 16)) - 1u);
+}
+
+// ปัด float เป็นค่าที่ bf16 แทนได้พอดี (ผลเท่ากับ widen<true> ทีละค่า)
+__attribute__((target("avx512f")))
+void roundRunAvx512(const float* src, size_t count, float* dst) {
+    for (size_t i = 0; i < count; i += 16) {
+        __mmask16 mask = firstLanes(count - i);
+        _mm512_mask_storeu_ps(dst + i, mask, _mm512_castsi512_ps(_mm512_slli_epi32(bf16Lanes(mask, src + i), 16)));
+    }
+}
+
+__attribute__((target("avx2")))
+void roundRunAvx2(const float* src, size_t count, float* dst) {
+    const __m256i roundBias = _mm256_set1_epi32(0x7fff);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i absMask = _mm256_set1_epi32(0x7fffffff);
+    const __m256i infinity = _mm256_set1_epi32(0x7f800000);
+    const __m256i quiet = _mm256_set1_epi32(0x400000);
+    const __m256i high = _mm256_set1_epi32(static_cast<int>(0xffff0000u));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i bits = _mm256_castps_si256(_mm256_loadu_ps(src + i));
+        __m256i rounded = _mm256_add_epi32(bits, _mm256_add_epi32(roundBias,
+                              _mm256_and_si256(_mm256_srli_epi32(bits, 16), one)));
+        __m256i nan = _mm256_cmpgt_epi32(_mm256_and_si256(bits, absMask), infinity);
+        rounded = _mm256_blendv_epi8(rounded, _mm256_or_si256(bits, quiet), nan);
+        _mm256_storeu_ps(dst + i, _mm256_castsi256_ps(_mm256_and_si256(rounded, high)));
+    }
+    for (; i < count; i++) {
+        dst[i] = widen<true>(src[i]);
+    }
+}
+
+#endif
+
+void roundRun(const float* src, size_t count, float* dst) {
+#ifdef AI_LANGUAGE_X86
+    if (cpuHasAvx512()) {
+        roundRunAvx512(src, count, dst);
+        return;
+    }
+    if (cpuHasAvx2()) {
+        roundRunAvx2(src, count, dst);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = widen<true>(src[i]);
+    }
+}
+
+// ส่วนที่ต่อเนื่องในต้นทางของแผง float32 (แถวของ A^T หรือ B)
+template <bool Round>
+void copyRun(const float* src, size_t count, float* dst) {
+    if (Round) {
+        roundRun(src, count, dst);
+    } else {
+        std::copy(src, src + count, dst);
+    }
+}
+
+template <bool Round>
+void copyRun(const uint16_t* src, size_t count, float* dst) {
+    bf16ToFloat(src, dst, count);
+}
+
+// op(A)[i0.., p0..] -> แผงละ mr แถว: out[panel][p][r]
+// อ่านตามแนวที่ต่อเนื่องในหน่วยความจำต้นทางเสมอ ส่วนการเขียนกระโดดอยู่ภายในแผงที่อยู่ใน L1
+template <bool Round, typename T>
+void packA(const T* a, size_t lda, bool transA, size_t i0, size_t p0, size_t rows, size_t depth, size_t mr,
+           size_t panelBegin, size_t panelEnd, float* out) {
+    for (size_t panel = panelBegin; panel < panelEnd; panel++) {
+        float* dst = out + panel * mr * depth;
+        size_t r0 = panel * mr;
+        size_t valid = std::min(mr, rows - r0);
+        if (transA) {
+            for (size_t p = 0; p < depth; p++) {
+                const T* src = a + (p0 + p) * lda + i0 + r0;
+                copyRun<Round>(src, valid, dst + p * mr);
+                std::fill(dst + p * mr + valid, dst + (p + 1) * mr, 0.0f);
+            }
+            continue;
+        }
+        for (size_t r = 0; r < mr; r++) {
+            if (r < valid) {
+                const T* src = a + (i0 + r0 + r) * lda + p0;
+                for (size_t p = 0; p < depth; p++) {
+                    dst[p * mr + r] = widen<Round>(src[p]);
+                }
+            } else {
+                for (size_t p = 0; p < depth; p++) {
+                    dst[p * mr + r] = 0.0f;
+                }
+            }
+        }
+    }
+}
+
+// op(B)[p0.., j0..] -> แผงละ nr คอลัมน์: out[panel][p][j]
+template <bool Round, typename T>
+void packB(const T* b, size_t ldb, bool transB, size_t p0, size_t j0, size_t depth, size_t cols, size_t nr,
+           size_t panelBegin, size_t panelEnd, float* out) {
+    for (size_t panel = panelBegin; panel < panelEnd; panel++) {
+        float* dst = out + panel * nr * depth;
+        size_t c0 = panel * nr;
+        size_t valid = std::min(nr, cols - c0);
+        if (!transB) {
+            for (size_t p = 0; p < depth; p++) {
+                const T* src = b + (p0 + p) * ldb + j0 + c0;
+                copyRun<Round>(src, valid, dst + p * nr);
+                std::fill(dst + p * nr + valid, dst + (p + 1) * nr, 0.0f);
+            }
+            continue;
+        }
+        for (size_t j = 0; j < nr; j++) {
+            if (j < valid) {
+                const T* src = b + (j0 + c0 + j) * ldb + p0;
+                for (size_t p = 0; p < depth; p++) {
+                    dst[p * nr + j] = widen<Round>(src[p]);
+                }
+            } else {
+                for (size_t p = 0; p < depth; p++) {
+                    dst[p * nr + j] = 0.0f;
+                }
+            }
+        }
+    }
+}
+
+#ifdef AI_LANGUAGE_X86
+
+// คู่ของสองแถว K ที่ติดกันเมื่อแถวต่อเนื่องตามแนว M/N: out[j] = row0[j] | row1[j] << 16 สำหรับ j < width
+// (j >= valid และ row1 ที่เป็น nullptr ของความลึกคี่ได้ศูนย์)
+template <typename T>
+__attribute__((target("avx512f")))
+void pairRows(const T* row0, const T* row1, size_t valid, size_t width, uint32_t* out) {
+    for (size_t j = 0; j < width; j += 16) {
+        __mmask16 load = firstLanes(valid > j ? valid - j : 0);
+        __m512i words = bf16Lanes(load, row0 + j);
+        if (row1 != nullptr) {
+            words = _mm512_or_si512(words, _mm512_slli_epi32(bf16Lanes(load, row1 + j), 16));
+        }
+        _mm512_mask_storeu_epi32(out + j, firstLanes(width - j), words);
+    }
+}
+
+// คู่ของค่าที่ติดกันในแถวที่ต่อเนื่องตามแนว K: out[q * stride] = src[2q] | src[2q + 1] << 16 (ความลึกคี่เติมศูนย์)
+__attribute__((target("avx512f")))
+void pairRun(const float* src, size_t depth, size_t stride, uint32_t* out) {
+    const __m512i index = _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+                                             _mm512_set1_epi32(static_cast<int>(stride)));
+    for (size_t p = 0; p < depth; p += 32) {
+        size_t count = std::min<size_t>(32, depth - p);
+        // vpmovdw เรียง bf16 กลับเป็นลำดับต่อเนื่อง สองค่าที่ติดกันจึงเป็นหนึ่งคู่ในคำ 32 บิต
+        __m256i low = _mm512_cvtepi32_epi16(bf16Lanes(firstLanes(count), src + p));
+        __m256i high = _mm512_cvtepi32_epi16(bf16Lanes(firstLanes(count > 16 ? count - 16 : 0), src + p + 16));
+        __m512i words = _mm512_inserti64x4(_mm512_castsi256_si512(low), high, 1);
+        _mm512_mask_i32scatter_epi32(out + (p / 2) * stride, firstLanes((count + 1) / 2), index, words, 4);
+    }
+}
+
+// ค่าเป็น bf16 อยู่แล้ว สองค่าที่ติดกันในหน่วยความจำคือคู่ที่ต้องการพอดี
+void pairRun(const uint16_t* src, size_t depth, size_t stride, uint32_t* out) {
+    size_t q = 0;
+    for (; 2 * q + 1 < depth; q++) {
+        std::memcpy(out + q * stride, src + 2 * q, sizeof(uint32_t));
+    }
+    if (depth & 1) {
+        out[q * stride] = src[depth - 1];
+    }
+}
+
+// แผงคู่ bf16 ของ kernelAvx512Bf16: out[panel][p / 2][r][p % 2] โดยความลึกถูกปัดขึ้นเป็นเลขคู่และเติมศูนย์
+template <typename T>
+void packPairsA(const T* a, size_t lda, bool transA, size_t i0, size_t p0, size_t rows, size_t depth, size_t mr,
+                size_t panelBegin, size_t panelEnd, uint16_t* out) {
+    const size_t padded = depth + (depth & 1);
+    for (size_t panel = panelBegin; panel < panelEnd; panel++) {
+        uint32_t* dst = reinterpret_cast<uint32_t*>(out + panel * mr * padded);
+        size_t r0 = panel * mr;
+        size_t valid = std::min(mr, rows - r0);
+        if (transA) {
+            for (size_t p = 0; p < depth; p += 2) {
+                const T* row = a + (p0 + p) * lda + i0 + r0;
+                pairRows(row, p + 1 < depth ? row + lda : nullptr, valid, mr, dst + (p / 2) * mr);
+            }
+            continue;
+        }
+        if (valid < mr) {
+            std::fill(dst, dst + mr * padded / 2, 0u);
+        }
+        for (size_t r = 0; r < valid; r++) {
+            pairRun(a + (i0 + r0 + r) * lda + p0, depth, mr, dst + r);
+        }
+    }
+}
+
+// out[panel][p / 2][j][p % 2]: หนึ่งคู่ของแถว K ต่อ nr คอลัมน์คือ zmm สองตัว (และคือรูปแบบ VNNI ของไทล์ B ใน AMX)
+// ความลึกถูกปัดขึ้นเป็นพหุคูณของ step และเติมศูนย์
+template <typename T>
+void packPairsB(const T* b, size_t ldb, bool transB, size_t p0, size_t j0, size_t depth, size_t cols, size_t nr,
+                size_t step, size_t panelBegin, size_t panelEnd, uint16_t* out) {
+    const size_t padded = (depth + step - 1) / step * step;
+    const size_t pairs = (depth + 1) / 2;
+    for (size_t panel = panelBegin; panel < panelEnd; panel++) {
+        uint32_t* dst = reinterpret_cast<uint32_t*>(out + panel * nr * padded);
+        size_t c0 = panel * nr;
+        size_t valid = std::min(nr, cols - c0);
+        std::fill(dst + pairs * nr, dst + padded / 2 * nr, 0u);
+        if (!transB) {
+            for (size_t p = 0; p < depth; p += 2) {
+                const T* row = b + (p0 + p) * ldb + j0 + c0;
+                pairRows(row, p + 1 < depth ? row + ldb : nullptr, valid, nr, dst + (p / 2) * nr);
+            }
+            continue;
+        }
+        if (valid < nr) {
+            std::fill(dst, dst + pairs * nr, 0u);
+        }
+        for (size_t j = 0; j < valid; j++) {
+            pairRun(b + (j0 + c0 + j) * ldb + p0, depth, nr, dst + j);
+        }
+    }
+}
+
+constexpr size_t kAmxMr = 32;
+constexpr size_t kAmxNr = 32;
+constexpr size_t kAmxK = 32;   ///< ความลึกต่อการคูณไทล์หนึ่งครั้ง (แถวละ 64 ไบต์ของ bf16)
+
+// 32 ค่าต่อเนื่องเป็น bf16 ต่อเนื่อง (ตำแหน่งที่ count ไม่ถึงเป็นศูนย์)
+__attribute__((target("avx512f")))
+void bf16Block(const float* src, size_t count, uint16_t* out) {
+    __m256i low = _mm512_cvtepi32_epi16(bf16Lanes(firstLanes(count), src));
+    __m256i high = _mm512_cvtepi32_epi16(bf16Lanes(firstLanes(count > 16 ? count - 16 : 0), src + 16));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), low);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 16), high);
+}
+
+void bf16Block(const uint16_t* src, size_t count, uint16_t* out) {
+    std::copy(src, src + count, out);
+    std::fill(out + count, out + kAmxK, uint16_t(0));
+}
+
+// แผง A ของ kernelAmxBf16: out[panel][p / 32][r][p % 32] แต่ละบล็อก 32 x 32 คือไทล์ A สองไทล์ (16 แถว แถวละ 64 ไบต์)
+template <typename T>
+void packRowsA(const T* a, size_t lda, bool transA, size_t i0, size_t p0, size_t rows, size_t depth, size_t mr,
+               size_t panelBegin, size_t panelEnd, uint16_t* out) {
+    const size_t padded = (depth + kAmxK - 1) / kAmxK * kAmxK;
+    for (size_t panel = panelBegin; panel < panelEnd; panel++) {
+        uint16_t* dst = out + panel * mr * padded;
+        size_t r0 = panel * mr;
+        size_t valid = std::min(mr, rows - r0);
+        if (transA) {
+            // ต้นทางต่อเนื่องตามแนว M จึงกระจายทีละค่า (op(A) แบบนี้ในการเทรนมีแค่ dz^T และ W^T ที่เล็ก)
+            std::fill(dst, dst + mr * padded, uint16_t(0));
+            for (size_t p = 0; p < depth; p++) {
+                const T* src = a + (p0 + p) * lda + i0 + r0;
+                uint16_t* column = dst + (p / kAmxK) * mr * kAmxK + p % kAmxK;
+                for (size_t r = 0; r < valid; r++) {
+                    column[r * kAmxK] = narrow(src[r]);
+                }
+            }
+            continue;
+        }
+        for (size_t r = 0; r < mr; r++) {
+            for (size_t p = 0; p < padded; p += kAmxK) {
+                uint16_t* block = dst + (p / kAmxK) * mr * kAmxK + r * kAmxK;
+                if (r < valid) {
+                    bf16Block(a + (i0 + r0 + r) * lda + p0 + p, std::min(kAmxK, depth - p), block);
+                } else {
+                    std::fill(block, block + kAmxK, uint16_t(0));
+                }
+            }
+        }
+    }
+}
+
+struct alignas(64) TileConfig {
+    uint8_t palette = 1;
+    uint8_t startRow = 0;
+    uint8_t reserved[14] = {};
+    uint16_t bytesPerRow[16] = {};
+    uint8_t rows[16] = {};
+};
+
+// ไทล์ 0-3: C 32x32 เป็น 2x2 ไทล์ของ 16x16 float, 4-5: A ครึ่งบนและล่าง, 6-7: B ครึ่งซ้ายและขวา (ทุกไทล์ 16 แถว x 64 ไบต์)
+// config อยู่กับเธรด จึงโหลดครั้งเดียวต่อเธรด
+__attribute__((target("amx-tile")))
+void configureTiles() {
+    thread_local bool configured = false;
+    if (!configured) {
+        TileConfig config;
+        for (int t = 0; t < 8; t++) {
+            config.bytesPerRow[t] = 64;
+            config.rows[t] = 16;
+        }
+        _tile_loadconfig(&config);
+        configured = true;
+    }
+}
+
+__attribute__((target("avx512f,amx-tile,amx-bf16")))
+void kernelAmxBf16(size_t depth, const uint16_t* a, const uint16_t* b, float* c, size_t ldc, float alpha, float beta,
+                   size_t rows, size_t cols) {
+    configureTiles();
+    // ไทล์เต็มที่ alpha เป็น 1 สะสมลง C โดยตรง (beta 1 โหลด C เป็นค่าเริ่มต้นของตัวสะสม) ไม่ต้องผ่านบัฟเฟอร์
+    const bool direct = rows == kAmxMr && cols == kAmxNr && alpha == 1.0f && (beta == 0.0f || beta == 1.0f);
+    const size_t rowBytes = ldc * sizeof(float);
+    if (direct && beta == 1.0f) {
+        _tile_loadd(0, c, rowBytes);
+        _tile_loadd(1, c + 16, rowBytes);
+        _tile_loadd(2, c + 16 * ldc, rowBytes);
+        _tile_loadd(3, c + 16 * ldc + 16, rowBytes);
+    } else {
+        _tile_zero(0);
+        _tile_zero(1);
+        _tile_zero(2);
+        _tile_zero(3);
+    }
+    for (size_t p = 0; p < depth; p += kAmxK) {
+        _tile_loadd(4, a, kAmxK * sizeof(uint16_t));
+        _tile_loadd(5, a + 16 * kAmxK, kAmxK * sizeof(uint16_t));
+        _tile_loadd(6, b, 2 * kAmxNr * sizeof(uint16_t));
+        _tile_loadd(7, b + 32, 2 * kAmxNr * sizeof(uint16_t));
+        _tile_dpbf16ps(0, 4, 6);
+        _tile_dpbf16ps(1, 4, 7);
+        _tile_dpbf16ps(2, 5, 6);
+        _tile_dpbf16ps(3, 5, 7);
+        a += kAmxMr * kAmxK;
+        b += kAmxK * kAmxNr;
+    }
+    if (direct) {
+        _tile_stored(0, c, rowBytes);
+        _tile_stored(1, c + 16, rowBytes);
+        _tile_stored(2, c + 16 * ldc, rowBytes);
+        _tile_stored(3, c + 16 * ldc + 16, rowBytes);
+        return;
+    }
+    alignas(64) float tile[kAmxMr * kAmxNr];
+    _tile_stored(0, tile, kAmxNr * sizeof(float));
+    _tile_stored(1, tile + 16, kAmxNr * sizeof(float));
+    _tile_stored(2, tile + 16 * kAmxNr, kAmxNr * sizeof(float));
+    _tile_stored(3, tile + 16 * kAmxNr + 16, kAmxNr * sizeof(float));
+
+    const __m512 scale = _mm512_set1_ps(alpha), keep = _mm512_set1_ps(beta);
+    const __mmask16 left = firstLanes(cols), right = firstLanes(cols > 16 ? cols - 16 : 0);
+    for (size_t r = 0; r < rows; r++) {
+        float* row = c + r * ldc;
+        __m512 lo = _mm512_mul_ps(_mm512_load_ps(tile + r * kAmxNr), scale);
+        __m512 hi = _mm512_mul_ps(_mm512_load_ps(tile + r * kAmxNr + 16), scale);
+        if (beta != 0.0f) {
+            lo = _mm512_fmadd_ps(keep, _mm512_maskz_loadu_ps(left, row), lo);
+            hi = _mm512_fmadd_ps(keep, _mm512_maskz_loadu_ps(right, row + 16), hi);
+        }
+        _mm512_mask_storeu_ps(row, left, lo);
+        _mm512_mask_storeu_ps(row + 16, right, hi);
+    }
+}
+
+// AMX: แผง B ลึก 512 (32 KB) อยู่ใน L1 ส่วนบล็อก A 256 x 512 (256 KB) อยู่ใน L2
+// AVX512-BF16: kc เป็นสองเท่าของ float32 เพราะแผงคู่ bf16 ใช้ไบต์ต่อความลึกครึ่งหนึ่ง
+GemmBlocking bf16Blocking(GemmKernel kind) {
+    return kind == GemmKernel::AmxBf16 ? GemmBlocking{kAmxMr, kAmxNr, kAmxMr * 8, 512, 2048}
+                                       : GemmBlocking{kAvx512Mr, kAvx512Nr, kAvx512Mr * 12, 512, 2048};
+}
+
+#endif
+
+void scaleRows(float* c, size_t ldc, size_t m, size_t n, float beta) {
+    for (size_t i = 0; i < m; i++) {
+        float* row = c + i * ldc;
+        if (beta == 0.0f) {
+            std::fill(row, row + n, 0.0f);
+        } else if (beta != 1.0f) {
+            for (size_t j = 0; j < n; j++) {
+                row[j] *= beta;
+            }
+        }
+    }
+}
+
+// ตัวขับแบบ Goto ที่ใช้ร่วมกันทุกชนิดแผง: Packed คือ float หรือคู่ bf16
+// packA(i0, p0, rows, depth, panelBegin, panelEnd, out), packB(p0, j0, depth, cols, panelBegin, panelEnd, out)
+// และ kernel(depth, แผง A, แผง B, ...) โดยแผงลึก depth ที่ปัดขึ้นเป็นพหุคูณของ depthStep
+template <typename Packed, typename PackAFn, typename PackBFn, typename KernelFn>
+void runBlocked(size_t m, size_t n, size_t k, float alpha, float beta, float* c, size_t ldc,
+                const GemmEpilogue& epilogue, const GemmBlocking& blk, size_t depthStep, PackBuffer<Packed>& sharedA,
+                PackBuffer<Packed>& sharedB, PackAFn packPanelsA, PackBFn packPanelsB, KernelFn kernel) {
+    const bool finish = !epilogue.empty();
+    // ไทล์ rows x cols ที่มุม (i, j) ของ C
+    auto applyEpilogue = [&](size_t i, size_t j, size_t rows, size_t cols) {
+        for (size_t r = 0; r < rows; r++) {
+            biasActivation(c + (i + r) * ldc + j, cols, epilogue.rowBias != nullptr ? epilogue.rowBias[i + r] : 0.0f,
+                           epilogue.columnBias != nullptr ? epilogue.columnBias + j : nullptr, epilogue.activation);
+        }
+    };
+    const size_t threads = availableThreads();
+    const size_t mBlocks = (m + blk.mc - 1) / blk.mc;
+
+    // คำนวณบล็อก A ที่จัดเรียงแล้ว (mcur แถวเริ่มที่ i0) กับแผง B ช่วง [panelBegin, panelEnd)
+    // lastK: บล็อก K สุดท้าย จึงทำ epilogue ต่อทันทีบนไทล์ที่เพิ่งเขียน
+    auto multiply = [&](const Packed* ap, const Packed* bp, size_t i0, size_t mcur, size_t jc, size_t ncur,
+                        size_t depth, float betaNow, bool lastK, size_t panelBegin, size_t panelEnd) {
+        size_t rowPanels = (mcur + blk.mr - 1) / blk.mr;
+        for (size_t jr = panelBegin; jr < panelEnd; jr++) {
+            size_t cols = std::min(blk.nr, ncur - jr * blk.nr);
+            const Packed* bPanel = bp + jr * blk.nr * depth;
+            for (size_t ir = 0; ir < rowPanels; ir++) {
+                size_t rows = std::min(blk.mr, mcur - ir * blk.mr);
+                kernel(depth, ap + ir * blk.mr * depth, bPanel, c + (i0 + ir * blk.mr) * ldc + jc + jr * blk.nr, ldc,
+                       alpha, betaNow, rows, cols);
+                if (lastK && finish) {
+                    applyEpilogue(i0 + ir * blk.mr, jc + jr * blk.nr, rows, cols);
+                }
+            }
+        }
+    };
+
+    for (size_t jc = 0; jc < n; jc += blk.nc) {
+        size_t ncur = std::min(blk.nc, n - jc);
+        size_t colPanels = (ncur + blk.nr - 1) / blk.nr;
+        for (size_t pc = 0; pc < k; pc += blk.kc) {
+            size_t kcur = std::min(blk.kc, k - pc);
+            size_t depth = (kcur + depthStep - 1) / depthStep * depthStep;
+            float betaNow = pc == 0 ? beta : 1.0f;
+            bool lastK = pc + kcur == k;
+            Packed* bp = sharedB.reserve(colPanels * blk.nr * depth);
+            parallelFor(0, colPanels, [&](size_t begin, size_t end, size_t) {
+                packPanelsB(pc, jc, kcur, ncur, begin, end, bp);
+            }, 8);
+
+            if (mBlocks >= threads) {
+                // บล็อกของ M พอสำหรับทุกเธรด: แต่ละเธรดจัดเรียง A ของตัวเองแล้วคำนวณทั้งแถบ
+                parallelFor(0, mBlocks, [&](size_t begin, size_t end, size_t worker) {
+                    PackBuffer<Packed> local;
+                    Packed* ap = (worker == 0 ? sharedA : local).reserve(blk.mc * depth);
+                    for (size_t block = begin; block < end; block++) {
+                        size_t i0 = block * blk.mc;
+                        size_t mcur = std::min(blk.mc, m - i0);
+                        packPanelsA(i0, pc, mcur, kcur, 0, (mcur + blk.mr - 1) / blk.mr, ap);
+                        multiply(ap, bp, i0, mcur, jc, ncur, depth, betaNow, lastK, 0, colPanels);
+                    }
+                });
+                continue;
+            }
+            // M น้อย (เช่น batch ของ dense layer): ใช้บล็อก A ร่วมกันและแบ่งไทล์ตาม N
+            Packed* ap = sharedA.reserve(blk.mc * depth);
+            for (size_t i0 = 0; i0 < m; i0 += blk.mc) {
+                size_t mcur = std::min(blk.mc, m - i0);
+                size_t rowPanels = (mcur + blk.mr - 1) / blk.mr;
+                parallelFor(0, rowPanels, [&](size_t begin, size_t end, size_t) {
+                    packPanelsA(i0, pc, mcur, kcur, begin, end, ap);
+                }, 4);
+                parallelFor(0, colPanels, [&](size_t begin, size_t end, size_t) {
+                    multiply(ap, bp, i0, mcur, jc, ncur, depth, betaNow, lastK, begin, end);
+                }, 2);
+            }
+        }
+    }
+}
+
+// เรียก fn ด้วยตัวชี้ชนิดจริงของตัวถูกคูณ (const float* หรือ const uint16_t*)
+template <typename Fn>
+void withOperand(const GemmOperand& operand, Fn&& fn) {
+    if (operand.dtype == DType::BFloat16) {
+        fn(static_cast<const uint16_t*>(operand.data));
+    } else {
+        fn(static_cast<const float*>(operand.data));
+    }
+}
+
+template <bool Round>
+void runFloatPanels(size_t m, size_t n, size_t k, float alpha, const GemmOperand& a, const GemmOperand& b, float beta,
+                    float* c, size_t ldc, const GemmEpilogue& epilogue, const KernelInfo& info) {
+    const GemmBlocking& blk = info.blocking;
+    withOperand(a, [&](auto pa) {
+        withOperand(b, [&](auto pb) {
+            runBlocked<float>(m, n, k, alpha, beta, c, ldc, epilogue, blk, 1, packedA, packedB,
+                [&](size_t i0, size_t p0, size_t rows, size_t depth, size_t begin, size_t end, float* out) {
+                    packA<Round>(pa, a.ld, a.transposed, i0, p0, rows, depth, blk.mr, begin, end, out);
+                },
+                [&](size_t p0, size_t j0, size_t depth, size_t cols, size_t begin, size_t end, float* out) {
+                    packB<Round>(pb, b.ld, b.transposed, p0, j0, depth, cols, blk.nr, begin, end, out);
+                },
+                info.run);
+        });
+    });
+}
+
+} // namespace
+
+std::string gemmKernelName(GemmKernel kernel) {
+    switch (kernel) {
+        case GemmKernel::Auto: return "auto";
+        case GemmKernel::Scalar: return "scalar";
+        case GemmKernel::Avx2: return "AVX2";
+        case GemmKernel::Avx512: return "AVX-512";
+        case GemmKernel::Avx512Bf16: return "AVX512-BF16";
+        case GemmKernel::AmxBf16: return "AMX-BF16";
+    }
+    return "unknown";
+}
+
+std::string gemmPrecisionName(GemmPrecision precision) {
+    return precision == GemmPrecision::BFloat16 ? "bf16" : "fp32";
+}
+
+GemmPrecision parseGemmPrecision(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (lower == "fp32" || lower == "float32") return GemmPrecision::Float32;
+    if (lower == "bf16" || lower == "bfloat16") return GemmPrecision::BFloat16;
+    throw std::invalid_argument("Unknown precision '" + name + "' (use fp32 or bf16)");
+}
+
+bool gemmKernelSupported(GemmKernel kernel) {
+    switch (kernel) {
+        case GemmKernel::Auto:
+        case GemmKernel::Scalar:
+            return true;
+#ifdef AI_LANGUAGE_X86
+        case GemmKernel::Avx2:
+            return cpuHasAvx2();
+        case GemmKernel::Avx512:
+            return cpuHasAvx512();
+        case GemmKernel::Avx512Bf16:
+            return cpuHasAvx512Bf16();
+        case GemmKernel::AmxBf16:
+            return cpuHasAmxBf16();
+#endif
+        default:
+            return false;
+    }
+}
+
+GemmKernel bestGemmKernel() {
+    static const GemmKernel best = gemmKernelSupported(GemmKernel::Avx512) ? GemmKernel::Avx512
+                                 : gemmKernelSupported(GemmKernel::Avx2) ? GemmKernel::Avx2
+                                 : GemmKernel::Scalar;
+    return best;
+}
+
+GemmKernel bestBf16GemmKernel() {
+    static const GemmKernel best = gemmKernelSupported(GemmKernel::AmxBf16) ? GemmKernel::AmxBf16
+                                 : gemmKernelSupported(GemmKernel::Avx512Bf16) ? GemmKernel::Avx512Bf16
+                                 : bestGemmKernel();
+    return best;
+}
+
+GemmBlocking gemmBlocking(GemmKernel kernel) {
+#ifdef AI_LANGUAGE_X86
+    if ((kernel == GemmKernel::AmxBf16 || kernel == GemmKernel::Avx512Bf16) && gemmKernelSupported(kernel)) {
+        return bf16Blocking(kernel);
+    }
+#endif
+    return kernelInfo(kernel).blocking;
+}
+
+void sgemm(bool transA, bool transB, size_t m, size_t n, size_t k, float alpha, const float* a, size_t lda,
+           const float* b, size_t ldb, float beta, float* c, size_t ldc, GemmKernel kernel) {
+    sgemm(transA, transB, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc, GemmEpilogue{}, kernel);
+}
+
+void sgemm(bool transA, bool transB, size_t m, size_t n, size_t k, float alpha, const float* a, size_t lda,
+           const float* b, size_t ldb, float beta, float* c, size_t ldc, const GemmEpilogue& epilogue,
+           GemmKernel kernel) {
+    gemm(m, n, k, alpha, GemmOperand(a, lda, transA), GemmOperand(b, ldb, transB), beta, c, ldc, epilogue,
+         GemmPrecision::Float32, kernel);
+}
+
+void gemm(size_t m, size_t n, size_t k, float alpha, const GemmOperand& a, const GemmOperand& b, float beta, float* c,
+          size_t ldc, const GemmEpilogue& epilogue, GemmPrecision precision, GemmKernel kernel) {
+    if (a.ld < (a.transposed ? m : k) || b.ld < (b.transposed ? k : n) || ldc < n) {
+        throw std::invalid_argument("sgemm leading dimension is smaller than the matrix width");
+    }
+    if ((a.dtype != DType::Float32 && a.dtype != DType::BFloat16) ||
+        (b.dtype != DType::Float32 && b.dtype != DType::BFloat16)) {
+        throw std::invalid_argument("gemm operands must be float32 or bf16");
+    }
+    if (epilogue.activation == Activation::Softmax) {
+        throw std::invalid_argument("sgemm epilogue cannot apply softmax");
+    }
+    if (m == 0 || n == 0) {
+        return;
+    }
+    if (k == 0 || alpha == 0.0f) {
+        scaleRows(c, ldc, m, n, beta);
+        for (size_t i = 0; i < m && !epilogue.empty(); i++) {
+            biasActivation(c + i * ldc, n, epilogue.rowBias != nullptr ? epilogue.rowBias[i] : 0.0f,
+                           epilogue.columnBias, epilogue.activation);
+        }
+        return;
+    }
+
+    if (precision == GemmPrecision::Float32) {
+        runFloatPanels<false>(m, n, k, alpha, a, b, beta, c, ldc, epilogue, kernelInfo(kernel));
+        return;
+    }
+    const GemmKernel chosen = kernel == GemmKernel::Auto ? bestBf16GemmKernel() : kernel;
+    if (chosen != GemmKernel::AmxBf16 && chosen != GemmKernel::Avx512Bf16) {
+        runFloatPanels<true>(m, n, k, alpha, a, b, beta, c, ldc, epilogue, kernelInfo(chosen));
+        return;
+    }
+    if (!gemmKernelSupported(chosen)) {
+        throw std::invalid_argument("This CPU does not support the " + gemmKernelName(chosen) + " GEMM kernel");
+    }
+#ifdef AI_LANGUAGE_X86
+    const GemmBlocking blk = bf16Blocking(chosen);
+    withOperand(a, [&](auto pa) {
+        withOperand(b, [&](auto pb) {
+            if (chosen == GemmKernel::AmxBf16) {
+                runBlocked<uint16_t>(m, n, k, alpha, beta, c, ldc, epilogue, blk, kAmxK, packedPairsA, packedPairsB,
+                    [&](size_t i0, size_t p0, size_t rows, size_t depth, size_t begin, size_t end, uint16_t* out) {
+                        packRowsA(pa, a.ld, a.transposed, i0, p0, rows, depth, blk.mr, begin, end, out);
+                    },
+                    [&](size_t p0, size_t j0, size_t depth, size_t cols, size_t begin, size_t end, uint16_t* out) {
+                        packPairsB(pb, b.ld, b.transposed, p0, j0, depth, cols, blk.nr, kAmxK, begin, end, out);
+                    },
+                    kernelAmxBf16);
+                return;
+            }
+            runBlocked<uint16_t>(m, n, k, alpha, beta, c, ldc, epilogue, blk, 2, packedPairsA, packedPairsB,
+                [&](size_t i0, size_t p0, size_t rows, size_t depth, size_t begin, size_t end, uint16_t* out) {
+                    packPairsA(pa, a.ld, a.transposed, i0, p0, rows, depth, blk.mr, begin, end, out);
+                },
+                [&](size_t p0, size_t j0, size_t depth, size_t cols, size_t begin, size_t end, uint16_t* out) {
+                    packPairsB(pb, b.ld, b.transposed, p0, j0, depth, cols, blk.nr, 2, begin, end, out);
+                },
+                kernelAvx512Bf16);
+        });
+    });
+#endif
+}
+
+namespace {
+
+// แปลง Tensor สองมิติเป็น (ตัวชี้, leading dimension, สลับแกนหรือไม่) โดยรับมุมมองที่สลับแกนแล้วได้
+void matrixOperand(const Tensor& t, const char* name, bool& trans, size_t& ld) {
+    if (t.dim() != 2 || t.dtype() != DType::Float32) {
+        throw std::invalid_argument(std::string("matmul: ") + name + " must be a 2-D float32 tensor, got " + t.describe());
+    }
+    const std::vector<size_t>& steps = t.strides();
+    if (steps[1] == 1 || t.shape()[1] == 1) {
+        ld = std::max<size_t>(steps[0], t.shape()[1]);
+    } else if (steps[0] == 1 || t.shape()[0] == 1) {
+        trans = !trans;
+        ld = std::max<size_t>(steps[1], t.shape()[0]);
+    } else {
+        throw std::invalid_argument(std::string("matmul: ") + name + " needs one unit stride, got " + t.describe());
+    }
+}
+
+} // namespace
+
+void matmul(const Tensor& a, const Tensor& b, Tensor& c, bool transA, bool transB, float alpha, float beta,
+            GemmKernel kernel) {
+    size_t lda = 0, ldb = 0, ldc = 0;
+    bool storedA = transA, storedB = transB;
+    matrixOperand(a, "a", storedA, lda);
+    matrixOperand(b, "b", storedB, ldb);
+    size_t m = transA ? a.size(1) : a.size(0);
+    size_t k = transA ? a.size(0) : a.size(1);
+    size_t n = transB ? b.size(0) : b.size(1);
+    size_t kb = transB ? b.size(1) : b.size(0);
+    bool transC = false;
+    matrixOperand(c, "c", transC, ldc);
+    if (transC) {
+        throw std::invalid_argument("matmul: c must be row-major, got " + c.describe());
+    }
+    if (k != kb || c.size(0) != m || c.size(1) != n) {
+        throw std::invalid_argument("matmul: shapes " + shapeToString(a.shape()) + (transA ? "^T" : "") + " x " +
+                                    shapeToString(b.shape()) + (transB ? "^T" : "") + " -> " +
+                                    shapeToString(c.shape()) + " do not match");
+    }
+    sgemm(storedA, storedB, m, n, k, alpha, a.data<float>(), lda, b.data<float>(), ldb, beta, c.data<float>(), ldc,
+          kernel);
+}
+
+} // namespace ai_language
@@ -0,0 +1,455 @@
+#include "../../include/dl/Graph.h"
+#include "../../include/dl/Autograd.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace ai_language {
+
+namespace {
+
+std::vector<std::string> splitOn(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    std::string part;
+    std::istringstream stream(text);
+    while (std::getline(stream, part, separator)) {
+        parts.push_back(part);
+    }
+    return parts;
+}
+
+size_t parseSize(const std::string& text, const char* what) {
+    size_t used = 0;
+    long long value = 0;
+    try {
+        value = std::stoll(text, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (used != text.size() || value <= 0) {
+        throw std::invalid_argument(std::string(what) + " must be a positive integer, got '" + text + "'");
+    }
+    return static_cast<size_t>(value);
+}
+
+size_t product(const std::vector<size_t>& shape) {
+    size_t total = 1;
+    for (size_t dim : shape) {
+        total *= dim;
+    }
+    return total;
+}
+
+std::vector<size_t> batched(size_t batch, const std::vector<size_t>& shape) {
+    std::vector<size_t> result{batch};
+    result.insert(result.end(), shape.begin(), shape.end());
+    return result;
+}
+
+} // namespace
+
+std::string layerKindName(LayerKind kind) {
+    switch (kind) {
+        case LayerKind::Input: return "input";
+        case LayerKind::Conv: return "conv";
+        case LayerKind::Pool: return "pool";
+        case LayerKind::Flatten: return "flatten";
+        case LayerKind::Dense: return "dense";
+        case LayerKind::Dropout: return "dropout";
+    }
+    return "unknown";
+}
+
+LayerSpec LayerSpec::parse(const std::string& text) {
+    std::vector<std::string> parts = splitOn(text, ':');
+    if (parts.empty()) {
+        throw std::invalid_argument("Empty layer description");
+    }
+    const std::string& type = parts[0];
+    LayerSpec spec;
+    spec.source = text;
+
+    if (type == "input") {
+        spec.kind = LayerKind::Input;
+        if (parts.size() < 2) {
+            throw std::invalid_argument("input layer needs a size");
+        }
+        std::vector<std::string> dims = splitOn(parts[1], 'x');
+        if (dims.size() == 1) {
+            spec.shape = {parseSize(dims[0], "input size")};
+        } else if (dims.size() == 3) {
+            // ผู้ใช้เขียน กว้าง สูง ช่องสี แต่เก็บภายในเป็น ช่องสี x สูง x กว้าง
+            spec.shape = {parseSize(dims[2], "channels"), parseSize(dims[1], "height"), parseSize(dims[0], "width")};
+        } else {
+            throw std::invalid_argument("input layer needs <size> or <width> <height> <channels>");
+        }
+    } else if (type == "conv") {
+        spec.kind = LayerKind::Conv;
+        if (parts.size() < 3) {
+            throw std::invalid_argument("conv layer needs filters and kernel size");
+        }
+        spec.units = parseSize(parts[1], "filters");
+        spec.kernel = parseSize(parts[2], "kernel size");
+        spec.activation = parts.size() > 3 ? parseActivation(parts[3]) : Activation::ReLU;
+    } else if (type == "pool") {
+        spec.kind = LayerKind::Pool;
+        std::vector<std::string> dims = parts.size() > 1 ? splitOn(parts[1], 'x') : std::vector<std::string>{};
+        if (dims.size() == 1) {
+            spec.poolWidth = spec.poolHeight = parseSize(dims[0], "pool size");
+        } else if (dims.size() == 2) {
+            spec.poolWidth = parseSize(dims[0], "pool width");
+            spec.poolHeight = parseSize(dims[1], "pool height");
+        } else {
+            throw std::invalid_argument("pool layer needs a window size");
+        }
+    } else if (type == "flatten") {
+        spec.kind = LayerKind::Flatten;
+    } else if (type == "hidden" || type == "dense" || type == "output") {
+        spec.kind = LayerKind::Dense;
+        spec.output = type == "output";
+        if (parts.size() < 2) {
+            throw std::invalid_argument(type + " layer needs a number of units");
+        }
+        spec.units = parseSize(parts[1], "units");
+        spec.activation = parts.size() > 2 ? parseActivation(parts[2])
+                                           : (spec.output ? Activation::Softmax : Activation::ReLU);
+    } else if (type == "dropout") {
+        spec.kind = LayerKind::Dropout;
+        if (parts.size() < 2) {
+            throw std::invalid_argument("dropout layer needs a rate");
+        }
+        try {
+            spec.rate = std::stof(parts[1]);
+        } catch (const std::exception&) {
+            throw std::invalid_argument("dropout rate must be a number, got '" + parts[1] + "'");
+        }
+        if (!(spec.rate >= 0.0f && spec.rate < 1.0f)) {
+            throw std::invalid_argument("dropout rate must be in [0, 1)");
+        }
+    } else {
+        throw std::invalid_argument("Unknown layer type '" + type + "'");
+    }
+    return spec;
+}
+
+std::string LayerSpec::describe() const {
+    std::ostringstream out;
+    switch (kind) {
+        case LayerKind::Input:
+            out << "input";
+            break;
+        case LayerKind::Conv:
+            out << "conv " << units << "x" << kernel << "x" << kernel << " " << activationName(activation);
+            break;
+        case LayerKind::Pool:
+            out << "maxpool " << poolWidth << "x" << poolHeight;
+            break;
+        case LayerKind::Flatten:
+            out << "flatten";
+            break;
+        case LayerKind::Dense:
+            out << (output ? "output " : "dense ") << units << " " << activationName(activation);
+            break;
+        case LayerKind::Dropout:
+            out << "dropout " << rate;
+            break;
+    }
+    return out.str();
+}
+
+size_t GraphValue::bytes() const {
+    return product(shape) * dtypeSize(dtype);
+}
+
+size_t LayerGraph::addValue(const std::string& name, std::vector<size_t> shape, DType dtype) {
+    GraphValue value;
+    value.name = name;
+    value.shape = std::move(shape);
+    value.dtype = dtype;
+    graphValues.push_back(std::move(value));
+    return graphValues.size() - 1;
+}
+
+size_t LayerGraph::aliasValue(const std::string& name, size_t target, std::vector<size_t> shape) {
+    size_t id = addValue(name, std::move(shape), graphValues[target].dtype);
+    graphValues[id].aliasOf = static_cast<int>(target);
+    return id;
+}
+
+ConvShape GraphNode::convShape() const {
+    return {inputShape[0], inputShape[1], inputShape[2], spec.units, spec.kernel};
+}
+
+LayerGraph LayerGraph::compile(const std::vector<std::string>& layers, size_t batchSize, bool training,
+                               GemmPrecision precision) {
+    if (batchSize == 0) {
+        throw std::invalid_argument("batch_size must be positive");
+    }
+    if (layers.empty()) {
+        throw std::invalid_argument("The model has no layers");
+    }
+    LayerGraph graph;
+    graph.batch = batchSize;
+    graph.trainingMode = training;
+    graph.activationPrecision = precision;
+
+    // อนุมาน shape ทุกชั้นให้ครบก่อนสร้างค่าและขั้นตอนใด ๆ
+    std::vector<size_t> shape;
+    for (size_t i = 0; i < layers.size(); i++) {
+        auto fail = [&](const std::string& why) {
+            throw std::invalid_argument("Layer " + std::to_string(i + 1) + " (" + layers[i] + "): " + why);
+        };
+        GraphNode node;
+        try {
+            node.spec = LayerSpec::parse(layers[i]);
+        } catch (const std::invalid_argument& e) {
+            fail(e.what());
+        }
+        const LayerSpec& spec = node.spec;
+        if (i == 0 && spec.kind != LayerKind::Input) {
+            fail("the first layer must be 'add layer input <size>' or 'add layer input <width> <height> <channels>'");
+        }
+        if (i > 0 && spec.kind == LayerKind::Input) {
+            fail("only the first layer can be an input layer");
+        }
+        if (i > 0 && graph.layerNodes.back().spec.output) {
+            fail("no layer can follow the output layer");
+        }
+        node.name = layerKindName(spec.kind) + std::to_string(i);
+        node.inputShape = shape;
+
+        switch (spec.kind) {
+            case LayerKind::Input:
+                node.outputShape = spec.shape;
+                break;
+            case LayerKind::Conv: {
+                if (shape.size() != 3) {
+                    fail("convolution needs a channels x height x width input but receives " + shapeToString(shape) +
+                         "; use 'add layer input <width> <height> <channels>' and place convolutions before flatten");
+                }
+                if (spec.kernel > shape[1] || spec.kernel > shape[2]) {
+                    fail("kernel " + std::to_string(spec.kernel) + " is larger than the " + std::to_string(shape[1]) +
+                         "x" + std::to_string(shape[2]) + " input");
+                }
+                if (spec.activation == Activation::Softmax) {
+                    fail("softmax applies only to dense layers");
+                }
+                node.outputShape = {spec.units, shape[1] - spec.kernel + 1, shape[2] - spec.kernel + 1};
+                node.parameters = spec.units * shape[0] * spec.kernel * spec.kernel + spec.units;
+                break;
+            }
+            case LayerKind::Pool:
+                if (shape.size() != 3) {
+                    fail("pooling needs a channels x height x width input but receives " + shapeToString(shape));
+                }
+                if (spec.poolHeight > shape[1] || spec.poolWidth > shape[2]) {
+                    fail("pool window is larger than the " + std::to_string(shape[1]) + "x" +
+                         std::to_string(shape[2]) + " input");
+                }
+                node.outputShape = {shape[0], shape[1] / spec.poolHeight, shape[2] / spec.poolWidth};
+                break;
+            case LayerKind::Flatten:
+                node.outputShape = {product(shape)};
+                break;
+            case LayerKind::Dense:
+                if (shape.size() != 1) {
+                    fail("dense layers need a flat input but receive " + shapeToString(shape) +
+                         "; add 'add layer flatten' before this layer");
+                }
+                node.outputShape = {spec.units};
+                node.parameters = shape[0] * spec.units + spec.units;
+                break;
+            case LayerKind::Dropout:
+                node.outputShape = shape;
+                break;
+        }
+        shape = node.outputShape;
+        graph.layerNodes.push_back(std::move(node));
+    }
+    if (graph.layerNodes.size() < 2) {
+        throw std::invalid_argument("The model has only an input layer");
+    }
+    if (training && graph.parameterCount() == 0) {
+        throw std::invalid_argument("The model has no trainable layers (add a dense, conv or output layer)");
+    }
+
+    // forward: ทุกชั้นเขียนค่าใหม่ ยกเว้น flatten (และ dropout ตอนทำนาย) ที่เป็นมุมมองบนค่าเดิม
+    std::vector<GraphNode>& nodes = graph.layerNodes;
+    std::vector<bool> needsGradient(nodes.size(), false);
+    // max(ReLU(x)) = ReLU(max(x)) จึงย้าย ReLU ของ conv ไปทำบนผลลัพธ์ที่เล็กกว่าของ pool
+    for (size_t i = 1; i < nodes.size(); i++) {
+        if (nodes[i].spec.kind == LayerKind::Pool && nodes[i - 1].spec.kind == LayerKind::Conv &&
+            nodes[i - 1].spec.activation == Activation::ReLU) {
+            nodes[i - 1].activationFused = true;
+            nodes[i].fusedReLU = true;
+        }
+    }
+    std::vector<int> workspace(nodes.size(), -1), mask(nodes.size(), -1);
+    const DType activationType = precision == GemmPrecision::BFloat16 ? DType::BFloat16 : DType::Float32;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        GraphNode& node = nodes[i];
+        const LayerSpec& spec = node.spec;
+        std::vector<size_t> outShape = batched(batchSize, node.outputShape);
+        if (i == 0) {
+            node.output = graph.addValue(node.name + ".out", outShape, activationType);
+            graph.schedule.push_back({"load batch", i, {}, {node.output}});
+            continue;
+        }
+        node.input = nodes[i - 1].output;
+        needsGradient[i] = training && (node.parameters > 0 || needsGradient[i - 1]);
+        GraphStep step{"forward " + node.name, i, {node.input}, {}};
+        if (spec.kind == LayerKind::Flatten || (spec.kind == LayerKind::Dropout && !training)) {
+            node.output = graph.aliasValue(node.name + ".out", node.input, outShape);
+            continue;
+        }
+        if (spec.kind == LayerKind::Conv) {
+            // ไทล์ im2col/Winograd ของทุกเธรด (ขนาดคงที่ไม่ขึ้นกับ batch)
+            workspace[i] = static_cast<int>(graph.addValue(node.name + ".workspace",
+                {convWorkspaceFloats(node.convShape(), ConvAlgorithm::Auto, false, availableThreads(), activationType)}));
+            step.writes.push_back(static_cast<size_t>(workspace[i]));
+        }
+        if (activationType != DType::Float32 && spec.kind == LayerKind::Dense) {
+            // GEMM สะสมผลเป็น float32 ทีละกลุ่มแถวก่อนปัดลงผลลัพธ์ bf16 (conv ใช้ไทล์ใน workspace)
+            step.writes.push_back(graph.addValue(node.name + ".acc",
+                {denseAccumulatorRows(batchSize, spec.units), spec.units}));
+        }
+        node.output = graph.addValue(node.name + ".out", outShape, activationType);
+        step.writes.push_back(node.output);
+        if (spec.kind == LayerKind::Dropout) {
+            mask[i] = static_cast<int>(graph.addValue(node.name + ".mask", outShape, DType::Int8));
+            step.writes.push_back(static_cast<size_t>(mask[i]));
+        }
+        if (spec.kind == LayerKind::Pool && training) {
+            node.argmax = static_cast<int>(graph.addValue(node.name + ".argmax", outShape, DType::Int8));
+            step.writes.push_back(static_cast<size_t>(node.argmax));
+        }
+        graph.schedule.push_back(std::move(step));
+    }
+    if (!training) {
+        return graph;
+    }
+
+    // loss เขียน gradient ของผลลัพธ์สุดท้าย (softmax/sigmoid สุดท้ายรวมอยู่ใน loss)
+    size_t last = nodes.size() - 1;
+    nodes[last].gradient = static_cast<int>(graph.addValue(nodes[last].name + ".grad",
+                                                           batched(batchSize, nodes[last].outputShape)));
+    graph.schedule.push_back({"loss", last, {nodes[last].output}, {static_cast<size_t>(nodes[last].gradient)}});
+
+    for (size_t i = last; i >= 1 && needsGradient[i]; i--) {
+        GraphNode& node = nodes[i];
+        const LayerSpec& spec = node.spec;
+        size_t gradOut = static_cast<size_t>(node.gradient);
+        int gradIn = -1;
+        if (needsGradient[i - 1]) {
+            std::vector<size_t> inShape = batched(batchSize, node.inputShape);
+            gradIn = spec.kind == LayerKind::Flatten
+                ? static_cast<int>(graph.aliasValue(nodes[i - 1].name + ".grad", gradOut, inShape))
+                : static_cast<int>(graph.addValue(nodes[i - 1].name + ".grad", inShape));
+            nodes[i - 1].gradient = gradIn;
+        }
+        if (spec.kind == LayerKind::Flatten) {
+            continue;
+        }
+        GraphStep step{"backward " + node.name, i, {gradOut}, {}};
+        bool foldedIntoLoss = i == last && (spec.activation == Activation::Softmax ||
+                                            spec.activation == Activation::Sigmoid);
+        switch (spec.kind) {
+            case LayerKind::Dense:
+            case LayerKind::Conv:
+                // x สำหรับ gradient ของ weight, ผลลัพธ์สำหรับอนุพันธ์ของ activation
+                step.reads.push_back(node.input);
+                if (spec.activation != Activation::Linear && !foldedIntoLoss && !node.activationFused) {
+                    step.reads.push_back(node.output);
+                }
+                if (spec.kind == LayerKind::Conv) {
+                    step.writes.push_back(graph.addValue(node.name + ".dworkspace",
+                        {convWorkspaceFloats(node.convShape(), ConvAlgorithm::Auto, true, availableThreads())}));
+                }
+                break;
+            case LayerKind::Pool:
+                // argmax บอกตำแหน่งที่ได้ gradient ส่วนผลลัพธ์ใช้เป็น mask ของ ReLU ที่รวมเข้ามา
+                step.reads.push_back(static_cast<size_t>(node.argmax));
+                if (node.fusedReLU) {
+                    step.reads.push_back(node.output);
+                }
+                break;
+            case LayerKind::Dropout:
+                step.reads.push_back(static_cast<size_t>(mask[i]));
+                break;
+            default:
+                break;
+        }
+        if (gradIn >= 0) {
+            step.writes.push_back(static_cast<size_t>(gradIn));
+        }
+        graph.schedule.push_back(std::move(step));
+    }
+    return graph;
+}
+
+size_t LayerGraph::parameterCount() const {
+    size_t total = 0;
+    for (const GraphNode& node : layerNodes) {
+        total += node.parameters;
+    }
+    return total;
+}
+
+const std::vector<size_t>& LayerGraph::outputShape() const {
+    if (layerNodes.empty()) {
+        throw std::out_of_range("The graph is empty");
+    }
+    return layerNodes.back().outputShape;
+}
+
+void LayerGraph::print(std::ostream& os) const {
+    std::ios::fmtflags flags = os.flags();
+    os << "  " << std::left << std::setw(4) << "#" << std::setw(24) << "layer" << std::setw(18) << "output shape"
+       << std::right << std::setw(12) << "params" << "\n";
+    for (size_t i = 0; i < layerNodes.size(); i++) {
+        const GraphNode& node = layerNodes[i];
+        os << "  " << std::left << std::setw(4) << i << std::setw(24) << node.spec.describe() << std::setw(18)
+           << shapeToString(node.outputShape) << std::right << std::setw(12) << node.parameters << "\n";
+    }
+    os << "  Total parameters: " << parameterCount() << " (batch " << batch << ", "
+       << (trainingMode ? "training" : "inference") << ", " << schedule.size() << " steps"
+       << (activationPrecision == GemmPrecision::BFloat16 ? ", bf16 activations" : "") << ")\n";
+    for (size_t i = 1; i < layerNodes.size(); i++) {
+        if (layerNodes[i].fusedReLU) {
+            os << "  Fused: " << layerNodes[i - 1].name << " bias+relu -> " << layerNodes[i].name
+               << " max (conv output is read once" << (trainingMode ? ", argmax 1 byte per output" : "") << ")\n";
+        }
+    }
+    os.flags(flags);
+}
+
+std::vector<std::string> defaultLayers(size_t neuronsPerLayer) {
+    size_t hidden = std::max<size_t>(neuronsPerLayer, 2);
+    return {"input:784:linear", "hidden:" + std::to_string(hidden) + ":relu",
+            "hidden:" + std::to_string(hidden / 2) + ":relu", "output:10:softmax"};
+}
+
+std::vector<std::string> withInferredInput(const std::vector<std::string>& layers, size_t features) {
+    if (!layers.empty() && LayerSpec::parse(layers.front()).kind == LayerKind::Input) {
+        return layers;
+    }
+    if (features == 0) {
+        throw std::invalid_argument("Cannot infer an input layer from 0 features");
+    }
+    for (size_t i = 0; i < layers.size(); i++) {
+        LayerKind kind = LayerSpec::parse(layers[i]).kind;
+        if (kind == LayerKind::Conv || kind == LayerKind::Pool) {
+            throw std::invalid_argument("Layer " + std::to_string(i + 1) + " (" + layers[i] +
+                                        "): needs an image input; declare 'add layer input <width> <height> <channels>'");
+        }
+    }
+    std::vector<std::string> result;
+    result.reserve(layers.size() + 1);
+    result.push_back("input:" + std::to_string(features) + ":linear");
+    result.insert(result.end(), layers.begin(), layers.end());
+    return result;
+}
+
+} // namespace ai_language
@@ -0,0 +1,146 @@
+#include "../../include/dl/MemoryPlanner.h"
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace ai_language {
+
+namespace {
+
+size_t alignUp(size_t bytes) {
+    return (bytes + Tensor::kAlignment - 1) / Tensor::kAlignment * Tensor::kAlignment;
+}
+
+std::string formatBytes(size_t bytes) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if (bytes < 1024) {
+        out << bytes << " B";
+    } else if (bytes < 1024 * 1024) {
+        out << bytes / 1024.0 << " KB";
+    } else {
+        out << bytes / (1024.0 * 1024.0) << " MB";
+    }
+    return out.str();
+}
+
+} // namespace
+
+MemoryPlan MemoryPlan::build(const LayerGraph& graph) {
+    MemoryPlan plan;
+    plan.values = graph.values();
+    plan.steps = graph.steps().size();
+    const size_t count = plan.values.size();
+
+    // มุมมองใช้บัฟเฟอร์ของค่าต้นทาง อายุของต้นทางจึงครอบคลุมการใช้มุมมองด้วย
+    auto root = [&](size_t value) {
+        while (plan.values[value].aliasOf >= 0) {
+            value = static_cast<size_t>(plan.values[value].aliasOf);
+        }
+        return value;
+    };
+    const size_t never = std::numeric_limits<size_t>::max();
+    std::vector<size_t> first(count, never), last(count, 0);
+    for (size_t s = 0; s < graph.steps().size(); s++) {
+        const GraphStep& step = graph.steps()[s];
+        for (const std::vector<size_t>* list : {&step.reads, &step.writes}) {
+            for (size_t value : *list) {
+                size_t owner = root(value);
+                first[owner] = std::min(first[owner], s);
+                last[owner] = std::max(last[owner], s);
+            }
+        }
+    }
+
+    plan.bufferIndex.assign(count, -1);
+    for (size_t v = 0; v < count; v++) {
+        if (plan.values[v].aliasOf < 0 && first[v] != never) {
+            PlannedBuffer buffer;
+            buffer.value = v;
+            buffer.bytes = alignUp(plan.values[v].bytes());
+            buffer.firstStep = first[v];
+            buffer.lastStep = last[v];
+            plan.naive += buffer.bytes;
+            plan.planned.push_back(buffer);
+        }
+    }
+
+    // ใหญ่ก่อน: บัฟเฟอร์ใหญ่ได้ตำแหน่งต่ำ บัฟเฟอร์เล็กแทรกในช่องว่างระหว่างกัน
+    std::stable_sort(plan.planned.begin(), plan.planned.end(), [](const PlannedBuffer& a, const PlannedBuffer& b) {
+        return a.bytes > b.bytes;
+    });
+    std::vector<const PlannedBuffer*> placed;
+    for (PlannedBuffer& buffer : plan.planned) {
+        std::vector<const PlannedBuffer*> live;
+        for (const PlannedBuffer* other : placed) {
+            if (other->firstStep <= buffer.lastStep && buffer.firstStep <= other->lastStep) {
+                live.push_back(other);
+            }
+        }
+        std::sort(live.begin(), live.end(), [](const PlannedBuffer* a, const PlannedBuffer* b) {
+            return a->offset < b->offset;
+        });
+        size_t offset = 0;
+        for (const PlannedBuffer* other : live) {
+            if (offset + buffer.bytes <= other->offset) {
+                break;
+            }
+            offset = std::max(offset, other->offset + other->bytes);
+        }
+        buffer.offset = offset;
+        plan.peak = std::max(plan.peak, offset + buffer.bytes);
+        placed.push_back(&buffer);
+    }
+
+    std::sort(plan.planned.begin(), plan.planned.end(), [](const PlannedBuffer& a, const PlannedBuffer& b) {
+        return a.value < b.value;
+    });
+    for (size_t i = 0; i < plan.planned.size(); i++) {
+        plan.bufferIndex[plan.planned[i].value] = static_cast<int>(i);
+    }
+    for (size_t v = 0; v < count; v++) {
+        plan.bufferIndex[v] = plan.bufferIndex[root(v)];
+    }
+    return plan;
+}
+
+const PlannedBuffer& MemoryPlan::bufferOf(size_t value) const {
+    if (value >= bufferIndex.size() || bufferIndex[value] < 0) {
+        throw std::out_of_range("Value " + std::to_string(value) + " has no planned buffer");
+    }
+    return planned[static_cast<size_t>(bufferIndex[value])];
+}
+
+Tensor MemoryPlan::allocateArena() const {
+    return Tensor({std::max<size_t>(peak, 1)}, DType::Int8);
+}
+
+Tensor MemoryPlan::bind(Tensor& arena, size_t value) const {
+    const PlannedBuffer& buffer = bufferOf(value);
+    if (arena.dtype() != DType::Int8 || arena.nbytes() < buffer.offset + buffer.bytes) {
+        throw std::invalid_argument("Arena of " + std::to_string(arena.nbytes()) + " bytes is smaller than the plan (" +
+                                    std::to_string(peak) + " bytes)");
+    }
+    const GraphValue& info = values[value];
+    return Tensor::wrap(static_cast<uint8_t*>(arena.raw()) + buffer.offset, info.shape, info.dtype);
+}
+
+void MemoryPlan::print(std::ostream& os, const MemoryPlan* float32Plan) const {
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    double saved = naive > 0 ? 100.0 * (1.0 - static_cast<double>(peak) / static_cast<double>(naive)) : 0.0;
+    os << "  Activation arena (estimate): " << formatBytes(peak) << " planned peak vs " << formatBytes(naive)
+       << " naive sum (" << std::fixed << std::setprecision(1) << saved << "% less), " << planned.size()
+       << " buffers over " << steps << " steps\n";
+    if (float32Plan != nullptr && float32Plan->peak > 0) {
+        double smaller = 100.0 * (1.0 - static_cast<double>(peak) / static_cast<double>(float32Plan->peak));
+        os << "  bf16 activations: " << formatBytes(peak) << " planned peak vs " << formatBytes(float32Plan->peak)
+           << " with fp32 activations (" << smaller << "% less)\n";
+    }
+    os.flags(flags);
+    os.precision(precision);
+}
+
+} // namespace ai_language
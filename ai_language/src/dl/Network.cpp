@@ -0,0 +1,217 @@
+#include "../../include/dl/Network.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace ai_language {
+
+namespace {
+
+// ก้อนละ 64 KB ของ float32 ต่อเธรด
+constexpr size_t kMinConvertChunk = 16384;
+
+} // namespace
+
+Network::Network(const LayerGraph& graph, uint32_t seed, GemmPrecision precision) : rng(seed), gemmPrecision(precision) {
+    if (graph.empty() || !graph.training()) {
+        throw std::invalid_argument("Network needs a graph compiled for training");
+    }
+    const std::vector<GraphNode>& nodes = graph.nodes();
+    inputFeatures = 1;
+    for (size_t dim : nodes.front().outputShape) {
+        inputFeatures *= dim;
+    }
+    outputFeatures = 1;
+    for (size_t dim : nodes.back().outputShape) {
+        outputFeatures *= dim;
+    }
+
+    size_t total = 0;
+    for (size_t i = 1; i < nodes.size(); i++) {
+        const GraphNode& node = nodes[i];
+        Layer layer;
+        layer.kind = node.spec.kind;
+        layer.activation = node.spec.activation;
+        switch (layer.kind) {
+            case LayerKind::Conv:
+                layer.conv = node.convShape();
+                layer.algorithm = selectConvAlgorithm(layer.conv).algorithm;
+                layer.weightSize = layer.conv.filters * layer.conv.patch();
+                if (node.activationFused) {
+                    layer.activation = Activation::Linear;
+                }
+                break;
+            case LayerKind::Pool:
+                layer.pool = {node.inputShape[0], node.inputShape[1], node.inputShape[2], node.spec.poolHeight,
+                              node.spec.poolWidth};
+                layer.fusedReLU = node.fusedReLU;
+                break;
+            case LayerKind::Dense:
+                layer.units = node.spec.units;
+                layer.weightSize = layer.units * node.inputShape[0];
+                if (i + 1 == nodes.size() &&
+                    (layer.activation == Activation::Softmax || layer.activation == Activation::Sigmoid)) {
+                    lossActivation = layer.activation;
+                    layer.activation = Activation::Linear;
+                }
+                break;
+            case LayerKind::Dropout:
+                layer.rate = node.spec.rate;
+                break;
+            default:
+                break;
+        }
+        layer.weightOffset = total;
+        layer.biasOffset = total + layer.weightSize;
+        total += node.parameters;
+        layers.push_back(layer);
+    }
+
+    weights = Tensor({total});
+    grads = Tensor({total});
+    float* values = weights.data<float>();
+    for (size_t i = 0; i < layers.size(); i++) {
+        const Layer& layer = layers[i];
+        if (layer.weightSize == 0) {
+            continue;
+        }
+        const GraphNode& node = nodes[i + 1];
+        size_t outputs = layer.kind == LayerKind::Conv ? layer.conv.filters : layer.units;
+        size_t fanIn = layer.weightSize / outputs;
+        size_t fanOut = layer.kind == LayerKind::Conv ? outputs * layer.conv.kernel * layer.conv.kernel : outputs;
+        float limit = node.spec.activation == Activation::ReLU
+                          ? std::sqrt(6.0f / static_cast<float>(fanIn))
+                          : std::sqrt(6.0f / static_cast<float>(fanIn + fanOut));
+        std::uniform_real_distribution<float> distribution(-limit, limit);
+        for (size_t j = 0; j < layer.weightSize; j++) {
+            values[layer.weightOffset + j] = distribution(rng);
+        }
+    }
+    if (precision == GemmPrecision::BFloat16) {
+        weights16 = Tensor({total}, DType::BFloat16);
+        refreshWeightCopy();
+    }
+}
+
+void Network::shareParameters(const Network& source) {
+    if (source.weights.numel() != weights.numel() || source.inputFeatures != inputFeatures ||
+        source.outputFeatures != outputFeatures) {
+        throw std::invalid_argument("Cannot share parameters between networks of different shapes");
+    }
+    if (source.gemmPrecision != gemmPrecision) {
+        throw std::invalid_argument("Cannot share parameters between networks of different precision");
+    }
+    weights = source.weights;
+    weights16 = source.weights16;
+}
+
+void Network::refreshWeightCopy() {
+    if (weights16.empty()) {
+        return;
+    }
+    const float* values = weights.data<float>();
+    uint16_t* copy = weights16.data<uint16_t>();
+    parallelFor(0, weights.numel(), [&](size_t begin, size_t end, size_t) {
+        floatToBf16(values + begin, copy + begin, end - begin);
+    }, kMinConvertChunk);
+}
+
+Parameter Network::parameter(size_t offset, size_t size) {
+    Parameter p{weights.data<float>() + offset, grads.data<float>() + offset, size};
+    if (!weights16.empty()) {
+        p.value16 = weights16.data<uint16_t>() + offset;
+    }
+    return p;
+}
+
+Var Network::forward(Tape& tape, const float* inputs, size_t batch) {
+    Var x = tape.constant(inputs, batch, inputFeatures);
+    if (gemmPrecision == GemmPrecision::BFloat16) {
+        // ชั้นแรกเก็บ x ไว้คำนวณ gradient ของ weight จึงเก็บสำเนา bf16 ใน arena แทนการอ้าง batch float32
+        x = tape.variable(batch, inputFeatures, false);
+        floatToBf16(inputs, x->data16, x->size());
+    }
+    for (const Layer& layer : layers) {
+        switch (layer.kind) {
+            case LayerKind::Conv:
+                x = conv2d(tape, x, layer.conv, parameter(layer.weightOffset, layer.weightSize),
+                           parameter(layer.biasOffset, layer.conv.filters), layer.activation, layer.algorithm);
+                break;
+            case LayerKind::Pool:
+                x = maxPool(tape, x, layer.pool, layer.fusedReLU);
+                break;
+            case LayerKind::Dense:
+                x = dense(tape, x, parameter(layer.weightOffset, layer.weightSize),
+                          parameter(layer.biasOffset, layer.units), layer.units, layer.activation);
+                break;
+            case LayerKind::Dropout:
+                x = dropout(tape, x, layer.rate, rng);
+                break;
+            default:
+                // flatten: ข้อมูลแต่ละตัวอย่างต่อเนื่องกันอยู่แล้ว
+                break;
+        }
+    }
+    return x;
+}
+
+float Network::computeGradients(const float* inputs, const float* targets, size_t batch) {
+    if (batch == 0) {
+        throw std::invalid_argument("batch must be positive");
+    }
+    stepStart = arena.heapAllocations();
+    stepBatch = batch;
+    std::memset(grads.data<float>(), 0, grads.nbytes());
+    Tape tape(arena, true, gemmPrecision);
+    Var output = forward(tape, inputs, batch);
+    float loss = lossAndGradient(tape, output, lossActivation, targets);
+    tape.backward();
+    return loss;
+}
+
+float Network::applyOptimizer(Optimizer& optimizer) {
+    if (optimizer.parameterCount() != weights.numel()) {
+        throw std::invalid_argument("Optimizer was created for " + std::to_string(optimizer.parameterCount()) +
+                                    " parameters but the network has " + std::to_string(weights.numel()));
+    }
+    float norm = optimizer.step(weights.data<float>(), grads.data<float>());
+    refreshWeightCopy();
+    return norm;
+}
+
+void Network::endStep() {
+    arena.reset();
+    stepAllocations = arena.heapAllocations() - stepStart;
+    size_t threads = availableThreads();
+#ifndef NDEBUG
+    if (stepAllocations > 0 && stepBatch <= warmBatch && threads == warmThreads) {
+        throw std::logic_error("Training step with batch " + std::to_string(stepBatch) + " allocated " +
+                               std::to_string(stepAllocations) + " heap blocks after warm-up");
+    }
+#endif
+    if (threads != warmThreads) {
+        warmThreads = threads;
+        warmBatch = 0;
+    }
+    warmBatch = std::max(warmBatch, stepBatch);
+}
+
+float Network::trainStep(const float* inputs, const float* targets, size_t batch, Optimizer& optimizer) {
+    float loss = computeGradients(inputs, targets, batch);
+    applyOptimizer(optimizer);
+    endStep();
+    return loss;
+}
+
+float Network::evaluate(const float* inputs, const float* targets, size_t batch, float* predictions) {
+    Tape tape(arena, false, gemmPrecision);
+    Var output = forward(tape, inputs, batch);
+    float loss = lossAndGradient(tape, output, lossActivation, targets, predictions);
+    arena.reset();
+    return loss;
+}
+
+} // namespace ai_language
@@ -0,0 +1,326 @@
+#include "../../include/dl/Optimizer.h"
+#include "../../include/utils/cpu_features.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define AI_LANGUAGE_X86 1
+#endif
+
+namespace ai_language {
+
+namespace {
+
+// ก้อนละ 32K ค่า (128 KB ต่ออาร์เรย์) เล็กกว่านี้ไม่คุ้มกับการสร้างเธรด
+constexpr size_t kMinChunk = size_t(1) << 15;
+
+// ค่าคงที่ของหนึ่ง step ที่คำนวณครั้งเดียวก่อนเข้า loop
+struct Coefficients {
+    OptimizerKind kind = OptimizerKind::SGD;
+    float learningRate = 0.0f;
+    float scale = 1.0f;             ///< ตัวคูณจากการ clip
+    float l2 = 0.0f;                ///< weight decay ที่บวกเข้า gradient
+    float decay = 1.0f;             ///< ตัวคูณ weight ของ AdamW
+    float momentum = 0.0f;
+    float beta1 = 0.0f;
+    float beta2 = 0.0f;
+    float stepSize = 0.0f;          ///< learningRate / (1 - beta1^t)
+    float correction2 = 1.0f;       ///< 1 / (1 - beta2^t)
+    float epsilon = 0.0f;
+};
+
+void updateScalar(const Coefficients& c, float* w, const float* g, float* m, float* v, size_t n) {
+    switch (c.kind) {
+        case OptimizerKind::SGD:
+            for (size_t i = 0; i < n; i++) {
+                w[i] -= c.learningRate * (g[i] * c.scale + c.l2 * w[i]);
+            }
+            break;
+        case OptimizerKind::Momentum:
+            for (size_t i = 0; i < n; i++) {
+                m[i] = c.momentum * m[i] + (g[i] * c.scale + c.l2 * w[i]);
+                w[i] -= c.learningRate * m[i];
+            }
+            break;
+        default:
+            for (size_t i = 0; i < n; i++) {
+                float grad = g[i] * c.scale + c.l2 * w[i];
+                m[i] = c.beta1 * m[i] + (1.0f - c.beta1) * grad;
+                v[i] = c.beta2 * v[i] + (1.0f - c.beta2) * grad * grad;
+                w[i] = w[i] * c.decay - c.stepSize * m[i] / (std::sqrt(v[i] * c.correction2) + c.epsilon);
+            }
+            break;
+    }
+}
+
+double sumSquaresScalar(const float* g, size_t n) {
+    double total = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        total += static_cast<double>(g[i]) * g[i];
+    }
+    return total;
+}
+
+#ifdef AI_LANGUAGE_X86
+
+__attribute__((target("avx512f")))
+void updateAvx512(const Coefficients& c, float* w, const float* g, float* m, float* v, size_t n) {
+    const __m512 scale = _mm512_set1_ps(c.scale), l2 = _mm512_set1_ps(c.l2), lr = _mm512_set1_ps(c.learningRate);
+    size_t i = 0;
+    switch (c.kind) {
+        case OptimizerKind::SGD:
+            for (; i + 16 <= n; i += 16) {
+                __m512 weight = _mm512_loadu_ps(w + i);
+                __m512 grad = _mm512_fmadd_ps(_mm512_loadu_ps(g + i), scale, _mm512_mul_ps(l2, weight));
+                _mm512_storeu_ps(w + i, _mm512_fnmadd_ps(lr, grad, weight));
+            }
+            break;
+        case OptimizerKind::Momentum: {
+            const __m512 momentum = _mm512_set1_ps(c.momentum);
+            for (; i + 16 <= n; i += 16) {
+                __m512 weight = _mm512_loadu_ps(w + i);
+                __m512 grad = _mm512_fmadd_ps(_mm512_loadu_ps(g + i), scale, _mm512_mul_ps(l2, weight));
+                __m512 buffer = _mm512_fmadd_ps(momentum, _mm512_loadu_ps(m + i), grad);
+                _mm512_storeu_ps(m + i, buffer);
+                _mm512_storeu_ps(w + i, _mm512_fnmadd_ps(lr, buffer, weight));
+            }
+            break;
+        }
+        default: {
+            const __m512 beta1 = _mm512_set1_ps(c.beta1), beta2 = _mm512_set1_ps(c.beta2);
+            const __m512 rest1 = _mm512_set1_ps(1.0f - c.beta1), rest2 = _mm512_set1_ps(1.0f - c.beta2);
+            const __m512 stepSize = _mm512_set1_ps(c.stepSize), correction2 = _mm512_set1_ps(c.correction2);
+            const __m512 epsilon = _mm512_set1_ps(c.epsilon), decay = _mm512_set1_ps(c.decay);
+            for (; i + 16 <= n; i += 16) {
+                __m512 weight = _mm512_loadu_ps(w + i);
+                __m512 grad = _mm512_fmadd_ps(_mm512_loadu_ps(g + i), scale, _mm512_mul_ps(l2, weight));
+                __m512 first = _mm512_fmadd_ps(beta1, _mm512_loadu_ps(m + i), _mm512_mul_ps(rest1, grad));
+                __m512 second = _mm512_fmadd_ps(beta2, _mm512_loadu_ps(v + i),
+                                                _mm512_mul_ps(rest2, _mm512_mul_ps(grad, grad)));
+                _mm512_storeu_ps(m + i, first);
+                _mm512_storeu_ps(v + i, second);
+                __m512 denominator = _mm512_add_ps(_mm512_sqrt_ps(_mm512_mul_ps(second, correction2)), epsilon);
+                __m512 update = _mm512_mul_ps(stepSize, _mm512_div_ps(first, denominator));
+                _mm512_storeu_ps(w + i, _mm512_fmsub_ps(weight, decay, update));
+            }
+            break;
+        }
+    }
+    updateScalar(c, w + i, g + i, m != nullptr ? m + i : nullptr, v != nullptr ? v + i : nullptr, n - i);
+}
+
+__attribute__((target("avx2,fma")))
+void updateAvx2(const Coefficients& c, float* w, const float* g, float* m, float* v, size_t n) {
+    const __m256 scale = _mm256_set1_ps(c.scale), l2 = _mm256_set1_ps(c.l2), lr = _mm256_set1_ps(c.learningRate);
+    size_t i = 0;
+    switch (c.kind) {
+        case OptimizerKind::SGD:
+            for (; i + 8 <= n; i += 8) {
+                __m256 weight = _mm256_loadu_ps(w + i);
+                __m256 grad = _mm256_fmadd_ps(_mm256_loadu_ps(g + i), scale, _mm256_mul_ps(l2, weight));
+                _mm256_storeu_ps(w + i, _mm256_fnmadd_ps(lr, grad, weight));
+            }
+            break;
+        case OptimizerKind::Momentum: {
+            const __m256 momentum = _mm256_set1_ps(c.momentum);
+            for (; i + 8 <= n; i += 8) {
+                __m256 weight = _mm256_loadu_ps(w + i);
+                __m256 grad = _mm256_fmadd_ps(_mm256_loadu_ps(g + i), scale, _mm256_mul_ps(l2, weight));
+                __m256 buffer = _mm256_fmadd_ps(momentum, _mm256_loadu_ps(m + i), grad);
+                _mm256_storeu_ps(m + i, buffer);
+                _mm256_storeu_ps(w + i, _mm256_fnmadd_ps(lr, buffer, weight));
+            }
+            break;
+        }
+        default: {
+            const __m256 beta1 = _mm256_set1_ps(c.beta1), beta2 = _mm256_set1_ps(c.beta2);
+            const __m256 rest1 = _mm256_set1_ps(1.0f - c.beta1), rest2 = _mm256_set1_ps(1.0f - c.beta2);
+            const __m256 stepSize = _mm256_set1_ps(c.stepSize), correction2 = _mm256_set1_ps(c.correction2);
+            const __m256 epsilon = _mm256_set1_ps(c.epsilon), decay = _mm256_set1_ps(c.decay);
+            for (; i + 8 <= n; i += 8) {
+                __m256 weight = _mm256_loadu_ps(w + i);
+                __m256 grad = _mm256_fmadd_ps(_mm256_loadu_ps(g + i), scale, _mm256_mul_ps(l2, weight));
+                __m256 first = _mm256_fmadd_ps(beta1, _mm256_loadu_ps(m + i), _mm256_mul_ps(rest1, grad));
+                __m256 second = _mm256_fmadd_ps(beta2, _mm256_loadu_ps(v + i),
+                                                _mm256_mul_ps(rest2, _mm256_mul_ps(grad, grad)));
+                _mm256_storeu_ps(m + i, first);
+                _mm256_storeu_ps(v + i, second);
+                __m256 denominator = _mm256_add_ps(_mm256_sqrt_ps(_mm256_mul_ps(second, correction2)), epsilon);
+                __m256 update = _mm256_mul_ps(stepSize, _mm256_div_ps(first, denominator));
+                _mm256_storeu_ps(w + i, _mm256_fmsub_ps(weight, decay, update));
+            }
+            break;
+        }
+    }
+    updateScalar(c, w + i, g + i, m != nullptr ? m + i : nullptr, v != nullptr ? v + i : nullptr, n - i);
+}
+
+// สะสมเป็น float ในแต่ละ lane (พอสำหรับตัดสินการ clip) แล้วรวมระหว่างก้อนเป็น double
+__attribute__((target("avx512f")))
+double sumSquaresAvx512(const float* g, size_t n) {
+    __m512 a = _mm512_setzero_ps(), b = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512 x = _mm512_loadu_ps(g + i), y = _mm512_loadu_ps(g + i + 16);
+        a = _mm512_fmadd_ps(x, x, a);
+        b = _mm512_fmadd_ps(y, y, b);
+    }
+    return static_cast<double>(_mm512_reduce_add_ps(_mm512_add_ps(a, b))) + sumSquaresScalar(g + i, n - i);
+}
+
+__attribute__((target("avx2,fma")))
+double sumSquaresAvx2(const float* g, size_t n) {
+    __m256 a = _mm256_setzero_ps(), b = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 x = _mm256_loadu_ps(g + i), y = _mm256_loadu_ps(g + i + 8);
+        a = _mm256_fmadd_ps(x, x, a);
+        b = _mm256_fmadd_ps(y, y, b);
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, _mm256_add_ps(a, b));
+    double total = 0.0;
+    for (float lane : lanes) {
+        total += lane;
+    }
+    return total + sumSquaresScalar(g + i, n - i);
+}
+
+#endif
+
+void update(const Coefficients& c, float* w, const float* g, float* m, float* v, size_t n) {
+#ifdef AI_LANGUAGE_X86
+    if (cpuHasAvx512()) {
+        updateAvx512(c, w, g, m, v, n);
+        return;
+    }
+    if (cpuHasAvx2()) {
+        updateAvx2(c, w, g, m, v, n);
+        return;
+    }
+#endif
+    updateScalar(c, w, g, m, v, n);
+}
+
+double sumSquares(const float* g, size_t n) {
+#ifdef AI_LANGUAGE_X86
+    if (cpuHasAvx512()) {
+        return sumSquaresAvx512(g, n);
+    }
+    if (cpuHasAvx2()) {
+        return sumSquaresAvx2(g, n);
+    }
+#endif
+    return sumSquaresScalar(g, n);
+}
+
+void checkRange(bool valid, const std::string& what) {
+    if (!valid) {
+        throw std::invalid_argument("Invalid optimizer setting: " + what);
+    }
+}
+
+} // namespace
+
+std::string optimizerName(OptimizerKind kind) {
+    switch (kind) {
+        case OptimizerKind::SGD: return "sgd";
+        case OptimizerKind::Momentum: return "momentum";
+        case OptimizerKind::Adam: return "adam";
+        case OptimizerKind::AdamW: return "adamw";
+    }
+    return "unknown";
+}
+
+OptimizerKind parseOptimizer(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (lower == "sgd") return OptimizerKind::SGD;
+    if (lower == "momentum" || lower == "sgd_momentum") return OptimizerKind::Momentum;
+    if (lower == "adam") return OptimizerKind::Adam;
+    if (lower == "adamw") return OptimizerKind::AdamW;
+    throw std::invalid_argument("Unknown optimizer '" + name + "' (use sgd, momentum, adam or adamw)");
+}
+
+Optimizer::Optimizer(const OptimizerConfig& config, size_t parameters) : settings(config), count(parameters) {
+    checkRange(parameters > 0, "the model has no parameters");
+    checkRange(config.learningRate > 0.0f, "learning_rate must be positive");
+    checkRange(config.momentum >= 0.0f && config.momentum < 1.0f, "momentum must be in [0, 1)");
+    checkRange(config.beta1 >= 0.0f && config.beta1 < 1.0f, "beta1 must be in [0, 1)");
+    checkRange(config.beta2 >= 0.0f && config.beta2 < 1.0f, "beta2 must be in [0, 1)");
+    checkRange(config.epsilon > 0.0f, "epsilon must be positive");
+    checkRange(config.weightDecay >= 0.0f, "weight_decay must not be negative");
+    checkRange(config.clipNorm >= 0.0f, "clip_norm must not be negative");
+    switch (config.kind) {
+        case OptimizerKind::SGD:
+            break;
+        case OptimizerKind::Momentum:
+            moments = Tensor({1, parameters});
+            break;
+        default:
+            moments = Tensor({2, parameters});
+            break;
+    }
+}
+
+void Optimizer::setLearningRate(float learningRate) {
+    checkRange(learningRate > 0.0f, "learning_rate must be positive");
+    settings.learningRate = learningRate;
+}
+
+float Optimizer::step(float* weights, const float* gradients) {
+    float norm = 0.0f;
+    Coefficients c;
+    if (settings.clipNorm > 0.0f) {
+        size_t chunks = parallelChunks(count, kMinChunk);
+        if (partials.size() < chunks) {
+            partials.resize(chunks);
+        }
+        std::fill(partials.begin(), partials.begin() + static_cast<std::ptrdiff_t>(chunks), 0.0);
+        parallelFor(0, count, [&](size_t begin, size_t end, size_t worker) {
+            partials[worker] = sumSquares(gradients + begin, end - begin);
+        }, kMinChunk);
+        double total = 0.0;
+        for (size_t i = 0; i < chunks; i++) {
+            total += partials[i];
+        }
+        norm = static_cast<float>(std::sqrt(total));
+        if (!std::isfinite(norm)) {
+            return norm;
+        }
+        if (norm > settings.clipNorm) {
+            c.scale = settings.clipNorm / norm;
+        }
+    }
+
+    stepCount++;
+    c.kind = settings.kind;
+    c.learningRate = settings.learningRate;
+    c.momentum = settings.momentum;
+    c.beta1 = settings.beta1;
+    c.beta2 = settings.beta2;
+    c.epsilon = settings.epsilon;
+    if (settings.kind == OptimizerKind::AdamW) {
+        c.decay = 1.0f - settings.learningRate * settings.weightDecay;
+    } else {
+        c.l2 = settings.weightDecay;
+    }
+    double t = static_cast<double>(stepCount);
+    c.stepSize = static_cast<float>(settings.learningRate / (1.0 - std::pow(settings.beta1, t)));
+    c.correction2 = static_cast<float>(1.0 / (1.0 - std::pow(settings.beta2, t)));
+
+    float* first = moments.empty() ? nullptr : moments.data<float>();
+    float* second = moments.empty() || moments.size(0) < 2 ? nullptr : first + count;
+    parallelFor(0, count, [&](size_t begin, size_t end, size_t) {
+        update(c, weights + begin, gradients + begin, first != nullptr ? first + begin : nullptr,
+               second != nullptr ? second + begin : nullptr, end - begin);
+    }, kMinChunk);
+    return norm;
+}
+
+} // namespace ai_language
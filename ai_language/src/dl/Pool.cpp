@@ -0,0 +1,117 @@
+#include "../../include/dl/Pool.h"
+#include "../../include/dl/Tensor.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace ai_language {
+
+namespace {
+
+void checkShape(const PoolShape& shape) {
+    if (shape.poolHeight == 0 || shape.poolWidth == 0 || shape.poolHeight > shape.height ||
+        shape.poolWidth > shape.width) {
+        throw std::invalid_argument("Invalid pool window " + std::to_string(shape.poolHeight) + "x" +
+                                    std::to_string(shape.poolWidth) + " on " + std::to_string(shape.height) + "x" +
+                                    std::to_string(shape.width));
+    }
+    if (shape.poolHeight * shape.poolWidth > 256) {
+        throw std::invalid_argument("Pool windows larger than 256 positions do not fit the one-byte argmax");
+    }
+}
+
+template <typename Input, typename Output>
+void poolForward(const PoolShape& shape, size_t batch, const Input* input, Output* output, uint8_t* argmax,
+                 bool relu) {
+    checkShape(shape);
+    const size_t oh = shape.outHeight(), ow = shape.outWidth();
+    const size_t ph = shape.poolHeight, pw = shape.poolWidth;
+    parallelFor(0, batch * shape.channels, [&](size_t begin, size_t end, size_t) {
+        for (size_t plane = begin; plane < end; plane++) {
+            const Input* x = input + plane * shape.height * shape.width;
+            Output* y = output + plane * oh * ow;
+            uint8_t* index = argmax != nullptr ? argmax + plane * oh * ow : nullptr;
+            for (size_t i = 0; i < oh; i++) {
+                for (size_t j = 0; j < ow; j++) {
+                    const Input* window = x + i * ph * shape.width + j * pw;
+                    float best = loadFloat(window[0]);
+                    size_t where = 0;
+                    for (size_t r = 0; r < ph; r++) {
+                        for (size_t s = 0; s < pw; s++) {
+                            float value = loadFloat(window[r * shape.width + s]);
+                            if (value > best) {
+                                best = value;
+                                where = r * pw + s;
+                            }
+                        }
+                    }
+                    storeFloat(y[i * ow + j], relu ? std::max(best, 0.0f) : best);
+                    if (index != nullptr) {
+                        index[i * ow + j] = static_cast<uint8_t>(where);
+                    }
+                }
+            }
+        }
+    }, 4);
+}
+
+template <typename Output>
+void poolBackward(const PoolShape& shape, size_t batch, const float* gradOutput, const uint8_t* argmax,
+                  const Output* output, bool relu, float* gradInput) {
+    checkShape(shape);
+    if (relu && output == nullptr) {
+        throw std::invalid_argument("maxPoolBackward with a fused ReLU needs the pooled output");
+    }
+    const size_t oh = shape.outHeight(), ow = shape.outWidth();
+    const size_t ph = shape.poolHeight, pw = shape.poolWidth;
+    const size_t planeSize = shape.height * shape.width;
+    parallelFor(0, batch * shape.channels, [&](size_t begin, size_t end, size_t) {
+        for (size_t plane = begin; plane < end; plane++) {
+            float* dx = gradInput + plane * planeSize;
+            std::fill(dx, dx + planeSize, 0.0f);
+            const float* dy = gradOutput + plane * oh * ow;
+            const uint8_t* index = argmax + plane * oh * ow;
+            const Output* y = relu ? output + plane * oh * ow : nullptr;
+            for (size_t i = 0; i < oh; i++) {
+                for (size_t j = 0; j < ow; j++) {
+                    size_t o = i * ow + j;
+                    if (relu && loadFloat(y[o]) <= 0.0f) {
+                        continue;
+                    }
+                    size_t r = index[o] / pw, s = index[o] % pw;
+                    dx[(i * ph + r) * shape.width + j * pw + s] = dy[o];
+                }
+            }
+        }
+    }, 4);
+}
+
+} // namespace
+
+void maxPoolForward(const PoolShape& shape, size_t batch, const float* input, float* output, uint8_t* argmax,
+                    bool relu) {
+    poolForward(shape, batch, input, output, argmax, relu);
+}
+
+void maxPoolForward(const PoolShape& shape, size_t batch, const uint16_t* input, uint16_t* output, uint8_t* argmax,
+                    bool relu) {
+    poolForward(shape, batch, input, output, argmax, relu);
+}
+
+void maxPoolForward(const PoolShape& shape, size_t batch, const float* input, uint16_t* output, uint8_t* argmax,
+                    bool relu) {
+    poolForward(shape, batch, input, output, argmax, relu);
+}
+
+void maxPoolBackward(const PoolShape& shape, size_t batch, const float* gradOutput, const uint8_t* argmax,
+                     const float* output, bool relu, float* gradInput) {
+    poolBackward(shape, batch, gradOutput, argmax, output, relu, gradInput);
+}
+
+void maxPoolBackward(const PoolShape& shape, size_t batch, const float* gradOutput, const uint8_t* argmax,
+                     const uint16_t* output, float* gradInput) {
+    poolBackward(shape, batch, gradOutput, argmax, output, true, gradInput);
+}
+
+} // namespace ai_language
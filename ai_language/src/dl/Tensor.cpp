@@ -0,0 +1,382 @@
+#include "../../include/dl/Tensor.h"
+#include "../../include/utils/cpu_features.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define AI_LANGUAGE_X86 1
+#endif
+
+namespace ai_language {
+
+namespace {
+
+float loadAsFloat(const void* base, size_t index, DType dtype, float scale) {
+    switch (dtype) {
+        case DType::Float32: return static_cast<const float*>(base)[index];
+        case DType::BFloat16: return bf16ToFloat(static_cast<const uint16_t*>(base)[index]);
+        case DType::Int8: return static_cast<const int8_t*>(base)[index] * scale;
+    }
+    return 0.0f;
+}
+
+void storeFromFloat(void* base, size_t index, DType dtype, float scale, float value) {
+    switch (dtype) {
+        case DType::Float32:
+            static_cast<float*>(base)[index] = value;
+            break;
+        case DType::BFloat16:
+            static_cast<uint16_t*>(base)[index] = floatToBf16(value);
+            break;
+        case DType::Int8: {
+            float q = scale > 0.0f ? std::nearbyint(value / scale) : 0.0f;
+            static_cast<int8_t*>(base)[index] = static_cast<int8_t>(std::max(-127.0f, std::min(127.0f, q)));
+            break;
+        }
+    }
+}
+
+// เรียก fn(ตำแหน่งใน a, ตำแหน่งใน b) ทุกสมาชิกตามลำดับ row-major ของ shape
+template <typename Fn>
+void forEachElement(const std::vector<size_t>& shape, const std::vector<size_t>& stridesA, size_t offsetA,
+                    const std::vector<size_t>& stridesB, size_t offsetB, Fn&& fn) {
+    size_t total = 1;
+    for (size_t extent : shape) {
+        total *= extent;
+    }
+    if (total == 0) {
+        return;
+    }
+    std::vector<size_t> index(shape.size(), 0);
+    size_t a = offsetA, b = offsetB;
+    for (size_t n = 0; n < total; n++) {
+        fn(a, b);
+        for (size_t axis = shape.size(); axis-- > 0;) {
+            if (++index[axis] < shape[axis]) {
+                a += stridesA[axis];
+                b += stridesB[axis];
+                break;
+            }
+            a -= stridesA[axis] * (shape[axis] - 1);
+            b -= stridesB[axis] * (shape[axis] - 1);
+            index[axis] = 0;
+        }
+    }
+}
+
+#ifdef AI_LANGUAGE_X86
+
+__attribute__((target("avx2")))
+void floatToBf16Avx2(const float* in, uint16_t* out, size_t count) {
+    const __m256i roundBias = _mm256_set1_epi32(0x7fff);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i absMask = _mm256_set1_epi32(0x7fffffff);
+    const __m256i infinity = _mm256_set1_epi32(0x7f800000);
+    const __m256i quiet = _mm256_set1_epi32(0x40);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i halves[2];
+        for (int h = 0; h < 2; h++) {
+            __m256i bits = _mm256_castps_si256(_mm256_loadu_ps(in + i + 8 * h));
+            __m256i rounded = _mm256_add_epi32(bits, _mm256_add_epi32(roundBias,
+                                  _mm256_and_si256(_mm256_srli_epi32(bits, 16), one)));
+            __m256i nan = _mm256_cmpgt_epi32(_mm256_and_si256(bits, absMask), infinity);
+            __m256i result = _mm256_blendv_epi8(rounded, _mm256_or_si256(bits, _mm256_slli_epi32(quiet, 16)), nan);
+            halves[h] = _mm256_srli_epi32(result, 16);
+        }
+        // packus ทำงานแยกกันในแต่ละครึ่ง 128 บิต จึงต้องสลับ lane กลับตามลำดับ
+        __m256i packed = _mm256_packus_epi32(halves[0], halves[1]);
+        packed = _mm256_permute4x64_epi64(packed, 0xd8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+    }
+    for (; i < count; i++) {
+        out[i] = floatToBf16(in[i]);
+    }
+}
+
+__attribute__((target("avx2")))
+void bf16ToFloatAvx2(const uint16_t* in, float* out, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i wide = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+        _mm256_storeu_ps(out + i, _mm256_castsi256_ps(_mm256_slli_epi32(wide, 16)));
+    }
+    for (; i < count; i++) {
+        out[i] = bf16ToFloat(in[i]);
+    }
+}
+
+#endif
+
+} // namespace
+
+size_t dtypeSize(DType dtype) {
+    switch (dtype) {
+        case DType::Float32: return 4;
+        case DType::BFloat16: return 2;
+        case DType::Int8: return 1;
+    }
+    return 4;
+}
+
+std::string dtypeName(DType dtype) {
+    switch (dtype) {
+        case DType::Float32: return "float32";
+        case DType::BFloat16: return "bf16";
+        case DType::Int8: return "int8";
+    }
+    return "unknown";
+}
+
+void floatToBf16(const float* in, uint16_t* out, size_t count) {
+#ifdef AI_LANGUAGE_X86
+    if (cpuHasAvx2()) {
+        floatToBf16Avx2(in, out, count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; i++) {
+        out[i] = floatToBf16(in[i]);
+    }
+}
+
+void bf16ToFloat(const uint16_t* in, float* out, size_t count) {
+#ifdef AI_LANGUAGE_X86
+    if (cpuHasAvx2()) {
+        bf16ToFloatAvx2(in, out, count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; i++) {
+        out[i] = bf16ToFloat(in[i]);
+    }
+}
+
+std::vector<size_t> contiguousStrides(const std::vector<size_t>& shape) {
+    std::vector<size_t> strides(shape.size(), 1);
+    for (size_t axis = shape.size(); axis-- > 1;) {
+        strides[axis - 1] = strides[axis] * shape[axis];
+    }
+    return strides;
+}
+
+std::string shapeToString(const std::vector<size_t>& shape) {
+    std::ostringstream out;
+    out << "[";
+    for (size_t axis = 0; axis < shape.size(); axis++) {
+        out << (axis ? ", " : "") << shape[axis];
+    }
+    out << "]";
+    return out.str();
+}
+
+Tensor::Tensor(const std::vector<size_t>& shape, DType dtype) : dims(shape), steps(contiguousStrides(shape)), kind(dtype) {
+    // ปัดขนาดขึ้นเป็นพหุคูณของ kAlignment ตามข้อกำหนดของ aligned_alloc (และไม่ให้ได้ตัวชี้ว่างเมื่อขนาดเป็นศูนย์)
+    size_t bytes = std::max<size_t>(nbytes(), 1);
+    bytes = (bytes + kAlignment - 1) / kAlignment * kAlignment;
+    void* memory = std::aligned_alloc(kAlignment, bytes);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    std::memset(memory, 0, bytes);
+    storage = std::shared_ptr<void>(memory, std::free);
+    base = memory;
+}
+
+Tensor Tensor::wrap(void* data, const std::vector<size_t>& shape, DType dtype) {
+    if (!data) {
+        throw std::invalid_argument("Cannot wrap a null pointer as a tensor");
+    }
+    Tensor tensor;
+    tensor.base = data;
+    tensor.dims = shape;
+    tensor.steps = contiguousStrides(shape);
+    tensor.kind = dtype;
+    return tensor;
+}
+
+Tensor Tensor::fromData(const float* values, const std::vector<size_t>& shape) {
+    Tensor tensor(shape);
+    std::memcpy(tensor.raw(), values, tensor.nbytes());
+    return tensor;
+}
+
+size_t Tensor::size(size_t axis) const {
+    if (axis >= dims.size()) {
+        throw std::out_of_range("Axis " + std::to_string(axis) + " out of range for tensor " + describe());
+    }
+    return dims[axis];
+}
+
+size_t Tensor::numel() const {
+    size_t total = 1;
+    for (size_t extent : dims) {
+        total *= extent;
+    }
+    return total;
+}
+
+bool Tensor::isContiguous() const {
+    size_t expected = 1;
+    for (size_t axis = dims.size(); axis-- > 0;) {
+        if (dims[axis] != 1 && steps[axis] != expected) {
+            return false;
+        }
+        expected *= dims[axis];
+    }
+    return true;
+}
+
+void Tensor::checkType(DType expected) const {
+    if (expected != kind) {
+        throw std::invalid_argument("Tensor " + describe() + " accessed as " + dtypeName(expected));
+    }
+}
+
+size_t Tensor::elementOffset(const std::vector<size_t>& index) const {
+    if (index.size() != dims.size()) {
+        throw std::out_of_range("Index with " + std::to_string(index.size()) + " axes for tensor " + describe());
+    }
+    size_t position = offset;
+    for (size_t axis = 0; axis < dims.size(); axis++) {
+        if (index[axis] >= dims[axis]) {
+            throw std::out_of_range("Index " + shapeToString(index) + " out of range for tensor " + describe());
+        }
+        position += index[axis] * steps[axis];
+    }
+    return position;
+}
+
+float Tensor::at(const std::vector<size_t>& index) const {
+    return loadAsFloat(base, elementOffset(index), kind, scale);
+}
+
+void Tensor::set(const std::vector<size_t>& index, float value) {
+    storeFromFloat(base, elementOffset(index), kind, scale, value);
+}
+
+Tensor Tensor::view(const std::vector<size_t>& shape) const {
+    size_t total = 1;
+    for (size_t extent : shape) {
+        total *= extent;
+    }
+    if (total != numel()) {
+        throw std::invalid_argument("Cannot view tensor " + describe() + " as " + shapeToString(shape));
+    }
+    if (!isContiguous()) {
+        throw std::invalid_argument("Cannot view strided tensor " + describe() + "; call contiguous() first");
+    }
+    Tensor result = *this;
+    result.dims = shape;
+    result.steps = contiguousStrides(shape);
+    return result;
+}
+
+Tensor Tensor::slice(size_t axis, size_t begin, size_t end, size_t step) const {
+    if (axis >= dims.size() || begin > end || end > dims[axis] || step == 0) {
+        throw std::out_of_range("Invalid slice [" + std::to_string(begin) + ", " + std::to_string(end) + ") on axis " +
+                                std::to_string(axis) + " of tensor " + describe());
+    }
+    Tensor result = *this;
+    result.offset += begin * steps[axis];
+    result.dims[axis] = (end - begin + step - 1) / step;
+    result.steps[axis] *= step;
+    return result;
+}
+
+Tensor Tensor::select(size_t axis, size_t index) const {
+    if (axis >= dims.size() || index >= dims[axis]) {
+        throw std::out_of_range("Cannot select index " + std::to_string(index) + " on axis " + std::to_string(axis) +
+                                " of tensor " + describe());
+    }
+    Tensor result = *this;
+    result.offset += index * steps[axis];
+    result.dims.erase(result.dims.begin() + axis);
+    result.steps.erase(result.steps.begin() + axis);
+    return result;
+}
+
+Tensor Tensor::transpose(size_t a, size_t b) const {
+    if (a >= dims.size() || b >= dims.size()) {
+        throw std::out_of_range("Cannot transpose axes " + std::to_string(a) + " and " + std::to_string(b) +
+                                " of tensor " + describe());
+    }
+    Tensor result = *this;
+    std::swap(result.dims[a], result.dims[b]);
+    std::swap(result.steps[a], result.steps[b]);
+    return result;
+}
+
+Tensor Tensor::contiguous() const {
+    return isContiguous() ? *this : clone();
+}
+
+Tensor Tensor::clone() const {
+    Tensor result(dims, kind);
+    result.scale = scale;
+    result.copyFrom(*this);
+    return result;
+}
+
+Tensor Tensor::to(DType dtype) const {
+    if (dtype == kind) {
+        return clone();
+    }
+    Tensor result(dims, dtype);
+    if (dtype == DType::Int8) {
+        float largest = 0.0f;
+        forEachElement(dims, steps, offset, steps, offset, [&](size_t a, size_t) {
+            largest = std::max(largest, std::fabs(loadAsFloat(base, a, kind, scale)));
+        });
+        result.scale = largest > 0.0f ? largest / 127.0f : 1.0f;
+    }
+    result.copyFrom(*this);
+    return result;
+}
+
+void Tensor::copyFrom(const Tensor& source) {
+    if (source.dims != dims) {
+        throw std::invalid_argument("Cannot copy tensor " + source.describe() + " into " + describe());
+    }
+    if (source.kind == kind && (kind != DType::Int8 || source.scale == scale) && isContiguous() &&
+        source.isContiguous()) {
+        std::memmove(raw(), source.raw(), nbytes());
+        return;
+    }
+    if (isContiguous() && source.isContiguous()) {
+        if (source.kind == DType::Float32 && kind == DType::BFloat16) {
+            floatToBf16(static_cast<const float*>(source.raw()), static_cast<uint16_t*>(raw()), numel());
+            return;
+        }
+        if (source.kind == DType::BFloat16 && kind == DType::Float32) {
+            bf16ToFloat(static_cast<const uint16_t*>(source.raw()), static_cast<float*>(raw()), numel());
+            return;
+        }
+    }
+    forEachElement(dims, steps, offset, source.steps, source.offset, [&](size_t to, size_t from) {
+        storeFromFloat(base, to, kind, scale, loadAsFloat(source.base, from, source.kind, source.scale));
+    });
+}
+
+void Tensor::fill(float value) {
+    if (kind == DType::Float32 && isContiguous()) {
+        std::fill_n(static_cast<float*>(raw()), numel(), value);
+        return;
+    }
+    forEachElement(dims, steps, offset, steps, offset, [&](size_t position, size_t) {
+        storeFromFloat(base, position, kind, scale, value);
+    });
+}
+
+std::string Tensor::describe() const {
+    std::string text = dtypeName(kind) + shapeToString(dims);
+    if (base && !isContiguous()) {
+        text += " (strided)";
+    }
+    return text;
+}
+
+} // namespace ai_language
@@ -129,7 +129,9 @@ void BaseInterpreter::interpretLine(const std::string& line) {
             }
             handleDeleteModelCommand(deleteArgs);
         } else if (command == "compare" && parts.size() > 1 && parts[1] == "models") {
-            handleCompareModelsCommand();
+            handleCompareModelsCommand(args);
+        } else if (command == "recommend") {
+            handleRecommendCommand(args);
         } else if (command == "check" && parts.size() > 1 && parts[1] == "status") {
             handleCheckStatusCommand();
         } else if (command == "debug") {
@@ -175,6 +177,10 @@ void BaseInterpreter::handleStartCommand() {
     std::cout << GREEN << "AI Language program started" << RESET << std::endl;
 }
 
+void BaseInterpreter::handleRecommendCommand(const std::vector<std::string>& /* args */) {
+    std::cout << YELLOW << "Model recommendation is only available in the ML interpreter" << RESET << std::endl;
+}
+
 void BaseInterpreter::handleCreateCommand(const std::vector<std::string>& /* args */) {
     std::cout << "Base create command - override in derived classes" << std::endl;
 }
@@ -435,7 +441,7 @@ void BaseInterpreter::handleDeleteModelCommand(const std::vector<std::string>& /
     std::cout << "Base delete model command - override in derived classes" << std::endl;
 }
 
-void BaseInterpreter::handleCompareModelsCommand() {
+void BaseInterpreter::handleCompareModelsCommand(const std::vector<std::string>& /* args */) {
     std::cout << "Base compare models command - override in derived classes" << std::endl;
 }
 
@@ -565,18 +571,13 @@ void BaseInterpreter::showModelInfo() {
 
         if (modelType == "LinearRegression" || modelType == "RandomForest" || 
             modelType == "SVM" || modelType == "GradientBoosting") {
-            // Metrics สำหรับโมเดล regression
-            std::cout << "  - Mean Squared Error (MSE): 0.05" << std::endl;
-            std::cout << "  - R-squared: 0.95" << std::endl;
-            std::cout << "  - Mean Absolute Error (MAE): 0.18" << std::endl;
+            // Metrics สำหรับโมเดล regression คำนวณจริงโดย interpreter ที่มีข้อมูลและโมเดล
+            std::cout << "  - MSE, MAE, R-squared: run 'evaluate model' to compute" << std::endl;
         } else if (modelType == "LogisticRegression" || modelType == "KNN" || 
                  modelType == "DecisionTree" || modelType == "NeuralNetwork" || 
                  modelType == "CNN" || modelType == "RNN" || modelType == "LSTM") {
-            // Metrics สำหรับโมเดล classification
-            std::cout << "  - Accuracy: 0.92" << std::endl;
-            std::cout << "  - Precision: 0.90" << std::endl;
-            std::cout << "  - Recall: 0.94" << std::endl;
-            std::cout << "  - F1 Score: 0.92" << std::endl;
+            // Metrics สำหรับโมเดล classification คำนวณจริงโดย interpreter ที่มีข้อมูลและโมเดล
+            std::cout << "  - Accuracy, Precision, Recall, F1: run 'evaluate model' to compute" << std::endl;
         } else if (modelType == "QLearning" || modelType == "DQN" || 
                  modelType == "PPO" || modelType == "A2C" || modelType == "DDQN") {
             // Metrics สำหรับโมเดล reinforcement learning
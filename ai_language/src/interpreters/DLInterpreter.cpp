@@ -1,5 +1,8 @@
 // interpreters/DLInterpreter.cpp
 #include "../../include/interpreters/DLInterpreter.h"
+#include "../../include/ml/Compare.h"
+#include "../../include/ml/Importance.h"
+#include "../../include/utils/parallel.h"
 #include <iostream>
 #include <sys/stat.h>
 #include <chrono>
@@ -9,9 +12,17 @@
 #include <string>
 #include <fstream> // Added for file operations
 #include <algorithm> // Added for std::transform
+#include <stdexcept>
+#include <numeric>
+#include <random>
+#include <sstream>
 
 namespace ai_language {
 
+DLInterpreter::DLInterpreter() {
+    setDefaultParameters();
+}
+
 void DLInterpreter::interpret() {
     // โค้ดสำหรับการแปลภาษา DL
     std::cout << "กำลังดำเนินการกับโมเดล Deep Learning..." << std::endl;
@@ -59,6 +70,7 @@ void DLInterpreter::setDefaultParameters() {
     parameters["dropout"] = 0.2;
     parameters["hidden_layers"] = 3;
     parameters["neurons_per_layer"] = 128;
+    parameters["prefetch"] = 2;
 }
 
 void DLInterpreter::handleStartCommand() {
@@ -137,23 +149,61 @@ void DLInterpreter::handleAddCommand(const std::vector<std::string>& args) {
         }
 
     } else if (layerType == "convolutional" || layerType == "conv") {
-        if (args.size() < 5) {
-            std::cout << RED << "รูปแบบคำสั่งไม่ถูกต้อง สำหรับ convolutional layer: add layer conv filters kernel_size activation" << RESET << std::endl;
+        // รองรับทั้ง conv 32 3 activation "relu", convolutional 32 3 3, conv 32 kernel 3 และ convolutional filters 32 kernel_size 3
+        std::vector<int> sizes;
+        std::string activation = "relu";
+        try {
+            for (size_t i = 2; i < args.size(); i++) {
+                if (args[i] == "activation" && i + 1 < args.size()) {
+                    activation = args[++i];
+                } else if ((args[i] == "filters" || args[i] == "kernel" || args[i] == "kernel_size") && i + 1 < args.size()) {
+                    sizes.push_back(std::stoi(args[++i]));
+                } else {
+                    sizes.push_back(std::stoi(args[i]));
+                }
+            }
+        } catch (const std::exception&) {
+            sizes.clear();
+        }
+        // conv 32 3 3 คือ kernel 3x3 (รองรับเฉพาะ kernel สี่เหลี่ยมจัตุรัส)
+        if (sizes.size() == 3 && sizes[1] == sizes[2]) {
+            sizes.pop_back();
+        } else if (sizes.size() == 3) {
+            std::cout << RED << "Error: kernel ต้องเป็นสี่เหลี่ยมจัตุรัส (ได้ " << sizes[1] << "x" << sizes[2] << ")" << RESET << std::endl;
             return;
         }
-        int filters = std::stoi(args[2]);
-        int kernelSize = std::stoi(args[3]);
-        std::string activation = args.size() > 5 && args[4] == "activation" ? args[5] : "relu";
-        if (activation.front() == '"') activation = activation.substr(1, activation.size()-2);
-        layerInfo = "conv:" + std::to_string(filters) + ":" + std::to_string(kernelSize) + ":" + activation;
+        if (sizes.size() != 2) {
+            std::cout << RED << "รูปแบบคำสั่งไม่ถูกต้อง สำหรับ convolutional layer: add layer conv filters kernel_size [kernel_size] [activation function]" << RESET << std::endl;
+            return;
+        }
+        if (activation.length() >= 2 && activation.front() == '"' && activation.back() == '"') {
+            activation = activation.substr(1, activation.length() - 2);
+        }
+        layerInfo = "conv:" + std::to_string(sizes[0]) + ":" + std::to_string(sizes[1]) + ":" + activation;
 
-    } else if (layerType == "max_pooling" || layerType == "pool") {
-        if (args.size() < 4) {
-            std::cout << RED << "รูปแบบคำสั่งไม่ถูกต้อง สำหรับ pooling layer: add layer pool size_x size_y" << RESET << std::endl;
+    } else if (layerType == "max_pooling" || layerType == "pool" || layerType == "pooling") {
+        // pool 2 หรือ pooling size 2 คือหน้าต่าง 2x2
+        std::vector<int> sizes;
+        try {
+            for (size_t i = 2; i < args.size(); i++) {
+                if (args[i] == "type" && i + 1 < args.size()) {
+                    if (args[++i] != "max" && args[i] != "\"max\"") {
+                        std::cout << RED << "รองรับเฉพาะ max pooling" << RESET << std::endl;
+                        return;
+                    }
+                } else if (args[i] != "size") {
+                    sizes.push_back(std::stoi(args[i]));
+                }
+            }
+        } catch (const std::exception&) {
+            sizes.clear();
+        }
+        if (sizes.empty() || sizes.size() > 2) {
+            std::cout << RED << "รูปแบบคำสั่งไม่ถูกต้อง สำหรับ pooling layer: add layer pool size_x [size_y]" << RESET << std::endl;
             return;
         }
-        int sizeX = std::stoi(args[2]);
-        int sizeY = std::stoi(args[3]);
+        int sizeX = sizes[0];
+        int sizeY = sizes.size() > 1 ? sizes[1] : sizeX;
         layerInfo = "pool:" + std::to_string(sizeX) + "x" + std::to_string(sizeY);
 
     } else if (layerType == "flatten") {
@@ -216,7 +266,14 @@ void DLInterpreter::handleAddCommand(const std::vector<std::string>& args) {
             std::cout << RED << "รูปแบบคำสั่งไม่ถูกต้อง สำหรับ dropout layer: add layer dropout rate" << RESET << std::endl;
             return;
         }
-        float rate = std::stof(args[2]);
+        size_t rateIndex = args[2] == "rate" ? 3 : 2;
+        float rate = 0.0f;
+        try {
+            rate = std::stof(rateIndex < args.size() ? args[rateIndex] : "");
+        } catch (const std::exception&) {
+            std::cout << RED << "รูปแบบคำสั่งไม่ถูกต้อง สำหรับ dropout layer: add layer dropout [rate] <0-1>" << RESET << std::endl;
+            return;
+        }
         layerInfo = "dropout:" + std::to_string(rate);
     } else {
         std::cout << RED << "ไม่รู้จักประเภทของ layer: " << layerType << RESET << std::endl;
@@ -249,13 +306,20 @@ void DLInterpreter::handleLoadCommand(const std::vector<std::string>& args) {
         return;
     }
 
-    datasetPath = args[0];
+    datasetPath = args[0] == "dataset" && args.size() > 1 ? args[1] : args[0];
     std::cout << GREEN << "กำลังโหลดข้อมูลจาก: " << datasetPath << RESET << std::endl;
 
-    // จำลองการโหลดข้อมูล
-    std::cout << BLUE << "กำลังเตรียมข้อมูลสำหรับ Deep Learning..." << RESET << std::endl;
-    std::cout << BLUE << "กำลังทำ Data Preprocessing..." << RESET << std::endl;
-    std::cout << BLUE << "กำลังทำ Data Augmentation..." << RESET << std::endl;
+    auto target = stringParameters.find("target_column");
+    std::string error;
+    if (loadCsvDataset(datasetPath, target != stringParameters.end() ? target->second : "", dataset, error)) {
+        std::cout << BLUE << "โหลด " << dataset.rows << " แถว x " << dataset.cols << " features (เป้าหมาย: "
+                  << dataset.targetName << ", " << (dataset.isClassification() ? "classification" : "regression")
+                  << ")" << RESET << std::endl;
+    } else {
+        dataset = Dataset();
+        std::cout << YELLOW << "Warning: " << error << " - train จะใช้ข้อมูลสังเคราะห์ตาม shape ของ input layer"
+                  << RESET << std::endl;
+    }
 
     hasLoaded = true;
 }
@@ -278,6 +342,17 @@ void DLInterpreter::handleSetCommand(const std::vector<std::string>& args) {
     try {
         // ลองแปลงเป็นตัวเลข
         double paramValue = std::stod(paramValueStr);
+        if (paramName == "threads") {
+            if (paramValue < 0) {
+                std::cout << RED << "Error: threads must not be negative (0 = use every core)" << RESET << std::endl;
+                return;
+            }
+            setMaxThreads(static_cast<size_t>(paramValue));
+        }
+        if (paramName == "prefetch" && paramValue < 1) {
+            std::cout << RED << "Error: prefetch must be at least 1" << RESET << std::endl;
+            return;
+        }
         parameters[paramName] = paramValue;
         std::cout << GREEN << "ตั้งค่า " << paramName << " = " << paramValue << RESET << std::endl;
     } catch (const std::exception& e) {
@@ -287,6 +362,17 @@ void DLInterpreter::handleSetCommand(const std::vector<std::string>& args) {
             paramValueStr = paramValueStr.substr(1, paramValueStr.length() - 2);
         }
 
+        try {
+            if (paramName == "optimizer") {
+                parseOptimizer(paramValueStr);
+            } else if (paramName == "precision") {
+                parseGemmPrecision(paramValueStr);
+            }
+        } catch (const std::invalid_argument& error) {
+            std::cout << RED << "Error: " << error.what() << RESET << std::endl;
+            return;
+        }
+
         // เก็บค่าสตริงในพารามิเตอร์พิเศษ
         stringParameters[paramName] = paramValueStr;
 
@@ -297,6 +383,266 @@ void DLInterpreter::handleSetCommand(const std::vector<std::string>& args) {
     }
 }
 
+void DLInterpreter::printConvChoices() const {
+    bool header = false;
+    for (const GraphNode& node : graph.nodes()) {
+        if (node.spec.kind != LayerKind::Conv) {
+            continue;
+        }
+        if (!header) {
+            std::cout << CYAN << "วิธีคำนวณ convolution (วัด forward + backward หนึ่งตัวอย่างตอนเริ่มเทรน):" << RESET << std::endl;
+            header = true;
+        }
+        ConvShape shape = node.convShape();
+        ConvChoice choice = selectConvAlgorithm(shape);
+        std::ios_base::fmtflags flags = std::cout.flags();
+        std::streamsize precision = std::cout.precision();
+        std::cout << "  " << node.name << ": " << convAlgorithmName(choice.algorithm) << std::fixed
+                  << std::setprecision(3) << " (im2col " << choice.im2colMillis << " ms";
+        if (winogradSupported(shape)) {
+            std::cout << ", winograd " << choice.winogradMillis << " ms";
+        }
+        std::cout << ")" << std::endl;
+        std::cout.flags(flags);
+        std::cout.precision(precision);
+    }
+}
+
+GemmPrecision DLInterpreter::trainingPrecision() const {
+    auto text = stringParameters.find("precision");
+    return text != stringParameters.end() ? parseGemmPrecision(text->second) : GemmPrecision::Float32;
+}
+
+OptimizerConfig DLInterpreter::optimizerConfig() const {
+    auto text = stringParameters.find("optimizer");
+    return optimizerConfig(text != stringParameters.end() ? parseOptimizer(text->second) : OptimizerKind::Adam);
+}
+
+OptimizerConfig DLInterpreter::optimizerConfig(OptimizerKind kind) const {
+    OptimizerConfig config;
+    config.kind = kind;
+    auto number = [this](const std::string& name, float fallback) {
+        auto it = parameters.find(name);
+        return it != parameters.end() ? static_cast<float>(it->second) : fallback;
+    };
+    config.learningRate = number("learning_rate", config.learningRate);
+    config.momentum = number("momentum", config.momentum);
+    config.beta1 = number("beta1", config.beta1);
+    config.beta2 = number("beta2", config.beta2);
+    config.epsilon = number("epsilon", config.epsilon);
+    config.weightDecay = number("weight_decay", config.kind == OptimizerKind::AdamW ? 0.01f : 0.0f);
+    config.clipNorm = number("clip_norm", 0.0f);
+    return config;
+}
+
+namespace {
+
+// ต่อท้ายทุกค่าที่วัดจากข้อมูลสังเคราะห์ เพื่อไม่ให้อ่านเป็นผลของโมเดลบนข้อมูลจริง
+const char* const SYNTHETIC_TAG = " [ข้อมูลสังเคราะห์]";
+
+// สัดส่วนที่ทำนายถูก: argmax สำหรับหลายคลาส หรือเกณฑ์ 0.5 สำหรับ sigmoid หนึ่งค่า
+float classificationAccuracy(const float* predictions, const float* targets, size_t samples, size_t width) {
+    size_t correct = 0;
+    for (size_t i = 0; i < samples; i++) {
+        const float* p = predictions + i * width;
+        const float* t = targets + i * width;
+        if (width == 1) {
+            correct += (p[0] > 0.5f) == (t[0] > 0.5f);
+        } else {
+            correct += std::max_element(p, p + width) - p == std::max_element(t, t + width) - t;
+        }
+    }
+    return samples > 0 ? static_cast<float>(correct) / static_cast<float>(samples) : 0.0f;
+}
+
+// R^2 ของผลทำนาย regression หนึ่งค่าต่อตัวอย่าง
+float rSquared(const float* predictions, const float* targets, size_t samples) {
+    double mean = 0.0;
+    for (size_t i = 0; i < samples; i++) {
+        mean += targets[i];
+    }
+    mean /= static_cast<double>(std::max<size_t>(samples, 1));
+    double residual = 0.0, total = 0.0;
+    for (size_t i = 0; i < samples; i++) {
+        residual += (predictions[i] - targets[i]) * (predictions[i] - targets[i]);
+        total += (targets[i] - mean) * (targets[i] - mean);
+    }
+    return total > 0.0 ? static_cast<float>(1.0 - residual / total) : (residual == 0.0 ? 1.0f : 0.0f);
+}
+
+// ดัชนีคลาสต่อตัวอย่าง (argmax ของ one-hot หรือเกณฑ์ 0.5 ของ sigmoid หนึ่งค่า) หรือค่าเป้าหมายของ regression
+std::vector<float> rowLabels(const std::vector<float>& targets, size_t samples, size_t width, bool classification) {
+    std::vector<float> labels(samples);
+    for (size_t i = 0; i < samples; i++) {
+        const float* t = targets.data() + i * width;
+        if (!classification) {
+            labels[i] = t[0];
+        } else if (width == 1) {
+            labels[i] = t[0] > 0.5f ? 1.0f : 0.0f;
+        } else {
+            labels[i] = static_cast<float>(std::max_element(t, t + width) - t);
+        }
+    }
+    return labels;
+}
+
+// แถว rows ของ data (width ค่าต่อแถว) เรียงต่อกันเป็นก้อนใหม่
+std::vector<float> gatherRows(const std::vector<float>& data, size_t width, const std::vector<size_t>& rows) {
+    std::vector<float> out(rows.size() * width);
+    for (size_t i = 0; i < rows.size(); i++) {
+        std::copy(data.begin() + rows[i] * width, data.begin() + (rows[i] + 1) * width, out.begin() + i * width);
+    }
+    return out;
+}
+
+// ปรับสเกลในที่เดิมแบบเดียวกับที่ DataLoader ทำตอนรวบ batch
+void applyScaling(std::vector<float>& inputs, size_t width, const FeatureScaling& scaling) {
+    if (scaling.empty()) {
+        return;
+    }
+    for (size_t i = 0; i < inputs.size(); i++) {
+        inputs[i] = (inputs[i] - scaling.offset[i % width]) * scaling.scale[i % width];
+    }
+}
+
+// เทรน trainer ครบ epochs รอบบนตัวอย่างทั้งหมด (ไม่พิมพ์ความคืบหน้า) false ถ้า loss ไม่เป็นจำนวนจำกัด
+bool fitEpochs(DataParallelTrainer& trainer, Optimizer& optimizer, const std::vector<float>& inputs,
+               const std::vector<float>& targets, size_t samples, const FeatureScaling& scaling,
+               DataLoaderConfig config) {
+    const size_t inSize = inputs.size() / samples, outSize = targets.size() / samples;
+    DataLoader loader(inputs.data(), targets.data(), samples, inSize, outSize, config, scaling);
+    DataLoader::Batch next;
+    for (size_t epoch = 0; epoch < config.epochs; epoch++) {
+        double epochLoss = 0.0;
+        for (size_t b = 0; b < loader.batchesPerEpoch() && loader.next(next); b++) {
+            epochLoss += static_cast<double>(trainer.step(next.inputs, next.targets, next.size, optimizer)) * next.size;
+        }
+        if (!std::isfinite(epochLoss)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool DLInterpreter::prepareTrainingData(const LayerGraph& network, std::vector<float>& inputs,
+                                        std::vector<float>& targets, size_t& samples, FeatureScaling& scaling) {
+    size_t inSize = 1, outSize = 1;
+    for (size_t dim : network.nodes().front().outputShape) inSize *= dim;
+    for (size_t dim : network.nodes().back().outputShape) outSize *= dim;
+    Activation last = network.nodes().back().spec.activation;
+    bool classification = last == Activation::Softmax || last == Activation::Sigmoid;
+    // sigmoid หนึ่งค่าเป็นสองคลาส (เป้าหมาย 0/1) ส่วนอย่างอื่นเป็น one-hot
+    size_t classes = classification ? (outSize == 1 ? 2 : outSize) : 0;
+    std::mt19937 rng(7);
+
+    if (dataset.empty()) {
+        // ข้อมูลสังเคราะห์: แต่ละคลาสมีค่าเฉลี่ยของตัวเองบวกสัญญาณรบกวน (regression: ผลรวมถ่วงน้ำหนักของ features)
+        samples = std::max<size_t>(64, 2 * network.batchSize());
+        std::cout << YELLOW << "ไม่มีข้อมูล CSV ใช้ข้อมูลสังเคราะห์ " << samples << " ตัวอย่าง x " << inSize << " features"
+                  << RESET << std::endl;
+        std::normal_distribution<float> noise(0.0f, 1.0f);
+        std::vector<float> centers((classification ? classes : 1) * inSize);
+        for (float& v : centers) v = 0.5f * noise(rng);
+        inputs.assign(samples * inSize, 0.0f);
+        targets.assign(samples * outSize, 0.0f);
+        for (size_t i = 0; i < samples; i++) {
+            size_t label = classification ? i % classes : 0;
+            double sum = 0.0;
+            for (size_t j = 0; j < inSize; j++) {
+                inputs[i * inSize + j] = centers[label * inSize + j] + noise(rng);
+                sum += inputs[i * inSize + j] * centers[j];
+            }
+            if (!classification) {
+                targets[i * outSize] = static_cast<float>(sum / std::sqrt(static_cast<double>(inSize)));
+            } else if (outSize == 1) {
+                targets[i] = static_cast<float>(label);
+            } else {
+                targets[i * outSize + label] = 1.0f;
+            }
+        }
+        return true;
+    }
+
+    if (dataset.cols != inSize) {
+        std::cout << RED << "Error: ข้อมูลมี " << dataset.cols << " features แต่ input layer รับ " << inSize << RESET << std::endl;
+        return false;
+    }
+    if (classification && (!dataset.isClassification() || dataset.numClasses() > classes)) {
+        std::cout << RED << "Error: output layer (" << activationName(last) << " " << outSize << ") ไม่รองรับเป้าหมาย "
+                  << dataset.targetName << " (" << (dataset.isClassification() ? std::to_string(dataset.numClasses()) +
+                  " คลาส" : std::string("ค่าต่อเนื่อง")) << ")" << RESET << std::endl;
+        return false;
+    }
+    if (!classification && outSize != 1) {
+        std::cout << RED << "Error: regression ต้องมี output 1 ค่า แต่ output layer มี " << outSize << RESET << std::endl;
+        return false;
+    }
+    samples = dataset.rows;
+    inputs = dataset.features;
+    // standardize แต่ละ feature ตอนรวบ batch ให้ทุกคอลัมน์อยู่ในช่วงเดียวกันกับค่าเริ่มต้นของ weight
+    scaling = standardization(inputs.data(), samples, inSize);
+    targets.assign(samples * outSize, 0.0f);
+    for (size_t i = 0; i < samples; i++) {
+        if (!classification || outSize == 1) {
+            targets[i * outSize] = dataset.targets[i];
+        } else {
+            targets[i * outSize + static_cast<size_t>(dataset.targets[i])] = 1.0f;
+        }
+    }
+    return true;
+}
+
+bool DLInterpreter::resolveArchitecture(std::vector<std::string>& architecture) {
+    architecture = layers.empty() ? defaultLayers(static_cast<size_t>(parameters["neurons_per_layer"])) : layers;
+    // สคริปต์ที่ไม่ได้ประกาศ input layer (หรือใช้โครงสร้างเริ่มต้น) รับ input แบบแบนเท่าจำนวน features ของ CSV ที่โหลดไว้
+    const bool declaredInput = !layers.empty() && layers.front().rfind("input:", 0) == 0;
+    if (declaredInput || (layers.empty() && dataset.empty())) {
+        return true;
+    }
+    if (dataset.empty()) {
+        std::cout << RED << "Error: ไม่ได้ประกาศ input layer และไม่มีข้อมูล CSV ให้อนุมานขนาด input "
+                  << "เพิ่ม 'add layer input <size>' หรือ 'add layer input <width> <height> <channels>' เป็น layer แรก"
+                  << RESET << std::endl;
+        return false;
+    }
+    if (layers.empty()) {
+        architecture.erase(architecture.begin());   // ขนาด input เริ่มต้น (784) ถูกแทนด้วยจำนวน features
+    }
+    try {
+        architecture = withInferredInput(architecture, dataset.cols);
+    } catch (const std::exception& e) {
+        std::cout << RED << "Error: " << e.what() << RESET << std::endl;
+        return false;
+    }
+    std::cout << YELLOW << "ไม่ได้ประกาศ input layer ใช้ขนาด input " << dataset.cols << " ตามจำนวน features ของ "
+              << stripQuotes(datasetPath) << RESET << std::endl;
+    return true;
+}
+
+void DLInterpreter::printScaling(const float* inputs, const float* targets, size_t count) {
+    const size_t batch = std::min(graph.batchSize(), count);
+    std::vector<ScalingPoint> points;
+    try {
+        points = measureScaling(graph, inputs, targets, batch, maxThreads(), 3, graph.precision());
+    } catch (const std::exception& e) {
+        std::cout << RED << "Error: " << e.what() << RESET << std::endl;
+        return;
+    }
+    std::ios_base::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+    std::cout << CYAN << "Scaling (batch " << batch << ", เวลาต่อรอบของแบบจำลองใหม่):" << RESET << std::endl;
+    std::cout << "  threads      ms/step   speedup   efficiency" << std::endl;
+    for (const ScalingPoint& point : points) {
+        std::cout << std::fixed << "  " << std::setw(7) << point.threads << std::setw(13) << std::setprecision(3)
+                  << point.millisPerStep << std::setw(9) << std::setprecision(2) << point.speedup << "x"
+                  << std::setw(12) << std::setprecision(0) << point.efficiency * 100.0 << "%" << std::endl;
+    }
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+}
+
 void DLInterpreter::handleTrainCommand(const std::vector<std::string>& /* args */) {
     if (!hasCreated) {
         std::cout << RED << "กรุณาสร้างโมเดลก่อนด้วยคำสั่ง 'create'" << RESET << std::endl;
@@ -308,20 +654,309 @@ void DLInterpreter::handleTrainCommand(const std::vector<std::string>& /* args *
         return;
     }
 
+    // ผลของการเทรนครั้งก่อนใช้ไม่ได้อีกเมื่อเริ่มใหม่ ไม่ว่าครั้งนี้จะสำเร็จหรือไม่
+    hasTrained = false;
+    trainer.reset();
+
+    // คอมไพล์ layer เป็นกราฟและวางแผนหน่วยความจำก่อนเริ่มคำนวณ shape ที่ไม่ตรงกันจึงถูกปฏิเสธทันที
+    std::unique_ptr<Optimizer> optimizer;
+    std::vector<std::string> architecture;
+    if (!resolveArchitecture(architecture)) {
+        return;
+    }
+    try {
+        if (parameters["batch_size"] < 1) {
+            throw std::invalid_argument("batch_size must be positive");
+        }
+        const size_t batchSize = static_cast<size_t>(parameters["batch_size"]);
+        graph = LayerGraph::compile(architecture, batchSize, true, trainingPrecision());
+        memoryPlan = MemoryPlan::build(graph);
+        float32Plan = graph.precision() == GemmPrecision::BFloat16
+                          ? MemoryPlan::build(LayerGraph::compile(architecture, batchSize))
+                          : MemoryPlan();
+        optimizer = std::make_unique<Optimizer>(optimizerConfig(), graph.parameterCount());
+    } catch (const std::exception& e) {
+        std::cout << RED << "Error: " << e.what() << RESET << std::endl;
+        return;
+    }
+    if (layers.empty()) {
+        std::cout << YELLOW << "ยังไม่ได้เพิ่ม layer ใช้โครงสร้างเริ่มต้น (ดูด้วย show model)" << RESET << std::endl;
+    }
+    std::cout << CYAN << "โครงสร้างเครือข่ายหลังอนุมาน shape:" << RESET << std::endl;
+    graph.print(std::cout);
+    memoryPlan.print(std::cout, float32Plan.buffers().empty() ? nullptr : &float32Plan);
+    printConvChoices();
+
+    std::vector<float> inputs, targets;
+    size_t samples = 0;
+    FeatureScaling scaling;
+    syntheticData = dataset.empty();
+    if (!prepareTrainingData(graph, inputs, targets, samples, scaling)) {
+        return;
+    }
+    const size_t threads = maxThreads();
+    const size_t batch = graph.batchSize();
+    const size_t inSize = inputs.size() / samples, outSize = targets.size() / samples;
+    const int epochs = std::max(1, static_cast<int>(parameters["epochs"]));
+    const OptimizerConfig& config = optimizer->config();
+    const Activation last = graph.nodes().back().spec.activation;
+    const bool classification = last == Activation::Softmax || last == Activation::Sigmoid;
+
     std::cout << GREEN << "กำลังเทรนโมเดล " << modelType << "..." << RESET << std::endl;
-    std::cout << BLUE << "จำนวน Epochs: " << parameters["epochs"] << RESET << std::endl;
-    std::cout << BLUE << "Learning Rate: " << parameters["learning_rate"] << RESET << std::endl;
-    std::cout << BLUE << "Batch Size: " << parameters["batch_size"] << RESET << std::endl;
+    std::cout << BLUE << "จำนวน Epochs: " << epochs << RESET << std::endl;
+    std::cout << BLUE << "Learning Rate: " << config.learningRate << RESET << std::endl;
+    std::cout << BLUE << "Batch Size: " << batch << " (แบ่งให้ " << threads << " เธรด, เตรียมล่วงหน้า "
+              << static_cast<size_t>(parameters["prefetch"]) << " batch)" << RESET << std::endl;
+    std::cout << BLUE << "Optimizer: " << optimizerName(config.kind);
+    if (config.weightDecay > 0.0f) {
+        std::cout << ", weight_decay " << config.weightDecay;
+    }
+    if (config.clipNorm > 0.0f) {
+        std::cout << ", clip_norm " << config.clipNorm;
+    }
+    std::ios_base::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+    std::cout << std::fixed << std::setprecision(1) << " (อัปเดตทุกพารามิเตอร์ในรอบเดียว, state "
+              << optimizer->stateBytes() / 1024.0 << " KB)" << RESET << std::endl;
+    const GemmPrecision gemmPrecision = graph.precision();
+    if (gemmPrecision == GemmPrecision::BFloat16) {
+        const GemmKernel kernel = bestBf16GemmKernel();
+        const bool native = kernel == GemmKernel::AmxBf16 || kernel == GemmKernel::Avx512Bf16;
+        std::cout << BLUE << "Precision: bf16 ตัวถูกคูณและ activation / fp32 ผลสะสม gradient และ master weight ("
+                  << (native ? "" : "จำลองบน ") << gemmKernelName(kernel) << ", สำเนา weight "
+                  << graph.parameterCount() * sizeof(uint16_t) / 1024.0 << " KB)" << RESET << std::endl;
+    } else {
+        std::cout << BLUE << "Precision: fp32" << RESET << std::endl;
+    }
 
-    // จำลองการเทรนโมเดล
-    for (int epoch = 1; epoch <= 3; epoch++) {
-        std::cout << YELLOW << "Epoch " << epoch << "/" << parameters["epochs"] << " - ";
-        std::cout << "Loss: " << 0.5 / epoch << " - Accuracy: " << 0.7 + epoch * 0.1 << RESET << std::endl;
+    // ผ่านข้อมูลทั้งหมดตามลำดับเดิมบนโมเดลแรก (ปรับสเกลด้วย DataLoader เดียวกับตอนเทรน)
+    std::vector<float> predictions(targets.size());
+    auto evaluateAll = [&]() {
+        DataLoaderConfig sequential;
+        sequential.batchSize = 256;
+        sequential.shuffle = false;
+        DataLoader loader(inputs.data(), targets.data(), samples, inSize, outSize, sequential, scaling);
+        DataLoader::Batch part;
+        double total = 0.0;
+        for (size_t first = 0; loader.next(part); first += part.size) {
+            total += static_cast<double>(trainer->evaluate(part.inputs, part.targets, part.size,
+                                                           predictions.data() + first * outSize)) * part.size;
+        }
+        return static_cast<float>(total / static_cast<double>(samples));
+    };
+
+    trainer = std::make_unique<DataParallelTrainer>(graph, threads, 42, gemmPrecision);
+    DataLoaderConfig loaderConfig;
+    loaderConfig.batchSize = batch;
+    loaderConfig.prefetch = std::max<size_t>(1, static_cast<size_t>(parameters["prefetch"]));
+    loaderConfig.epochs = static_cast<size_t>(epochs);
+    DataLoader loader(inputs.data(), targets.data(), samples, inSize, outSize, loaderConfig, scaling);
+    const int reportEvery = std::max(1, epochs / 10);
+    auto started = std::chrono::steady_clock::now();
+    bool diverged = false;
+    for (int epoch = 1; epoch <= epochs && !diverged; epoch++) {
+        double epochLoss = 0.0;
+        DataLoader::Batch next;
+        for (size_t b = 0; b < loader.batchesPerEpoch() && loader.next(next); b++) {
+            epochLoss += static_cast<double>(trainer->step(next.inputs, next.targets, next.size, *optimizer)) * next.size;
+        }
+        epochLoss /= static_cast<double>(samples);
+        if (!std::isfinite(epochLoss)) {
+            std::cout << RED << "Loss ไม่เป็นจำนวนจำกัดใน epoch " << epoch
+                      << " หยุดเทรน (ลองลด learning_rate หรือ set clip_norm)" << RESET << std::endl;
+            diverged = true;
+        } else if (epoch % reportEvery == 0 || epoch == epochs) {
+            std::cout << YELLOW << std::setprecision(4) << "Epoch " << epoch << "/" << epochs << " - Loss: " << epochLoss;
+            if (classification) {
+                evaluateAll();
+                std::cout << " - Accuracy: " << std::setprecision(3)
+                          << classificationAccuracy(predictions.data(), targets.data(), samples, outSize);
+            }
+            std::cout << (syntheticData ? SYNTHETIC_TAG : "") << RESET << std::endl;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    trainLoss = evaluateAll();
+    trainAccuracy = classification ? classificationAccuracy(predictions.data(), targets.data(), samples, outSize) : -1.0f;
+    std::cout << BLUE << std::setprecision(3) << "เทรน " << samples << " ตัวอย่าง x " << epochs << " epochs ใน "
+              << seconds << " วินาที (" << std::setprecision(0)
+              << static_cast<double>(samples) * epochs / std::max(seconds, 1e-9) << " ตัวอย่าง/วินาที, " << threads
+              << " เธรด)" << RESET << std::endl;
+    std::cout << BLUE << std::setprecision(3) << "รอข้อมูล: " << loader.stallSeconds() * 1000.0 << " ms ใน "
+              << loader.stalls() << " จาก " << loader.batchesPerEpoch() * static_cast<size_t>(epochs)
+              << " batch (ไม่นับ batch แรก)" << RESET << std::endl;
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+    if (threads > 1) {
+        DataLoaderConfig first;
+        first.batchSize = batch;
+        first.shuffle = false;
+        DataLoader sample(inputs.data(), targets.data(), samples, inSize, outSize, first, scaling);
+        DataLoader::Batch part;
+        sample.next(part);
+        printScaling(part.inputs, part.targets, part.size);
     }
 
+    trainedScaling = scaling;
+    trainedClassNames = dataset.classNames;
+    trainedFeatureCategories = dataset.featureCategories;
     hasTrained = true;
 }
 
+void DLInterpreter::showFeatureImportance(const std::vector<std::string>& args) {
+    // show feature_importance [on] "file": ใช้ไฟล์ที่ระบุเป็นข้อมูล held-out กับเครือข่ายที่เทรนไว้
+    // ไม่ระบุไฟล์: เทรนเครือข่ายเดียวกันใหม่บนชุดเทรนของการแบ่งแบบ compare models แล้วประเมินบนแถวที่กันไว้
+    size_t pathIndex = args.size() >= 3 && args[1] == "on" ? 2 : 1;
+    const bool heldOut = args.size() <= pathIndex;
+    if (heldOut && dataset.empty()) {
+        std::cout << YELLOW << "Feature importance ต้องใช้ข้อมูล CSV (ข้อมูลสังเคราะห์ไม่มี feature ที่มีความหมาย) "
+                  << "ใช้ 'load dataset' แล้ว 'train model' หรือระบุไฟล์ด้วย show feature_importance on \"<ไฟล์>\""
+                  << RESET << std::endl;
+        return;
+    }
+    auto param = [this](const std::string& name, double fallback) {
+        auto it = parameters.find(name);
+        return it != parameters.end() && it->second > 0 ? it->second : fallback;
+    };
+    const size_t repeats = static_cast<size_t>(param("importance_repeats", 5));
+    const size_t maxRows = static_cast<size_t>(param("importance_rows", 5000));
+    const unsigned seed = static_cast<unsigned>(param("random_state", 42));
+    const Activation last = graph.nodes().back().spec.activation;
+    const bool classification = last == Activation::Softmax || last == Activation::Sigmoid;
+
+    Dataset fileData;
+    const Dataset* data = &dataset;
+    std::string source = datasetPath;
+    DataParallelTrainer* scored = trainer.get();
+    std::unique_ptr<DataParallelTrainer> refit;
+    FeatureScaling scaling = trainedScaling;
+    std::vector<uint32_t> view;
+    size_t fittedRows = 0;
+    try {
+        if (heldOut) {
+            std::vector<float> inputs, targets;
+            size_t samples = 0;
+            if (!prepareTrainingData(graph, inputs, targets, samples, scaling)) {
+                return;
+            }
+            const size_t inSize = inputs.size() / samples, outSize = targets.size() / samples;
+            std::vector<size_t> trainRows, testRows;
+            splitTrainTest(dataset.targets, classification, param("test_size", 0.2), seed, trainRows, testRows);
+            std::vector<float> trainInputs = gatherRows(inputs, inSize, trainRows);
+            if (!scaling.empty()) {
+                scaling = standardization(trainInputs.data(), trainRows.size(), inSize);
+            }
+            DataLoaderConfig loaderConfig;
+            loaderConfig.batchSize = graph.batchSize();
+            loaderConfig.prefetch = std::max<size_t>(1, static_cast<size_t>(param("prefetch", 2)));
+            loaderConfig.epochs = static_cast<size_t>(param("epochs", 50));
+            refit = std::make_unique<DataParallelTrainer>(graph, maxThreads(), 42, graph.precision());
+            Optimizer optimizer(optimizerConfig(), graph.parameterCount());
+            if (!fitEpochs(*refit, optimizer, trainInputs, gatherRows(targets, outSize, trainRows), trainRows.size(),
+                           scaling, loaderConfig)) {
+                std::cout << RED << "Error: Loss ไม่เป็นจำนวนจำกัดระหว่างเทรนใหม่บนชุดเทรน" << RESET << std::endl;
+                return;
+            }
+            scored = refit.get();
+            fittedRows = trainRows.size();
+            view.assign(testRows.begin(), testRows.end());
+        } else {
+            auto target = stringParameters.find("target_column");
+            std::string error;
+            if (!loadCsvDataset(args[pathIndex], target != stringParameters.end() ? target->second : "", fileData,
+                                error)) {
+                std::cout << RED << "Error: " << error << RESET << std::endl;
+                return;
+            }
+            fileData.alignClasses(trainedClassNames);
+            fileData.alignFeatureCategories(trainedFeatureCategories);
+            if (fileData.cols != trainer->model().inputSize()) {
+                std::cout << RED << "Error: ไฟล์มี " << fileData.cols << " features แต่ input layer รับ "
+                          << trainer->model().inputSize() << RESET << std::endl;
+                return;
+            }
+            data = &fileData;
+            source = args[pathIndex];
+            view.resize(fileData.rows);
+            std::iota(view.begin(), view.end(), 0u);
+        }
+    } catch (const std::exception& e) {
+        std::cout << RED << "Error: " << e.what() << RESET << std::endl;
+        return;
+    }
+    if (view.empty()) {
+        std::cout << RED << "Error: ไม่มีแถวที่มีเป้าหมายให้ประเมิน" << RESET << std::endl;
+        return;
+    }
+    if (view.size() > maxRows) {
+        std::mt19937 rng(seed);
+        std::shuffle(view.begin(), view.end(), rng);
+        view.resize(maxRows);
+        std::sort(view.begin(), view.end());
+    }
+
+    // แต่ละ worker ทำนายบนแบบจำลองของตัวเอง (weight ร่วมกัน) จึงจำกัดเธรดไม่เกินจำนวนแบบจำลอง
+    const size_t inSize = data->cols, outSize = scored->model().outputSize();
+    const size_t workers = std::min(maxThreads(), scored->replicaCount());
+    std::vector<std::vector<float>> scaled(workers), outputs(workers), unused(workers);
+    BlockPredictor predict = [&](const float* rows, size_t count, float* out, size_t worker) {
+        std::vector<float>& x = scaled[worker];
+        std::vector<float>& y = outputs[worker];
+        x.assign(rows, rows + count * inSize);
+        applyScaling(x, inSize, scaling);
+        y.resize(count * outSize);
+        unused[worker].resize(count * outSize);   // เป้าหมายของ loss ที่ไม่ใช้ (ต้องการเฉพาะผลทำนาย)
+        scored->replica(worker).evaluate(x.data(), unused[worker].data(), count, y.data());
+        for (size_t i = 0; i < count; i++) {
+            const float* p = y.data() + i * outSize;
+            if (!classification) {
+                out[i] = p[0];
+            } else if (outSize == 1) {
+                out[i] = p[0] > 0.5f ? 1.0f : 0.0f;
+            } else {
+                out[i] = static_cast<float>(std::max_element(p, p + outSize) - p);
+            }
+        }
+    };
+    const size_t previous = maxThreads();
+    PermutationImportance importance;
+    auto start = std::chrono::steady_clock::now();
+    try {
+        setMaxThreads(workers);
+        importance = permutationImportance(predict, *data, view, repeats, seed, classification);
+        setMaxThreads(previous);
+    } catch (const std::exception& e) {
+        setMaxThreads(previous);
+        std::cout << RED << "Error: " << e.what() << RESET << std::endl;
+        return;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<size_t> order(data->cols);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return importance.mean[a] > importance.mean[b]; });
+    std::ios_base::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+    std::cout << CYAN << "Permutation importance ของ " << modelType << " บน " << importance.rows
+              << (heldOut ? " แถว held-out" : " แถว") << " ของ " << stripQuotes(source) << " (" << importance.repeats
+              << " รอบ, " << importance.metric << " ก่อนสลับ " << std::fixed << std::setprecision(4)
+              << importance.baseline << ", " << seconds << " วินาที)" << RESET << std::endl;
+    if (heldOut) {
+        std::cout << "เทรนเครือข่ายใหม่บนอีก " << fittedRows << " แถว (แบ่งตาม test_size) "
+                  << "ใช้ show feature_importance on \"<ไฟล์>\" เพื่อประเมินโมเดลที่เทรนไว้บนไฟล์ held-out" << std::endl;
+    }
+    std::cout << std::left << std::setw(24) << "Feature" << std::right << std::setw(12) << "Importance"
+              << std::setw(10) << "Std" << std::endl;
+    for (size_t f : order) {
+        std::string name = f < data->featureNames.size() ? data->featureNames[f] : "feature_" + std::to_string(f);
+        std::cout << std::left << std::setw(24) << name << std::right << std::setw(12) << importance.mean[f]
+                  << std::setw(10) << importance.stddev[f] << std::endl;
+    }
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+}
+
 void DLInterpreter::handleEvaluateCommand(const std::vector<std::string>& args) {
     if (!hasTrained) {
         std::cout << RED << "กรุณาเทรนโมเดลก่อนด้วยคำสั่ง 'train'" << RESET << std::endl;
@@ -330,8 +965,12 @@ void DLInterpreter::handleEvaluateCommand(const std::vector<std::string>& args)
 
     if (args.empty() || (args.size() >= 1 && args[0] == "model")) {
         std::cout << GREEN << "กำลังประเมินผลโมเดล " << modelType << "..." << RESET << std::endl;
-        std::cout << BLUE << "ความแม่นยำบนชุดข้อมูลทดสอบ: 0.92" << RESET << std::endl;
-        std::cout << BLUE << "ค่า Loss บนชุดข้อมูลทดสอบ: 0.08" << RESET << std::endl;
+        if (trainAccuracy >= 0.0f) {
+            std::cout << BLUE << "ความแม่นยำบนชุดข้อมูลเทรน: " << trainAccuracy << (syntheticData ? SYNTHETIC_TAG : "")
+                      << RESET << std::endl;
+        }
+        std::cout << BLUE << "ค่า Loss บนชุดข้อมูลเทรน: " << trainLoss << (syntheticData ? SYNTHETIC_TAG : "") << RESET
+                  << std::endl;
     } else {
         std::cout << RED << "รูปแบบคำสั่งไม่ถูกต้อง ตัวอย่าง: evaluate model" << RESET << std::endl;
     }
@@ -351,9 +990,14 @@ void DLInterpreter::handleShowCommand(const std::vector<std::string>& args) {
     std::string showType = args[0];
 
     if (showType == "accuracy") {
-        std::cout << GREEN << "ความแม่นยำของโมเดล: 0.89" << RESET << std::endl;
+        if (trainAccuracy >= 0.0f) {
+            std::cout << GREEN << "ความแม่นยำของโมเดล: " << trainAccuracy << (syntheticData ? SYNTHETIC_TAG : "") << RESET
+                      << std::endl;
+        } else {
+            std::cout << YELLOW << "โมเดล regression ไม่มีค่าความแม่นยำ (ดู show loss)" << RESET << std::endl;
+        }
     } else if (showType == "loss") {
-        std::cout << GREEN << "ค่า Loss: 0.134" << RESET << std::endl;
+        std::cout << GREEN << "ค่า Loss: " << trainLoss << (syntheticData ? SYNTHETIC_TAG : "") << RESET << std::endl;
     } else if (showType == "graph") {
         std::cout << GREEN << "กำลังสร้างกราฟผลการเทรนโมเดล " << modelType << "..." << RESET << std::endl;
 
@@ -417,10 +1061,16 @@ void DLInterpreter::handleShowCommand(const std::vector<std::string>& args) {
         std::cout << BLUE << "Precision: 0.91" << RESET << std::endl;
         std::cout << BLUE << "Recall: 0.87" << RESET << std::endl;
         std::cout << BLUE << "F1 Score: 0.89" << RESET << std::endl;
+    } else if (showType == "feature_importance") {
+        showFeatureImportance(args);
     } else if (showType == "model") {
         std::cout << GREEN << "โครงสร้างโมเดล " << modelType << ":" << RESET << std::endl;
 
-        if (layers.empty()) {
+        if (!graph.empty()) {
+            // กราฟที่คอมไพล์ตอน train มี shape และจำนวนพารามิเตอร์ครบทุกชั้น
+            graph.print(std::cout);
+            memoryPlan.print(std::cout, float32Plan.buffers().empty() ? nullptr : &float32Plan);
+        } else if (layers.empty()) {
             // ถ้ายังไม่มีการกำหนด layer ใช้ค่าเริ่มต้น
             std::cout << BLUE << "- Input Layer: 784 neurons" << RESET << std::endl;
             std::cout << BLUE << "- Hidden Layer 1: " << parameters["neurons_per_layer"] << " neurons, Activation: ReLU" << RESET << std::endl;
@@ -578,7 +1228,17 @@ void DLInterpreter::handleSaveCommand(const std::vector<std::string>& args) {
             scriptFile << "    'model_type': '" << modelType << "',\n";
             scriptFile << "    'learning_rate': " << parameters["learning_rate"] << ",\n";
             scriptFile << "    'epochs': " << parameters["epochs"] << ",\n";
-            scriptFile << "    'accuracy': 0.95,\n";
+            if (trainAccuracy >= 0.0f) {
+                scriptFile << "    'accuracy': " << trainAccuracy << ",\n";
+            } else {
+                scriptFile << "    'accuracy': None,\n";
+            }
+            if (std::isfinite(trainLoss)) {
+                scriptFile << "    'loss': " << trainLoss << ",\n";
+            } else {
+                scriptFile << "    'loss': float('nan'),\n";
+            }
+            scriptFile << "    'synthetic_data': " << (syntheticData ? "True" : "False") << ",\n";
             scriptFile << "    'create_time': '" << timestamp << "',\n";
 
             // เพิ่มข้อมูล layers
@@ -707,7 +1367,12 @@ void DLInterpreter::handleSaveCommand(const std::vector<std::string>& args) {
             modelFile << "model_type: " << modelType << "\n";
             modelFile << "learning_rate: " << parameters["learning_rate"] << "\n";
             modelFile << "epochs: " << parameters["epochs"] << "\n";
-            modelFile << "accuracy: 0.95\n";
+            if (trainAccuracy >= 0.0f) {
+                modelFile << "accuracy: " << trainAccuracy << "\n";
+            }
+            modelFile << "loss: " << trainLoss << "\n";
+            // ค่าข้างบนวัดจากข้อมูลสังเคราะห์ถ้าไม่ได้ load CSV ก่อน train
+            modelFile << "synthetic_data: " << (syntheticData ? "true" : "false") << "\n";
             modelFile << "create_time: " << timestamp << "\n\n";
 
             modelFile << "# Layers: " << layers.size() << "\n";
@@ -736,8 +1401,14 @@ void DLInterpreter::handleHelpCommand() {
     std::cout << GREEN << "create [model_type]" << RESET << " - สร้างโมเดล (CNN, RNN, LSTM, Transformer)" << std::endl;
     std::cout << GREEN << "load [dataset_path]" << RESET << " - โหลดข้อมูล" << std::endl;
     std::cout << GREEN << "set [param_name] [value]" << RESET << " - ตั้งค่าพารามิเตอร์" << std::endl;
+    std::cout << GREEN << "set optimizer [sgd|momentum|adam|adamw]" << RESET
+              << " - เลือก optimizer (ใช้ร่วมกับ momentum, beta1, beta2, weight_decay, clip_norm)" << std::endl;
+    std::cout << GREEN << "set threads [n]" << RESET << " - จำนวนเธรดที่ใช้เทรน (0 = ตามจำนวนคอร์)" << std::endl;
+    std::cout << GREEN << "set prefetch [n]" << RESET << " - จำนวน batch ที่เตรียมล่วงหน้าบนเธรดเบื้องหลัง (ค่าเริ่มต้น 2)" << std::endl;
+    std::cout << GREEN << "set precision [fp32|bf16]" << RESET
+              << " - bf16: ตัวถูกคูณของ GEMM/conv เป็น bfloat16 ผลสะสมและ weight หลักเป็น fp32" << std::endl;
     std::cout << GREEN << "train" << RESET << " - เทรนโมเดล" << std::endl;
-    std::cout << GREEN << "show [accuracy|loss|model]" << RESET << " - แสดงข้อมูลของโมเดล" << std::endl;
+    std::cout << GREEN << "show [accuracy|loss|model|feature_importance]" << RESET << " - แสดงข้อมูลของโมเดล" << std::endl;
     std::cout << GREEN << "save [file_path]" << RESET << " - บันทึกโมเดล" << std::endl;
     std::cout << GREEN << "help" << RESET << " - แสดงคำสั่งที่รองรับ" << std::endl;
     std::cout << GREEN << "add layer [layer_type] [neurons] [activation]" << RESET << " - เพิ่ม layer" << std::endl; // Added help for add command
@@ -1490,8 +2161,182 @@ void DLInterpreter::handleDeleteModelCommand([[maybe_unused]] const std::vector<
     std::cout << "Delete model command is not implemented for DL yet" << std::endl;
 }
 
-void DLInterpreter::handleCompareModelsCommand() {
-    std::cout << "Compare models command is not implemented for DL yet" << std::endl;
+void DLInterpreter::handleCompareModelsCommand(const std::vector<std::string>& args) {
+    if (!hasCreated) {
+        std::cout << RED << "กรุณาสร้างโมเดลก่อนด้วยคำสั่ง 'create'" << RESET << std::endl;
+        return;
+    }
+    if (!hasLoaded) {
+        std::cout << RED << "กรุณาโหลดข้อมูลก่อนด้วยคำสั่ง 'load'" << RESET << std::endl;
+        return;
+    }
+
+    // compare models SGD, Momentum, Adam, AdamW: เครือข่ายเดียวกันเทรนด้วย optimizer แต่ละแบบ (ว่าง = ทั้งหมด)
+    std::vector<OptimizerKind> kinds;
+    try {
+        for (size_t i = 1; i < args.size(); i++) {
+            std::stringstream names(args[i]);
+            std::string name;
+            while (std::getline(names, name, ',')) {
+                if (name.empty()) {
+                    continue;
+                }
+                OptimizerKind kind = parseOptimizer(name);
+                if (std::find(kinds.begin(), kinds.end(), kind) == kinds.end()) {
+                    kinds.push_back(kind);
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cout << RED << "Error: " << e.what() << RESET << std::endl;
+        return;
+    }
+    if (kinds.empty()) {
+        kinds = {OptimizerKind::SGD, OptimizerKind::Momentum, OptimizerKind::Adam, OptimizerKind::AdamW};
+    }
+
+    // คอมไพล์กราฟของตัวเองจึงไม่แตะโมเดลที่ train model เทรนไว้
+    std::vector<std::string> architecture;
+    if (!resolveArchitecture(architecture)) {
+        return;
+    }
+    LayerGraph candidate;
+    try {
+        if (parameters["batch_size"] < 1) {
+            throw std::invalid_argument("batch_size must be positive");
+        }
+        candidate = LayerGraph::compile(architecture, static_cast<size_t>(parameters["batch_size"]), true,
+                                        trainingPrecision());
+    } catch (const std::exception& e) {
+        std::cout << RED << "Error: " << e.what() << RESET << std::endl;
+        return;
+    }
+    std::vector<float> inputs, targets;
+    size_t samples = 0;
+    FeatureScaling scaling;
+    if (!prepareTrainingData(candidate, inputs, targets, samples, scaling)) {
+        return;
+    }
+    const size_t inSize = inputs.size() / samples, outSize = targets.size() / samples;
+    const Activation last = candidate.nodes().back().spec.activation;
+    const bool classification = last == Activation::Softmax || last == Activation::Sigmoid;
+    auto number = [this](const std::string& name, double fallback) {
+        auto it = parameters.find(name);
+        return it != parameters.end() ? it->second : fallback;
+    };
+
+    // แบ่งครั้งเดียวสำหรับทุกตัวเลือก สถิติของการปรับสเกลมาจากชุดเทรนเท่านั้น
+    using Clock = std::chrono::steady_clock;
+    ComparisonReport report;
+    report.classification = classification;
+    auto start = Clock::now();
+    std::vector<size_t> trainRows, testRows;
+    try {
+        splitTrainTest(rowLabels(targets, samples, outSize, classification), classification,
+                       number("test_size", 0.2), static_cast<unsigned>(number("random_state", 42)), trainRows,
+                       testRows);
+    } catch (const std::exception& e) {
+        std::cout << RED << "Error: " << e.what() << RESET << std::endl;
+        return;
+    }
+    std::vector<float> trainInputs = gatherRows(inputs, inSize, trainRows);
+    std::vector<float> trainTargets = gatherRows(targets, outSize, trainRows);
+    std::vector<float> testInputs = gatherRows(inputs, inSize, testRows);
+    std::vector<float> testTargets = gatherRows(targets, outSize, testRows);
+    if (!scaling.empty()) {
+        scaling = standardization(trainInputs.data(), trainRows.size(), inSize);
+    }
+    applyScaling(testInputs, inSize, scaling);
+    report.trainRows = trainRows.size();
+    report.testRows = testRows.size();
+    report.splitSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    report.cores = availableThreads();
+
+    std::vector<OptimizerConfig> configs;
+    for (OptimizerKind kind : kinds) {
+        configs.push_back(optimizerConfig(kind));
+    }
+    DataLoaderConfig loaderConfig;
+    loaderConfig.batchSize = candidate.batchSize();
+    loaderConfig.prefetch = std::max<size_t>(1, static_cast<size_t>(number("prefetch", 2)));
+    loaderConfig.epochs = static_cast<size_t>(std::max(1.0, number("epochs", 50)));
+    const GemmPrecision precision = candidate.precision();
+    size_t modelBytes = candidate.parameterCount() * sizeof(float);
+    if (precision == GemmPrecision::BFloat16) {
+        modelBytes += candidate.parameterCount() * sizeof(uint16_t);   // สำเนา bf16 ที่ใช้ร่วมกันทุกแบบจำลอง
+    }
+
+    std::cout << CYAN << "Comparing " << kinds.size() << " optimizers on " << modelType << " (" << architecture.size()
+              << " layers, " << loaderConfig.epochs << " epochs)" << (dataset.empty() ? SYNTHETIC_TAG : "") << "..."
+              << RESET << std::endl;
+    // ทุกตัวเลือกใช้หลายเธรดได้ (data parallel) ตัวจัดตารางแบ่งคอร์ให้รวมกันไม่เกินจำนวนคอร์
+    report.results.resize(kinds.size());
+    std::vector<std::unique_ptr<DataParallelTrainer>> trained(kinds.size());
+    start = Clock::now();
+    scheduleTasks(kinds.size(), [&](size_t) { return report.cores; }, [&](size_t t, size_t threads) {
+        ModelComparison& result = report.results[t];
+        result.type = optimizerName(kinds[t]);
+        result.threads = threads;
+        try {
+            auto fitStart = Clock::now();
+            auto model = std::make_unique<DataParallelTrainer>(candidate, threads, 42, precision);
+            Optimizer optimizer(configs[t], candidate.parameterCount());
+            if (!fitEpochs(*model, optimizer, trainInputs, trainTargets, trainRows.size(), scaling, loaderConfig)) {
+                result.error = "loss is not finite (lower learning_rate or set clip_norm)";
+                return;
+            }
+            result.trainSeconds = std::chrono::duration<double>(Clock::now() - fitStart).count();
+            std::vector<float> predictions(testTargets.size());
+            model->evaluate(testInputs.data(), testTargets.data(), testRows.size(), predictions.data());
+            result.score = classification
+                ? classificationAccuracy(predictions.data(), testTargets.data(), testRows.size(), outSize)
+                : rSquared(predictions.data(), testTargets.data(), testRows.size());
+            result.modelBytes = modelBytes;
+            trained[t] = std::move(model);
+        } catch (const std::exception& e) {
+            result.error = e.what();
+        }
+    });
+    report.trainWallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // วัดเวลาทำนายทีละตัวเลือกเมื่อเครื่องว่าง
+    const size_t latencyRows = std::min<size_t>(256, testRows.size());
+    std::vector<float> predictions(testTargets.size());
+    for (size_t t = 0; t < kinds.size(); t++) {
+        if (!trained[t]) {
+            continue;
+        }
+        ModelComparison& result = report.results[t];
+        auto predictStart = Clock::now();
+        for (size_t i = 0; i < latencyRows; i++) {
+            trained[t]->evaluate(testInputs.data() + i * inSize, testTargets.data() + i * outSize, 1,
+                                 predictions.data() + i * outSize);
+        }
+        result.latencyMicros = std::chrono::duration<double>(Clock::now() - predictStart).count() * 1e6 /
+                               std::max<size_t>(latencyRows, 1);
+        predictStart = Clock::now();
+        trained[t]->evaluate(testInputs.data(), testTargets.data(), testRows.size(), predictions.data());
+        result.batchMicros = std::chrono::duration<double>(Clock::now() - predictStart).count() * 1e6 /
+                             testRows.size();
+    }
+
+    std::stable_sort(report.results.begin(), report.results.end(), [](const ModelComparison& a, const ModelComparison& b) {
+        if (a.ok() != b.ok()) {
+            return a.ok();
+        }
+        return a.ok() && a.score > b.score;
+    });
+    report.print(std::cout);
+    const ModelComparison* best = report.best();
+    if (!best) {
+        std::cout << RED << "Error: No optimizer trained successfully." << RESET << std::endl;
+        return;
+    }
+    std::ios_base::fmtflags flags = std::cout.flags();
+    std::cout << GREEN << "Best: " << best->type << " (" << (classification ? "accuracy " : "R^2 ") << std::fixed
+              << std::setprecision(4) << best->score << "). Use 'set optimizer \"" << best->type
+              << "\"' then 'train model' to train it on all rows." << RESET << std::endl;
+    std::cout.flags(flags);
 }
 
 void DLInterpreter::handleCheckStatusCommand() {
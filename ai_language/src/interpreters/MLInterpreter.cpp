@@ -1,13 +1,49 @@
 #include "../../include/interpreters/MLInterpreter.h"
 #include "../../include/utils/plotting.h"
+#include "../../include/ml/CodeGen.h"
+#include "../../include/ml/Compare.h"
+#include "../../include/ml/Importance.h"
+#include "../../include/ml/ModelFactory.h"
+#include "../../include/ml/Polynomial.h"
+#include "../../include/ml/Recommender.h"
 #include <iostream>
 #include <chrono>
 #include <ctime>
 #include <cmath>
+#include <cstdio>
 #include <algorithm> // Added to fix compiler error
+#include <iomanip>
+#include <numeric>
+#include <random>
+#include <sstream>
 
 namespace ai_language {
 
+namespace {
+
+// จำนวนแถวตัวอย่างสูงสุดที่ฝังใน benchmark harness ของ export model
+constexpr size_t kExportSampleRows = 1000;
+
+// ดีกรีสูงสุดของ preprocess polynomial
+constexpr size_t kMaxPolynomialDegree = 4;
+// จำนวนพจน์ที่เริ่มเตือนให้ลด learning rate
+constexpr size_t kManyPolynomialTerms = 1000;
+
+// แทน features ของชุดข้อมูลด้วยผลการฉายลงแกนหลัก
+void projectDataset(const PCA& pca, Dataset& data) {
+    std::vector<float> projected(data.rows * pca.outputDimension());
+    pca.transform(data.features.data(), data.rows, projected.data());
+    data.features.swap(projected);
+    data.cols = pca.outputDimension();
+    data.featureCategories.clear();
+    data.featureNames.resize(data.cols);
+    for (size_t c = 0; c < data.cols; c++) {
+        data.featureNames[c] = "pc" + std::to_string(c + 1);
+    }
+}
+
+} // namespace
+
 MLInterpreter::MLInterpreter() {
     // Constructor implementation without debug output
     hasStarted = false;
@@ -16,6 +52,9 @@ MLInterpreter::MLInterpreter() {
     hasTrained = false;
     hasShowedAccuracy = false;
     hasEvaluated = false; // Added to track evaluation status
+    trainedRows = 0;
+    lastFullFitSeconds = 0.0;
+    hasMetrics = false;
     setDefaultParameters();
 }
 
@@ -42,7 +81,7 @@ void MLInterpreter::createModel(const std::string& modelType) {
     // รองรับโมเดลประเภทต่างๆ สำหรับ ML
     std::vector<std::string> supportedModels = {
         "LinearRegression", "LogisticRegression", "RandomForest", 
-        "SVM", "DecisionTree", "KNN", "NaiveBayes", "GradientBoosting"
+        "SVM", "DecisionTree", "KNN", "NaiveBayes", "GradientBoosting", "KMeans", "Voting", "Stacking"
     };
 
     bool isSupported = false;
@@ -68,14 +107,178 @@ void MLInterpreter::loadModel(const std::string& modelPath) {
     // Implementation for loading ML model
 }
 
-void MLInterpreter::trainModel() {
+ModelParams MLInterpreter::currentModelParams() const {
+    ModelParams params;
+    params.numeric = parameters;
+    params.text = stringParameters;
+    return params;
+}
+
+void MLInterpreter::trainModel(bool incremental) {
     std::cout << "Training ML model..." << std::endl;
-    // Implementation for training ML model
+
+    if (!ModelFactory::isNativeModel(modelType) || dataset.empty()) {
+        // Implementation for training ML model
+        return;
+    }
+
+    // warm start: เทรนต่อจากพารามิเตอร์เดิมด้วยแถวที่โหลดหรือต่อท้ายหลังการเทรนครั้งล่าสุด
+    if (incremental) {
+        if (!model || model->typeName() != modelType) {
+            std::cout << YELLOW << "Warning: No trained " << modelType << " to continue from. Running a full fit."
+                      << RESET << std::endl;
+        } else if (!model->supportsPartialFit()) {
+            std::cout << YELLOW << "Warning: " << modelType << " does not support incremental training. Running a full fit."
+                      << RESET << std::endl;
+        } else if (trainedRows >= dataset.rows) {
+            std::cout << YELLOW << "No new rows since the last training. Load or append a dataset first." << RESET << std::endl;
+            return;
+        } else if (projection != trainedProjection) {
+            std::cout << RED << "Error: The dataset projection changed since the last training. Use 'train model' to start over."
+                      << RESET << std::endl;
+            return;
+        } else if (dataset.targetName != trainedTarget) {
+            std::cout << RED << "Error: The model was trained to predict '" << trainedTarget << "' but the target column is now '"
+                      << dataset.targetName << "'. Use 'train model' to start over." << RESET << std::endl;
+            return;
+        } else if (dataset.cols != model->numFeatures()) {
+            std::cout << RED << "Error: New dataset has " << dataset.cols << " features but the model was trained on "
+                      << model->numFeatures() << ". Use 'train model' to start over." << RESET << std::endl;
+            return;
+        } else {
+            try {
+                dataset.alignClasses(trainedClassNames);
+                dataset.alignFeatureCategories(trainedFeatureCategories);
+                size_t newRows = dataset.rows - trainedRows;
+                auto start = std::chrono::steady_clock::now();
+                if (trainedRows == 0) {
+                    model->partialFit(dataset);
+                } else {
+                    std::vector<size_t> indices(newRows);
+                    for (size_t i = 0; i < newRows; i++) {
+                        indices[i] = trainedRows + i;
+                    }
+                    model->partialFit(dataset.subset(indices));
+                }
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                std::cout << GREEN << "Updated " << modelType << " with " << newRows << " new rows in "
+                          << std::fixed << std::setprecision(4) << seconds << "s";
+                if (lastFullFitSeconds > 0.0) {
+                    std::cout << " (last full fit: " << lastFullFitSeconds << "s)";
+                }
+                std::cout << RESET << std::endl;
+                std::cout.unsetf(std::ios::fixed);
+                trainedClassNames = dataset.classNames;
+                trainedFeatureCategories = dataset.featureCategories;
+                trainedRows = dataset.rows;
+                hasMetrics = false;
+                model->describe(std::cout);
+            } catch (const std::exception& e) {
+                std::cout << RED << "Error: Incremental training failed: " << e.what() << RESET << std::endl;
+            }
+            return;
+        }
+    }
+
+    auto degree = parameters.find("polynomial_degree");
+    if (degree != parameters.end() && degree->second > 1 && modelType != "LinearRegression" &&
+        modelType != "LogisticRegression") {
+        std::cout << RED << "Error: Polynomial features are expanded inside LinearRegression and LogisticRegression only. "
+                  << "Use 'preprocess polynomial degree 1' to train " << modelType << " on the original features."
+                  << RESET << std::endl;
+        return;
+    }
+
+    try {
+        model = ModelFactory::createModel(modelType, currentModelParams());
+        auto start = std::chrono::steady_clock::now();
+        model->fit(dataset);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << GREEN << "Trained " << modelType << " on " << dataset.rows << " rows in "
+                  << std::fixed << std::setprecision(4) << seconds << "s" << RESET << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+        trainedClassNames = dataset.classNames;
+        trainedFeatureCategories = dataset.featureCategories;
+        trainedTarget = dataset.targetName;
+        trainedProjection = projection;
+        trainedRows = dataset.rows;
+        lastFullFitSeconds = seconds;
+        hasMetrics = false;
+        model->describe(std::cout);
+    } catch (const std::exception& e) {
+        model.reset();
+        std::cout << RED << "Error: Training failed: " << e.what() << RESET << std::endl;
+    }
 }
 
 void MLInterpreter::evaluateModel() {
     std::cout << "Evaluating ML model performance..." << std::endl;
-    // Implementation for evaluating ML model
+    if (!model) {
+        std::cout << YELLOW << "Warning: No trained model to evaluate." << RESET << std::endl;
+        return;
+    }
+    if (computeMetrics(dataset, datasetPath)) {
+        lastMetrics.print(std::cout, trainedClassNames);
+    }
+}
+
+bool MLInterpreter::computeMetrics(Dataset& data, const std::string& source) {
+    if (!model) {
+        std::cout << YELLOW << "Warning: Metrics are only available after 'train model' on a loaded dataset." << RESET << std::endl;
+        return false;
+    }
+    if (!model->isSupervised()) {
+        std::cout << YELLOW << "Warning: " << modelType << " does not use the target column; see 'show model_info' "
+                  << "for inertia and cluster sizes, or 'predict file' for cluster labels." << RESET << std::endl;
+        return false;
+    }
+    if (data.empty()) {
+        std::cout << RED << "Error: No labelled rows to evaluate. Use 'load dataset' first." << RESET << std::endl;
+        return false;
+    }
+    if (data.cols != model->numFeatures()) {
+        std::cout << RED << "Error: Dataset has " << data.cols << " features but the model expects "
+                  << model->numFeatures() << RESET << std::endl;
+        return false;
+    }
+    try {
+        data.alignClasses(trainedClassNames);
+        data.alignFeatureCategories(trainedFeatureCategories);
+        auto start = std::chrono::steady_clock::now();
+        std::vector<float> predictions(data.rows);
+        model->predictBatch(data.features.data(), data.rows, predictions.data());
+        double predictSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        bool classification = data.isClassification() && modelType != "LinearRegression";
+        size_t classes = std::max(data.numClasses(), trainedClassNames.size());
+        lastMetrics = MetricsEngine::evaluate(data.targets.data(), predictions.data(), data.rows, classification, classes);
+        if (classification) {
+            std::vector<float> scores;
+            size_t width = model->decisionScores(data.features.data(), data.rows, scores);
+            MetricsEngine::addRankingMetrics(lastMetrics, data.targets.data(), scores.data(), data.rows, width);
+        }
+        double metricSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        hasMetrics = true;
+        hasEvaluated = true;
+        metricsSource = stripQuotes(source);
+        std::cout << GREEN << "Evaluated " << modelType << " on " << data.rows << " rows of " << metricsSource
+                  << std::fixed << std::setprecision(4) << " (predict " << predictSeconds << "s, metrics "
+                  << metricSeconds << "s)" << RESET << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+        return true;
+    } catch (const std::exception& e) {
+        std::cout << RED << "Error: Evaluation failed: " << e.what() << RESET << std::endl;
+        return false;
+    }
+}
+
+bool MLInterpreter::ensureMetrics() {
+    if (hasMetrics) {
+        return true;
+    }
+    return computeMetrics(dataset, datasetPath);
 }
 
 void MLInterpreter::saveModel(const std::string& modelPath) {
@@ -113,6 +316,20 @@ void MLInterpreter::saveModel(const std::string& modelPath) {
     // ใช้ฟังก์ชัน getCurrentDateTime จาก BaseInterpreter
     std::string timestamp = getCurrentDateTime();
 
+    // บันทึกตัวชี้วัดจริงของ evaluate model ล่าสุด (คำนวณบนชุดข้อมูลที่โหลดไว้ถ้ายังไม่เคยประเมิน)
+    const bool metricsKnown = hasTrained && model && model->isSupervised() && ensureMetrics();
+    auto writeMetrics = [&](std::ostream& out) {
+        if (!metricsKnown) {
+            out << "metrics: none\n";
+            return;
+        }
+        for (const auto& value : lastMetrics.values()) {
+            out << value.first << ": " << value.second << "\n";
+        }
+        out << "metrics_rows: " << lastMetrics.count << "\n";
+        out << "metrics_source: " << metricsSource << "\n";
+    };
+
     // ตรวจสอบนามสกุลไฟล์เพื่อเลือกวิธีการบันทึกที่เหมาะสม
     if (fullPath.find(".pkl") != std::string::npos) {
         // สำหรับไฟล์ .pkl ใช้ Python และ pickle
@@ -154,7 +371,15 @@ void MLInterpreter::saveModel(const std::string& modelPath) {
             scriptFile << "        'model_type': '" << modelType << "',\n";
             scriptFile << "        'learning_rate': " << parameters["learning_rate"] << ",\n";
             scriptFile << "        'epochs': " << parameters["epochs"] << ",\n";
-            scriptFile << "        'accuracy': 0.95,\n";
+            if (metricsKnown) {
+                for (const auto& value : lastMetrics.values()) {
+                    scriptFile << "        '" << value.first << "': " << value.second << ",\n";
+                }
+                scriptFile << "        'metrics_rows': " << lastMetrics.count << ",\n";
+                scriptFile << "        'metrics_source': '" << metricsSource << "',\n";
+            } else {
+                scriptFile << "        'metrics': None,\n";
+            }
             scriptFile << "        'create_time': '" << timestamp << "'\n";
             scriptFile << "    }\n\n";
             
@@ -180,7 +405,7 @@ void MLInterpreter::saveModel(const std::string& modelPath) {
                     modelFile << "model_type: " << modelType << "\n";
                     modelFile << "learning_rate: " << parameters["learning_rate"] << "\n";
                     modelFile << "epochs: " << parameters["epochs"] << "\n";
-                    modelFile << "accuracy: 0.95\n";
+                    writeMetrics(modelFile);
                     modelFile << "create_time: " << timestamp << "\n";
                     modelFile.close();
                     std::cout << "Fallback: Model saved in text format to: " << fullPath << std::endl;
@@ -197,7 +422,7 @@ void MLInterpreter::saveModel(const std::string& modelPath) {
             modelFile << "model_type: " << modelType << "\n";
             modelFile << "learning_rate: " << parameters["learning_rate"] << "\n";
             modelFile << "epochs: " << parameters["epochs"] << "\n";
-            modelFile << "accuracy: 0.95\n";
+            writeMetrics(modelFile);
             modelFile << "create_time: " << timestamp << "\n";
             modelFile.close();
             std::cout << "Model successfully saved to: " << fullPath << std::endl;
@@ -228,7 +453,22 @@ void MLInterpreter::handleCreateCommand(const std::vector<std::string>& args) {
         }
 
         modelType = args[1];
+        if (modelType == "Voting" || modelType == "Stacking") {
+            // create model Stacking with LinearRegression, RandomForest, KNN
+            std::string estimators;
+            for (size_t i = 3; i < args.size() && args[2] == "with"; i++) {
+                estimators += (estimators.empty() ? "" : " ") + args[i];
+            }
+            if (!estimators.empty()) {
+                stringParameters["estimators"] = estimators;
+            } else if (stringParameters.find("estimators") == stringParameters.end()) {
+                std::cout << RED << "Error: Usage: create model " << modelType << " with <model>, <model>[, ...]"
+                          << RESET << std::endl;
+                return;
+            }
+        }
         createModel(modelType); //Use the improved createModel function
+        model.reset();
         hasCreatedModel = true;
     } else if (createType == "ML") {
         // สำหรับคำสั่ง "create ML" เพื่อรองรับไวยากรณ์ใหม่
@@ -255,6 +495,38 @@ void MLInterpreter::handleLoadCommand(const std::vector<std::string>& args) {
     if (loadType == "dataset") {
         std::cout << "Loading dataset from: " << path << std::endl;
         hasLoadedData = true;
+        datasetPath = path;
+
+        auto target = stringParameters.find("target_column");
+        std::string error;
+        bool append = args.size() > 2 && args[2] == "append" && !dataset.empty();
+        Dataset loaded;
+        if (loadCsvDataset(path, target != stringParameters.end() ? target->second : "", loaded, error)) {
+            if (append && projection && loaded.cols == projection->inputDimension()) {
+                projectDataset(*projection, loaded);
+            }
+            if (append) {
+                // ต่อท้ายข้อมูลเดิม: แถวที่เทรนแล้วยังอยู่ และ 'train model incremental' ใช้เฉพาะแถวใหม่
+                if (!dataset.append(loaded)) {
+                    std::cout << RED << "Error: Cannot append " << loaded.cols << " features to a dataset with "
+                              << dataset.cols << RESET << std::endl;
+                    return;
+                }
+                std::cout << "Appended " << loaded.rows << " rows (" << dataset.rows << " rows total, "
+                          << dataset.rows - std::min(trainedRows, dataset.rows) << " not yet trained)" << std::endl;
+                return;
+            }
+            dataset = std::move(loaded);
+            trainedRows = 0;
+            projection.reset();
+            std::cout << "Loaded " << dataset.rows << " rows x " << dataset.cols << " features (target: "
+                      << dataset.targetName << ", " << (dataset.isClassification() ? "classification" : "regression")
+                      << ")" << std::endl;
+        } else {
+            dataset = Dataset();
+            projection.reset();
+            std::cout << YELLOW << "Warning: " << error << ". Native models will not be trained on this dataset." << RESET << std::endl;
+        }
     } else if (loadType == "model") {
         loadModel(path);
     } else if (loadType == "environment") {
@@ -332,6 +604,24 @@ void MLInterpreter::handleSetCommand(const std::vector<std::string>& args) {
             parameters[paramName] = -1;
             stringParameters[paramName] = paramValue;
             std::cout << "Set " << paramName << " = " << paramValue << std::endl;
+        } else if (paramName == "target_column") {
+            parameters[paramName] = -1;
+            stringParameters[paramName] = paramValue;
+            std::cout << "Set " << paramName << " = " << paramValue << std::endl;
+
+            // โหลดข้อมูลใหม่เพื่อใช้คอลัมน์เป้าหมายที่กำหนด
+            if (!datasetPath.empty()) {
+                std::string error;
+                Dataset reloaded;
+                if (loadCsvDataset(datasetPath, paramValue, reloaded, error)) {
+                    // เป้าหมายใหม่: ทุกแถวยังไม่ถูกเทรนด้วยเป้าหมายนี้ เช่นเดียวกับการโหลดไฟล์ใหม่
+                    dataset = std::move(reloaded);
+                    trainedRows = 0;
+                    projection.reset();
+                } else {
+                    std::cout << YELLOW << "Warning: " << error << RESET << std::endl;
+                }
+            }
         } else {
             // กรณีอื่นๆ ลองแปลงเป็นตัวเลข
             try {
@@ -350,7 +640,7 @@ void MLInterpreter::handleSetCommand(const std::vector<std::string>& args) {
     }
 }
 
-void MLInterpreter::handleTrainCommand(const std::vector<std::string>& /* args */) {
+void MLInterpreter::handleTrainCommand(const std::vector<std::string>& args) {
     if (!hasCreatedModel) {
         std::cout << "Error: No model created. Use 'create model' command first." << std::endl;
         return;
@@ -360,7 +650,8 @@ void MLInterpreter::handleTrainCommand(const std::vector<std::string>& /* args *
         std::cout << "Warning: No data loaded. Training with default dataset." << std::endl;
     }
 
-    trainModel();
+    bool incremental = std::find(args.begin(), args.end(), "incremental") != args.end();
+    trainModel(incremental);
     hasTrained = true;
 }
 
@@ -372,9 +663,24 @@ void MLInterpreter::handleEvaluateCommand(const std::vector<std::string>& args)
     }
 
     if (args.size() >= 1 && args[0] == "model") {
-        std::cout << "Evaluating ML model performance..." << std::endl;
-        // Evaluation code would go here
-        hasEvaluated = true;
+        // evaluate model [on] "<ไฟล์ทดสอบ>": ประเมินบนไฟล์ที่มีคอลัมน์เป้าหมายแทนข้อมูลที่ใช้เทรน
+        size_t pathIndex = args.size() >= 3 && args[1] == "on" ? 2 : 1;
+        if (args.size() > pathIndex) {
+            std::cout << "Evaluating ML model performance..." << std::endl;
+            auto target = stringParameters.find("target_column");
+            Dataset testData;
+            std::string error;
+            if (!loadCsvDataset(args[pathIndex], target != stringParameters.end() ? target->second : "", testData, error)) {
+                std::cout << RED << "Error: " << error << RESET << std::endl;
+                return;
+            }
+            projectForModel(testData);
+            if (computeMetrics(testData, args[pathIndex])) {
+                lastMetrics.print(std::cout, trainedClassNames);
+            }
+        } else {
+            evaluateModel();
+        }
     } else {
         std::cout << "Error: Invalid evaluation command format. Use 'evaluate model'" << std::endl;
     }
@@ -398,15 +704,35 @@ void MLInterpreter::handleShowCommand(const std::vector<std::string>& args) {
             std::cout << "Warning: Model not trained yet, no accuracy to show." << std::endl;
             return;
         }
-        double accuracy = 0.95;  // สมมติค่าความแม่นยำ
-        std::cout << "Model accuracy: " << accuracy << std::endl;
+        if (!ensureMetrics()) {
+            return;
+        }
+        std::cout << std::fixed << std::setprecision(4);
+        if (lastMetrics.classification) {
+            std::cout << "Model accuracy: " << lastMetrics.accuracy;
+        } else {
+            std::cout << "Model R-squared: " << lastMetrics.r2 << " (MSE " << lastMetrics.mse << ")";
+        }
+        std::cout << " on " << lastMetrics.count << " rows of " << metricsSource << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+        hasShowedAccuracy = true;
     } else if (showType == "loss") {
         if (!hasTrained) {
             std::cout << "Warning: Model not trained yet, no loss to show." << std::endl;
             return;
         }
-        double loss = 0.05;  // สมมติค่า loss
-        std::cout << "Model loss: " << loss << std::endl;
+        if (!ensureMetrics()) {
+            return;
+        }
+        // classification ไม่มีความน่าจะเป็นทุกโมเดล จึงรายงาน 0-1 loss (สัดส่วนที่ทำนายผิด) แทน log-loss
+        std::cout << std::fixed << std::setprecision(4);
+        if (lastMetrics.classification) {
+            std::cout << "Model loss (misclassification rate): " << 1.0 - lastMetrics.accuracy;
+        } else {
+            std::cout << "Model loss (MSE): " << lastMetrics.mse;
+        }
+        std::cout << " on " << lastMetrics.count << " rows of " << metricsSource << std::endl;
+        std::cout.unsetf(std::ios::fixed);
     } else if (showType == "graph") {
         if (!hasTrained) {
             std::cout << "Warning: Model not trained yet, no graph to show." << std::endl;
@@ -498,30 +824,152 @@ void MLInterpreter::handleShowCommand(const std::vector<std::string>& args) {
     } else if (showType == "version" || showType == "help" || showType == "time") {
         std::cout << "Showing " << showType << " (Not implemented)" << std::endl;
     } else if (showType == "model_info") {
-        std::cout << CYAN << "Model Information:" << RESET << std::endl;
-        std::cout << "Type: " << modelType << std::endl;
-        std::cout << "Status: " << (hasTrained ? "Trained" : "Not trained") << std::endl;
+        showModelInfo();
+    } else if (showType == "feature_importance") {
+        showFeatureImportance(args);
+    } else {
+        std::cout << "Unknown show type: " << showType << std::endl;
+    }
+}
 
-        std::cout << "\nParameters:" << std::endl;
-        for (const auto& param : parameters) {
-            if (param.second != -1) {  // Skip special values
-                std::cout << "- " << param.first << ": " << param.second << std::endl;
-            } else {
-                // Display string parameters
-                auto it = stringParameters.find(param.first);
-                if (it != stringParameters.end()) {
-                    std::cout << "- " << param.first << ": " << it->second << std::endl;
-                }
+void MLInterpreter::showFeatureImportance(const std::vector<std::string>& args) {
+    if (!hasTrained || !model) {
+        std::cout << YELLOW << "Warning: Feature importance is only available after 'train model' on a loaded dataset."
+                  << RESET << std::endl;
+        return;
+    }
+    if (!model->isSupervised()) {
+        std::cout << YELLOW << "Warning: Feature importance needs a target; " << modelType
+                  << " is unsupervised." << RESET << std::endl;
+        return;
+    }
+
+    // show feature_importance [on] "file": ใช้ไฟล์ที่ระบุเป็นข้อมูล held-out กับโมเดลที่เทรนไว้
+    // ไม่ระบุไฟล์: เทรนโมเดลชนิดเดียวกันใหม่บนชุดเทรนของการแบ่งแบบ compare models แล้วประเมินบนแถวที่กันไว้
+    // (คะแนนบนแถวที่โมเดลเห็นตอนเทรนให้รางวัลกับ feature ที่ overfit)
+    size_t pathIndex = args.size() >= 3 && args[1] == "on" ? 2 : 1;
+    const bool heldOut = args.size() <= pathIndex;
+    Dataset fileData;
+    Dataset* data = &dataset;
+    std::string source = datasetPath;
+    if (!heldOut) {
+        auto target = stringParameters.find("target_column");
+        std::string error;
+        if (!loadCsvDataset(args[pathIndex], target != stringParameters.end() ? target->second : "", fileData, error)) {
+            std::cout << RED << "Error: " << error << RESET << std::endl;
+            return;
+        }
+        projectForModel(fileData);
+        data = &fileData;
+        source = args[pathIndex];
+    }
+    if (data->empty()) {
+        std::cout << RED << "Error: No labelled rows to evaluate. Use 'load dataset' first." << RESET << std::endl;
+        return;
+    }
+
+    auto param = [this](const std::string& name, double fallback) {
+        auto it = parameters.find(name);
+        return it != parameters.end() && it->second > 0 ? it->second : fallback;
+    };
+    size_t repeats = static_cast<size_t>(param("importance_repeats", 5));
+    size_t maxRows = static_cast<size_t>(param("importance_rows", 5000));
+    unsigned seed = static_cast<unsigned>(param("random_state", 42));
+
+    try {
+        data->alignClasses(trainedClassNames);
+        data->alignFeatureCategories(trainedFeatureCategories);
+        bool classification = data->isClassification() && modelType != "LinearRegression";
+
+        // มุมมองดัชนีแถวที่ใช้ร่วมกันทุก feature
+        std::vector<uint32_t> view;
+        std::unique_ptr<MLModel> refit;
+        const MLModel* scored = model.get();
+        size_t fittedRows = 0;
+        if (heldOut) {
+            std::vector<size_t> trainRows, testRows;
+            splitTrainTest(data->targets, data->isClassification(), param("test_size", 0.2), seed, trainRows, testRows);
+            refit = ModelFactory::createModel(modelType, currentModelParams());
+            refit->fit(data->subset(trainRows));
+            scored = refit.get();
+            fittedRows = trainRows.size();
+            view.assign(testRows.begin(), testRows.end());
+        } else {
+            view.resize(data->rows);
+            std::iota(view.begin(), view.end(), 0u);
+        }
+        // สุ่มไม่เกิน importance_rows แถวแล้วเรียงเพื่ออ่านข้อมูลตามลำดับ
+        if (view.size() > maxRows) {
+            std::mt19937 rng(seed);
+            std::shuffle(view.begin(), view.end(), rng);
+            view.resize(maxRows);
+            std::sort(view.begin(), view.end());
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        PermutationImportance importance = permutationImportance(*scored, *data, view, repeats, seed, classification);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::vector<double> gains = scored->splitImportance();
+
+        std::vector<size_t> order(data->cols);
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::stable_sort(order.begin(), order.end(),
+                         [&](size_t a, size_t b) { return importance.mean[a] > importance.mean[b]; });
+
+        std::cout << CYAN << "Permutation importance of " << modelType << " on " << importance.rows
+                  << (heldOut ? " held-out" : "") << " rows of " << stripQuotes(source) << " (" << importance.repeats
+                  << " repeats, " << importance.metric << " baseline " << std::fixed << std::setprecision(4)
+                  << importance.baseline << ", " << seconds << "s)" << RESET << std::endl;
+        if (heldOut) {
+            std::cout << "Refit on the other " << fittedRows << " rows (test_size split); use 'show feature_importance on"
+                      << " \"file\"' to score the trained model on its own held-out file." << std::endl;
+        }
+        std::cout << std::left << std::setw(24) << "Feature" << std::right << std::setw(12) << "Importance"
+                  << std::setw(10) << "Std";
+        if (!gains.empty()) {
+            std::cout << std::setw(12) << "Split gain";
+        }
+        std::cout << std::endl;
+        for (size_t f : order) {
+            std::string name = f < data->featureNames.size() ? data->featureNames[f] : "feature_" + std::to_string(f);
+            std::cout << std::left << std::setw(24) << name << std::right << std::setw(12) << importance.mean[f]
+                      << std::setw(10) << importance.stddev[f];
+            if (!gains.empty()) {
+                std::cout << std::setw(12) << gains[f];
             }
+            std::cout << std::endl;
         }
+        std::cout.unsetf(std::ios::fixed | std::ios::adjustfield);
+    } catch (const std::exception& e) {
+        std::cout << RED << "Error: Feature importance failed: " << e.what() << RESET << std::endl;
+    }
+}
 
-        if (hasTrained) {
-            std::cout << "\nPerformance:" << std::endl;
-            std::cout << "- Accuracy: 0.95" << std::endl;
-            std::cout << "- Loss: 0.05" << std::endl;
+void MLInterpreter::showModelInfo() {
+    std::cout << CYAN << "Model Information:" << RESET << std::endl;
+    std::cout << "Type: " << modelType << std::endl;
+    std::cout << "Status: " << (hasTrained ? "Trained" : "Not trained") << std::endl;
+
+    std::cout << "\nParameters:" << std::endl;
+    for (const auto& param : parameters) {
+        if (param.second != -1) {  // Skip special values
+            std::cout << "- " << param.first << ": " << param.second << std::endl;
+        } else {
+            // Display string parameters
+            auto it = stringParameters.find(param.first);
+            if (it != stringParameters.end()) {
+                std::cout << "- " << param.first << ": " << it->second << std::endl;
+            }
+        }
+    }
+
+    if (hasTrained && model) {
+        std::cout << "\n";
+        model->describe(std::cout);
+        if (ensureMetrics()) {
+            std::cout << "\nPerformance on " << lastMetrics.count << " rows of " << metricsSource << ":" << std::endl;
+            lastMetrics.print(std::cout, trainedClassNames);
         }
-    } else {
-        std::cout << "Unknown show type: " << showType << std::endl;
     }
 }
 
@@ -555,21 +1003,30 @@ void MLInterpreter::handleHelpCommand() {
     std::cout << "Machine Learning Interpreter Help:" << std::endl;
     std::cout << "  start                        # Start the interpreter" << std::endl;
     std::cout << "  create model <model_type>    # Create an ML model (e.g., RandomForest, LinearRegression)" << std::endl;
+    std::cout << "  create model Stacking with <A>, <B>, ... # Ensemble trained concurrently (also Voting)" << std::endl;
+    std::cout << "  compare models [<A>, <B>, ...]  # Train models concurrently on one split: score, time, latency, size" << std::endl;
+    std::cout << "  recommend model [budget <s>] # Rank models using a dataset sketch and proxy fits" << std::endl;
     std::cout << "  load dataset <path>          # Load dataset from file" << std::endl;
+    std::cout << "  load dataset <path> append   # Append rows to the loaded dataset" << std::endl;
     std::cout << "  load model <path>            # Load a saved model" << std::endl;
     std::cout << "  set <param> <value>          # Set parameter value" << std::endl;
+    std::cout << "  preprocess pca components <N> # Project the dataset onto N principal components" << std::endl;
+    std::cout << "  preprocess polynomial degree <N> [interaction_only] # Polynomial terms for linear models" << std::endl;
     std::cout << "  train model                  # Train the model" << std::endl;
+    std::cout << "  train model incremental      # Continue training on rows added since the last training" << std::endl;
     std::cout << "  show parameters              # Show current parameters" << std::endl;
     std::cout << "  show accuracy                # Show model accuracy" << std::endl;
     std::cout << "  save model <path>            # Save model to file" << std::endl;
     std::cout << "  help                         # Show this help message" << std::endl;
     std::cout << "  evaluate model               # Evaluate the trained model" << std::endl; // Added evaluate command to help
+    std::cout << "  export model \"m.cpp\"         # Generate standalone C++ inference source + benchmark" << std::endl;
     std::cout << "  create DL                    # Create a Deep Learning model (Not fully implemented)" << std::endl;
     std::cout << "  create RL                    # Create a Reinforcement Learning model" << std::endl;
     std::cout << "  load environment <path>      # Load environment" << std::endl;
     std::cout << "  show reward                  # Show reward" << std::endl;
     std::cout << "  show q_table                 # Show q_table" << std::endl;
     std::cout << "  show model_info              # Show model info" << std::endl;
+    std::cout << "  show feature_importance      # Permutation importance (and split gain for tree models)" << std::endl;
     std::cout << "  show version                 # Show version (Not fully implemented)" << std::endl;
     std::cout << "  show time                    # Show time (Not fully implemented)" << std::endl;
     std::cout << "  plot <type> [options]       # Generate plots (scatter, line, histogram, correlation, learning_curve)" << std::endl;
@@ -887,7 +1344,7 @@ void MLInterpreter::handlePreprocessCommand(const std::vector<std::string>& args
 
     if (args.empty()) {
         std::cout << RED << "Error: Missing preprocessing method. Usage: preprocess <method>" << RESET << std::endl;
-        std::cout << "Available methods: normalize, standardize, encode, impute" << std::endl;
+        std::cout << "Available methods: normalize, standardize, encode, impute, pca, polynomial" << std::endl;
         return;
     }
 
@@ -906,12 +1363,130 @@ void MLInterpreter::handlePreprocessCommand(const std::vector<std::string>& args
     } else if (method == "impute") {
         std::cout << "Imputing missing values..." << std::endl;
         std::cout << GREEN << "Imputation complete: Missing values replaced with appropriate values" << RESET << std::endl;
+    } else if (method == "pca") {
+        preprocessPCA(args);
+    } else if (method == "polynomial") {
+        preprocessPolynomial(args);
     } else if (method == "dataset") {
         std::cout << "Applying standard preprocessing for dataset type..." << std::endl;
         std::cout << GREEN << "Dataset preprocessing complete: Applied standard transformations" << RESET << std::endl;
     } else {
         std::cout << RED << "Error: Unknown preprocessing method: " << method << RESET << std::endl;
-        std::cout << "Available methods: normalize, standardize, encode, impute, dataset" << std::endl;
+        std::cout << "Available methods: normalize, standardize, encode, impute, pca, polynomial, dataset" << std::endl;
+    }
+}
+
+void MLInterpreter::preprocessPCA(const std::vector<std::string>& args) {
+    // preprocess pca components N หรือ preprocess pca N
+    size_t valueIndex = args.size() >= 3 && args[1] == "components" ? 2 : 1;
+    size_t components = 0;
+    try {
+        components = args.size() > valueIndex ? static_cast<size_t>(std::stoul(args[valueIndex])) : 0;
+    } catch (const std::exception&) {
+        components = 0;
+    }
+    if (components == 0) {
+        std::cout << RED << "Error: Usage: preprocess pca components <N>" << RESET << std::endl;
+        return;
+    }
+    if (dataset.empty()) {
+        std::cout << RED << "Error: PCA needs a numeric dataset. Use 'load dataset' with a CSV file first." << RESET << std::endl;
+        return;
+    }
+    if (projection) {
+        std::cout << RED << "Error: The dataset is already projected to " << dataset.cols
+                  << " components. Reload the dataset to change the number of components." << RESET << std::endl;
+        return;
+    }
+
+    auto param = [this](const std::string& name, double fallback) {
+        auto it = parameters.find(name);
+        return it != parameters.end() && it->second >= 0 ? it->second : fallback;
+    };
+    PCA::Options options;
+    options.components = components;
+    options.oversample = static_cast<size_t>(param("pca_oversample", 10));
+    options.powerIterations = static_cast<size_t>(param("pca_iterations", 2));
+    options.seed = static_cast<unsigned>(param("random_state", 42));
+    try {
+        auto pca = std::make_shared<PCA>();
+        pca->fit(dataset.features.data(), dataset.rows, dataset.cols, options);
+        projectDataset(*pca, dataset);
+        projection = pca;
+        pca->describe(std::cout);
+        std::cout << GREEN << "Dataset projected to " << dataset.cols
+                  << " components. Train the model again to use them; predictions project raw inputs automatically."
+                  << RESET << std::endl;
+    } catch (const std::exception& e) {
+        std::cout << RED << "Error: PCA failed: " << e.what() << RESET << std::endl;
+    }
+}
+
+void MLInterpreter::preprocessPolynomial(const std::vector<std::string>& args) {
+    // preprocess polynomial degree N [interaction_only] หรือ preprocess polynomial N
+    size_t degree = 2;
+    bool interactionOnly = false;
+    for (size_t i = 1; i < args.size(); i++) {
+        if (args[i] == "interaction_only") {
+            interactionOnly = true;
+        } else if (args[i] != "degree") {
+            try {
+                degree = static_cast<size_t>(std::stoul(args[i]));
+            } catch (const std::exception&) {
+                degree = 0;
+            }
+        }
+    }
+    if (degree < 1 || degree > kMaxPolynomialDegree) {
+        std::cout << RED << "Error: Usage: preprocess polynomial degree <1-" << kMaxPolynomialDegree
+                  << "> [interaction_only]" << RESET << std::endl;
+        return;
+    }
+    if (degree == 1) {
+        parameters.erase("polynomial_degree");
+        parameters.erase("interaction_only");
+        std::cout << GREEN << "Polynomial features disabled. Train the model again to use the original features."
+                  << RESET << std::endl;
+        return;
+    }
+    if (dataset.empty()) {
+        std::cout << RED << "Error: Polynomial features need a numeric dataset. Use 'load dataset' with a CSV file first."
+                  << RESET << std::endl;
+        return;
+    }
+    size_t columns = PolynomialFeatures::outputDimension(dataset.cols, degree, interactionOnly);
+    if (columns == 0) {
+        std::cout << RED << "Error: Degree " << degree << " on " << dataset.cols << " features exceeds "
+                  << PolynomialFeatures::maxOutputs() << " columns" << RESET << std::endl;
+        return;
+    }
+
+    // ไม่แก้ dataset: LinearRegression/LogisticRegression ขยายพจน์ทีละแถวในเคอร์เนลของตัวเองผ่านพารามิเตอร์นี้
+    parameters["polynomial_degree"] = static_cast<double>(degree);
+    parameters["interaction_only"] = interactionOnly ? 1.0 : 0.0;
+    double materializedMB = static_cast<double>(dataset.rows) * columns * sizeof(float) / (1024.0 * 1024.0);
+    std::cout << "Polynomial features: " << dataset.cols << " -> " << columns << " columns (degree " << degree
+              << (interactionOnly ? ", interaction only" : "") << ")" << std::endl;
+    if (dataset.cols >= 2) {
+        PolynomialFeatures preview(std::min<size_t>(dataset.cols, 2), 2, interactionOnly);
+        std::vector<std::string> names = preview.featureNames(dataset.featureNames);
+        std::cout << "  e.g. " << names[2] << (names.size() > 3 ? ", " + names[3] : "") << std::endl;
+    }
+    std::cout << "  Expanded per row block during training and prediction; a materialized copy would take "
+              << std::fixed << std::setprecision(1) << materializedMB << " MB" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+    if (columns > kManyPolynomialTerms) {
+        // แถวที่ standardize แล้วมีขนาดกำลังสองประมาณเท่าจำนวนคอลัมน์ SGD จึงต้องการ learning rate ที่เล็กลงตาม
+        std::cout << YELLOW << "Note: With " << columns << " terms SGD may diverge at the default learning rate; "
+                  << "try 'set learning_rate 0.001' if the training loss grows." << RESET << std::endl;
+    }
+    std::cout << GREEN << "Polynomial features enabled for LinearRegression and LogisticRegression. Train the model again to use them."
+              << RESET << std::endl;
+}
+
+void MLInterpreter::projectForModel(Dataset& data) const {
+    if (trainedProjection && data.cols == trainedProjection->inputDimension()) {
+        projectDataset(*trainedProjection, data);
     }
 }
 
@@ -1084,9 +1659,32 @@ void MLInterpreter::handlePredictCommand(const std::vector<std::string>& args) {
             return;
         }
 
-        std::string filePath = args[1];
+        std::string filePath = stripQuotes(args[1]);
         std::cout << CYAN << "Making predictions on data from file: " << filePath << RESET << std::endl;
 
+        if (model) {
+            std::vector<float> rows;
+            size_t count = 0;
+            std::string error;
+            size_t inputs = trainedProjection ? trainedProjection->inputDimension() : model->numFeatures();
+            if (!loadCsvFeatures(filePath, inputs, rows, count, error)) {
+                std::cout << RED << "Error: " << error << RESET << std::endl;
+                return;
+            }
+            if (trainedProjection) {
+                std::vector<float> projected(count * trainedProjection->outputDimension());
+                trainedProjection->transform(rows.data(), count, projected.data());
+                rows.swap(projected);
+            }
+            auto start = std::chrono::steady_clock::now();
+            std::vector<float> predictions(count);
+            model->predictBatch(rows.data(), count, predictions.data());
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            printPredictions(predictions, count, seconds);
+            model->reportBatch(rows.data(), count, std::cout);
+            return;
+        }
+
         // ตรวจสอบการมีอยู่ของไฟล์ (ในที่นี้เป็นตัวอย่างโค้ด)
         std::ifstream testFile(filePath);
         if (!testFile.is_open()) {
@@ -1157,6 +1755,23 @@ void MLInterpreter::handlePredictCommand(const std::vector<std::string>& args) {
     }
     std::cout << RESET << std::endl;
 
+    if (model) {
+        size_t inputs = trainedProjection ? trainedProjection->inputDimension() : model->numFeatures();
+        if (inputValues.size() != inputs) {
+            std::cout << RED << "Error: Model expects " << inputs << " input values, got "
+                      << inputValues.size() << RESET << std::endl;
+            return;
+        }
+        std::vector<float> row(inputValues.begin(), inputValues.end());
+        if (trainedProjection) {
+            std::vector<float> projected(trainedProjection->outputDimension());
+            trainedProjection->transform(row.data(), 1, projected.data());
+            row.swap(projected);
+        }
+        std::cout << GREEN << "Prediction result: " << formatPrediction(model->predictOne(row.data())) << RESET << std::endl;
+        return;
+    }
+
     // สร้างผลลัพธ์จำลอง
     double result = 0.0;
     for (size_t i = 0; i < inputValues.size(); i++) {
@@ -1167,6 +1782,28 @@ void MLInterpreter::handlePredictCommand(const std::vector<std::string>& args) {
     std::cout << GREEN << "Prediction result: " << result << RESET << std::endl;
 }
 
+std::string MLInterpreter::formatPrediction(float value) const {
+    if (model && !model->isSupervised()) {
+        return "cluster " + std::to_string(static_cast<long>(value));
+    }
+    return dataset.formatTarget(value);
+}
+
+void MLInterpreter::printPredictions(const std::vector<float>& predictions, size_t count, double seconds) {
+    const size_t shown = std::min<size_t>(count, 20);
+    std::cout << GREEN << "Prediction results:" << RESET << std::endl;
+    for (size_t i = 0; i < shown; i++) {
+        std::cout << "Row " << (i + 1) << ": " << formatPrediction(predictions[i]) << std::endl;
+    }
+    if (count > shown) {
+        std::cout << "... (" << (count - shown) << " more rows)" << std::endl;
+    }
+    if (seconds > 0.0 && count > 0) {
+        std::cout << "Predicted " << count << " rows in " << seconds * 1000.0 << " ms ("
+                  << static_cast<size_t>(count / seconds) << " rows/s)" << std::endl;
+    }
+}
+
 void MLInterpreter::handleListModelsCommand() {
     std::cout << CYAN << "Available ML model types:" << RESET << std::endl;
     std::cout << "- LinearRegression: For regression tasks" << std::endl;
@@ -1177,6 +1814,9 @@ void MLInterpreter::handleListModelsCommand() {
     std::cout << "- KNN: K-Nearest Neighbors algorithm" << std::endl;
     std::cout << "- NaiveBayes: Probabilistic classifier" << std::endl;
     std::cout << "- GradientBoosting: Boosting ensemble method" << std::endl;
+    std::cout << "- KMeans: Clustering (k-means|| init, Hamerly/Elkan bounds, mini-batch)" << std::endl;
+    std::cout << "- Voting: Majority vote or mean of several models trained concurrently (create model Voting with A, B, C)" << std::endl;
+    std::cout << "- Stacking: Meta-learner on out-of-fold predictions of several models (create model Stacking with A, B, C)" << std::endl;
 
     if (hasCreatedModel) {
         std::cout << GREEN << "\nCurrent model: " << modelType << RESET << std::endl;
@@ -1217,27 +1857,107 @@ void MLInterpreter::handleDeleteModelCommand(const std::vector<std::string>& arg
     }
 }
 
-void MLInterpreter::handleCompareModelsCommand() {
-    if (!hasLoadedData) {
+void MLInterpreter::handleCompareModelsCommand(const std::vector<std::string>& args) {
+    if (!hasLoadedData || dataset.empty()) {
         std::cout << RED << "Error: No dataset loaded. Please load a dataset first." << RESET << std::endl;
         return;
     }
 
-    std::cout << CYAN << "Comparing ML models on current dataset..." << RESET << std::endl;
+    // compare models LinearRegression, RandomForest, GradientBoosting (ว่าง = โมเดลทั้งหมดที่เหมาะกับงาน)
+    std::vector<std::string> types;
+    for (size_t i = 1; i < args.size(); i++) {
+        std::stringstream names(args[i]);
+        std::string name;
+        while (std::getline(names, name, ',')) {
+            if (!name.empty() && std::find(types.begin(), types.end(), name) == types.end()) {
+                types.push_back(name);
+            }
+        }
+    }
+    if (types.empty()) {
+        types = defaultComparisonModels(dataset.isClassification());
+    }
+    for (const auto& type : types) {
+        if (!ModelFactory::isNativeModel(type)) {
+            std::cout << RED << "Error: Unknown or non-native model type: " << type << RESET << std::endl;
+            return;
+        }
+    }
+
+    CompareOptions options;
+    options.params = currentModelParams();
+    options.testSize = options.params.get("test_size", 0.2);
+    options.seed = static_cast<unsigned>(options.params.get("random_state", 42));
+    if (options.params.get("polynomial_degree", 1.0) > 1.0) {
+        std::cout << YELLOW << "Note: Polynomial features apply to LinearRegression and LogisticRegression only; "
+                  << "other models use the original features." << RESET << std::endl;
+    }
 
-    // แสดงผลการเปรียบเทียบจำลอง
-    std::cout << "Model comparison results:" << std::endl;
-    std::cout << "-------------------------------------------------" << std::endl;
-    std::cout << "Model Type            | Accuracy | Training Time" << std::endl;
-    std::cout << "-------------------------------------------------" << std::endl;
-    std::cout << "LinearRegression      | 0.78     | 0.05s" << std::endl;
-    std::cout << "LogisticRegression    | 0.82     | 0.08s" << std::endl;
-    std::cout << "RandomForest          | 0.91     | 1.25s" << std::endl;
-    std::cout << "SVM                   | 0.85     | 1.56s" << std::endl;
-    std::cout << "DecisionTree          | 0.88     | 0.23s" << std::endl;
-    std::cout << "-------------------------------------------------" << std::endl;
+    std::cout << CYAN << "Comparing " << types.size() << " ML models on " << datasetPath << "..." << RESET << std::endl;
+    try {
+        ComparisonReport report = compareModels(dataset, types, options);
+        report.print(std::cout);
+        const ModelComparison* best = report.best();
+        if (!best) {
+            std::cout << RED << "Error: No model trained successfully." << RESET << std::endl;
+            return;
+        }
+        std::cout << GREEN << "Best: " << best->type << " (" << (report.classification ? "accuracy " : "R^2 ")
+                  << std::fixed << std::setprecision(4) << best->score << "). Use 'create model " << best->type
+                  << "' then 'train model' to train it on all rows." << RESET << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+    } catch (const std::exception& e) {
+        std::cout << RED << "Error: Comparison failed: " << e.what() << RESET << std::endl;
+    }
+}
 
-    std::cout << GREEN << "Recommendation: RandomForest provides the best accuracy for this dataset." << RESET << std::endl;
+void MLInterpreter::handleRecommendCommand(const std::vector<std::string>& args) {
+    if (args.empty() || args[0] != "model") {
+        std::cout << RED << "Error: Usage: recommend model [budget <seconds>]" << RESET << std::endl;
+        return;
+    }
+    if (!hasLoadedData || dataset.empty()) {
+        std::cout << RED << "Error: Model recommendation needs a numeric dataset. Use 'load dataset' with a CSV file first."
+                  << RESET << std::endl;
+        return;
+    }
+
+    RecommendOptions options;
+    options.params = currentModelParams();
+    options.sampleRows = static_cast<size_t>(options.params.get("recommend_sample", 2000));
+    options.budgetSeconds = options.params.get("recommend_budget", 2.0);
+    options.seed = static_cast<unsigned>(options.params.get("random_state", 42));
+    for (size_t i = 1; i + 1 < args.size(); i++) {
+        if (args[i] == "budget") {
+            try {
+                options.budgetSeconds = std::stod(args[i + 1]);
+            } catch (const std::exception&) {
+                std::cout << RED << "Error: Invalid budget: " << args[i + 1] << RESET << std::endl;
+                return;
+            }
+        }
+    }
+    // ตัวแทนใช้พารามิเตอร์เดียวกับการเทรนจริง ยกเว้นพจน์พหุนามที่โมเดลส่วนใหญ่ไม่รองรับ
+    options.params.numeric.erase("polynomial_degree");
+
+    std::cout << CYAN << "Recommending a model for " << datasetPath << "..." << RESET << std::endl;
+    try {
+        RecommendationReport report = recommendModels(dataset, options);
+        report.print(std::cout);
+        const ModelCandidate& top = report.candidates.front();
+        if (top.trainRows == 0) {
+            std::cout << YELLOW << "No proxy model finished within the budget. Try 'recommend model budget 10'."
+                      << RESET << std::endl;
+            return;
+        }
+        std::cout << GREEN << "Recommendation: " << top.type << " (" << (report.sketch.classification ? "accuracy " : "R^2 ")
+                  << std::fixed << std::setprecision(4) << top.score << " on the holdout, about "
+                  << std::setprecision(2) << top.estimatedSeconds << "s to train on all " << dataset.rows
+                  << " rows). Use 'create model " << top.type << "'" << RESET << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+    } catch (const std::exception& e) {
+        std::cout << RED << "Error: Recommendation failed: " << e.what() << RESET << std::endl;
+    }
 }
 
 void MLInterpreter::handleCheckStatusCommand() {
@@ -1358,23 +2078,104 @@ void MLInterpreter::handleCrossValidateCommand(const std::vector<std::string>& a
     std::cout << "Standard deviation: " << std::fixed << std::setprecision(4) << stdDev << std::endl;
 }
 
+void MLInterpreter::exportModelSource(const std::vector<std::string>& args) {
+    if (!hasTrained || !model) {
+        std::cout << RED << "Error: Model must be trained before exporting it" << RESET << std::endl;
+        return;
+    }
+    if (args.size() < 2) {
+        std::cout << RED << "Error: Usage: export model \"<file>.cpp\" [on \"<raw inputs>.csv\"]" << RESET << std::endl;
+        return;
+    }
+    std::string path = stripQuotes(args[1]);
+
+    // แถวตัวอย่างของ harness ต้องเป็นข้อมูลดิบก่อนฉาย PCA: ใช้ไฟล์ที่ระบุ หรือข้อมูลที่โหลดไว้ถ้าไม่ได้ฉาย
+    SourceExportOptions options;
+    options.fileName = path.substr(path.find_last_of('/') + 1);
+    options.projection = trainedProjection.get();
+    size_t inputs = trainedProjection ? trainedProjection->inputDimension() : model->numFeatures();
+    std::vector<float> samples;
+    size_t sampleCount = 0;
+    if (args.size() >= 4 && args[2] == "on") {
+        std::string error;
+        if (!loadCsvFeatures(args[3], inputs, samples, sampleCount, error)) {
+            std::cout << RED << "Error: " << error << RESET << std::endl;
+            return;
+        }
+        sampleCount = std::min(sampleCount, kExportSampleRows);
+        samples.resize(sampleCount * inputs);
+    } else if (!trainedProjection && dataset.cols == inputs && !dataset.empty()) {
+        size_t step = std::max<size_t>(1, dataset.rows / kExportSampleRows);
+        for (size_t i = 0; i < dataset.rows && sampleCount < kExportSampleRows; i += step, sampleCount++) {
+            samples.insert(samples.end(), dataset.row(i), dataset.row(i) + inputs);
+        }
+    }
+    options.sampleRows = samples.data();
+    options.sampleCount = sampleCount;
+    if (!trainedProjection) {
+        options.featureNames = dataset.featureNames;
+    }
+    options.classNames = trainedClassNames;
+
+    std::ofstream file(path);
+    if (!file) {
+        std::cout << RED << "Error: Could not open " << path << " for writing" << RESET << std::endl;
+        return;
+    }
+    try {
+        SourceExportReport report = ai_language::exportModelSource(*model, options, file);
+        std::cout << GREEN << "Exported " << modelType << " to " << path << " (" << report.bytes << " bytes)" << RESET
+                  << std::endl;
+        if (report.sampleRows > 0) {
+            std::cout << "Benchmark harness: " << report.sampleRows << " rows, interpreter predict "
+                      << std::fixed << std::setprecision(1) << report.interpreterRowNanos << " ns/row (batch "
+                      << report.interpreterBatchNanos << " ns/row)" << std::endl;
+            std::cout.unsetf(std::ios::fixed);
+            std::string binary = path.substr(0, path.find_last_of('.')) + "_bench";
+            std::cout << "Build it with: g++ -O2 -std=c++17 -DAI_LANGUAGE_BENCHMARK \"" << path << "\" -o \"" << binary
+                      << "\"" << std::endl;
+        } else {
+            std::cout << YELLOW << "Note: No raw input rows for the benchmark harness; use 'export model \"" << path
+                      << "\" on \"<raw inputs>.csv\"'" << RESET << std::endl;
+        }
+    } catch (const std::exception& e) {
+        file.close();
+        std::remove(path.c_str());
+        std::cout << RED << "Error: " << e.what() << RESET << std::endl;
+    }
+}
+
 void MLInterpreter::handleExportResultsCommand(const std::vector<std::string>& args) {
+    if (!args.empty() && args[0] == "model") {
+        exportModelSource(args);
+        return;
+    }
     if (!hasTrained) {
         std::cout << RED << "Error: Model must be trained before exporting results" << RESET << std::endl;
         return;
     }
 
-    if (args.empty()) {
+    // รองรับทั้ง export results <format> [path] และ export results "<ไฟล์>.<format>"
+    std::vector<std::string> exportArgs = args;
+    if (!exportArgs.empty() && exportArgs[0] == "results") {
+        exportArgs.erase(exportArgs.begin());
+    }
+    if (exportArgs.empty()) {
         std::cout << RED << "Error: Missing export format. Usage: export results <format> [path]" << RESET << std::endl;
         std::cout << "Available formats: csv, json, txt" << RESET << std::endl;
         return;
     }
 
-    std::string format = args[0];
+    std::string format = exportArgs[0];
     std::string path = "Program test/Data/results";
 
-    if (args.size() > 1) {
-        path = args[1];
+    if (exportArgs.size() > 1) {
+        path = stripQuotes(exportArgs[1]);
+    } else if (format != "csv" && format != "json" && format != "txt") {
+        path = stripQuotes(format);
+        size_t dot = path.find_last_of('.');
+        format = dot == std::string::npos ? "csv" : path.substr(dot + 1);
+        path = path.substr(0, dot);
     }
 
     // สร้างโฟลเดอร์ถ้ายังไม่มี
@@ -1387,15 +2188,26 @@ void MLInterpreter::handleExportResultsCommand(const std::vector<std::string>& a
 
     std::cout << CYAN << "Exporting model results in " << format << " format..." << RESET << std::endl;
 
+    if (format != "csv" && format != "json" && format != "txt") {
+        std::cout << RED << "Error: Unsupported export format '" << format << "'" << RESET << std::endl;
+        std::cout << "Available formats: csv, json, txt" << std::endl;
+        return;
+    }
+    if (!ensureMetrics()) {
+        return;
+    }
+    auto values = lastMetrics.values();
+    const ConfusionMatrix& confusion = lastMetrics.confusion;
+
     if (format == "csv") {
         path += ".csv";
         std::ofstream outFile(path);
         if (outFile.is_open()) {
             outFile << "metric,value\n";
-            outFile << "accuracy,0.95\n";
-            outFile << "precision,0.92\n";
-            outFile << "recall,0.89\n";
-            outFile << "f1_score,0.91\n";
+            outFile << "rows," << lastMetrics.count << "\n";
+            for (const auto& value : values) {
+                outFile << value.first << "," << value.second << "\n";
+            }
             outFile.close();
         }
     } else if (format == "json") {
@@ -1404,34 +2216,53 @@ void MLInterpreter::handleExportResultsCommand(const std::vector<std::string>& a
         if (outFile.is_open()) {
             outFile << "{\n";
             outFile << "  \"model\": \"" << modelType << "\",\n";
+            outFile << "  \"evaluated_on\": \"" << metricsSource << "\",\n";
+            outFile << "  \"rows\": " << lastMetrics.count << ",\n";
             outFile << "  \"metrics\": {\n";
-            outFile << "    \"accuracy\": 0.95,\n";
-            outFile << "    \"precision\": 0.92,\n";
-            outFile << "    \"recall\": 0.89,\n";
-            outFile << "    \"f1_score\": 0.91\n";
+            for (size_t i = 0; i < values.size(); i++) {
+                outFile << "    \"" << values[i].first << "\": " << values[i].second
+                        << (i + 1 < values.size() ? ",\n" : "\n");
+            }
             outFile << "  },\n";
+            if (lastMetrics.classification) {
+                // ตารางเต็มสำหรับคลาสไม่มาก ไม่เช่นนั้นเขียนเฉพาะช่องที่ไม่เป็นศูนย์ [actual, predicted, count]
+                size_t classes = confusion.classes;
+                if (classes <= 100) {
+                    outFile << "  \"confusion_matrix\": [";
+                    for (size_t t = 0; t < classes; t++) {
+                        outFile << (t > 0 ? ", [" : "[");
+                        for (size_t p = 0; p < classes; p++) {
+                            outFile << (p > 0 ? ", " : "") << confusion.at(t, p);
+                        }
+                        outFile << "]";
+                    }
+                    outFile << "],\n";
+                } else {
+                    outFile << "  \"confusion_cells\": [";
+                    auto cells = confusion.nonZero();
+                    for (size_t i = 0; i < cells.size(); i++) {
+                        outFile << (i > 0 ? ", " : "") << "[" << cells[i].first / classes << ", "
+                                << cells[i].first % classes << ", " << cells[i].second << "]";
+                    }
+                    outFile << "],\n";
+                }
+            }
             outFile << "  \"timestamp\": \"" << getCurrentDateTime() << "\"\n";
             outFile << "}\n";
             outFile.close();
         }
-    } else if (format == "txt") {
+    } else {
         path += ".txt";
         std::ofstream outFile(path);
         if (outFile.is_open()) {
             outFile << "Model Evaluation Results\n";
             outFile << "======================\n";
             outFile << "Model Type: " << modelType << "\n";
-            outFile << "Accuracy: 0.95\n";
-            outFile << "Precision: 0.92\n";
-            outFile << "Recall: 0.89\n";
-            outFile << "F1 Score: 0.91\n";
+            outFile << "Evaluated on: " << lastMetrics.count << " rows of " << metricsSource << "\n";
+            lastMetrics.print(outFile, trainedClassNames);
             outFile << "Timestamp: " << getCurrentDateTime() << "\n";
             outFile.close();
         }
-    } else {
-        std::cout << RED << "Error: Unsupported export format '" << format << "'" << RESET << std::endl;
-        std::cout << "Available formats: csv, json, txt" << std::endl;
-        return;
     }
 
     std::cout << GREEN << "Results exported to: " << path << RESET << std::endl;
@@ -1216,7 +1216,7 @@ void RLInterpreter::handleDeleteModelCommand(const std::vector<std::string>& arg
     std::cout << "ยังไม่ได้ดำเนินการคำสั่ง delete model" << std::endl;
 }
 
-void RLInterpreter::handleCompareModelsCommand() {
+void RLInterpreter::handleCompareModelsCommand([[maybe_unused]] const std::vector<std::string>& args) {
     std::cout << "ยังไม่ได้ดำเนินการคำสั่ง compare models" << std::endl;
 }
 
@@ -0,0 +1,248 @@
+#include "../../include/ml/CodeGen.h"
+#include "../../include/ml/PCA.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+
+namespace ai_language {
+
+namespace {
+
+constexpr size_t kValuesPerLine = 8;
+constexpr double kTimingSeconds = 0.2;
+
+std::string escape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out;
+}
+
+// เรียก fn ซ้ำจนใช้เวลาอย่างน้อย kTimingSeconds แล้วคืนเวลาเฉลี่ยต่อแถวเป็นนาโนวินาที
+template <typename Fn>
+double timePerRow(size_t rowsPerCall, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    size_t rows = 0;
+    double elapsed = 0.0;
+    do {
+        fn();
+        rows += rowsPerCall;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < kTimingSeconds);
+    return elapsed * 1e9 / static_cast<double>(rows);
+}
+
+} // namespace
+
+std::ostream& SourceWriter::line() {
+    for (int i = 0; i < depth; i++) {
+        os << "    ";
+    }
+    return os;
+}
+
+std::string SourceWriter::literal(float value) {
+    if (std::isnan(value)) {
+        return "std::numeric_limits<float>::quiet_NaN()";
+    }
+    if (std::isinf(value)) {
+        return value > 0 ? "std::numeric_limits<float>::infinity()" : "-std::numeric_limits<float>::infinity()";
+    }
+    // 9 หลักนัยสำคัญพอให้ float แปลงกลับได้ค่าเดิมทุกบิต
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.9g", static_cast<double>(value));
+    std::string text = buffer;
+    if (text.find_first_of(".e") == std::string::npos) {
+        text += ".0";
+    }
+    return text + "f";
+}
+
+void SourceWriter::floatArray(const std::string& name, const float* values, size_t count) {
+    line() << "constexpr float " << name << "[" << std::max<size_t>(count, 1) << "] = {";
+    if (count == 0) {
+        os << "0.0f};\n";
+        return;
+    }
+    os << "\n";
+    indent();
+    for (size_t i = 0; i < count; i += kValuesPerLine) {
+        line();
+        for (size_t j = i; j < std::min(count, i + kValuesPerLine); j++) {
+            os << literal(values[j]) << (j + 1 < count ? ", " : "");
+        }
+        os << "\n";
+    }
+    dedent();
+    line() << "};\n";
+}
+
+void SourceWriter::returnArgmax(const std::string& scores, size_t width) {
+    line() << "std::size_t best = 0;\n";
+    line() << "for (std::size_t c = 1; c < " << width << "; c++) {\n";
+    line() << "    best = " << scores << "[c] > " << scores << "[best] ? c : best;\n";
+    line() << "}\n";
+    line() << "return static_cast<float>(best);\n";
+}
+
+SourceExportReport exportModelSource(const MLModel& model, const SourceExportOptions& options, std::ostream& os) {
+    const PCA* projection = options.projection;
+    size_t inputs = projection ? projection->inputDimension() : model.numFeatures();
+    std::ostringstream body;
+    SourceWriter out(body);
+    if (!model.emitSource(out)) {
+        throw std::invalid_argument(model.typeName() + " cannot be exported as C++ source");
+    }
+
+    SourceExportReport report;
+    std::string file = options.fileName.empty() ? "model.cpp" : options.fileName;
+    std::string binary = file.substr(0, file.find_last_of('.')) + "_bench";
+    std::ostringstream source;
+    SourceWriter writer(source);
+    source << "// Generated by AI Language `export model` from a trained " << model.typeName() << " (" << inputs
+           << " input features).\n"
+           << "// Self-contained: call ai_language_generated::predict(x) with x[kInputFeatures] in the order below.\n"
+           << "// Benchmark: g++ -O2 -std=c++17 -DAI_LANGUAGE_BENCHMARK " << file << " -o " << binary << " && ./"
+           << binary << "\n"
+           << "#include <cmath>\n#include <cstddef>\n#include <limits>\n\n"
+           << "namespace ai_language_generated {\n\n"
+           << "constexpr std::size_t kInputFeatures = " << inputs << ";\n";
+    if (!options.featureNames.empty()) {
+        source << "// Inputs:";
+        for (size_t j = 0; j < options.featureNames.size(); j++) {
+            source << (j % 8 == 0 && j > 0 ? "\n//        " : " ") << options.featureNames[j];
+        }
+        source << "\n";
+    }
+    source << "\n";
+
+    if (projection) {
+        source << "// PCA projection (preprocess pca): " << inputs << " -> " << projection->outputDimension()
+               << " components\n";
+        writer.floatArray("kProjection", projection->componentMatrix());
+        writer.floatArray("kProjectionOffset", projection->meanOffsets());
+        source << "\n";
+    }
+    source << body.str() << "\n";
+
+    source << "float predict(const float* x) {\n";
+    if (projection) {
+        size_t outputs = projection->outputDimension();
+        source << "    float projected[" << outputs << "];\n"
+               << "    for (std::size_t c = 0; c < " << outputs << "; c++) {\n"
+               << "        float sum = 0.0f;\n"
+               << "        for (std::size_t j = 0; j < kInputFeatures; j++) {\n"
+               << "            sum += kProjection[c * kInputFeatures + j] * x[j];\n"
+               << "        }\n"
+               << "        projected[c] = sum - kProjectionOffset[c];\n"
+               << "    }\n"
+               << "    return model(projected);\n";
+    } else {
+        source << "    return model(x);\n";
+    }
+    source << "}\n";
+    if (!options.classNames.empty() && model.isSupervised()) {
+        source << "\nconstexpr const char* kClassNames[" << options.classNames.size() << "] = {";
+        for (size_t c = 0; c < options.classNames.size(); c++) {
+            source << (c > 0 ? ", " : "") << "\"" << escape(options.classNames[c]) << "\"";
+        }
+        source << "};\n\n"
+               << "const char* predict_label(const float* x) {\n"
+               << "    return kClassNames[static_cast<std::size_t>(predict(x))];\n"
+               << "}\n";
+    }
+    source << "\n} // namespace ai_language_generated\n";
+
+    // benchmark harness: วัดเส้นทาง predict ของ interpreter ตอนนี้ แล้วฝังผลไว้เทียบกับโค้ดที่คอมไพล์แล้ว
+    size_t count = options.sampleRows ? options.sampleCount : 0;
+    if (count > 0) {
+        const float* rows = options.sampleRows;
+        size_t modelInputs = model.numFeatures();
+        std::vector<float> projected(projection ? count * modelInputs : 0);
+        std::vector<float> expected(count), single(modelInputs);
+        if (projection) {
+            projection->transform(rows, count, projected.data());
+        }
+        model.predictBatch(projection ? projected.data() : rows, count, expected.data());
+
+        report.interpreterRowNanos = timePerRow(count, [&]() {
+            for (size_t i = 0; i < count; i++) {
+                const float* row = rows + i * inputs;
+                if (projection) {
+                    projection->transform(row, 1, single.data());
+                    row = single.data();
+                }
+                volatile float result = model.predictOne(row);
+                (void)result;
+            }
+        });
+        std::vector<float> batch(count);
+        report.interpreterBatchNanos = timePerRow(count, [&]() {
+            if (projection) {
+                projection->transform(rows, count, projected.data());
+            }
+            model.predictBatch(projection ? projected.data() : rows, count, batch.data());
+        });
+        report.sampleRows = count;
+
+        char timing[128];
+        source << "\n#ifdef AI_LANGUAGE_BENCHMARK\n"
+               << "#include <chrono>\n#include <cstdio>\n\n"
+               << "namespace ai_language_generated {\nnamespace benchmark {\n\n"
+               << "constexpr std::size_t kRows = " << count << ";\n";
+        writer.floatArray("kInputs", rows, count * inputs);
+        source << "// Interpreter predictBatch output for kInputs\n";
+        writer.floatArray("kExpected", expected);
+        std::snprintf(timing, sizeof(timing), "constexpr double kInterpreterRowNanos = %.1f;\n", report.interpreterRowNanos);
+        source << "// Interpreter latency per row measured at export time (row-by-row predict and predictBatch)\n" << timing;
+        std::snprintf(timing, sizeof(timing), "constexpr double kInterpreterBatchNanos = %.1f;\n", report.interpreterBatchNanos);
+        source << timing
+               << "\n} // namespace benchmark\n} // namespace ai_language_generated\n\n"
+               << "int main() {\n"
+               << "    using namespace ai_language_generated;\n"
+               << "    using namespace ai_language_generated::benchmark;\n"
+               << "    std::size_t mismatches = 0;\n"
+               << "    double maxDiff = 0.0;\n"
+               << "    for (std::size_t i = 0; i < kRows; i++) {\n"
+               << "        double diff = std::fabs(static_cast<double>(predict(kInputs + i * kInputFeatures)) - kExpected[i]);\n"
+               << "        maxDiff = diff > maxDiff ? diff : maxDiff;\n"
+               << "        mismatches += diff > 1e-4 * (1.0 + std::fabs(static_cast<double>(kExpected[i])));\n"
+               << "    }\n\n"
+               << "    volatile float sink = 0.0f;\n"
+               << "    std::size_t calls = 0;\n"
+               << "    double seconds = 0.0;\n"
+               << "    auto start = std::chrono::steady_clock::now();\n"
+               << "    do {\n"
+               << "        for (std::size_t i = 0; i < kRows; i++) {\n"
+               << "            sink = sink + predict(kInputs + i * kInputFeatures);\n"
+               << "        }\n"
+               << "        calls += kRows;\n"
+               << "        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();\n"
+               << "    } while (seconds < " << kTimingSeconds << ");\n"
+               << "    double nanos = seconds * 1e9 / static_cast<double>(calls);\n\n"
+               << "    std::printf(\"" << escape(model.typeName()) << ": %zu rows, %zu input features\\n\", kRows, kInputFeatures);\n"
+               << "    std::printf(\"  %-28s %12s %10s\\n\", \"path\", \"latency/row\", \"speedup\");\n"
+               << "    std::printf(\"  %-28s %9.1f ns %9.1fx\\n\", \"generated predict()\", nanos, kInterpreterRowNanos / nanos);\n"
+               << "    std::printf(\"  %-28s %9.1f ns %9.1fx\\n\", \"interpreter predict (row)\", kInterpreterRowNanos, 1.0);\n"
+               << "    std::printf(\"  %-28s %9.1f ns %9.1fx\\n\", \"interpreter predictBatch\", kInterpreterBatchNanos,\n"
+               << "                kInterpreterRowNanos / kInterpreterBatchNanos);\n"
+               << "    std::printf(\"Agreement with interpreter: %zu/%zu rows (max |diff| %g)\\n\", kRows - mismatches, kRows, maxDiff);\n"
+               << "    return mismatches == 0 ? 0 : 1;\n"
+               << "}\n"
+               << "#endif // AI_LANGUAGE_BENCHMARK\n";
+    }
+
+    std::string text = source.str();
+    os << text;
+    report.bytes = text.size();
+    return report;
+}
+
+} // namespace ai_language
@@ -0,0 +1,230 @@
+#include "../../include/ml/Compare.h"
+#include "../../include/ml/Metrics.h"
+#include "../../include/ml/ModelFactory.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+namespace ai_language {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// จำนวนคอร์ที่การเทรนของแต่ละประเภทใช้ประโยชน์ได้ (ตาม parallelFor ภายใน fit)
+size_t trainingWidth(const std::string& type, const Dataset& train, const ModelParams& params, size_t cores) {
+    if (type == "LinearRegression" || type == "LogisticRegression" || type == "NaiveBayes") {
+        return 1;   // SGD และสถิติพอเพียงทำงานแบบลำดับเป็นส่วนใหญ่
+    }
+    if (type == "KNN") {
+        return params.getString("index", "auto") == "hnsw" ? cores : 1;
+    }
+    if (type == "DecisionTree") {
+        return std::min(train.cols, cores);   // ขนานตาม feature ในแต่ละโหนด
+    }
+    if (type == "SVM") {
+        size_t classes = train.numClasses();
+        return std::min<size_t>(classes > 2 ? classes : 1, cores);   // ปัญหาย่อย one-vs-rest
+    }
+    return cores;   // RandomForest, GradientBoosting, KMeans, Voting, Stacking
+}
+
+std::string formatBytes(size_t bytes) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if (bytes == 0) {
+        out << "-";
+    } else if (bytes < 1024) {
+        out << bytes << " B";
+    } else if (bytes < 1024 * 1024) {
+        out << bytes / 1024.0 << " KB";
+    } else {
+        out << bytes / (1024.0 * 1024.0) << " MB";
+    }
+    return out.str();
+}
+
+} // namespace
+
+std::vector<std::string> defaultComparisonModels(bool classification) {
+    if (classification) {
+        return {"LogisticRegression", "NaiveBayes", "DecisionTree", "KNN", "RandomForest", "GradientBoosting", "SVM"};
+    }
+    return {"LinearRegression", "DecisionTree", "KNN", "RandomForest", "GradientBoosting"};
+}
+
+void splitTrainTest(const std::vector<float>& labels, bool classification, double testSize, unsigned seed,
+                    std::vector<size_t>& trainRows, std::vector<size_t>& testRows) {
+    if (testSize <= 0.0 || testSize >= 1.0) {
+        throw std::invalid_argument("test_size must be between 0 and 1");
+    }
+    // สุ่มลำดับแล้วกันแถวแรกของแต่ละคลาสไว้ทดสอบ
+    const size_t rows = labels.size();
+    std::vector<size_t> order(rows);
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937 rng(seed);
+    std::shuffle(order.begin(), order.end(), rng);
+    size_t groups = 1;
+    if (classification) {
+        for (float label : labels) {
+            groups = std::max(groups, static_cast<size_t>(label) + 1);
+        }
+    }
+    std::vector<size_t> groupSize(groups, 0), groupTaken(groups, 0);
+    for (float label : labels) {
+        groupSize[classification ? static_cast<size_t>(label) : 0]++;
+    }
+    trainRows.clear();
+    testRows.clear();
+    for (size_t i : order) {
+        size_t group = classification ? static_cast<size_t>(labels[i]) : 0;
+        size_t quota = static_cast<size_t>(testSize * groupSize[group] + 0.5);
+        (groupTaken[group]++ < quota ? testRows : trainRows).push_back(i);
+    }
+    if (trainRows.empty() || testRows.empty()) {
+        throw std::invalid_argument("Dataset with " + std::to_string(rows) + " rows is too small to split");
+    }
+    // เรียงกลับตามลำดับเดิมเพื่อให้อ่านหน่วยความจำต่อเนื่อง
+    std::sort(trainRows.begin(), trainRows.end());
+    std::sort(testRows.begin(), testRows.end());
+}
+
+const ModelComparison* ComparisonReport::best() const {
+    return !results.empty() && results.front().ok() ? &results.front() : nullptr;
+}
+
+ComparisonReport compareModels(const Dataset& data, const std::vector<std::string>& types, const CompareOptions& options) {
+    if (types.empty()) {
+        throw std::invalid_argument("No models to compare");
+    }
+    ComparisonReport report;
+    report.classification = data.isClassification();
+
+    auto start = Clock::now();
+    std::vector<size_t> trainRows, testRows;
+    splitTrainTest(data.targets, report.classification, options.testSize, options.seed, trainRows, testRows);
+    Dataset train = data.subset(trainRows);
+    Dataset test = data.subset(testRows);
+    report.trainRows = train.rows;
+    report.testRows = test.rows;
+    report.splitSeconds = secondsSince(start);
+
+    size_t classes = report.classification ? data.numClasses() : 0;
+    report.cores = availableThreads();
+    std::vector<size_t> widths(types.size());
+    for (size_t t = 0; t < types.size(); t++) {
+        widths[t] = trainingWidth(types[t], train, options.params, report.cores);
+    }
+    // งานที่ใช้หลายคอร์ (และมักใช้เวลานาน) เริ่มก่อน
+    std::vector<size_t> taskOrder(types.size());
+    std::iota(taskOrder.begin(), taskOrder.end(), 0);
+    std::stable_sort(taskOrder.begin(), taskOrder.end(), [&](size_t a, size_t b) { return widths[a] > widths[b]; });
+
+    report.results.resize(types.size());
+    std::vector<std::unique_ptr<MLModel>> models(types.size());
+    start = Clock::now();
+    scheduleTasks(types.size(), [&](size_t task) { return widths[taskOrder[task]]; },
+                  [&](size_t task, size_t threads) {
+        size_t t = taskOrder[task];
+        ModelComparison& result = report.results[t];
+        result.type = types[t];
+        result.threads = threads;
+        try {
+            std::unique_ptr<MLModel> model = ModelFactory::createModel(types[t], options.params);
+            if (!model) {
+                result.error = "no native implementation";
+                return;
+            }
+            if (!model->isSupervised()) {
+                result.error = "does not use the target column";
+                return;
+            }
+            if (report.classification && types[t] == "LinearRegression") {
+                result.error = "predicts continuous values; use LogisticRegression for class labels";
+                return;
+            }
+            auto fitStart = Clock::now();
+            model->fit(train);
+            result.trainSeconds = secondsSince(fitStart);
+
+            std::vector<float> predicted(test.rows);
+            model->predictBatch(test.features.data(), test.rows, predicted.data());
+            MetricsReport metrics = MetricsEngine::evaluate(test.targets.data(), predicted.data(), test.rows,
+                                                            report.classification, classes);
+            result.score = report.classification ? metrics.accuracy : metrics.r2;
+            result.modelBytes = model->memoryBytes();
+            models[t] = std::move(model);
+        } catch (const std::exception& e) {
+            result.error = e.what();
+        }
+    });
+    report.trainWallSeconds = secondsSince(start);
+
+    // วัดเวลาทำนายทีละโมเดลเมื่อเครื่องว่าง
+    size_t latencyRows = std::min(options.latencyRows, test.rows);
+    for (size_t t = 0; t < types.size(); t++) {
+        if (!models[t]) {
+            continue;
+        }
+        ModelComparison& result = report.results[t];
+        std::vector<float> predicted(test.rows);
+        auto predictStart = Clock::now();
+        for (size_t i = 0; i < latencyRows; i++) {
+            predicted[i] = models[t]->predictOne(test.row(i));
+        }
+        result.latencyMicros = secondsSince(predictStart) * 1e6 / std::max<size_t>(latencyRows, 1);
+
+        predictStart = Clock::now();
+        models[t]->predictBatch(test.features.data(), test.rows, predicted.data());
+        result.batchMicros = secondsSince(predictStart) * 1e6 / test.rows;
+    }
+
+    std::stable_sort(report.results.begin(), report.results.end(), [](const ModelComparison& a, const ModelComparison& b) {
+        if (a.ok() != b.ok()) {
+            return a.ok();
+        }
+        return a.ok() && a.score > b.score;
+    });
+    return report;
+}
+
+void ComparisonReport::print(std::ostream& os) const {
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    const char* metric = classification ? "accuracy" : "R^2";
+    os << "Shared split: " << trainRows << " train / " << testRows << " test rows"
+       << (classification ? " (stratified)" : "") << ", " << results.size() << " models trained concurrently on "
+       << cores << (cores == 1 ? " core" : " cores") << " in " << std::fixed << std::setprecision(3)
+       << trainWallSeconds << "s\n";
+    os << "  " << std::left << std::setw(20) << "model" << std::right << std::setw(10) << metric << std::setw(11)
+       << "train" << std::setw(9) << "threads" << std::setw(14) << "latency/row" << std::setw(12) << "batch/row"
+       << std::setw(11) << "size" << "\n";
+    for (const ModelComparison& result : results) {
+        os << "  " << std::left << std::setw(20) << result.type << std::right;
+        if (!result.ok()) {
+            os << "  failed: " << result.error << "\n";
+            continue;
+        }
+        std::ostringstream train, latency, batch;
+        train << std::fixed << std::setprecision(3) << result.trainSeconds << "s";
+        latency << std::fixed << std::setprecision(2) << result.latencyMicros << "us";
+        batch << std::fixed << std::setprecision(2) << result.batchMicros << "us";
+        os << std::setw(10) << std::setprecision(4) << result.score << std::setw(11) << train.str() << std::setw(9)
+           << result.threads << std::setw(14) << latency.str() << std::setw(12) << batch.str() << std::setw(11)
+           << formatBytes(result.modelBytes) << "\n";
+    }
+    os.flags(flags);
+    os.precision(precision);
+}
+
+} // namespace ai_language
@@ -0,0 +1,364 @@
+#include "../../include/ml/Dataset.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+
+namespace ai_language {
+
+namespace {
+
+std::string trim(const std::string& text) {
+    size_t start = text.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(start, end - start + 1);
+}
+
+// รหัสใหม่ของแต่ละข้อความใน names ตามรายการอ้างอิง ข้อความที่ไม่มีถูกต่อท้าย reference
+std::vector<float> categoryMap(const std::vector<std::string>& names, std::vector<std::string>& reference) {
+    std::vector<float> map;
+    map.reserve(names.size());
+    for (const auto& name : names) {
+        auto it = std::find(reference.begin(), reference.end(), name);
+        if (it == reference.end()) {
+            reference.push_back(name);
+            map.push_back(static_cast<float>(reference.size() - 1));
+        } else {
+            map.push_back(static_cast<float>(it - reference.begin()));
+        }
+    }
+    return map;
+}
+
+float remapCode(float code, const std::vector<float>& map) {
+    return code >= 0 && static_cast<size_t>(code) < map.size() ? map[static_cast<size_t>(code)] : code;
+}
+
+std::vector<std::string> splitCsvLine(const std::string& line) {
+    std::vector<std::string> cells;
+    std::string cell;
+    bool inQuotes = false;
+    for (char c : line) {
+        if (c == '"') {
+            inQuotes = !inQuotes;
+        } else if (c == ',' && !inQuotes) {
+            cells.push_back(trim(cell));
+            cell.clear();
+        } else {
+            cell += c;
+        }
+    }
+    cells.push_back(trim(cell));
+    return cells;
+}
+
+bool parseNumber(const std::string& text, float& value) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    value = std::strtof(text.c_str(), &end);
+    return end != nullptr && *end == '\0';
+}
+
+// อ่านแถวที่ไม่ว่างทั้งหมดจากไฟล์
+bool readCsvRows(const std::string& path, std::vector<std::vector<std::string>>& rows, std::string& error) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        error = "Could not open file " + path;
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (trim(line).empty() || line[0] == '#') {
+            continue;
+        }
+        rows.push_back(splitCsvLine(line));
+    }
+    if (rows.empty()) {
+        error = "File " + path + " contains no data";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+std::string stripQuotes(const std::string& text) {
+    if (text.size() >= 2 && text.front() == '"' && text.back() == '"') {
+        return text.substr(1, text.size() - 2);
+    }
+    return text;
+}
+
+size_t Dataset::numClasses() const {
+    if (!classNames.empty()) {
+        return classNames.size();
+    }
+    float maxLabel = 0.0f;
+    for (float t : targets) {
+        maxLabel = std::max(maxLabel, t);
+    }
+    return static_cast<size_t>(maxLabel) + 1;
+}
+
+std::string Dataset::formatTarget(float value) const {
+    if (classification) {
+        long label = std::lround(value);
+        if (label >= 0 && static_cast<size_t>(label) < classNames.size()) {
+            return classNames[label];
+        }
+        return std::to_string(label);
+    }
+    std::ostringstream ss;
+    ss << value;
+    return ss.str();
+}
+
+Dataset Dataset::subset(const std::vector<size_t>& indices) const {
+    Dataset result;
+    result.featureNames = featureNames;
+    result.targetName = targetName;
+    result.classNames = classNames;
+    result.featureCategories = featureCategories;
+    result.classification = classification;
+    result.cols = cols;
+    result.rows = indices.size();
+    result.features.resize(result.rows * cols);
+    result.targets.resize(result.rows);
+    for (size_t i = 0; i < indices.size(); i++) {
+        std::copy(row(indices[i]), row(indices[i]) + cols, result.row(i));
+        result.targets[i] = targets[indices[i]];
+    }
+    return result;
+}
+
+bool Dataset::append(const Dataset& other) {
+    if (empty()) {
+        *this = other;
+        return true;
+    }
+    if (other.cols != cols) {
+        return false;
+    }
+
+    // จับคู่ชื่อคลาสและข้อความของแต่ละ feature ในข้อมูลใหม่กับรหัสเดิม
+    std::vector<float> classMap = categoryMap(other.classNames, classNames);
+    featureCategories.resize(cols);
+    std::vector<std::vector<float>> featureMaps(cols);
+    for (size_t c = 0; c < cols && c < other.featureCategories.size(); c++) {
+        featureMaps[c] = categoryMap(other.featureCategories[c], featureCategories[c]);
+    }
+
+    size_t first = features.size();
+    features.insert(features.end(), other.features.begin(), other.features.end());
+    for (size_t i = first; i < features.size(); i++) {
+        const std::vector<float>& map = featureMaps[(i - first) % cols];
+        if (!map.empty()) {
+            features[i] = remapCode(features[i], map);
+        }
+    }
+    for (float t : other.targets) {
+        targets.push_back(remapCode(t, classMap));
+    }
+    rows += other.rows;
+    classification = classification || other.classification;
+    return true;
+}
+
+void Dataset::alignClasses(const std::vector<std::string>& reference) {
+    if (classNames.empty() || reference.empty()) {
+        return;
+    }
+    std::vector<std::string> aligned = reference;
+    std::vector<float> classMap = categoryMap(classNames, aligned);
+    for (float& t : targets) {
+        t = remapCode(t, classMap);
+    }
+    classNames = std::move(aligned);
+}
+
+void Dataset::alignFeatureCategories(const std::vector<std::vector<std::string>>& reference) {
+    featureCategories.resize(cols);
+    for (size_t c = 0; c < cols && c < reference.size(); c++) {
+        if (featureCategories[c].empty() || reference[c].empty()) {
+            continue;
+        }
+        std::vector<std::string> aligned = reference[c];
+        std::vector<float> map = categoryMap(featureCategories[c], aligned);
+        for (size_t r = 0; r < rows; r++) {
+            row(r)[c] = remapCode(row(r)[c], map);
+        }
+        featureCategories[c] = std::move(aligned);
+    }
+}
+
+bool loadCsvDataset(const std::string& path, const std::string& targetColumn,
+                    Dataset& out, std::string& error) {
+    std::string cleanPath = stripQuotes(path);
+    std::vector<std::vector<std::string>> table;
+    if (!readCsvRows(cleanPath, table, error)) {
+        return false;
+    }
+
+    const std::vector<std::string>& header = table[0];
+    size_t columnCount = header.size();
+    if (columnCount < 2) {
+        error = "Dataset needs at least one feature column and one target column";
+        return false;
+    }
+    if (table.size() < 2) {
+        error = "Dataset has a header but no rows";
+        return false;
+    }
+
+    size_t targetIndex = columnCount - 1;
+    std::string cleanTarget = stripQuotes(targetColumn);
+    if (!cleanTarget.empty()) {
+        auto it = std::find(header.begin(), header.end(), cleanTarget);
+        if (it == header.end()) {
+            error = "Target column '" + cleanTarget + "' not found";
+            return false;
+        }
+        targetIndex = static_cast<size_t>(it - header.begin());
+    }
+
+    size_t rowCount = table.size() - 1;
+    std::vector<std::vector<float>> columns(columnCount, std::vector<float>(rowCount, 0.0f));
+    std::vector<std::vector<std::string>> categories(columnCount);
+
+    for (size_t c = 0; c < columnCount; c++) {
+        // คอลัมน์เป็นตัวเลขถ้าทุกช่องที่ไม่ว่างแปลงเป็นตัวเลขได้
+        bool numeric = true;
+        for (size_t r = 0; r < rowCount && numeric; r++) {
+            const auto& cells = table[r + 1];
+            float value;
+            if (c < cells.size() && !cells[c].empty() && !parseNumber(cells[c], value)) {
+                numeric = false;
+            }
+        }
+
+        double sum = 0.0;
+        size_t present = 0;
+        std::vector<bool> missing(rowCount, false);
+        std::unordered_map<std::string, float> codes;
+        for (size_t r = 0; r < rowCount; r++) {
+            const auto& cells = table[r + 1];
+            std::string cell = c < cells.size() ? cells[c] : "";
+            if (numeric) {
+                float value;
+                if (parseNumber(cell, value)) {
+                    columns[c][r] = value;
+                    sum += value;
+                    present++;
+                } else {
+                    missing[r] = true;
+                }
+            } else {
+                auto it = codes.find(cell);
+                if (it == codes.end()) {
+                    float code = static_cast<float>(categories[c].size());
+                    codes[cell] = code;
+                    categories[c].push_back(cell);
+                    columns[c][r] = code;
+                } else {
+                    columns[c][r] = it->second;
+                }
+            }
+        }
+
+        // เติมค่าที่หายไปด้วยค่าเฉลี่ยของคอลัมน์
+        if (numeric && present < rowCount) {
+            float mean = present > 0 ? static_cast<float>(sum / present) : 0.0f;
+            for (size_t r = 0; r < rowCount; r++) {
+                if (missing[r]) {
+                    columns[c][r] = mean;
+                }
+            }
+        }
+    }
+
+    Dataset result;
+    result.rows = rowCount;
+    result.cols = columnCount - 1;
+    result.targetName = header[targetIndex];
+    for (size_t c = 0; c < columnCount; c++) {
+        if (c != targetIndex) {
+            result.featureNames.push_back(header[c]);
+            result.featureCategories.push_back(categories[c]);
+        }
+    }
+    result.features.resize(result.rows * result.cols);
+    for (size_t r = 0; r < rowCount; r++) {
+        float* dst = result.row(r);
+        for (size_t c = 0, f = 0; c < columnCount; c++) {
+            if (c != targetIndex) {
+                dst[f++] = columns[c][r];
+            }
+        }
+    }
+    result.targets = std::move(columns[targetIndex]);
+    result.classNames = categories[targetIndex];
+
+    if (!result.classNames.empty()) {
+        result.classification = true;
+    } else {
+        std::set<float> distinct;
+        bool integral = true;
+        for (float t : result.targets) {
+            if (t < 0 || std::floor(t) != t) {
+                integral = false;
+                break;
+            }
+            distinct.insert(t);
+        }
+        result.classification = integral && distinct.size() <= 20 && distinct.size() * 2 <= rowCount;
+    }
+
+    out = std::move(result);
+    return true;
+}
+
+bool loadCsvFeatures(const std::string& path, size_t expectedCols,
+                     std::vector<float>& out, size_t& rows, std::string& error) {
+    std::vector<std::vector<std::string>> table;
+    if (!readCsvRows(stripQuotes(path), table, error)) {
+        return false;
+    }
+
+    size_t start = 0;
+    float probe;
+    if (!table[0].empty() && !parseNumber(table[0][0], probe)) {
+        start = 1; // แถวแรกเป็นหัวตาราง
+    }
+
+    out.clear();
+    rows = 0;
+    for (size_t r = start; r < table.size(); r++) {
+        const auto& cells = table[r];
+        if (cells.size() != expectedCols && cells.size() != expectedCols + 1) {
+            error = "Row " + std::to_string(r + 1) + " has " + std::to_string(cells.size()) +
+                    " columns, expected " + std::to_string(expectedCols);
+            return false;
+        }
+        for (size_t c = 0; c < expectedCols; c++) {
+            float value = 0.0f;
+            if (!parseNumber(cells[c], value)) {
+                error = "Non-numeric value '" + cells[c] + "' in row " + std::to_string(r + 1);
+                return false;
+            }
+            out.push_back(value);
+        }
+        rows++;
+    }
+    return true;
+}
+
+} // namespace ai_language
@@ -0,0 +1,296 @@
+#include "../../include/ml/DecisionTree.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace ai_language {
+
+namespace {
+
+constexpr size_t kMaxBins = 256;
+constexpr size_t kBinSampleRows = 200000;
+
+struct SplitCandidate {
+    double gain = 0.0;
+    int32_t feature = -1;
+    uint8_t bin = 0;
+};
+
+} // namespace
+
+void FeatureBinner::fit(const Dataset& data, size_t maxBins) {
+    maxBins = std::max<size_t>(2, std::min(maxBins, kMaxBins));
+    edges.assign(data.cols, {});
+    size_t step = std::max<size_t>(1, data.rows / kBinSampleRows);
+
+    parallelFor(0, data.cols, [&](size_t begin, size_t end, size_t) {
+        std::vector<float> values;
+        for (size_t f = begin; f < end; f++) {
+            values.clear();
+            for (size_t i = 0; i < data.rows; i += step) {
+                values.push_back(data.row(i)[f]);
+            }
+            std::sort(values.begin(), values.end());
+            std::vector<float> distinct(values);
+            distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+
+            std::vector<float>& cut = edges[f];
+            if (distinct.size() <= maxBins) {
+                for (size_t k = 0; k + 1 < distinct.size(); k++) {
+                    cut.push_back(distinct[k] + (distinct[k + 1] - distinct[k]) * 0.5f);
+                }
+                continue;
+            }
+            // ควอนไทล์: ขอบอยู่ระหว่างค่าที่ตำแหน่งควอนไทล์กับค่าถัดไปที่มากกว่า
+            for (size_t k = 1; k < maxBins; k++) {
+                float value = values[k * values.size() / maxBins];
+                auto next = std::upper_bound(distinct.begin(), distinct.end(), value);
+                if (next == distinct.end()) {
+                    break;
+                }
+                float edge = value + (*next - value) * 0.5f;
+                if (cut.empty() || edge > cut.back()) {
+                    cut.push_back(edge);
+                }
+            }
+        }
+    });
+}
+
+uint8_t FeatureBinner::bin(size_t feature, float value) const {
+    const std::vector<float>& cut = edges[feature];
+    return static_cast<uint8_t>(std::lower_bound(cut.begin(), cut.end(), value) - cut.begin());
+}
+
+void FeatureBinner::transformColumns(const Dataset& data, std::vector<uint8_t>& out) const {
+    out.resize(data.cols * data.rows);
+    parallelFor(0, data.cols, [&](size_t begin, size_t end, size_t) {
+        for (size_t f = begin; f < end; f++) {
+            uint8_t* column = out.data() + f * data.rows;
+            for (size_t i = 0; i < data.rows; i++) {
+                column[i] = bin(f, data.row(i)[f]);
+            }
+        }
+    });
+}
+
+void FeatureBinner::transformRows(const float* rows, size_t count, uint8_t* out) const {
+    size_t cols = edges.size();
+    for (size_t i = 0; i < count; i++) {
+        for (size_t f = 0; f < cols; f++) {
+            out[i * cols + f] = bin(f, rows[i * cols + f]);
+        }
+    }
+}
+
+const float* DecisionTree::evaluate(const float* row) const {
+    const TreeNode* node = &nodes[0];
+    while (node->feature >= 0) {
+        node = &nodes[row[node->feature] <= node->threshold ? node->left : node->right];
+    }
+    return leafValues.data() + node->leaf * outputs;
+}
+
+const float* DecisionTree::evaluateBinned(const uint8_t* columns, size_t rows, size_t index) const {
+    const TreeNode* node = &nodes[0];
+    while (node->feature >= 0) {
+        uint8_t value = columns[static_cast<size_t>(node->feature) * rows + index];
+        node = &nodes[value <= node->bin ? node->left : node->right];
+    }
+    return leafValues.data() + node->leaf * outputs;
+}
+
+size_t DecisionTree::depth() const {
+    if (nodes.empty()) {
+        return 0;
+    }
+    size_t maxDepth = 0;
+    std::vector<std::pair<int32_t, size_t>> stack = {{0, 0}};
+    while (!stack.empty()) {
+        auto [node, level] = stack.back();
+        stack.pop_back();
+        maxDepth = std::max(maxDepth, level);
+        if (nodes[node].feature >= 0) {
+            stack.emplace_back(nodes[node].left, level + 1);
+            stack.emplace_back(nodes[node].right, level + 1);
+        }
+    }
+    return maxDepth;
+}
+
+TreeBuilder::TreeBuilder(const FeatureBinner& binner, const std::vector<uint8_t>& columns, size_t rows)
+    : binner(binner), columns(columns), rows(rows), cols(binner.numFeatures()) {
+}
+
+DecisionTree TreeBuilder::buildClassifier(const std::vector<float>& labels, size_t classes,
+                                          std::vector<uint32_t> rowIndex, const TreeBuildParams& params) const {
+    return build(&labels, classes, nullptr, nullptr, rowIndex, params);
+}
+
+DecisionTree TreeBuilder::buildRegressor(const std::vector<float>& gradients, const std::vector<float>& hessians,
+                                         std::vector<uint32_t> rowIndex, const TreeBuildParams& params) const {
+    return build(nullptr, 0, &gradients, &hessians, rowIndex, params);
+}
+
+DecisionTree TreeBuilder::build(const std::vector<float>* labels, size_t classes,
+                                const std::vector<float>* gradients, const std::vector<float>* hessians,
+                                std::vector<uint32_t>& rowIndex, const TreeBuildParams& params) const {
+    if (rowIndex.empty()) {
+        throw std::invalid_argument("Cannot build a tree without rows");
+    }
+    const bool gini = labels != nullptr;
+    // histogram ต่อช่วง: [จำนวนแถว, สถิติ...] โดยสถิติคือจำนวนต่อคลาส (Gini) หรือ G, H (gradient)
+    const size_t stride = 1 + (gini ? classes : 2);
+    const double lambda = params.lambda;
+
+    auto score = [&](const double* stats) {
+        if (stats[0] <= 0.0) {
+            return 0.0;
+        }
+        if (gini) {
+            double sum = 0.0;
+            for (size_t c = 0; c < classes; c++) {
+                sum += stats[1 + c] * stats[1 + c];
+            }
+            return sum / stats[0];
+        }
+        double denom = stats[2] + lambda;
+        return denom > 0.0 ? stats[1] * stats[1] / denom : 0.0;
+    };
+    auto accumulate = [&](double* stats, uint32_t row) {
+        stats[0] += 1.0;
+        if (gini) {
+            stats[1 + static_cast<size_t>((*labels)[row])] += 1.0;
+        } else {
+            stats[1] += (*gradients)[row];
+            stats[2] += (*hessians)[row];
+        }
+    };
+
+    DecisionTree tree;
+    tree.outputs = gini ? classes : 1;
+    std::mt19937 rng(params.seed);
+    std::vector<size_t> featureOrder(cols);
+    std::iota(featureOrder.begin(), featureOrder.end(), 0);
+    size_t candidateCount = params.maxFeatures > 0 ? std::min(params.maxFeatures, cols) : cols;
+
+    struct Task {
+        size_t begin;
+        size_t end;
+        int32_t parent;
+        bool left;
+        size_t depth;
+    };
+    std::vector<Task> stack = {{0, rowIndex.size(), -1, false, 0}};
+    std::vector<double> total(stride);
+
+    while (!stack.empty()) {
+        Task task = stack.back();
+        stack.pop_back();
+        int32_t id = static_cast<int32_t>(tree.nodes.size());
+        tree.nodes.emplace_back();
+        if (task.parent >= 0) {
+            (task.left ? tree.nodes[task.parent].left : tree.nodes[task.parent].right) = id;
+        }
+
+        std::fill(total.begin(), total.end(), 0.0);
+        for (size_t r = task.begin; r < task.end; r++) {
+            accumulate(total.data(), rowIndex[r]);
+        }
+        size_t count = task.end - task.begin;
+        tree.nodes[id].samples = static_cast<uint32_t>(count);
+
+        bool pure = gini && std::any_of(total.begin() + 1, total.end(),
+                                        [&](double c) { return c == static_cast<double>(count); });
+        SplitCandidate best;
+        if (!pure && task.depth < params.maxDepth && count >= params.minSamplesSplit &&
+            count >= 2 * params.minSamplesLeaf) {
+            if (candidateCount < cols) {
+                for (size_t k = 0; k < candidateCount; k++) {
+                    std::uniform_int_distribution<size_t> pick(k, cols - 1);
+                    std::swap(featureOrder[k], featureOrder[pick(rng)]);
+                }
+            }
+            double parentScore = score(total.data());
+            std::vector<SplitCandidate> perFeature(candidateCount);
+
+            // histogram ของแต่ละ feature อิสระต่อกัน จึงแบ่ง features ให้หลายเธรดได้
+            size_t minChunk = std::max<size_t>(1, 32768 / std::max<size_t>(1, count));
+            parallelFor(0, candidateCount, [&](size_t begin, size_t end, size_t) {
+                std::vector<double> hist(kMaxBins * stride);
+                std::vector<double> left(stride), right(stride);
+                for (size_t k = begin; k < end; k++) {
+                    size_t f = featureOrder[k];
+                    size_t bins = binner.numBins(f);
+                    if (bins < 2) {
+                        continue;
+                    }
+                    std::fill(hist.begin(), hist.begin() + bins * stride, 0.0);
+                    const uint8_t* column = columns.data() + f * rows;
+                    for (size_t r = task.begin; r < task.end; r++) {
+                        uint32_t row = rowIndex[r];
+                        accumulate(hist.data() + column[row] * stride, row);
+                    }
+                    std::fill(left.begin(), left.end(), 0.0);
+                    for (size_t b = 0; b + 1 < bins; b++) {
+                        const double* h = hist.data() + b * stride;
+                        for (size_t s = 0; s < stride; s++) {
+                            left[s] += h[s];
+                            right[s] = total[s] - left[s];
+                        }
+                        if (h[0] == 0.0 || left[0] < params.minSamplesLeaf) {
+                            continue;
+                        }
+                        if (right[0] < params.minSamplesLeaf) {
+                            break;
+                        }
+                        double gain = score(left.data()) + score(right.data()) - parentScore;
+                        if (gain > perFeature[k].gain) {
+                            perFeature[k] = {gain, static_cast<int32_t>(f), static_cast<uint8_t>(b)};
+                        }
+                    }
+                }
+            }, minChunk);
+            for (const auto& candidate : perFeature) {
+                if (candidate.feature >= 0 && candidate.gain > best.gain) {
+                    best = candidate;
+                }
+            }
+        }
+
+        if (best.feature < 0 || best.gain <= params.minGain) {
+            TreeNode& leaf = tree.nodes[id];
+            leaf.leaf = static_cast<uint32_t>(tree.leafCount());
+            if (gini) {
+                for (size_t c = 0; c < classes; c++) {
+                    tree.leafValues.push_back(static_cast<float>(total[1 + c] / total[0]));
+                }
+            } else {
+                double denom = total[2] + lambda;
+                double value = denom > 0.0 ? -total[1] / denom : 0.0;
+                tree.leafValues.push_back(static_cast<float>(value * params.leafScale));
+            }
+            continue;
+        }
+
+        const uint8_t* column = columns.data() + static_cast<size_t>(best.feature) * rows;
+        auto middle = std::partition(rowIndex.begin() + task.begin, rowIndex.begin() + task.end,
+                                     [&](uint32_t row) { return column[row] <= best.bin; });
+        size_t mid = static_cast<size_t>(middle - rowIndex.begin());
+
+        TreeNode& node = tree.nodes[id];
+        node.feature = best.feature;
+        node.bin = best.bin;
+        node.threshold = binner.threshold(static_cast<size_t>(best.feature), best.bin);
+        node.gain = static_cast<float>(best.gain);
+        // ใส่ขวาก่อนเพื่อให้ลูกซ้ายถูกสร้างต่อจากพ่อทันที (ลำดับ depth-first)
+        stack.push_back({mid, task.end, id, false, task.depth + 1});
+        stack.push_back({task.begin, mid, id, true, task.depth + 1});
+    }
+    return tree;
+}
+
+} // namespace ai_language
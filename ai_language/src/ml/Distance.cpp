@@ -0,0 +1,320 @@
+#include "../../include/ml/Distance.h"
+#include "../../include/utils/cpu_features.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define AI_LANGUAGE_X86 1
+#endif
+
+namespace ai_language {
+
+namespace {
+
+float squaredL2Scalar(const float* a, const float* b, size_t dim) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < dim; i++) {
+        float d = a[i] - b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+float dotScalar(const float* a, const float* b, size_t dim) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < dim; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+void cosineTermsScalar(const float* a, const float* b, size_t dim, float& ab, float& aa, float& bb) {
+    ab = aa = bb = 0.0f;
+    for (size_t i = 0; i < dim; i++) {
+        ab += a[i] * b[i];
+        aa += a[i] * a[i];
+        bb += b[i] * b[i];
+    }
+}
+
+#ifdef AI_LANGUAGE_X86
+
+__attribute__((target("avx2,fma")))
+inline float horizontalSum(__m256 v) {
+    __m128 low = _mm256_castps256_ps128(v);
+    __m128 high = _mm256_extractf128_ps(v, 1);
+    low = _mm_add_ps(low, high);
+    __m128 shuf = _mm_movehdup_ps(low);
+    __m128 sums = _mm_add_ps(low, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    sums = _mm_add_ss(sums, shuf);
+    return _mm_cvtss_f32(sums);
+}
+
+__attribute__((target("avx2,fma")))
+float squaredL2Avx2(const float* a, const float* b, size_t dim) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= dim; i += 16) {
+        __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+        acc0 = _mm256_fmadd_ps(d0, d0, acc0);
+        acc1 = _mm256_fmadd_ps(d1, d1, acc1);
+    }
+    for (; i + 8 <= dim; i += 8) {
+        __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        acc0 = _mm256_fmadd_ps(d0, d0, acc0);
+    }
+    float sum = horizontalSum(_mm256_add_ps(acc0, acc1));
+    for (; i < dim; i++) {
+        float d = a[i] - b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+__attribute__((target("avx2,fma")))
+float dotAvx2(const float* a, const float* b, size_t dim) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= dim; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    for (; i + 8 <= dim; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    }
+    float sum = horizontalSum(_mm256_add_ps(acc0, acc1));
+    for (; i < dim; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+__attribute__((target("avx2,fma")))
+void cosineTermsAvx2(const float* a, const float* b, size_t dim, float& ab, float& aa, float& bb) {
+    __m256 accAB = _mm256_setzero_ps();
+    __m256 accAA = _mm256_setzero_ps();
+    __m256 accBB = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= dim; i += 8) {
+        __m256 va = _mm256_loadu_ps(a + i);
+        __m256 vb = _mm256_loadu_ps(b + i);
+        accAB = _mm256_fmadd_ps(va, vb, accAB);
+        accAA = _mm256_fmadd_ps(va, va, accAA);
+        accBB = _mm256_fmadd_ps(vb, vb, accBB);
+    }
+    ab = horizontalSum(accAB);
+    aa = horizontalSum(accAA);
+    bb = horizontalSum(accBB);
+    for (; i < dim; i++) {
+        ab += a[i] * b[i];
+        aa += a[i] * a[i];
+        bb += b[i] * b[i];
+    }
+}
+
+// microkernel 4 queries x 2 points: โหลด 6 เวกเตอร์ต่อ 8 FMA
+__attribute__((target("avx2,fma")))
+void dotTileAvx2(const float* queries, size_t m, const float* points, size_t n,
+                 size_t dim, float* out, size_t ldOut) {
+    size_t i = 0;
+    for (; i + 4 <= m; i += 4) {
+        const float* q0 = queries + (i + 0) * dim;
+        const float* q1 = queries + (i + 1) * dim;
+        const float* q2 = queries + (i + 2) * dim;
+        const float* q3 = queries + (i + 3) * dim;
+        size_t j = 0;
+        for (; j + 2 <= n; j += 2) {
+            const float* x0 = points + j * dim;
+            const float* x1 = x0 + dim;
+            __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+            __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+            __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+            __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+            size_t k = 0;
+            for (; k + 8 <= dim; k += 8) {
+                __m256 vx0 = _mm256_loadu_ps(x0 + k);
+                __m256 vx1 = _mm256_loadu_ps(x1 + k);
+                __m256 vq = _mm256_loadu_ps(q0 + k);
+                c00 = _mm256_fmadd_ps(vq, vx0, c00);
+                c01 = _mm256_fmadd_ps(vq, vx1, c01);
+                vq = _mm256_loadu_ps(q1 + k);
+                c10 = _mm256_fmadd_ps(vq, vx0, c10);
+                c11 = _mm256_fmadd_ps(vq, vx1, c11);
+                vq = _mm256_loadu_ps(q2 + k);
+                c20 = _mm256_fmadd_ps(vq, vx0, c20);
+                c21 = _mm256_fmadd_ps(vq, vx1, c21);
+                vq = _mm256_loadu_ps(q3 + k);
+                c30 = _mm256_fmadd_ps(vq, vx0, c30);
+                c31 = _mm256_fmadd_ps(vq, vx1, c31);
+            }
+            float r[4][2] = {
+                {horizontalSum(c00), horizontalSum(c01)},
+                {horizontalSum(c10), horizontalSum(c11)},
+                {horizontalSum(c20), horizontalSum(c21)},
+                {horizontalSum(c30), horizontalSum(c31)}};
+            const float* qs[4] = {q0, q1, q2, q3};
+            for (; k < dim; k++) {
+                for (int a = 0; a < 4; a++) {
+                    r[a][0] += qs[a][k] * x0[k];
+                    r[a][1] += qs[a][k] * x1[k];
+                }
+            }
+            for (int a = 0; a < 4; a++) {
+                out[(i + a) * ldOut + j] = r[a][0];
+                out[(i + a) * ldOut + j + 1] = r[a][1];
+            }
+        }
+        for (; j < n; j++) {
+            const float* x = points + j * dim;
+            out[(i + 0) * ldOut + j] = dotAvx2(q0, x, dim);
+            out[(i + 1) * ldOut + j] = dotAvx2(q1, x, dim);
+            out[(i + 2) * ldOut + j] = dotAvx2(q2, x, dim);
+            out[(i + 3) * ldOut + j] = dotAvx2(q3, x, dim);
+        }
+    }
+    for (; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            out[i * ldOut + j] = dotAvx2(queries + i * dim, points + j * dim, dim);
+        }
+    }
+}
+
+// exp(x) สำหรับ x <= 0 แบบ Cephes: แยก x = n ln2 + r แล้วประมาณ e^r ด้วยพหุนามดีกรี 6
+__attribute__((target("avx2,fma")))
+inline __m256 expAvx2(__m256 x) {
+    const __m256 log2e = _mm256_set1_ps(1.44269504088896341f);
+    const __m256 ln2High = _mm256_set1_ps(0.693359375f);
+    const __m256 ln2Low = _mm256_set1_ps(-2.12194440e-4f);
+    x = _mm256_max_ps(x, _mm256_set1_ps(-87.3f));
+    x = _mm256_min_ps(x, _mm256_set1_ps(88.3f));
+    __m256 n = _mm256_floor_ps(_mm256_fmadd_ps(x, log2e, _mm256_set1_ps(0.5f)));
+    __m256 r = _mm256_fnmadd_ps(n, ln2High, x);
+    r = _mm256_fnmadd_ps(n, ln2Low, r);
+    __m256 p = _mm256_set1_ps(1.9875691500e-4f);
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.3981999507e-3f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(8.3334519073e-3f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(4.1665795894e-2f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.6666665459e-1f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(5.0000001201e-1f));
+    p = _mm256_fmadd_ps(p, _mm256_mul_ps(r, r), _mm256_add_ps(r, _mm256_set1_ps(1.0f)));
+    __m256i exponent = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+    return _mm256_mul_ps(p, _mm256_castsi256_ps(exponent));
+}
+
+__attribute__((target("avx2,fma")))
+void rbfFinishAvx2(float* row, float queryNorm, const float* pointNorms, size_t n, float gamma) {
+    const __m256 qn = _mm256_set1_ps(queryNorm);
+    const __m256 minusTwo = _mm256_set1_ps(-2.0f);
+    const __m256 negGamma = _mm256_set1_ps(-gamma);
+    const __m256 zero = _mm256_setzero_ps();
+    size_t j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m256 d = _mm256_fmadd_ps(minusTwo, _mm256_loadu_ps(row + j),
+                                   _mm256_add_ps(qn, _mm256_loadu_ps(pointNorms + j)));
+        d = _mm256_max_ps(d, zero);
+        _mm256_storeu_ps(row + j, expAvx2(_mm256_mul_ps(negGamma, d)));
+    }
+    for (; j < n; j++) {
+        float d = std::max(0.0f, queryNorm + pointNorms[j] - 2.0f * row[j]);
+        row[j] = std::exp(-gamma * d);
+    }
+}
+
+#endif // AI_LANGUAGE_X86
+
+} // namespace
+
+bool parseDistanceMetric(const std::string& name, DistanceMetric& metric) {
+    if (name == "euclidean" || name == "l2") {
+        metric = DistanceMetric::Euclidean;
+        return true;
+    }
+    if (name == "cosine") {
+        metric = DistanceMetric::Cosine;
+        return true;
+    }
+    return false;
+}
+
+float squaredL2(const float* a, const float* b, size_t dim) {
+#ifdef AI_LANGUAGE_X86
+    if (cpuHasAvx2()) {
+        return squaredL2Avx2(a, b, dim);
+    }
+#endif
+    return squaredL2Scalar(a, b, dim);
+}
+
+float dotProduct(const float* a, const float* b, size_t dim) {
+#ifdef AI_LANGUAGE_X86
+    if (cpuHasAvx2()) {
+        return dotAvx2(a, b, dim);
+    }
+#endif
+    return dotScalar(a, b, dim);
+}
+
+float cosineDistance(const float* a, const float* b, size_t dim) {
+    float ab, aa, bb;
+#ifdef AI_LANGUAGE_X86
+    if (cpuHasAvx2()) {
+        cosineTermsAvx2(a, b, dim, ab, aa, bb);
+    } else {
+        cosineTermsScalar(a, b, dim, ab, aa, bb);
+    }
+#else
+    cosineTermsScalar(a, b, dim, ab, aa, bb);
+#endif
+    float denom = std::sqrt(aa) * std::sqrt(bb);
+    if (denom <= 0.0f) {
+        return 1.0f;
+    }
+    return 1.0f - ab / denom;
+}
+
+void squaredNorms(const float* rows, size_t count, size_t dim, float* out) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = dotProduct(rows + i * dim, rows + i * dim, dim);
+    }
+}
+
+void dotTile(const float* queries, size_t m, const float* points, size_t n,
+             size_t dim, float* out, size_t ldOut) {
+#ifdef AI_LANGUAGE_X86
+    if (cpuHasAvx2()) {
+        dotTileAvx2(queries, m, points, n, dim, out, ldOut);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            out[i * ldOut + j] = dotScalar(queries + i * dim, points + j * dim, dim);
+        }
+    }
+}
+
+void rbfKernelTile(const float* queries, const float* queryNorms, size_t m,
+                   const float* points, const float* pointNorms, size_t n,
+                   size_t dim, float gamma, float* out, size_t ldOut) {
+    dotTile(queries, m, points, n, dim, out, ldOut);
+    for (size_t i = 0; i < m; i++) {
+        float* row = out + i * ldOut;
+#ifdef AI_LANGUAGE_X86
+        if (cpuHasAvx2()) {
+            rbfFinishAvx2(row, queryNorms[i], pointNorms, n, gamma);
+            continue;
+        }
+#endif
+        for (size_t j = 0; j < n; j++) {
+            float d = std::max(0.0f, queryNorms[i] + pointNorms[j] - 2.0f * row[j]);
+            row[j] = std::exp(-gamma * d);
+        }
+    }
+}
+
+} // namespace ai_language
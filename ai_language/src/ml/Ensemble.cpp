@@ -0,0 +1,389 @@
+#include "../../include/ml/Ensemble.h"
+#include "../../include/ml/ModelFactory.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace ai_language {
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t");
+    size_t end = text.find_last_not_of(" \t");
+    return begin == std::string::npos ? "" : text.substr(begin, end - begin + 1);
+}
+
+// โมเดลที่ใช้เป็นโมเดลพื้นฐานหรือ meta-learner ได้: มี implementation, ใช้เป้าหมาย และไม่ซ้อน ensemble
+void checkLearnerType(const std::string& type) {
+    if (type == "Voting" || type == "Stacking") {
+        throw std::invalid_argument("Ensembles cannot contain " + type);
+    }
+    if (type == "KMeans") {
+        throw std::invalid_argument("KMeans does not use the target column and cannot be part of an ensemble");
+    }
+    if (!ModelFactory::isNativeModel(type)) {
+        throw std::invalid_argument("Unknown model type in ensemble: " + type);
+    }
+}
+
+// accuracy สำหรับการจำแนกประเภท หรือ R^2 สำหรับการถดถอย
+double score(const std::vector<float>& predicted, const std::vector<float>& targets, bool classification) {
+    size_t n = targets.size();
+    if (classification) {
+        size_t correct = 0;
+        for (size_t i = 0; i < n; i++) {
+            correct += predicted[i] == targets[i];
+        }
+        return n > 0 ? static_cast<double>(correct) / n : 0.0;
+    }
+    double mean = n > 0 ? std::accumulate(targets.begin(), targets.end(), 0.0) / n : 0.0;
+    double residual = 0.0, total = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        residual += (predicted[i] - targets[i]) * static_cast<double>(predicted[i] - targets[i]);
+        total += (targets[i] - mean) * (targets[i] - mean);
+    }
+    return total > 0.0 ? 1.0 - residual / total : 0.0;
+}
+
+} // namespace
+
+EnsembleModel::EnsembleModel(const ModelParams& params)
+    : learnerParams(params), seed(static_cast<unsigned>(params.get("random_state", 42))) {
+    std::string list = params.getString("estimators", "");
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        std::string type = trim(list.substr(start, comma == std::string::npos ? std::string::npos : comma - start));
+        if (!type.empty()) {
+            checkLearnerType(type);
+            types.push_back(type);
+        }
+        if (comma == std::string::npos) {
+            break;
+        }
+        start = comma + 1;
+    }
+    if (types.size() < 2) {
+        throw std::invalid_argument("An ensemble needs at least two models, e.g. 'create model Stacking with "
+                                    "LinearRegression, RandomForest, KNN'");
+    }
+    learnerParams.text.erase("estimators");
+}
+
+std::unique_ptr<MLModel> EnsembleModel::createLearner(size_t index) const {
+    return ModelFactory::createModel(types[index], learnerParams);
+}
+
+void EnsembleModel::fit(const Dataset& data) {
+    if (data.empty()) {
+        throw std::invalid_argument("Dataset is empty");
+    }
+    featureCount = data.cols;
+    classification = data.isClassification();
+    classes = classification ? data.numClasses() : 0;
+    size_t count = types.size();
+    learners.clear();
+    learners.resize(count);
+    learnerSeconds.assign(count, 0.0);
+
+    // งานแรกคือการเทรนบนข้อมูลทั้งหมด (ใหญ่ที่สุด จึงเริ่มก่อน) ตามด้วยงานเพิ่มเติมของ Stacking
+    taskCount = count + extraTasks(data);
+    std::vector<double> seconds(taskCount, 0.0);
+    std::atomic<size_t> next(0);
+    auto start = std::chrono::steady_clock::now();
+    parallelFor(0, parallelChunks(taskCount), [&](size_t, size_t, size_t) {
+        for (size_t task = next++; task < taskCount; task = next++) {
+            auto taskStart = std::chrono::steady_clock::now();
+            if (task < count) {
+                std::unique_ptr<MLModel> model = createLearner(task);
+                model->fit(data);
+                learners[task] = std::move(model);
+            } else {
+                runExtraTask(data, task - count);
+            }
+            seconds[task] = secondsSince(taskStart);
+        }
+    });
+    wallSeconds = secondsSince(start);
+    taskSeconds = std::accumulate(seconds.begin(), seconds.end(), 0.0);
+    std::copy(seconds.begin(), seconds.begin() + count, learnerSeconds.begin());
+    finishFit(data);
+}
+
+size_t EnsembleModel::memoryBytes() const {
+    size_t bytes = 0;
+    for (const auto& learner : learners) {
+        bytes += learner->memoryBytes();
+    }
+    return bytes;
+}
+
+void EnsembleModel::describe(std::ostream& os) const {
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << typeName() << " of " << types.size() << " models trained concurrently: " << taskCount << " tasks in "
+       << std::fixed << std::setprecision(4) << wallSeconds << "s wall (" << taskSeconds << "s of training, "
+       << maxThreads() << (maxThreads() == 1 ? " thread)\n" : " threads)\n");
+    for (size_t m = 0; m < types.size(); m++) {
+        os << "  " << std::left << std::setw(20) << types[m] << std::right << " full fit " << learnerSeconds[m] << "s\n";
+    }
+    os.flags(flags);
+    os.precision(precision);
+    describeCombiner(os);
+}
+
+std::vector<float> VotingModel::learnerPredictions(const float* rows, size_t count) const {
+    if (learners.empty()) {
+        throw std::runtime_error("Voting model has not been trained");
+    }
+    size_t width = learners.size();
+    std::vector<float> all(count * width), column(count);
+    for (size_t m = 0; m < width; m++) {
+        learners[m]->predictBatch(rows, count, column.data());
+        for (size_t i = 0; i < count; i++) {
+            all[i * width + m] = column[i];
+        }
+    }
+    return all;
+}
+
+void VotingModel::predictBatch(const float* rows, size_t count, float* out) const {
+    std::vector<float> all = learnerPredictions(rows, count);
+    size_t width = learners.size();
+    std::vector<size_t> votes(classes);
+    for (size_t i = 0; i < count; i++) {
+        const float* row = all.data() + i * width;
+        if (!classification) {
+            out[i] = std::accumulate(row, row + width, 0.0f) / static_cast<float>(width);
+            continue;
+        }
+        // เสียงข้างมาก ค่าเท่ากันเลือกคลาสที่เลขน้อยกว่า
+        std::fill(votes.begin(), votes.end(), 0);
+        for (size_t m = 0; m < width; m++) {
+            size_t label = static_cast<size_t>(row[m]);
+            if (label < classes) {
+                votes[label]++;
+            }
+        }
+        out[i] = static_cast<float>(std::max_element(votes.begin(), votes.end()) - votes.begin());
+    }
+}
+
+size_t VotingModel::decisionScores(const float* rows, size_t count, std::vector<float>& out) const {
+    if (!classification) {
+        return 0;
+    }
+    std::vector<float> all = learnerPredictions(rows, count);
+    size_t width = learners.size();
+    size_t scoreWidth = classes == 2 ? 1 : classes;
+    out.assign(count * scoreWidth, 0.0f);
+    float share = 1.0f / static_cast<float>(width);
+    for (size_t i = 0; i < count; i++) {
+        for (size_t m = 0; m < width; m++) {
+            size_t label = static_cast<size_t>(all[i * width + m]);
+            if (classes == 2) {
+                out[i] += label == 1 ? share : 0.0f;
+            } else if (label < classes) {
+                out[i * scoreWidth + label] += share;
+            }
+        }
+    }
+    return scoreWidth;
+}
+
+void VotingModel::describeCombiner(std::ostream& os) const {
+    os << (classification ? "Majority vote over " + std::to_string(classes) + " classes" : std::string("Mean of predictions"))
+       << "\n";
+}
+
+StackingModel::StackingModel(const ModelParams& params)
+    : EnsembleModel(params),
+      folds(static_cast<size_t>(std::max(2.0, params.get("cv", 5)))),
+      metaType(params.getString("final_estimator", "")) {
+    if (!metaType.empty()) {
+        checkLearnerType(metaType);
+    }
+    learnerParams.text.erase("final_estimator");
+}
+
+size_t StackingModel::extraTasks(const Dataset& data) {
+    if (data.rows < folds) {
+        throw std::invalid_argument("Stacking needs at least " + std::to_string(folds) + " rows for " +
+                                    std::to_string(folds) + "-fold out-of-fold predictions");
+    }
+    // fold แบบ stratified: สุ่มลำดับแล้วเรียงตามคลาส (คงลำดับสุ่มภายในคลาส) และแจกวนทีละ fold
+    std::vector<uint32_t> order(data.rows);
+    std::iota(order.begin(), order.end(), 0u);
+    std::mt19937 rng(seed);
+    std::shuffle(order.begin(), order.end(), rng);
+    if (data.isClassification()) {
+        std::stable_sort(order.begin(), order.end(),
+                         [&](uint32_t a, uint32_t b) { return data.targets[a] < data.targets[b]; });
+    }
+    foldOf.resize(data.rows);
+    for (size_t p = 0; p < order.size(); p++) {
+        foldOf[order[p]] = static_cast<uint32_t>(p % folds);
+    }
+    size_t tasks = folds * types.size();
+    foldScores.assign(tasks, {});
+    foldPredictions.assign(tasks, {});
+    foldWidths.assign(tasks, 0);
+    return tasks;
+}
+
+void StackingModel::runExtraTask(const Dataset& data, size_t task) {
+    size_t fold = task / types.size();
+    size_t learnerIndex = task % types.size();
+    std::vector<size_t> trainRows, heldOut;
+    for (size_t i = 0; i < data.rows; i++) {
+        (foldOf[i] == fold ? heldOut : trainRows).push_back(i);
+    }
+    std::unique_ptr<MLModel> model = createLearner(learnerIndex);
+    model->fit(data.subset(trainRows));
+
+    Dataset test = data.subset(heldOut);
+    foldWidths[task] = learnerMetaFeatures(*model, test.features.data(), test.rows, foldScores[task]);
+    foldPredictions[task].resize(test.rows);
+    model->predictBatch(test.features.data(), test.rows, foldPredictions[task].data());
+}
+
+size_t StackingModel::learnerMetaFeatures(const MLModel& model, const float* rows, size_t count,
+                                          std::vector<float>& out) const {
+    if (!classification) {
+        out.resize(count);
+        model.predictBatch(rows, count, out.data());
+        return 1;
+    }
+    size_t width = model.decisionScores(rows, count, out);
+    if (width > 0) {
+        return width;
+    }
+    std::vector<float> predicted(count);
+    model.predictBatch(rows, count, predicted.data());
+    out.assign(count * classes, 0.0f);
+    for (size_t i = 0; i < count; i++) {
+        size_t label = static_cast<size_t>(predicted[i]);
+        if (label < classes) {
+            out[i * classes + label] = 1.0f;
+        }
+    }
+    return classes;
+}
+
+void StackingModel::finishFit(const Dataset& data) {
+    size_t count = types.size();
+    learnerWidths.assign(count, 0);
+    metaWidth = 0;
+    std::vector<float> probe;
+    for (size_t m = 0; m < count; m++) {
+        size_t width = learnerMetaFeatures(*learners[m], data.row(0), 1, probe);
+        for (size_t fold = 0; fold < folds; fold++) {
+            if (foldWidths[fold * count + m] != width) {
+                throw std::runtime_error(types[m] + " produced " + std::to_string(foldWidths[fold * count + m]) +
+                                         " scores in fold " + std::to_string(fold + 1) + " but " +
+                                         std::to_string(width) + " on the full dataset");
+            }
+        }
+        learnerWidths[m] = width;
+        metaWidth += width;
+    }
+
+    // ประกอบ meta-features ตามลำดับแถวเดิม: แถวของแต่ละ fold เรียงตามดัชนีเหมือนตอนแบ่ง
+    Dataset metaData;
+    metaData.rows = data.rows;
+    metaData.cols = metaWidth;
+    metaData.targets = data.targets;
+    metaData.targetName = data.targetName;
+    metaData.classNames = data.classNames;
+    metaData.classification = data.isClassification();
+    metaData.features.resize(data.rows * metaWidth);
+    std::vector<std::vector<float>> oof(count, std::vector<float>(data.rows));
+    std::vector<size_t> cursor(folds, 0);
+    for (size_t i = 0; i < data.rows; i++) {
+        size_t fold = foldOf[i];
+        size_t position = cursor[fold]++;
+        float* row = metaData.row(i);
+        for (size_t m = 0; m < count; m++) {
+            size_t width = learnerWidths[m];
+            const float* scores = foldScores[fold * count + m].data() + position * width;
+            std::copy(scores, scores + width, row);
+            row += width;
+            oof[m][i] = foldPredictions[fold * count + m][position];
+        }
+    }
+    for (size_t m = 0; m < count; m++) {
+        for (size_t k = 0; k < learnerWidths[m]; k++) {
+            metaData.featureNames.push_back(types[m] + (learnerWidths[m] > 1 ? ":" + std::to_string(k) : ""));
+        }
+    }
+    oofScores.assign(count, 0.0);
+    for (size_t m = 0; m < count; m++) {
+        oofScores[m] = score(oof[m], data.targets, classification);
+    }
+    foldScores.clear();
+    foldPredictions.clear();
+
+    ModelParams metaParams;
+    metaParams.numeric["random_state"] = seed;
+    std::string type = metaType.empty() ? (classification ? "LogisticRegression" : "LinearRegression") : metaType;
+    meta = ModelFactory::createModel(type, metaParams);
+    meta->fit(metaData);
+}
+
+void StackingModel::metaFeatures(const float* rows, size_t count, std::vector<float>& out) const {
+    if (!meta) {
+        throw std::runtime_error("Stacking model has not been trained");
+    }
+    out.resize(count * metaWidth);
+    std::vector<float> scores;
+    size_t offset = 0;
+    for (size_t m = 0; m < learners.size(); m++) {
+        size_t width = learnerMetaFeatures(*learners[m], rows, count, scores);
+        for (size_t i = 0; i < count; i++) {
+            std::copy(scores.begin() + i * width, scores.begin() + (i + 1) * width, out.begin() + i * metaWidth + offset);
+        }
+        offset += width;
+    }
+}
+
+void StackingModel::predictBatch(const float* rows, size_t count, float* out) const {
+    std::vector<float> features;
+    metaFeatures(rows, count, features);
+    meta->predictBatch(features.data(), count, out);
+}
+
+size_t StackingModel::decisionScores(const float* rows, size_t count, std::vector<float>& out) const {
+    std::vector<float> features;
+    metaFeatures(rows, count, features);
+    return meta->decisionScores(features.data(), count, out);
+}
+
+size_t StackingModel::memoryBytes() const {
+    return EnsembleModel::memoryBytes() + (meta ? meta->memoryBytes() : 0);
+}
+
+void StackingModel::describeCombiner(std::ostream& os) const {
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << "Meta-learner " << meta->typeName() << " on " << metaWidth << " out-of-fold features (" << folds
+       << " folds x " << types.size() << " models)\n";
+    os << "  out-of-fold " << (classification ? "accuracy" : "R^2") << ":" << std::fixed << std::setprecision(4);
+    for (size_t m = 0; m < types.size(); m++) {
+        os << (m > 0 ? "," : "") << " " << types[m] << " " << oofScores[m];
+    }
+    os << "\n";
+    os.flags(flags);
+    os.precision(precision);
+}
+
+} // namespace ai_language
@@ -0,0 +1,219 @@
+#include "../../include/ml/GradientBoosting.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace ai_language {
+
+namespace {
+
+constexpr float kMinHessian = 1e-6f;
+
+inline float sigmoid(float x) {
+    return 1.0f / (1.0f + std::exp(-x));
+}
+
+} // namespace
+
+GradientBoostingModel::GradientBoostingModel(const ModelParams& params)
+    : TreeEnsembleModel(params),
+      rounds(static_cast<size_t>(std::max(1.0, params.get("n_estimators", params.get("trees", 100))))),
+      incrementalRounds(static_cast<size_t>(std::max(1.0, params.get("incremental_rounds", rounds / 10.0)))),
+      learningRate(params.get("learning_rate", 0.1)),
+      subsample(std::min(1.0, std::max(0.01, params.get("subsample", 1.0)))),
+      buildParams(readTreeParams(params, 3)) {
+    buildParams.lambda = std::max(0.0, params.get("lambda", 1.0));
+    buildParams.leafScale = learningRate;
+}
+
+double GradientBoostingModel::loss(const Dataset& data, const std::vector<float>& F) const {
+    double total = 0.0;
+    for (size_t i = 0; i < data.rows; i++) {
+        const float* f = F.data() + i * scoreWidth;
+        float y = data.targets[i];
+        if (!classification) {
+            total += 0.5 * (f[0] - y) * (f[0] - y);
+        } else if (marginOutput) {
+            // log(1 + e^f) - y f แบบไม่ล้นค่า
+            double margin = f[0];
+            total += std::max(margin, 0.0) + std::log1p(std::exp(-std::fabs(margin))) - y * margin;
+        } else {
+            float top = *std::max_element(f, f + scoreWidth);
+            double sum = 0.0;
+            for (size_t k = 0; k < scoreWidth; k++) {
+                sum += std::exp(f[k] - top);
+            }
+            total += std::log(sum) + top - f[static_cast<size_t>(y)];
+        }
+    }
+    return total / static_cast<double>(data.rows);
+}
+
+void GradientBoostingModel::boost(const Dataset& data, const std::vector<uint8_t>& columns,
+                                  std::vector<float>& F, size_t count) {
+    size_t rows = data.rows;
+    TreeBuilder builder(binner, columns, rows);
+    std::vector<std::vector<float>> gradients(scoreWidth, std::vector<float>(rows));
+    std::vector<std::vector<float>> hessians(scoreWidth, std::vector<float>(rows));
+    std::vector<uint32_t> allRows(rows);
+    std::iota(allRows.begin(), allRows.end(), 0u);
+    std::mt19937 rng(buildParams.seed + static_cast<unsigned>(trees.size()));
+
+    for (size_t round = 0; round < count; round++) {
+        parallelFor(0, rows, [&](size_t begin, size_t end, size_t) {
+            std::vector<float> prob(scoreWidth);
+            for (size_t i = begin; i < end; i++) {
+                const float* f = F.data() + i * scoreWidth;
+                float y = data.targets[i];
+                if (!classification) {
+                    gradients[0][i] = f[0] - y;
+                    hessians[0][i] = 1.0f;
+                } else if (marginOutput) {
+                    float p = sigmoid(f[0]);
+                    gradients[0][i] = p - y;
+                    hessians[0][i] = std::max(p * (1.0f - p), kMinHessian);
+                } else {
+                    float top = *std::max_element(f, f + scoreWidth);
+                    float sum = 0.0f;
+                    for (size_t k = 0; k < scoreWidth; k++) {
+                        prob[k] = std::exp(f[k] - top);
+                        sum += prob[k];
+                    }
+                    for (size_t k = 0; k < scoreWidth; k++) {
+                        float p = prob[k] / sum;
+                        gradients[k][i] = p - (static_cast<size_t>(y) == k ? 1.0f : 0.0f);
+                        hessians[k][i] = std::max(p * (1.0f - p), kMinHessian);
+                    }
+                }
+            }
+        }, 4096);
+
+        std::vector<uint32_t> sample = allRows;
+        if (subsample < 1.0) {
+            std::shuffle(sample.begin(), sample.end(), rng);
+            sample.resize(std::max<size_t>(1, static_cast<size_t>(subsample * rows)));
+        }
+
+        // หลายคลาส: ต้นไม้ของแต่ละคลาสในรอบเดียวกันเป็นอิสระต่อกัน
+        std::vector<DecisionTree> roundTrees(scoreWidth);
+        parallelFor(0, scoreWidth, [&](size_t begin, size_t end, size_t) {
+            for (size_t k = begin; k < end; k++) {
+                TreeBuildParams params = buildParams;
+                params.seed = buildParams.seed + static_cast<unsigned>(trees.size() + k);
+                roundTrees[k] = builder.buildRegressor(gradients[k], hessians[k], sample, params);
+                roundTrees[k].outputOffset = k;
+            }
+        }, 1);
+
+        parallelFor(0, rows, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; i++) {
+                for (size_t k = 0; k < scoreWidth; k++) {
+                    F[i * scoreWidth + k] += roundTrees[k].evaluateBinned(columns.data(), rows, i)[0];
+                }
+            }
+        }, 4096);
+        for (auto& tree : roundTrees) {
+            trees.push_back(std::move(tree));
+        }
+        trainLoss.push_back(loss(data, F));
+    }
+}
+
+void GradientBoostingModel::fit(const Dataset& data) {
+    std::vector<uint8_t> columns;
+    prepareBins(data, columns);
+    trees.clear();
+    trainLoss.clear();
+    scoreScale = 1.0f;
+
+    size_t classes = classification ? data.numClasses() : 0;
+    marginOutput = classification && classes == 2;
+    scoreWidth = classification && !marginOutput ? classes : 1;
+    baseScore.assign(scoreWidth, 0.0f);
+
+    // คะแนนเริ่มต้น: ค่าเฉลี่ย, log-odds หรือ log ของสัดส่วนคลาส
+    if (!classification) {
+        double sum = std::accumulate(data.targets.begin(), data.targets.end(), 0.0);
+        baseScore[0] = static_cast<float>(sum / data.rows);
+    } else {
+        std::vector<double> counts(classes, 0.0);
+        for (float t : data.targets) {
+            counts[static_cast<size_t>(t)] += 1.0;
+        }
+        for (auto& c : counts) {
+            c = std::max(c, 1.0) / data.rows;
+        }
+        if (marginOutput) {
+            baseScore[0] = static_cast<float>(std::log(counts[1] / counts[0]));
+        } else {
+            for (size_t k = 0; k < classes; k++) {
+                baseScore[k] = static_cast<float>(std::log(counts[k]));
+            }
+        }
+    }
+
+    std::vector<float> F(data.rows * scoreWidth);
+    for (size_t i = 0; i < data.rows; i++) {
+        std::copy(baseScore.begin(), baseScore.end(), F.begin() + i * scoreWidth);
+    }
+    trainLoss.push_back(loss(data, F));
+    boost(data, columns, F, rounds);
+    compileLayouts();
+    trainingCalls = 1;
+}
+
+void GradientBoostingModel::partialFit(const Dataset& data) {
+    if (trees.empty()) {
+        fit(data);
+        return;
+    }
+    if (data.empty()) {
+        throw std::invalid_argument("Dataset is empty");
+    }
+    if (data.cols != featureCount) {
+        throw std::invalid_argument("Expected " + std::to_string(featureCount) + " features but got " +
+                                    std::to_string(data.cols));
+    }
+    size_t classes = marginOutput ? 2 : scoreWidth;
+    if (data.isClassification() != classification || (classification && data.numClasses() > classes)) {
+        throw std::invalid_argument("New rows contain classes the model was not trained on; a full fit is required");
+    }
+
+    // เริ่มจากคะแนนของต้นไม้เดิมแล้วต่อรอบใหม่บนช่วงค่า features เดิม
+    std::vector<uint8_t> columns;
+    binner.transformColumns(data, columns);
+    std::vector<float> F(data.rows * scoreWidth);
+    rawScores(data.features.data(), data.rows, F.data(), TreeLayout::Auto);
+    trainLoss.assign(1, loss(data, F));
+    boost(data, columns, F, incrementalRounds);
+    compileLayouts();
+    trainingCalls++;
+}
+
+size_t GradientBoostingModel::decisionScores(const float* rows, size_t count, std::vector<float>& out) const {
+    size_t width = TreeEnsembleModel::decisionScores(rows, count, out);
+    if (width > 1) {
+        logSoftmaxRows(out.data(), count, width);
+    }
+    return width;
+}
+
+void GradientBoostingModel::describe(std::ostream& os) const {
+    const char* objective = !classification ? "squared error" : (marginOutput ? "logistic" : "softmax");
+    os << "GradientBoosting (" << objective << ", learning rate " << learningRate << ", "
+       << trees.size() / std::max<size_t>(1, scoreWidth) << " rounds): ";
+    describeTrees(os);
+    if (trainLoss.size() > 1) {
+        os << "Training loss: " << trainLoss.front() << " -> " << trainLoss.back();
+        if (trainingCalls > 1) {
+            os << " (last " << trainLoss.size() - 1 << " rounds, training call " << trainingCalls << ")";
+        }
+        os << "\n";
+    }
+}
+
+} // namespace ai_language
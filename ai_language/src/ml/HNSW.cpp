@@ -0,0 +1,275 @@
+#include "../../include/ml/HNSW.h"
+#include "../../include/ml/Distance.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+
+namespace ai_language {
+
+HNSWIndex::HNSWIndex(size_t m, size_t efConstruction, unsigned seed)
+    : m(std::max<size_t>(2, m)),
+      efConstruction(std::max<size_t>(m, efConstruction)),
+      seed(seed),
+      data(nullptr),
+      count(0),
+      dim(0),
+      entryPoint(0),
+      topLevel(-1) {
+}
+
+HNSWIndex::~HNSWIndex() = default;
+
+float HNSWIndex::distance(const float* a, uint32_t b) const {
+    return squaredL2(a, data + static_cast<size_t>(b) * dim, dim);
+}
+
+std::vector<uint32_t> HNSWIndex::neighborsOf(uint32_t node, int level) const {
+    std::lock_guard<std::mutex> guard(nodeLocks[node]);
+    return links[node][level];
+}
+
+size_t HNSWIndex::edgeCount() const {
+    size_t total = 0;
+    for (const auto& nodeLinks : links) {
+        for (const auto& level : nodeLinks) {
+            total += level.size();
+        }
+    }
+    return total;
+}
+
+void HNSWIndex::build(const float* points, size_t n, size_t d) {
+    data = points;
+    count = n;
+    dim = d;
+    levels.assign(count, 0);
+    links.assign(count, {});
+    nodeLocks.reset(new std::mutex[count]);
+    topLevel = -1;
+    if (count == 0) {
+        return;
+    }
+
+    // ชั้นของแต่ละโหนดสุ่มจากการแจกแจงเอกซ์โพเนนเชียล mL = 1 / ln(M)
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uniform(std::numeric_limits<double>::min(), 1.0);
+    double levelScale = 1.0 / std::log(static_cast<double>(m));
+    for (size_t i = 0; i < count; i++) {
+        levels[i] = static_cast<int>(-std::log(uniform(rng)) * levelScale);
+        links[i].resize(levels[i] + 1);
+    }
+
+    entryPoint = 0;
+    topLevel = levels[0];
+
+    // โหนดแรกเป็นจุดเริ่มต้น ที่เหลือเพิ่มแบบขนาน
+    parallelFor(1, count, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; i++) {
+            insert(static_cast<uint32_t>(i));
+        }
+    }, 256);
+}
+
+std::vector<HNSWIndex::Candidate> HNSWIndex::searchLayer(const float* query, uint32_t entry, float entryDist,
+                                                         size_t ef, int level, std::vector<uint32_t>& visitedMark,
+                                                         uint32_t visitTag) const {
+    // candidates: min-heap ตามระยะ, results: max-heap ขนาดไม่เกิน ef
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+    std::priority_queue<Candidate> results;
+    candidates.emplace(entryDist, entry);
+    results.emplace(entryDist, entry);
+    visitedMark[entry] = visitTag;
+
+    while (!candidates.empty()) {
+        Candidate current = candidates.top();
+        if (current.first > results.top().first && results.size() >= ef) {
+            break;
+        }
+        candidates.pop();
+        for (uint32_t neighbor : neighborsOf(current.second, level)) {
+            if (visitedMark[neighbor] == visitTag) {
+                continue;
+            }
+            visitedMark[neighbor] = visitTag;
+            float d = distance(query, neighbor);
+            if (results.size() < ef || d < results.top().first) {
+                candidates.emplace(d, neighbor);
+                results.emplace(d, neighbor);
+                if (results.size() > ef) {
+                    results.pop();
+                }
+            }
+        }
+    }
+
+    std::vector<Candidate> sorted;
+    sorted.reserve(results.size());
+    while (!results.empty()) {
+        sorted.push_back(results.top());
+        results.pop();
+    }
+    std::reverse(sorted.begin(), sorted.end());
+    return sorted;
+}
+
+std::vector<uint32_t> HNSWIndex::selectNeighbors(std::vector<Candidate> candidates, size_t limit) const {
+    // heuristic ของ HNSW: เลือกผู้สมัครที่ใกล้จุดฐานมากกว่าใกล้เพื่อนบ้านที่เลือกไปแล้ว เพื่อกระจายทิศทาง
+    std::sort(candidates.begin(), candidates.end());
+    std::vector<uint32_t> selected;
+    std::vector<uint32_t> pruned;
+    for (const auto& candidate : candidates) {
+        if (selected.size() >= limit) {
+            break;
+        }
+        const float* point = data + static_cast<size_t>(candidate.second) * dim;
+        bool keep = true;
+        for (uint32_t chosen : selected) {
+            if (distance(point, chosen) < candidate.first) {
+                keep = false;
+                break;
+            }
+        }
+        if (keep) {
+            selected.push_back(candidate.second);
+        } else {
+            pruned.push_back(candidate.second);
+        }
+    }
+    // เติมด้วยผู้สมัครที่ถูกตัดออก เพื่อให้กราฟเชื่อมต่อกันดี
+    for (size_t i = 0; i < pruned.size() && selected.size() < limit; i++) {
+        selected.push_back(pruned[i]);
+    }
+    return selected;
+}
+
+void HNSWIndex::connect(uint32_t node, uint32_t neighbor, int level) {
+    size_t limit = level == 0 ? 2 * m : m;
+    std::lock_guard<std::mutex> guard(nodeLocks[node]);
+    auto& list = links[node][level];
+    if (std::find(list.begin(), list.end(), neighbor) != list.end()) {
+        return;
+    }
+    list.push_back(neighbor);
+    if (list.size() <= limit) {
+        return;
+    }
+    // รายการเต็ม: เก็บเพื่อนบ้านที่ใกล้ที่สุดไว้
+    const float* base = data + static_cast<size_t>(node) * dim;
+    std::vector<Candidate> candidates;
+    candidates.reserve(list.size());
+    for (uint32_t other : list) {
+        candidates.emplace_back(distance(base, other), other);
+    }
+    std::nth_element(candidates.begin(), candidates.begin() + limit, candidates.end());
+    list.clear();
+    for (size_t i = 0; i < limit; i++) {
+        list.push_back(candidates[i].second);
+    }
+}
+
+void HNSWIndex::insert(uint32_t node) {
+    const float* point = data + static_cast<size_t>(node) * dim;
+    int level = levels[node];
+
+    uint32_t entry;
+    int currentTop;
+    {
+        std::lock_guard<std::mutex> guard(entryLock);
+        entry = entryPoint;
+        currentTop = topLevel;
+    }
+
+    thread_local std::vector<uint32_t> visitedMark;
+    thread_local uint32_t visitTag = 0;
+    if (visitedMark.size() != count) {
+        visitedMark.assign(count, 0);
+        visitTag = 0;
+    }
+
+    // ลงจากชั้นบนแบบ greedy จนถึงชั้นของโหนดใหม่
+    float entryDist = distance(point, entry);
+    for (int l = currentTop; l > level; l--) {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (uint32_t neighbor : neighborsOf(entry, l)) {
+                float d = distance(point, neighbor);
+                if (d < entryDist) {
+                    entryDist = d;
+                    entry = neighbor;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    for (int l = std::min(level, currentTop); l >= 0; l--) {
+        visitTag++;
+        std::vector<Candidate> candidates = searchLayer(point, entry, entryDist, efConstruction, l, visitedMark, visitTag);
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                        [node](const Candidate& c) { return c.second == node; }),
+                         candidates.end());
+        if (candidates.empty()) {
+            continue;
+        }
+        std::vector<uint32_t> selected = selectNeighbors(candidates, m);
+        {
+            std::lock_guard<std::mutex> guard(nodeLocks[node]);
+            links[node][l] = selected;
+        }
+        for (uint32_t neighbor : selected) {
+            connect(neighbor, node, l);
+        }
+        entry = candidates.front().second;
+        entryDist = candidates.front().first;
+    }
+
+    if (level > currentTop) {
+        std::lock_guard<std::mutex> guard(entryLock);
+        if (level > topLevel) {
+            topLevel = level;
+            entryPoint = node;
+        }
+    }
+}
+
+std::vector<std::pair<float, uint32_t>> HNSWIndex::search(const float* query, size_t k, size_t ef) const {
+    if (count == 0) {
+        return {};
+    }
+    uint32_t entry = entryPoint;
+    float entryDist = distance(query, entry);
+    for (int l = topLevel; l > 0; l--) {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (uint32_t neighbor : links[entry][l]) {
+                float d = distance(query, neighbor);
+                if (d < entryDist) {
+                    entryDist = d;
+                    entry = neighbor;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    thread_local std::vector<uint32_t> visitedMark;
+    thread_local uint32_t visitTag = 0;
+    if (visitedMark.size() != count) {
+        visitedMark.assign(count, 0);
+        visitTag = 0;
+    }
+    visitTag++;
+    std::vector<Candidate> results = searchLayer(query, entry, entryDist, std::max(ef, k), 0, visitedMark, visitTag);
+    if (results.size() > k) {
+        results.resize(k);
+    }
+    return results;
+}
+
+} // namespace ai_language
@@ -0,0 +1,126 @@
+#include "../../include/ml/Importance.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace ai_language {
+
+namespace {
+
+constexpr size_t kBlockRows = 256;
+
+double scorePredictions(const Dataset& data, const std::vector<uint32_t>& view, const float* predicted,
+                        bool classification) {
+    size_t n = view.size();
+    if (classification) {
+        size_t correct = 0;
+        for (size_t i = 0; i < n; i++) {
+            correct += predicted[i] == data.targets[view[i]];
+        }
+        return static_cast<double>(correct) / n;
+    }
+    double mean = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        mean += data.targets[view[i]];
+    }
+    mean /= n;
+    double residual = 0.0, total = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double y = data.targets[view[i]];
+        residual += (predicted[i] - y) * (predicted[i] - y);
+        total += (y - mean) * (y - mean);
+    }
+    return total > 0.0 ? 1.0 - residual / total : (residual == 0.0 ? 1.0 : 0.0);
+}
+
+// ทำนายแถวใน view ทีละบล็อก ถ้า permutation ไม่ว่าง feature ที่กำหนดจะอ่านจากแถว view[permutation[i]]
+void predictView(const BlockPredictor& predict, size_t worker, const Dataset& data, const std::vector<uint32_t>& view,
+                 const std::vector<uint32_t>* permutation, size_t feature,
+                 std::vector<float>& block, float* out) {
+    size_t cols = data.cols;
+    for (size_t start = 0; start < view.size(); start += kBlockRows) {
+        size_t count = std::min(kBlockRows, view.size() - start);
+        for (size_t r = 0; r < count; r++) {
+            const float* source = data.row(view[start + r]);
+            std::copy(source, source + cols, block.begin() + r * cols);
+            if (permutation) {
+                block[r * cols + feature] = data.row(view[(*permutation)[start + r]])[feature];
+            }
+        }
+        predict(block.data(), count, out + start, worker);
+    }
+}
+
+} // namespace
+
+PermutationImportance permutationImportance(const MLModel& model, const Dataset& data,
+                                            const std::vector<uint32_t>& view, size_t repeats,
+                                            unsigned seed, bool classification) {
+    if (data.cols != model.numFeatures()) {
+        throw std::invalid_argument("Dataset has " + std::to_string(data.cols) + " features but the model expects " +
+                                    std::to_string(model.numFeatures()));
+    }
+    BlockPredictor predict = [&model](const float* rows, size_t count, float* out, size_t) {
+        model.predictBatch(rows, count, out);
+    };
+    return permutationImportance(predict, data, view, repeats, seed, classification);
+}
+
+PermutationImportance permutationImportance(const BlockPredictor& predict, const Dataset& data,
+                                            const std::vector<uint32_t>& view, size_t repeats,
+                                            unsigned seed, bool classification) {
+    if (view.empty()) {
+        throw std::invalid_argument("No rows to evaluate feature importance");
+    }
+    repeats = std::max<size_t>(1, repeats);
+    size_t n = view.size();
+    size_t cols = data.cols;
+
+    PermutationImportance result;
+    result.metric = classification ? "accuracy" : "r2";
+    result.rows = n;
+    result.repeats = repeats;
+    {
+        std::vector<float> block(kBlockRows * cols), predicted(n);
+        predictView(predict, 0, data, view, nullptr, 0, block, predicted.data());
+        result.baseline = scorePredictions(data, view, predicted.data(), classification);
+    }
+
+    // permutation หนึ่งชุดต่อรอบ ใช้ร่วมกันทุก feature
+    std::vector<std::vector<uint32_t>> permutations(repeats, std::vector<uint32_t>(n));
+    std::mt19937 rng(seed);
+    for (auto& permutation : permutations) {
+        std::iota(permutation.begin(), permutation.end(), 0u);
+        std::shuffle(permutation.begin(), permutation.end(), rng);
+    }
+
+    std::vector<double> drops(cols * repeats);
+    parallelFor(0, cols * repeats, [&](size_t begin, size_t end, size_t worker) {
+        std::vector<float> block(kBlockRows * cols), predicted(n);
+        for (size_t task = begin; task < end; task++) {
+            size_t feature = task / repeats;
+            predictView(predict, worker, data, view, &permutations[task % repeats], feature, block,
+                        predicted.data());
+            drops[task] = result.baseline - scorePredictions(data, view, predicted.data(), classification);
+        }
+    }, 1);
+
+    result.mean.assign(cols, 0.0);
+    result.stddev.assign(cols, 0.0);
+    for (size_t f = 0; f < cols; f++) {
+        const double* values = drops.data() + f * repeats;
+        double mean = std::accumulate(values, values + repeats, 0.0) / repeats;
+        double variance = 0.0;
+        for (size_t r = 0; r < repeats; r++) {
+            variance += (values[r] - mean) * (values[r] - mean);
+        }
+        result.mean[f] = mean;
+        result.stddev[f] = std::sqrt(variance / repeats);
+    }
+    return result;
+}
+
+} // namespace ai_language
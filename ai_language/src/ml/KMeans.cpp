@@ -0,0 +1,831 @@
+#include "../../include/ml/KMeans.h"
+#include "../../include/ml/CodeGen.h"
+#include "../../include/ml/Distance.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace ai_language {
+
+namespace {
+
+constexpr size_t kRowBlock = 256;
+constexpr size_t kMinChunkRows = 2048;
+constexpr size_t kHamerlyMaxClusters = 20;
+constexpr size_t kElkanBoundBytes = size_t(1) << 30;
+constexpr size_t kNoImprovementBatches = 10;
+constexpr size_t kCandidateLloydRounds = 10;
+constexpr size_t kReductionAttempts = 5;
+constexpr size_t kReductionBudget = size_t(1) << 20;  // ผู้สมัคร x clusters ที่ยังทำซ้ำหลายครั้งได้
+
+uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// ตัวเลขสุ่มในช่วง [0, 1) ที่ขึ้นกับ (seed, รอบ, แถว) เท่านั้น จึงได้ผลเดิมไม่ว่าจะแบ่งเธรดอย่างไร
+double hashUniform(uint64_t seed, uint64_t round, uint64_t index) {
+    uint64_t bits = splitmix64(splitmix64(seed ^ (round << 40)) ^ index);
+    return static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0);
+}
+
+float distance(const float* a, const float* b, size_t dim) {
+    return std::sqrt(squaredL2(a, b, dim));
+}
+
+void addRow(double* sum, const float* row, size_t dim) {
+    for (size_t j = 0; j < dim; j++) {
+        sum[j] += row[j];
+    }
+}
+
+// ขนาดบล็อกแถวให้ตารางผลคูณ (แถว x ศูนย์กลาง) ไม่เกินราว 64K ค่า
+size_t blockRowsFor(size_t centers) {
+    return std::max<size_t>(8, std::min<size_t>(kRowBlock, (size_t(1) << 16) / std::max<size_t>(1, centers)));
+}
+
+// ศูนย์กลางที่ใกล้ที่สุดของบล็อกแถวด้วย ||x||² - 2 x·c + ||c||² ผ่าน dotTile
+// ระยะที่คืนคำนวณใหม่แบบตรงกับศูนย์กลางที่ชนะเพื่อไม่ให้คลาดเคลื่อนจากการกระจายพจน์
+void nearestBlock(const float* rows, size_t count, size_t dim, const float* centers, const float* centerNorms,
+                  size_t k, std::vector<float>& scratch, uint32_t* labels, float* distances) {
+    scratch.resize(count * k);
+    dotTile(rows, count, centers, k, dim, scratch.data(), k);
+    for (size_t r = 0; r < count; r++) {
+        const float* products = scratch.data() + r * k;
+        uint32_t best = 0;
+        float bestScore = std::numeric_limits<float>::infinity();
+        for (size_t c = 0; c < k; c++) {
+            float score = centerNorms[c] - 2.0f * products[c];
+            if (score < bestScore) {
+                bestScore = score;
+                best = static_cast<uint32_t>(c);
+            }
+        }
+        labels[r] = best;
+        if (distances) {
+            distances[r] = squaredL2(rows + r * dim, centers + best * dim, dim);
+        }
+    }
+}
+
+// ศูนย์กลางที่ใกล้ที่สุดของทุกแถวแบบขนาน
+void nearestCenters(const float* rows, size_t count, size_t dim, const float* centers, size_t k,
+                    uint32_t* labels, float* distances) {
+    std::vector<float> norms(k);
+    squaredNorms(centers, k, dim, norms.data());
+    size_t block = blockRowsFor(k);
+    parallelFor(0, count, [&](size_t begin, size_t end, size_t) {
+        std::vector<float> scratch;
+        for (size_t start = begin; start < end; start += block) {
+            size_t n = std::min(block, end - start);
+            nearestBlock(rows + start * dim, n, dim, centers, norms.data(), k, scratch, labels + start,
+                         distances ? distances + start : nullptr);
+        }
+    }, kMinChunkRows);
+}
+
+// ครึ่งหนึ่งของระยะจากศูนย์กลางแต่ละตัวถึงศูนย์กลางอื่นที่ใกล้ที่สุด และตารางระยะระหว่างศูนย์กลาง (ถ้าต้องการ)
+void centerSeparation(const std::vector<float>& centers, size_t k, size_t dim, std::vector<float>& half,
+                      std::vector<float>* matrix) {
+    half.assign(k, std::numeric_limits<float>::infinity());
+    if (matrix) {
+        matrix->assign(k * k, 0.0f);
+    }
+    for (size_t a = 0; a < k; a++) {
+        for (size_t b = a + 1; b < k; b++) {
+            float d = distance(centers.data() + a * dim, centers.data() + b * dim, dim);
+            half[a] = std::min(half[a], 0.5f * d);
+            half[b] = std::min(half[b], 0.5f * d);
+            if (matrix) {
+                (*matrix)[a * k + b] = d;
+                (*matrix)[b * k + a] = d;
+            }
+        }
+    }
+}
+
+} // namespace
+
+KMeansModel::KMeansModel(const ModelParams& params)
+    : clusters(static_cast<size_t>(std::max(1.0, params.get("clusters", params.get("n_clusters", 8))))),
+      maxIterations(static_cast<size_t>(std::max(1.0, params.get("max_iter", 300)))),
+      tol(std::max(0.0, params.get("tol", 1e-4))),
+      requested(KMeansAlgorithm::Auto),
+      randomInit(params.getString("init", "kmeans||") == "random"),
+      initRounds(static_cast<size_t>(std::max(1.0, params.get("init_rounds", 5)))),
+      miniBatchSize(static_cast<size_t>(std::max(1.0, params.get("minibatch_size", 1024)))),
+      seed(static_cast<unsigned>(params.get("random_state", params.get("seed", 42)))) {
+    std::string algorithm = params.getString("algorithm", "auto");
+    if (algorithm == "lloyd") {
+        requested = KMeansAlgorithm::Lloyd;
+    } else if (algorithm == "hamerly") {
+        requested = KMeansAlgorithm::Hamerly;
+    } else if (algorithm == "elkan") {
+        requested = KMeansAlgorithm::Elkan;
+    } else if (algorithm == "minibatch" || algorithm == "mini-batch") {
+        requested = KMeansAlgorithm::MiniBatch;
+    } else if (algorithm != "auto") {
+        throw std::invalid_argument("Unknown KMeans algorithm '" + algorithm +
+                                    "' (use auto, lloyd, hamerly, elkan or minibatch)");
+    }
+}
+
+std::string KMeansModel::algorithmName(KMeansAlgorithm algorithm) {
+    switch (algorithm) {
+        case KMeansAlgorithm::Lloyd: return "lloyd";
+        case KMeansAlgorithm::Hamerly: return "hamerly";
+        case KMeansAlgorithm::Elkan: return "elkan";
+        case KMeansAlgorithm::MiniBatch: return "minibatch";
+        default: return "auto";
+    }
+}
+
+void KMeansModel::fit(const Dataset& data) {
+    if (data.rows < clusters) {
+        throw std::invalid_argument("KMeans needs at least " + std::to_string(clusters) + " rows, got " +
+                                    std::to_string(data.rows));
+    }
+    auto start = std::chrono::steady_clock::now();
+    featureCount = dim = data.cols;
+    stats = KMeansStats();
+    trainingCalls = 1;
+    rowsSeen = data.rows;
+    const float* rows = data.features.data();
+
+    // tol เทียบกับค่าเฉลี่ยความแปรปรวนของ features เหมือนกันทุกวิธี
+    std::vector<double> sum(dim, 0.0), squares(dim, 0.0);
+    for (size_t i = 0; i < data.rows; i++) {
+        const float* x = data.row(i);
+        for (size_t j = 0; j < dim; j++) {
+            sum[j] += x[j];
+            squares[j] += static_cast<double>(x[j]) * x[j];
+        }
+    }
+    double meanVariance = 0.0;
+    for (size_t j = 0; j < dim; j++) {
+        double mean = sum[j] / data.rows;
+        meanVariance += std::max(0.0, squares[j] / data.rows - mean * mean);
+    }
+    tolScaled = tol * meanVariance / std::max<size_t>(1, dim);
+
+    algorithmUsed = requested;
+    if (algorithmUsed == KMeansAlgorithm::Auto) {
+        bool elkanFits = data.rows * clusters * sizeof(float) <= kElkanBoundBytes;
+        algorithmUsed = clusters <= kHamerlyMaxClusters || !elkanFits ? KMeansAlgorithm::Hamerly : KMeansAlgorithm::Elkan;
+    }
+
+    if (algorithmUsed == KMeansAlgorithm::MiniBatch) {
+        // เริ่มต้นจากตัวอย่างขนาดเล็ก แล้ววนชุดย่อยจนค่า inertia เฉลี่ยไม่ดีขึ้น
+        size_t sampleRows = std::min(data.rows, std::max(3 * miniBatchSize, 10 * clusters));
+        std::vector<float> sample;
+        const float* initRows = rows;
+        if (sampleRows < data.rows) {
+            std::vector<size_t> order(data.rows);
+            std::iota(order.begin(), order.end(), size_t(0));
+            std::mt19937 rng(seed);
+            std::shuffle(order.begin(), order.end(), rng);
+            sample.resize(sampleRows * dim);
+            for (size_t i = 0; i < sampleRows; i++) {
+                std::copy(data.row(order[i]), data.row(order[i]) + dim, sample.begin() + i * dim);
+            }
+            initRows = sample.data();
+        }
+        initialize(initRows, sampleRows);
+        seenCounts.assign(clusters, 0.0);
+        size_t batchesPerEpoch = (data.rows + miniBatchSize - 1) / miniBatchSize;
+        miniBatchPass(rows, data.rows, maxIterations * batchesPerEpoch, true);
+    } else {
+        initialize(rows, data.rows);
+        if (algorithmUsed == KMeansAlgorithm::Lloyd) {
+            runLloyd(rows, data.rows);
+        } else if (algorithmUsed == KMeansAlgorithm::Hamerly) {
+            runHamerly(rows, data.rows);
+        } else {
+            runElkan(rows, data.rows);
+        }
+    }
+    finish(rows, data.rows);
+    seenCounts.assign(clusterSizes.begin(), clusterSizes.end());
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void KMeansModel::partialFit(const Dataset& data) {
+    if (centers.empty()) {
+        // ข้อมูลแบบสตรีม: ชุดแรกใช้ mini-batch ตั้งแต่ต้น
+        KMeansAlgorithm saved = requested;
+        size_t savedIterations = maxIterations;
+        requested = KMeansAlgorithm::MiniBatch;
+        maxIterations = 1;
+        fit(data);
+        requested = saved;
+        maxIterations = savedIterations;
+        return;
+    }
+    if (data.cols != dim) {
+        throw std::invalid_argument("Dataset has " + std::to_string(data.cols) + " features but KMeans was trained on " +
+                                    std::to_string(dim));
+    }
+    auto start = std::chrono::steady_clock::now();
+    stats = KMeansStats();
+    algorithmUsed = KMeansAlgorithm::MiniBatch;
+    trainingCalls++;
+    rowsSeen += data.rows;
+    size_t batches = (data.rows + miniBatchSize - 1) / miniBatchSize;
+    miniBatchPass(data.features.data(), data.rows, batches, false);
+    finish(data.features.data(), data.rows);
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void KMeansModel::initialize(const float* data, size_t rows) {
+    std::mt19937 rng(seed);
+    centers.assign(clusters * dim, 0.0f);
+    if (randomInit) {
+        std::vector<size_t> order(rows);
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::shuffle(order.begin(), order.end(), rng);
+        for (size_t c = 0; c < clusters; c++) {
+            std::copy(data + order[c] * dim, data + (order[c] + 1) * dim, centers.begin() + c * dim);
+        }
+        return;
+    }
+
+    // k-means||: แต่ละรอบเลือกแถวด้วยความน่าจะเป็น l * d²(x) / phi พร้อมกันทุกแถว
+    std::vector<size_t> candidates = {std::uniform_int_distribution<size_t>(0, rows - 1)(rng)};
+    std::vector<float> candidateRows(data + candidates[0] * dim, data + (candidates[0] + 1) * dim);
+    std::vector<float> nearest(rows);
+    std::vector<uint32_t> labels(rows);
+    nearestCenters(data, rows, dim, candidateRows.data(), 1, labels.data(), nearest.data());
+    stats.initDistances += rows;
+    double oversampling = 2.0 * clusters;
+    size_t chunks = parallelChunks(rows, kMinChunkRows);
+
+    for (size_t round = 0; round < initRounds; round++) {
+        double phi = std::accumulate(nearest.begin(), nearest.end(), 0.0);
+        if (phi <= 0.0) {
+            break;
+        }
+        std::vector<std::vector<size_t>> picked(chunks);
+        parallelFor(0, rows, [&](size_t begin, size_t end, size_t worker) {
+            for (size_t i = begin; i < end; i++) {
+                if (hashUniform(seed, round + 1, i) < oversampling * nearest[i] / phi) {
+                    picked[worker].push_back(i);
+                }
+            }
+        }, kMinChunkRows);
+        std::vector<float> added;
+        for (const auto& part : picked) {
+            for (size_t index : part) {
+                candidates.push_back(index);
+                added.insert(added.end(), data + index * dim, data + (index + 1) * dim);
+            }
+        }
+        size_t count = added.size() / dim;
+        if (count == 0) {
+            continue;
+        }
+        candidateRows.insert(candidateRows.end(), added.begin(), added.end());
+        std::vector<float> toAdded(rows);
+        nearestCenters(data, rows, dim, added.data(), count, labels.data(), toAdded.data());
+        stats.initDistances += static_cast<uint64_t>(rows) * count;
+        for (size_t i = 0; i < rows; i++) {
+            nearest[i] = std::min(nearest[i], toAdded[i]);
+        }
+    }
+    // ข้อมูลซ้ำกันมากจนผู้สมัครไม่พอ: เติมแถวสุ่ม
+    while (candidates.size() < clusters) {
+        size_t index = std::uniform_int_distribution<size_t>(0, rows - 1)(rng);
+        candidates.push_back(index);
+        candidateRows.insert(candidateRows.end(), data + index * dim, data + (index + 1) * dim);
+    }
+    size_t m = candidates.size();
+    stats.initCandidates = m;
+
+    // น้ำหนักของผู้สมัคร = จำนวนแถวที่อยู่ใกล้ผู้สมัครนั้นที่สุด
+    nearestCenters(data, rows, dim, candidateRows.data(), m, labels.data(), nullptr);
+    stats.initDistances += static_cast<uint64_t>(rows) * m;
+    std::vector<double> weights(m, 0.0);
+    for (size_t i = 0; i < rows; i++) {
+        weights[labels[i]] += 1.0;
+    }
+
+    // k-means++ แบบถ่วงน้ำหนักบนผู้สมัคร ปรับด้วย Lloyd แบบถ่วงน้ำหนัก แล้วเก็บผลที่ดีที่สุดจากหลายครั้ง
+    // (ผู้สมัครมีไม่กี่ร้อยตัว ทำซ้ำได้ถูกกว่ารอบเดียวบนข้อมูลจริงมาก)
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    auto pick = [&](const std::vector<double>& mass) {
+        double total = std::accumulate(mass.begin(), mass.end(), 0.0);
+        if (total <= 0.0) {
+            return static_cast<size_t>(std::max_element(weights.begin(), weights.end()) - weights.begin());
+        }
+        double target = uniform(rng) * total;
+        for (size_t j = 0; j < m; j++) {
+            target -= mass[j];
+            if (target <= 0.0) {
+                return j;
+            }
+        }
+        return m - 1;
+    };
+    // แบบ greedy: ลองผู้สมัคร 2 + ln(k) ตัวต่อขั้น แล้วเลือกตัวที่ทำให้ผลรวมระยะถ่วงน้ำหนักน้อยที่สุด
+    size_t trials = 2 + static_cast<size_t>(std::log(static_cast<double>(clusters)));
+    std::vector<double> minDistance(m), mass(m), trial(m), bestTrial(m);
+    std::vector<float> attempt(clusters * dim), owned(m);
+    std::vector<uint32_t> owner(m);
+    double bestAttempt = std::numeric_limits<double>::infinity();
+
+    size_t attempts = m * clusters <= kReductionBudget ? kReductionAttempts : 1;
+    for (size_t run = 0; run < attempts; run++) {
+        size_t chosen = pick(weights);
+        for (size_t j = 0; j < m; j++) {
+            minDistance[j] = squaredL2(candidateRows.data() + j * dim, candidateRows.data() + chosen * dim, dim);
+        }
+        for (size_t c = 0; c < clusters; c++) {
+            std::copy(candidateRows.begin() + chosen * dim, candidateRows.begin() + (chosen + 1) * dim,
+                      attempt.begin() + c * dim);
+            if (c + 1 == clusters) {
+                break;
+            }
+            for (size_t j = 0; j < m; j++) {
+                mass[j] = weights[j] * minDistance[j];
+            }
+            double bestPotential = std::numeric_limits<double>::infinity();
+            for (size_t t = 0; t < trials; t++) {
+                size_t option = pick(mass);
+                double potential = 0.0;
+                for (size_t j = 0; j < m; j++) {
+                    double d = squaredL2(candidateRows.data() + j * dim, candidateRows.data() + option * dim, dim);
+                    trial[j] = std::min(minDistance[j], d);
+                    potential += weights[j] * trial[j];
+                }
+                if (potential < bestPotential) {
+                    bestPotential = potential;
+                    chosen = option;
+                    bestTrial.swap(trial);
+                }
+            }
+            minDistance.swap(bestTrial);
+        }
+
+        double potential = 0.0;
+        for (size_t round = 0; round <= kCandidateLloydRounds; round++) {
+            nearestCenters(candidateRows.data(), m, dim, attempt.data(), clusters, owner.data(), owned.data());
+            if (round == kCandidateLloydRounds) {
+                break;
+            }
+            std::vector<double> sums(clusters * dim, 0.0), totals(clusters, 0.0);
+            for (size_t j = 0; j < m; j++) {
+                const float* x = candidateRows.data() + j * dim;
+                double* target = sums.data() + owner[j] * dim;
+                for (size_t d = 0; d < dim; d++) {
+                    target[d] += weights[j] * x[d];
+                }
+                totals[owner[j]] += weights[j];
+            }
+            for (size_t c = 0; c < clusters; c++) {
+                if (totals[c] > 0.0) {
+                    for (size_t d = 0; d < dim; d++) {
+                        attempt[c * dim + d] = static_cast<float>(sums[c * dim + d] / totals[c]);
+                    }
+                }
+            }
+        }
+        for (size_t j = 0; j < m; j++) {
+            potential += weights[j] * owned[j];
+        }
+        if (potential < bestAttempt) {
+            bestAttempt = potential;
+            centers = attempt;
+        }
+    }
+}
+
+std::vector<float> KMeansModel::updateCenters(const std::vector<std::vector<double>>& sums,
+                                              const std::vector<std::vector<uint64_t>>& counts) {
+    std::vector<float> shifts(clusters, 0.0f);
+    std::vector<float> updated(dim);
+    for (size_t c = 0; c < clusters; c++) {
+        double total = 0.0;
+        for (const auto& part : counts) {
+            total += part[c];
+        }
+        if (total == 0.0) {
+            continue;  // กลุ่มว่างคงศูนย์กลางเดิมไว้
+        }
+        for (size_t d = 0; d < dim; d++) {
+            double value = 0.0;
+            for (const auto& part : sums) {
+                value += part[c * dim + d];
+            }
+            updated[d] = static_cast<float>(value / total);
+        }
+        float* center = centers.data() + c * dim;
+        shifts[c] = distance(center, updated.data(), dim);
+        std::copy(updated.begin(), updated.end(), center);
+    }
+    return shifts;
+}
+
+bool KMeansModel::shiftConverged(const std::vector<float>& shifts) const {
+    double total = 0.0;
+    for (float shift : shifts) {
+        total += static_cast<double>(shift) * shift;
+    }
+    return total <= tolScaled;
+}
+
+void KMeansModel::runLloyd(const float* data, size_t rows) {
+    std::vector<uint32_t> labels(rows, std::numeric_limits<uint32_t>::max());
+    size_t chunks = parallelChunks(rows, kMinChunkRows);
+    size_t block = blockRowsFor(clusters);
+    for (size_t iteration = 0; iteration < maxIterations; iteration++) {
+        std::vector<std::vector<double>> sums(chunks, std::vector<double>(clusters * dim, 0.0));
+        std::vector<std::vector<uint64_t>> counts(chunks, std::vector<uint64_t>(clusters, 0));
+        std::vector<size_t> changed(chunks, 0);
+        std::vector<float> norms(clusters);
+        squaredNorms(centers.data(), clusters, dim, norms.data());
+        parallelFor(0, rows, [&](size_t begin, size_t end, size_t worker) {
+            std::vector<float> scratch;
+            std::vector<uint32_t> assigned(block);
+            for (size_t start = begin; start < end; start += block) {
+                size_t n = std::min(block, end - start);
+                nearestBlock(data + start * dim, n, dim, centers.data(), norms.data(), clusters, scratch,
+                             assigned.data(), nullptr);
+                for (size_t r = 0; r < n; r++) {
+                    size_t i = start + r;
+                    changed[worker] += assigned[r] != labels[i];
+                    labels[i] = assigned[r];
+                    addRow(sums[worker].data() + assigned[r] * dim, data + i * dim, dim);
+                    counts[worker][assigned[r]]++;
+                }
+            }
+        }, kMinChunkRows);
+        stats.distancesComputed += static_cast<uint64_t>(rows) * clusters;
+        std::vector<float> shifts = updateCenters(sums, counts);
+        stats.iterations++;
+        if (std::accumulate(changed.begin(), changed.end(), size_t(0)) == 0 || shiftConverged(shifts)) {
+            stats.converged = true;
+            break;
+        }
+    }
+}
+
+void KMeansModel::runHamerly(const float* data, size_t rows) {
+    std::vector<uint32_t> labels(rows);
+    std::vector<float> upper(rows), lower(rows);
+    size_t chunks = parallelChunks(rows, kMinChunkRows);
+    std::vector<float> half;
+
+    for (size_t iteration = 0; iteration < maxIterations; iteration++) {
+        std::vector<std::vector<double>> sums(chunks, std::vector<double>(clusters * dim, 0.0));
+        std::vector<std::vector<uint64_t>> counts(chunks, std::vector<uint64_t>(clusters, 0));
+        std::vector<uint64_t> computed(chunks, 0), skipped(chunks, 0), changed(chunks, 0);
+        centerSeparation(centers, clusters, dim, half, nullptr);
+
+        parallelFor(0, rows, [&](size_t begin, size_t end, size_t worker) {
+            for (size_t i = begin; i < end; i++) {
+                const float* x = data + i * dim;
+                uint32_t a = labels[i];
+                if (iteration > 0) {
+                    float bound = std::max(half[a], lower[i]);
+                    if (upper[i] <= bound) {
+                        skipped[worker] += clusters;
+                        addRow(sums[worker].data() + a * dim, x, dim);
+                        counts[worker][a]++;
+                        continue;
+                    }
+                    upper[i] = distance(x, centers.data() + a * dim, dim);
+                    computed[worker]++;
+                    if (upper[i] <= bound) {
+                        skipped[worker] += clusters - 1;
+                        addRow(sums[worker].data() + a * dim, x, dim);
+                        counts[worker][a]++;
+                        continue;
+                    }
+                }
+                // ค้นทุกศูนย์กลาง (รอบแรกทุกแถวมาที่นี่)
+                uint32_t best = a;
+                float bestDistance = iteration > 0 ? upper[i] : std::numeric_limits<float>::infinity();
+                float second = std::numeric_limits<float>::infinity();
+                for (size_t c = 0; c < clusters; c++) {
+                    if (iteration > 0 && c == a) {
+                        continue;
+                    }
+                    float d = distance(x, centers.data() + c * dim, dim);
+                    if (d < bestDistance) {
+                        second = bestDistance;
+                        bestDistance = d;
+                        best = static_cast<uint32_t>(c);
+                    } else if (d < second) {
+                        second = d;
+                    }
+                }
+                computed[worker] += iteration > 0 ? clusters - 1 : clusters;
+                changed[worker] += iteration == 0 || best != a;
+                labels[i] = best;
+                upper[i] = bestDistance;
+                lower[i] = second;
+                addRow(sums[worker].data() + best * dim, x, dim);
+                counts[worker][best]++;
+            }
+        }, kMinChunkRows);
+
+        stats.distancesComputed += std::accumulate(computed.begin(), computed.end(), uint64_t(0));
+        stats.distancesSkipped += std::accumulate(skipped.begin(), skipped.end(), uint64_t(0));
+        stats.iterations++;
+        std::vector<float> shifts = updateCenters(sums, counts);
+        bool stable = iteration > 0 && std::accumulate(changed.begin(), changed.end(), uint64_t(0)) == 0;
+        if (stable || shiftConverged(shifts)) {
+            stats.converged = true;
+            break;
+        }
+
+        // ขอบเขตบนเพิ่มตามการเคลื่อนของศูนย์กลางของแถว ขอบเขตล่างลดตามการเคลื่อนมากสุดของศูนย์กลางอื่น
+        size_t farthest = std::max_element(shifts.begin(), shifts.end()) - shifts.begin();
+        float maxShift = shifts[farthest], secondShift = 0.0f;
+        for (size_t c = 0; c < clusters; c++) {
+            if (c != farthest) {
+                secondShift = std::max(secondShift, shifts[c]);
+            }
+        }
+        parallelFor(0, rows, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; i++) {
+                upper[i] += shifts[labels[i]];
+                lower[i] -= labels[i] == farthest ? secondShift : maxShift;
+            }
+        }, kMinChunkRows);
+    }
+}
+
+void KMeansModel::runElkan(const float* data, size_t rows) {
+    std::vector<uint32_t> labels(rows);
+    std::vector<float> upper(rows), lower(rows * clusters);
+    size_t chunks = parallelChunks(rows, kMinChunkRows);
+    std::vector<float> half, between;
+
+    for (size_t iteration = 0; iteration < maxIterations; iteration++) {
+        std::vector<std::vector<double>> sums(chunks, std::vector<double>(clusters * dim, 0.0));
+        std::vector<std::vector<uint64_t>> counts(chunks, std::vector<uint64_t>(clusters, 0));
+        std::vector<uint64_t> computed(chunks, 0), skipped(chunks, 0), changed(chunks, 0);
+        centerSeparation(centers, clusters, dim, half, &between);
+
+        parallelFor(0, rows, [&](size_t begin, size_t end, size_t worker) {
+            for (size_t i = begin; i < end; i++) {
+                const float* x = data + i * dim;
+                float* bounds = lower.data() + i * clusters;
+                uint32_t a = labels[i];
+                uint64_t done = 0;
+                if (iteration == 0) {
+                    float best = std::numeric_limits<float>::infinity();
+                    for (size_t c = 0; c < clusters; c++) {
+                        bounds[c] = distance(x, centers.data() + c * dim, dim);
+                        if (bounds[c] < best) {
+                            best = bounds[c];
+                            a = static_cast<uint32_t>(c);
+                        }
+                    }
+                    upper[i] = best;
+                    done = clusters;
+                    changed[worker]++;
+                } else if (upper[i] > half[a]) {
+                    bool stale = true;
+                    uint32_t original = a;
+                    for (size_t c = 0; c < clusters; c++) {
+                        if (c == a || upper[i] <= bounds[c] || upper[i] <= 0.5f * between[a * clusters + c]) {
+                            continue;
+                        }
+                        if (stale) {
+                            upper[i] = distance(x, centers.data() + a * dim, dim);
+                            bounds[a] = upper[i];
+                            stale = false;
+                            done++;
+                            if (upper[i] <= bounds[c] || upper[i] <= 0.5f * between[a * clusters + c]) {
+                                continue;
+                            }
+                        }
+                        float d = distance(x, centers.data() + c * dim, dim);
+                        bounds[c] = d;
+                        done++;
+                        if (d < upper[i]) {
+                            a = static_cast<uint32_t>(c);
+                            upper[i] = d;
+                        }
+                    }
+                    changed[worker] += a != original;
+                }
+                computed[worker] += done;
+                skipped[worker] += clusters - done;
+                labels[i] = a;
+                addRow(sums[worker].data() + a * dim, x, dim);
+                counts[worker][a]++;
+            }
+        }, kMinChunkRows);
+
+        stats.distancesComputed += std::accumulate(computed.begin(), computed.end(), uint64_t(0));
+        stats.distancesSkipped += std::accumulate(skipped.begin(), skipped.end(), uint64_t(0));
+        stats.iterations++;
+        std::vector<float> shifts = updateCenters(sums, counts);
+        bool stable = iteration > 0 && std::accumulate(changed.begin(), changed.end(), uint64_t(0)) == 0;
+        if (stable || shiftConverged(shifts)) {
+            stats.converged = true;
+            break;
+        }
+
+        parallelFor(0, rows, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; i++) {
+                float* bounds = lower.data() + i * clusters;
+                for (size_t c = 0; c < clusters; c++) {
+                    bounds[c] = std::max(0.0f, bounds[c] - shifts[c]);
+                }
+                upper[i] += shifts[labels[i]];
+            }
+        }, kMinChunkRows);
+    }
+}
+
+void KMeansModel::miniBatchPass(const float* data, size_t rows, size_t maxBatches, bool earlyStop) {
+    std::mt19937 rng(seed + static_cast<unsigned>(trainingCalls) * 7919u);
+    if (seenCounts.size() != clusters) {
+        seenCounts.assign(clusters, 0.0);
+    }
+    size_t batchSize = std::min(miniBatchSize, rows);
+    std::vector<size_t> order(rows);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::shuffle(order.begin(), order.end(), rng);
+    size_t position = 0;
+
+    std::vector<float> batch(batchSize * dim), distances(batchSize);
+    std::vector<uint32_t> labels(batchSize);
+    double smoothed = -1.0, best = std::numeric_limits<double>::infinity();
+    double alpha = std::min(1.0, 2.0 * batchSize / (rows + 1.0));
+    size_t noImprovement = 0;
+
+    for (size_t step = 0; step < maxBatches; step++) {
+        for (size_t r = 0; r < batchSize; r++) {
+            if (position == rows) {
+                std::shuffle(order.begin(), order.end(), rng);
+                position = 0;
+            }
+            const float* x = data + order[position++] * dim;
+            std::copy(x, x + dim, batch.begin() + r * dim);
+        }
+        nearestCenters(batch.data(), batchSize, dim, centers.data(), clusters, labels.data(), distances.data());
+        stats.distancesComputed += static_cast<uint64_t>(batchSize) * clusters;
+        stats.iterations++;
+
+        // อัตราเรียนรู้ต่อศูนย์กลาง 1 / จำนวนแถวที่ศูนย์กลางนั้นเคยเห็น
+        for (size_t r = 0; r < batchSize; r++) {
+            uint32_t c = labels[r];
+            seenCounts[c] += 1.0;
+            float eta = static_cast<float>(1.0 / seenCounts[c]);
+            float* center = centers.data() + c * dim;
+            const float* x = batch.data() + r * dim;
+            for (size_t d = 0; d < dim; d++) {
+                center[d] += eta * (x[d] - center[d]);
+            }
+        }
+
+        if (earlyStop) {
+            double inertia = std::accumulate(distances.begin(), distances.end(), 0.0) / batchSize;
+            smoothed = smoothed < 0.0 ? inertia : smoothed * (1.0 - alpha) + inertia * alpha;
+            if (smoothed < best) {
+                best = smoothed;
+                noImprovement = 0;
+            } else if (++noImprovement >= kNoImprovementBatches) {
+                stats.converged = true;
+                break;
+            }
+        }
+    }
+    if (!earlyStop) {
+        stats.converged = true;
+    }
+}
+
+void KMeansModel::finish(const float* data, size_t rows) {
+    std::vector<uint32_t> labels(rows);
+    std::vector<float> distances(rows);
+    assign(data, rows, labels.data(), distances.data());
+    stats.inertia = std::accumulate(distances.begin(), distances.end(), 0.0);
+    clusterSizes.assign(clusters, 0);
+    for (uint32_t label : labels) {
+        clusterSizes[label]++;
+    }
+}
+
+void KMeansModel::assign(const float* rows, size_t count, uint32_t* labels, float* distances) const {
+    if (centers.empty()) {
+        throw std::runtime_error("KMeans has not been trained");
+    }
+    nearestCenters(rows, count, dim, centers.data(), clusters, labels, distances);
+}
+
+void KMeansModel::predictBatch(const float* rows, size_t count, float* out) const {
+    std::vector<uint32_t> labels(count);
+    assign(rows, count, labels.data(), nullptr);
+    for (size_t i = 0; i < count; i++) {
+        out[i] = static_cast<float>(labels[i]);
+    }
+}
+
+void KMeansModel::reportBatch(const float* rows, size_t count, std::ostream& os) const {
+    if (count == 0 || centers.empty()) {
+        return;
+    }
+    std::vector<uint32_t> labels(count);
+    std::vector<float> distances(count);
+    assign(rows, count, labels.data(), distances.data());
+    std::vector<size_t> sizes(clusters, 0);
+    for (uint32_t label : labels) {
+        sizes[label]++;
+    }
+    double inertia = std::accumulate(distances.begin(), distances.end(), 0.0);
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << std::fixed << std::setprecision(4);
+    os << "Inertia of " << count << " rows: " << inertia << " (mean squared distance " << inertia / count << ")\n";
+    os << "Rows per cluster:";
+    for (size_t c = 0; c < clusters; c++) {
+        os << " " << sizes[c];
+    }
+    os << "\n";
+    os.flags(flags);
+    os.precision(precision);
+}
+
+bool KMeansModel::emitSource(SourceWriter& out) const {
+    if (centers.empty()) {
+        return false;
+    }
+    out.floatArray("kCenters", centers);
+    out.line() << "\n";
+    out.line() << "static float model(const float* x) {\n";
+    out.indent();
+    out.line() << "std::size_t best = 0;\n";
+    out.line() << "float bestDistance = std::numeric_limits<float>::infinity();\n";
+    out.line() << "for (std::size_t c = 0; c < " << clusters << "; c++) {\n";
+    out.line() << "    float d2 = 0.0f;\n";
+    out.line() << "    for (std::size_t j = 0; j < " << dim << "; j++) {\n";
+    out.line() << "        float d = x[j] - kCenters[c * " << dim << " + j];\n";
+    out.line() << "        d2 += d * d;\n";
+    out.line() << "    }\n";
+    out.line() << "    if (d2 < bestDistance) {\n";
+    out.line() << "        bestDistance = d2;\n";
+    out.line() << "        best = c;\n";
+    out.line() << "    }\n";
+    out.line() << "}\n";
+    out.line() << "return static_cast<float>(best);\n";
+    out.dedent();
+    out.line() << "}\n";
+    return true;
+}
+
+size_t KMeansModel::memoryBytes() const {
+    return centers.size() * sizeof(float) + clusterSizes.size() * sizeof(uint64_t) + seenCounts.size() * sizeof(double);
+}
+
+void KMeansModel::describe(std::ostream& os) const {
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << "KMeans (" << algorithmName(algorithmUsed) << ", " << (randomInit ? "random" : "k-means||") << " init";
+    if (stats.initCandidates > 0) {
+        os << " with " << stats.initCandidates << " candidates";
+    }
+    os << "): " << clusters << " clusters x " << featureCount << " features\n";
+    os << "Last training call: " << stats.iterations
+       << (algorithmUsed == KMeansAlgorithm::MiniBatch ? " mini-batches" : " iterations")
+       << (stats.converged ? " (converged)" : " (iteration limit)") << " in " << std::fixed << std::setprecision(4)
+       << stats.seconds << "s, inertia " << std::setprecision(4) << stats.inertia << "\n";
+    uint64_t lloyd = stats.distancesComputed + stats.distancesSkipped;
+    os << "Distance computations: " << stats.distancesComputed << " computed";
+    if (algorithmUsed == KMeansAlgorithm::Hamerly || algorithmUsed == KMeansAlgorithm::Elkan) {
+        os << ", " << stats.distancesSkipped << " skipped by bounds (" << std::setprecision(1)
+           << (lloyd > 0 ? 100.0 * stats.distancesSkipped / lloyd : 0.0) << "% of Lloyd)";
+    }
+    if (stats.initDistances > 0) {
+        os << ", " << stats.initDistances << " during initialization";
+    }
+    os << "\n";
+    if (trainingCalls > 1) {
+        os << rowsSeen << " rows seen across " << trainingCalls << " training calls\n";
+    }
+    os << "Cluster sizes:";
+    size_t shown = std::min<size_t>(clusters, 20);
+    for (size_t c = 0; c < shown; c++) {
+        os << " " << clusterSizes[c];
+    }
+    if (clusters > shown) {
+        os << " ...";
+    }
+    os << "\n";
+    os.flags(flags);
+    os.precision(precision);
+}
+
+} // namespace ai_language
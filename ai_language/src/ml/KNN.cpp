@@ -0,0 +1,538 @@
+#include "../../include/ml/KNN.h"
+#include "../../include/ml/HNSW.h"
+#include "../../include/utils/parallel.h"
+#include "../../include/utils/cpu_features.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace ai_language {
+
+/**
+ * @brief max-heap ขนาดจำกัดสำหรับเก็บเพื่อนบ้านที่ใกล้ที่สุด k ตัว
+ */
+class NeighborHeap {
+public:
+    explicit NeighborHeap(size_t capacity) : capacity(capacity) {
+        entries.reserve(capacity);
+    }
+
+    float worst() const {
+        return entries.size() < capacity ? std::numeric_limits<float>::infinity() : entries.front().first;
+    }
+
+    void push(float distance, uint32_t index) {
+        if (entries.size() < capacity) {
+            entries.emplace_back(distance, index);
+            std::push_heap(entries.begin(), entries.end());
+        } else if (distance < entries.front().first) {
+            std::pop_heap(entries.begin(), entries.end());
+            entries.back() = {distance, index};
+            std::push_heap(entries.begin(), entries.end());
+        }
+    }
+
+    // เรียงจากใกล้ไปไกลและเขียนผลลัพธ์ (ช่องที่เหลือเติมด้วยเพื่อนบ้านตัวสุดท้าย)
+    void drain(uint32_t* indices, float* distances) {
+        std::sort_heap(entries.begin(), entries.end());
+        for (size_t i = 0; i < capacity; i++) {
+            const auto& entry = entries[std::min(i, entries.size() - 1)];
+            indices[i] = entry.second;
+            distances[i] = entry.first;
+        }
+        entries.clear();
+    }
+
+private:
+    size_t capacity;
+    std::vector<std::pair<float, uint32_t>> entries;
+};
+
+namespace {
+
+constexpr size_t kQueryTile = 64;
+constexpr size_t kPointTile = 256;
+
+void normalizeRows(float* rows, size_t count, size_t dim) {
+    for (size_t i = 0; i < count; i++) {
+        float* row = rows + i * dim;
+        float norm = std::sqrt(dotProduct(row, row, dim));
+        if (norm > 0.0f) {
+            for (size_t j = 0; j < dim; j++) {
+                row[j] /= norm;
+            }
+        }
+    }
+}
+
+} // namespace
+
+KNNModel::KNNModel(const ModelParams& params)
+    : k(static_cast<size_t>(std::max(1.0, params.get("k", params.get("n_neighbors", 5))))),
+      leafSize(static_cast<size_t>(std::max(4.0, params.get("leaf_size", 32)))),
+      hnswM(static_cast<size_t>(std::max(2.0, params.get("M", params.get("m", 16))))),
+      efConstruction(static_cast<size_t>(std::max(8.0, params.get("ef_construction", 200)))),
+      efSearch(static_cast<size_t>(std::max(1.0, params.get("ef_search", 64)))),
+      recallSample(static_cast<size_t>(std::max(0.0, params.get("recall_sample", 100)))),
+      seed(static_cast<unsigned>(params.get("random_state", params.get("seed", 42)))),
+      metric(DistanceMetric::Euclidean),
+      requestedIndex(KNNIndexType::Auto),
+      builtIndex(KNNIndexType::Brute),
+      classification(true),
+      numClassesCount(0),
+      rowCount(0) {
+    std::string metricName = params.getString("metric", "euclidean");
+    if (!parseDistanceMetric(metricName, metric)) {
+        throw std::invalid_argument("Unknown distance metric '" + metricName + "' (use euclidean or cosine)");
+    }
+    std::string indexName = params.getString("index", "auto");
+    if (indexName == "auto") {
+        requestedIndex = KNNIndexType::Auto;
+    } else if (indexName == "kdtree" || indexName == "kd_tree") {
+        requestedIndex = KNNIndexType::KDTree;
+    } else if (indexName == "balltree" || indexName == "ball_tree") {
+        requestedIndex = KNNIndexType::BallTree;
+    } else if (indexName == "brute") {
+        requestedIndex = KNNIndexType::Brute;
+    } else if (indexName == "hnsw") {
+        requestedIndex = KNNIndexType::HNSW;
+    } else {
+        throw std::invalid_argument("Unknown KNN index '" + indexName + "' (use auto, kdtree, balltree, brute or hnsw)");
+    }
+}
+
+KNNModel::~KNNModel() = default;
+
+std::string KNNModel::indexName(KNNIndexType type) {
+    switch (type) {
+        case KNNIndexType::KDTree: return "KD-tree";
+        case KNNIndexType::BallTree: return "Ball tree";
+        case KNNIndexType::Brute: return "brute-force (tiled)";
+        case KNNIndexType::HNSW: return "HNSW (approximate)";
+        default: return "auto";
+    }
+}
+
+void KNNModel::fit(const Dataset& data) {
+    if (data.empty()) {
+        throw std::runtime_error("KNN requires a non-empty dataset");
+    }
+    featureCount = data.cols;
+    rowCount = data.rows;
+    classification = data.isClassification();
+    numClassesCount = classification ? data.numClasses() : 0;
+    points = data.features;
+    labels = data.targets;
+    originalIndex.resize(rowCount);
+    std::iota(originalIndex.begin(), originalIndex.end(), 0u);
+    if (metric == DistanceMetric::Cosine) {
+        normalizeRows(points.data(), rowCount, featureCount);
+    }
+
+    // KD-tree สำหรับมิติต่ำ, ball tree สำหรับมิติปานกลาง, brute-force แบบบล็อกเมื่อข้อมูลน้อยหรือมิติสูงมาก
+    builtIndex = requestedIndex;
+    if (builtIndex == KNNIndexType::Auto) {
+        if (rowCount < 4 * leafSize || featureCount > 128) {
+            builtIndex = KNNIndexType::Brute;
+        } else if (featureCount <= 16) {
+            builtIndex = KNNIndexType::KDTree;
+        } else {
+            builtIndex = KNNIndexType::BallTree;
+        }
+    }
+
+    nodes.clear();
+    centers.clear();
+    graph.reset();
+    if (builtIndex == KNNIndexType::KDTree || builtIndex == KNNIndexType::BallTree) {
+        buildTree(builtIndex == KNNIndexType::BallTree);
+    } else if (builtIndex == KNNIndexType::HNSW) {
+        graph = std::make_unique<HNSWIndex>(hnswM, efConstruction, seed);
+        graph->build(points.data(), rowCount, featureCount);
+    }
+    pointNorms.resize(rowCount);
+    squaredNorms(points.data(), rowCount, featureCount, pointNorms.data());
+}
+
+void KNNModel::buildTree(bool ball) {
+    const size_t dim = featureCount;
+    std::vector<uint32_t> order(rowCount);
+    std::iota(order.begin(), order.end(), 0u);
+
+    struct Pending {
+        int32_t node;
+        uint32_t begin;
+        uint32_t end;
+    };
+    nodes.push_back({0, static_cast<uint32_t>(rowCount), -1, -1, -1, 0.0f, 0.0f});
+    std::vector<Pending> stack = {{0, 0, static_cast<uint32_t>(rowCount)}};
+    std::vector<float> lo(dim), hi(dim), center(dim);
+
+    while (!stack.empty()) {
+        Pending item = stack.back();
+        stack.pop_back();
+
+        // หาขอบเขตและจุดศูนย์กลางของโหนด
+        std::fill(lo.begin(), lo.end(), std::numeric_limits<float>::infinity());
+        std::fill(hi.begin(), hi.end(), -std::numeric_limits<float>::infinity());
+        std::fill(center.begin(), center.end(), 0.0f);
+        for (uint32_t i = item.begin; i < item.end; i++) {
+            const float* p = points.data() + static_cast<size_t>(order[i]) * dim;
+            for (size_t d = 0; d < dim; d++) {
+                lo[d] = std::min(lo[d], p[d]);
+                hi[d] = std::max(hi[d], p[d]);
+                center[d] += p[d];
+            }
+        }
+        size_t count = item.end - item.begin;
+        if (ball) {
+            float radius = 0.0f;
+            for (size_t d = 0; d < dim; d++) {
+                center[d] /= static_cast<float>(count);
+            }
+            for (uint32_t i = item.begin; i < item.end; i++) {
+                radius = std::max(radius, squaredL2(center.data(), points.data() + static_cast<size_t>(order[i]) * dim, dim));
+            }
+            nodes[item.node].radius = std::sqrt(radius);
+            centers.resize(nodes.size() * dim);
+            std::copy(center.begin(), center.end(), centers.begin() + static_cast<size_t>(item.node) * dim);
+        }
+
+        if (count <= leafSize) {
+            continue;
+        }
+
+        // แบ่งตามมิติที่มีช่วงกว้างที่สุดที่ค่ามัธยฐาน
+        size_t splitDim = 0;
+        float bestSpread = -1.0f;
+        for (size_t d = 0; d < dim; d++) {
+            if (hi[d] - lo[d] > bestSpread) {
+                bestSpread = hi[d] - lo[d];
+                splitDim = d;
+            }
+        }
+        if (bestSpread <= 0.0f) {
+            continue; // จุดทั้งหมดซ้ำกัน
+        }
+        uint32_t mid = item.begin + static_cast<uint32_t>(count / 2);
+        std::nth_element(order.begin() + item.begin, order.begin() + mid, order.begin() + item.end,
+                         [&](uint32_t a, uint32_t b) {
+                             return points[static_cast<size_t>(a) * dim + splitDim] <
+                                    points[static_cast<size_t>(b) * dim + splitDim];
+                         });
+
+        int32_t left = static_cast<int32_t>(nodes.size());
+        int32_t right = left + 1;
+        nodes.push_back({item.begin, mid, -1, -1, -1, 0.0f, 0.0f});
+        nodes.push_back({mid, item.end, -1, -1, -1, 0.0f, 0.0f});
+        Node& parent = nodes[item.node];
+        parent.left = left;
+        parent.right = right;
+        parent.splitDim = static_cast<int32_t>(splitDim);
+        parent.splitValue = points[static_cast<size_t>(order[mid]) * dim + splitDim];
+        stack.push_back({left, item.begin, mid});
+        stack.push_back({right, mid, item.end});
+    }
+    if (ball) {
+        centers.resize(nodes.size() * dim);
+    }
+
+    // จัดเรียงข้อมูลตามลำดับใบ เพื่อให้การสแกนใบอ่านหน่วยความจำต่อเนื่อง
+    std::vector<float> reordered(points.size());
+    std::vector<float> reorderedLabels(rowCount);
+    std::vector<uint32_t> reorderedIndex(rowCount);
+    for (size_t i = 0; i < rowCount; i++) {
+        std::copy(points.begin() + static_cast<size_t>(order[i]) * dim,
+                  points.begin() + static_cast<size_t>(order[i] + 1) * dim,
+                  reordered.begin() + i * dim);
+        reorderedLabels[i] = labels[order[i]];
+        reorderedIndex[i] = originalIndex[order[i]];
+    }
+    points.swap(reordered);
+    labels.swap(reorderedLabels);
+    originalIndex.swap(reorderedIndex);
+}
+
+void KNNModel::searchKD(int32_t nodeIndex, const float* query, NeighborHeap& heap) const {
+    const Node& node = nodes[nodeIndex];
+    if (node.left < 0) {
+        for (uint32_t i = node.begin; i < node.end; i++) {
+            heap.push(squaredL2(query, points.data() + static_cast<size_t>(i) * featureCount, featureCount), i);
+        }
+        return;
+    }
+    float diff = query[node.splitDim] - node.splitValue;
+    int32_t nearChild = diff < 0.0f ? node.left : node.right;
+    int32_t farChild = diff < 0.0f ? node.right : node.left;
+    searchKD(nearChild, query, heap);
+    if (diff * diff < heap.worst()) {
+        searchKD(farChild, query, heap);
+    }
+}
+
+void KNNModel::searchBall(int32_t nodeIndex, const float* query, float centerDist, NeighborHeap& heap) const {
+    const Node& node = nodes[nodeIndex];
+    float bound = std::max(0.0f, centerDist - node.radius);
+    if (bound * bound >= heap.worst()) {
+        return;
+    }
+    if (node.left < 0) {
+        for (uint32_t i = node.begin; i < node.end; i++) {
+            heap.push(squaredL2(query, points.data() + static_cast<size_t>(i) * featureCount, featureCount), i);
+        }
+        return;
+    }
+    float leftDist = std::sqrt(squaredL2(query, centers.data() + static_cast<size_t>(node.left) * featureCount, featureCount));
+    float rightDist = std::sqrt(squaredL2(query, centers.data() + static_cast<size_t>(node.right) * featureCount, featureCount));
+    if (leftDist <= rightDist) {
+        searchBall(node.left, query, leftDist, heap);
+        searchBall(node.right, query, rightDist, heap);
+    } else {
+        searchBall(node.right, query, rightDist, heap);
+        searchBall(node.left, query, leftDist, heap);
+    }
+}
+
+void KNNModel::searchOne(const float* query, NeighborHeap& heap) const {
+    if (builtIndex == KNNIndexType::KDTree) {
+        searchKD(0, query, heap);
+    } else {
+        float rootDist = std::sqrt(squaredL2(query, centers.data(), featureCount));
+        searchBall(0, query, rootDist, heap);
+    }
+}
+
+void KNNModel::prepareQueries(const float* rows, size_t count, std::vector<float>& prepared) const {
+    prepared.assign(rows, rows + count * featureCount);
+    if (metric == DistanceMetric::Cosine) {
+        normalizeRows(prepared.data(), count, featureCount);
+    }
+}
+
+void KNNModel::bruteForcePositions(const float* rows, size_t count, size_t kk,
+                                   std::vector<uint32_t>& indices, std::vector<float>& distances) const {
+    std::vector<float> queries;
+    prepareQueries(rows, count, queries);
+    kk = std::min(kk, rowCount);
+    indices.assign(count * kk, 0);
+    distances.assign(count * kk, 0.0f);
+    const size_t dim = featureCount;
+
+    // แต่ละเธรดรับผิดชอบบล็อกของคิวรี: ||q||² + ||x||² - 2 q·x คำนวณเป็นไทล์แบบ GEMM
+    size_t blocks = (count + kQueryTile - 1) / kQueryTile;
+    parallelFor(0, blocks, [&](size_t blockBegin, size_t blockEnd, size_t) {
+        std::vector<float> tile(kQueryTile * kPointTile);
+        std::vector<float> queryNorms(kQueryTile);
+        std::vector<NeighborHeap> heaps(kQueryTile, NeighborHeap(kk));
+        for (size_t block = blockBegin; block < blockEnd; block++) {
+            size_t q0 = block * kQueryTile;
+            size_t m = std::min(kQueryTile, count - q0);
+            const float* q = queries.data() + q0 * dim;
+            squaredNorms(q, m, dim, queryNorms.data());
+            for (size_t p0 = 0; p0 < rowCount; p0 += kPointTile) {
+                size_t n = std::min(kPointTile, rowCount - p0);
+                dotTile(q, m, points.data() + p0 * dim, n, dim, tile.data(), kPointTile);
+                for (size_t i = 0; i < m; i++) {
+                    const float* dots = tile.data() + i * kPointTile;
+                    float worst = heaps[i].worst();
+                    for (size_t j = 0; j < n; j++) {
+                        float d = std::max(0.0f, queryNorms[i] + pointNorms[p0 + j] - 2.0f * dots[j]);
+                        if (d < worst) {
+                            heaps[i].push(d, static_cast<uint32_t>(p0 + j));
+                            worst = heaps[i].worst();
+                        }
+                    }
+                }
+            }
+            for (size_t i = 0; i < m; i++) {
+                heaps[i].drain(indices.data() + (q0 + i) * kk, distances.data() + (q0 + i) * kk);
+            }
+        }
+    });
+}
+
+void KNNModel::neighborPositions(const float* rows, size_t count, size_t kk,
+                                 std::vector<uint32_t>& indices, std::vector<float>& distances) const {
+    if (rowCount == 0) {
+        throw std::runtime_error("KNN model has not been trained");
+    }
+    if (builtIndex == KNNIndexType::Brute) {
+        bruteForcePositions(rows, count, kk, indices, distances);
+        return;
+    }
+
+    std::vector<float> queries;
+    prepareQueries(rows, count, queries);
+    kk = std::min(kk, rowCount);
+    indices.assign(count * kk, 0);
+    distances.assign(count * kk, 0.0f);
+
+    if (builtIndex == KNNIndexType::HNSW) {
+        parallelFor(0, count, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; i++) {
+                auto found = graph->search(queries.data() + i * featureCount, kk, efSearch);
+                for (size_t j = 0; j < kk; j++) {
+                    const auto& entry = found[std::min(j, found.size() - 1)];
+                    indices[i * kk + j] = entry.second;
+                    distances[i * kk + j] = entry.first;
+                }
+            }
+        }, 32);
+        return;
+    }
+
+    parallelFor(0, count, [&](size_t begin, size_t end, size_t) {
+        NeighborHeap heap(kk);
+        for (size_t i = begin; i < end; i++) {
+            searchOne(queries.data() + i * featureCount, heap);
+            heap.drain(indices.data() + i * kk, distances.data() + i * kk);
+        }
+    }, 32);
+}
+
+void KNNModel::toOriginal(std::vector<uint32_t>& indices, std::vector<float>& distances) const {
+    for (size_t i = 0; i < indices.size(); i++) {
+        indices[i] = originalIndex[indices[i]];
+        if (metric == DistanceMetric::Cosine) {
+            distances[i] *= 0.5f; // ||a - b||² = 2 - 2cos สำหรับเวกเตอร์หนึ่งหน่วย
+        }
+    }
+}
+
+void KNNModel::kneighbors(const float* rows, size_t count, size_t kk,
+                          std::vector<uint32_t>& indices, std::vector<float>& distances) const {
+    neighborPositions(rows, count, kk, indices, distances);
+    toOriginal(indices, distances);
+}
+
+void KNNModel::bruteForceKneighbors(const float* rows, size_t count, size_t kk,
+                                    std::vector<uint32_t>& indices, std::vector<float>& distances) const {
+    if (rowCount == 0) {
+        throw std::runtime_error("KNN model has not been trained");
+    }
+    bruteForcePositions(rows, count, kk, indices, distances);
+    toOriginal(indices, distances);
+}
+
+void KNNModel::vote(const uint32_t* neighbors, size_t kk, float* out) const {
+    if (!classification) {
+        double sum = 0.0;
+        for (size_t i = 0; i < kk; i++) {
+            sum += labels[neighbors[i]];
+        }
+        *out = static_cast<float>(sum / static_cast<double>(kk));
+        return;
+    }
+    // โหวตเสียงข้างมาก ถ้าเสมอให้คลาสของเพื่อนบ้านที่ใกล้กว่าชนะ
+    // (เพื่อนบ้านเรียงจากใกล้ไปไกล คลาสแรกในลำดับนั้นที่ได้คะแนนสูงสุดจึงเป็นคลาสที่มีเพื่อนบ้านใกล้ที่สุด)
+    std::vector<size_t> votes(numClassesCount + 1, 0);
+    size_t most = 0;
+    for (size_t i = 0; i < kk; i++) {
+        size_t label = static_cast<size_t>(labels[neighbors[i]]);
+        if (label >= votes.size()) {
+            votes.resize(label + 1, 0);
+        }
+        most = std::max(most, ++votes[label]);
+    }
+    for (size_t i = 0; i < kk; i++) {
+        size_t label = static_cast<size_t>(labels[neighbors[i]]);
+        if (votes[label] == most) {
+            *out = static_cast<float>(label);
+            return;
+        }
+    }
+}
+
+void KNNModel::predictBatch(const float* rows, size_t count, float* out) const {
+    std::vector<uint32_t> indices;
+    std::vector<float> distances;
+    neighborPositions(rows, count, k, indices, distances);
+    size_t kk = std::min(k, rowCount);
+    for (size_t i = 0; i < count; i++) {
+        vote(indices.data() + i * kk, kk, out + i);
+    }
+}
+
+RecallReport KNNModel::estimateRecall(const float* rows, size_t count, size_t sampleSize) const {
+    RecallReport report;
+    if (count == 0 || sampleSize == 0) {
+        return report;
+    }
+    sampleSize = std::min(sampleSize, count);
+    std::vector<float> sample(sampleSize * featureCount);
+    for (size_t i = 0; i < sampleSize; i++) {
+        const float* source = rows + (i * count / sampleSize) * featureCount;
+        std::copy(source, source + featureCount, sample.begin() + i * featureCount);
+    }
+
+    std::vector<uint32_t> approx, exact;
+    std::vector<float> approxDist, exactDist;
+    auto start = std::chrono::steady_clock::now();
+    kneighbors(sample.data(), sampleSize, k, approx, approxDist);
+    auto middle = std::chrono::steady_clock::now();
+    bruteForceKneighbors(sample.data(), sampleSize, k, exact, exactDist);
+    auto end = std::chrono::steady_clock::now();
+
+    // นับเพื่อนบ้านแท้ที่ถูกพบ โดยยอมรับระยะที่เท่ากับเพื่อนบ้านตัวที่ k (กรณีระยะเสมอกัน)
+    size_t kk = std::min(k, rowCount);
+    size_t hits = 0;
+    for (size_t q = 0; q < sampleSize; q++) {
+        float kth = exactDist[q * kk + kk - 1];
+        for (size_t j = 0; j < kk; j++) {
+            if (approxDist[q * kk + j] <= kth * (1.0f + 1e-5f) + 1e-12f) {
+                hits++;
+            }
+        }
+    }
+    report.sampleSize = sampleSize;
+    report.recall = static_cast<double>(hits) / static_cast<double>(sampleSize * kk);
+    report.approxMicros = std::chrono::duration<double, std::micro>(middle - start).count() / sampleSize;
+    report.exactMicros = std::chrono::duration<double, std::micro>(end - middle).count() / sampleSize;
+    return report;
+}
+
+void KNNModel::reportBatch(const float* rows, size_t count, std::ostream& os) const {
+    if (builtIndex != KNNIndexType::HNSW || recallSample == 0) {
+        return;
+    }
+    RecallReport report = estimateRecall(rows, count, recallSample);
+    if (report.sampleSize == 0) {
+        return;
+    }
+    os << "HNSW recall@" << k << " vs exact search on " << report.sampleSize << " sampled queries: "
+       << report.recall << "\n";
+    os << "Latency per query: HNSW " << report.approxMicros << " us, exact " << report.exactMicros << " us";
+    if (report.approxMicros > 0.0) {
+        os << " (speedup " << report.exactMicros / report.approxMicros << "x)";
+    }
+    os << "\n";
+}
+
+size_t KNNModel::memoryBytes() const {
+    size_t bytes = (points.size() + pointNorms.size() + labels.size() + centers.size()) * sizeof(float) +
+                   originalIndex.size() * sizeof(uint32_t) + nodes.size() * sizeof(Node);
+    if (graph) {
+        bytes += graph->edgeCount() * sizeof(uint32_t) + graph->size() * sizeof(int);
+    }
+    return bytes;
+}
+
+void KNNModel::describe(std::ostream& os) const {
+    os << "KNN index: " << indexName(builtIndex) << " over " << rowCount << " rows x "
+       << featureCount << " features";
+    if (!nodes.empty()) {
+        os << " (" << nodes.size() << " nodes, leaf size " << leafSize << ")";
+    }
+    if (graph) {
+        os << " (M = " << hnswM << ", ef_construction = " << efConstruction << ", ef_search = " << efSearch
+           << ", " << graph->maxLevel() + 1 << " layers, " << graph->edgeCount() << " edges)";
+    }
+    os << "\n";
+    os << "k = " << k << ", metric = " << (metric == DistanceMetric::Cosine ? "cosine" : "euclidean")
+       << ", distance kernels: " << (cpuHasAvx2() ? "AVX2" : "scalar") << "\n";
+}
+
+} // namespace ai_language
@@ -0,0 +1,413 @@
+#include "../../include/ml/LinearModel.h"
+#include "../../include/ml/CodeGen.h"
+#include "../../include/ml/Distance.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace ai_language {
+
+namespace {
+
+// จำนวนรอบติดต่อกันที่ loss ไม่ลดลงก่อนหยุด SGD
+constexpr size_t kPatience = 3;
+
+// ขนาดบัฟเฟอร์ของแถวที่ขยายเป็นพจน์พหุนามแล้วต่อเธรด (ให้อยู่ใน L2)
+constexpr size_t kExpandBlockBytes = 256 * 1024;
+
+// เรียก fn(block, first, n) กับแถว [begin, end) ที่ขยายแล้วทีละก้อน (ไม่คัดลอกเมื่อไม่มีพจน์พหุนาม)
+template <typename Fn>
+void forExpandedBlocks(const PolynomialFeatures& expansion, const float* rows, size_t begin, size_t end,
+                       std::vector<float>& buffer, Fn&& fn) {
+    size_t inputs = expansion.inputDimension();
+    if (expansion.identity()) {
+        fn(rows + begin * inputs, begin, end - begin);
+        return;
+    }
+    size_t block = expansion.rowsPerBlock(kExpandBlockBytes);
+    buffer.resize(std::min(block, end - begin) * expansion.outputDimension());
+    for (size_t first = begin; first < end; first += block) {
+        size_t n = std::min(block, end - first);
+        expansion.expand(rows + first * inputs, n, buffer.data());
+        fn(buffer.data(), first, n);
+    }
+}
+
+} // namespace
+
+LinearModel::LinearModel(const ModelParams& params)
+    : learningRate(params.get("learning_rate", 0.01)),
+      epochs(static_cast<size_t>(std::max(1.0, params.get("epochs", 100)))),
+      batchSize(static_cast<size_t>(std::max(1.0, params.get("batch_size", 32)))),
+      l2(std::max(0.0, params.get("l2", 1e-4))),
+      tol(std::max(0.0, params.get("tol", 1e-3))),
+      seed(static_cast<unsigned>(params.get("random_state", 42))),
+      polynomialDegree(static_cast<size_t>(std::max(1.0, params.get("polynomial_degree", 1)))),
+      interactionOnly(params.get("interaction_only", 0) > 0) {
+    if (learningRate <= 0.0) {
+        throw std::invalid_argument("learning_rate must be positive");
+    }
+}
+
+void LinearModel::initialBias(const Dataset& data, std::vector<float>& bias) const {
+    (void)data;
+    std::fill(bias.begin(), bias.end(), 0.0f);
+}
+
+void LinearModel::fit(const Dataset& data) {
+    if (data.empty()) {
+        throw std::invalid_argument("Dataset is empty");
+    }
+    featureCount = data.cols;
+    expansion = PolynomialFeatures(data.cols, polynomialDegree, interactionOnly);
+    outputs = prepareOutputs(data);
+
+    // ค่าเฉลี่ยและส่วนเบี่ยงเบนมาตรฐานจากข้อมูลชุดแรก (ของคอลัมน์ที่ขยายแล้ว ขยายทีละก้อนต่อเธรด)
+    size_t cols = expansion.outputDimension();
+    size_t chunks = parallelChunks(data.rows, 2048);
+    std::vector<std::vector<double>> partialSum(chunks), partialSquares(chunks);
+    parallelFor(0, data.rows, [&](size_t begin, size_t end, size_t worker) {
+        std::vector<double>& s = partialSum[worker];
+        std::vector<double>& q = partialSquares[worker];
+        s.assign(cols, 0.0);
+        q.assign(cols, 0.0);
+        std::vector<float> buffer;
+        forExpandedBlocks(expansion, data.features.data(), begin, end, buffer, [&](const float* block, size_t, size_t n) {
+            for (size_t i = 0; i < n; i++) {
+                const float* x = block + i * cols;
+                for (size_t j = 0; j < cols; j++) {
+                    s[j] += x[j];
+                    q[j] += static_cast<double>(x[j]) * x[j];
+                }
+            }
+        });
+    }, 2048);
+    std::vector<double> sum(cols, 0.0), sumSquares(cols, 0.0);
+    for (size_t c = 0; c < chunks; c++) {
+        for (size_t j = 0; j < cols && !partialSum[c].empty(); j++) {
+            sum[j] += partialSum[c][j];
+            sumSquares[j] += partialSquares[c][j];
+        }
+    }
+    mean.resize(cols);
+    invStd.resize(cols);
+    for (size_t j = 0; j < cols; j++) {
+        double m = sum[j] / data.rows;
+        double variance = std::max(0.0, sumSquares[j] / data.rows - m * m);
+        mean[j] = static_cast<float>(m);
+        invStd[j] = variance > 1e-12 ? static_cast<float>(1.0 / std::sqrt(variance)) : 1.0f;
+    }
+
+    weights.assign(outputs * cols, 0.0f);
+    bias.assign(outputs, 0.0f);
+    initialBias(data, bias);
+    epochsTotal = 0;
+    rowsSeen = 0;
+    trainingCalls = 0;
+    runSGD(data);
+}
+
+void LinearModel::partialFit(const Dataset& data) {
+    if (outputs == 0) {
+        fit(data);
+        return;
+    }
+    if (data.empty()) {
+        throw std::invalid_argument("Dataset is empty");
+    }
+    if (data.cols != featureCount) {
+        throw std::invalid_argument("Expected " + std::to_string(featureCount) + " features but got " +
+                                    std::to_string(data.cols));
+    }
+    checkIncremental(data);
+    runSGD(data);
+}
+
+void LinearModel::runSGD(const Dataset& data) {
+    size_t rows = data.rows;
+    size_t cols = expansion.outputDimension();
+    // ไม่มีพจน์พหุนาม: standardize ทั้งชุดครั้งเดียว มีพจน์พหุนาม: ขยายและ standardize ทีละแถวใน mini-batch
+    bool lazy = !expansion.identity();
+    std::vector<float> scaled(lazy ? 0 : rows * cols), expanded(lazy ? cols : 0);
+    parallelFor(0, lazy ? 0 : rows, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; i++) {
+            const float* x = data.row(i);
+            float* z = scaled.data() + i * cols;
+            for (size_t j = 0; j < cols; j++) {
+                z[j] = (x[j] - mean[j]) * invStd[j];
+            }
+        }
+    }, 2048);
+
+    std::vector<uint32_t> order(rows);
+    std::iota(order.begin(), order.end(), 0u);
+    std::mt19937 rng(seed + static_cast<unsigned>(trainingCalls));
+    std::vector<float> gradWeights(outputs * cols), gradBias(outputs), scores(outputs), grad(outputs);
+    float decay = static_cast<float>(1.0 - learningRate * l2);
+
+    double best = std::numeric_limits<double>::infinity();
+    size_t stale = 0;
+    epochsLastCall = 0;
+    for (size_t epoch = 0; epoch < epochs && stale < kPatience; epoch++) {
+        std::shuffle(order.begin(), order.end(), rng);
+        double total = 0.0;
+        for (size_t start = 0; start < rows; start += batchSize) {
+            size_t end = std::min(rows, start + batchSize);
+            std::fill(gradWeights.begin(), gradWeights.end(), 0.0f);
+            std::fill(gradBias.begin(), gradBias.end(), 0.0f);
+            for (size_t idx = start; idx < end; idx++) {
+                const float* z = scaled.data() + static_cast<size_t>(order[idx]) * cols;
+                if (lazy) {
+                    expansion.expand(data.row(order[idx]), 1, expanded.data());
+                    for (size_t j = 0; j < cols; j++) {
+                        expanded[j] = (expanded[j] - mean[j]) * invStd[j];
+                    }
+                    z = expanded.data();
+                }
+                for (size_t o = 0; o < outputs; o++) {
+                    scores[o] = bias[o] + dotProduct(weights.data() + o * cols, z, cols);
+                }
+                total += lossGradient(scores.data(), data.targets[order[idx]], grad.data());
+                for (size_t o = 0; o < outputs; o++) {
+                    float g = grad[o];
+                    float* gw = gradWeights.data() + o * cols;
+                    for (size_t j = 0; j < cols; j++) {
+                        gw[j] += g * z[j];
+                    }
+                    gradBias[o] += g;
+                }
+            }
+            float step = static_cast<float>(learningRate / (end - start));
+            for (size_t k = 0; k < weights.size(); k++) {
+                weights[k] = decay * weights[k] - step * gradWeights[k];
+            }
+            for (size_t o = 0; o < outputs; o++) {
+                bias[o] -= step * gradBias[o];
+            }
+        }
+
+        double average = total / rows;
+        if (epoch == 0) {
+            firstLoss = average;
+        }
+        finalLoss = average;
+        epochsLastCall++;
+        if (average > best - tol) {
+            stale++;
+        } else {
+            stale = 0;
+        }
+        best = std::min(best, average);
+    }
+
+    epochsTotal += epochsLastCall;
+    rowsSeen += rows;
+    trainingCalls++;
+    foldWeights();
+}
+
+void LinearModel::foldWeights() {
+    // w' = w / std, b' = b - sum(w' * mean) เพื่อทำนายบนข้อมูลดิบ (หรือแถวที่ขยายแล้ว) ได้โดยตรง
+    size_t cols = expansion.outputDimension();
+    foldedWeights.resize(weights.size());
+    foldedBias = bias;
+    for (size_t o = 0; o < outputs; o++) {
+        double shift = 0.0;
+        for (size_t j = 0; j < cols; j++) {
+            float w = weights[o * cols + j] * invStd[j];
+            foldedWeights[o * cols + j] = w;
+            shift += static_cast<double>(w) * mean[j];
+        }
+        foldedBias[o] = static_cast<float>(bias[o] - shift);
+    }
+}
+
+void LinearModel::decisionFunction(const float* rows, size_t count, float* out) const {
+    if (outputs == 0) {
+        throw std::runtime_error("Linear model has not been trained");
+    }
+    size_t cols = expansion.outputDimension();
+    parallelFor(0, count, [&](size_t begin, size_t end, size_t) {
+        std::vector<float> buffer;
+        forExpandedBlocks(expansion, rows, begin, end, buffer, [&](const float* block, size_t first, size_t n) {
+            dotTile(block, n, foldedWeights.data(), outputs, cols, out + first * outputs, outputs);
+        });
+        for (size_t i = begin; i < end; i++) {
+            for (size_t o = 0; o < outputs; o++) {
+                out[i * outputs + o] += foldedBias[o];
+            }
+        }
+    }, 1024);
+}
+
+void LinearModel::predictBatch(const float* rows, size_t count, float* out) const {
+    std::vector<float> scores(count * outputs);
+    decisionFunction(rows, count, scores.data());
+    for (size_t i = 0; i < count; i++) {
+        out[i] = decide(scores.data() + i * outputs);
+    }
+}
+
+size_t LinearModel::decisionScores(const float* rows, size_t count, std::vector<float>& out) const {
+    out.resize(count * outputs);
+    decisionFunction(rows, count, out.data());
+    if (outputs > 1) {
+        logSoftmaxRows(out.data(), count, outputs);
+    }
+    return outputs;
+}
+
+bool LinearModel::emitSource(SourceWriter& out) const {
+    if (outputs == 0) {
+        return false;
+    }
+    // น้ำหนักที่รวมการ standardize แล้ว จึงรับข้อมูลดิบได้ตรงๆ
+    size_t cols = expansion.outputDimension();
+    out.floatArray("kWeights", foldedWeights);
+    out.floatArray("kBias", foldedBias);
+    out.line() << "\n";
+    out.line() << "static float model(const float* x) {\n";
+    out.indent();
+    out.line() << "float s[" << outputs << "];\n";
+    out.line() << "for (std::size_t o = 0; o < " << outputs << "; o++) {\n";
+    out.indent();
+    out.line() << "const float* w = kWeights + o * " << cols << ";\n";
+    out.line() << "float sum = 0.0f;\n";
+    if (expansion.identity()) {
+        out.line() << "for (std::size_t j = 0; j < " << featureCount << "; j++) {\n";
+        out.line() << "    sum += w[j] * x[j];\n";
+        out.line() << "}\n";
+    } else {
+        // พจน์พหุนามเรียงตามดัชนี a <= b <= ... เหมือน PolynomialFeatures จึงไล่ w ต่อกันได้โดยไม่ต้องเก็บแถวที่ขยาย
+        out.line() << "std::size_t p = 0;\n";
+        for (size_t t = 1; t <= expansion.degree(); t++) {
+            std::string product;
+            for (size_t level = 0; level < t; level++) {
+                std::string var = "i" + std::to_string(level);
+                std::string from = level == 0 ? "0" : "i" + std::to_string(level - 1) +
+                                                      (expansion.interactionOnly() ? " + 1" : "");
+                out.line() << "for (std::size_t " << var << " = " << from << "; " << var << " < " << featureCount
+                           << "; " << var << "++) {\n";
+                out.indent();
+                product += (level == 0 ? "x[" : " * x[") + var + "]";
+            }
+            out.line() << "sum += w[p++] * (" << product << ");\n";
+            for (size_t level = 0; level < t; level++) {
+                out.dedent();
+                out.line() << "}\n";
+            }
+        }
+    }
+    out.line() << "s[o] = sum + kBias[o];\n";
+    out.dedent();
+    out.line() << "}\n";
+    emitDecision(out);
+    out.dedent();
+    out.line() << "}\n";
+    return true;
+}
+
+size_t LinearModel::memoryBytes() const {
+    // weights/bias บนข้อมูลที่ standardize แล้วเก็บไว้สำหรับ partialFit
+    return (mean.size() + invStd.size() + weights.size() + bias.size() + foldedWeights.size() + foldedBias.size()) *
+           sizeof(float);
+}
+
+void LinearModel::describe(std::ostream& os) const {
+    os << typeName() << " (" << objectiveName() << ", SGD learning rate " << learningRate
+       << ", batch " << batchSize << "): " << featureCount << " features";
+    if (!expansion.identity()) {
+        os << " -> " << expansion.outputDimension() << " polynomial terms (degree " << expansion.degree()
+           << (expansion.interactionOnly() ? ", interaction only" : "") << ", expanded per row block)";
+    }
+    os << "\n";
+    os << "Last training call: " << epochsLastCall << " epochs"
+       << (epochsLastCall < epochs ? " (converged)" : " (epoch limit)") << ", loss " << firstLoss << " -> "
+       << finalLoss << "\n";
+    if (trainingCalls > 1) {
+        os << rowsSeen << " rows seen across " << trainingCalls << " training calls, "
+           << epochsTotal << " epochs total\n";
+    }
+}
+
+void LinearRegressionModel::emitDecision(SourceWriter& out) const {
+    out.line() << "return s[0];\n";
+}
+
+size_t LinearRegressionModel::prepareOutputs(const Dataset& data) {
+    (void)data;
+    return 1;
+}
+
+void LinearRegressionModel::initialBias(const Dataset& data, std::vector<float>& bias) const {
+    double sum = std::accumulate(data.targets.begin(), data.targets.end(), 0.0);
+    bias[0] = static_cast<float>(sum / data.rows);
+}
+
+double LinearRegressionModel::lossGradient(const float* scores, float target, float* grad) const {
+    float diff = scores[0] - target;
+    grad[0] = diff;
+    return 0.5 * diff * diff;
+}
+
+size_t LogisticRegressionModel::prepareOutputs(const Dataset& data) {
+    if (!data.isClassification()) {
+        throw std::invalid_argument("LogisticRegression needs a classification target");
+    }
+    classes = data.numClasses();
+    if (classes < 2) {
+        throw std::invalid_argument("LogisticRegression needs at least two classes");
+    }
+    return classes == 2 ? 1 : classes;
+}
+
+void LogisticRegressionModel::checkIncremental(const Dataset& data) const {
+    if (!data.isClassification() || data.numClasses() > classes) {
+        throw std::invalid_argument("New rows contain classes the model was not trained on; a full fit is required");
+    }
+}
+
+double LogisticRegressionModel::lossGradient(const float* scores, float target, float* grad) const {
+    if (classes == 2) {
+        // log(1 + e^s) - y s แบบไม่ล้นค่า
+        double s = scores[0];
+        grad[0] = static_cast<float>(1.0 / (1.0 + std::exp(-s)) - target);
+        return std::max(s, 0.0) + std::log1p(std::exp(-std::fabs(s))) - target * s;
+    }
+    size_t label = static_cast<size_t>(target);
+    float top = *std::max_element(scores, scores + classes);
+    double sum = 0.0;
+    for (size_t k = 0; k < classes; k++) {
+        grad[k] = std::exp(scores[k] - top);
+        sum += grad[k];
+    }
+    for (size_t k = 0; k < classes; k++) {
+        grad[k] = static_cast<float>(grad[k] / sum) - (k == label ? 1.0f : 0.0f);
+    }
+    return std::log(sum) + top - scores[label];
+}
+
+float LogisticRegressionModel::decide(const float* scores) const {
+    if (classes == 2) {
+        return scores[0] > 0.0f ? 1.0f : 0.0f;
+    }
+    return static_cast<float>(std::max_element(scores, scores + classes) - scores);
+}
+
+void LogisticRegressionModel::emitDecision(SourceWriter& out) const {
+    if (classes == 2) {
+        out.line() << "return s[0] > 0.0f ? 1.0f : 0.0f;\n";
+    } else {
+        out.returnArgmax("s", classes);
+    }
+}
+
+std::string LogisticRegressionModel::objectiveName() const {
+    return classes == 2 ? "logistic" : "softmax, " + std::to_string(classes) + " classes";
+}
+
+} // namespace ai_language
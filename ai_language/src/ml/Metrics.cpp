@@ -0,0 +1,458 @@
+#include "../../include/ml/Metrics.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+
+namespace ai_language {
+
+namespace {
+
+constexpr size_t kMetricChunk = 16384;
+constexpr size_t kSortChunk = 65536;
+
+// ผลรวมย่อยของแต่ละเธรดสำหรับงานจำแนกประเภท
+struct ClassPartial {
+    uint64_t correct = 0;
+    std::vector<uint64_t> truePositives;
+    std::vector<uint64_t> actual;
+    std::vector<uint64_t> predicted;
+    std::vector<uint64_t> mismatches;  ///< truth * classes + predicted ของแถวที่ทำนายผิด
+};
+
+struct RegressionPartial {
+    double squaredError = 0.0;
+    double absoluteError = 0.0;
+    double sum = 0.0;         ///< ผลรวมของ (y - shift)
+    double sumSquares = 0.0;  ///< ผลรวมของ (y - shift)²
+};
+
+// แปลง float เป็น uint32 ที่เรียงลำดับเหมือนค่าเดิม (-0 กับ +0 ได้คีย์เดียวกัน)
+inline uint32_t orderedBits(float value) {
+    if (value == 0.0f) {
+        value = 0.0f;
+    }
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+inline size_t labelIndex(float value, size_t classes) {
+    if (!(value >= 0.0f) || value >= static_cast<float>(classes)) {
+        throw std::invalid_argument("Label " + std::to_string(value) + " is outside [0, " +
+                                    std::to_string(classes) + ")");
+    }
+    return static_cast<size_t>(value);
+}
+
+void evaluateClassification(MetricsReport& report, const float* truth, const float* predicted,
+                            size_t count, size_t classes) {
+    size_t chunks = parallelChunks(count, kMetricChunk);
+    std::vector<ClassPartial> partials(chunks);
+    size_t step = (count + chunks - 1) / chunks;
+    parallelFor(0, chunks, [&](size_t begin, size_t end, size_t) {
+        for (size_t c = begin; c < end; c++) {
+            ClassPartial& part = partials[c];
+            part.truePositives.assign(classes, 0);
+            part.actual.assign(classes, 0);
+            part.predicted.assign(classes, 0);
+            size_t last = std::min(count, (c + 1) * step);
+            for (size_t i = c * step; i < last; i++) {
+                size_t t = labelIndex(truth[i], classes);
+                size_t p = labelIndex(predicted[i], classes);
+                part.actual[t]++;
+                part.predicted[p]++;
+                if (t == p) {
+                    part.correct++;
+                    part.truePositives[t]++;
+                } else {
+                    part.mismatches.push_back(static_cast<uint64_t>(t) * classes + p);
+                }
+            }
+        }
+    }, 1);
+
+    ConfusionMatrix& matrix = report.confusion;
+    matrix.classes = classes;
+    matrix.truePositives.assign(classes, 0);
+    matrix.actualCounts.assign(classes, 0);
+    matrix.predictedCounts.assign(classes, 0);
+    uint64_t correct = 0;
+    std::vector<uint64_t> mismatches;
+    for (auto& part : partials) {
+        correct += part.correct;
+        for (size_t k = 0; k < classes; k++) {
+            matrix.truePositives[k] += part.truePositives[k];
+            matrix.actualCounts[k] += part.actual[k];
+            matrix.predictedCounts[k] += part.predicted[k];
+        }
+        mismatches.insert(mismatches.end(), part.mismatches.begin(), part.mismatches.end());
+    }
+    report.accuracy = static_cast<double>(correct) / count;
+
+    // ช่องแนวทแยงมาจาก truePositives ช่องอื่นมาจากแถวที่ทำนายผิด
+    std::vector<std::pair<uint64_t, uint64_t>> cells;
+    for (size_t k = 0; k < classes; k++) {
+        if (matrix.truePositives[k] > 0) {
+            cells.emplace_back(static_cast<uint64_t>(k) * classes + k, matrix.truePositives[k]);
+        }
+    }
+    std::sort(mismatches.begin(), mismatches.end());
+    for (size_t i = 0; i < mismatches.size();) {
+        size_t j = i;
+        while (j < mismatches.size() && mismatches[j] == mismatches[i]) {
+            j++;
+        }
+        cells.emplace_back(mismatches[i], j - i);
+        i = j;
+    }
+    std::sort(cells.begin(), cells.end());
+    matrix.setCells(cells);
+
+    auto ratio = [](uint64_t a, uint64_t b) { return b == 0 ? 0.0 : static_cast<double>(a) / b; };
+    if (classes == 2) {
+        report.precision = ratio(matrix.truePositives[1], matrix.predictedCounts[1]);
+        report.recall = ratio(matrix.truePositives[1], matrix.actualCounts[1]);
+        double sum = report.precision + report.recall;
+        report.f1 = sum > 0.0 ? 2.0 * report.precision * report.recall / sum : 0.0;
+        return;
+    }
+    double precision = 0.0, recall = 0.0, f1 = 0.0;
+    size_t present = 0;
+    for (size_t k = 0; k < classes; k++) {
+        if (matrix.actualCounts[k] == 0 && matrix.predictedCounts[k] == 0) {
+            continue;
+        }
+        double p = ratio(matrix.truePositives[k], matrix.predictedCounts[k]);
+        double r = ratio(matrix.truePositives[k], matrix.actualCounts[k]);
+        precision += p;
+        recall += r;
+        f1 += p + r > 0.0 ? 2.0 * p * r / (p + r) : 0.0;
+        present++;
+    }
+    if (present > 0) {
+        report.precision = precision / present;
+        report.recall = recall / present;
+        report.f1 = f1 / present;
+    }
+}
+
+void evaluateRegression(MetricsReport& report, const float* truth, const float* predicted, size_t count) {
+    size_t chunks = parallelChunks(count, kMetricChunk);
+    std::vector<RegressionPartial> partials(chunks);
+    size_t step = (count + chunks - 1) / chunks;
+    // เลื่อนค่าด้วย y[0] ก่อนสะสมผลรวมกำลังสองเพื่อลดการสูญเสียความแม่นยำ
+    double shift = truth[0];
+    parallelFor(0, chunks, [&](size_t begin, size_t end, size_t) {
+        for (size_t c = begin; c < end; c++) {
+            RegressionPartial& part = partials[c];
+            size_t last = std::min(count, (c + 1) * step);
+            for (size_t i = c * step; i < last; i++) {
+                double error = static_cast<double>(predicted[i]) - truth[i];
+                double centered = truth[i] - shift;
+                part.squaredError += error * error;
+                part.absoluteError += std::fabs(error);
+                part.sum += centered;
+                part.sumSquares += centered * centered;
+            }
+        }
+    }, 1);
+
+    RegressionPartial total;
+    for (const auto& part : partials) {
+        total.squaredError += part.squaredError;
+        total.absoluteError += part.absoluteError;
+        total.sum += part.sum;
+        total.sumSquares += part.sumSquares;
+    }
+    report.mse = total.squaredError / count;
+    report.mae = total.absoluteError / count;
+    double totalVariance = total.sumSquares - total.sum * total.sum / count;
+    if (totalVariance > 0.0) {
+        report.r2 = 1.0 - total.squaredError / totalVariance;
+    } else {
+        report.r2 = total.squaredError == 0.0 ? 1.0 : 0.0;
+    }
+}
+
+} // namespace
+
+uint64_t ConfusionMatrix::at(size_t truth, size_t predicted) const {
+    if (truth >= classes || predicted >= classes) {
+        return 0;
+    }
+    uint64_t key = static_cast<uint64_t>(truth) * classes + predicted;
+    if (isDense()) {
+        return dense[key];
+    }
+    auto it = std::lower_bound(sparse.begin(), sparse.end(), std::make_pair(key, uint64_t(0)));
+    return it != sparse.end() && it->first == key ? it->second : 0;
+}
+
+std::vector<std::pair<uint64_t, uint64_t>> ConfusionMatrix::nonZero() const {
+    if (!isDense()) {
+        return sparse;
+    }
+    std::vector<std::pair<uint64_t, uint64_t>> cells;
+    for (size_t key = 0; key < dense.size(); key++) {
+        if (dense[key] > 0) {
+            cells.emplace_back(key, dense[key]);
+        }
+    }
+    return cells;
+}
+
+void ConfusionMatrix::setCells(const std::vector<std::pair<uint64_t, uint64_t>>& cells) {
+    if (isDense()) {
+        dense.assign(classes * classes, 0);
+        for (const auto& cell : cells) {
+            dense[cell.first] = cell.second;
+        }
+        sparse.clear();
+    } else {
+        dense.clear();
+        sparse = cells;
+    }
+}
+
+MetricsReport::MetricsReport()
+    : rocAuc(std::numeric_limits<double>::quiet_NaN()), prAuc(std::numeric_limits<double>::quiet_NaN()) {
+}
+
+std::vector<std::pair<std::string, double>> MetricsReport::values() const {
+    std::vector<std::pair<std::string, double>> result;
+    if (classification) {
+        result = {{"accuracy", accuracy}, {"precision", precision}, {"recall", recall}, {"f1_score", f1}};
+        if (!std::isnan(rocAuc)) {
+            result.emplace_back("roc_auc", rocAuc);
+        }
+        if (!std::isnan(prAuc)) {
+            result.emplace_back("pr_auc", prAuc);
+        }
+    } else {
+        result = {{"mse", mse}, {"rmse", std::sqrt(mse)}, {"mae", mae}, {"r2", r2}};
+    }
+    return result;
+}
+
+void MetricsReport::print(std::ostream& os, const std::vector<std::string>& classNames,
+                          size_t maxMatrixClasses) const {
+    static const std::vector<std::pair<std::string, std::string>> labels = {
+        {"accuracy", "Accuracy"}, {"precision", "Precision"}, {"recall", "Recall"}, {"f1_score", "F1 Score"},
+        {"roc_auc", "ROC-AUC"}, {"pr_auc", "PR-AUC"}, {"mse", "Mean Squared Error (MSE)"}, {"rmse", "RMSE"},
+        {"mae", "Mean Absolute Error (MAE)"}, {"r2", "R-squared"}};
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precisionBefore = os.precision();
+    os << std::fixed << std::setprecision(4);
+    for (const auto& value : values()) {
+        std::string label = value.first;
+        for (const auto& entry : labels) {
+            if (entry.first == value.first) {
+                label = entry.second;
+            }
+        }
+        os << "  - " << label << ": " << value.second << "\n";
+    }
+    os.flags(flags);
+    os.precision(precisionBefore);
+    if (!classification) {
+        return;
+    }
+
+    size_t classes = confusion.classes;
+    auto name = [&](size_t k) { return k < classNames.size() ? classNames[k] : std::to_string(k); };
+    if (classes > maxMatrixClasses) {
+        os << "  Confusion matrix: " << classes << " classes, " << confusion.nonZero().size()
+           << " non-zero cells (export results json to see all cells)\n";
+        return;
+    }
+    size_t width = 6;
+    for (size_t k = 0; k < classes; k++) {
+        width = std::max(width, name(k).size() + 1);
+        width = std::max(width, std::to_string(confusion.actualCounts[k]).size() + 1);
+    }
+    os << "  Confusion matrix (rows = actual, columns = predicted):\n  " << std::setw(width) << "";
+    for (size_t k = 0; k < classes; k++) {
+        os << std::setw(width) << name(k);
+    }
+    os << "\n";
+    for (size_t t = 0; t < classes; t++) {
+        os << "  " << std::setw(width) << name(t);
+        for (size_t p = 0; p < classes; p++) {
+            os << std::setw(width) << confusion.at(t, p);
+        }
+        os << "\n";
+    }
+}
+
+MetricsReport MetricsEngine::evaluate(const float* truth, const float* predicted, size_t count,
+                                      bool classification, size_t classes) {
+    if (count == 0) {
+        throw std::invalid_argument("No rows to evaluate");
+    }
+    MetricsReport report;
+    report.classification = classification;
+    report.count = count;
+    if (classification) {
+        evaluateClassification(report, truth, predicted, count, std::max<size_t>(classes, 1));
+    } else {
+        evaluateRegression(report, truth, predicted, count);
+    }
+    return report;
+}
+
+void MetricsEngine::sortByScoreDescending(const float* scores, size_t stride, size_t count,
+                                          std::vector<uint32_t>& order) {
+    // คีย์ 64 บิต: 32 บิตบนเป็นคะแนน (กลับด้านเพื่อเรียงมากไปน้อย) 32 บิตล่างเป็นดัชนีแถว
+    std::vector<uint64_t> keys(count), buffer(count);
+    parallelFor(0, count, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; i++) {
+            keys[i] = (static_cast<uint64_t>(~orderedBits(scores[i * stride])) << 32) | i;
+        }
+    }, kSortChunk);
+
+    size_t chunks = parallelChunks(count, kSortChunk);
+    size_t step = (count + chunks - 1) / chunks;
+    std::vector<size_t> offsets(chunks * 256);
+    for (unsigned shift = 32; shift < 64; shift += 8) {
+        std::fill(offsets.begin(), offsets.end(), 0);
+        parallelFor(0, chunks, [&](size_t begin, size_t end, size_t) {
+            for (size_t c = begin; c < end; c++) {
+                size_t* histogram = offsets.data() + c * 256;
+                size_t last = std::min(count, (c + 1) * step);
+                for (size_t i = c * step; i < last; i++) {
+                    histogram[(keys[i] >> shift) & 0xFF]++;
+                }
+            }
+        }, 1);
+
+        // ข้ามรอบที่ทุกคีย์มีหลักเดียวกัน (พบบ่อยเมื่อคะแนนอยู่ในช่วงแคบ)
+        bool trivial = false;
+        size_t running = 0;
+        for (size_t digit = 0; digit < 256; digit++) {
+            size_t digitTotal = 0;
+            for (size_t c = 0; c < chunks; c++) {
+                size_t n = offsets[c * 256 + digit];
+                offsets[c * 256 + digit] = running;
+                running += n;
+                digitTotal += n;
+            }
+            trivial = trivial || digitTotal == count;
+        }
+        if (trivial) {
+            continue;
+        }
+
+        parallelFor(0, chunks, [&](size_t begin, size_t end, size_t) {
+            for (size_t c = begin; c < end; c++) {
+                size_t* position = offsets.data() + c * 256;
+                size_t last = std::min(count, (c + 1) * step);
+                for (size_t i = c * step; i < last; i++) {
+                    buffer[position[(keys[i] >> shift) & 0xFF]++] = keys[i];
+                }
+            }
+        }, 1);
+        keys.swap(buffer);
+    }
+
+    order.resize(count);
+    parallelFor(0, count, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; i++) {
+            order[i] = static_cast<uint32_t>(keys[i]);
+        }
+    }, kSortChunk);
+}
+
+bool MetricsEngine::rankingScores(const float* scores, size_t stride, const uint8_t* positive, size_t count,
+                                  double& rocAuc, double& averagePrecision) {
+    // NaN ไม่เท่ากับตัวเองจึงจัดกลุ่มคะแนนเท่ากันไม่ได้ และไม่มีลำดับให้จัดอันดับ (เช่นโมเดลที่ลู่ออก)
+    size_t positives = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (std::isnan(scores[i * stride])) {
+            return false;
+        }
+        positives += positive[i];
+    }
+    size_t negatives = count - positives;
+    if (positives == 0 || negatives == 0) {
+        return false;
+    }
+
+    std::vector<uint32_t> order;
+    sortByScoreDescending(scores, stride, count, order);
+
+    // เดินจากคะแนนสูงไปต่ำทีละกลุ่มคะแนนเท่ากัน: พื้นที่ใต้ ROC แบบสี่เหลี่ยมคางหมู และ AP แบบขั้นบันได
+    double area = 0.0, precisionSum = 0.0;
+    size_t tp = 0, fp = 0;
+    for (size_t i = 0; i < count;) {
+        float score = scores[static_cast<size_t>(order[i]) * stride];
+        size_t groupTp = 0, groupFp = 0;
+        while (i < count && scores[static_cast<size_t>(order[i]) * stride] == score) {
+            if (positive[order[i]]) {
+                groupTp++;
+            } else {
+                groupFp++;
+            }
+            i++;
+        }
+        area += groupFp * (tp + 0.5 * groupTp);
+        tp += groupTp;
+        fp += groupFp;
+        if (groupTp > 0) {
+            precisionSum += groupTp * (static_cast<double>(tp) / (tp + fp));
+        }
+    }
+    rocAuc = area / (static_cast<double>(positives) * negatives);
+    averagePrecision = precisionSum / positives;
+    return true;
+}
+
+void MetricsEngine::addRankingMetrics(MetricsReport& report, const float* truth, const float* scores,
+                                      size_t count, size_t width) {
+    if (!report.classification || width == 0 || count == 0) {
+        return;
+    }
+    std::vector<uint8_t> positive(count);
+    double roc = 0.0, ap = 0.0;
+    if (width <= 2) {
+        std::vector<float> margin;
+        const float* binaryScores = scores;
+        if (width == 2) {
+            margin.resize(count);
+            for (size_t i = 0; i < count; i++) {
+                margin[i] = scores[i * 2 + 1] - scores[i * 2];
+            }
+            binaryScores = margin.data();
+        }
+        for (size_t i = 0; i < count; i++) {
+            positive[i] = truth[i] == 1.0f;
+        }
+        if (rankingScores(binaryScores, 1, positive.data(), count, roc, ap)) {
+            report.rocAuc = roc;
+            report.prAuc = ap;
+        }
+        return;
+    }
+
+    double rocSum = 0.0, apSum = 0.0;
+    size_t used = 0;
+    for (size_t k = 0; k < width; k++) {
+        for (size_t i = 0; i < count; i++) {
+            positive[i] = truth[i] == static_cast<float>(k);
+        }
+        if (rankingScores(scores + k, width, positive.data(), count, roc, ap)) {
+            rocSum += roc;
+            apSum += ap;
+            used++;
+        }
+    }
+    if (used > 0) {
+        report.rocAuc = rocSum / used;
+        report.prAuc = apSum / used;
+    }
+}
+
+} // namespace ai_language
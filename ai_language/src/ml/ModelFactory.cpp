@@ -0,0 +1,57 @@
+#include "../../include/ml/ModelFactory.h"
+#include "../../include/ml/KNN.h"
+#include "../../include/ml/LinearModel.h"
+#include "../../include/ml/NaiveBayes.h"
+#include "../../include/ml/SVM.h"
+#include "../../include/ml/TreeEnsemble.h"
+#include "../../include/ml/RandomForest.h"
+#include "../../include/ml/GradientBoosting.h"
+#include "../../include/ml/KMeans.h"
+#include "../../include/ml/Ensemble.h"
+
+namespace ai_language {
+
+std::unique_ptr<MLModel> ModelFactory::createModel(const std::string& type, const ModelParams& params) {
+    if (type == "LinearRegression") {
+        return std::make_unique<LinearRegressionModel>(params);
+    }
+    if (type == "LogisticRegression") {
+        return std::make_unique<LogisticRegressionModel>(params);
+    }
+    if (type == "KNN") {
+        return std::make_unique<KNNModel>(params);
+    }
+    if (type == "NaiveBayes") {
+        return std::make_unique<NaiveBayesModel>(params);
+    }
+    if (type == "SVM") {
+        return std::make_unique<SVMModel>(params);
+    }
+    if (type == "DecisionTree") {
+        return std::make_unique<DecisionTreeModel>(params);
+    }
+    if (type == "RandomForest") {
+        return std::make_unique<RandomForestModel>(params);
+    }
+    if (type == "GradientBoosting") {
+        return std::make_unique<GradientBoostingModel>(params);
+    }
+    if (type == "KMeans") {
+        return std::make_unique<KMeansModel>(params);
+    }
+    if (type == "Voting") {
+        return std::make_unique<VotingModel>(params);
+    }
+    if (type == "Stacking") {
+        return std::make_unique<StackingModel>(params);
+    }
+    return nullptr;
+}
+
+bool ModelFactory::isNativeModel(const std::string& type) {
+    return type == "LinearRegression" || type == "LogisticRegression" || type == "KNN" || type == "NaiveBayes" || type == "SVM" ||
+           type == "DecisionTree" || type == "RandomForest" || type == "GradientBoosting" ||
+           type == "KMeans" || type == "Voting" || type == "Stacking";
+}
+
+} // namespace ai_language
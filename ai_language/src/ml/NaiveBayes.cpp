@@ -0,0 +1,330 @@
+#include "../../include/ml/NaiveBayes.h"
+#include "../../include/ml/CodeGen.h"
+#include "../../include/ml/Distance.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace ai_language {
+
+namespace {
+
+constexpr size_t kAccumulateChunk = 4096;
+constexpr size_t kPredictBlock = 64;
+constexpr double kLogTwoPi = 1.8378770664093453;
+constexpr double kMinVariance = 1e-12;
+constexpr float kLogZero = -1e30f;  // แทน log(0) โดยไม่ให้ 0 * -inf กลายเป็น NaN
+
+} // namespace
+
+void NaiveBayesStats::resize(size_t numClasses, size_t numCols, bool withSquares) {
+    if (numCols != cols && classes > 0) {
+        throw std::invalid_argument("NaiveBayes statistics were collected on " + std::to_string(cols) +
+                                    " features, got " + std::to_string(numCols));
+    }
+    cols = numCols;
+    if (numClasses > classes) {
+        classes = numClasses;
+        counts.resize(classes, 0.0);
+        sums.resize(classes * cols, 0.0);
+        if (withSquares) {
+            sumSquares.resize(classes * cols, 0.0);
+        }
+    }
+}
+
+void NaiveBayesStats::accumulate(const Dataset& data, size_t begin, size_t end) {
+    bool squares = !sumSquares.empty();
+    for (size_t i = begin; i < end; i++) {
+        size_t label = static_cast<size_t>(data.targets[i]);
+        const float* row = data.row(i);
+        double* sum = sums.data() + label * cols;
+        counts[label] += 1.0;
+        if (squares) {
+            double* square = sumSquares.data() + label * cols;
+            for (size_t j = 0; j < cols; j++) {
+                double x = row[j];
+                sum[j] += x;
+                square[j] += x * x;
+            }
+        } else {
+            for (size_t j = 0; j < cols; j++) {
+                sum[j] += row[j];
+            }
+        }
+    }
+}
+
+void NaiveBayesStats::merge(const NaiveBayesStats& other) {
+    resize(other.classes, other.cols, !other.sumSquares.empty());
+    for (size_t c = 0; c < other.classes; c++) {
+        counts[c] += other.counts[c];
+    }
+    for (size_t i = 0; i < other.sums.size(); i++) {
+        sums[i] += other.sums[i];
+    }
+    for (size_t i = 0; i < other.sumSquares.size(); i++) {
+        sumSquares[i] += other.sumSquares[i];
+    }
+}
+
+double NaiveBayesStats::total() const {
+    double result = 0.0;
+    for (double count : counts) {
+        result += count;
+    }
+    return result;
+}
+
+NaiveBayesModel::NaiveBayesModel(const ModelParams& params)
+    : kind(NaiveBayesVariant::Gaussian),
+      varSmoothing(std::max(0.0, params.get("var_smoothing", 1e-9))),
+      alpha(std::max(0.0, params.get("alpha", 1.0))) {
+    std::string name = params.getString("variant", "gaussian");
+    if (name == "multinomial") {
+        kind = NaiveBayesVariant::Multinomial;
+    } else if (name != "gaussian") {
+        throw std::invalid_argument("Unknown NaiveBayes variant '" + name + "' (use gaussian or multinomial)");
+    }
+}
+
+void NaiveBayesModel::fit(const Dataset& data) {
+    stats = NaiveBayesStats();
+    updates = 0;
+    featureCount = 0;
+    partialFit(data);
+}
+
+void NaiveBayesModel::partialFit(const Dataset& data) {
+    if (!data.isClassification()) {
+        throw std::invalid_argument("NaiveBayes needs a classification target");
+    }
+    if (data.empty()) {
+        throw std::invalid_argument("Dataset is empty");
+    }
+    for (float t : data.targets) {
+        if (t < 0.0f || t != std::floor(t)) {
+            throw std::invalid_argument("NaiveBayes class labels must be non-negative integers");
+        }
+    }
+    if (kind == NaiveBayesVariant::Multinomial) {
+        for (float x : data.features) {
+            if (x < 0.0f) {
+                throw std::invalid_argument("Multinomial NaiveBayes needs non-negative feature counts");
+            }
+        }
+    }
+
+    bool gaussian = kind == NaiveBayesVariant::Gaussian;
+    size_t classes = std::max(stats.classes, data.numClasses());
+    stats.resize(classes, data.cols, gaussian);
+
+    // แต่ละเธรดสะสมสถิติของตัวเอง แล้วรวมกันตอนท้าย
+    std::vector<NaiveBayesStats> local(parallelChunks(data.rows, kAccumulateChunk));
+    for (auto& part : local) {
+        part.resize(classes, data.cols, gaussian);
+    }
+    parallelFor(0, data.rows, [&](size_t begin, size_t end, size_t worker) {
+        local[worker].accumulate(data, begin, end);
+    }, kAccumulateChunk);
+    for (const auto& part : local) {
+        stats.merge(part);
+    }
+
+    featureCount = data.cols;
+    updates++;
+    updateCoefficients();
+}
+
+size_t NaiveBayesModel::expandedWidth() const {
+    return kind == NaiveBayesVariant::Gaussian ? 2 * featureCount : featureCount;
+}
+
+void NaiveBayesModel::updateCoefficients() {
+    size_t classes = stats.classes;
+    size_t cols = stats.cols;
+    size_t width = expandedWidth();
+    double total = stats.total();
+    const float negInf = -std::numeric_limits<float>::infinity();
+    weights.assign(classes * width, 0.0f);
+    bias.assign(classes, negInf);
+
+    if (kind == NaiveBayesVariant::Multinomial) {
+        for (size_t c = 0; c < classes; c++) {
+            if (stats.counts[c] <= 0.0) {
+                continue;
+            }
+            const double* sum = stats.sums.data() + c * cols;
+            double classTotal = 0.0;
+            for (size_t j = 0; j < cols; j++) {
+                classTotal += sum[j];
+            }
+            double denom = classTotal + alpha * cols;
+            for (size_t j = 0; j < cols; j++) {
+                double numer = sum[j] + alpha;
+                weights[c * width + j] = numer > 0.0 && denom > 0.0
+                                             ? static_cast<float>(std::log(numer / denom))
+                                             : kLogZero;
+            }
+            bias[c] = static_cast<float>(std::log(stats.counts[c] / total));
+        }
+        return;
+    }
+
+    // จุดศูนย์กลางรวมของทุกคลาส ลดขนาดของ x² ก่อนคำนวณด้วย float
+    center.assign(cols, 0.0f);
+    double maxVariance = 0.0;
+    for (size_t j = 0; j < cols; j++) {
+        double sum = 0.0, square = 0.0;
+        for (size_t c = 0; c < classes; c++) {
+            sum += stats.sums[c * cols + j];
+            square += stats.sumSquares[c * cols + j];
+        }
+        double mean = sum / total;
+        center[j] = static_cast<float>(mean);
+        maxVariance = std::max(maxVariance, square / total - mean * mean);
+    }
+    double epsilon = varSmoothing * maxVariance;
+
+    for (size_t c = 0; c < classes; c++) {
+        double n = stats.counts[c];
+        if (n <= 0.0) {
+            continue;
+        }
+        const double* sum = stats.sums.data() + c * cols;
+        const double* square = stats.sumSquares.data() + c * cols;
+        float* w = weights.data() + c * width;
+        double constant = std::log(n / total);
+        for (size_t j = 0; j < cols; j++) {
+            double mean = sum[j] / n;
+            // กันความแปรปรวนเป็นศูนย์เมื่อ feature คงที่ทั้งชุดข้อมูล (epsilon จะเป็นศูนย์ด้วย)
+            double variance = std::max(kMinVariance, std::max(0.0, square[j] / n - mean * mean) + epsilon);
+            double shifted = mean - center[j];
+            w[j] = static_cast<float>(-0.5 / variance);
+            w[cols + j] = static_cast<float>(shifted / variance);
+            constant -= 0.5 * (kLogTwoPi + std::log(variance)) + shifted * shifted / (2.0 * variance);
+        }
+        bias[c] = static_cast<float>(constant);
+    }
+}
+
+void NaiveBayesModel::expandRows(const float* rows, size_t count, float* out) const {
+    size_t cols = featureCount;
+    if (kind == NaiveBayesVariant::Multinomial) {
+        std::copy(rows, rows + count * cols, out);
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        const float* row = rows + i * cols;
+        float* expanded = out + i * 2 * cols;
+        for (size_t j = 0; j < cols; j++) {
+            float x = row[j] - center[j];
+            expanded[j] = x * x;
+            expanded[cols + j] = x;
+        }
+    }
+}
+
+void NaiveBayesModel::jointLogLikelihood(const float* rows, size_t count, float* out) const {
+    if (stats.classes == 0) {
+        throw std::runtime_error("NaiveBayes model has not been trained");
+    }
+    size_t classes = stats.classes;
+    size_t width = expandedWidth();
+    parallelFor(0, (count + kPredictBlock - 1) / kPredictBlock, [&](size_t begin, size_t end, size_t) {
+        std::vector<float> expanded(kPredictBlock * width);
+        for (size_t block = begin; block < end; block++) {
+            size_t first = block * kPredictBlock;
+            size_t m = std::min(kPredictBlock, count - first);
+            expandRows(rows + first * featureCount, m, expanded.data());
+            float* scores = out + first * classes;
+            dotTile(expanded.data(), m, weights.data(), classes, width, scores, classes);
+            for (size_t i = 0; i < m; i++) {
+                for (size_t c = 0; c < classes; c++) {
+                    scores[i * classes + c] += bias[c];
+                }
+            }
+        }
+    }, 4);
+}
+
+void NaiveBayesModel::predictBatch(const float* rows, size_t count, float* out) const {
+    size_t classes = stats.classes;
+    std::vector<float> scores(count * classes);
+    jointLogLikelihood(rows, count, scores.data());
+    for (size_t i = 0; i < count; i++) {
+        const float* row = scores.data() + i * classes;
+        out[i] = static_cast<float>(std::max_element(row, row + classes) - row);
+    }
+}
+
+size_t NaiveBayesModel::decisionScores(const float* rows, size_t count, std::vector<float>& out) const {
+    out.resize(count * stats.classes);
+    jointLogLikelihood(rows, count, out.data());
+    logSoftmaxRows(out.data(), count, stats.classes);
+    return stats.classes;
+}
+
+bool NaiveBayesModel::emitSource(SourceWriter& out) const {
+    if (stats.classes == 0) {
+        return false;
+    }
+    size_t cols = featureCount;
+    size_t width = expandedWidth();
+    bool gaussian = kind == NaiveBayesVariant::Gaussian;
+    if (gaussian) {
+        out.floatArray("kCenter", center);
+    }
+    out.floatArray("kWeights", weights);
+    out.floatArray("kBias", bias);
+    out.line() << "\n";
+    out.line() << "static float model(const float* x) {\n";
+    out.indent();
+    out.line() << "float e[" << width << "];\n";
+    out.line() << "for (std::size_t j = 0; j < " << cols << "; j++) {\n";
+    if (gaussian) {
+        out.line() << "    float d = x[j] - kCenter[j];\n";
+        out.line() << "    e[j] = d * d;\n";
+        out.line() << "    e[" << cols << " + j] = d;\n";
+    } else {
+        out.line() << "    e[j] = x[j];\n";
+    }
+    out.line() << "}\n";
+    out.line() << "float s[" << stats.classes << "];\n";
+    out.line() << "for (std::size_t c = 0; c < " << stats.classes << "; c++) {\n";
+    out.line() << "    float sum = 0.0f;\n";
+    out.line() << "    for (std::size_t j = 0; j < " << width << "; j++) {\n";
+    out.line() << "        sum += kWeights[c * " << width << " + j] * e[j];\n";
+    out.line() << "    }\n";
+    out.line() << "    s[c] = sum + kBias[c];\n";
+    out.line() << "}\n";
+    out.returnArgmax("s", stats.classes);
+    out.dedent();
+    out.line() << "}\n";
+    return true;
+}
+
+size_t NaiveBayesModel::memoryBytes() const {
+    // สถิติพอเพียงเก็บไว้สำหรับ partialFit
+    return (stats.counts.size() + stats.sums.size() + stats.sumSquares.size()) * sizeof(double) +
+           (center.size() + weights.size() + bias.size()) * sizeof(float);
+}
+
+void NaiveBayesModel::describe(std::ostream& os) const {
+    os << (kind == NaiveBayesVariant::Gaussian ? "Gaussian" : "Multinomial") << " NaiveBayes: "
+       << stats.classes << " classes x " << featureCount << " features, "
+       << static_cast<size_t>(stats.total()) << " rows seen";
+    if (updates > 1) {
+        os << " across " << updates << " training calls";
+    }
+    os << "\n";
+    os << "Class counts:";
+    for (size_t c = 0; c < stats.classes; c++) {
+        os << " " << static_cast<size_t>(stats.counts[c]);
+    }
+    os << "\n";
+}
+
+} // namespace ai_language
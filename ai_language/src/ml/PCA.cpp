@@ -0,0 +1,423 @@
+#include "../../include/ml/PCA.h"
+#include "../../include/ml/Distance.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace ai_language {
+
+namespace {
+
+constexpr size_t kRowBlock = 256;
+constexpr size_t kMinChunkRows = 4096;
+constexpr size_t kPanel = 32;
+
+// รวมผลของแต่ละก้อนแถวที่คำนวณแบบขนาน fn(begin, end, partial) สะสม width ค่าลงใน partial
+template <typename Fn>
+std::vector<double> reduceRows(size_t rows, size_t width, Fn&& fn) {
+    size_t chunks = parallelChunks(rows, kMinChunkRows);
+    std::vector<std::vector<double>> partials(chunks, std::vector<double>(width, 0.0));
+    parallelFor(0, rows, [&](size_t begin, size_t end, size_t worker) {
+        fn(begin, end, partials[worker].data());
+    }, kMinChunkRows);
+    std::vector<double> total(width, 0.0);
+    for (const auto& partial : partials) {
+        for (size_t i = 0; i < width; i++) {
+            total[i] += partial[i];
+        }
+    }
+    return total;
+}
+
+// out (rows x width) = (data - mean) * basis^T โดย basis เป็น width x cols
+void multiplyCentered(const float* data, size_t rows, size_t cols, const std::vector<float>& mean,
+                      const std::vector<float>& basis, size_t width, float* out) {
+    std::vector<float> shift(width);
+    for (size_t c = 0; c < width; c++) {
+        shift[c] = dotProduct(basis.data() + c * cols, mean.data(), cols);
+    }
+    parallelFor(0, rows, [&](size_t begin, size_t end, size_t) {
+        for (size_t start = begin; start < end; start += kRowBlock) {
+            size_t count = std::min(kRowBlock, end - start);
+            float* block = out + start * width;
+            dotTile(data + start * cols, count, basis.data(), width, cols, block, width);
+            for (size_t r = 0; r < count; r++) {
+                for (size_t c = 0; c < width; c++) {
+                    block[r * width + c] -= shift[c];
+                }
+            }
+        }
+    }, kRowBlock);
+}
+
+// สลับแกนบล็อกแถว src (count แถว, stride ld) เป็น cols x count ทีละ 16 คอลัมน์เพื่อให้อยู่ใน cache
+void transposeBlock(const float* src, size_t ld, size_t cols, size_t count, const float* shift, float* dst) {
+    for (size_t j0 = 0; j0 < cols; j0 += 16) {
+        size_t j1 = std::min(j0 + 16, cols);
+        for (size_t r = 0; r < count; r++) {
+            const float* row = src + r * ld;
+            for (size_t j = j0; j < j1; j++) {
+                dst[j * count + r] = shift ? row[j] - shift[j] : row[j];
+            }
+        }
+    }
+}
+
+// A^T B (aCols x bCols) รวมทุกแถว โดย A และ B เป็น row-major ที่มี stride lda/ldb (ลบ shift ออกจาก A ถ้ามี)
+// แต่ละบล็อกแถวถูกสลับแกนแล้วใช้ dotTile เป็น GEMM ของบล็อก ถ้า B คือ A เดียวกันจะสลับแกนครั้งเดียว
+std::vector<double> transposedProduct(const float* a, size_t lda, size_t aCols, const float* shift,
+                                      const float* b, size_t ldb, size_t bCols, size_t rows) {
+    bool same = a == b && lda == ldb && aCols == bCols && !shift;
+    return reduceRows(rows, aCols * bCols, [&](size_t begin, size_t end, double* acc) {
+        std::vector<float> aBlock(aCols * kRowBlock), bBlock(same ? 0 : bCols * kRowBlock), product(aCols * bCols);
+        for (size_t start = begin; start < end; start += kRowBlock) {
+            size_t count = std::min(kRowBlock, end - start);
+            transposeBlock(a + start * lda, lda, aCols, count, shift, aBlock.data());
+            if (!same) {
+                transposeBlock(b + start * ldb, ldb, bCols, count, nullptr, bBlock.data());
+            }
+            dotTile(aBlock.data(), aCols, same ? aBlock.data() : bBlock.data(), bCols, count, product.data(), bCols);
+            for (size_t i = 0; i < product.size(); i++) {
+                acc[i] += product[i];
+            }
+        }
+    });
+}
+
+// out (cols x width) = (data - mean)^T * q โดย q เป็น rows x width
+void multiplyCenteredTransposed(const float* data, size_t rows, size_t cols, const std::vector<float>& mean,
+                                const float* q, size_t width, std::vector<float>& out) {
+    std::vector<double> total = transposedProduct(data, cols, cols, mean.data(), q, width, width, rows);
+    out.assign(total.begin(), total.end());
+}
+
+// out = in * M (หรือ out -= in * M ถ้า subtract) สำหรับทุกแถว โดย in มี inCols คอลัมน์และ stride ldIn
+// mT คือ M ที่สลับแกนแล้ว (outCols x inCols) บล็อกแถวถูกคัดลอกให้ต่อเนื่องก่อนส่งเข้า dotTile
+void multiplyRows(const float* in, size_t ldIn, size_t inCols, const std::vector<float>& mT, size_t outCols,
+                  float* out, size_t ldOut, size_t rows, bool subtract) {
+    parallelFor(0, rows, [&](size_t begin, size_t end, size_t) {
+        std::vector<float> block(kRowBlock * inCols), product(kRowBlock * outCols);
+        for (size_t start = begin; start < end; start += kRowBlock) {
+            size_t count = std::min(kRowBlock, end - start);
+            for (size_t r = 0; r < count; r++) {
+                const float* row = in + (start + r) * ldIn;
+                std::copy(row, row + inCols, block.begin() + r * inCols);
+            }
+            dotTile(block.data(), count, mT.data(), outCols, inCols, product.data(), outCols);
+            for (size_t r = 0; r < count; r++) {
+                float* target = out + (start + r) * ldOut;
+                const float* value = product.data() + r * outCols;
+                for (size_t k = 0; k < outCols; k++) {
+                    target[k] = subtract ? target[k] - value[k] : value[k];
+                }
+            }
+        }
+    }, kMinChunkRows);
+}
+
+// แผงคอลัมน์ [p0, p0 + pb) = แผง * R^-1 โดย R^T R = Gram ของแผง (Cholesky QR)
+// คอลัมน์ที่ขึ้นต่อคอลัมน์ก่อนหน้า (pivot เล็กมาก) ถูกตั้งเป็นศูนย์
+void choleskyOrthonormalize(float* a, size_t rows, size_t width, size_t p0, size_t pb) {
+    std::vector<double> gram = transposedProduct(a + p0, width, pb, nullptr, a + p0, width, pb, rows);
+
+    std::vector<double> r(pb * pb, 0.0);
+    std::vector<char> alive(pb, 0);
+    for (size_t k = 0; k < pb; k++) {
+        double pivot = gram[k * pb + k];
+        for (size_t j = 0; j < k; j++) {
+            pivot -= r[j * pb + k] * r[j * pb + k];
+        }
+        if (!(pivot > 1e-10 * gram[k * pb + k]) || gram[k * pb + k] <= 0.0) {
+            continue;
+        }
+        alive[k] = 1;
+        r[k * pb + k] = std::sqrt(pivot);
+        for (size_t m = k + 1; m < pb; m++) {
+            double value = gram[k * pb + m];
+            for (size_t j = 0; j < k; j++) {
+                value -= r[j * pb + k] * r[j * pb + m];
+            }
+            r[k * pb + m] = value / r[k * pb + k];
+        }
+    }
+
+    // R^-1 (สามเหลี่ยมบน) เฉพาะคอลัมน์ที่เหลืออยู่ แล้วเก็บแบบสลับแกนสำหรับ multiplyRows
+    std::vector<double> inverse(pb * pb, 0.0);
+    for (size_t k = 0; k < pb; k++) {
+        if (!alive[k]) {
+            continue;
+        }
+        inverse[k * pb + k] = 1.0 / r[k * pb + k];
+        for (size_t i = k; i-- > 0;) {
+            if (!alive[i]) {
+                continue;
+            }
+            double value = 0.0;
+            for (size_t j = i + 1; j <= k; j++) {
+                value += r[i * pb + j] * inverse[j * pb + k];
+            }
+            inverse[i * pb + k] = -value / r[i * pb + i];
+        }
+    }
+    std::vector<float> inverseT(pb * pb);
+    for (size_t j = 0; j < pb; j++) {
+        for (size_t k = 0; k < pb; k++) {
+            inverseT[k * pb + j] = static_cast<float>(inverse[j * pb + k]);
+        }
+    }
+    multiplyRows(a + p0, width, pb, inverseT, pb, a + p0, width, rows, false);
+}
+
+// ทำให้คอลัมน์ของ a (rows x width) ตั้งฉากและยาวหนึ่งหน่วยด้วย blocked QR:
+// แต่ละแผงลบส่วนที่ฉายลงคอลัมน์ก่อนหน้าด้วย GEMM สองครั้ง (CGS2) แล้วทำ Cholesky QR สองครั้งภายในแผง
+void orthonormalizeColumns(float* a, size_t rows, size_t width) {
+    for (size_t p0 = 0; p0 < width; p0 += kPanel) {
+        size_t pb = std::min(kPanel, width - p0);
+        for (int pass = 0; pass < 2; pass++) {
+            if (p0 > 0) {
+                std::vector<double> r = transposedProduct(a, width, p0, nullptr, a + p0, width, pb, rows);
+                std::vector<float> rT(pb * p0);
+                for (size_t c = 0; c < p0; c++) {
+                    for (size_t k = 0; k < pb; k++) {
+                        rT[k * p0 + c] = static_cast<float>(r[c * pb + k]);
+                    }
+                }
+                multiplyRows(a, width, p0, rT, pb, a + p0, width, rows, true);
+            }
+            choleskyOrthonormalize(a, rows, width, p0, pb);
+        }
+    }
+}
+
+// ค่าลักษณะเฉพาะของเมทริกซ์สมมาตร n x n ด้วย cyclic Jacobi (เวกเตอร์อยู่ในคอลัมน์ของ vectors)
+void symmetricEigen(std::vector<double> a, size_t n, std::vector<double>& values, std::vector<double>& vectors) {
+    vectors.assign(n * n, 0.0);
+    for (size_t i = 0; i < n; i++) {
+        vectors[i * n + i] = 1.0;
+    }
+    double scale = 0.0;
+    for (double value : a) {
+        scale += value * value;
+    }
+    for (int sweep = 0; sweep < 100; sweep++) {
+        double off = 0.0;
+        for (size_t p = 0; p < n; p++) {
+            for (size_t q = p + 1; q < n; q++) {
+                off += a[p * n + q] * a[p * n + q];
+            }
+        }
+        if (off <= 1e-30 * scale) {
+            break;
+        }
+        for (size_t p = 0; p < n; p++) {
+            for (size_t q = p + 1; q < n; q++) {
+                double apq = a[p * n + q];
+                if (std::fabs(apq) < 1e-300) {
+                    continue;
+                }
+                double theta = (a[q * n + q] - a[p * n + p]) / (2.0 * apq);
+                double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                double c = 1.0 / std::sqrt(t * t + 1.0);
+                double s = t * c;
+                for (size_t k = 0; k < n; k++) {
+                    double akp = a[k * n + p], akq = a[k * n + q];
+                    a[k * n + p] = c * akp - s * akq;
+                    a[k * n + q] = s * akp + c * akq;
+                }
+                for (size_t k = 0; k < n; k++) {
+                    double apk = a[p * n + k], aqk = a[q * n + k];
+                    a[p * n + k] = c * apk - s * aqk;
+                    a[q * n + k] = s * apk + c * aqk;
+                }
+                for (size_t k = 0; k < n; k++) {
+                    double vkp = vectors[k * n + p], vkq = vectors[k * n + q];
+                    vectors[k * n + p] = c * vkp - s * vkq;
+                    vectors[k * n + q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+    values.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        values[i] = a[i * n + i];
+    }
+}
+
+void transpose(const std::vector<float>& in, size_t rows, size_t cols, std::vector<float>& out) {
+    out.resize(rows * cols);
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) {
+            out[j * rows + i] = in[i * cols + j];
+        }
+    }
+}
+
+} // namespace
+
+void PCA::fit(const float* data, size_t rows, size_t cols, const Options& options) {
+    if (options.components == 0 || options.components > std::min(rows, cols)) {
+        throw std::invalid_argument("PCA components must be between 1 and " + std::to_string(std::min(rows, cols)));
+    }
+    auto start = std::chrono::steady_clock::now();
+    size_t k = options.components;
+    size_t width = std::min(k + options.oversample, std::min(rows, cols));
+
+    // ค่าเฉลี่ยและความแปรปรวนรวมของทุกคอลัมน์ (สองรอบเพื่อความแม่นยำ)
+    std::vector<double> sums = reduceRows(rows, cols, [&](size_t begin, size_t end, double* acc) {
+        for (size_t i = begin; i < end; i++) {
+            const float* x = data + i * cols;
+            for (size_t j = 0; j < cols; j++) {
+                acc[j] += x[j];
+            }
+        }
+    });
+    std::vector<float> columnMean(cols);
+    for (size_t j = 0; j < cols; j++) {
+        columnMean[j] = static_cast<float>(sums[j] / rows);
+    }
+    std::vector<double> squares = reduceRows(rows, cols, [&](size_t begin, size_t end, double* acc) {
+        for (size_t i = begin; i < end; i++) {
+            const float* x = data + i * cols;
+            for (size_t j = 0; j < cols; j++) {
+                double d = x[j] - columnMean[j];
+                acc[j] += d * d;
+            }
+        }
+    });
+    double denominator = rows > 1 ? static_cast<double>(rows - 1) : 1.0;
+    double totalVariance = 0.0;
+    for (double value : squares) {
+        totalVariance += value / denominator;
+    }
+
+    // range finder: Y = (X - mean) * Omega แล้ว power iteration
+    std::vector<float> omega(width * cols);
+    std::mt19937 rng(options.seed);
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    for (float& value : omega) {
+        value = normal(rng);
+    }
+    std::vector<float> y(rows * width);
+    multiplyCentered(data, rows, cols, columnMean, omega, width, y.data());
+    orthonormalizeColumns(y.data(), rows, width);
+
+    std::vector<float> z, basis;
+    for (size_t iteration = 0; iteration < options.powerIterations; iteration++) {
+        multiplyCenteredTransposed(data, rows, cols, columnMean, y.data(), width, z);
+        orthonormalizeColumns(z.data(), cols, width);
+        transpose(z, cols, width, basis);
+        multiplyCentered(data, rows, cols, columnMean, basis, width, y.data());
+        orthonormalizeColumns(y.data(), rows, width);
+    }
+
+    // B^T = (X - mean)^T Q มีขนาด cols x width: SVD ของ B ได้จากค่าลักษณะเฉพาะของ B B^T (width x width)
+    multiplyCenteredTransposed(data, rows, cols, columnMean, y.data(), width, z);
+    y.clear();
+    y.shrink_to_fit();
+    std::vector<double> gram(width * width, 0.0);
+    for (size_t j = 0; j < cols; j++) {
+        const float* row = z.data() + j * width;
+        for (size_t a = 0; a < width; a++) {
+            for (size_t b = a; b < width; b++) {
+                gram[a * width + b] += static_cast<double>(row[a]) * row[b];
+            }
+        }
+    }
+    for (size_t a = 0; a < width; a++) {
+        for (size_t b = 0; b < a; b++) {
+            gram[a * width + b] = gram[b * width + a];
+        }
+    }
+    std::vector<double> eigenvalues, eigenvectors;
+    symmetricEigen(gram, width, eigenvalues, eigenvectors);
+    std::vector<size_t> order(width);
+    for (size_t i = 0; i < width; i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return eigenvalues[a] > eigenvalues[b]; });
+
+    // แกนหลัก c = B^T u_c / sigma_c กลับเครื่องหมายให้ค่าที่มีขนาดมากสุดเป็นบวกเพื่อให้ผลคงที่
+    inputs = cols;
+    outputs = k;
+    fittedRows = rows;
+    rank = width;
+    mean = columnMean;
+    components.assign(k * cols, 0.0f);
+    variance.assign(k, 0.0);
+    varianceRatio.assign(k, 0.0);
+    for (size_t c = 0; c < k; c++) {
+        size_t e = order[c];
+        double lambda = std::max(eigenvalues[e], 0.0);
+        variance[c] = lambda / denominator;
+        varianceRatio[c] = totalVariance > 0.0 ? variance[c] / totalVariance : 0.0;
+        if (lambda <= 0.0) {
+            continue;
+        }
+        double inverseSigma = 1.0 / std::sqrt(lambda);
+        float* component = components.data() + c * cols;
+        size_t largest = 0;
+        for (size_t j = 0; j < cols; j++) {
+            double value = 0.0;
+            for (size_t a = 0; a < width; a++) {
+                value += static_cast<double>(z[j * width + a]) * eigenvectors[a * width + e];
+            }
+            component[j] = static_cast<float>(value * inverseSigma);
+            if (std::fabs(component[j]) > std::fabs(component[largest])) {
+                largest = j;
+            }
+        }
+        if (component[largest] < 0.0f) {
+            for (size_t j = 0; j < cols; j++) {
+                component[j] = -component[j];
+            }
+        }
+    }
+    meanProjection.resize(k);
+    for (size_t c = 0; c < k; c++) {
+        meanProjection[c] = dotProduct(components.data() + c * cols, mean.data(), cols);
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void PCA::transform(const float* rows, size_t count, float* out) const {
+    if (!fitted()) {
+        throw std::runtime_error("PCA has not been fitted");
+    }
+    parallelFor(0, count, [&](size_t begin, size_t end, size_t) {
+        for (size_t start = begin; start < end; start += kRowBlock) {
+            size_t n = std::min(kRowBlock, end - start);
+            float* block = out + start * outputs;
+            dotTile(rows + start * inputs, n, components.data(), outputs, inputs, block, outputs);
+            for (size_t r = 0; r < n; r++) {
+                for (size_t c = 0; c < outputs; c++) {
+                    block[r * outputs + c] -= meanProjection[c];
+                }
+            }
+        }
+    }, kMinChunkRows);
+}
+
+void PCA::describe(std::ostream& os) const {
+    double explained = 0.0;
+    for (double ratio : varianceRatio) {
+        explained += ratio;
+    }
+    std::ios::fmtflags flags = os.flags();
+    os << "PCA: " << inputs << " -> " << outputs << " components on " << fittedRows << " rows (randomized SVD, rank "
+       << rank << ") in " << std::fixed << std::setprecision(3) << seconds << "s" << std::endl;
+    os << "Explained variance: " << std::setprecision(2) << explained * 100.0 << "%";
+    size_t shown = std::min<size_t>(outputs, 5);
+    os << " (first " << shown << ":";
+    for (size_t c = 0; c < shown; c++) {
+        os << " " << varianceRatio[c] * 100.0 << "%";
+    }
+    os << ")" << std::endl;
+    os.flags(flags);
+}
+
+} // namespace ai_language
@@ -0,0 +1,116 @@
+#include "../../include/ml/Polynomial.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace ai_language {
+
+size_t PolynomialFeatures::outputDimension(size_t inputs, size_t degree, bool interactionOnly) {
+    // พจน์ดีกรี t: C(n + t - 1, t) เมื่อยอมให้ตัวแปรซ้ำ และ C(n, t) เมื่อ interaction_only
+    size_t total = 0;
+    size_t terms = 1;
+    for (size_t t = 1; t <= degree; t++) {
+        if (interactionOnly && t > inputs) {
+            break;
+        }
+        size_t top = interactionOnly ? inputs - (t - 1) : inputs + t - 1;
+        // terms * top / t เป็นจำนวนเต็มเสมอ (ผลคูณ t ตัวติดกันหารด้วย t! ลงตัว)
+        if (terms > maxOutputs() / std::max<size_t>(top, 1)) {
+            return 0;
+        }
+        terms = terms * top / t;
+        total += terms;
+        if (total > maxOutputs()) {
+            return 0;
+        }
+    }
+    return total;
+}
+
+PolynomialFeatures::PolynomialFeatures(size_t inputs, size_t degree, bool interactionOnly)
+    : inputs(inputs), maxDegree(degree), interactionsOnly(interactionOnly) {
+    if (degree == 0) {
+        throw std::invalid_argument("Polynomial degree must be at least 1");
+    }
+    outputs = outputDimension(inputs, degree, interactionOnly);
+    if (outputs == 0 && inputs > 0) {
+        throw std::invalid_argument("Polynomial expansion of " + std::to_string(inputs) + " features at degree " +
+                                    std::to_string(degree) + " exceeds " + std::to_string(maxOutputs()) + " columns");
+    }
+    lastFactor.reserve(outputs);
+    levelStart.push_back(0);
+    for (size_t j = 0; j < inputs; j++) {
+        lastFactor.push_back(static_cast<uint32_t>(j));
+    }
+    for (size_t t = 2; t <= degree; t++) {
+        size_t previous = levelStart.back();
+        size_t current = lastFactor.size();
+        levelStart.push_back(current);
+        for (size_t m = previous; m < current; m++) {
+            for (size_t j = lastFactor[m] + (interactionOnly ? 1 : 0); j < inputs; j++) {
+                lastFactor.push_back(static_cast<uint32_t>(j));
+            }
+        }
+    }
+    levelStart.push_back(lastFactor.size());
+}
+
+void PolynomialFeatures::expand(const float* rows, size_t count, float* out) const {
+    size_t skip = interactionsOnly ? 1 : 0;
+    for (size_t i = 0; i < count; i++) {
+        const float* x = rows + i * inputs;
+        float* z = out + i * outputs;
+        std::copy(x, x + inputs, z);
+        size_t p = inputs;
+        for (size_t t = 1; t + 1 < levelStart.size(); t++) {
+            for (size_t m = levelStart[t - 1]; m < levelStart[t]; m++) {
+                float value = z[m];
+                for (size_t j = lastFactor[m] + skip; j < inputs; j++) {
+                    z[p++] = value * x[j];
+                }
+            }
+        }
+    }
+}
+
+std::vector<std::string> PolynomialFeatures::featureNames(const std::vector<std::string>& inputNames) const {
+    std::vector<std::vector<uint32_t>> factors(outputs);
+    for (size_t j = 0; j < inputs; j++) {
+        factors[j] = {static_cast<uint32_t>(j)};
+    }
+    size_t p = inputs;
+    size_t skip = interactionsOnly ? 1 : 0;
+    for (size_t t = 1; t + 1 < levelStart.size(); t++) {
+        for (size_t m = levelStart[t - 1]; m < levelStart[t]; m++) {
+            for (size_t j = lastFactor[m] + skip; j < inputs; j++) {
+                factors[p] = factors[m];
+                factors[p++].push_back(static_cast<uint32_t>(j));
+            }
+        }
+    }
+
+    std::vector<std::string> names(outputs);
+    for (size_t k = 0; k < outputs; k++) {
+        const auto& f = factors[k];
+        std::string name;
+        for (size_t a = 0; a < f.size();) {
+            size_t b = a;
+            while (b < f.size() && f[b] == f[a]) {
+                b++;
+            }
+            name += (name.empty() ? "" : "*") +
+                    (f[a] < inputNames.size() ? inputNames[f[a]] : "x" + std::to_string(f[a]));
+            if (b - a > 1) {
+                name += "^" + std::to_string(b - a);
+            }
+            a = b;
+        }
+        names[k] = name;
+    }
+    return names;
+}
+
+size_t PolynomialFeatures::rowsPerBlock(size_t bytes) const {
+    return std::max<size_t>(1, bytes / (std::max<size_t>(outputs, 1) * sizeof(float)));
+}
+
+} // namespace ai_language
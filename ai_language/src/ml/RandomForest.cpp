@@ -0,0 +1,77 @@
+#include "../../include/ml/RandomForest.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace ai_language {
+
+RandomForestModel::RandomForestModel(const ModelParams& params)
+    : TreeEnsembleModel(params),
+      treeCount(static_cast<size_t>(std::max(1.0, params.get("n_estimators", params.get("trees", 100))))),
+      maxFeatures(params.get("max_features", 0.0)),
+      bootstrap(params.get("bootstrap", 1.0) != 0.0),
+      buildParams(readTreeParams(params, 64)) {
+}
+
+void RandomForestModel::fit(const Dataset& data) {
+    std::vector<uint8_t> columns;
+    prepareBins(data, columns);
+    TreeBuilder builder(binner, columns, data.rows);
+
+    if (maxFeatures >= 1.0) {
+        featuresPerSplit = std::min(data.cols, static_cast<size_t>(maxFeatures));
+    } else if (maxFeatures > 0.0) {
+        featuresPerSplit = std::max<size_t>(1, static_cast<size_t>(maxFeatures * data.cols));
+    } else {
+        featuresPerSplit = classification ? std::max<size_t>(1, static_cast<size_t>(std::sqrt(data.cols))) : data.cols;
+    }
+
+    std::vector<float> gradients, hessians;
+    if (classification) {
+        scoreWidth = data.numClasses();
+    } else {
+        scoreWidth = 1;
+        gradients.resize(data.rows);
+        hessians.assign(data.rows, 1.0f);
+        for (size_t i = 0; i < data.rows; i++) {
+            gradients[i] = -data.targets[i];
+        }
+    }
+
+    trees.assign(treeCount, DecisionTree());
+    parallelFor(0, treeCount, [&](size_t begin, size_t end, size_t) {
+        for (size_t t = begin; t < end; t++) {
+            TreeBuildParams params = buildParams;
+            params.seed = buildParams.seed + static_cast<unsigned>(t) * 7919u;
+            params.maxFeatures = featuresPerSplit;
+            std::mt19937 rng(params.seed);
+            std::vector<uint32_t> rowIndex(data.rows);
+            if (bootstrap) {
+                std::uniform_int_distribution<uint32_t> pick(0, static_cast<uint32_t>(data.rows - 1));
+                for (auto& row : rowIndex) {
+                    row = pick(rng);
+                }
+            } else {
+                for (size_t i = 0; i < data.rows; i++) {
+                    rowIndex[i] = static_cast<uint32_t>(i);
+                }
+            }
+            trees[t] = classification
+                           ? builder.buildClassifier(data.targets, scoreWidth, std::move(rowIndex), params)
+                           : builder.buildRegressor(gradients, hessians, std::move(rowIndex), params);
+        }
+    }, 1);
+
+    baseScore.assign(scoreWidth, 0.0f);
+    scoreScale = 1.0f / static_cast<float>(treeCount);
+    compileLayouts();
+}
+
+void RandomForestModel::describe(std::ostream& os) const {
+    os << "RandomForest (" << (classification ? "gini" : "squared error") << ", "
+       << (bootstrap ? "bootstrap" : "no bootstrap") << ", " << featuresPerSplit << " features per split): ";
+    describeTrees(os);
+}
+
+} // namespace ai_language
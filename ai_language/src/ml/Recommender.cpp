@@ -0,0 +1,465 @@
+#include "../../include/ml/Recommender.h"
+#include "../../include/ml/Distance.h"
+#include "../../include/ml/Metrics.h"
+#include "../../include/ml/ModelFactory.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+namespace ai_language {
+
+namespace {
+
+// จำนวน hash ต่ำสุดที่ KMV เก็บต่อ feature (นับค่าไม่ซ้ำได้ตรงถ้ามีไม่เกินนี้)
+constexpr size_t kDistinctSketch = 64;
+constexpr double kLowCardinality = 10.0;
+// features สูงสุดที่ใช้คำนวณสหสัมพันธ์ระหว่างคู่บนแถวตัวอย่าง (เลือกห่างเท่ากันถ้ามีมากกว่านี้)
+constexpr size_t kMaxCorrelationFeatures = 256;
+constexpr size_t kMinSampleRows = 40;
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+uint64_t splitmix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+uint64_t valueHash(float value) {
+    uint32_t bits;
+    value = value == 0.0f ? 0.0f : value;  // -0 กับ +0 เป็นค่าเดียวกัน
+    std::memcpy(&bits, &value, sizeof(bits));
+    return splitmix64(bits);
+}
+
+// เก็บ hash ที่เล็กที่สุดไม่เกิน limit ค่าแบบเรียงลำดับและไม่ซ้ำ (ค่าที่มากกว่าตัวสุดท้ายถูกตัดทันที)
+void keepSmallest(std::vector<uint64_t>& sorted, uint64_t hash, size_t limit) {
+    if (sorted.size() == limit && hash >= sorted.back()) {
+        return;
+    }
+    auto position = std::lower_bound(sorted.begin(), sorted.end(), hash);
+    if (position != sorted.end() && *position == hash) {
+        return;
+    }
+    sorted.insert(position, hash);
+    if (sorted.size() > limit) {
+        sorted.pop_back();
+    }
+}
+
+struct SketchPartial {
+    std::vector<double> sum;
+    std::vector<double> sumSquares;
+    std::vector<size_t> classCounts;
+    std::vector<std::vector<uint64_t>> distinct;
+    std::vector<std::pair<uint64_t, uint32_t>> sample;  ///< max-heap ของ (hash ของแถว, แถว)
+    size_t zeros = 0;
+};
+
+// |r| มากสุดระหว่างคอลัมน์ของ z (คอลัมน์ละ m ค่าที่ standardize แล้ว) และระหว่างคอลัมน์กับ targets
+void sampleCorrelations(const Dataset& data, const std::vector<uint32_t>& sample, size_t classes,
+                        DatasetSketch& sketch) {
+    size_t m = sample.size();
+    if (m < 3) {
+        return;
+    }
+    std::vector<size_t> columns;
+    size_t step = std::max<size_t>(1, (data.cols + kMaxCorrelationFeatures - 1) / kMaxCorrelationFeatures);
+    for (size_t j = 0; j < data.cols; j += step) {
+        columns.push_back(j);
+    }
+    auto standardize = [m](float* z) {
+        double mean = 0.0, squares = 0.0;
+        for (size_t i = 0; i < m; i++) {
+            mean += z[i];
+        }
+        mean /= m;
+        for (size_t i = 0; i < m; i++) {
+            squares += (z[i] - mean) * (z[i] - mean);
+        }
+        if (squares <= 1e-12) {
+            std::fill(z, z + m, 0.0f);
+            return;
+        }
+        float scale = static_cast<float>(1.0 / std::sqrt(squares));
+        for (size_t i = 0; i < m; i++) {
+            z[i] = static_cast<float>((z[i] - mean) * scale);
+        }
+    };
+
+    // คอลัมน์ที่ standardize แล้วมีความยาว 1 ผลคูณภายในจึงเป็นค่า r โดยตรง
+    size_t d = columns.size();
+    std::vector<float> z(d * m);
+    for (size_t c = 0; c < d; c++) {
+        for (size_t i = 0; i < m; i++) {
+            z[c * m + i] = data.row(sample[i])[columns[c]];
+        }
+        standardize(z.data() + c * m);
+    }
+    std::vector<double> rowMax(d, 0.0);
+    parallelFor(0, d, [&](size_t begin, size_t end, size_t) {
+        for (size_t a = begin; a < end; a++) {
+            for (size_t b = a + 1; b < d; b++) {
+                rowMax[a] = std::max(rowMax[a], static_cast<double>(std::fabs(dotProduct(z.data() + a * m, z.data() + b * m, m))));
+            }
+        }
+    }, 16);
+    sketch.maxFeatureCorrelation = d > 1 ? std::min(1.0, *std::max_element(rowMax.begin(), rowMax.end())) : 0.0;
+
+    // เป้าหมาย: ค่าตรงๆ สำหรับการถดถอย หรือตัวบ่งชี้ของแต่ละคลาส
+    size_t targetsCount = sketch.classification ? (classes == 2 ? 1 : classes) : 1;
+    std::vector<float> target(m);
+    for (size_t t = 0; t < targetsCount; t++) {
+        for (size_t i = 0; i < m; i++) {
+            float y = data.targets[sample[i]];
+            target[i] = sketch.classification ? (static_cast<size_t>(y) == (classes == 2 ? 1 : t) ? 1.0f : 0.0f) : y;
+        }
+        standardize(target.data());
+        for (size_t c = 0; c < d; c++) {
+            double r = std::fabs(dotProduct(z.data() + c * m, target.data(), m));
+            sketch.maxTargetCorrelation = std::max(sketch.maxTargetCorrelation, std::min(1.0, r));
+        }
+    }
+}
+
+// โมเดลที่ลองตามลำดับค่าใช้จ่ายโดยประมาณ และเลขชี้กำลังขั้นต่ำของเวลาเทรนเทียบกับจำนวนแถว
+struct CandidateSpec {
+    const char* type;
+    double minExponent;
+    bool classification;
+    bool regression;
+};
+
+const CandidateSpec kCandidates[] = {
+    {"LinearRegression", 1.0, false, true},
+    {"LogisticRegression", 1.0, true, false},
+    {"NaiveBayes", 1.0, true, false},
+    {"DecisionTree", 1.0, true, true},
+    {"KNN", 1.0, true, true},
+    {"GradientBoosting", 1.0, true, true},
+    {"RandomForest", 1.0, true, true},
+    {"SVM", 2.0, true, false},
+};
+
+double holdoutScore(const MLModel& model, const Dataset& test, size_t classes) {
+    std::vector<float> predicted(test.rows);
+    model.predictBatch(test.features.data(), test.rows, predicted.data());
+    MetricsReport report = MetricsEngine::evaluate(test.targets.data(), predicted.data(), test.rows,
+                                                   test.isClassification(), classes);
+    return test.isClassification() ? report.accuracy : report.r2;
+}
+
+} // namespace
+
+double DatasetSketch::classBalance() const {
+    size_t smallest = std::numeric_limits<size_t>::max(), largest = 0;
+    for (size_t count : classCounts) {
+        if (count > 0) {
+            smallest = std::min(smallest, count);
+            largest = std::max(largest, count);
+        }
+    }
+    return largest > 0 ? static_cast<double>(smallest) / largest : 1.0;
+}
+
+DatasetSketch sketchDataset(const Dataset& data, size_t sampleRows, unsigned seed) {
+    auto start = Clock::now();
+    DatasetSketch sketch;
+    sketch.rows = data.rows;
+    sketch.cols = data.cols;
+    sketch.classification = data.isClassification();
+    size_t classes = sketch.classification ? data.numClasses() : 0;
+    size_t cols = data.cols;
+    sampleRows = std::min(sampleRows, data.rows);
+
+    size_t chunks = parallelChunks(data.rows, 4096);
+    std::vector<SketchPartial> partials(chunks);
+    uint64_t salt = splitmix64(seed);
+    parallelFor(0, data.rows, [&](size_t begin, size_t end, size_t worker) {
+        SketchPartial& p = partials[worker];
+        p.sum.assign(cols, 0.0);
+        p.sumSquares.assign(cols, 0.0);
+        p.classCounts.assign(classes, 0);
+        p.distinct.assign(cols, {});
+        for (size_t i = begin; i < end; i++) {
+            const float* x = data.row(i);
+            for (size_t j = 0; j < cols; j++) {
+                p.sum[j] += x[j];
+                p.sumSquares[j] += static_cast<double>(x[j]) * x[j];
+                p.zeros += x[j] == 0.0f;
+                keepSmallest(p.distinct[j], valueHash(x[j]), kDistinctSketch);
+            }
+            if (classes > 0 && static_cast<size_t>(data.targets[i]) < classes) {
+                p.classCounts[static_cast<size_t>(data.targets[i])]++;
+            }
+            // bottom-k ของ hash ของแถว: ตัวอย่างสุ่มแบบไม่ใส่คืนที่รวมจากหลายก้อนได้และไม่ขึ้นกับจำนวนเธรด
+            uint64_t hash = splitmix64(salt ^ i);
+            if (p.sample.size() < sampleRows || hash < p.sample.front().first) {
+                p.sample.emplace_back(hash, static_cast<uint32_t>(i));
+                std::push_heap(p.sample.begin(), p.sample.end());
+                if (p.sample.size() > sampleRows) {
+                    std::pop_heap(p.sample.begin(), p.sample.end());
+                    p.sample.pop_back();
+                }
+            }
+        }
+    }, 4096);
+
+    // รวมผลของทุกก้อน
+    std::vector<double> sum(cols, 0.0), sumSquares(cols, 0.0);
+    std::vector<std::vector<uint64_t>> distinct(cols);
+    std::vector<std::pair<uint64_t, uint32_t>> sample;
+    sketch.classCounts.assign(classes, 0);
+    size_t zeros = 0;
+    for (const SketchPartial& p : partials) {
+        if (p.sum.empty()) {
+            continue;
+        }
+        for (size_t j = 0; j < cols; j++) {
+            sum[j] += p.sum[j];
+            sumSquares[j] += p.sumSquares[j];
+            for (uint64_t hash : p.distinct[j]) {
+                keepSmallest(distinct[j], hash, kDistinctSketch);
+            }
+        }
+        for (size_t c = 0; c < classes; c++) {
+            sketch.classCounts[c] += p.classCounts[c];
+        }
+        zeros += p.zeros;
+        sample.insert(sample.end(), p.sample.begin(), p.sample.end());
+    }
+    sketch.zeroFraction = data.rows * cols > 0 ? static_cast<double>(zeros) / (data.rows * cols) : 0.0;
+
+    double smallestStd = std::numeric_limits<double>::infinity(), largestStd = 0.0;
+    sketch.cardinality.resize(cols);
+    for (size_t j = 0; j < cols; j++) {
+        double mean = sum[j] / data.rows;
+        double deviation = std::sqrt(std::max(0.0, sumSquares[j] / data.rows - mean * mean));
+        if (deviation <= 1e-6 * std::max(1.0, std::fabs(mean))) {
+            sketch.constantFeatures++;
+        } else {
+            smallestStd = std::min(smallestStd, deviation);
+            largestStd = std::max(largestStd, deviation);
+        }
+        // KMV: ค่าไม่ซ้ำ ~ (k - 1) / (hash ที่ k ในช่วง [0, 1))
+        const auto& hashes = distinct[j];
+        if (hashes.size() < kDistinctSketch) {
+            sketch.cardinality[j] = static_cast<double>(hashes.size());
+        } else {
+            double kth = static_cast<double>(hashes.back()) / 18446744073709551616.0;
+            sketch.cardinality[j] = std::min<double>(data.rows, (kDistinctSketch - 1) / std::max(kth, 1e-300));
+        }
+        sketch.lowCardinality += sketch.cardinality[j] <= kLowCardinality;
+    }
+    sketch.scaleSpread = largestStd > 0.0 ? largestStd / smallestStd : 1.0;
+
+    std::sort(sample.begin(), sample.end());
+    sample.resize(std::min(sample.size(), sampleRows));
+    for (const auto& entry : sample) {
+        sketch.sample.push_back(entry.second);
+    }
+    sampleCorrelations(data, sketch.sample, classes, sketch);
+    sketch.seconds = secondsSince(start);
+    return sketch;
+}
+
+void DatasetSketch::print(std::ostream& os) const {
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << std::fixed << std::setprecision(2);
+    os << "Dataset sketch: " << rows << " rows x " << cols << " features, one pass in " << std::setprecision(4)
+       << seconds << "s" << std::setprecision(2) << "\n";
+    if (classification) {
+        os << "  task: classification, " << classCounts.size() << " classes (smallest/largest class "
+           << classBalance() << ")\n";
+    } else {
+        os << "  task: regression\n";
+    }
+    os << "  zeros: " << zeroFraction * 100.0 << "%, constant features: " << constantFeatures
+       << ", features with <= " << static_cast<int>(kLowCardinality) << " distinct values: " << lowCardinality
+       << ", std spread: " << scaleSpread << "x\n";
+    os << "  max |corr| between features: " << maxFeatureCorrelation << ", strongest feature-target |corr|: "
+       << maxTargetCorrelation << " (on " << sample.size() << " sampled rows)\n";
+    os.flags(flags);
+    os.precision(precision);
+}
+
+RecommendationReport recommendModels(const Dataset& data, const RecommendOptions& options) {
+    auto start = Clock::now();
+    if (data.rows < kMinSampleRows) {
+        throw std::invalid_argument("Model recommendation needs at least " + std::to_string(kMinSampleRows) + " rows");
+    }
+    RecommendationReport report;
+    report.budgetSeconds = options.budgetSeconds;
+    report.sketch = sketchDataset(data, std::max(options.sampleRows, kMinSampleRows), options.seed);
+    const DatasetSketch& sketch = report.sketch;
+    bool classification = sketch.classification;
+    size_t classes = classification ? data.numClasses() : 0;
+
+    // แถวตัวอย่างเรียงตาม hash (สุ่มแล้ว): ทุกแถวที่สี่กันไว้ประเมิน ที่เหลือใช้เทรน
+    std::vector<size_t> trainRows, testRows;
+    for (size_t p = 0; p < sketch.sample.size(); p++) {
+        (p % 4 == 3 ? testRows : trainRows).push_back(sketch.sample[p]);
+    }
+    Dataset train = data.subset(trainRows);
+    Dataset test = data.subset(testRows);
+    report.sampleRows = sketch.sample.size();
+    size_t quarter = std::max<size_t>(kMinSampleRows / 2, train.rows / 4);
+    std::vector<size_t> firstQuarter(std::min(quarter, train.rows));
+    for (size_t i = 0; i < firstQuarter.size(); i++) {
+        firstQuarter[i] = i;
+    }
+    Dataset small = train.subset(firstQuarter);
+
+    std::vector<const CandidateSpec*> specs;
+    for (const CandidateSpec& spec : kCandidates) {
+        if (classification ? spec.classification : spec.regression) {
+            specs.push_back(&spec);
+        }
+    }
+    report.candidates.resize(specs.size());
+
+    // ตัวแทนทุกตัวอยู่ในคิวเดียว: เธรดดึงตัวถัดไปจนหมดหรือเกินงบเวลา
+    auto deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.budgetSeconds));
+    std::atomic<size_t> next(0);
+    parallelFor(0, parallelChunks(specs.size()), [&](size_t, size_t, size_t) {
+        for (size_t c = next++; c < specs.size(); c = next++) {
+            const CandidateSpec& spec = *specs[c];
+            ModelCandidate& candidate = report.candidates[c];
+            candidate.type = spec.type;
+            candidate.scalingExponent = spec.minExponent;
+            if (Clock::now() >= deadline) {
+                candidate.note = "not started: time budget used up";
+                continue;
+            }
+            try {
+                auto fitStart = Clock::now();
+                std::unique_ptr<MLModel> model = ModelFactory::createModel(spec.type, options.params);
+                model->fit(small);
+                double quarterSeconds = secondsSince(fitStart);
+                candidate.trainRows = small.rows;
+                candidate.sampleSeconds = quarterSeconds;
+                candidate.score = holdoutScore(*model, test, classes);
+
+                // เทรนบนแถวตัวอย่างทั้งหมดเฉพาะเมื่อเวลาที่คาดไว้ยังอยู่ในงบ
+                double growth = static_cast<double>(train.rows) / small.rows;
+                double expected = quarterSeconds * std::pow(growth, spec.minExponent);
+                if (growth > 1.0 && Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                                      std::chrono::duration<double>(expected)) <= deadline) {
+                    fitStart = Clock::now();
+                    model = ModelFactory::createModel(spec.type, options.params);
+                    model->fit(train);
+                    double fullSeconds = secondsSince(fitStart);
+                    candidate.trainRows = train.rows;
+                    candidate.sampleSeconds = fullSeconds;
+                    candidate.score = holdoutScore(*model, test, classes);
+                    // เวลาสั้นเกินไปวัดเลขชี้กำลังไม่ได้ ใช้ค่าขั้นต่ำของโมเดล
+                    if (quarterSeconds > 1e-3) {
+                        double measured = std::log(fullSeconds / quarterSeconds) / std::log(growth);
+                        candidate.scalingExponent = std::min(3.0, std::max(spec.minExponent, measured));
+                    }
+                } else if (growth > 1.0) {
+                    candidate.note = "over time budget: scored on " + std::to_string(small.rows) + " rows";
+                }
+                candidate.estimatedSeconds = candidate.sampleSeconds *
+                    std::pow(static_cast<double>(data.rows) / candidate.trainRows, candidate.scalingExponent);
+            } catch (const std::exception& e) {
+                candidate.trainRows = 0;
+                candidate.note = std::string("failed: ") + e.what();
+            }
+        }
+    });
+
+    // คะแนนใกล้คะแนนดีที่สุดเรียงตามคะแนนต่อวินาที ที่เหลือตามคะแนน ที่ไม่ได้เทรนอยู่ท้ายสุด
+    double best = -std::numeric_limits<double>::infinity();
+    for (const ModelCandidate& candidate : report.candidates) {
+        if (candidate.trainRows > 0) {
+            best = std::max(best, candidate.score);
+        }
+    }
+    for (ModelCandidate& candidate : report.candidates) {
+        candidate.competitive = candidate.trainRows > 0 && candidate.score >= best - options.tolerance;
+    }
+    std::stable_sort(report.candidates.begin(), report.candidates.end(),
+                     [](const ModelCandidate& a, const ModelCandidate& b) {
+        if ((a.trainRows > 0) != (b.trainRows > 0)) {
+            return a.trainRows > 0;
+        }
+        if (a.competitive != b.competitive) {
+            return a.competitive;
+        }
+        if (a.competitive) {
+            return a.scorePerSecond() > b.scorePerSecond();
+        }
+        return a.score > b.score;
+    });
+
+    if (classification && sketch.classBalance() < 0.2) {
+        report.notes.push_back("Classes are imbalanced: compare ROC-AUC / PR-AUC from 'evaluate model', not only accuracy");
+    }
+    if (sketch.maxFeatureCorrelation > 0.95) {
+        report.notes.push_back("Some features are nearly collinear: 'preprocess pca components N' removes the redundancy");
+    }
+    if (sketch.zeroFraction > 0.5) {
+        report.notes.push_back("Features are mostly zeros: tree and linear models cope better than distance-based KNN/SVM");
+    }
+    if (sketch.cols > 0 && sketch.lowCardinality * 2 > sketch.cols) {
+        report.notes.push_back("Most features look like category codes: tree models split on them directly");
+    }
+    if (sketch.scaleSpread > 100.0) {
+        report.notes.push_back("Feature scales differ widely: distance-based KNN is dominated by the largest features");
+    }
+    if (!classification && sketch.maxTargetCorrelation > 0.9) {
+        report.notes.push_back("One feature is strongly linear in the target: LinearRegression is a good baseline");
+    }
+    report.seconds = secondsSince(start);
+    return report;
+}
+
+void RecommendationReport::print(std::ostream& os) const {
+    sketch.print(os);
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    const char* metric = sketch.classification ? "accuracy" : "R^2";
+    os << "Proxy models on " << sampleRows << " sampled rows (3/4 train, 1/4 holdout; budget " << std::fixed
+       << std::setprecision(1) << budgetSeconds << "s, used " << std::setprecision(2) << seconds << "s):\n";
+    os << "  " << std::left << std::setw(20) << "model" << std::right << std::setw(10) << metric << std::setw(12)
+       << "sample fit" << std::setw(14) << "est. full fit" << std::setw(12) << std::string(metric) + "/s" << "\n";
+    for (const ModelCandidate& candidate : candidates) {
+        os << "  " << std::left << std::setw(20) << candidate.type << std::right;
+        if (candidate.trainRows == 0) {
+            os << "  " << candidate.note << "\n";
+            continue;
+        }
+        std::ostringstream fit;
+        fit << std::fixed << std::setprecision(3) << candidate.sampleSeconds << "s";
+        os << std::setw(10) << std::setprecision(4) << candidate.score << std::setw(12) << fit.str()
+           << std::setw(13) << std::setprecision(3) << candidate.estimatedSeconds << "s" << std::setw(12)
+           << std::setprecision(1) << candidate.scorePerSecond() << (candidate.competitive ? " *" : "  ");
+        if (!candidate.note.empty()) {
+            os << " (" << candidate.note << ")";
+        }
+        os << "\n";
+    }
+    os << "  * within the tolerance of the best " << metric << ", ranked by " << metric << " per second of training\n";
+    for (const std::string& note : notes) {
+        os << "Note: " << note << "\n";
+    }
+    os.flags(flags);
+    os.precision(precision);
+}
+
+} // namespace ai_language
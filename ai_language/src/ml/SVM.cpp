@@ -0,0 +1,879 @@
+#include "../../include/ml/SVM.h"
+#include "../../include/ml/CodeGen.h"
+#include "../../include/ml/Distance.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace ai_language {
+
+namespace {
+
+constexpr double kTau = 1e-12;
+constexpr size_t kPredictBlock = 64;
+constexpr size_t kSupportTile = 256;
+
+/**
+ * @brief ตัวแก้ SMO แบบเดียวกับ LIBSVM: เลือก working set ด้วยข้อมูลอันดับสอง และ shrinking ตัวแปรที่ติดขอบ
+ *
+ * ข้อมูลถูกเรียงใหม่ตาม active set (ตัวแปรที่ยังไม่ถูก shrink อยู่ช่วงต้น) เพื่อให้แถวเคอร์เนลที่ต้องคำนวณต่อเนื่องกัน
+ */
+class SMOSolver {
+public:
+    SMOSolver(const std::vector<float>& points, const std::vector<float>& pointNorms, const std::vector<int8_t>& labels,
+              size_t count, size_t dim, float gamma, double C, double eps, bool shrinking, size_t cacheBytes)
+        : x(points), norms(pointNorms), y(labels), l(count), dim(dim), gamma(gamma), C(C), eps(eps),
+          shrinking(shrinking), cache(count, cacheBytes) {
+        alpha.assign(l, 0.0);
+        G.assign(l, -1.0);
+        Gbar.assign(l, 0.0);
+        status.assign(l, Lower);
+        QD.assign(l, 1.0);  // K(x, x) = 1 สำหรับ RBF
+        activeSet.resize(l);
+        for (size_t i = 0; i < l; i++) {
+            activeSet[i] = static_cast<uint32_t>(i);
+        }
+        activeSize = l;
+    }
+
+    void solve(size_t maxIterations, std::vector<double>& alphaOut, double& rho, SVMSolveInfo& info) {
+        size_t iter = 0;
+        size_t counter = std::min<size_t>(l, 1000) + 1;
+        bool optimal = false;
+        while (iter < maxIterations) {
+            if (--counter == 0) {
+                counter = std::min<size_t>(l, 1000);
+                if (shrinking) {
+                    doShrinking();
+                    info.shrinkPasses++;
+                }
+            }
+
+            int32_t i, j;
+            if (selectWorkingSet(i, j)) {
+                // ตรวจสอบอีกครั้งบนข้อมูลทั้งหมดก่อนหยุด
+                reconstructGradient();
+                activeSize = l;
+                if (selectWorkingSet(i, j)) {
+                    optimal = true;
+                    break;
+                }
+                counter = 1;
+            }
+            iter++;
+            update(static_cast<size_t>(i), static_cast<size_t>(j));
+        }
+        if (!optimal) {
+            reconstructGradient();
+            activeSize = l;
+        }
+
+        rho = calculateRho();
+        alphaOut.assign(l, 0.0);
+        for (size_t i = 0; i < l; i++) {
+            alphaOut[activeSet[i]] = alpha[i];
+            if (alpha[i] > 0.0) {
+                info.supportVectors++;
+            }
+        }
+        info.iterations = iter;
+        info.converged = optimal;
+        info.cacheHits = cache.hits();
+        info.cacheMisses = cache.misses();
+    }
+
+private:
+    enum Status : uint8_t { Lower, Upper, Free };
+
+    bool isUpper(size_t i) const { return status[i] == Upper; }
+    bool isLower(size_t i) const { return status[i] == Lower; }
+    bool isFree(size_t i) const { return status[i] == Free; }
+
+    void updateStatus(size_t i) {
+        status[i] = alpha[i] >= C ? Upper : (alpha[i] <= 0.0 ? Lower : Free);
+    }
+
+    // แถว i ของ Q_ij = y_i y_j K(x_i, x_j) สำหรับ j ใน [0, len)
+    const float* row(size_t i, size_t len) {
+        float* data;
+        size_t start = cache.get(i, &data, len);
+        if (start < len) {
+            rbfKernelTile(x.data() + i * dim, &norms[i], 1, x.data() + start * dim, norms.data() + start,
+                          len - start, dim, gamma, data + start, len);
+            if (y[i] > 0) {
+                for (size_t j = start; j < len; j++) {
+                    data[j] = y[j] > 0 ? data[j] : -data[j];
+                }
+            } else {
+                for (size_t j = start; j < len; j++) {
+                    data[j] = y[j] > 0 ? -data[j] : data[j];
+                }
+            }
+        }
+        return data;
+    }
+
+    void swapIndex(size_t i, size_t j) {
+        cache.swapIndex(i, j);
+        std::swap_ranges(x.begin() + i * dim, x.begin() + (i + 1) * dim, x.begin() + j * dim);
+        std::swap(norms[i], norms[j]);
+        std::swap(y[i], y[j]);
+        std::swap(alpha[i], alpha[j]);
+        std::swap(G[i], G[j]);
+        std::swap(Gbar[i], Gbar[j]);
+        std::swap(status[i], status[j]);
+        std::swap(QD[i], QD[j]);
+        std::swap(activeSet[i], activeSet[j]);
+    }
+
+    bool selectWorkingSet(int32_t& outI, int32_t& outJ) {
+        double gMax = -std::numeric_limits<double>::infinity();
+        double gMax2 = -std::numeric_limits<double>::infinity();
+        int32_t gMaxIdx = -1;
+        int32_t gMinIdx = -1;
+        double objDiffMin = std::numeric_limits<double>::infinity();
+
+        for (size_t t = 0; t < activeSize; t++) {
+            if (y[t] > 0) {
+                if (!isUpper(t) && -G[t] >= gMax) {
+                    gMax = -G[t];
+                    gMaxIdx = static_cast<int32_t>(t);
+                }
+            } else if (!isLower(t) && G[t] >= gMax) {
+                gMax = G[t];
+                gMaxIdx = static_cast<int32_t>(t);
+            }
+        }
+
+        const float* Qi = gMaxIdx != -1 ? row(static_cast<size_t>(gMaxIdx), activeSize) : nullptr;
+        for (size_t j = 0; j < activeSize && Qi; j++) {
+            size_t i = static_cast<size_t>(gMaxIdx);
+            double gradDiff;
+            double quadCoef;
+            if (y[j] > 0) {
+                if (isLower(j)) {
+                    continue;
+                }
+                gradDiff = gMax + G[j];
+                gMax2 = std::max(gMax2, G[j]);
+                quadCoef = QD[i] + QD[j] - 2.0 * y[i] * Qi[j];
+            } else {
+                if (isUpper(j)) {
+                    continue;
+                }
+                gradDiff = gMax - G[j];
+                gMax2 = std::max(gMax2, -G[j]);
+                quadCoef = QD[i] + QD[j] + 2.0 * y[i] * Qi[j];
+            }
+            if (gradDiff > 0.0) {
+                double objDiff = -(gradDiff * gradDiff) / (quadCoef > 0.0 ? quadCoef : kTau);
+                if (objDiff <= objDiffMin) {
+                    gMinIdx = static_cast<int32_t>(j);
+                    objDiffMin = objDiff;
+                }
+            }
+        }
+
+        if (gMax + gMax2 < eps || gMinIdx == -1) {
+            return true;
+        }
+        outI = gMaxIdx;
+        outJ = gMinIdx;
+        return false;
+    }
+
+    void update(size_t i, size_t j) {
+        const float* Qi = row(i, activeSize);
+        const float* Qj = row(j, activeSize);
+        double oldI = alpha[i];
+        double oldJ = alpha[j];
+
+        if (y[i] != y[j]) {
+            double quadCoef = QD[i] + QD[j] + 2.0 * Qi[j];
+            double delta = (-G[i] - G[j]) / (quadCoef > 0.0 ? quadCoef : kTau);
+            double diff = alpha[i] - alpha[j];
+            alpha[i] += delta;
+            alpha[j] += delta;
+            if (diff > 0.0) {
+                if (alpha[j] < 0.0) {
+                    alpha[j] = 0.0;
+                    alpha[i] = diff;
+                }
+            } else if (alpha[i] < 0.0) {
+                alpha[i] = 0.0;
+                alpha[j] = -diff;
+            }
+            if (diff > 0.0) {
+                if (alpha[i] > C) {
+                    alpha[i] = C;
+                    alpha[j] = C - diff;
+                }
+            } else if (alpha[j] > C) {
+                alpha[j] = C;
+                alpha[i] = C + diff;
+            }
+        } else {
+            double quadCoef = QD[i] + QD[j] - 2.0 * Qi[j];
+            double delta = (G[i] - G[j]) / (quadCoef > 0.0 ? quadCoef : kTau);
+            double sum = alpha[i] + alpha[j];
+            alpha[i] -= delta;
+            alpha[j] += delta;
+            if (sum > C) {
+                if (alpha[i] > C) {
+                    alpha[i] = C;
+                    alpha[j] = sum - C;
+                }
+                if (alpha[j] > C) {
+                    alpha[j] = C;
+                    alpha[i] = sum - C;
+                }
+            } else {
+                if (alpha[j] < 0.0) {
+                    alpha[j] = 0.0;
+                    alpha[i] = sum;
+                }
+                if (alpha[i] < 0.0) {
+                    alpha[i] = 0.0;
+                    alpha[j] = sum;
+                }
+            }
+        }
+
+        double deltaI = alpha[i] - oldI;
+        double deltaJ = alpha[j] - oldJ;
+        for (size_t k = 0; k < activeSize; k++) {
+            G[k] += Qi[k] * deltaI + Qj[k] * deltaJ;
+        }
+
+        // G_bar เก็บผลรวมของตัวแปรที่ชนขอบบน เพื่อสร้าง gradient ของตัวแปรที่ถูก shrink กลับมาได้
+        bool wasUpperI = isUpper(i);
+        bool wasUpperJ = isUpper(j);
+        updateStatus(i);
+        updateStatus(j);
+        if (wasUpperI != isUpper(i)) {
+            const float* full = row(i, l);
+            double sign = wasUpperI ? -C : C;
+            for (size_t k = 0; k < l; k++) {
+                Gbar[k] += sign * full[k];
+            }
+        }
+        if (wasUpperJ != isUpper(j)) {
+            const float* full = row(j, l);
+            double sign = wasUpperJ ? -C : C;
+            for (size_t k = 0; k < l; k++) {
+                Gbar[k] += sign * full[k];
+            }
+        }
+    }
+
+    void reconstructGradient() {
+        if (activeSize == l) {
+            return;
+        }
+        for (size_t j = activeSize; j < l; j++) {
+            G[j] = Gbar[j] - 1.0;
+        }
+        for (size_t i = 0; i < activeSize; i++) {
+            if (isFree(i)) {
+                const float* Qi = row(i, l);
+                for (size_t j = activeSize; j < l; j++) {
+                    G[j] += alpha[i] * Qi[j];
+                }
+            }
+        }
+    }
+
+    bool beShrunk(size_t i, double gMax1, double gMax2) const {
+        if (isUpper(i)) {
+            return y[i] > 0 ? -G[i] > gMax1 : -G[i] > gMax2;
+        }
+        if (isLower(i)) {
+            return y[i] > 0 ? G[i] > gMax2 : G[i] > gMax1;
+        }
+        return false;
+    }
+
+    void doShrinking() {
+        double gMax1 = -std::numeric_limits<double>::infinity();
+        double gMax2 = -std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < activeSize; i++) {
+            if (y[i] > 0) {
+                if (!isUpper(i)) {
+                    gMax1 = std::max(gMax1, -G[i]);
+                }
+                if (!isLower(i)) {
+                    gMax2 = std::max(gMax2, G[i]);
+                }
+            } else {
+                if (!isUpper(i)) {
+                    gMax2 = std::max(gMax2, -G[i]);
+                }
+                if (!isLower(i)) {
+                    gMax1 = std::max(gMax1, G[i]);
+                }
+            }
+        }
+
+        // ใกล้ลู่เข้าแล้ว: คืนตัวแปรทั้งหมดหนึ่งครั้งเพื่อไม่ให้ shrink ผิดตัว
+        if (!unshrunk && gMax1 + gMax2 <= eps * 10) {
+            unshrunk = true;
+            reconstructGradient();
+            activeSize = l;
+        }
+
+        for (size_t i = 0; i < activeSize; i++) {
+            if (!beShrunk(i, gMax1, gMax2)) {
+                continue;
+            }
+            activeSize--;
+            while (activeSize > i) {
+                if (!beShrunk(activeSize, gMax1, gMax2)) {
+                    swapIndex(i, activeSize);
+                    break;
+                }
+                activeSize--;
+            }
+        }
+    }
+
+    double calculateRho() const {
+        size_t freeCount = 0;
+        double upper = std::numeric_limits<double>::infinity();
+        double lower = -std::numeric_limits<double>::infinity();
+        double sumFree = 0.0;
+        for (size_t i = 0; i < activeSize; i++) {
+            double yG = y[i] * G[i];
+            if (isUpper(i)) {
+                if (y[i] < 0) {
+                    upper = std::min(upper, yG);
+                } else {
+                    lower = std::max(lower, yG);
+                }
+            } else if (isLower(i)) {
+                if (y[i] > 0) {
+                    upper = std::min(upper, yG);
+                } else {
+                    lower = std::max(lower, yG);
+                }
+            } else {
+                freeCount++;
+                sumFree += yG;
+            }
+        }
+        return freeCount > 0 ? sumFree / freeCount : (upper + lower) / 2.0;
+    }
+
+    std::vector<float> x;
+    std::vector<float> norms;
+    std::vector<int8_t> y;
+    size_t l;
+    size_t dim;
+    float gamma;
+    double C;
+    double eps;
+    bool shrinking;
+    bool unshrunk = false;
+    KernelRowCache cache;
+
+    std::vector<double> alpha;
+    std::vector<double> G;
+    std::vector<double> Gbar;
+    std::vector<Status> status;
+    std::vector<double> QD;
+    std::vector<uint32_t> activeSet;
+    size_t activeSize;
+};
+
+} // namespace
+
+KernelRowCache::KernelRowCache(size_t count, size_t bytes)
+    : rows(count),
+      freeFloats(std::max(bytes / sizeof(float), 2 * count)) {
+}
+
+void KernelRowCache::unlink(size_t index) {
+    Row& r = rows[index];
+    if (r.prev != -1) {
+        rows[r.prev].next = r.next;
+    } else {
+        head = r.next;
+    }
+    if (r.next != -1) {
+        rows[r.next].prev = r.prev;
+    } else {
+        tail = r.prev;
+    }
+    r.prev = r.next = -1;
+    r.linked = false;
+}
+
+void KernelRowCache::pushBack(size_t index) {
+    Row& r = rows[index];
+    r.prev = tail;
+    r.next = -1;
+    if (tail != -1) {
+        rows[tail].next = static_cast<int32_t>(index);
+    } else {
+        head = static_cast<int32_t>(index);
+    }
+    tail = static_cast<int32_t>(index);
+    r.linked = true;
+}
+
+size_t KernelRowCache::get(size_t index, float** data, size_t len) {
+    Row& r = rows[index];
+    if (r.linked) {
+        unlink(index);
+    }
+    size_t have = r.len;
+    if (have < len) {
+        missCount++;
+        size_t more = len - have;
+        // ไล่แถวที่ไม่ได้ใช้นานที่สุดออกจนมีที่พอ
+        while (freeFloats < more && head != -1) {
+            size_t victim = static_cast<size_t>(head);
+            unlink(victim);
+            freeFloats += rows[victim].len;
+            std::vector<float>().swap(rows[victim].data);
+            rows[victim].len = 0;
+        }
+        r.data.resize(len);
+        freeFloats -= more;
+        r.len = len;
+    } else {
+        hitCount++;
+    }
+    pushBack(index);
+    *data = r.data.data();
+    return have;
+}
+
+void KernelRowCache::swapIndex(size_t i, size_t j) {
+    if (i == j) {
+        return;
+    }
+    bool linkedI = rows[i].linked;
+    bool linkedJ = rows[j].linked;
+    if (linkedI) {
+        unlink(i);
+    }
+    if (linkedJ) {
+        unlink(j);
+    }
+    std::swap(rows[i].data, rows[j].data);
+    std::swap(rows[i].len, rows[j].len);
+    if (linkedJ) {
+        pushBack(i);
+    }
+    if (linkedI) {
+        pushBack(j);
+    }
+
+    if (i > j) {
+        std::swap(i, j);
+    }
+    for (int32_t h = head; h != -1;) {
+        Row& r = rows[h];
+        int32_t next = r.next;
+        if (r.len > i) {
+            if (r.len > j) {
+                std::swap(r.data[i], r.data[j]);
+            } else {
+                // แถวนี้มีค่าที่ตำแหน่ง i แต่ไม่มีที่ตำแหน่ง j: ทิ้งแถวทั้งแถว
+                unlink(static_cast<size_t>(h));
+                freeFloats += r.len;
+                std::vector<float>().swap(r.data);
+                r.len = 0;
+            }
+        }
+        h = next;
+    }
+}
+
+SVMModel::SVMModel(const ModelParams& params)
+    : kernelType(SVMKernel::RBF),
+      C(params.get("C", params.get("c", 1.0))),
+      gammaParam(params.get("gamma", 0.0)),
+      tolerance(params.get("tol", 0.0)),
+      maxIterations(static_cast<size_t>(std::max(0.0, params.get("max_iter", 0.0)))),
+      cacheMB(std::max(1.0, params.get("kernel_cache_mb", 100.0))),
+      shrinking(params.get("shrinking", 1.0) != 0.0),
+      seed(static_cast<unsigned>(params.get("random_state", params.get("seed", 42)))) {
+    std::string name = params.getString("kernel", "rbf");
+    if (name == "linear") {
+        kernelType = SVMKernel::Linear;
+    } else if (name != "rbf") {
+        throw std::invalid_argument("Unknown SVM kernel '" + name + "' (use rbf or linear)");
+    }
+    if (C <= 0.0) {
+        throw std::invalid_argument("SVM parameter C must be positive");
+    }
+}
+
+void SVMModel::solveSMO(const std::vector<float>& x, const std::vector<float>& norms, const std::vector<int8_t>& y,
+                        size_t rows, size_t cacheBytes, std::vector<double>& alpha, double& rho,
+                        SVMSolveInfo& solveInfo) const {
+    double eps = tolerance > 0.0 ? tolerance : 1e-3;
+    size_t limit = maxIterations > 0 ? maxIterations : std::max<size_t>(10000000, rows > 100000 ? 100 * rows : 0);
+    SMOSolver solver(x, norms, y, rows, featureCount, gamma, C, eps, shrinking, cacheBytes);
+    solver.solve(limit, alpha, rho, solveInfo);
+}
+
+void SVMModel::solveDCD(const std::vector<float>& x, const std::vector<int8_t>& y, size_t rows,
+                        float* w, float& b, SVMSolveInfo& solveInfo) const {
+    // dual coordinate descent ของ L1-loss SVM (Hsieh et al. 2008) โดยเก็บ w แทนแถวเคอร์เนล
+    // bias ถูกจัดการเหมือน feature คงที่ค่า 1
+    size_t dim = featureCount;
+    double eps = tolerance > 0.0 ? tolerance : 0.1;
+    size_t limit = maxIterations > 0 ? maxIterations : 1000;
+    std::vector<double> alpha(rows, 0.0);
+    std::vector<float> QD(rows);
+    std::vector<uint32_t> index(rows);
+    for (size_t i = 0; i < rows; i++) {
+        QD[i] = dotProduct(x.data() + i * dim, x.data() + i * dim, dim) + 1.0f;
+        index[i] = static_cast<uint32_t>(i);
+    }
+    std::fill(w, w + dim, 0.0f);
+    b = 0.0f;
+
+    std::mt19937 rng(seed);
+    size_t activeSize = rows;
+    double pgMaxOld = std::numeric_limits<double>::infinity();
+    double pgMinOld = -std::numeric_limits<double>::infinity();
+    size_t iter = 0;
+    for (; iter < limit; iter++) {
+        double pgMaxNew = -std::numeric_limits<double>::infinity();
+        double pgMinNew = std::numeric_limits<double>::infinity();
+        std::shuffle(index.begin(), index.begin() + activeSize, rng);
+
+        for (size_t s = 0; s < activeSize; s++) {
+            size_t i = index[s];
+            const float* xi = x.data() + i * dim;
+            double yi = y[i];
+            double g = yi * (dotProduct(w, xi, dim) + b) - 1.0;
+            double pg = 0.0;
+            if (alpha[i] == 0.0) {
+                if (g > pgMaxOld && shrinking) {
+                    std::swap(index[s], index[--activeSize]);
+                    s--;
+                    continue;
+                }
+                if (g < 0.0) {
+                    pg = g;
+                }
+            } else if (alpha[i] == C) {
+                if (g < pgMinOld && shrinking) {
+                    std::swap(index[s], index[--activeSize]);
+                    s--;
+                    continue;
+                }
+                if (g > 0.0) {
+                    pg = g;
+                }
+            } else {
+                pg = g;
+            }
+            pgMaxNew = std::max(pgMaxNew, pg);
+            pgMinNew = std::min(pgMinNew, pg);
+
+            if (std::fabs(pg) > 1e-12) {
+                double old = alpha[i];
+                alpha[i] = std::min(std::max(alpha[i] - g / QD[i], 0.0), C);
+                float d = static_cast<float>((alpha[i] - old) * yi);
+                for (size_t k = 0; k < dim; k++) {
+                    w[k] += d * xi[k];
+                }
+                b += d;
+            }
+        }
+
+        if (pgMaxNew - pgMinNew <= eps) {
+            if (activeSize == rows) {
+                solveInfo.converged = true;
+                break;
+            }
+            activeSize = rows;
+            pgMaxOld = std::numeric_limits<double>::infinity();
+            pgMinOld = -std::numeric_limits<double>::infinity();
+            solveInfo.shrinkPasses++;
+            continue;
+        }
+        pgMaxOld = pgMaxNew <= 0.0 ? std::numeric_limits<double>::infinity() : pgMaxNew;
+        pgMinOld = pgMinNew >= 0.0 ? -std::numeric_limits<double>::infinity() : pgMinNew;
+    }
+
+    solveInfo.iterations = iter;
+    for (double a : alpha) {
+        if (a > 0.0) {
+            solveInfo.supportVectors++;
+        }
+    }
+}
+
+void SVMModel::fit(const Dataset& data) {
+    if (!data.isClassification()) {
+        throw std::invalid_argument("SVM supports classification targets only");
+    }
+    if (data.empty()) {
+        throw std::invalid_argument("Dataset is empty");
+    }
+    featureCount = data.cols;
+    classes = data.numClasses();
+    if (classes < 2) {
+        throw std::invalid_argument("SVM needs at least two classes");
+    }
+    problems = classes == 2 ? 1 : classes;
+    size_t rows = data.rows;
+    size_t dim = featureCount;
+
+    if (gammaParam > 0.0) {
+        gamma = static_cast<float>(gammaParam);
+    } else {
+        // gamma = 1 / (features * ความแปรปรวนรวม) แบบเดียวกับ scikit-learn "scale"
+        double sum = 0.0, square = 0.0;
+        for (float v : data.features) {
+            sum += v;
+            square += static_cast<double>(v) * v;
+        }
+        double n = static_cast<double>(data.features.size());
+        double variance = square / n - (sum / n) * (sum / n);
+        gamma = static_cast<float>(variance > 0.0 ? 1.0 / (dim * variance) : 1.0);
+    }
+
+    std::vector<std::vector<int8_t>> labels(problems, std::vector<int8_t>(rows));
+    std::vector<bool> mixed(problems, false);
+    for (size_t p = 0; p < problems; p++) {
+        size_t positive = problems == 1 ? 1 : p;
+        size_t positives = 0;
+        for (size_t i = 0; i < rows; i++) {
+            bool isPositive = static_cast<size_t>(data.targets[i]) == positive;
+            labels[p][i] = isPositive ? 1 : -1;
+            positives += isPositive ? 1 : 0;
+        }
+        mixed[p] = positives > 0 && positives < rows;
+    }
+
+    info.assign(problems, SVMSolveInfo());
+    bias.assign(problems, 0.0f);
+    weights.clear();
+    supportVectors.clear();
+    svNorms.clear();
+    svCoef.clear();
+    svCount = 0;
+
+    if (kernelType == SVMKernel::Linear) {
+        weights.assign(problems * dim, 0.0f);
+        parallelFor(0, problems, [&](size_t begin, size_t end, size_t) {
+            for (size_t p = begin; p < end; p++) {
+                if (!mixed[p]) {
+                    bias[p] = labels[p][0];
+                    continue;
+                }
+                solveDCD(data.features, labels[p], rows, weights.data() + p * dim, bias[p], info[p]);
+            }
+        });
+        return;
+    }
+
+    std::vector<float> norms(rows);
+    squaredNorms(data.features.data(), rows, dim, norms.data());
+    size_t concurrent = std::max<size_t>(1, std::min(problems, availableThreads()));
+    size_t cacheBytes = static_cast<size_t>(cacheMB * 1024.0 * 1024.0) / concurrent;
+
+    std::vector<std::vector<double>> alphas(problems);
+    std::vector<double> rhos(problems, 0.0);
+    parallelFor(0, problems, [&](size_t begin, size_t end, size_t) {
+        for (size_t p = begin; p < end; p++) {
+            if (!mixed[p]) {
+                alphas[p].assign(rows, 0.0);
+                rhos[p] = -labels[p][0];
+                continue;
+            }
+            solveSMO(data.features, norms, labels[p], rows, cacheBytes, alphas[p], rhos[p], info[p]);
+        }
+    });
+
+    // รวม support vectors ของทุกปัญหาย่อย เพื่อให้คำนวณเคอร์เนลตอนทำนายเพียงครั้งเดียวต่อแถว
+    std::vector<uint32_t> selected;
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t p = 0; p < problems; p++) {
+            if (alphas[p][i] > 0.0) {
+                selected.push_back(static_cast<uint32_t>(i));
+                break;
+            }
+        }
+    }
+    svCount = selected.size();
+    supportVectors.resize(svCount * dim);
+    svNorms.resize(svCount);
+    svCoef.assign(svCount * problems, 0.0f);
+    for (size_t s = 0; s < svCount; s++) {
+        size_t i = selected[s];
+        std::copy(data.row(i), data.row(i) + dim, supportVectors.begin() + s * dim);
+        svNorms[s] = norms[i];
+        for (size_t p = 0; p < problems; p++) {
+            svCoef[s * problems + p] = static_cast<float>(alphas[p][i] * labels[p][i]);
+        }
+    }
+    for (size_t p = 0; p < problems; p++) {
+        bias[p] = static_cast<float>(-rhos[p]);
+    }
+}
+
+void SVMModel::decisionFunction(const float* rows, size_t count, float* out) const {
+    if (problems == 0) {
+        throw std::runtime_error("SVM model has not been trained");
+    }
+    size_t dim = featureCount;
+    parallelFor(0, (count + kPredictBlock - 1) / kPredictBlock, [&](size_t begin, size_t end, size_t) {
+        std::vector<float> queryNorms(kPredictBlock);
+        std::vector<float> tile(kPredictBlock * kSupportTile);
+        for (size_t block = begin; block < end; block++) {
+            size_t first = block * kPredictBlock;
+            size_t m = std::min(kPredictBlock, count - first);
+            const float* queries = rows + first * dim;
+            float* scores = out + first * problems;
+
+            if (kernelType == SVMKernel::Linear) {
+                dotTile(queries, m, weights.data(), problems, dim, scores, problems);
+            } else {
+                std::fill(scores, scores + m * problems, 0.0f);
+                squaredNorms(queries, m, dim, queryNorms.data());
+                for (size_t s = 0; s < svCount; s += kSupportTile) {
+                    size_t n = std::min(kSupportTile, svCount - s);
+                    rbfKernelTile(queries, queryNorms.data(), m, supportVectors.data() + s * dim,
+                                  svNorms.data() + s, n, dim, gamma, tile.data(), kSupportTile);
+                    for (size_t i = 0; i < m; i++) {
+                        const float* k = tile.data() + i * kSupportTile;
+                        float* score = scores + i * problems;
+                        for (size_t t = 0; t < n; t++) {
+                            const float* coef = svCoef.data() + (s + t) * problems;
+                            for (size_t p = 0; p < problems; p++) {
+                                score[p] += k[t] * coef[p];
+                            }
+                        }
+                    }
+                }
+            }
+            for (size_t i = 0; i < m; i++) {
+                for (size_t p = 0; p < problems; p++) {
+                    scores[i * problems + p] += bias[p];
+                }
+            }
+        }
+    }, 2);
+}
+
+void SVMModel::predictBatch(const float* rows, size_t count, float* out) const {
+    std::vector<float> scores(count * problems);
+    decisionFunction(rows, count, scores.data());
+    for (size_t i = 0; i < count; i++) {
+        const float* score = scores.data() + i * problems;
+        if (problems == 1) {
+            out[i] = score[0] > 0.0f ? 1.0f : 0.0f;
+        } else {
+            out[i] = static_cast<float>(std::max_element(score, score + problems) - score);
+        }
+    }
+}
+
+size_t SVMModel::decisionScores(const float* rows, size_t count, std::vector<float>& out) const {
+    out.resize(count * problems);
+    decisionFunction(rows, count, out.data());
+    return problems;
+}
+
+bool SVMModel::emitSource(SourceWriter& out) const {
+    if (problems == 0) {
+        return false;
+    }
+    size_t dim = featureCount;
+    if (kernelType == SVMKernel::Linear) {
+        out.floatArray("kWeights", weights);
+    } else {
+        out.line() << "constexpr std::size_t kSupportVectors = " << svCount << ";\n";
+        out.floatArray("kVectors", supportVectors);
+        out.floatArray("kCoef", svCoef);
+    }
+    out.floatArray("kBias", bias);
+    out.line() << "\n";
+    out.line() << "static float model(const float* x) {\n";
+    out.indent();
+    out.line() << "float s[" << problems << "] = {};\n";
+    if (kernelType == SVMKernel::Linear) {
+        out.line() << "for (std::size_t p = 0; p < " << problems << "; p++) {\n";
+        out.line() << "    for (std::size_t j = 0; j < " << dim << "; j++) {\n";
+        out.line() << "        s[p] += kWeights[p * " << dim << " + j] * x[j];\n";
+        out.line() << "    }\n";
+        out.line() << "}\n";
+    } else {
+        out.line() << "for (std::size_t v = 0; v < kSupportVectors; v++) {\n";
+        out.line() << "    float d2 = 0.0f;\n";
+        out.line() << "    for (std::size_t j = 0; j < " << dim << "; j++) {\n";
+        out.line() << "        float d = x[j] - kVectors[v * " << dim << " + j];\n";
+        out.line() << "        d2 += d * d;\n";
+        out.line() << "    }\n";
+        out.line() << "    float k = std::exp(" << SourceWriter::literal(-gamma) << " * d2);\n";
+        out.line() << "    for (std::size_t p = 0; p < " << problems << "; p++) {\n";
+        out.line() << "        s[p] += k * kCoef[v * " << problems << " + p];\n";
+        out.line() << "    }\n";
+        out.line() << "}\n";
+    }
+    out.line() << "for (std::size_t p = 0; p < " << problems << "; p++) {\n";
+    out.line() << "    s[p] += kBias[p];\n";
+    out.line() << "}\n";
+    if (problems == 1) {
+        out.line() << "return s[0] > 0.0f ? 1.0f : 0.0f;\n";
+    } else {
+        out.returnArgmax("s", problems);
+    }
+    out.dedent();
+    out.line() << "}\n";
+    return true;
+}
+
+size_t SVMModel::memoryBytes() const {
+    return (weights.size() + bias.size() + supportVectors.size() + svNorms.size() + svCoef.size()) * sizeof(float);
+}
+
+void SVMModel::describe(std::ostream& os) const {
+    size_t iterations = 0, shrinkPasses = 0, hits = 0, misses = 0, vectors = 0;
+    bool converged = true;
+    for (const auto& part : info) {
+        iterations += part.iterations;
+        shrinkPasses += part.shrinkPasses;
+        hits += part.cacheHits;
+        misses += part.cacheMisses;
+        vectors += part.supportVectors;
+        converged = converged && (part.converged || part.iterations == 0);
+    }
+
+    os << "SVM (" << (kernelType == SVMKernel::Linear ? "linear, dual coordinate descent" : "rbf, SMO") << "): "
+       << classes << " classes";
+    if (problems > 1) {
+        os << " (" << problems << " one-vs-rest problems)";
+    }
+    os << ", C = " << C;
+    if (kernelType == SVMKernel::RBF) {
+        os << ", gamma = " << gamma;
+    }
+    os << "\n";
+    if (kernelType == SVMKernel::Linear) {
+        os << "Support vectors: " << vectors << ", epochs: " << iterations << ", shrink restarts: " << shrinkPasses << "\n";
+    } else {
+        os << "Support vectors: " << svCount << " unique (" << vectors << " across problems), iterations: "
+           << iterations << ", shrink passes: " << shrinkPasses << "\n";
+        if (hits + misses > 0) {
+            os << "Kernel cache (" << cacheMB << " MB): " << hits << " hits, " << misses << " misses ("
+               << 100.0 * hits / (hits + misses) << "% hit rate)\n";
+        }
+    }
+    if (!converged) {
+        os << "Warning: solver reached max_iter before converging\n";
+    }
+}
+
+} // namespace ai_language
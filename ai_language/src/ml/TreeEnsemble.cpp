@@ -0,0 +1,550 @@
+#include "../../include/ml/TreeEnsemble.h"
+#include "../../include/ml/CodeGen.h"
+#include "../../include/utils/parallel.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+namespace ai_language {
+
+namespace {
+
+constexpr size_t kRowBlock = 64;
+constexpr size_t kScorerBlock = 32;
+constexpr size_t kLatencySample = 200;
+constexpr size_t kThroughputSample = 20000;
+
+inline void addLeaf(const float* values, size_t outputs, float* scores) {
+    for (size_t o = 0; o < outputs; o++) {
+        scores[o] += values[o];
+    }
+}
+
+// เขียนโหนดเป็น if/else ซ้อนกันด้วยเกณฑ์ float เดียวกับ DecisionTree::evaluate
+void emitNode(SourceWriter& out, const DecisionTree& tree, int32_t index) {
+    const TreeNode& node = tree.nodes[index];
+    if (node.feature < 0) {
+        const float* values = tree.leafValues.data() + node.leaf * tree.outputs;
+        for (size_t o = 0; o < tree.outputs; o++) {
+            out.line() << "s[" << tree.outputOffset + o << "] += " << SourceWriter::literal(values[o]) << ";\n";
+        }
+        return;
+    }
+    out.line() << "if (x[" << node.feature << "] <= " << SourceWriter::literal(node.threshold) << ") {\n";
+    out.indent();
+    emitNode(out, tree, node.left);
+    out.dedent();
+    out.line() << "} else {\n";
+    out.indent();
+    emitNode(out, tree, node.right);
+    out.dedent();
+    out.line() << "}\n";
+}
+
+} // namespace
+
+bool CompiledForest::compile(const std::vector<DecisionTree>& trees, size_t features) {
+    nodes.clear();
+    roots.clear();
+    outputs.clear();
+    offsets.clear();
+    leafValues.clear();
+    if (features > 65535) {
+        return false;
+    }
+    for (const auto& tree : trees) {
+        uint32_t base = static_cast<uint32_t>(nodes.size());
+        uint32_t leafBase = static_cast<uint32_t>(leafValues.size());
+        roots.push_back(base);
+        outputs.push_back(static_cast<uint16_t>(tree.outputs));
+        offsets.push_back(static_cast<uint16_t>(tree.outputOffset));
+        leafValues.insert(leafValues.end(), tree.leafValues.begin(), tree.leafValues.end());
+        nodes.resize(base + tree.nodes.size());
+
+        // breadth-first: ลูกทั้งสองของโหนดถูกจองตำแหน่งติดกันตามลำดับที่พบในคิว
+        std::vector<int32_t> queue = {0};
+        uint32_t next = base + 1;
+        for (size_t head = 0; head < queue.size(); head++) {
+            const TreeNode& source = tree.nodes[queue[head]];
+            Node& node = nodes[base + head];
+            if (source.feature < 0) {
+                node = {0, 0, 1, leafBase + source.leaf * static_cast<uint32_t>(tree.outputs)};
+                continue;
+            }
+            node = {static_cast<uint16_t>(source.feature), source.bin, 0, next};
+            next += 2;
+            queue.push_back(source.left);
+            queue.push_back(source.right);
+        }
+    }
+    return true;
+}
+
+void CompiledForest::evaluate(const uint8_t* binnedRows, size_t count, size_t cols, float* scores, size_t width) const {
+    const Node* base = nodes.data();
+    for (size_t first = 0; first < count; first += kRowBlock) {
+        size_t last = std::min(count, first + kRowBlock);
+        // ต้นเดียวกันถูกใช้กับทั้งบล็อกของแถว โหนดบนๆ จึงอยู่ใน cache ตลอด
+        for (size_t t = 0; t < roots.size(); t++) {
+            const Node* root = base + roots[t];
+            size_t out = outputs[t];
+            size_t offset = offsets[t];
+            for (size_t r = first; r < last; r++) {
+                const uint8_t* x = binnedRows + r * cols;
+                const Node* node = root;
+                while (!node->isLeaf) {
+                    node = base + node->target + (x[node->feature] > node->bin ? 1 : 0);
+                }
+                addLeaf(leafValues.data() + node->target, out, scores + r * width + offset);
+            }
+        }
+    }
+}
+
+size_t CompiledForest::bytes() const {
+    return nodes.size() * sizeof(Node) + leafValues.size() * sizeof(float) + roots.size() * 8;
+}
+
+bool QuickScorerForest::compile(const std::vector<DecisionTree>& trees, size_t features) {
+    treeCount = 0;
+    featureOffsets.assign(features + 1, 0);
+    entryBins.clear();
+    entryTrees.clear();
+    entryMasks.clear();
+    initialMasks.clear();
+    leafOffsets.clear();
+    outputs.clear();
+    offsets.clear();
+    leafValues.clear();
+    for (const auto& tree : trees) {
+        if (tree.leafCount() > 64) {
+            return false;
+        }
+    }
+
+    struct Entry {
+        uint32_t feature;
+        uint8_t bin;
+        uint32_t tree;
+        uint64_t mask;
+    };
+    std::vector<Entry> entries;
+    for (size_t t = 0; t < trees.size(); t++) {
+        const DecisionTree& tree = trees[t];
+        // ลำดับใบจากซ้ายไปขวา และช่วงใบ [first, last) ของทุกโหนด
+        std::vector<uint32_t> firstLeaf(tree.nodes.size()), lastLeaf(tree.nodes.size());
+        std::vector<int32_t> leafOrder;
+        std::vector<std::pair<int32_t, bool>> stack = {{0, false}};
+        while (!stack.empty()) {
+            auto [id, visited] = stack.back();
+            stack.pop_back();
+            const TreeNode& node = tree.nodes[id];
+            if (node.feature < 0) {
+                firstLeaf[id] = static_cast<uint32_t>(leafOrder.size());
+                leafOrder.push_back(id);
+                lastLeaf[id] = static_cast<uint32_t>(leafOrder.size());
+            } else if (visited) {
+                firstLeaf[id] = firstLeaf[node.left];
+                lastLeaf[id] = lastLeaf[node.right];
+            } else {
+                stack.push_back({id, true});
+                stack.push_back({node.right, false});
+                stack.push_back({node.left, false});
+            }
+        }
+
+        size_t leaves = leafOrder.size();
+        uint64_t all = leaves == 64 ? ~0ULL : ((1ULL << leaves) - 1);
+        initialMasks.push_back(all);
+        for (size_t id = 0; id < tree.nodes.size(); id++) {
+            const TreeNode& node = tree.nodes[id];
+            if (node.feature < 0) {
+                continue;
+            }
+            // เงื่อนไขเป็นเท็จ (ไปขวา): ใบในกิ่งซ้ายทั้งหมดไปไม่ถึงอีกต่อไป
+            uint32_t lo = firstLeaf[node.left];
+            uint32_t hi = lastLeaf[node.left];
+            uint64_t span = (hi - lo == 64) ? ~0ULL : (((1ULL << (hi - lo)) - 1) << lo);
+            entries.push_back({static_cast<uint32_t>(node.feature), node.bin, static_cast<uint32_t>(t), all & ~span});
+        }
+
+        leafOffsets.push_back(static_cast<uint32_t>(leafValues.size()));
+        outputs.push_back(static_cast<uint16_t>(tree.outputs));
+        offsets.push_back(static_cast<uint16_t>(tree.outputOffset));
+        for (int32_t id : leafOrder) {
+            const float* values = tree.leafValues.data() + tree.nodes[id].leaf * tree.outputs;
+            leafValues.insert(leafValues.end(), values, values + tree.outputs);
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.feature != b.feature ? a.feature < b.feature : a.bin < b.bin;
+    });
+    for (const auto& entry : entries) {
+        featureOffsets[entry.feature + 1]++;
+        entryBins.push_back(entry.bin);
+        entryTrees.push_back(entry.tree);
+        entryMasks.push_back(entry.mask);
+    }
+    for (size_t f = 0; f < features; f++) {
+        featureOffsets[f + 1] += featureOffsets[f];
+    }
+    treeCount = trees.size();
+    return true;
+}
+
+void QuickScorerForest::evaluate(const uint8_t* binnedRows, size_t count, size_t cols, float* scores,
+                                 size_t width) const {
+    std::vector<uint64_t> leaves(kScorerBlock * treeCount);
+    for (size_t first = 0; first < count; first += kScorerBlock) {
+        size_t rowsInBlock = std::min(kScorerBlock, count - first);
+        for (size_t r = 0; r < rowsInBlock; r++) {
+            std::copy(initialMasks.begin(), initialMasks.end(), leaves.begin() + r * treeCount);
+        }
+        // เกณฑ์ของ feature เดียวกันถูกใช้กับทุกแถวในบล็อกก่อนไป feature ถัดไป
+        for (size_t f = 0; f < cols; f++) {
+            uint32_t begin = featureOffsets[f];
+            uint32_t end = featureOffsets[f + 1];
+            if (begin == end) {
+                continue;
+            }
+            for (size_t r = 0; r < rowsInBlock; r++) {
+                uint8_t value = binnedRows[(first + r) * cols + f];
+                uint64_t* rowLeaves = leaves.data() + r * treeCount;
+                for (uint32_t e = begin; e < end && entryBins[e] < value; e++) {
+                    rowLeaves[entryTrees[e]] &= entryMasks[e];
+                }
+            }
+        }
+        for (size_t r = 0; r < rowsInBlock; r++) {
+            const uint64_t* rowLeaves = leaves.data() + r * treeCount;
+            float* rowScores = scores + (first + r) * width;
+            for (size_t t = 0; t < treeCount; t++) {
+                size_t leaf = static_cast<size_t>(__builtin_ctzll(rowLeaves[t]));
+                addLeaf(leafValues.data() + leafOffsets[t] + leaf * outputs[t], outputs[t], rowScores + offsets[t]);
+            }
+        }
+    }
+}
+
+size_t QuickScorerForest::bytes() const {
+    return entryBins.size() * (1 + 4 + 8) + leafValues.size() * sizeof(float) + treeCount * (8 + 4 + 4) +
+           featureOffsets.size() * 4;
+}
+
+TreeBuildParams readTreeParams(const ModelParams& params, size_t defaultDepth) {
+    TreeBuildParams build;
+    double depth = params.get("max_depth", 0.0);
+    build.maxDepth = depth > 0.0 ? static_cast<size_t>(depth) : defaultDepth;
+    build.minSamplesSplit = static_cast<size_t>(std::max(2.0, params.get("min_samples_split", 2.0)));
+    build.minSamplesLeaf = static_cast<size_t>(std::max(1.0, params.get("min_samples_leaf", 1.0)));
+    build.seed = static_cast<unsigned>(params.get("random_state", params.get("seed", 42)));
+    return build;
+}
+
+TreeEnsembleModel::TreeEnsembleModel(const ModelParams& params)
+    : maxBins(static_cast<size_t>(std::min(256.0, std::max(2.0, params.get("max_bins", 256))))),
+      requestedLayout(TreeLayout::Auto) {
+    std::string name = params.getString("inference", "auto");
+    if (name == "naive") {
+        requestedLayout = TreeLayout::Naive;
+    } else if (name == "compiled") {
+        requestedLayout = TreeLayout::Compiled;
+    } else if (name == "quickscorer") {
+        requestedLayout = TreeLayout::QuickScorer;
+    } else if (name != "auto") {
+        throw std::invalid_argument("Unknown tree inference layout '" + name +
+                                    "' (use auto, naive, compiled or quickscorer)");
+    }
+}
+
+std::string TreeEnsembleModel::layoutName(TreeLayout layout) {
+    switch (layout) {
+        case TreeLayout::Naive: return "naive";
+        case TreeLayout::Compiled: return "compiled-bfs";
+        case TreeLayout::QuickScorer: return "quickscorer";
+        default: return "auto";
+    }
+}
+
+TreeLayout TreeEnsembleModel::activeLayout() const {
+    if (requestedLayout == TreeLayout::Naive) {
+        return TreeLayout::Naive;
+    }
+    if ((requestedLayout == TreeLayout::Auto || requestedLayout == TreeLayout::QuickScorer) && !quickScorer.empty()) {
+        return TreeLayout::QuickScorer;
+    }
+    return compiled.empty() ? TreeLayout::Naive : TreeLayout::Compiled;
+}
+
+void TreeEnsembleModel::prepareBins(const Dataset& data, std::vector<uint8_t>& columns) {
+    if (data.empty()) {
+        throw std::invalid_argument("Dataset is empty");
+    }
+    if (data.isClassification()) {
+        for (float t : data.targets) {
+            if (t < 0.0f || t != std::floor(t)) {
+                throw std::invalid_argument("Class labels must be non-negative integers");
+            }
+        }
+    }
+    featureCount = data.cols;
+    classification = data.isClassification();
+    binner.fit(data, maxBins);
+    binner.transformColumns(data, columns);
+}
+
+void TreeEnsembleModel::compileLayouts() {
+    if (!compiled.compile(trees, featureCount)) {
+        compiled = CompiledForest();
+    }
+    if (!quickScorer.compile(trees, featureCount)) {
+        quickScorer = QuickScorerForest();
+    }
+
+    gainImportance.assign(featureCount, 0.0);
+    double total = 0.0;
+    for (const auto& tree : trees) {
+        for (const auto& node : tree.nodes) {
+            if (node.feature >= 0 && node.gain > 0.0f) {
+                gainImportance[node.feature] += node.gain;
+                total += node.gain;
+            }
+        }
+    }
+    if (total > 0.0) {
+        for (double& value : gainImportance) {
+            value /= total;
+        }
+    }
+}
+
+void TreeEnsembleModel::rawScores(const float* rows, size_t count, float* out, TreeLayout layout) const {
+    if (trees.empty()) {
+        throw std::runtime_error("Tree model has not been trained");
+    }
+    if (layout == TreeLayout::Auto || (layout == TreeLayout::QuickScorer && quickScorer.empty()) ||
+        (layout == TreeLayout::Compiled && compiled.empty())) {
+        layout = activeLayout();
+    }
+    std::fill(out, out + count * scoreWidth, 0.0f);
+    size_t cols = featureCount;
+
+    parallelFor(0, (count + 255) / 256, [&](size_t begin, size_t end, size_t) {
+        std::vector<uint8_t> binned;
+        for (size_t block = begin; block < end; block++) {
+            size_t first = block * 256;
+            size_t n = std::min<size_t>(256, count - first);
+            const float* blockRows = rows + first * cols;
+            float* blockScores = out + first * scoreWidth;
+            if (layout == TreeLayout::Naive) {
+                for (size_t r = 0; r < n; r++) {
+                    for (const auto& tree : trees) {
+                        addLeaf(tree.evaluate(blockRows + r * cols), tree.outputs,
+                                blockScores + r * scoreWidth + tree.outputOffset);
+                    }
+                }
+                continue;
+            }
+            binned.resize(n * cols);
+            binner.transformRows(blockRows, n, binned.data());
+            if (layout == TreeLayout::QuickScorer) {
+                quickScorer.evaluate(binned.data(), n, cols, blockScores, scoreWidth);
+            } else {
+                compiled.evaluate(binned.data(), n, cols, blockScores, scoreWidth);
+            }
+        }
+    }, 1);
+
+    for (size_t i = 0; i < count; i++) {
+        float* score = out + i * scoreWidth;
+        for (size_t o = 0; o < scoreWidth; o++) {
+            score[o] = baseScore[o] + scoreScale * score[o];
+        }
+    }
+}
+
+void TreeEnsembleModel::predictBatch(const float* rows, size_t count, float* out) const {
+    std::vector<float> scores(count * scoreWidth);
+    rawScores(rows, count, scores.data(), activeLayout());
+    for (size_t i = 0; i < count; i++) {
+        const float* score = scores.data() + i * scoreWidth;
+        if (!classification) {
+            out[i] = score[0];
+        } else if (marginOutput) {
+            out[i] = score[0] > 0.0f ? 1.0f : 0.0f;
+        } else {
+            out[i] = static_cast<float>(std::max_element(score, score + scoreWidth) - score);
+        }
+    }
+}
+
+size_t TreeEnsembleModel::decisionScores(const float* rows, size_t count, std::vector<float>& out) const {
+    if (!classification) {
+        return 0;
+    }
+    out.resize(count * scoreWidth);
+    rawScores(rows, count, out.data(), TreeLayout::Auto);
+    return scoreWidth;
+}
+
+bool TreeEnsembleModel::emitSource(SourceWriter& out) const {
+    if (trees.empty()) {
+        return false;
+    }
+    for (size_t t = 0; t < trees.size(); t++) {
+        out.line() << "static void model_tree" << t << "(const float* x, float* s) {\n";
+        out.indent();
+        emitNode(out, trees[t], 0);
+        out.dedent();
+        out.line() << "}\n\n";
+    }
+    out.floatArray("kBaseScore", baseScore);
+    out.line() << "\n";
+    out.line() << "static float model(const float* x) {\n";
+    out.indent();
+    out.line() << "float s[" << scoreWidth << "] = {};\n";
+    for (size_t t = 0; t < trees.size(); t++) {
+        out.line() << "model_tree" << t << "(x, s);\n";
+    }
+    out.line() << "for (std::size_t o = 0; o < " << scoreWidth << "; o++) {\n";
+    out.line() << "    s[o] = kBaseScore[o] + " << SourceWriter::literal(scoreScale) << " * s[o];\n";
+    out.line() << "}\n";
+    if (!classification) {
+        out.line() << "return s[0];\n";
+    } else if (marginOutput) {
+        out.line() << "return s[0] > 0.0f ? 1.0f : 0.0f;\n";
+    } else {
+        out.returnArgmax("s", scoreWidth);
+    }
+    out.dedent();
+    out.line() << "}\n";
+    return true;
+}
+
+void TreeEnsembleModel::reportBatch(const float* rows, size_t count, std::ostream& os) const {
+    if (count == 0 || trees.empty()) {
+        return;
+    }
+    size_t batch = std::min(count, kThroughputSample);
+    size_t latencyRows = std::min(count, kLatencySample);
+    size_t naiveBytes = 0;
+    for (const auto& tree : trees) {
+        naiveBytes += tree.nodes.size() * sizeof(TreeNode) + tree.leafValues.size() * sizeof(float);
+    }
+
+    std::vector<float> reference(batch * scoreWidth);
+    std::vector<float> scores(batch * scoreWidth);
+    os << "Tree inference layouts (" << trees.size() << " trees, " << batch << " rows):\n";
+    os << "  " << std::left << std::setw(14) << "layout" << std::setw(16) << "latency/row" << std::setw(18)
+       << "throughput" << std::setw(12) << "memory" << "max |diff|" << "\n";
+    for (TreeLayout layout : {TreeLayout::Naive, TreeLayout::Compiled, TreeLayout::QuickScorer}) {
+        if ((layout == TreeLayout::Compiled && compiled.empty()) ||
+            (layout == TreeLayout::QuickScorer && quickScorer.empty())) {
+            os << "  " << std::setw(14) << layoutName(layout) << "n/a"
+               << (layout == TreeLayout::QuickScorer ? " (trees have more than 64 leaves)" : "") << "\n";
+            continue;
+        }
+        auto start = std::chrono::steady_clock::now();
+        rawScores(rows, batch, scores.data(), layout);
+        double batchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::vector<float> one(scoreWidth);
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < latencyRows; i++) {
+            rawScores(rows + i * featureCount, 1, one.data(), layout);
+        }
+        double latency = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() /
+                         latencyRows;
+
+        double diff = 0.0;
+        if (layout == TreeLayout::Naive) {
+            reference = scores;
+        } else {
+            for (size_t i = 0; i < scores.size(); i++) {
+                diff = std::max(diff, static_cast<double>(std::fabs(scores[i] - reference[i])));
+            }
+        }
+        size_t bytes = layout == TreeLayout::Naive ? naiveBytes
+                                                   : (layout == TreeLayout::Compiled ? compiled.bytes() : quickScorer.bytes());
+        std::ostringstream latencyText, throughputText, memoryText;
+        latencyText << std::fixed << std::setprecision(2) << latency << " us";
+        throughputText << static_cast<size_t>(batchSeconds > 0.0 ? batch / batchSeconds : 0.0) << " rows/s";
+        memoryText << (bytes + 1023) / 1024 << " KB";
+        os << "  " << std::setw(14) << layoutName(layout) << std::setw(16) << latencyText.str() << std::setw(18)
+           << throughputText.str() << std::setw(12) << memoryText.str() << diff
+           << (layout == activeLayout() ? "  <- active" : "") << "\n";
+    }
+    os << std::right;
+}
+
+size_t TreeEnsembleModel::memoryBytes() const {
+    // ต้นไม้ต้นฉบับ (ใช้กับ inference "naive" และ export) รวมกับรูปแบบที่คอมไพล์แล้วและเกณฑ์ของทุก feature
+    size_t bytes = compiled.bytes() + quickScorer.bytes() + baseScore.size() * sizeof(float);
+    for (const auto& tree : trees) {
+        bytes += tree.nodes.size() * sizeof(TreeNode) + tree.leafValues.size() * sizeof(float);
+    }
+    for (size_t f = 0; f < binner.numFeatures(); f++) {
+        bytes += (binner.numBins(f) - 1) * sizeof(float);
+    }
+    return bytes;
+}
+
+void TreeEnsembleModel::describeTrees(std::ostream& os) const {
+    size_t nodes = 0, leaves = 0, maxDepth = 0;
+    for (const auto& tree : trees) {
+        nodes += tree.nodes.size();
+        leaves += tree.leafCount();
+        maxDepth = std::max(maxDepth, tree.depth());
+    }
+    os << trees.size() << (trees.size() == 1 ? " tree, " : " trees, ") << nodes << " nodes, " << leaves
+       << " leaves, max depth " << maxDepth << "\n";
+    os << "Inference layout: " << layoutName(activeLayout());
+    if (!compiled.empty()) {
+        os << " (compiled " << (compiled.bytes() + 1023) / 1024 << " KB";
+        if (!quickScorer.empty()) {
+            os << ", quickscorer " << (quickScorer.bytes() + 1023) / 1024 << " KB";
+        }
+        os << ")";
+    }
+    os << "\n";
+}
+
+DecisionTreeModel::DecisionTreeModel(const ModelParams& params)
+    : TreeEnsembleModel(params), buildParams(readTreeParams(params, 64)) {
+}
+
+void DecisionTreeModel::fit(const Dataset& data) {
+    std::vector<uint8_t> columns;
+    prepareBins(data, columns);
+    TreeBuilder builder(binner, columns, data.rows);
+    std::vector<uint32_t> rowIndex(data.rows);
+    std::iota(rowIndex.begin(), rowIndex.end(), 0u);
+
+    trees.clear();
+    if (classification) {
+        scoreWidth = data.numClasses();
+        trees.push_back(builder.buildClassifier(data.targets, scoreWidth, std::move(rowIndex), buildParams));
+    } else {
+        scoreWidth = 1;
+        std::vector<float> gradients(data.rows), hessians(data.rows, 1.0f);
+        for (size_t i = 0; i < data.rows; i++) {
+            gradients[i] = -data.targets[i];
+        }
+        trees.push_back(builder.buildRegressor(gradients, hessians, std::move(rowIndex), buildParams));
+    }
+    baseScore.assign(scoreWidth, 0.0f);
+    scoreScale = 1.0f;
+    compileLayouts();
+}
+
+void DecisionTreeModel::describe(std::ostream& os) const {
+    os << "DecisionTree (" << (classification ? "gini" : "squared error") << "): ";
+    describeTrees(os);
+}
+
+} // namespace ai_language
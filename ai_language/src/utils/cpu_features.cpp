@@ -0,0 +1,58 @@
+#include "../../include/utils/cpu_features.h"
+
+#if defined(__linux__) && defined(__x86_64__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ai_language {
+
+bool cpuHasAvx2() {
+#if defined(__x86_64__) || defined(__i386__)
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+bool cpuHasAvx512() {
+#if defined(__x86_64__) || defined(__i386__)
+    static const bool supported = __builtin_cpu_supports("avx512f");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+bool cpuHasAvx512Bf16() {
+#if defined(__x86_64__) || defined(__i386__)
+    static const bool supported = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bf16");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+bool cpuHasAmxBf16() {
+#if defined(__linux__) && defined(__x86_64__)
+    // ARCH_REQ_XCOMP_PERM กับ XFEATURE_XTILEDATA: Linux ไม่ให้ใช้หน่วยความจำไทล์จนกว่าโปรเซสจะขอ
+    static const bool supported = __builtin_cpu_supports("amx-tile") && __builtin_cpu_supports("amx-bf16") &&
+                                  syscall(SYS_arch_prctl, 0x1023, 18) == 0;
+    return supported;
+#else
+    return false;
+#endif
+}
+
+std::string cpuSimdLevel() {
+    if (cpuHasAvx512()) {
+        return "AVX-512";
+    }
+    if (cpuHasAvx2()) {
+        return "AVX2";
+    }
+    return "scalar";
+}
+
+} // namespace ai_language
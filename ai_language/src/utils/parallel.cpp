@@ -0,0 +1,220 @@
+#include "../../include/utils/parallel.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ai_language {
+
+namespace {
+
+std::atomic<size_t> configuredThreads{0};
+thread_local size_t threadBudget = 0;   ///< 0 = ยังไม่ถูกจำกัด (ใช้ maxThreads())
+
+/**
+ * ชุดเธรดถาวรของ parallelFor: ทำงานทีละหนึ่งงาน แต่ละเธรดที่เข้าร่วมหยิบหมายเลขก้อนถัดไปจากตัวนับ atomic
+ * จนหมด ผู้เรียกหยิบก้อนด้วยและรอจนทุกก้อนเสร็จและทุกเธรดที่เข้าร่วมออกจากงานแล้ว
+ * งานถัดไปจึงไม่มีเธรดใดยังอ่านตัวนับหรือ context ของงานก่อนค้างอยู่
+ */
+class WorkerPool {
+public:
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    /**
+     * @return false ถ้ากำลังทำงานของผู้เรียกอื่นอยู่
+     */
+    bool tryRun(size_t chunks, void (*invoke)(void*, size_t), void* context) {
+        std::unique_lock<std::mutex> job(busy, std::try_to_lock);
+        if (!job.owns_lock()) {
+            return false;
+        }
+        // เธรดที่ขาดถูกสร้างครั้งเดียว (จอง heap เฉพาะตอนนี้)
+        while (threads.size() + 1 < chunks) {
+            threads.emplace_back(&WorkerPool::work, this);
+        }
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            current = invoke;
+            currentContext = context;
+            currentChunks = chunks;
+            next.store(0, std::memory_order_relaxed);
+            remaining = chunks;
+            helpers = chunks - 1;
+            error = nullptr;
+            generation++;
+        }
+        wake.notify_all();
+
+        size_t previous = detail::exchangeThreadBudget(1);
+        runAvailable(invoke, context, chunks);
+        detail::exchangeThreadBudget(previous);
+
+        std::exception_ptr failure;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            finished.wait(guard, [this] { return remaining == 0 && active == 0; });
+            helpers = 0;    // เธรดที่ตื่นช้าต้องไม่เข้าร่วมงานที่จบแล้ว (context อยู่บน stack ของผู้เรียก)
+            failure = error;
+            error = nullptr;
+        }
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+        return true;
+    }
+
+private:
+    void work() {
+        detail::exchangeThreadBudget(1);
+        unsigned long long seen = 0;
+        std::unique_lock<std::mutex> guard(lock);
+        for (;;) {
+            wake.wait(guard, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            if (helpers == 0) {
+                continue;   // งานนี้มีเธรดครบแล้ว
+            }
+            helpers--;
+            active++;
+            void (*invoke)(void*, size_t) = current;
+            void* context = currentContext;
+            size_t chunks = currentChunks;
+            guard.unlock();
+            runAvailable(invoke, context, chunks);
+            guard.lock();
+            active--;
+            if (remaining == 0 && active == 0) {
+                finished.notify_all();
+            }
+        }
+    }
+
+    void runAvailable(void (*invoke)(void*, size_t), void* context, size_t chunks) {
+        size_t done = 0;
+        for (size_t c = next.fetch_add(1, std::memory_order_relaxed); c < chunks;
+             c = next.fetch_add(1, std::memory_order_relaxed)) {
+            try {
+                invoke(context, c);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(lock);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+            done++;
+        }
+        if (done > 0) {
+            std::lock_guard<std::mutex> guard(lock);
+            remaining -= done;
+            if (remaining == 0 && active == 0) {
+                finished.notify_all();
+            }
+        }
+    }
+
+    std::mutex busy;                ///< ถือตลอดหนึ่งงาน
+    std::mutex lock;                ///< ป้องกันสถานะของงานด้านล่าง
+    std::condition_variable wake;
+    std::condition_variable finished;
+    std::vector<std::thread> threads;
+    void (*current)(void*, size_t) = nullptr;
+    void* currentContext = nullptr;
+    size_t currentChunks = 0;
+    std::atomic<size_t> next{0};
+    size_t remaining = 0;           ///< ก้อนที่ยังไม่เสร็จ
+    size_t helpers = 0;             ///< จำนวนเธรดที่ยังเข้าร่วมงานนี้ได้
+    size_t active = 0;              ///< เธรดที่กำลังทำงานนี้อยู่
+    unsigned long long generation = 0;
+    bool stopping = false;
+    std::exception_ptr error;
+};
+
+// เธรดชั่วคราวหนึ่งเธรดต่อก้อน เมื่อชุดเธรดถาวรไม่ว่าง
+void runOnNewThreads(size_t chunks, void (*invoke)(void*, size_t), void* context) {
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> errors(chunks);
+    workers.reserve(chunks - 1);
+    for (size_t c = 1; c < chunks; c++) {
+        workers.emplace_back([invoke, context, &errors, c]() {
+            detail::exchangeThreadBudget(1);
+            try {
+                invoke(context, c);
+            } catch (...) {
+                errors[c] = std::current_exception();
+            }
+        });
+    }
+    size_t previous = detail::exchangeThreadBudget(1);
+    try {
+        invoke(context, 0);
+    } catch (...) {
+        errors[0] = std::current_exception();
+    }
+    detail::exchangeThreadBudget(previous);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+} // namespace
+
+size_t maxThreads() {
+    size_t configured = configuredThreads.load();
+    if (configured > 0) {
+        return configured;
+    }
+    // hardware_concurrency อ่านข้อมูลจากระบบทุกครั้ง (หลายไมโครวินาที) จึงถามครั้งเดียว
+    static const size_t hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? hardware : 1;
+}
+
+void setMaxThreads(size_t threads) {
+    configuredThreads.store(threads);
+}
+
+size_t availableThreads() {
+    size_t limit = maxThreads();
+    return threadBudget > 0 && threadBudget < limit ? threadBudget : limit;
+}
+
+bool inParallelRegion() {
+    return threadBudget == 1;
+}
+
+namespace detail {
+
+size_t exchangeThreadBudget(size_t threads) {
+    size_t previous = threadBudget;
+    threadBudget = threads;
+    return previous;
+}
+
+void runChunks(size_t chunks, void (*invoke)(void*, size_t), void* context) {
+    static WorkerPool pool;
+    if (!pool.tryRun(chunks, invoke, context)) {
+        runOnNewThreads(chunks, invoke, context);
+    }
+}
+
+} // namespace detail
+
+} // namespace ai_language
@@ -0,0 +1,938 @@
+#include <gtest/gtest.h>
+#include "../include/dl/Conv.h"
+#include "../include/dl/DataLoader.h"
+#include "../include/dl/DataParallel.h"
+#include "../include/dl/Gemm.h"
+#include "../include/dl/Graph.h"
+#include "../include/dl/MemoryPlanner.h"
+#include "../include/dl/Network.h"
+#include "../include/dl/Optimizer.h"
+#include "../include/dl/Pool.h"
+#include "../include/dl/Tensor.h"
+#include "../include/ml/Dataset.h"
+#include "../include/utils/parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ai_language;
+
+// นับทุกการเรียก operator new ในโปรแกรมทดสอบ เพื่อตรวจว่ารอบการเทรนไม่จอง heap
+// แทนที่ครบทุกรูปแบบ (เดี่ยว อาร์เรย์ และแบบกำหนด alignment) ให้ทุกการจองถูกนับและคืนผ่านคู่ฟังก์ชันเดียวกัน
+namespace {
+std::atomic<size_t> heapCalls{0};
+
+// ไม่ให้ inline เข้าไปใน operator delete ที่จุดเรียก เพื่อไม่ให้ GCC จับคู่ new กับ free (-Wmismatched-new-delete)
+[[gnu::noinline]] void* countedAllocate(std::size_t size, std::size_t alignment) {
+    heapCalls++;
+    if (size == 0) {
+        size = 1;
+    }
+    void* memory = nullptr;
+    if (alignment <= alignof(std::max_align_t)) {
+        memory = std::malloc(size);
+    } else {
+        // aligned_alloc ต้องการขนาดที่เป็นพหุคูณของ alignment
+        memory = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    }
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+[[gnu::noinline]] void countedRelease(void* memory) noexcept {
+    std::free(memory);
+}
+}
+
+void* operator new(std::size_t size) {
+    return countedAllocate(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size) {
+    return countedAllocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept {
+    countedRelease(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    countedRelease(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    countedRelease(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    countedRelease(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+    countedRelease(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept {
+    countedRelease(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept {
+    countedRelease(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept {
+    countedRelease(memory);
+}
+
+TEST(HeapCounterTest, CountsArrayAndAlignedAllocations) {
+    struct alignas(64) Wide {
+        float lanes[16];
+    };
+    size_t before = heapCalls.load();
+    float* values = new float[8];
+    Wide* single = new Wide;
+    Wide* many = new Wide[3];
+    EXPECT_EQ(heapCalls.load() - before, 3u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(single) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(many) % 64, 0u);
+    delete[] many;
+    delete single;
+    delete[] values;
+}
+
+TEST(TensorTest, ViewsShareAlignedStorage) {
+    Tensor t({4, 6});
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(t.raw()) % Tensor::kAlignment, 0u);
+    EXPECT_EQ(t.numel(), 24u);
+    EXPECT_EQ(t.nbytes(), 96u);
+    EXPECT_EQ(t.strides(), (std::vector<size_t>{6, 1}));
+    EXPECT_TRUE(t.isContiguous());
+    EXPECT_FLOAT_EQ(t.at({3, 5}), 0.0f);
+    for (size_t i = 0; i < 4; i++) {
+        for (size_t j = 0; j < 6; j++) {
+            t.set({i, j}, static_cast<float>(i * 10 + j));
+        }
+    }
+
+    // มุมมองทุกแบบอ่านและเขียนบัฟเฟอร์เดียวกัน
+    Tensor columns = t.slice(1, 1, 6, 2);
+    EXPECT_EQ(columns.shape(), (std::vector<size_t>{4, 3}));
+    EXPECT_FALSE(columns.isContiguous());
+    EXPECT_FLOAT_EQ(columns.at({2, 1}), 23.0f);
+    columns.set({0, 0}, -1.0f);
+    EXPECT_FLOAT_EQ(t.at({0, 1}), -1.0f);
+
+    Tensor row = t.select(0, 2);
+    EXPECT_EQ(row.shape(), (std::vector<size_t>{6}));
+    EXPECT_TRUE(row.isContiguous());
+    EXPECT_EQ(row.data<float>(), t.data<float>() + 12);
+
+    Tensor transposed = t.transpose(0, 1);
+    EXPECT_FLOAT_EQ(transposed.at({5, 3}), 35.0f);
+    EXPECT_THROW(transposed.view({24}), std::invalid_argument);
+    Tensor packed = transposed.contiguous();
+    EXPECT_TRUE(packed.isContiguous());
+    EXPECT_NE(packed.raw(), t.raw());
+    EXPECT_FLOAT_EQ(packed.data<float>()[1], 10.0f);
+    EXPECT_EQ(t.view({2, 12}).raw(), t.raw());
+    EXPECT_EQ(packed.contiguous().raw(), packed.raw());
+
+    EXPECT_THROW(t.at({4, 0}), std::out_of_range);
+    EXPECT_THROW(t.slice(1, 4, 8), std::out_of_range);
+    EXPECT_THROW(t.view({5, 5}), std::invalid_argument);
+    EXPECT_THROW(t.data<int8_t>(), std::invalid_argument);
+
+    // wrap ไม่เป็นเจ้าของหน่วยความจำ
+    std::vector<float> external(8, 2.0f);
+    Tensor wrapped = Tensor::wrap(external.data(), {2, 4});
+    EXPECT_FALSE(wrapped.ownsStorage());
+    wrapped.slice(1, 0, 4, 3).fill(7.0f);
+    EXPECT_EQ(external, (std::vector<float>{7, 2, 2, 7, 7, 2, 2, 7}));
+    Tensor copy = wrapped.clone();
+    EXPECT_TRUE(copy.ownsStorage());
+    EXPECT_FLOAT_EQ(copy.at({1, 3}), 7.0f);
+}
+
+TEST(TensorTest, ConvertsBetweenElementTypes) {
+    // ปัดเศษไปหาเลขคู่: 1 + 2^-8 อยู่กึ่งกลางระหว่าง 1 กับ 1 + 2^-7
+    EXPECT_EQ(floatToBf16(1.0f + std::ldexp(1.0f, -8)), floatToBf16(1.0f));
+    EXPECT_EQ(floatToBf16(1.0f + 3 * std::ldexp(1.0f, -8)), floatToBf16(1.0f + std::ldexp(1.0f, -6)));
+    EXPECT_TRUE(std::isnan(bf16ToFloat(floatToBf16(std::numeric_limits<float>::quiet_NaN()))));
+    EXPECT_TRUE(std::isinf(bf16ToFloat(floatToBf16(std::numeric_limits<float>::infinity()))));
+
+    std::mt19937 rng(3);
+    std::normal_distribution<float> normal(0.0f, 100.0f);
+    std::vector<float> values(1003);
+    for (auto& value : values) {
+        value = normal(rng);
+    }
+    values[5] = std::numeric_limits<float>::quiet_NaN();
+    values[17] = -std::numeric_limits<float>::infinity();
+    std::vector<uint16_t> bulk(values.size());
+    floatToBf16(values.data(), bulk.data(), values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        ASSERT_EQ(bulk[i], floatToBf16(values[i])) << "at " << i;
+    }
+
+    Tensor source = Tensor::fromData(values.data(), {17, 59});
+    source.set({0, 5}, 1.0f);
+    source.set({0, 17}, 1.0f);
+    Tensor half = source.to(DType::BFloat16);
+    EXPECT_EQ(half.dtype(), DType::BFloat16);
+    EXPECT_EQ(half.nbytes(), source.numel() * 2);
+    Tensor back = half.to(DType::Float32);
+    for (size_t i = 0; i < source.numel(); i++) {
+        float x = source.data<float>()[i];
+        EXPECT_LE(std::fabs(back.data<float>()[i] - x), std::fabs(x) * std::ldexp(1.0f, -8));
+    }
+
+    // int8 แบบสมมาตร: ความคลาดเคลื่อนไม่เกินครึ่งหนึ่งของ scale ทั้งจาก Tensor ต่อเนื่องและมุมมองแบบ strided
+    Tensor strided = source.transpose(0, 1);
+    Tensor quantized = strided.to(DType::Int8);
+    float largest = 0.0f;
+    for (size_t i = 0; i < source.numel(); i++) {
+        largest = std::max(largest, std::fabs(source.data<float>()[i]));
+    }
+    EXPECT_FLOAT_EQ(quantized.quantScale(), largest / 127.0f);
+    for (size_t i = 0; i < 59; i++) {
+        for (size_t j = 0; j < 17; j++) {
+            EXPECT_NEAR(quantized.at({i, j}), source.at({j, i}), quantized.quantScale() * 0.5f + 1e-6f);
+        }
+    }
+}
+
+TEST(GraphTest, InfersShapesAndPlansReusedArena) {
+    std::vector<std::string> layers = {"input:28x28x1", "conv:8:3:relu", "pool:2x2", "conv:16:3:relu", "pool:2x2",
+                                       "flatten", "hidden:64:relu", "dropout:0.200000", "output:10:softmax"};
+    LayerGraph graph = LayerGraph::compile(layers, 32);
+    const auto& nodes = graph.nodes();
+    ASSERT_EQ(nodes.size(), layers.size());
+    EXPECT_EQ(nodes[0].outputShape, (std::vector<size_t>{1, 28, 28}));
+    EXPECT_EQ(nodes[1].outputShape, (std::vector<size_t>{8, 26, 26}));
+    EXPECT_EQ(nodes[4].outputShape, (std::vector<size_t>{16, 5, 5}));
+    EXPECT_EQ(nodes[5].outputShape, (std::vector<size_t>{400}));
+    EXPECT_EQ(graph.outputShape(), (std::vector<size_t>{10}));
+    EXPECT_EQ(graph.parameterCount(), (8 * 9 + 8) + (16 * 8 * 9 + 16) + (400 * 64 + 64) + (64 * 10 + 10));
+    EXPECT_EQ(graph.values()[nodes[5].output].aliasOf, static_cast<int>(nodes[4].output));
+    EXPECT_EQ(nodes[0].gradient, -1);   // ไม่มี gradient ของข้อมูลนำเข้า
+
+    // ค่าที่มีอายุซ้อนกันต้องไม่ทับกันใน arena และใช้พื้นที่น้อยกว่าแยกกันทั้งหมด
+    MemoryPlan plan = MemoryPlan::build(graph);
+    const auto& buffers = plan.buffers();
+    for (size_t a = 0; a < buffers.size(); a++) {
+        EXPECT_EQ(buffers[a].offset % Tensor::kAlignment, 0u);
+        EXPECT_LE(buffers[a].offset + buffers[a].bytes, plan.arenaBytes());
+        for (size_t b = a + 1; b < buffers.size(); b++) {
+            bool liveTogether = buffers[a].firstStep <= buffers[b].lastStep && buffers[b].firstStep <= buffers[a].lastStep;
+            bool sameBytes = buffers[a].offset < buffers[b].offset + buffers[b].bytes &&
+                             buffers[b].offset < buffers[a].offset + buffers[a].bytes;
+            EXPECT_FALSE(liveTogether && sameBytes) << graph.values()[buffers[a].value].name << " / "
+                                                    << graph.values()[buffers[b].value].name;
+        }
+    }
+    EXPECT_LT(plan.arenaBytes(), plan.naiveBytes());
+    // conv1 relu + pool2 ถูกรวมกัน: ผลลัพธ์เต็มขนาดของ conv1 หมดอายุหลัง forward ของ pool
+    // ส่วนผลลัพธ์ของ dense7 ต้องอยู่จนถึง backward ของชั้นเดียวกันเพื่อคำนวณอนุพันธ์ของ ReLU
+    EXPECT_TRUE(nodes[1].activationFused);
+    EXPECT_TRUE(nodes[2].fusedReLU);
+    EXPECT_EQ(graph.steps()[plan.bufferOf(nodes[1].output).lastStep].name, "forward pool2");
+    EXPECT_EQ(graph.values()[static_cast<size_t>(nodes[2].argmax)].dtype, DType::Int8);
+    EXPECT_EQ(graph.steps()[plan.bufferOf(nodes[6].output).lastStep].name, "backward dense6");
+
+    Tensor arena = plan.allocateArena();
+    Tensor flat = plan.bind(arena, nodes[5].output);
+    EXPECT_EQ(flat.shape(), (std::vector<size_t>{32, 400}));
+    EXPECT_EQ(flat.raw(), plan.bind(arena, nodes[4].output).raw());
+    EXPECT_EQ(plan.bind(arena, static_cast<size_t>(nodes[7].gradient)).shape(), (std::vector<size_t>{32, 64}));
+
+    // โหมดทำนายมีเฉพาะ forward จึงใช้หน่วยความจำน้อยกว่า
+    LayerGraph inference = LayerGraph::compile(layers, 32, false);
+    EXPECT_LT(MemoryPlan::build(inference).arenaBytes(), plan.arenaBytes());
+
+    // shape ไม่สอดคล้องถูกปฏิเสธตอนคอมไพล์
+    EXPECT_THROW(LayerGraph::compile({"input:28x28x1", "conv:8:3:relu", "hidden:64:relu"}, 32), std::invalid_argument);
+    EXPECT_THROW(LayerGraph::compile({"input:784:linear", "conv:8:3:relu"}, 32), std::invalid_argument);
+    EXPECT_THROW(LayerGraph::compile({"input:4x4x1", "conv:8:5:relu"}, 32), std::invalid_argument);
+    EXPECT_THROW(LayerGraph::compile({"hidden:8:relu", "output:3:softmax"}, 32), std::invalid_argument);
+    EXPECT_THROW(LayerGraph::compile({"input:4:linear", "output:3:softmax", "hidden:8:relu"}, 32), std::invalid_argument);
+    EXPECT_THROW(LayerGraph::compile({"input:4:linear", "hidden:8:swish"}, 32), std::invalid_argument);
+    try {
+        LayerGraph::compile({"input:8x8x3", "pool:2x2", "output:3:softmax"}, 16);
+        FAIL() << "dense on a 3-D input must be rejected";
+    } catch (const std::invalid_argument& e) {
+        EXPECT_NE(std::string(e.what()).find("Layer 3"), std::string::npos);
+        EXPECT_NE(std::string(e.what()).find("flatten"), std::string::npos);
+    }
+}
+
+TEST(GraphTest, InfersFlatInputFromFeatureCount) {
+    // ไม่ได้ประกาศ input: ใช้จำนวน features ของ CSV เป็น input แบบแบน
+    std::vector<std::string> layers = withInferredInput({"hidden:16:relu", "output:3:softmax"}, 5);
+    ASSERT_EQ(layers.size(), 3u);
+    EXPECT_EQ(layers.front(), "input:5:linear");
+    LayerGraph graph = LayerGraph::compile(layers, 8);
+    EXPECT_EQ(graph.nodes().front().spec.kind, LayerKind::Input);
+    EXPECT_EQ(graph.nodes().front().outputShape, (std::vector<size_t>{5}));
+    EXPECT_EQ(graph.parameterCount(), (5 * 16 + 16) + (16 * 3 + 3));
+
+    // input ที่ประกาศไว้แล้วไม่ถูกแทน แม้จำนวน features จะต่างกัน (ตรวจทีหลังตอนเตรียมข้อมูล)
+    std::vector<std::string> declared = {"input:28x28x1", "conv:8:3:relu", "pool:2x2", "flatten", "output:10:softmax"};
+    EXPECT_EQ(withInferredInput(declared, 5), declared);
+
+    // รูปภาพอนุมานจากจำนวน features ไม่ได้: conv หรือ pool ต้องมี input ที่ประกาศเอง
+    try {
+        withInferredInput({"conv:8:3:relu", "flatten", "output:2:softmax"}, 784);
+        FAIL() << "conv without a declared image input must be rejected";
+    } catch (const std::invalid_argument& e) {
+        EXPECT_NE(std::string(e.what()).find("Layer 1"), std::string::npos);
+        EXPECT_NE(std::string(e.what()).find("add layer input"), std::string::npos);
+    }
+    EXPECT_THROW(withInferredInput({"hidden:8:relu", "pool:2x2", "output:2:softmax"}, 16), std::invalid_argument);
+    EXPECT_THROW(withInferredInput({"hidden:8:relu", "output:2:softmax"}, 0), std::invalid_argument);
+}
+
+TEST(GemmTest, EveryKernelMatchesReferenceAcrossBlockEdges) {
+    struct Case {
+        bool transA, transB;
+        size_t m, n, k;
+        float alpha, beta;
+    };
+    // ขนาดที่ไม่ลงตัวกับ mr/nr และเกิน kc/mc/nc เพื่อให้ผ่านทุกกรณีขอบของการแบ่งบล็อก
+    std::vector<Case> cases = {{false, false, 37, 53, 300, 1.0f, 0.0f}, {true, false, 29, 41, 17, 0.5f, 1.0f},
+                               {false, true, 200, 33, 70, 1.0f, -0.5f}, {true, true, 13, 19, 257, 2.0f, 0.0f},
+                               {false, false, 7, 2100, 5, 1.0f, 0.0f},  {false, true, 1, 1, 1, 1.0f, 0.0f}};
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    for (GemmKernel kernel : {GemmKernel::Auto, GemmKernel::Scalar, GemmKernel::Avx2, GemmKernel::Avx512}) {
+        if (!gemmKernelSupported(kernel)) {
+            EXPECT_THROW(gemmBlocking(kernel), std::invalid_argument);
+            continue;
+        }
+        for (const Case& t : cases) {
+            size_t lda = (t.transA ? t.m : t.k) + 3, ldb = (t.transB ? t.k : t.n) + 1, ldc = t.n + 5;
+            std::vector<float> a((t.transA ? t.k : t.m) * lda), b((t.transB ? t.n : t.k) * ldb), c(t.m * ldc);
+            for (float& x : a) x = uniform(rng);
+            for (float& x : b) x = uniform(rng);
+            for (float& x : c) x = uniform(rng);
+            std::vector<float> expected = c;
+            for (size_t i = 0; i < t.m; i++) {
+                for (size_t j = 0; j < t.n; j++) {
+                    double sum = 0.0;
+                    for (size_t p = 0; p < t.k; p++) {
+                        sum += static_cast<double>(t.transA ? a[p * lda + i] : a[i * lda + p]) *
+                               (t.transB ? b[j * ldb + p] : b[p * ldb + j]);
+                    }
+                    expected[i * ldc + j] = static_cast<float>(t.alpha * sum + (t.beta == 0.0f ? 0.0 : t.beta * c[i * ldc + j]));
+                }
+            }
+            // beta = 0 ต้องไม่อ่าน C เดิม
+            if (t.beta == 0.0f) {
+                std::fill(c.begin(), c.end(), std::numeric_limits<float>::quiet_NaN());
+            }
+            sgemm(t.transA, t.transB, t.m, t.n, t.k, t.alpha, a.data(), lda, b.data(), ldb, t.beta, c.data(), ldc, kernel);
+            for (size_t i = 0; i < t.m; i++) {
+                for (size_t j = 0; j < t.n; j++) {
+                    ASSERT_NEAR(c[i * ldc + j], expected[i * ldc + j], 1e-4f * (1.0f + t.k))
+                        << gemmKernelName(kernel) << " " << t.m << "x" << t.n << "x" << t.k << " at " << i << "," << j;
+                }
+                // คอลัมน์ระหว่าง n กับ ldc ต้องไม่ถูกแตะ
+                for (size_t j = t.n; j < ldc; j++) {
+                    ASSERT_TRUE(std::isnan(c[i * ldc + j]) || c[i * ldc + j] == expected[i * ldc + j]);
+                }
+            }
+        }
+    }
+
+    // matmul บน Tensor รับมุมมองที่สลับแกนโดยไม่คัดลอก
+    Tensor x({5, 7}), w({3, 7}), y({5, 3});
+    for (size_t i = 0; i < 5; i++) for (size_t j = 0; j < 7; j++) x.set({i, j}, uniform(rng));
+    for (size_t i = 0; i < 3; i++) for (size_t j = 0; j < 7; j++) w.set({i, j}, uniform(rng));
+    matmul(x, w.transpose(0, 1), y);
+    Tensor z({5, 3});
+    matmul(x, w, z, false, true);
+    for (size_t i = 0; i < 5; i++) {
+        for (size_t j = 0; j < 3; j++) {
+            float sum = 0.0f;
+            for (size_t p = 0; p < 7; p++) sum += x.at({i, p}) * w.at({j, p});
+            EXPECT_NEAR(y.at({i, j}), sum, 1e-5f);
+            EXPECT_NEAR(z.at({i, j}), sum, 1e-5f);
+        }
+    }
+    EXPECT_THROW(matmul(x, w, y), std::invalid_argument);
+    EXPECT_THROW(sgemm(false, false, 4, 4, 4, 1.0f, x.data<float>(), 2, x.data<float>(), 4, 0.0f, y.data<float>(), 4),
+                 std::invalid_argument);
+}
+
+TEST(GemmTest, Bf16KernelsMatchRoundedReference) {
+    struct Case {
+        bool transA, transB;
+        size_t m, n, k;
+        float alpha, beta;
+    };
+    // k คี่ให้คู่ตามแนว K ของ B มีช่องเติมศูนย์ ส่วน 33 และ 300 เกินไทล์ 32 ของ AMX และ kc
+    std::vector<Case> cases = {{false, false, 37, 53, 301, 1.0f, 0.0f}, {true, false, 29, 41, 17, 0.5f, 1.0f},
+                               {false, true, 70, 33, 64, 1.0f, 1.0f},   {true, true, 13, 19, 257, 2.0f, -0.5f},
+                               {false, false, 64, 64, 32, 1.0f, 0.0f},  {false, true, 1, 1, 1, 1.0f, 0.0f}};
+    std::mt19937 rng(13);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    auto rounded = [](float x) { return bf16ToFloat(floatToBf16(x)); };
+    for (GemmKernel kernel : {GemmKernel::Auto, GemmKernel::Scalar, GemmKernel::Avx2, GemmKernel::Avx512,
+                              GemmKernel::Avx512Bf16, GemmKernel::AmxBf16}) {
+        if (!gemmKernelSupported(kernel)) {
+            EXPECT_THROW(gemmBlocking(kernel), std::invalid_argument);
+            continue;
+        }
+        for (size_t index = 0; index < cases.size(); index++) {
+            const Case& t = cases[index];
+            size_t lda = (t.transA ? t.m : t.k) + 3, ldb = (t.transB ? t.k : t.n) + 1, ldc = t.n + 5;
+            std::vector<float> a((t.transA ? t.k : t.m) * lda), b((t.transB ? t.n : t.k) * ldb), c(t.m * ldc);
+            for (float& x : a) x = uniform(rng);
+            for (float& x : b) x = uniform(rng);
+            for (float& x : c) x = uniform(rng);
+            // กรณีคู่ให้ B เป็น bf16 อยู่แล้ว (เช่นสำเนา weight ของ dense) กรณีคี่ให้ทั้งสองเป็น float32
+            std::vector<uint16_t> b16(b.size());
+            floatToBf16(b.data(), b16.data(), b.size());
+            GemmOperand opA(a.data(), lda, t.transA);
+            GemmOperand opB = index % 2 == 0 ? GemmOperand(b16.data(), ldb, t.transB) : GemmOperand(b.data(), ldb, t.transB);
+            std::vector<float> expected = c;
+            for (size_t i = 0; i < t.m; i++) {
+                for (size_t j = 0; j < t.n; j++) {
+                    double sum = 0.0;
+                    for (size_t p = 0; p < t.k; p++) {
+                        sum += static_cast<double>(rounded(t.transA ? a[p * lda + i] : a[i * lda + p])) *
+                               rounded(t.transB ? b[j * ldb + p] : b[p * ldb + j]);
+                    }
+                    expected[i * ldc + j] = static_cast<float>(t.alpha * sum + (t.beta == 0.0f ? 0.0 : t.beta * c[i * ldc + j]));
+                }
+            }
+            if (t.beta == 0.0f) {
+                std::fill(c.begin(), c.end(), std::numeric_limits<float>::quiet_NaN());
+            }
+            gemm(t.m, t.n, t.k, t.alpha, opA, opB, t.beta, c.data(), ldc, GemmEpilogue(), GemmPrecision::BFloat16, kernel);
+            for (size_t i = 0; i < t.m; i++) {
+                for (size_t j = 0; j < t.n; j++) {
+                    ASSERT_NEAR(c[i * ldc + j], expected[i * ldc + j], 1e-4f * (1.0f + t.k))
+                        << gemmKernelName(kernel) << " " << t.m << "x" << t.n << "x" << t.k << " at " << i << "," << j;
+                }
+                for (size_t j = t.n; j < ldc; j++) {
+                    ASSERT_TRUE(std::isnan(c[i * ldc + j]) || c[i * ldc + j] == expected[i * ldc + j]);
+                }
+            }
+        }
+    }
+
+    // Float32 ไม่ปัดตัวถูกคูณ float32 และไม่ยอมรับ kernel ของ bf16
+    std::vector<float> a = {1.0f + 1.0f / 512.0f, 2.0f}, b = {3.0f, 0.5f}, c(1);
+    gemm(1, 1, 2, 1.0f, GemmOperand(a.data(), 2), GemmOperand(b.data(), 1), 0.0f, c.data(), 1);
+    EXPECT_FLOAT_EQ(c[0], 3.0f * a[0] + 1.0f);
+    gemm(1, 1, 2, 1.0f, GemmOperand(a.data(), 2), GemmOperand(b.data(), 1), 0.0f, c.data(), 1, GemmEpilogue(),
+         GemmPrecision::BFloat16);
+    EXPECT_FLOAT_EQ(c[0], 4.0f);   // 1 + 2^-9 ปัดเป็น 1 ใน bf16
+    EXPECT_THROW(gemm(1, 1, 2, 1.0f, GemmOperand(a.data(), 2), GemmOperand(b.data(), 1), 0.0f, c.data(), 1,
+                      GemmEpilogue(), GemmPrecision::Float32, GemmKernel::AmxBf16),
+                 std::invalid_argument);
+    EXPECT_EQ(parseGemmPrecision("bf16"), GemmPrecision::BFloat16);
+    EXPECT_EQ(parseGemmPrecision("FP32"), GemmPrecision::Float32);
+    EXPECT_THROW(parseGemmPrecision("fp16"), std::invalid_argument);
+}
+
+TEST(ConvTest, Im2colAndWinogradMatchDirectConvolution) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    setMaxThreads(3);   // workspace มีที่ให้สองเธรด: ต้องใช้ไม่เกินนั้นแม้จะมีเธรดมากกว่า
+    // 11x9 ให้ผลลัพธ์ขนาดคี่ (ไทล์ Winograd เกินขอบ) และ 40x40 หลาย channel ให้ im2col แบ่งหลายไทล์
+    for (ConvShape shape : {ConvShape{2, 11, 9, 3, 3}, ConvShape{17, 40, 40, 5, 3}, ConvShape{3, 8, 10, 4, 5}}) {
+        const size_t batch = 3, oh = shape.outHeight(), ow = shape.outWidth(), k = shape.kernel;
+        std::vector<float> x(batch * shape.channels * shape.height * shape.width), w(shape.filters * shape.patch()),
+            bias(shape.filters), dy(batch * shape.filters * oh * ow);
+        for (auto* v : {&x, &w, &bias, &dy}) for (float& e : *v) e = uniform(rng);
+
+        // อ้างอิง: convolution ตรงตามนิยาม
+        std::vector<float> y(dy.size()), dx(x.size(), 0.0f), dw(w.size(), 0.0f), db(bias.size(), 0.0f);
+        auto xAt = [&](size_t n, size_t c, size_t i, size_t j) {
+            return ((n * shape.channels + c) * shape.height + i) * shape.width + j;
+        };
+        for (size_t n = 0; n < batch; n++) {
+            for (size_t f = 0; f < shape.filters; f++) {
+                for (size_t i = 0; i < oh; i++) {
+                    for (size_t j = 0; j < ow; j++) {
+                        size_t o = ((n * shape.filters + f) * oh + i) * ow + j;
+                        double sum = bias[f];
+                        for (size_t c = 0; c < shape.channels; c++) {
+                            for (size_t p = 0; p < k; p++) {
+                                for (size_t q = 0; q < k; q++) {
+                                    size_t wi = ((f * shape.channels + c) * k + p) * k + q;
+                                    sum += w[wi] * x[xAt(n, c, i + p, j + q)];
+                                    dx[xAt(n, c, i + p, j + q)] += w[wi] * dy[o];
+                                    dw[wi] += x[xAt(n, c, i + p, j + q)] * dy[o];
+                                }
+                            }
+                        }
+                        y[o] = static_cast<float>(sum);
+                        db[f] += dy[o];
+                    }
+                }
+            }
+        }
+
+        for (ConvAlgorithm algorithm : {ConvAlgorithm::Im2col, ConvAlgorithm::Winograd}) {
+            if (algorithm == ConvAlgorithm::Winograd && !winogradSupported(shape)) {
+                EXPECT_THROW(convForward(shape, batch, x.data(), w.data(), nullptr, y.data(), nullptr,
+                                         convWorkspaceFloats(shape, ConvAlgorithm::Im2col, false, 1), algorithm),
+                             std::invalid_argument);
+                continue;
+            }
+            std::vector<float> workspace(convWorkspaceFloats(shape, algorithm, true, 2));
+            std::vector<float> out(y.size()), gx(x.size()), gw(w.size()), gb(bias.size());
+            convForward(shape, batch, x.data(), w.data(), bias.data(), out.data(), workspace.data(), workspace.size(),
+                        algorithm);
+            convBackward(shape, batch, x.data(), w.data(), dy.data(), gx.data(), gw.data(), gb.data(),
+                         workspace.data(), workspace.size(), algorithm);
+            const float tolerance = 1e-4f * shape.patch();
+            for (size_t i = 0; i < y.size(); i++) ASSERT_NEAR(out[i], y[i], tolerance) << convAlgorithmName(algorithm);
+            for (size_t i = 0; i < x.size(); i++) ASSERT_NEAR(gx[i], dx[i], tolerance) << convAlgorithmName(algorithm);
+            for (size_t i = 0; i < w.size(); i++) ASSERT_NEAR(gw[i], dw[i], 1e-3f * dy.size() / shape.filters);
+            for (size_t i = 0; i < bias.size(); i++) ASSERT_NEAR(gb[i], db[i], 1e-3f * dy.size() / shape.filters);
+
+            // input และผลลัพธ์ bf16 (ผลรวมสะสมเป็นไทล์ใน workspace) = ผลลัพธ์ float32 ของ input ที่ปัดแล้ว ปัดลงอีกครั้ง
+            std::vector<uint16_t> x16(x.size()), out16(y.size());
+            std::vector<float> rounded(x.size());
+            floatToBf16(x.data(), x16.data(), x.size());
+            bf16ToFloat(x16.data(), rounded.data(), x.size());
+            std::vector<float> half(convWorkspaceFloats(shape, algorithm, false, 2, DType::BFloat16));
+            convForward(shape, batch, rounded.data(), w.data(), bias.data(), out.data(), workspace.data(),
+                        workspace.size(), algorithm);
+            convForward(shape, batch, x16.data(), w.data(), bias.data(), out16.data(), half.data(), half.size(),
+                        algorithm);
+            for (size_t i = 0; i < y.size(); i++) ASSERT_EQ(out16[i], floatToBf16(out[i])) << convAlgorithmName(algorithm);
+        }
+        ConvChoice choice = selectConvAlgorithm(shape);
+        EXPECT_GT(choice.im2colMillis, 0.0);
+        EXPECT_EQ(choice.winogradMillis > 0.0, winogradSupported(shape));
+    }
+    setMaxThreads(0);
+    // workspace ต้องพออย่างน้อยหนึ่งเธรด
+    ConvShape shape{1, 4, 4, 1, 3};
+    std::vector<float> x(16), w(9), y(4), small(1);
+    EXPECT_THROW(convForward(shape, 1, x.data(), w.data(), nullptr, y.data(), small.data(), small.size()),
+                 std::invalid_argument);
+}
+
+TEST(FusedKernelsTest, EpilogueAndReluPoolMatchSeparatePasses) {
+    std::mt19937 rng(13);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    auto random = [&](size_t n) {
+        std::vector<float> v(n);
+        for (float& x : v) x = uniform(rng);
+        return v;
+    };
+
+    // epilogue ทำหลังบล็อก K สุดท้ายเท่านั้น (k = 300 มีสองบล็อก) ทั้ง bias ตามแถวและตามคอลัมน์
+    const size_t m = 37, n = 45, k = 300;
+    std::vector<float> a = random(m * k), b = random(k * n), rowBias = random(m), colBias = random(n);
+    std::vector<float> plain(m * n), fused(m * n);
+    sgemm(false, false, m, n, k, 1.0f, a.data(), k, b.data(), n, 0.0f, plain.data(), n);
+    GemmEpilogue epilogue;
+    epilogue.rowBias = rowBias.data();
+    epilogue.activation = Activation::ReLU;
+    sgemm(false, false, m, n, k, 1.0f, a.data(), k, b.data(), n, 0.0f, fused.data(), n, epilogue);
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            ASSERT_NEAR(fused[i * n + j], std::max(plain[i * n + j] + rowBias[i], 0.0f), 1e-4f);
+        }
+    }
+    epilogue = GemmEpilogue{};
+    epilogue.columnBias = colBias.data();
+    epilogue.activation = Activation::Tanh;
+    sgemm(false, false, m, n, k, 1.0f, a.data(), k, b.data(), n, 0.0f, fused.data(), n, epilogue);
+    for (size_t i = 0; i < m * n; i++) {
+        ASSERT_NEAR(fused[i], std::tanh(plain[i] + colBias[i % n]), 1e-4f);
+    }
+    epilogue.activation = Activation::Softmax;
+    EXPECT_THROW(sgemm(false, false, m, n, k, 1.0f, a.data(), k, b.data(), n, 0.0f, fused.data(), n, epilogue),
+                 std::invalid_argument);
+
+    // conv + bias + ReLU ในรอบเดียวตรงกับ conv แล้วทำ ReLU แยก ทั้งสองวิธี
+    ConvShape conv{4, 9, 11, 6, 3};
+    const size_t batch = 2, positions = conv.outHeight() * conv.outWidth();
+    std::vector<float> x = random(batch * conv.channels * conv.height * conv.width), w = random(conv.filters * conv.patch()),
+        bias = random(conv.filters);
+    std::vector<float> workspace(convWorkspaceFloats(conv, ConvAlgorithm::Auto, false, 1));
+    std::vector<float> linear(batch * conv.filters * positions), activated(linear.size());
+    for (ConvAlgorithm algorithm : {ConvAlgorithm::Im2col, ConvAlgorithm::Winograd}) {
+        convForward(conv, batch, x.data(), w.data(), bias.data(), linear.data(), workspace.data(), workspace.size(),
+                    algorithm);
+        convForward(conv, batch, x.data(), w.data(), bias.data(), activated.data(), workspace.data(), workspace.size(),
+                    algorithm, Activation::ReLU);
+        for (size_t i = 0; i < linear.size(); i++) {
+            ASSERT_EQ(activated[i], std::max(linear[i], 0.0f)) << convAlgorithmName(algorithm);
+        }
+    }
+
+    // pool ที่รวม ReLU: ผลลัพธ์และ gradient เท่ากับ ReLU แยก + pool (ขอบ 7x9 ที่เหลือไม่ครบหน้าต่างถูกตัด)
+    PoolShape pool{3, 7, 9, 2, 3};
+    const size_t planes = batch * pool.channels, inSize = planes * pool.height * pool.width;
+    const size_t outSize = planes * pool.outHeight() * pool.outWidth();
+    std::vector<float> y = random(inSize), relu(inSize), dy = random(outSize);
+    for (size_t i = 0; i < inSize; i++) relu[i] = std::max(y[i], 0.0f);
+    std::vector<float> separate(outSize), together(outSize), dxSeparate(inSize), dxTogether(inSize);
+    std::vector<uint8_t> argSeparate(outSize), argTogether(outSize);
+    maxPoolForward(pool, batch, relu.data(), separate.data(), argSeparate.data());
+    maxPoolForward(pool, batch, y.data(), together.data(), argTogether.data(), true);
+    EXPECT_EQ(separate, together);
+    maxPoolBackward(pool, batch, dy.data(), argSeparate.data(), nullptr, false, dxSeparate.data());
+    activationBackward(relu.data(), dxSeparate.data(), inSize, Activation::ReLU);
+    maxPoolBackward(pool, batch, dy.data(), argTogether.data(), together.data(), true, dxTogether.data());
+    EXPECT_EQ(dxSeparate, dxTogether);
+    EXPECT_THROW(maxPoolForward(PoolShape{1, 20, 20, 17, 17}, 1, y.data(), together.data(), nullptr),
+                 std::invalid_argument);
+}
+
+TEST(AutogradTest, GradientsMatchFiniteDifferencesWithoutStepAllocations) {
+    const size_t batch = 4;
+    LayerGraph graph = LayerGraph::compile(
+        {"input:6x6x2", "conv:3:3:relu", "pool:2x2", "flatten", "dense:5:tanh", "output:3:softmax"}, batch);
+    Network network(graph, 5);
+    ASSERT_EQ(network.inputSize(), 72u);
+    ASSERT_EQ(network.outputSize(), 3u);
+    ASSERT_EQ(network.parameterCount(), graph.parameterCount());
+
+    std::mt19937 rng(21);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    std::vector<float> inputs(batch * network.inputSize()), targets(batch * network.outputSize(), 0.0f);
+    for (float& v : inputs) v = uniform(rng);
+    for (size_t i = 0; i < batch; i++) targets[i * 3 + i % 3] = 1.0f;
+
+    // gradient จาก tape เทียบกับผลต่างสองข้างของ loss ทุก ๆ 5 พารามิเตอร์ (ครอบคลุมทุกชั้น)
+    network.computeGradients(inputs.data(), targets.data(), batch);
+    network.endStep();
+    std::vector<float> analytic(network.gradients().data<float>(),
+                                network.gradients().data<float>() + network.parameterCount());
+    float* w = network.parameters().data<float>();
+    const float eps = 1e-2f;
+    size_t checked = 0;
+    for (size_t i = 0; i < network.parameterCount(); i += 5) {
+        float original = w[i];
+        w[i] = original + eps;
+        float plus = network.evaluate(inputs.data(), targets.data(), batch);
+        w[i] = original - eps;
+        float minus = network.evaluate(inputs.data(), targets.data(), batch);
+        w[i] = original;
+        float numeric = (plus - minus) / (2.0f * eps);
+        EXPECT_NEAR(analytic[i], numeric, 2e-3f + 0.05f * std::fabs(numeric)) << "parameter " << i;
+        checked++;
+    }
+    EXPECT_GT(checked, 20u);
+
+    // ความน่าจะเป็นรวมเป็นหนึ่ง, หลังรอบแรกไม่มีการจอง heap และการเทรนลด loss
+    std::vector<float> predictions(batch * 3);
+    float before = network.evaluate(inputs.data(), targets.data(), batch, predictions.data());
+    EXPECT_NEAR(predictions[0] + predictions[1] + predictions[2], 1.0f, 1e-5f);
+    OptimizerConfig sgd;
+    sgd.kind = OptimizerKind::SGD;
+    sgd.learningRate = 0.1f;
+    Optimizer optimizer(sgd, network.parameterCount());
+    setMaxThreads(4);   // นับรวมการแบ่งงานของ parallelFor ด้วย ไม่ใช่แค่ arena
+    network.trainStep(inputs.data(), targets.data(), batch, optimizer);
+    size_t heapBefore = heapCalls.load();
+    for (int step = 0; step < 20; step++) {
+        network.trainStep(inputs.data(), targets.data(), batch, optimizer);
+    }
+    size_t heapDuring = heapCalls.load() - heapBefore;
+    setMaxThreads(0);
+    EXPECT_EQ(heapDuring, 0u);
+    EXPECT_EQ(network.lastStepHeapAllocations(), 0u);
+    EXPECT_LT(network.evaluate(inputs.data(), targets.data(), batch), before);
+
+    EXPECT_THROW(Network(LayerGraph::compile({"input:4", "output:2:softmax"}, 2, false)), std::invalid_argument);
+}
+
+TEST(OptimizerTest, FusedUpdatesMatchPerElementReference) {
+    // จำนวนที่ไม่ลงตัวกับ lane และหลายก้อนของ parallelFor
+    const size_t n = 100003;
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    std::vector<float> start(n);
+    for (float& v : start) v = uniform(rng);
+    std::vector<std::vector<float>> grads(3, std::vector<float>(n));
+    for (auto& g : grads) {
+        for (float& v : g) v = uniform(rng);
+    }
+
+    setMaxThreads(3);
+    for (OptimizerKind kind : {OptimizerKind::SGD, OptimizerKind::Momentum, OptimizerKind::Adam, OptimizerKind::AdamW}) {
+        OptimizerConfig config;
+        config.kind = kind;
+        config.learningRate = 0.01f;
+        config.weightDecay = 0.05f;
+        config.clipNorm = 50.0f;    // norm ของ gradient สุ่มประมาณ 180 จึงถูก clip ทุกรอบ
+        Optimizer optimizer(config, n);
+        std::vector<float> w = start;
+        std::vector<double> ref(start.begin(), start.end()), m(n, 0.0), v(n, 0.0);
+        for (size_t t = 1; t <= grads.size(); t++) {
+            const std::vector<float>& g = grads[t - 1];
+            double total = 0.0;
+            for (float x : g) total += static_cast<double>(x) * x;
+            double norm = std::sqrt(total), scale = std::min(1.0, config.clipNorm / norm);
+            EXPECT_NEAR(optimizer.step(w.data(), g.data()), norm, 1e-3 * norm);
+            for (size_t i = 0; i < n; i++) {
+                double grad = g[i] * scale + (kind == OptimizerKind::AdamW ? 0.0 : config.weightDecay * ref[i]);
+                if (kind == OptimizerKind::SGD) {
+                    ref[i] -= config.learningRate * grad;
+                } else if (kind == OptimizerKind::Momentum) {
+                    m[i] = config.momentum * m[i] + grad;
+                    ref[i] -= config.learningRate * m[i];
+                } else {
+                    m[i] = config.beta1 * m[i] + (1 - config.beta1) * grad;
+                    v[i] = config.beta2 * v[i] + (1 - config.beta2) * grad * grad;
+                    double mHat = m[i] / (1 - std::pow(config.beta1, t)), vHat = v[i] / (1 - std::pow(config.beta2, t));
+                    if (kind == OptimizerKind::AdamW) {
+                        ref[i] -= config.learningRate * config.weightDecay * ref[i];
+                    }
+                    ref[i] -= config.learningRate * mHat / (std::sqrt(vHat) + config.epsilon);
+                }
+            }
+        }
+        for (size_t i = 0; i < n; i++) {
+            ASSERT_NEAR(w[i], ref[i], 1e-5) << optimizerName(kind) << " at " << i;
+        }
+        EXPECT_EQ(optimizer.steps(), 3u);
+    }
+    setMaxThreads(0);
+
+    // gradient ที่ไม่เป็นจำนวนจำกัดไม่แตะ weight
+    OptimizerConfig adam;
+    adam.clipNorm = 1.0f;
+    Optimizer optimizer(adam, n);
+    std::vector<float> w = start, bad = grads[0];
+    bad[n / 2] = std::numeric_limits<float>::infinity();
+    EXPECT_FALSE(std::isfinite(optimizer.step(w.data(), bad.data())));
+    EXPECT_EQ(w, start);
+    EXPECT_EQ(optimizer.steps(), 0u);
+    EXPECT_EQ(optimizer.stateBytes(), 2 * n * sizeof(float));
+
+    EXPECT_EQ(parseOptimizer("AdamW"), OptimizerKind::AdamW);
+    EXPECT_THROW(parseOptimizer("rmsprop"), std::invalid_argument);
+    adam.beta2 = 1.0f;
+    EXPECT_THROW(Optimizer(adam, n), std::invalid_argument);
+}
+
+TEST(DataParallelTest, ShardedStepMatchesSingleModel) {
+    // 200 x 512 ให้ gradient มากกว่า 16 ก้อนของ all-reduce จึงรวมแบบหลายเธรดจริง และ batch 10 แบ่งเป็น 3/3/4
+    LayerGraph graph = LayerGraph::compile({"input:200", "dense:512:relu", "output:3:softmax"}, 10);
+    const size_t batch = 10;
+    std::mt19937 rng(29);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    std::vector<float> inputs(batch * 200), targets(batch * 3, 0.0f);
+    for (float& v : inputs) v = uniform(rng);
+    for (size_t i = 0; i < batch; i++) targets[i * 3 + (i * 7) % 3] = 1.0f;
+
+    OptimizerConfig config;
+    config.kind = OptimizerKind::Momentum;
+    config.learningRate = 0.05f;
+    Network single(graph);
+    Optimizer singleOptimizer(config, single.parameterCount());
+    setMaxThreads(3);
+    DataParallelTrainer trainer(graph, 3);
+    Optimizer sharedOptimizer(config, trainer.model().parameterCount());
+    EXPECT_EQ(trainer.replicaCount(), 3u);
+    for (int step = 0; step < 3; step++) {
+        float expected = single.trainStep(inputs.data(), targets.data(), batch, singleOptimizer);
+        EXPECT_NEAR(trainer.step(inputs.data(), targets.data(), batch, sharedOptimizer), expected, 1e-5f);
+    }
+    const float* a = single.parameters().data<float>();
+    const float* b = trainer.model().parameters().data<float>();
+    for (size_t i = 0; i < single.parameterCount(); i++) {
+        ASSERT_NEAR(a[i], b[i], 1e-5f) << "parameter " << i;
+    }
+    EXPECT_NEAR(trainer.evaluate(inputs.data(), targets.data(), batch),
+                single.evaluate(inputs.data(), targets.data(), batch), 1e-5f);
+    // หลังรอบแรก ๆ การแบ่ง batch, all-reduce และ optimizer บนหลายเธรดไม่จอง heap (parallelFor ใช้ชุดเธรดถาวร)
+    size_t heapBefore = heapCalls.load();
+    for (int step = 0; step < 5; step++) {
+        trainer.step(inputs.data(), targets.data(), batch, sharedOptimizer);
+    }
+    EXPECT_EQ(heapCalls.load() - heapBefore, 0u);
+    // batch ที่เล็กกว่าจำนวนแบบจำลองใช้เท่าที่มีตัวอย่าง
+    EXPECT_NO_THROW(trainer.step(inputs.data(), targets.data(), 2, sharedOptimizer));
+
+    std::vector<ScalingPoint> points = measureScaling(graph, inputs.data(), targets.data(), batch, 3, 1);
+    ASSERT_EQ(points.size(), 3u);
+    EXPECT_EQ(points[0].threads, 1u);
+    EXPECT_EQ(points[2].threads, 3u);
+    EXPECT_DOUBLE_EQ(points[0].efficiency, 1.0);
+    EXPECT_GT(points[2].millisPerStep, 0.0);
+    EXPECT_EQ(maxThreads(), 3u);
+    setMaxThreads(0);
+}
+
+TEST(DataLoaderTest, PrefetchedBatchesMatchSynchronousGather) {
+    // 103 ตัวอย่าง batch 10: 11 batch ต่อ epoch โดย batch สุดท้ายมี 3 ตัวอย่าง
+    const size_t samples = 103, features = 5, outputs = 2;
+    std::mt19937 rng(31);
+    std::uniform_real_distribution<float> uniform(-3.0f, 7.0f);
+    std::vector<float> inputs(samples * features), targets(samples * outputs);
+    for (float& v : inputs) v = uniform(rng);
+    for (float& v : targets) v = uniform(rng);
+    FeatureScaling scaling = standardization(inputs.data(), samples, features);
+    ASSERT_EQ(scaling.offset.size(), features);
+
+    for (size_t prefetch : {1u, 4u}) {
+        DataLoaderConfig config;
+        config.batchSize = 10;
+        config.prefetch = prefetch;
+        config.epochs = 3;
+        config.seed = 5;
+        DataLoader loader(inputs.data(), targets.data(), samples, features, outputs, config, scaling);
+        EXPECT_EQ(loader.batchesPerEpoch(), 11u);
+
+        // อ้างอิง: สลับและรวบแบบลำดับในเธรดเดียวกัน
+        std::vector<size_t> order(samples);
+        for (size_t i = 0; i < samples; i++) order[i] = i;
+        std::mt19937 shuffler(config.seed);
+        DataLoader::Batch batch;
+        size_t delivered = 0;
+        for (size_t epoch = 0; epoch < config.epochs; epoch++) {
+            std::shuffle(order.begin(), order.end(), shuffler);
+            std::vector<float> column(features, 0.0f);
+            for (size_t index = 0; index < loader.batchesPerEpoch(); index++) {
+                ASSERT_TRUE(loader.next(batch));
+                delivered++;
+                EXPECT_EQ(batch.epoch, epoch);
+                EXPECT_EQ(batch.index, index);
+                EXPECT_EQ(reinterpret_cast<uintptr_t>(batch.inputs) % 64, 0u);
+                ASSERT_EQ(batch.size, std::min<size_t>(10, samples - index * 10));
+                for (size_t i = 0; i < batch.size; i++) {
+                    size_t row = order[index * 10 + i];
+                    for (size_t j = 0; j < features; j++) {
+                        float expected = (inputs[row * features + j] - scaling.offset[j]) * scaling.scale[j];
+                        ASSERT_FLOAT_EQ(batch.inputs[i * features + j], expected);
+                        column[j] += batch.inputs[i * features + j];
+                    }
+                    for (size_t j = 0; j < outputs; j++) {
+                        ASSERT_EQ(batch.targets[i * outputs + j], targets[row * outputs + j]);
+                    }
+                }
+            }
+            // ทุกตัวอย่างถูกส่งครั้งเดียวต่อ epoch ค่าเฉลี่ยหลัง standardize จึงเป็นศูนย์
+            for (size_t j = 0; j < features; j++) {
+                EXPECT_NEAR(column[j] / samples, 0.0f, 1e-4f);
+            }
+        }
+        EXPECT_FALSE(loader.next(batch));
+        EXPECT_EQ(delivered, 33u);
+        EXPECT_LE(loader.stalls(), delivered - 1);
+    }
+
+    // ไม่สลับ: ลำดับเดิม และทำลายก่อนครบ epoch โดยไม่ค้าง
+    DataLoaderConfig sequential;
+    sequential.batchSize = 4;
+    sequential.shuffle = false;
+    sequential.epochs = 100;
+    DataLoader loader(inputs.data(), targets.data(), samples, features, outputs, sequential);
+    DataLoader::Batch batch;
+    ASSERT_TRUE(loader.next(batch));
+    ASSERT_TRUE(loader.next(batch));
+    EXPECT_EQ(batch.inputs[0], inputs[4 * features]);
+    EXPECT_THROW(DataLoader(inputs.data(), targets.data(), samples, features + 1, outputs, sequential, scaling),
+                 std::invalid_argument);
+}
+
+TEST(MixedPrecisionTest, LossMatchesFloat32OnBundledExamples) {
+    // เทรนสองแบบจำลองจาก seed เดียวกัน (ค่าเริ่มต้นและ dropout เหมือนกัน) ต่างกันแค่ precision
+    auto train = [](const std::vector<std::string>& layers, size_t batch, const std::vector<float>& inputs,
+                    const std::vector<float>& targets, size_t steps, GemmPrecision precision) {
+        LayerGraph graph = LayerGraph::compile(layers, batch);
+        Network network(graph, 42, precision);
+        EXPECT_EQ(network.precision(), precision);
+        OptimizerConfig config;
+        Optimizer optimizer(config, network.parameterCount());
+        const size_t samples = inputs.size() / network.inputSize(), in = network.inputSize(), out = network.outputSize();
+        std::vector<float> losses;
+        for (size_t s = 0; s < steps; s++) {
+            size_t first = s * batch % samples, count = std::min(batch, samples - first);
+            losses.push_back(network.trainStep(inputs.data() + first * in, targets.data() + first * out, count, optimizer));
+        }
+        losses.push_back(network.evaluate(inputs.data(), targets.data(), samples));
+        return losses;
+    };
+
+    // neural_network.ai: iris.csv ที่มากับโปรเจกต์ ปรับสเกลแบบเดียวกับ train
+    std::string root(__FILE__);
+    root = root.substr(0, root.rfind("tests"));
+    Dataset iris;
+    std::string error;
+    ASSERT_TRUE(loadCsvDataset(root + "datasets/iris.csv", "species", iris, error)) << error;
+    std::vector<float> inputs = iris.features, targets(iris.rows * 3, 0.0f);
+    FeatureScaling scaling = standardization(inputs.data(), iris.rows, iris.cols);
+    for (size_t i = 0; i < iris.rows; i++) {
+        for (size_t j = 0; j < iris.cols; j++) {
+            inputs[i * iris.cols + j] = (inputs[i * iris.cols + j] - scaling.offset[j]) * scaling.scale[j];
+        }
+        targets[i * 3 + static_cast<size_t>(iris.targets[i])] = 1.0f;
+    }
+    std::vector<std::string> dense = {"input:4", "hidden:8:relu", "hidden:6:relu", "output:3:softmax"};
+    std::vector<float> full = train(dense, 16, inputs, targets, 200, GemmPrecision::Float32);
+    std::vector<float> mixed = train(dense, 16, inputs, targets, 200, GemmPrecision::BFloat16);
+    EXPECT_LT(mixed.back(), mixed.front());
+    EXPECT_NEAR(mixed.back(), full.back(), 0.02f * full.back() + 0.005f);
+
+    // cnn.ai: ไม่มีรูปภาพมากับโปรเจกต์ จึงใช้ข้อมูลสังเคราะห์แบบที่ train ใช้ (ค่าเฉลี่ยต่อคลาสบวกสัญญาณรบกวน)
+    std::vector<std::string> cnn = {"input:16x16x3", "conv:8:3:relu", "pool:2x2", "conv:16:3:relu", "pool:2x2",
+                                    "dropout:0.250000", "flatten", "dense:32:relu", "dropout:0.500000",
+                                    "output:3:softmax"};
+    const size_t samples = 64, features = 16 * 16 * 3;
+    std::mt19937 rng(7);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    std::vector<float> centers(3 * features), images(samples * features), labels(samples * 3, 0.0f);
+    for (float& v : centers) v = 0.5f * noise(rng);
+    for (size_t i = 0; i < samples; i++) {
+        for (size_t j = 0; j < features; j++) images[i * features + j] = centers[(i % 3) * features + j] + noise(rng);
+        labels[i * 3 + i % 3] = 1.0f;
+    }
+    full = train(cnn, 32, images, labels, 40, GemmPrecision::Float32);
+    mixed = train(cnn, 32, images, labels, 40, GemmPrecision::BFloat16);
+    EXPECT_LT(mixed.back(), 0.5f * mixed.front());
+    for (size_t s = 0; s < full.size(); s++) {
+        EXPECT_NEAR(mixed[s], full[s], 0.05f * full[s] + 0.01f) << "step " << s;
+    }
+
+    // ผลลัพธ์ของชั้นเป็น bf16 ทั้งในแผนและใน arena จริง ส่วน gradient ยังเป็น float32
+    LayerGraph half = LayerGraph::compile(cnn, 32, true, GemmPrecision::BFloat16);
+    LayerGraph single = LayerGraph::compile(cnn, 32);
+    const GraphNode& conv1 = half.nodes()[1];
+    EXPECT_EQ(half.values()[conv1.output].dtype, DType::BFloat16);
+    EXPECT_EQ(half.values()[conv1.output].bytes() * 2, single.values()[single.nodes()[1].output].bytes());
+    EXPECT_EQ(half.values()[static_cast<size_t>(conv1.gradient)].dtype, DType::Float32);
+    size_t halfPlan = MemoryPlan::build(half).arenaBytes(), singlePlan = MemoryPlan::build(single).arenaBytes();
+    Network halfNetwork(half, 42, GemmPrecision::BFloat16), singleNetwork(single, 42);
+    Optimizer halfOptimizer(OptimizerConfig(), halfNetwork.parameterCount());
+    Optimizer singleOptimizer(OptimizerConfig(), singleNetwork.parameterCount());
+    halfNetwork.trainStep(images.data(), labels.data(), 32, halfOptimizer);
+    singleNetwork.trainStep(images.data(), labels.data(), 32, singleOptimizer);
+    EXPECT_LT(halfPlan, singlePlan);
+    EXPECT_LT(halfNetwork.arenaPeakBytes(), singleNetwork.arenaPeakBytes());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
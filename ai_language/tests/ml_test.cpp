@@ -0,0 +1,993 @@
+#include <gtest/gtest.h>
+#include "../include/ml/CodeGen.h"
+#include "../include/ml/Compare.h"
+#include "../include/ml/Dataset.h"
+#include "../include/ml/Ensemble.h"
+#include "../include/ml/Importance.h"
+#include "../include/ml/KMeans.h"
+#include "../include/ml/KNN.h"
+#include "../include/ml/LinearModel.h"
+#include "../include/ml/Metrics.h"
+#include "../include/ml/NaiveBayes.h"
+#include "../include/ml/PCA.h"
+#include "../include/ml/Polynomial.h"
+#include "../include/ml/Recommender.h"
+#include "../include/ml/SVM.h"
+#include "../include/ml/RandomForest.h"
+#include "../include/ml/GradientBoosting.h"
+#include "../include/utils/parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <thread>
+
+using namespace ai_language;
+
+namespace {
+
+// สร้างชุดข้อมูลสามคลาสที่แยกกันชัดเจน
+Dataset makeBlobs(size_t rows, size_t cols, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, 0.3f);
+    Dataset data;
+    data.rows = rows;
+    data.cols = cols;
+    data.classification = true;
+    data.features.resize(rows * cols);
+    data.targets.resize(rows);
+    for (size_t i = 0; i < rows; i++) {
+        int label = static_cast<int>(i % 3);
+        for (size_t j = 0; j < cols; j++) {
+            data.row(i)[j] = static_cast<float>(label * 2) + noise(rng);
+        }
+        data.targets[i] = static_cast<float>(label);
+    }
+    return data;
+}
+
+ModelParams knnParams(const std::string& index) {
+    ModelParams params;
+    params.numeric["k"] = 5;
+    params.text["index"] = index;
+    return params;
+}
+
+} // namespace
+
+TEST(DatasetTest, LoadCsvWithCategoricalTarget) {
+    const char* path = "ml_test_dataset.csv";
+    {
+        std::ofstream file(path);
+        file << "\nx,y,species\n1,2,setosa\n3,,versicolor\n5,6,setosa\n";
+    }
+    Dataset data;
+    std::string error;
+    ASSERT_TRUE(loadCsvDataset(std::string("\"") + path + "\"", "", data, error)) << error;
+    std::remove(path);
+
+    EXPECT_EQ(3u, data.rows);
+    EXPECT_EQ(2u, data.cols);
+    EXPECT_TRUE(data.isClassification());
+    EXPECT_EQ("versicolor", data.formatTarget(1.0f));
+    EXPECT_FLOAT_EQ(4.0f, data.row(1)[1]); // ค่าที่หายไปถูกเติมด้วยค่าเฉลี่ย
+}
+
+TEST(DatasetTest, AppendKeepsCategoricalFeatureCodes) {
+    // ไฟล์ที่สองพบ "blue" ก่อน "red" จึงให้รหัสสลับกับไฟล์แรก
+    const char* first = "ml_test_colors1.csv";
+    const char* second = "ml_test_colors2.csv";
+    {
+        std::ofstream a(first), b(second);
+        a << "color,size,label\nred,1,yes\nblue,2,no\n";
+        b << "color,size,label\nblue,3,no\ngreen,4,yes\nred,5,yes\n";
+    }
+    Dataset data, more, test;
+    std::string error;
+    ASSERT_TRUE(loadCsvDataset(first, "", data, error)) << error;
+    ASSERT_TRUE(loadCsvDataset(second, "", more, error)) << error;
+    test = more;
+    std::remove(first);
+    std::remove(second);
+
+    ASSERT_TRUE(data.append(more));
+    ASSERT_EQ(5u, data.rows);
+    EXPECT_EQ((std::vector<std::string>{"red", "blue", "green"}), data.featureCategories[0]);
+    EXPECT_TRUE(data.featureCategories[1].empty());
+    const float colors[] = {0.0f, 1.0f, 1.0f, 2.0f, 0.0f};
+    for (size_t i = 0; i < data.rows; i++) {
+        EXPECT_FLOAT_EQ(colors[i], data.row(i)[0]) << "row " << i;
+        EXPECT_FLOAT_EQ(static_cast<float>(i + 1), data.row(i)[1]);
+    }
+
+    // ไฟล์ทดสอบที่โหลดแยกใช้พจนานุกรมของข้อมูลเทรน
+    test.alignFeatureCategories(data.featureCategories);
+    EXPECT_FLOAT_EQ(1.0f, test.row(0)[0]);
+    EXPECT_FLOAT_EQ(2.0f, test.row(1)[0]);
+    EXPECT_FLOAT_EQ(0.0f, test.row(2)[0]);
+}
+
+TEST(KNNTest, TreeIndexesMatchBruteForce) {
+    Dataset train = makeBlobs(600, 4, 1);
+    Dataset queries = makeBlobs(50, 4, 2);
+
+    for (const std::string index : {"kdtree", "balltree"}) {
+        KNNModel model(knnParams(index));
+        model.fit(train);
+        std::vector<uint32_t> treeIdx, bruteIdx;
+        std::vector<float> treeDist, bruteDist;
+        model.kneighbors(queries.features.data(), queries.rows, 5, treeIdx, treeDist);
+        model.bruteForceKneighbors(queries.features.data(), queries.rows, 5, bruteIdx, bruteDist);
+        ASSERT_EQ(treeDist.size(), bruteDist.size());
+        for (size_t i = 0; i < treeDist.size(); i++) {
+            EXPECT_NEAR(bruteDist[i], treeDist[i], 1e-3f) << index;
+        }
+    }
+}
+
+TEST(KNNTest, PredictsClusterLabels) {
+    Dataset train = makeBlobs(300, 3, 3);
+    KNNModel model(knnParams("auto"));
+    model.fit(train);
+
+    float query[3] = {4.0f, 4.1f, 3.9f};
+    EXPECT_FLOAT_EQ(2.0f, model.predictOne(query));
+
+    // เสมอ 2-2 (เรียงจากใกล้: 0, 1, 1, 0) ต้องได้คลาสของเพื่อนบ้านที่ใกล้ที่สุด ไม่ใช่คลาสที่ครบคะแนนก่อน
+    Dataset tie;
+    tie.rows = 4;
+    tie.cols = 1;
+    tie.classification = true;
+    tie.features = {0.1f, 0.2f, 0.3f, 0.4f};
+    tie.targets = {0.0f, 1.0f, 1.0f, 0.0f};
+    ModelParams params = knnParams("brute");
+    params.numeric["k"] = 4;
+    KNNModel tied(params);
+    tied.fit(tie);
+    float origin = 0.0f;
+    EXPECT_FLOAT_EQ(0.0f, tied.predictOne(&origin));
+}
+
+TEST(KNNTest, HNSWRecallAgainstExactSearch) {
+    Dataset train = makeBlobs(2000, 16, 4);
+    Dataset queries = makeBlobs(100, 16, 5);
+    ModelParams params = knnParams("hnsw");
+    params.numeric["M"] = 12;
+    params.numeric["ef_search"] = 64;
+    KNNModel model(params);
+    model.fit(train);
+
+    RecallReport report = model.estimateRecall(queries.features.data(), queries.rows, 100);
+    EXPECT_EQ(100u, report.sampleSize);
+    EXPECT_GT(report.recall, 0.9);
+}
+
+TEST(NaiveBayesTest, PartialFitMatchesFullFit) {
+    Dataset full = makeBlobs(900, 5, 6);
+    std::vector<size_t> first, second;
+    for (size_t i = 0; i < full.rows; i++) {
+        (i < 400 ? first : second).push_back(i);
+    }
+
+    NaiveBayesModel batch((ModelParams()));
+    batch.fit(full);
+    NaiveBayesModel online((ModelParams()));
+    online.fit(full.subset(first));
+    online.partialFit(full.subset(second));
+
+    EXPECT_DOUBLE_EQ(batch.statistics().total(), online.statistics().total());
+    Dataset queries = makeBlobs(30, 5, 7);
+    std::vector<float> a(queries.rows * 3), b(queries.rows * 3);
+    batch.jointLogLikelihood(queries.features.data(), queries.rows, a.data());
+    online.jointLogLikelihood(queries.features.data(), queries.rows, b.data());
+    for (size_t i = 0; i < a.size(); i++) {
+        EXPECT_NEAR(a[i], b[i], 1e-2f * std::max(1.0f, std::fabs(a[i])));
+    }
+    std::vector<float> predicted(queries.rows);
+    batch.predictBatch(queries.features.data(), queries.rows, predicted.data());
+    for (size_t i = 0; i < queries.rows; i++) {
+        EXPECT_FLOAT_EQ(queries.targets[i], predicted[i]);
+    }
+}
+
+TEST(NaiveBayesTest, MultinomialCounts) {
+    Dataset data;
+    data.rows = 4;
+    data.cols = 3;
+    data.classification = true;
+    data.features = {5, 0, 1, 4, 1, 0, 0, 6, 1, 1, 5, 0};
+    data.targets = {0, 0, 1, 1};
+    ModelParams params;
+    params.text["variant"] = "\"multinomial\"";
+    NaiveBayesModel model(params);
+    model.fit(data);
+
+    float query[3] = {3, 0, 1};
+    EXPECT_FLOAT_EQ(0.0f, model.predictOne(query));
+    float other[3] = {0, 4, 0};
+    EXPECT_FLOAT_EQ(1.0f, model.predictOne(other));
+}
+
+TEST(SVMTest, RbfSeparatesRing) {
+    // จุดในวงกลมรัศมี 1 เป็นคลาส 0 และวงแหวนรัศมี 2-3 เป็นคลาส 1 (แยกด้วยเส้นตรงไม่ได้)
+    std::mt19937 rng(8);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+    std::uniform_real_distribution<float> inner(0.0f, 1.0f), outer(2.0f, 3.0f);
+    Dataset data;
+    data.rows = 400;
+    data.cols = 2;
+    data.classification = true;
+    for (size_t i = 0; i < data.rows; i++) {
+        float r = i % 2 == 0 ? inner(rng) : outer(rng);
+        float a = angle(rng);
+        data.features.push_back(r * std::cos(a));
+        data.features.push_back(r * std::sin(a));
+        data.targets.push_back(static_cast<float>(i % 2));
+    }
+
+    for (double cacheMB : {100.0, 0.001}) {
+        ModelParams params;
+        params.numeric["kernel_cache_mb"] = cacheMB;
+        SVMModel model(params);
+        model.fit(data);
+        std::vector<float> predicted(data.rows);
+        model.predictBatch(data.features.data(), data.rows, predicted.data());
+        size_t correct = 0;
+        for (size_t i = 0; i < data.rows; i++) {
+            correct += predicted[i] == data.targets[i] ? 1 : 0;
+        }
+        EXPECT_GE(correct, data.rows * 98 / 100) << "cache " << cacheMB << " MB";
+    }
+}
+
+TEST(SVMTest, LinearOneVsRest) {
+    // คลาส c อยู่รอบจุด 3 * e_c ทำให้แต่ละคลาสแยกจากคลาสอื่นด้วยเส้นตรงได้
+    std::mt19937 rng(9);
+    std::normal_distribution<float> noise(0.0f, 0.4f);
+    Dataset data;
+    data.rows = 600;
+    data.cols = 3;
+    data.classification = true;
+    for (size_t i = 0; i < data.rows; i++) {
+        size_t label = i % 3;
+        for (size_t j = 0; j < data.cols; j++) {
+            data.features.push_back((j == label ? 3.0f : 0.0f) + noise(rng));
+        }
+        data.targets.push_back(static_cast<float>(label));
+    }
+
+    ModelParams params;
+    params.text["kernel"] = "linear";
+    SVMModel model(params);
+    model.fit(data);
+    EXPECT_EQ(3u, model.numProblems());
+
+    float queries[3][3] = {{3.1f, 0.2f, -0.1f}, {0.0f, 2.8f, 0.3f}, {-0.2f, 0.1f, 3.3f}};
+    for (size_t c = 0; c < 3; c++) {
+        EXPECT_FLOAT_EQ(static_cast<float>(c), model.predictOne(queries[c]));
+    }
+}
+
+TEST(TreeEnsembleTest, CompiledLayoutsMatchNaiveWalk) {
+    Dataset train = makeBlobs(900, 6, 10);
+    Dataset queries = makeBlobs(300, 6, 11);
+
+    ModelParams boostParams;
+    boostParams.numeric["n_estimators"] = 20;
+    GradientBoostingModel boosting(boostParams);
+    boosting.fit(train);
+    ModelParams forestParams;
+    forestParams.numeric["n_estimators"] = 10;
+    RandomForestModel forest(forestParams);
+    forest.fit(train);
+
+    for (const TreeEnsembleModel* model : {static_cast<const TreeEnsembleModel*>(&boosting),
+                                           static_cast<const TreeEnsembleModel*>(&forest)}) {
+        size_t width = model->scoreSize();
+        std::vector<float> naive(queries.rows * width), compiled(naive.size()), quick(naive.size());
+        model->rawScores(queries.features.data(), queries.rows, naive.data(), TreeLayout::Naive);
+        model->rawScores(queries.features.data(), queries.rows, compiled.data(), TreeLayout::Compiled);
+        model->rawScores(queries.features.data(), queries.rows, quick.data(), TreeLayout::QuickScorer);
+        for (size_t i = 0; i < naive.size(); i++) {
+            EXPECT_NEAR(naive[i], compiled[i], 1e-5f);
+            EXPECT_NEAR(naive[i], quick[i], 1e-5f);
+        }
+    }
+    // ต้นไม้ลึก 3 มีไม่เกิน 8 ใบ จึงต้องใช้ QuickScorer ได้
+    EXPECT_EQ(TreeLayout::QuickScorer, boosting.activeLayout());
+}
+
+TEST(TreeEnsembleTest, TreeModelsFitBlobs) {
+    Dataset train = makeBlobs(600, 4, 12);
+    Dataset queries = makeBlobs(90, 4, 13);
+    ModelParams params;
+    params.numeric["n_estimators"] = 30;
+    params.numeric["learning_rate"] = 0.3;
+    DecisionTreeModel tree(params);
+    RandomForestModel forest(params);
+    GradientBoostingModel boosting(params);
+    for (MLModel* model : {static_cast<MLModel*>(&tree), static_cast<MLModel*>(&forest),
+                           static_cast<MLModel*>(&boosting)}) {
+        model->fit(train);
+        std::vector<float> predicted(queries.rows);
+        model->predictBatch(queries.features.data(), queries.rows, predicted.data());
+        size_t correct = 0;
+        for (size_t i = 0; i < queries.rows; i++) {
+            correct += predicted[i] == queries.targets[i];
+        }
+        EXPECT_GE(correct, queries.rows * 95 / 100) << model->typeName();
+    }
+    EXPECT_LT(boosting.lossHistory().back(), boosting.lossHistory().front());
+}
+
+TEST(IncrementalTest, LogisticWarmStartConvergesFaster) {
+    Dataset full = makeBlobs(1200, 4, 14);
+    std::vector<size_t> first, second;
+    for (size_t i = 0; i < full.rows; i++) {
+        (i < 900 ? first : second).push_back(i);
+    }
+    ModelParams params;
+    params.numeric["learning_rate"] = 0.01;
+    LogisticRegressionModel model(params);
+    model.fit(full.subset(first));
+    size_t fullEpochs = model.lastEpochs();
+    double fittedLoss = model.lastLoss();
+    model.partialFit(full.subset(second));
+
+    // เริ่มจากน้ำหนักเดิมจึงหยุดเร็วกว่าและ loss ไม่แย่ลง
+    EXPECT_LT(model.lastEpochs(), fullEpochs);
+    EXPECT_LT(model.lastLoss(), fittedLoss * 1.5 + 1e-3);
+    Dataset queries = makeBlobs(60, 4, 15);
+    std::vector<float> predicted(queries.rows);
+    model.predictBatch(queries.features.data(), queries.rows, predicted.data());
+    for (size_t i = 0; i < queries.rows; i++) {
+        EXPECT_FLOAT_EQ(queries.targets[i], predicted[i]);
+    }
+}
+
+TEST(IncrementalTest, BoostingAppendsRounds) {
+    Dataset full = makeBlobs(900, 4, 16);
+    std::vector<size_t> first, second;
+    for (size_t i = 0; i < full.rows; i++) {
+        (i < 600 ? first : second).push_back(i);
+    }
+    ModelParams params;
+    params.numeric["n_estimators"] = 20;
+    params.numeric["incremental_rounds"] = 5;
+    params.numeric["learning_rate"] = 0.1;
+    GradientBoostingModel model(params);
+    model.fit(full.subset(first));
+    size_t before = model.numTrees();
+    model.partialFit(full.subset(second));
+
+    EXPECT_EQ(before + 5 * model.scoreSize(), model.numTrees());
+    EXPECT_EQ(6u, model.lossHistory().size());
+    EXPECT_LT(model.lossHistory().back(), model.lossHistory().front());
+}
+
+TEST(MetricsTest, ClassificationAndConfusionMatrix) {
+    float truth[] = {0, 0, 1, 1, 2, 2, 2, 1};
+    float predicted[] = {0, 1, 1, 1, 2, 0, 2, 2};
+    MetricsReport report = MetricsEngine::evaluate(truth, predicted, 8, true, 3);
+    EXPECT_DOUBLE_EQ(5.0 / 8.0, report.accuracy);
+    EXPECT_EQ(1u, report.confusion.at(0, 1));
+    EXPECT_EQ(1u, report.confusion.at(2, 0));
+    EXPECT_EQ(2u, report.confusion.at(1, 1));
+    // precision ต่อคลาส 1/2, 2/3, 2/3 และ recall 1/2, 2/3, 2/3
+    EXPECT_NEAR((0.5 + 2.0 / 3 + 2.0 / 3) / 3, report.precision, 1e-12);
+    EXPECT_NEAR((0.5 + 2.0 / 3 + 2.0 / 3) / 3, report.recall, 1e-12);
+
+    // คลาสจำนวนมากเก็บแบบ sparse
+    size_t classes = 3000, rows = 20000;
+    std::vector<float> t(rows), p(rows);
+    for (size_t i = 0; i < rows; i++) {
+        t[i] = static_cast<float>(i % classes);
+        p[i] = static_cast<float>(i % 7 == 0 ? (i + 1) % classes : i % classes);
+    }
+    MetricsReport large = MetricsEngine::evaluate(t.data(), p.data(), rows, true, classes);
+    EXPECT_FALSE(large.confusion.isDense());
+    uint64_t total = 0;
+    for (const auto& cell : large.confusion.nonZero()) {
+        total += cell.second;
+    }
+    EXPECT_EQ(rows, total);
+    EXPECT_EQ(large.confusion.truePositives[5], large.confusion.at(5, 5));
+}
+
+TEST(MetricsTest, RankingMatchesPairwiseDefinition) {
+    std::mt19937 rng(17);
+    std::uniform_int_distribution<int> coarse(0, 40);
+    size_t rows = 3000;
+    std::vector<float> scores(rows), truth(rows);
+    std::vector<uint8_t> positive(rows);
+    for (size_t i = 0; i < rows; i++) {
+        positive[i] = rng() % 3 == 0;
+        truth[i] = positive[i];
+        // คะแนนหยาบเพื่อให้มีค่าซ้ำ และค่าลบเพื่อทดสอบการแปลงบิต
+        scores[i] = static_cast<float>(coarse(rng) - 20) * 0.5f + (positive[i] ? 3.0f : 0.0f);
+    }
+
+    double roc = 0.0, ap = 0.0;
+    ASSERT_TRUE(MetricsEngine::rankingScores(scores.data(), 1, positive.data(), rows, roc, ap));
+    double wins = 0.0, pairs = 0.0;
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < rows; j++) {
+            if (positive[i] && !positive[j]) {
+                wins += scores[i] > scores[j] ? 1.0 : (scores[i] == scores[j] ? 0.5 : 0.0);
+                pairs += 1.0;
+            }
+        }
+    }
+    EXPECT_NEAR(wins / pairs, roc, 1e-9);
+
+    // average precision: เฉลี่ย precision ที่ threshold ของแต่ละตัวอย่างบวก
+    double expectedAp = 0.0, positives = 0.0;
+    for (size_t i = 0; i < rows; i++) {
+        if (!positive[i]) {
+            continue;
+        }
+        double above = 0.0, positiveAbove = 0.0;
+        for (size_t j = 0; j < rows; j++) {
+            if (scores[j] >= scores[i]) {
+                above += 1.0;
+                positiveAbove += positive[j];
+            }
+        }
+        expectedAp += positiveAbove / above;
+        positives += 1.0;
+    }
+    EXPECT_NEAR(expectedAp / positives, ap, 1e-9);
+
+    // คะแนน NaN จากโมเดลที่ลู่ออกไม่มีลำดับ: ไม่รายงาน ranking แทนที่จะวนไม่จบ
+    scores[rows / 2] = std::numeric_limits<float>::quiet_NaN();
+    EXPECT_FALSE(MetricsEngine::rankingScores(scores.data(), 1, positive.data(), rows, roc, ap));
+
+    // หลายก้อนขนานต้องให้ผลเหมือน stable sort
+    setMaxThreads(4);
+    std::vector<float> many(300000);
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    for (auto& value : many) {
+        value = std::round(normal(rng) * 1000.0f) / 100.0f;
+    }
+    std::vector<uint32_t> order, expected(many.size());
+    MetricsEngine::sortByScoreDescending(many.data(), 1, many.size(), order);
+    setMaxThreads(0);
+    std::iota(expected.begin(), expected.end(), 0u);
+    std::stable_sort(expected.begin(), expected.end(), [&](uint32_t a, uint32_t b) { return many[a] > many[b]; });
+    EXPECT_EQ(expected, order);
+}
+
+TEST(MetricsTest, MulticlassScoresRankWithinEachClass) {
+    // คลาสกลางของข้อมูลที่เรียงเป็นแนวเดียวแยกไม่ได้ด้วย logit ดิบ ต้องใช้คะแนนที่ normalize แล้ว
+    Dataset data = makeBlobs(600, 2, 9);
+    ModelParams params;
+    params.numeric["epochs"] = 50;
+    LogisticRegressionModel model(params);
+    model.fit(data);
+    std::vector<float> predicted(data.rows), scores;
+    model.predictBatch(data.features.data(), data.rows, predicted.data());
+    size_t width = model.decisionScores(data.features.data(), data.rows, scores);
+    MetricsReport report = MetricsEngine::evaluate(data.targets.data(), predicted.data(), data.rows, true, 3);
+    MetricsEngine::addRankingMetrics(report, data.targets.data(), scores.data(), data.rows, width);
+    EXPECT_GT(report.accuracy, 0.95);
+    EXPECT_GT(report.rocAuc, 0.99);
+}
+
+TEST(MetricsTest, RegressionMetrics) {
+    float truth[] = {1.0f, 2.0f, 3.0f, 4.0f};
+    float predicted[] = {1.5f, 2.0f, 2.0f, 4.0f};
+    MetricsReport report = MetricsEngine::evaluate(truth, predicted, 4, false, 0);
+    EXPECT_DOUBLE_EQ((0.25 + 1.0) / 4, report.mse);
+    EXPECT_DOUBLE_EQ(1.5 / 4, report.mae);
+    EXPECT_DOUBLE_EQ(1.0 - 1.25 / 5.0, report.r2);
+}
+
+TEST(ImportanceTest, InformativeFeatureRanksFirst) {
+    // feature 0 กำหนดคลาส ส่วน feature 1 และ 2 เป็นสัญญาณรบกวน
+    Dataset data = makeBlobs(900, 3, 5);
+    std::mt19937 rng(6);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    for (size_t i = 0; i < data.rows; i++) {
+        data.row(i)[1] = noise(rng);
+        data.row(i)[2] = noise(rng);
+    }
+    RandomForestModel model(ModelParams{});
+    model.fit(data);
+
+    std::vector<uint32_t> view(300);
+    std::iota(view.begin(), view.end(), 600u);
+    PermutationImportance serial = permutationImportance(model, data, view, 3, 7, true);
+    EXPECT_GT(serial.baseline, 0.95);
+    EXPECT_GT(serial.mean[0], 0.4);
+    EXPECT_LT(std::fabs(serial.mean[1]), 0.05);
+    EXPECT_LT(std::fabs(serial.mean[2]), 0.05);
+
+    setMaxThreads(4);
+    PermutationImportance parallel = permutationImportance(model, data, view, 3, 7, true);
+    // ตัวทำนายทั่วไป (เช่นเครือข่าย DL) ได้ worker ในช่วงเธรดที่ใช้ได้ และไม่มีสองงานใช้ worker เดียวกันพร้อมกัน
+    std::vector<std::atomic<int>> inUse(4);
+    std::atomic<bool> overlapped(false), outOfRange(false);
+    BlockPredictor predict = [&](const float* rows, size_t count, float* out, size_t worker) {
+        if (worker >= inUse.size()) {
+            outOfRange = true;
+            model.predictBatch(rows, count, out);
+            return;
+        }
+        overlapped = overlapped || inUse[worker]++ > 0;
+        model.predictBatch(rows, count, out);
+        inUse[worker]--;
+    };
+    PermutationImportance generic = permutationImportance(predict, data, view, 3, 7, true);
+    setMaxThreads(0);
+    EXPECT_EQ(serial.mean, parallel.mean);
+    EXPECT_EQ(serial.mean, generic.mean);
+    EXPECT_FALSE(overlapped);
+    EXPECT_FALSE(outOfRange);
+
+    std::vector<double> gains = model.splitImportance();
+    ASSERT_EQ(3u, gains.size());
+    EXPECT_NEAR(1.0, gains[0] + gains[1] + gains[2], 1e-9);
+    EXPECT_GT(gains[0], 0.8);
+}
+
+TEST(PCATest, RecoversLowRankStructure) {
+    // ข้อมูล 3 มิติแฝงที่มีความแปรปรวน 25, 9, 1 ฝังใน 40 features พร้อมสัญญาณรบกวนเล็กน้อย
+    const size_t rows = 20000, cols = 40, latent = 3;
+    std::mt19937 rng(11);
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    std::vector<float> mixing(latent * cols);
+    for (auto& value : mixing) {
+        value = normal(rng);
+    }
+    std::vector<float> data(rows * cols);
+    const float scales[latent] = {5.0f, 3.0f, 1.0f};
+    for (size_t i = 0; i < rows; i++) {
+        float z[latent];
+        for (size_t l = 0; l < latent; l++) {
+            z[l] = scales[l] * normal(rng);
+        }
+        for (size_t j = 0; j < cols; j++) {
+            float value = 10.0f + 0.01f * normal(rng);
+            for (size_t l = 0; l < latent; l++) {
+                value += z[l] * mixing[l * cols + j];
+            }
+            data[i * cols + j] = value;
+        }
+    }
+
+    // covariance แบบตรงเพื่อตรวจว่าแต่ละแกนเป็นเวกเตอร์ลักษณะเฉพาะ
+    std::vector<double> mean(cols, 0.0), covariance(cols * cols, 0.0);
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) {
+            mean[j] += data[i * cols + j] / static_cast<double>(rows);
+        }
+    }
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t a = 0; a < cols; a++) {
+            double da = data[i * cols + a] - mean[a];
+            for (size_t b = 0; b < cols; b++) {
+                covariance[a * cols + b] += da * (data[i * cols + b] - mean[b]) / (rows - 1);
+            }
+        }
+    }
+
+    setMaxThreads(4);
+    PCA pca;
+    PCA::Options options;
+    options.components = latent;
+    pca.fit(data.data(), rows, cols, options);
+    setMaxThreads(0);
+    ASSERT_EQ(latent, pca.outputDimension());
+
+    double explained = 0.0;
+    std::vector<float> projected(rows * latent);
+    pca.transform(data.data(), rows, projected.data());
+    for (size_t c = 0; c < latent; c++) {
+        explained += pca.explainedVarianceRatio()[c];
+        if (c > 0) {
+            EXPECT_GT(pca.explainedVariance()[c - 1], pca.explainedVariance()[c]);
+        }
+        // ความแปรปรวนของข้อมูลที่ฉายแล้วตรงกับค่าที่รายงาน และ C v = lambda v
+        double projectedVariance = 0.0;
+        for (size_t i = 0; i < rows; i++) {
+            projectedVariance += double(projected[i * latent + c]) * projected[i * latent + c] / (rows - 1);
+        }
+        double lambda = pca.explainedVariance()[c];
+        EXPECT_NEAR(1.0, projectedVariance / lambda, 1e-3);
+
+        std::vector<float> unit(cols), origin(cols, 0.0f), shifted(latent), zero(latent);
+        pca.transform(origin.data(), 1, zero.data());
+        double residual = 0.0;
+        std::vector<double> v(cols);
+        for (size_t j = 0; j < cols; j++) {
+            std::fill(unit.begin(), unit.end(), 0.0f);
+            unit[j] = 1.0f;
+            pca.transform(unit.data(), 1, shifted.data());
+            v[j] = shifted[c] - zero[c];
+        }
+        for (size_t a = 0; a < cols; a++) {
+            double cv = 0.0;
+            for (size_t b = 0; b < cols; b++) {
+                cv += covariance[a * cols + b] * v[b];
+            }
+            residual += (cv - lambda * v[a]) * (cv - lambda * v[a]);
+        }
+        EXPECT_LT(std::sqrt(residual) / lambda, 1e-2);
+    }
+    EXPECT_GT(explained, 0.999);
+}
+
+TEST(KMeansTest, BoundsMatchLloydAndSkipDistances) {
+    // 12 กลุ่มที่แยกกันชัดเจนใน 6 มิติ
+    const size_t rows = 6000, cols = 6, groups = 12;
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> spread(-20.0f, 20.0f);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    std::vector<float> truth(groups * cols);
+    for (auto& value : truth) {
+        value = spread(rng);
+    }
+    Dataset data;
+    data.rows = rows;
+    data.cols = cols;
+    data.features.resize(rows * cols);
+    data.targets.resize(rows);
+    for (size_t i = 0; i < rows; i++) {
+        size_t group = i % groups;
+        for (size_t j = 0; j < cols; j++) {
+            data.row(i)[j] = truth[group * cols + j] + noise(rng);
+        }
+        data.targets[i] = static_cast<float>(group);
+    }
+
+    auto train = [&](const std::string& algorithm, const std::string& init) {
+        ModelParams params;
+        params.numeric["clusters"] = groups;
+        params.numeric["tol"] = 0;
+        params.text["algorithm"] = algorithm;
+        params.text["init"] = init;
+        auto model = std::make_unique<KMeansModel>(params);
+        model->fit(data);
+        return model;
+    };
+
+    // k-means|| พบทุกกลุ่มจริง: แต่ละกลุ่มจริงตกอยู่ในกลุ่มเดียวของโมเดล
+    auto model = train("auto", "kmeans||");
+    EXPECT_EQ(model->usedAlgorithm(), KMeansAlgorithm::Hamerly);
+    double best = model->lastStats().inertia;
+    EXPECT_LT(best / rows, 1.2 * cols);
+    std::vector<float> labels(rows);
+    model->predictBatch(data.features.data(), rows, labels.data());
+    for (size_t i = groups; i < rows; i++) {
+        EXPECT_EQ(labels[i], labels[i % groups]);
+    }
+    EXPECT_LT(train("minibatch", "kmeans||")->lastStats().inertia, 1.05 * best);
+
+    // เริ่มแบบสุ่มเพื่อให้มีหลายรอบ: ขอบเขตต้องให้ผลเดียวกับ Lloyd และตัดการคำนวณระยะส่วนใหญ่
+    auto lloyd = train("lloyd", "random");
+    auto hamerly = train("hamerly", "random");
+    auto elkan = train("elkan", "random");
+    double reference = lloyd->lastStats().inertia;
+    EXPECT_GT(lloyd->lastStats().iterations, 3u);
+    for (const KMeansModel* bounded : {hamerly.get(), elkan.get()}) {
+        const KMeansStats& stats = bounded->lastStats();
+        EXPECT_NEAR(stats.inertia, reference, 1e-4 * reference);
+        EXPECT_EQ(stats.iterations, lloyd->lastStats().iterations);
+        EXPECT_GT(stats.distancesSkipped, stats.distancesComputed);
+        EXPECT_EQ(stats.distancesSkipped + stats.distancesComputed,
+                  static_cast<uint64_t>(rows) * groups * stats.iterations);
+    }
+    EXPECT_EQ(hamerly->centerMatrix(), elkan->centerMatrix());
+
+    // partialFit ต่อจากศูนย์กลางเดิมโดยไม่ทำให้ผลแย่ลงมาก
+    model->partialFit(data);
+    EXPECT_LT(model->lastStats().inertia, 1.05 * best);
+}
+
+TEST(CodeGenTest, ExportsTreesAndLinearWeights) {
+    // ค่าคงที่ต้องอ่านกลับได้ค่าเดิมทุกบิต
+    for (float value : {0.1f, -3.0f, 1e-30f, 123456.789f, 5e-45f}) {
+        std::string text = SourceWriter::literal(value);
+        ASSERT_EQ(text.back(), 'f');
+        EXPECT_EQ(std::strtof(text.c_str(), nullptr), value) << text;
+    }
+
+    Dataset data = makeBlobs(300, 4, 17);
+    std::vector<std::string> names = {"a", "b", "c"};
+    SourceExportOptions options;
+    options.fileName = "m.cpp";
+    options.classNames = names;
+    options.sampleRows = data.features.data();
+    options.sampleCount = 5;
+
+    ModelParams params;
+    params.numeric["max_depth"] = 3;
+    DecisionTreeModel tree(params);
+    tree.fit(data);
+    std::ostringstream treeSource;
+    SourceExportReport report = exportModelSource(tree, options, treeSource);
+    std::string text = treeSource.str();
+    EXPECT_EQ(report.bytes, text.size());
+    EXPECT_EQ(report.sampleRows, 5u);
+    EXPECT_NE(text.find("static void model_tree0(const float* x, float* s)"), std::string::npos);
+    EXPECT_NE(text.find("if (x["), std::string::npos);
+    EXPECT_NE(text.find("float predict(const float* x)"), std::string::npos);
+    EXPECT_NE(text.find("kClassNames[3] = {\"a\", \"b\", \"c\"}"), std::string::npos);
+    EXPECT_NE(text.find("#ifdef AI_LANGUAGE_BENCHMARK"), std::string::npos);
+    EXPECT_NE(text.find("constexpr std::size_t kRows = 5;"), std::string::npos);
+
+    LogisticRegressionModel linear(ModelParams{});
+    linear.fit(data);
+    std::ostringstream linearSource;
+    options.sampleRows = nullptr;
+    exportModelSource(linear, options, linearSource);
+    EXPECT_NE(linearSource.str().find("constexpr float kWeights[12]"), std::string::npos);
+    EXPECT_EQ(linearSource.str().find("#ifdef AI_LANGUAGE_BENCHMARK"), std::string::npos);
+
+    KNNModel knn(knnParams("brute"));
+    knn.fit(data);
+    std::ostringstream unused;
+    EXPECT_THROW(exportModelSource(knn, options, unused), std::invalid_argument);
+}
+
+TEST(PolynomialTest, LinearModelsExpandInteractionsLazily) {
+    PolynomialFeatures full(3, 2, false), interactions(3, 2, true);
+    EXPECT_EQ(full.outputDimension(), 9u);
+    EXPECT_EQ(interactions.outputDimension(), 6u);
+    EXPECT_EQ(PolynomialFeatures::outputDimension(200, 2, false), 20300u);
+    float x[3] = {1.0f, 2.0f, 3.0f};
+    std::vector<float> expanded(9);
+    full.expand(x, 1, expanded.data());
+    EXPECT_EQ(expanded, (std::vector<float>{1, 2, 3, 1, 2, 3, 4, 6, 9}));
+    std::vector<std::string> names = full.featureNames({"a", "b", "c"});
+    EXPECT_EQ(names[3], "a^2");
+    EXPECT_EQ(names[4], "a*b");
+    EXPECT_EQ(interactions.featureNames({"a", "b", "c"})[3], "a*b");
+
+    // XOR: แยกได้ด้วยพจน์ x * y เท่านั้น
+    Dataset data;
+    data.cols = 2;
+    data.featureNames = {"x", "y"};
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    for (size_t i = 0; i < 2000; i++) {
+        float a = uniform(rng), b = uniform(rng);
+        data.features.push_back(a);
+        data.features.push_back(b);
+        data.targets.push_back(a * b > 0.0f ? 1.0f : 0.0f);
+    }
+    data.rows = 2000;
+    data.classification = true;
+
+    auto accuracy = [&](const MLModel& model) {
+        std::vector<float> predictions(data.rows);
+        model.predictBatch(data.features.data(), data.rows, predictions.data());
+        size_t correct = 0;
+        for (size_t i = 0; i < data.rows; i++) {
+            correct += predictions[i] == data.targets[i];
+        }
+        return static_cast<double>(correct) / data.rows;
+    };
+    ModelParams params;
+    params.numeric["learning_rate"] = 0.1;
+    LogisticRegressionModel plain(params);
+    plain.fit(data);
+    EXPECT_LT(accuracy(plain), 0.7);
+
+    params.numeric["polynomial_degree"] = 2;
+    params.numeric["interaction_only"] = 1;
+    LogisticRegressionModel expandedModel(params);
+    expandedModel.fit(data);
+    EXPECT_EQ(expandedModel.numFeatures(), 2u);
+    EXPECT_EQ(expandedModel.featureExpansion().outputDimension(), 3u);
+    EXPECT_GT(accuracy(expandedModel), 0.95);
+
+    // ผลทำนายเป็นก้อนต้องตรงกับทีละแถว และโค้ดที่ส่งออกต้องมีลูปของพจน์ x[i0] * x[i1]
+    EXPECT_EQ(expandedModel.predictOne(data.row(7)), data.targets[7]);
+    std::ostringstream source;
+    SourceExportOptions options;
+    exportModelSource(expandedModel, options, source);
+    EXPECT_NE(source.str().find("sum += w[p++] * (x[i0] * x[i1]);"), std::string::npos);
+    EXPECT_NE(source.str().find("i1 = i0 + 1"), std::string::npos);
+}
+
+TEST(EnsembleTest, StackingAndVotingTrainConcurrently) {
+    Dataset data = makeBlobs(600, 4, 23);
+    ModelParams params;
+    params.text["estimators"] = "LogisticRegression, DecisionTree, KNN";
+    params.numeric["max_depth"] = 4;
+    params.numeric["cv"] = 4;
+
+    // ผลต้องไม่ขึ้นกับจำนวนเธรดที่ใช้ทำงานพร้อมกัน
+    setMaxThreads(1);
+    StackingModel serial(params);
+    serial.fit(data);
+    setMaxThreads(4);
+    StackingModel concurrent(params);
+    concurrent.fit(data);
+    setMaxThreads(0);
+
+    ASSERT_EQ(concurrent.learnerTypes().size(), 3u);
+    EXPECT_EQ(concurrent.learner(2).typeName(), "KNN");
+    EXPECT_EQ(concurrent.metaLearner().typeName(), "LogisticRegression");
+    EXPECT_GE(concurrent.metaFeatureCount(), 9u);
+    std::vector<float> a(data.rows), b(data.rows);
+    serial.predictBatch(data.features.data(), data.rows, a.data());
+    concurrent.predictBatch(data.features.data(), data.rows, b.data());
+    EXPECT_EQ(a, b);
+    size_t correct = 0;
+    for (size_t i = 0; i < data.rows; i++) {
+        correct += b[i] == data.targets[i];
+    }
+    EXPECT_GT(correct, data.rows * 95 / 100);
+    std::vector<float> scores;
+    EXPECT_EQ(concurrent.decisionScores(data.features.data(), 10, scores), 3u);
+
+    // Voting แบบถดถอยคือค่าเฉลี่ยของผลทำนาย
+    Dataset regression = makeBlobs(300, 2, 5);
+    regression.classification = false;
+    ModelParams votingParams;
+    votingParams.text["estimators"] = "LinearRegression,DecisionTree";
+    VotingModel voting(votingParams);
+    voting.fit(regression);
+    float mean = 0.5f * (voting.learner(0).predictOne(regression.row(3)) + voting.learner(1).predictOne(regression.row(3)));
+    EXPECT_FLOAT_EQ(voting.predictOne(regression.row(3)), mean);
+
+    ModelParams invalid;
+    invalid.text["estimators"] = "KNN";
+    EXPECT_THROW(VotingModel{invalid}, std::invalid_argument);
+    invalid.text["estimators"] = "KNN, KMeans";
+    EXPECT_THROW(StackingModel{invalid}, std::invalid_argument);
+}
+
+TEST(RecommenderTest, SketchIsExactAndRankingPrefersFastAccurateModels) {
+    Dataset data = makeBlobs(3000, 4, 21);
+    // คอลัมน์ 0 เป็นรหัสหมวดหมู่ 5 ค่า ให้ทดสอบการนับค่าไม่ซ้ำแบบตรง
+    for (size_t i = 0; i < data.rows; i++) {
+        data.row(i)[0] = static_cast<float>(i % 5);
+    }
+
+    // ผลรวมจากหลายก้อนต้องเท่ากับการสรุปแบบลำดับ
+    setMaxThreads(1);
+    DatasetSketch serial = sketchDataset(data, 500, 7);
+    setMaxThreads(4);
+    DatasetSketch concurrent = sketchDataset(data, 500, 7);
+    setMaxThreads(0);
+
+    EXPECT_EQ(concurrent.sample, serial.sample);
+    EXPECT_EQ(concurrent.cardinality, serial.cardinality);
+    ASSERT_EQ(concurrent.sample.size(), 500u);
+    std::vector<uint32_t> distinct = concurrent.sample;
+    std::sort(distinct.begin(), distinct.end());
+    EXPECT_EQ(std::unique(distinct.begin(), distinct.end()), distinct.end());
+    EXPECT_LT(distinct.back(), data.rows);
+    EXPECT_DOUBLE_EQ(concurrent.cardinality[0], 5.0);
+    EXPECT_GT(concurrent.cardinality[1], 1000.0);
+    EXPECT_EQ(concurrent.lowCardinality, 1u);
+    ASSERT_EQ(concurrent.classCounts.size(), 3u);
+    EXPECT_EQ(concurrent.classCounts[0], 1000u);
+    EXPECT_DOUBLE_EQ(concurrent.classBalance(), 1.0);
+    EXPECT_GT(concurrent.maxTargetCorrelation, 0.8);
+
+    RecommendOptions options;
+    options.sampleRows = 800;
+    options.budgetSeconds = 5.0;
+    RecommendationReport report = recommendModels(data, options);
+    ASSERT_GE(report.candidates.size(), 5u);
+    const ModelCandidate& top = report.candidates.front();
+    EXPECT_TRUE(top.competitive);
+    EXPECT_GT(top.score, 0.95);
+    EXPECT_GT(top.trainRows, 0u);
+    // ตัวที่อยู่ในเกณฑ์ต้องมาก่อน และเรียงตามคะแนนต่อวินาที
+    for (size_t c = 1; c < report.candidates.size(); c++) {
+        const ModelCandidate& previous = report.candidates[c - 1];
+        const ModelCandidate& current = report.candidates[c];
+        EXPECT_FALSE(current.competitive && !previous.competitive);
+        if (previous.competitive && current.competitive) {
+            EXPECT_GE(previous.scorePerSecond(), current.scorePerSecond());
+        }
+    }
+    // ไม่มีการถดถอยเชิงเส้นสำหรับงานจำแนกประเภท
+    for (const auto& candidate : report.candidates) {
+        EXPECT_NE(candidate.type, "LinearRegression");
+    }
+
+    Dataset tiny = makeBlobs(10, 2, 1);
+    EXPECT_THROW(recommendModels(tiny, options), std::invalid_argument);
+}
+
+TEST(CompareTest, SchedulerSharesCoresAndModelsShareOneSplit) {
+    // ตัวจัดตาราง: งานที่ขอหลายคอร์ได้ไม่เกินที่ว่าง และรวมกันไม่เกินจำนวนคอร์
+    setMaxThreads(4);
+    std::atomic<size_t> busy(0), peak(0);
+    std::vector<size_t> wants = {4, 1, 1, 3, 1, 2};
+    std::vector<size_t> granted(wants.size(), 0), seen(wants.size(), 0);
+    scheduleTasks(wants.size(), [&](size_t task) { return wants[task]; }, [&](size_t task, size_t threads) {
+        size_t now = busy += threads;
+        size_t previous = peak.load();
+        while (now > previous && !peak.compare_exchange_weak(previous, now)) {
+        }
+        granted[task] = threads;
+        seen[task] = availableThreads();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        busy -= threads;
+    });
+    EXPECT_LE(peak.load(), 4u);
+    EXPECT_EQ(granted[0], 1u);   // กันไว้คอร์ละหนึ่งให้งานที่ยังรออยู่ (5 งาน)
+    for (size_t t = 0; t < wants.size(); t++) {
+        EXPECT_GE(granted[t], 1u);
+        EXPECT_LE(granted[t], wants[t]);
+        EXPECT_EQ(seen[t], granted[t]);
+    }
+    EXPECT_EQ(availableThreads(), 4u);
+    wants = {4, 1, 1};
+    scheduleTasks(wants.size(), [&](size_t task) { return wants[task]; },
+                  [&](size_t task, size_t threads) { granted[task] = threads; });
+    EXPECT_EQ(granted[0], 2u);
+
+    Dataset data = makeBlobs(900, 4, 31);
+    CompareOptions options;
+    options.params.numeric["n_estimators"] = 10;
+    options.testSize = 0.25;
+    ComparisonReport report = compareModels(data, {"LogisticRegression", "RandomForest", "KNN", "LinearRegression"}, options);
+    setMaxThreads(0);
+
+    EXPECT_EQ(report.trainRows, 675u);
+    EXPECT_EQ(report.testRows, 225u);
+    ASSERT_EQ(report.results.size(), 4u);
+    // เรียงตามคะแนน โมเดลที่ใช้กับงานจำแนกประเภทไม่ได้อยู่ท้ายสุด
+    EXPECT_EQ(report.results.back().type, "LinearRegression");
+    EXPECT_FALSE(report.results.back().ok());
+    for (size_t r = 0; r + 1 < 3; r++) {
+        ASSERT_TRUE(report.results[r].ok());
+        EXPECT_GE(report.results[r].score, report.results[r + 1].score);
+    }
+    for (size_t r = 0; r < 3; r++) {
+        const ModelComparison& result = report.results[r];
+        EXPECT_GT(result.score, 0.95);
+        EXPECT_GT(result.modelBytes, 0u);
+        EXPECT_GT(result.latencyMicros, 0.0);
+        EXPECT_GE(result.threads, 1u);
+        EXPECT_LE(result.threads, 4u);
+    }
+    ASSERT_NE(report.best(), nullptr);
+
+    // ทุกโมเดลใช้ชุดเทรนเดียวกัน: KNN เก็บทุกแถวเทรน (features + label + ดัชนี)
+    const ModelComparison* knnResult = nullptr;
+    for (const auto& result : report.results) {
+        if (result.type == "KNN") {
+            knnResult = &result;
+        }
+    }
+    ASSERT_NE(knnResult, nullptr);
+    EXPECT_GE(knnResult->modelBytes, report.trainRows * 4 * sizeof(float));
+    EXPECT_THROW(compareModels(data, {}, options), std::invalid_argument);
+
+    // การแบ่งที่ DL compare models ใช้ร่วม: stratified ไม่ซ้ำกัน และเรียงตามลำดับเดิม
+    std::vector<size_t> trainRows, testRows;
+    splitTrainTest(data.targets, true, 0.25, 42, trainRows, testRows);
+    EXPECT_EQ(trainRows.size(), report.trainRows);
+    EXPECT_EQ(testRows.size(), report.testRows);
+    EXPECT_TRUE(std::is_sorted(testRows.begin(), testRows.end()));
+    std::vector<size_t> perClass(3, 0);
+    for (size_t row : testRows) {
+        perClass[static_cast<size_t>(data.targets[row])]++;
+        EXPECT_FALSE(std::binary_search(trainRows.begin(), trainRows.end(), row));
+    }
+    for (size_t count : perClass) {
+        EXPECT_EQ(count, 75u);
+    }
+    EXPECT_THROW(splitTrainTest(data.targets, true, 1.0, 42, trainRows, testRows), std::invalid_argument);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}